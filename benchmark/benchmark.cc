@@ -0,0 +1,600 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// Benchmark suite of the core pipelines of GMML
+/// Workloads are built from the files shipped in example/ and dat/ and from synthetic assemblies made of
+/// translated copies of example/pdb/1UBQ.pdb. Each workload is run a number of times and the best and the median times are
+/// reported together with the throughput; the bond by distance workloads are run for several atom and thread counts
+/// and reported as a scaling table.
+/// The best times are compared against a stored baseline (benchmark/baseline.dat, "name seconds" per line) and the
+/// program exits with 1 if a workload is slower than the baseline by more than the tolerance.
+///
+/// Usage: gmml-benchmark [--root <dir containing example/ and dat/>] [--repetitions n] [--quick]
+///                       [--baseline file] [--write-baseline file] [--tolerance fraction] [--output file]
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+#include "../includes/MolecularModeling/assembly.hpp"
+#include "../includes/MolecularModeling/atom.hpp"
+#include "../includes/InputSet/PdbFileSpace/pdbfile.hpp"
+#include "../includes/InputSet/TopologyFileSpace/topologyfile.hpp"
+#include "../includes/Glycan/oligosaccharide.hpp"
+#include "../includes/instrumentation.hpp"
+#include "../includes/logger.hpp"
+#include "../includes/common.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+
+/// Workloads faster than this are too noisy to be flagged as regressions
+static const double MINIMUM_REGRESSION_SECONDS = 0.01;
+/// Name of the machine speed reference in the results and the baseline
+static const string CALIBRATION_NAME = "calibration";
+/// Compiler flags of the benchmark and the library, set by the benchmark target of Makefile-main and stored with the baseline
+#ifndef GMML_BENCHMARK_CXXFLAGS
+#define GMML_BENCHMARK_CXXFLAGS "unknown"
+#endif
+static const string BUILD_FLAGS_PREFIX = "# Built with: ";
+
+struct BenchmarkOptions
+{
+        BenchmarkOptions() : root("."), repetitions(5), quick(false), tolerance(0.25) {}
+        string root;                    /*!< Directory containing example/ and dat/ >*/
+        int repetitions;                /*!< Number of timed runs of each workload >*/
+        bool quick;                     /*!< Use the smaller synthetic assemblies only >*/
+        double tolerance;               /*!< Allowed slow down relative to the baseline >*/
+        string baseline;                /*!< Baseline file to compare against >*/
+        string write_baseline;          /*!< Baseline file to write >*/
+        string output;                  /*!< Tab separated result file >*/
+};
+
+struct BenchmarkResult
+{
+        string name;                    /*!< Unique name of the workload, used as baseline key >*/
+        double seconds;                 /*!< Best wall clock time of a run, used for the comparison with the baseline >*/
+        double median_seconds;          /*!< Median wall clock time of a run >*/
+        double items;                   /*!< Number of items processed in a run >*/
+        string unit;                    /*!< Unit of the items >*/
+};
+typedef vector<BenchmarkResult> BenchmarkResultVector;
+
+/*! \class
+  * A workload; Prepare and Cleanup are not timed, Run returns the number of processed items
+  */
+class Workload
+{
+    public:
+        virtual ~Workload() {}
+        virtual void Prepare() {}
+        virtual double Run() = 0;
+        virtual void Cleanup() {}
+};
+
+static string Path(const BenchmarkOptions& options, const string& relative_path)
+{
+    return options.root + "/" + relative_path;
+}
+
+static string TemporaryPath(const string& name)
+{
+    stringstream ss;
+    ss << "/tmp/gmml-benchmark-" << getpid() << "-" << name;
+    return ss.str();
+}
+
+static BenchmarkResult Measure(const BenchmarkOptions& options, const string& name, const string& unit, Workload& workload)
+{
+    vector<double> times = vector<double>();
+    double items = 0.0;
+    /// The first run only warms up the file cache and the allocator
+    for(int i = 0; i <= options.repetitions; i++)
+    {
+        workload.Prepare();
+        double start = gmml::Instrumentation::GetTime();
+        items = workload.Run();
+        double elapsed = gmml::Instrumentation::GetTime() - start;
+        workload.Cleanup();
+        if(i > 0)
+            times.push_back(elapsed);
+    }
+    sort(times.begin(), times.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.seconds = times.front();
+    result.median_seconds = times.at(times.size() / 2);
+    result.items = items;
+    result.unit = unit;
+    cout << left << setw(44) << name << right << fixed << setprecision(4) << setw(10) << result.seconds << " s (median "
+         << result.median_seconds << " s)" << setprecision(1) << setw(14) << ((result.seconds > 0.0) ? items / result.seconds : 0.0) << " " << unit << "/s" << endl;
+    return result;
+}
+
+//////////////////////////////////////////////////////////
+//                       WORKLOADS                      //
+//////////////////////////////////////////////////////////
+/*! \class
+  * Fixed amount of string, map and sorting work that does not depend on GMML; the baseline is scaled by the ratio of its
+  * times so a slower or busier machine is not reported as a regression
+  */
+class CalibrationWorkload : public Workload
+{
+    public:
+        double Run()
+        {
+            map<string, int> names = map<string, int>();
+            vector<double> values = vector<double>();
+            unsigned int seed = 12345;
+            for(int i = 0; i < 100000; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                stringstream ss;
+                ss << "ATOM" << (seed % 100000);
+                names[ss.str()] += i;
+                values.push_back((seed >> 8) * 1e-3);
+            }
+            sort(values.begin(), values.end());
+            return names.size() + values.size();
+        }
+};
+
+class PdbParseWorkload : public Workload
+{
+    public:
+        PdbParseWorkload(const string& path) : path_(path), pdb_file_(NULL) {}
+        double Run()
+        {
+            pdb_file_ = new PdbFileSpace::PdbFile(path_);
+            return CountAtomCards(path_);
+        }
+        void Cleanup()
+        {
+            delete pdb_file_;
+            pdb_file_ = NULL;
+        }
+        static double CountAtomCards(const string& path)
+        {
+            ifstream in(path.c_str());
+            string line;
+            double count = 0;
+            while(getline(in, line))
+                if(line.compare(0, 4, "ATOM") == 0 || line.compare(0, 6, "HETATM") == 0)
+                    count++;
+            return count;
+        }
+    private:
+        string path_;
+        PdbFileSpace::PdbFile* pdb_file_;
+};
+
+class PrmtopParseWorkload : public Workload
+{
+    public:
+        PrmtopParseWorkload(const vector<string>& paths) : paths_(paths) {}
+        double Run()
+        {
+            double atoms = 0;
+            for(vector<string>::iterator it = paths_.begin(); it != paths_.end(); it++)
+            {
+                TopologyFileSpace::TopologyFile* topology_file = new TopologyFileSpace::TopologyFile(*it);
+                atoms += topology_file->GetNumberOfAtoms();
+                delete topology_file;
+            }
+            return atoms;
+        }
+    private:
+        vector<string> paths_;
+};
+
+class PrmtopWriteWorkload : public Workload
+{
+    public:
+        PrmtopWriteWorkload(const vector<string>& paths) : paths_(paths) {}
+        void Prepare()
+        {
+            for(vector<string>::iterator it = paths_.begin(); it != paths_.end(); it++)
+                topology_files_.push_back(new TopologyFileSpace::TopologyFile(*it));
+        }
+        double Run()
+        {
+            double atoms = 0;
+            string path = TemporaryPath("out.parm7");
+            for(vector<TopologyFileSpace::TopologyFile*>::iterator it = topology_files_.begin(); it != topology_files_.end(); it++)
+            {
+                (*it)->Write(path);
+                atoms += (*it)->GetNumberOfAtoms();
+            }
+            remove(path.c_str());
+            return atoms;
+        }
+        void Cleanup()
+        {
+            for(vector<TopologyFileSpace::TopologyFile*>::iterator it = topology_files_.begin(); it != topology_files_.end(); it++)
+                delete (*it);
+            topology_files_.clear();
+        }
+    private:
+        vector<string> paths_;
+        vector<TopologyFileSpace::TopologyFile*> topology_files_;
+};
+
+/*! \class
+  * Bonding by distance of a synthetic assembly made of copies of a pdb file placed on a grid, one chain per copy
+  */
+class BondByDistanceWorkload : public Workload
+{
+    public:
+        BondByDistanceWorkload(const string& path, int number_of_threads) : path_(path), number_of_threads_(number_of_threads), assembly_(NULL) {}
+        void Prepare()
+        {
+            assembly_ = new Assembly();
+            assembly_->BuildAssemblyFromPdbFile(path_);
+        }
+        double Run()
+        {
+            assembly_->BuildStructureByDistance(number_of_threads_);
+            return assembly_->GetAllAtomsOfAssembly().size();
+        }
+        void Cleanup()
+        {
+            delete assembly_;
+            assembly_ = NULL;
+        }
+        /// Write a pdb file with the given number of copies of the ATOM/HETATM cards of the source file
+        static int WriteSyntheticPdbFile(const string& source_path, int copies, const string& path)
+        {
+            vector<string> atom_cards = vector<string>();
+            ifstream in(source_path.c_str());
+            string line;
+            while(getline(in, line))
+                if((line.compare(0, 4, "ATOM") == 0 || line.compare(0, 6, "HETATM") == 0) && line.size() >= 54)
+                    atom_cards.push_back(line);
+            ofstream out(path.c_str());
+            int serial_number = 1;
+            /// Copies are 60A apart, far enough for the cutoff and small enough to keep the grid compact
+            int grid_size = 1;
+            while(grid_size * grid_size * grid_size < copies)
+                grid_size++;
+            for(int copy = 0; copy < copies; copy++)
+            {
+                double offset_x = 60.0 * (copy % grid_size);
+                double offset_y = 60.0 * ((copy / grid_size) % grid_size);
+                double offset_z = 60.0 * (copy / (grid_size * grid_size));
+                char chain_id = 'A' + (copy % 26);
+                for(vector<string>::iterator it = atom_cards.begin(); it != atom_cards.end(); it++)
+                {
+                    string card = (*it);
+                    stringstream coordinates;
+                    coordinates << fixed << setprecision(3) << setw(8) << atof(card.substr(30, 8).c_str()) + offset_x
+                                << setw(8) << atof(card.substr(38, 8).c_str()) + offset_y << setw(8) << atof(card.substr(46, 8).c_str()) + offset_z;
+                    stringstream serial;
+                    serial << setw(5) << (serial_number % 100000);
+                    card.replace(6, 5, serial.str());
+                    card[21] = chain_id;
+                    card.replace(30, 24, coordinates.str());
+                    out << card << endl;
+                    serial_number++;
+                }
+                out << "TER" << endl;
+            }
+            out << "END" << endl;
+            return serial_number - 1;
+        }
+    private:
+        string path_;
+        int number_of_threads_;
+        Assembly* assembly_;
+};
+
+class SugarWorkload : public Workload
+{
+    public:
+        SugarWorkload(const string& path, const vector<string>& amino_lib_files) : path_(path), amino_lib_files_(amino_lib_files), assembly_(NULL) {}
+        void Prepare()
+        {
+            assembly_ = new Assembly();
+            assembly_->BuildAssemblyFromPdbFile(path_);
+            assembly_->BuildStructureByDistance();
+        }
+        double Run()
+        {
+            vector<Glycan::Oligosaccharide*> oligosaccharides = assembly_->ExtractSugars(amino_lib_files_);
+            return oligosaccharides.size();
+        }
+        void Cleanup()
+        {
+            delete assembly_;
+            assembly_ = NULL;
+        }
+    private:
+        string path_;
+        vector<string> amino_lib_files_;
+        Assembly* assembly_;
+};
+
+class IonizingWorkload : public Workload
+{
+    public:
+        IonizingWorkload(const string& topology_path, const string& coordinate_path, const string& lib_path, const string& parameter_path, int ion_count)
+            : topology_path_(topology_path), coordinate_path_(coordinate_path), lib_path_(lib_path), parameter_path_(parameter_path), ion_count_(ion_count), assembly_(NULL) {}
+        void Prepare()
+        {
+            assembly_ = new Assembly();
+            assembly_->BuildAssemblyFromTopologyCoordinateFile(topology_path_, coordinate_path_);
+        }
+        double Run()
+        {
+            assembly_->Ionizing("Na+", lib_path_, parameter_path_, ion_count_);
+            return ion_count_;
+        }
+        void Cleanup()
+        {
+            delete assembly_;
+            assembly_ = NULL;
+        }
+    private:
+        string topology_path_;
+        string coordinate_path_;
+        string lib_path_;
+        string parameter_path_;
+        int ion_count_;
+        Assembly* assembly_;
+};
+
+class SelectWorkload : public Workload
+{
+    public:
+        SelectWorkload(const string& path, const vector<string>& patterns) : path_(path), patterns_(patterns), assembly_(NULL) {}
+        void Prepare()
+        {
+            assembly_ = new Assembly();
+            assembly_->BuildAssemblyFromPdbFile(path_);
+        }
+        double Run()
+        {
+            double selections = 0;
+            for(vector<string>::iterator it = patterns_.begin(); it != patterns_.end(); it++)
+            {
+                assembly_->Select(*it);
+                selections++;
+            }
+            return selections;
+        }
+        void Cleanup()
+        {
+            delete assembly_;
+            assembly_ = NULL;
+        }
+    private:
+        string path_;
+        vector<string> patterns_;
+        Assembly* assembly_;
+};
+
+//////////////////////////////////////////////////////////
+//                       BASELINE                       //
+//////////////////////////////////////////////////////////
+static map<string, double> ReadBaseline(const string& path, string& build_flags)
+{
+    map<string, double> baseline = map<string, double>();
+    ifstream in(path.c_str());
+    string line;
+    while(getline(in, line))
+    {
+        if(line.compare(0, BUILD_FLAGS_PREFIX.size(), BUILD_FLAGS_PREFIX) == 0)
+            build_flags = line.substr(BUILD_FLAGS_PREFIX.size());
+        if(line.empty() || line.at(0) == '#')
+            continue;
+        stringstream ss(line);
+        string name;
+        double seconds;
+        if(ss >> name >> seconds)
+            baseline[name] = seconds;
+    }
+    return baseline;
+}
+
+static void WriteBaseline(const string& path, const BenchmarkResultVector& results)
+{
+    ofstream out(path.c_str());
+    out << "# GMML benchmark baseline: <workload> <best seconds>" << endl;
+    out << "# Regenerate on the reference machine with 'make -f Makefile-main benchmark-baseline'" << endl;
+    out << BUILD_FLAGS_PREFIX << GMML_BENCHMARK_CXXFLAGS << endl;
+    for(BenchmarkResultVector::const_iterator it = results.begin(); it != results.end(); it++)
+        out << (*it).name << " " << fixed << setprecision(6) << (*it).seconds << endl;
+}
+
+/// @return Number of regressions
+static int CompareWithBaseline(const BenchmarkOptions& options, const BenchmarkResultVector& results)
+{
+    ifstream test(options.baseline.c_str());
+    if(!test.good())
+    {
+        cout << "Baseline " << options.baseline << " not found, nothing to compare against" << endl;
+        return 0;
+    }
+    string build_flags = "";
+    map<string, double> baseline = ReadBaseline(options.baseline, build_flags);
+    /// Times of builds with other optimisation flags are not comparable, the calibration does not make up for them
+    if(build_flags.compare(GMML_BENCHMARK_CXXFLAGS) != 0)
+        cout << "Warning: the baseline has been built with '" << build_flags << "', this benchmark with '" << GMML_BENCHMARK_CXXFLAGS << "'" << endl;
+    double scale = 1.0;
+    for(BenchmarkResultVector::const_iterator it = results.begin(); it != results.end(); it++)
+        if((*it).name.compare(CALIBRATION_NAME) == 0 && baseline.find(CALIBRATION_NAME) != baseline.end() && baseline[CALIBRATION_NAME] > 0.0)
+            scale = (*it).seconds / baseline[CALIBRATION_NAME];
+    int regressions = 0;
+    cout << endl << "Comparison with " << options.baseline << " (tolerance " << fixed << setprecision(0) << options.tolerance * 100
+         << "%, baseline scaled by " << setprecision(2) << scale << " from the calibration)" << endl;
+    for(BenchmarkResultVector::const_iterator it = results.begin(); it != results.end(); it++)
+    {
+        map<string, double>::iterator found = baseline.find((*it).name);
+        if(found == baseline.end() || (*it).name.compare(CALIBRATION_NAME) == 0)
+            continue;
+        double reference = found->second * scale;
+        double change = (reference > 0.0) ? ((*it).seconds - reference) / reference : 0.0;
+        bool regressed = change > options.tolerance && (*it).seconds - reference > MINIMUM_REGRESSION_SECONDS;
+        cout << left << setw(44) << (*it).name << right << fixed << setprecision(4) << setw(10) << reference << " s ->" << setw(10) << (*it).seconds
+             << " s" << showpos << setprecision(1) << setw(9) << change * 100 << "%" << noshowpos << (regressed ? "  REGRESSION" : "") << endl;
+        if(regressed)
+            regressions++;
+    }
+    return regressions;
+}
+
+//////////////////////////////////////////////////////////
+//                         MAIN                         //
+//////////////////////////////////////////////////////////
+static void PrintUsage()
+{
+    cout << "Usage: gmml-benchmark [--root dir] [--repetitions n] [--quick] [--baseline file] [--write-baseline file]"
+         << " [--tolerance fraction] [--output file]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options = BenchmarkOptions();
+    for(int i = 1; i < argc; i++)
+    {
+        string argument = string(argv[i]);
+        bool has_value = i + 1 < argc;
+        if(argument.compare("--root") == 0 && has_value)
+            options.root = argv[++i];
+        else if(argument.compare("--repetitions") == 0 && has_value)
+            options.repetitions = max(1, atoi(argv[++i]));
+        else if(argument.compare("--quick") == 0)
+            options.quick = true;
+        else if(argument.compare("--baseline") == 0 && has_value)
+            options.baseline = argv[++i];
+        else if(argument.compare("--write-baseline") == 0 && has_value)
+            options.write_baseline = argv[++i];
+        else if(argument.compare("--tolerance") == 0 && has_value)
+            options.tolerance = atof(argv[++i]);
+        else if(argument.compare("--output") == 0 && has_value)
+            options.output = argv[++i];
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    /// Log files would only measure the disk
+    gmml::Logger::Disable();
+
+    BenchmarkResultVector results = BenchmarkResultVector();
+    vector<string> amino_lib_files = vector<string>();
+    amino_lib_files.push_back(Path(options, "dat/CurrentParams/leaprc.ff12SB_2014-04-24/amino12.lib"));
+    vector<string> prmtop_files = vector<string>();
+    const char* prmtop_names[] = {"OME-0OB", "ROH-0LA", "ROH-0LB", "ROH-0OA", "ROH-3OA-3OA-3OA-0OA", "ROH-3OA-3OB-3OA-0OB",
+                                  "ROH-3OB-3OB-3OB-0OB", "ROH-4MA-4GA-4MB-0GA", "TBT-0GA", "TBT-0OA"};
+    for(unsigned int i = 0; i < sizeof(prmtop_names) / sizeof(prmtop_names[0]); i++)
+        prmtop_files.push_back(Path(options, "example/parm7/" + string(prmtop_names[i]) + ".parm7"));
+
+    cout << "== Calibration" << endl;
+    CalibrationWorkload calibration;
+    results.push_back(Measure(options, CALIBRATION_NAME, "items", calibration));
+
+    cout << endl << "== Parsing" << endl;
+    const char* pdb_names[] = {"1UBQ", "1NXC", "1Z7E"};
+    for(unsigned int i = 0; i < sizeof(pdb_names) / sizeof(pdb_names[0]); i++)
+    {
+        if(options.quick && string(pdb_names[i]).compare("1Z7E") == 0)
+            continue;
+        PdbParseWorkload pdb_parse(Path(options, "example/pdb/" + string(pdb_names[i]) + ".pdb"));
+        results.push_back(Measure(options, "pdb_parse/" + string(pdb_names[i]), "atoms", pdb_parse));
+    }
+    PrmtopParseWorkload prmtop_parse(prmtop_files);
+    results.push_back(Measure(options, "prmtop_parse/example_parm7", "atoms", prmtop_parse));
+    PrmtopWriteWorkload prmtop_write(prmtop_files);
+    results.push_back(Measure(options, "prmtop_write/example_parm7", "atoms", prmtop_write));
+
+    cout << endl << "== Bond by distance (synthetic copies of 1UBQ)" << endl;
+    vector<int> copy_counts = vector<int>();
+    copy_counts.push_back(1);
+    copy_counts.push_back(2);
+    copy_counts.push_back(4);
+    if(!options.quick)
+        copy_counts.push_back(8);
+    vector<int> thread_counts = vector<int>();
+    thread_counts.push_back(1);
+    thread_counts.push_back(2);
+    thread_counts.push_back(4);
+    map<int, map<int, double> > scaling = map<int, map<int, double> >();
+    map<int, int> atom_counts = map<int, int>();
+    for(vector<int>::iterator it = copy_counts.begin(); it != copy_counts.end(); it++)
+    {
+        stringstream synthetic_name;
+        synthetic_name << "synthetic-" << (*it) << ".pdb";
+        string synthetic_path = TemporaryPath(synthetic_name.str());
+        int atoms = BondByDistanceWorkload::WriteSyntheticPdbFile(Path(options, "example/pdb/1UBQ.pdb"), (*it), synthetic_path);
+        atom_counts[*it] = atoms;
+        for(vector<int>::iterator it1 = thread_counts.begin(); it1 != thread_counts.end(); it1++)
+        {
+            stringstream name;
+            name << "bond_by_distance/atoms_" << atoms << "/threads_" << (*it1);
+            BondByDistanceWorkload bond_by_distance(synthetic_path, (*it1));
+            BenchmarkResult result = Measure(options, name.str(), "atoms", bond_by_distance);
+            scaling[*it][*it1] = result.seconds;
+            results.push_back(result);
+        }
+        remove(synthetic_path.c_str());
+    }
+    cout << endl << "Scaling (speedup over 1 thread)" << endl << setw(10) << "atoms";
+    for(vector<int>::iterator it = thread_counts.begin(); it != thread_counts.end(); it++)
+        cout << setw(10) << (*it);
+    cout << endl;
+    for(vector<int>::iterator it = copy_counts.begin(); it != copy_counts.end(); it++)
+    {
+        cout << setw(10) << atom_counts[*it];
+        for(vector<int>::iterator it1 = thread_counts.begin(); it1 != thread_counts.end(); it1++)
+            cout << setw(10) << fixed << setprecision(2) << ((scaling[*it][*it1] > 0.0) ? scaling[*it][1] / scaling[*it][*it1] : 0.0);
+        cout << endl;
+    }
+
+    cout << endl << "== Ring perception and sugar naming" << endl;
+    SugarWorkload glycoprotein(Path(options, "example/pdb/1NXC.pdb"), amino_lib_files);
+    results.push_back(Measure(options, "extract_sugars/1NXC", "oligosaccharides", glycoprotein));
+
+    cout << endl << "== Ionizing" << endl;
+    IonizingWorkload ionizing(Path(options, "example/parm7/OME-0OB.parm7"), Path(options, "example/rst7/OME-0OB.rst7"),
+                              Path(options, "dat/CurrentParams/other/atomic_ions.lib"), Path(options, "dat/frcmod/frcmod.ionsjc_tip3p"), 2);
+    results.push_back(Measure(options, "ionizing/OME-0OB", "ions", ionizing));
+
+    cout << endl << "== Select" << endl;
+    vector<string> patterns = vector<string>();
+    patterns.push_back("1.*:ALA,GLY@CA");
+    patterns.push_back("1.*:ALA@^C");
+    patterns.push_back("1.*:NAG@C1");
+    patterns.push_back("1:#520,MAN,GAL@#3740-3750");
+    SelectWorkload select(Path(options, "example/pdb/1NXC.pdb"), patterns);
+    results.push_back(Measure(options, "select/1NXC", "selections", select));
+
+    if(!options.output.empty())
+    {
+        ofstream out(options.output.c_str());
+        out << "name\tseconds\tmedian_seconds\titems\tunit" << endl;
+        for(BenchmarkResultVector::iterator it = results.begin(); it != results.end(); it++)
+            out << (*it).name << "\t" << fixed << setprecision(6) << (*it).seconds << "\t" << (*it).median_seconds << "\t" << (*it).items << "\t" << (*it).unit << endl;
+    }
+    if(!options.write_baseline.empty())
+    {
+        WriteBaseline(options.write_baseline, results);
+        cout << endl << "Baseline written to " << options.write_baseline << endl;
+    }
+    if(!options.baseline.empty())
+    {
+        int regressions = CompareWithBaseline(options, results);
+        if(regressions > 0)
+        {
+            cout << regressions << " workload(s) regressed" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -18,6 +18,10 @@ namespace GeometryTopology
             Cell(Grid* grid, GeometryTopology::Coordinate* min, GeometryTopology::Coordinate* max);
             Cell(GeometryTopology::Coordinate* min, GeometryTopology::Coordinate* max, double charge, double potential_energy);
             Cell(Grid* grid, GeometryTopology::Coordinate* min, GeometryTopology::Coordinate* max, double charge, double potential_energy);
+            /*! \fn
+              * The corners are copied into the cell and deleted with it
+              */
+            ~Cell();
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
@@ -43,7 +47,7 @@ namespace GeometryTopology
             //////////////////////////////////////////////////////////+
             //                         FUNCTIONS                    //
             //////////////////////////////////////////////////////////
-            GeometryTopology::Coordinate* GetCellCenter();
+            GeometryTopology::Coordinate GetCellCenter();
             void CalculateCellCharge();
             void CalculateCellPotentialEnergy(double ion_radius);
             void CalculateBoxCharge();
@@ -60,6 +64,9 @@ namespace GeometryTopology
             void Print(std::ostream& out = std::cout);
 
     private:
+            Cell(const Cell&);
+            Cell& operator=(const Cell&);
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
@@ -0,0 +1,114 @@
+#ifndef CELLLIST_HPP
+#define CELLLIST_HPP
+
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "coordinate.hpp"
+#include "unitcell.hpp"
+
+namespace GeometryTopology
+{
+    /*! \class
+      * Spatial binning of a set of positions into cells no smaller than a cutoff, so that neighbour searches
+      * only have to look at the surrounding cells. If a unit cell is given the binning is done in fractional
+      * space, neighbouring cells wrap around the box and distances follow the minimum image convention.
+      */
+    class CellList
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Coordinate*> CoordinateVector;
+            typedef std::pair<int, int> IndexPair;
+            typedef std::vector<IndexPair> IndexPairVector;
+
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              */
+            CellList();
+            /*! \fn
+              * Constructor that bins the given positions
+              * @param coordinates Positions to be binned; indices into this vector are used in all results
+              * @param cutoff Neighbour cutoff; the cells are at least this wide
+              * @param unit_cell Periodic box of the positions, NULL for an open (non-periodic) system
+              */
+            CellList(CoordinateVector coordinates, double cutoff, UnitCell* unit_cell = NULL);
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            double GetCutoff();
+            UnitCell* GetUnitCell();
+            CoordinateVector GetCoordinates();
+            /*! \fn
+              * An accessor function in order to access to the number of cells along one axis
+              * @param axis Index of the axis (0, 1 or 2); for a periodic system this is the box vector index
+              * @return Number of cells along the given axis
+              */
+            int GetNumberOfCells(int axis);
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * (Re)bin the given positions
+              * @param coordinates Positions to be binned
+              * @param cutoff Neighbour cutoff; the cells are at least this wide
+              * @param unit_cell Periodic box of the positions, NULL for an open (non-periodic) system
+              */
+            void Build(CoordinateVector coordinates, double cutoff, UnitCell* unit_cell = NULL);
+            /*! \fn
+              * Find all pairs of binned positions that are closer than the cutoff
+              * @return List of index pairs (i, j) with i < j
+              */
+            IndexPairVector FindPairsWithinCutoff();
+            /*! \fn
+              * Find all binned positions that are closer than the given distance to a query position
+              * @param position The query position; it does not need to be one of the binned positions
+              * @param distance Search radius; must not be larger than the cutoff the list has been built with
+              * @return Indices of the binned positions within the given distance
+              */
+            std::vector<int> FindNeighbors(Coordinate* position, double distance);
+            /*! \fn
+              * Squared distance between two binned positions, using the minimum image convention for periodic systems
+              * @param first Index of the first position
+              * @param second Index of the second position
+              * @return Squared distance between the two positions
+              */
+            double SquaredDistance(int first, int second);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            void GetCellIndices(Coordinate* position, int cell_indices[3]);
+            int GetCellKey(int i, int j, int k);
+            std::vector<int> GetNeighborCellKeys(int cell_indices[3]);
+            double SquaredDistance(Coordinate* first, Coordinate* second);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            CoordinateVector coordinates_;          /*!< Binned positions >*/
+            double cutoff_;                         /*!< Neighbour cutoff the cells have been sized for >*/
+            UnitCell* unit_cell_;                   /*!< Periodic box, NULL for an open system >*/
+            int number_of_cells_[3];                /*!< Number of cells along each axis >*/
+            double origin_[3];                      /*!< Lower corner of the bounding box of an open system >*/
+            double cell_size_[3];                   /*!< Cell edge length of an open system >*/
+            std::vector<int> cell_heads_;           /*!< Index of the first position of each cell, -1 for an empty cell >*/
+            std::vector<int> next_;                 /*!< Index of the next position in the same cell, -1 at the end of a cell >*/
+    };
+}
+
+#endif // CELLLIST_HPP
@@ -5,9 +5,11 @@
 #include <iomanip>
 #include <iostream>
 
+#include "../memoryarena.hpp"
+
 namespace GeometryTopology
 {
-    class Coordinate
+    class Coordinate : public gmml::ArenaAllocated<Coordinate>
     {
         public:
             //////////////////////////////////////////////////////////
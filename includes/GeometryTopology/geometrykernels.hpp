@@ -0,0 +1,84 @@
+#ifndef GEOMETRYKERNELS_HPP
+#define GEOMETRYKERNELS_HPP
+
+#include <vector>
+
+#include "coordinate.hpp"
+#include "vector3.hpp"
+
+namespace GeometryTopology
+{
+    typedef std::vector<Vector3> Vector3Vector;
+
+    /*! \fn
+      * Copy a list of coordinates into a contiguous list of vectors
+      * @param coordinates List of coordinates
+      * @return List of vectors in the same order
+      */
+    Vector3Vector GatherCoordinates(const std::vector<Coordinate*>& coordinates);
+    /*! \fn
+      * Write a list of vectors back into a list of coordinates of the same size
+      * @param vectors List of vectors
+      * @param coordinates List of coordinates that have to be updated
+      */
+    void ScatterCoordinates(const Vector3Vector& vectors, const std::vector<Coordinate*>& coordinates);
+
+    /*! \fn
+      * Translate all the given positions by the same offset
+      * @param positions List of positions that have to be moved
+      * @param offset Translation vector
+      */
+    void TranslateCoordinates(Vector3Vector& positions, const Vector3& offset);
+    void TranslateCoordinates(const std::vector<Coordinate*>& coordinates, const Vector3& offset);
+    /*! \fn
+      * Apply a rigid transformation (rotation * p + translation) to all the given positions
+      * @param positions List of positions that have to be moved
+      * @param rotation Rotation matrix
+      * @param translation Translation vector applied after the rotation
+      */
+    void TransformCoordinates(Vector3Vector& positions, const Matrix3& rotation, const Vector3& translation);
+    void TransformCoordinates(const std::vector<Coordinate*>& coordinates, const Matrix3& rotation, const Vector3& translation);
+    /*! \fn
+      * Rotate all the given positions around a point
+      * @param positions List of positions that have to be moved
+      * @param rotation Rotation matrix
+      * @param origin The point that stays in place
+      */
+    void RotateCoordinates(Vector3Vector& positions, const Matrix3& rotation, const Vector3& origin);
+    void RotateCoordinates(const std::vector<Coordinate*>& coordinates, const Matrix3& rotation, const Vector3& origin);
+
+    /*! \fn
+      * Calculate the geometric center of the given positions
+      * @param positions List of positions
+      * @return Centroid of the positions, zero vector if the list is empty
+      */
+    Vector3 CalculateCentroid(const Vector3Vector& positions);
+    Vector3 CalculateCentroid(const std::vector<Coordinate*>& coordinates);
+    /*! \fn
+      * Calculate the root mean square deviation between two lists of positions of the same size, without superposition
+      * @param positions First list of positions
+      * @param reference_positions Second list of positions
+      * @return RMSD of the two lists, dNotSet if the sizes are different or the lists are empty
+      */
+    double CalculateRMSD(const Vector3Vector& positions, const Vector3Vector& reference_positions);
+    double CalculateRMSD(const std::vector<Coordinate*>& coordinates, const std::vector<Coordinate*>& reference_coordinates);
+    /*! \fn
+      * Calculate the distances between all pairs of the given positions
+      * @param positions List of n positions
+      * @return Row major n x n matrix of distances
+      */
+    std::vector<double> CalculateDistanceMatrix(const Vector3Vector& positions);
+    std::vector<double> CalculateDistanceMatrix(const std::vector<Coordinate*>& coordinates);
+
+    /*! \fn
+      * Convert internal coordinate to the corresponding cartesian coordinate
+      * @param reference_positions List of at most three cartesian positions (great grandparent, grandparent, parent) that the internal coordinate refers to
+      * @param distance Distance from the parent
+      * @param angle Angle in degree between the position, the parent and the grandparent
+      * @param torsion Torsion in degree between the position, the parent, the grandparent and the great grandparent
+      * @return Cartesian position of the internal coordinate (distance, angle, torsion)
+      */
+    Vector3 ConvertInternalCoordinate2CartesianCoordinate(const Vector3Vector& reference_positions, double distance, double angle, double torsion);
+}
+
+#endif // GEOMETRYKERNELS_HPP
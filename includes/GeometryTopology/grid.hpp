@@ -21,6 +21,10 @@ namespace GeometryTopology
             //////////////////////////////////////////////////////////
             Grid();
             Grid(MolecularModeling::Assembly* assembly, Coordinate* min, Coordinate* max, double ion_radius, double ion_charge);
+            /*! \fn
+              * The grid owns its corners and its cells
+              */
+            ~Grid();
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
@@ -60,6 +64,9 @@ namespace GeometryTopology
             void Print(std::ostream& out = std::cout);
 
     private:
+            Grid(const Grid&);
+            Grid& operator=(const Grid&);
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
@@ -0,0 +1,171 @@
+#ifndef UNITCELL_HPP
+#define UNITCELL_HPP
+
+#include <iostream>
+#include <string>
+
+#include "coordinate.hpp"
+
+namespace GeometryTopology
+{
+    class UnitCell
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor; the cell is left unset (no periodicity)
+              */
+            UnitCell();
+            /*! \fn
+              * Constructor with the crystallographic cell parameters
+              * @param a Length of the first box vector in Angstrom
+              * @param b Length of the second box vector in Angstrom
+              * @param c Length of the third box vector in Angstrom
+              * @param alpha Angle between b and c in degree
+              * @param beta Angle between a and c in degree
+              * @param gamma Angle between a and b in degree
+              */
+            UnitCell(double a, double b, double c, double alpha = 90.0, double beta = 90.0, double gamma = 90.0);
+            /*! \fn
+              * Copy constructor
+              * @param unit_cell A unit cell to be copied to another instance
+              */
+            UnitCell(const UnitCell& unit_cell);
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            double GetA();
+            double GetB();
+            double GetC();
+            double GetAlpha();
+            double GetBeta();
+            double GetGamma();
+            /*! \fn
+              * An accessor function in order to access to one of the box vectors of the cell
+              * Box vectors are stored in the usual lower triangular form: a along x and b in the xy plane
+              * @param index Index of the box vector (0, 1 or 2)
+              * @return The requested box vector
+              */
+            Coordinate GetBoxVector(int index);
+
+            //////////////////////////////////////////////////////////
+            //                           MUTATOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A mutator function in order to set all the cell parameters at once and rebuild the box matrices
+              * @param a Length of the first box vector in Angstrom
+              * @param b Length of the second box vector in Angstrom
+              * @param c Length of the third box vector in Angstrom
+              * @param alpha Angle between b and c in degree
+              * @param beta Angle between a and c in degree
+              * @param gamma Angle between a and b in degree
+              */
+            void SetCellParameters(double a, double b, double c, double alpha, double beta, double gamma);
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Check if the cell has been given valid (positive, finite) dimensions
+              * @return True if the cell can be used for periodic calculations
+              */
+            bool IsSet();
+            /*! \fn
+              * Check if the cell can be used as a periodic box for neighbour searches
+              * Other space groups need their symmetry operators to build the neighbouring images, and 1 1 1 is the placeholder cell of non-crystal structures
+              * @param space_group Space group of the cell as given by the file; a simulation box such as the one of a restart file is P 1
+              * @return True if the cell is set, the space group is P 1 and the cell is not the placeholder
+              */
+            bool IsPeriodicBox(std::string space_group = "P 1");
+            /*! \fn
+              * Check if all cell angles are right angles
+              * @return True if the cell is orthorhombic
+              */
+            bool IsOrthorhombic();
+            /*! \fn
+              * Volume of the cell
+              * @return Volume of the cell in cubic Angstrom
+              */
+            double GetVolume();
+            /*! \fn
+              * Perpendicular distance between the pair of cell faces that are spanned by the other two box vectors
+              * The number of neighbour search cells along a box vector is limited by this width
+              * @param index Index of the box vector (0, 1 or 2)
+              * @return Perpendicular width of the cell along the given box vector
+              */
+            double GetPerpendicularWidth(int index);
+            /*! \fn
+              * Convert a cartesian position to fractional coordinates of the cell
+              * @param x X value of the cartesian position
+              * @param y Y value of the cartesian position
+              * @param z Z value of the cartesian position
+              * @param fractional Output array of three fractional coordinates
+              */
+            void CartesianToFractional(double x, double y, double z, double fractional[3]);
+            /*! \fn
+              * Convert fractional coordinates of the cell to a cartesian position
+              * @param fractional Array of three fractional coordinates
+              * @param cartesian Output array of three cartesian values
+              */
+            void FractionalToCartesian(const double fractional[3], double cartesian[3]);
+            /*! \fn
+              * Replace a displacement vector by its shortest periodic image (minimum image convention)
+              * @param dx X value of the displacement, updated in place
+              * @param dy Y value of the displacement, updated in place
+              * @param dz Z value of the displacement, updated in place
+              */
+            void MinimumImage(double& dx, double& dy, double& dz);
+            /*! \fn
+              * Calculate the square of the minimum image distance between two positions
+              * @param first First position
+              * @param second Second position
+              * @return Squared distance between the closest periodic images of the two positions
+              */
+            double MinimumImageSquaredDistance(Coordinate* first, Coordinate* second);
+            /*! \fn
+              * Calculate the minimum image distance between two positions
+              * @param first First position
+              * @param second Second position
+              * @return Distance between the closest periodic images of the two positions
+              */
+            double MinimumImageDistance(Coordinate* first, Coordinate* second);
+            /*! \fn
+              * Move a position to its periodic image that lies inside the primary cell
+              * @param coordinate Position to be wrapped, updated in place
+              */
+            void Wrap(Coordinate* coordinate);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to print out the cell parameters and box vectors
+              * @param out An output stream, the print result will be written in the given output stream
+              */
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            void UpdateBoxMatrices();
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            double a_;                          /*!< Length of the first box vector >*/
+            double b_;                          /*!< Length of the second box vector >*/
+            double c_;                          /*!< Length of the third box vector >*/
+            double alpha_;                      /*!< Angle between b and c in degree >*/
+            double beta_;                       /*!< Angle between a and c in degree >*/
+            double gamma_;                      /*!< Angle between a and b in degree >*/
+            double box_[3][3];                  /*!< Box vectors as rows; a along x, b in the xy plane >*/
+            double inverse_box_[3][3];          /*!< Inverse of the box matrix, used for cartesian to fractional conversion >*/
+            bool orthorhombic_;                 /*!< Cached result of the right angle test >*/
+    };
+}
+
+#endif // UNITCELL_HPP
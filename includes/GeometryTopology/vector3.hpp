@@ -0,0 +1,192 @@
+#ifndef VECTOR3_HPP
+#define VECTOR3_HPP
+
+#include <math.h>
+#include <ostream>
+#include <iostream>
+
+#include "coordinate.hpp"
+
+namespace GeometryTopology
+{
+    /*! \class
+      * A three dimensional vector with value semantics
+      * Unlike Coordinate, all operations return a new vector and never change their operands, so temporaries of geometric
+      * calculations can live on the stack instead of being allocated with new
+      */
+    class Vector3
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, zero vector
+              */
+            constexpr Vector3() : x_(0.0), y_(0.0), z_(0.0) {}
+            /*! \fn
+              * Constructor with given three double values
+              * @param x A double value on X axis
+              * @param y A double value on Y axis
+              * @param z A double value on Z axis
+              */
+            constexpr Vector3(double x, double y, double z) : x_(x), y_(y), z_(z) {}
+            /*! \fn
+              * Constructor that copies the values of a coordinate
+              * @param coordinate A coordinate to be copied
+              */
+            explicit Vector3(Coordinate& coordinate) : x_(coordinate.GetX()), y_(coordinate.GetY()), z_(coordinate.GetZ()) {}
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            constexpr double GetX() const { return x_; }
+            constexpr double GetY() const { return y_; }
+            constexpr double GetZ() const { return z_; }
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            constexpr Vector3 operator+(const Vector3& vector) const { return Vector3(x_ + vector.x_, y_ + vector.y_, z_ + vector.z_); }
+            constexpr Vector3 operator-(const Vector3& vector) const { return Vector3(x_ - vector.x_, y_ - vector.y_, z_ - vector.z_); }
+            constexpr Vector3 operator-() const { return Vector3(-x_, -y_, -z_); }
+            constexpr Vector3 operator*(double multiplier) const { return Vector3(x_ * multiplier, y_ * multiplier, z_ * multiplier); }
+            constexpr Vector3 operator/(double divisor) const { return Vector3(x_ / divisor, y_ / divisor, z_ / divisor); }
+            Vector3& operator+=(const Vector3& vector) { x_ += vector.x_; y_ += vector.y_; z_ += vector.z_; return *this; }
+            Vector3& operator-=(const Vector3& vector) { x_ -= vector.x_; y_ -= vector.y_; z_ -= vector.z_; return *this; }
+            /*! \fn
+              * Calculate the dot product of current object and the given one
+              * @param vector Second vector in the dot product operator
+              * @return Dot product value of two vectors
+              */
+            constexpr double DotProduct(const Vector3& vector) const { return x_ * vector.x_ + y_ * vector.y_ + z_ * vector.z_; }
+            /*! \fn
+              * Calculate the cross product of current object and the given one
+              * @param vector Second vector in the cross product operator
+              * @return Cross product vector of two vectors
+              */
+            constexpr Vector3 CrossProduct(const Vector3& vector) const
+            {
+                return Vector3(y_ * vector.z_ - z_ * vector.y_, z_ * vector.x_ - x_ * vector.z_, x_ * vector.y_ - y_ * vector.x_);
+            }
+            constexpr double SquaredLength() const { return x_ * x_ + y_ * y_ + z_ * z_; }
+            double Length() const { return sqrt(this->SquaredLength()); }
+            /*! \fn
+              * Calculate the unit vector in the direction of the current object
+              * @return Normalized vector, or the zero vector if the length is zero
+              */
+            Vector3 Normalized() const
+            {
+                double length = this->Length();
+                return (length != 0.0) ? (*this / length) : *this;
+            }
+            constexpr double SquaredDistance(const Vector3& vector) const { return (*this - vector).SquaredLength(); }
+            double Distance(const Vector3& vector) const { return sqrt(this->SquaredDistance(vector)); }
+            /*! \fn
+              * Write the values of the current object into a coordinate
+              * @param coordinate The coordinate that has to be updated
+              */
+            void CopyTo(Coordinate* coordinate) const
+            {
+                coordinate->SetX(x_);
+                coordinate->SetY(y_);
+                coordinate->SetZ(z_);
+            }
+            Coordinate ToCoordinate() const { return Coordinate(x_, y_, z_); }
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            void Print(std::ostream& out = std::cout) const
+            {
+                out << std::setw(10) << x_ << ", " << std::setw(10) << y_ << ", " << std::setw(10) << z_;
+            }
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            double x_;          /*!< x */
+            double y_;          /*!< y */
+            double z_;          /*!< z */
+    };
+
+    constexpr Vector3 operator*(double multiplier, const Vector3& vector) { return vector * multiplier; }
+
+    /*! \class
+      * A 3x3 matrix with value semantics, stored by rows
+      * Used for rotations; a rigid transformation of a point p is rotation * p + translation
+      */
+    class Matrix3
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, identity matrix
+              */
+            constexpr Matrix3() : row0_(1.0, 0.0, 0.0), row1_(0.0, 1.0, 0.0), row2_(0.0, 0.0, 1.0) {}
+            /*! \fn
+              * Constructor with given rows
+              */
+            constexpr Matrix3(const Vector3& row0, const Vector3& row1, const Vector3& row2) : row0_(row0), row1_(row1), row2_(row2) {}
+            /*! \fn
+              * Build a matrix whose columns are the given vectors
+              */
+            static constexpr Matrix3 FromColumns(const Vector3& column0, const Vector3& column1, const Vector3& column2)
+            {
+                return Matrix3(Vector3(column0.GetX(), column1.GetX(), column2.GetX()),
+                               Vector3(column0.GetY(), column1.GetY(), column2.GetY()),
+                               Vector3(column0.GetZ(), column1.GetZ(), column2.GetZ()));
+            }
+            /*! \fn
+              * Build the rotation matrix around an axis through the origin, following the right hand rule
+              * @param axis Direction of the rotation axis, it does not need to be normalized
+              * @param angle Rotation angle in radian
+              */
+            static Matrix3 RotationAroundAxis(const Vector3& axis, double angle)
+            {
+                Vector3 n = axis.Normalized();
+                double u = n.GetX();
+                double v = n.GetY();
+                double w = n.GetZ();
+                double cos_angle = cos(angle);
+                double sin_angle = sin(angle);
+                double t = 1 - cos_angle;
+                return Matrix3(Vector3(u * u * t + cos_angle, u * v * t - w * sin_angle, u * w * t + v * sin_angle),
+                               Vector3(u * v * t + w * sin_angle, v * v * t + cos_angle, v * w * t - u * sin_angle),
+                               Vector3(u * w * t - v * sin_angle, v * w * t + u * sin_angle, w * w * t + cos_angle));
+            }
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            constexpr Vector3 GetRow0() const { return row0_; }
+            constexpr Vector3 GetRow1() const { return row1_; }
+            constexpr Vector3 GetRow2() const { return row2_; }
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            constexpr Vector3 operator*(const Vector3& vector) const
+            {
+                return Vector3(row0_.DotProduct(vector), row1_.DotProduct(vector), row2_.DotProduct(vector));
+            }
+            constexpr Matrix3 Transposed() const { return FromColumns(row0_, row1_, row2_); }
+            constexpr Matrix3 operator*(const Matrix3& matrix) const
+            {
+                return Matrix3(matrix.Transposed() * row0_, matrix.Transposed() * row1_, matrix.Transposed() * row2_);
+            }
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            Vector3 row0_;      /*!< First row */
+            Vector3 row1_;      /*!< Second row */
+            Vector3 row2_;      /*!< Third row */
+    };
+}
+
+#endif // VECTOR3_HPP
@@ -0,0 +1,150 @@
+#ifndef CIFATOMSITE_HPP
+#define CIFATOMSITE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+
+namespace CifFileSpace
+{
+    /*! \class
+      * Rows of the _atom_site loop of an mmCIF file, kept column by column
+      * Each attribute of the atoms is a vector with one entry per row in file order, so no object is created per atom. Where a
+      * file has both, the author (auth_*) identifiers are kept as they match the identifiers of the same structure in pdb format;
+      * the label_* identifiers are used for the rows that have no author identifier. Chain identifiers, residue names and atom
+      * names are strings of any length, and the number of atoms is not limited by the fixed columns of the pdb format.
+      */
+    class CifAtomSite
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            /*! \enum
+              * Items of the _atom_site category that are read; every other item of the loop is skipped
+              */
+            enum Item
+            {
+                kGroup,
+                kId,
+                kTypeSymbol,
+                kLabelAtomId,
+                kAuthAtomId,
+                kLabelAltId,
+                kLabelCompId,
+                kAuthCompId,
+                kLabelAsymId,
+                kAuthAsymId,
+                kLabelSeqId,
+                kAuthSeqId,
+                kInsertionCode,
+                kCartnX,
+                kCartnY,
+                kCartnZ,
+                kOccupancy,
+                kBFactor,
+                kFormalCharge,
+                kModelNumber,
+                kUnknownItem
+            };
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            CifAtomSite();
+
+            //////////////////////////////////////////////////////////
+            //                         ACCESSOR                     //
+            //////////////////////////////////////////////////////////
+            int GetNumberOfRows() const;
+            /*! \fn
+              * True for a HETATM row, false for an ATOM row
+              */
+            bool GetIsHeterogen(int row) const;
+            int GetSerialNumber(int row) const;
+            const std::string& GetElementSymbol(int row) const;
+            const std::string& GetAtomName(int row) const;
+            /*! \fn
+              * Alternate location of the atom, empty if the file has none ('.' or '?')
+              */
+            const std::string& GetAlternateLocation(int row) const;
+            const std::string& GetResidueName(int row) const;
+            const std::string& GetChainId(int row) const;
+            /*! \fn
+              * @return The sequence number of the residue of the atom, gmml::iNotSet if the file has none
+              */
+            int GetResidueSequenceNumber(int row) const;
+            /*! \fn
+              * Insertion code of the residue of the atom, empty if the file has none
+              */
+            const std::string& GetInsertionCode(int row) const;
+            double GetX(int row) const;
+            double GetY(int row) const;
+            double GetZ(int row) const;
+            double GetOccupancy(int row) const;
+            double GetTemperatureFactor(int row) const;
+            const std::string& GetFormalCharge(int row) const;
+            /*! \fn
+              * @return The model number of the row, 1 if the file has no pdbx_PDB_model_num item
+              */
+            int GetModelNumber(int row) const;
+
+            //////////////////////////////////////////////////////////
+            //                          MUTATOR                     //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Append a row with all items unset; the items of the row are set afterwards with SetValue
+              */
+            void AddRow();
+            /*! \fn
+              * Set an item of the last row from its value in the file
+              * @param item The item the value belongs to
+              * @param value The value as it is written in the file without quotes; '.' and '?' leave the item unset
+              */
+            void SetValue(Item item, std::string_view value);
+            /*! \fn
+              * Reserve space for the given number of rows in every column
+              */
+            void Reserve(int number_of_rows);
+            void Clear();
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Item of an _atom_site tag of the file
+              * @param tag A tag of the _atom_site category without the category, e.g. "Cartn_x"
+              * @return The corresponding item, kUnknownItem for an item that is not read
+              */
+            static Item GetItem(std::string_view tag);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::vector<char> is_heterogen_;                    /*!< 1 for HETATM rows, 0 for ATOM rows >*/
+            std::vector<int> serial_numbers_;                   /*!< _atom_site.id >*/
+            std::vector<std::string> element_symbols_;          /*!< _atom_site.type_symbol >*/
+            std::vector<std::string> atom_names_;               /*!< _atom_site.auth_atom_id, label_atom_id if not set >*/
+            std::vector<std::string> alternate_locations_;      /*!< _atom_site.label_alt_id >*/
+            std::vector<std::string> residue_names_;            /*!< _atom_site.auth_comp_id, label_comp_id if not set >*/
+            std::vector<std::string> chain_ids_;                /*!< _atom_site.auth_asym_id, label_asym_id if not set >*/
+            std::vector<int> residue_sequence_numbers_;         /*!< _atom_site.auth_seq_id, label_seq_id if not set >*/
+            std::vector<std::string> insertion_codes_;          /*!< _atom_site.pdbx_PDB_ins_code >*/
+            std::vector<double> x_;                             /*!< _atom_site.Cartn_x >*/
+            std::vector<double> y_;                             /*!< _atom_site.Cartn_y >*/
+            std::vector<double> z_;                             /*!< _atom_site.Cartn_z >*/
+            std::vector<double> occupancies_;                   /*!< _atom_site.occupancy >*/
+            std::vector<double> temperature_factors_;           /*!< _atom_site.B_iso_or_equiv >*/
+            std::vector<std::string> formal_charges_;           /*!< _atom_site.pdbx_formal_charge >*/
+            std::vector<int> model_numbers_;                    /*!< _atom_site.pdbx_PDB_model_num >*/
+    };
+}
+
+#endif // CIFATOMSITE_HPP
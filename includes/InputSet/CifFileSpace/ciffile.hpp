@@ -0,0 +1,140 @@
+#ifndef CIFFILE_HPP
+#define CIFFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+#include "../../GeometryTopology/unitcell.hpp"
+#include "cifatomsite.hpp"
+
+/*! \namespace CifFileSpace */
+namespace CifFileSpace
+{
+    /*! \class
+      * Reader of the coordinates of an mmCIF (PDBx) file
+      * The file is streamed line by line and only the _atom_site loop, the _cell parameters and the space group of the first
+      * data block are kept; the values of the loop go straight into the columns of a CifAtomSite without a per-atom object, which is what
+      * makes the reader suitable for the large assemblies that do not fit into the pdb format. Every other category is
+      * tokenized only to find where it ends, including the quoted values and the multi-line text fields of the format.
+      */
+    class CifFile
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              */
+            CifFile();
+            /*! \fn
+              * Constructor
+              * @param cif_file An existing mmCIF file path to be read
+              */
+            CifFile(const std::string& cif_file);
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            const std::string& GetFilePath() const;
+            /*! \fn
+              * Name of the data block the atoms have been read from, e.g. the PDB id of the entry
+              */
+            const std::string& GetDataBlockName() const;
+            const CifAtomSite& GetAtomSite() const;
+            /*! \fn
+              * @return True if the file has all six parameters of the _cell category
+              */
+            bool HasUnitCell() const;
+            /*! \fn
+              * Unit cell given by the _cell category, see HasUnitCell
+              */
+            GeometryTopology::UnitCell GetUnitCell() const;
+            /*! \fn
+              * Hermann-Mauguin symbol of the space group (_symmetry.space_group_name_H-M or _space_group.name_H-M_alt), empty if
+              * the file does not give it
+              */
+            const std::string& GetSpaceGroup() const;
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to parse the contents of a given stream of a file
+              * @param in_file A stream of an mmCIF file
+              */
+            void Read(std::istream& in_file);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to print out the atoms of the file in a structural format
+              * @param out An output stream, the print result will be written in the given output stream
+              */
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            /*! \fn
+              * Next token of a line of the file: a tag, a keyword or a value
+              * @param line A line of the file
+              * @param position Index of the first character after the previous token; moved past the returned token
+              * @param token The token; the quotes of a quoted value are not part of it
+              * @param quoted Set if the token was quoted, so it is a value even if it looks like a tag or a keyword
+              * @return False if the line has no token left (a '#' outside a quoted value starts a comment)
+              */
+            static bool NextToken(std::string_view line, std::size_t& position, std::string_view& token, bool& quoted);
+            /*! \fn
+              * Assign a value of the file to the current loop row or to the tag of the last key-value pair
+              */
+            void ProcessValue(std::string_view value);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::string path_;                                  /*!< Path of the file >*/
+            std::string data_block_name_;                       /*!< Name of the data block, after "data_" >*/
+            CifAtomSite atom_site_;                             /*!< Rows of the _atom_site loop >*/
+            double cell_[6];                                    /*!< a, b, c, alpha, beta and gamma of the _cell category >*/
+            std::string space_group_;                           /*!< Hermann-Mauguin symbol of the space group >*/
+            /// State of Read between two tokens
+            bool in_loop_header_;                               /*!< True between loop_ and the first value of the loop >*/
+            bool in_loop_;                                      /*!< True while the values of a loop are read >*/
+            std::vector<CifAtomSite::Item> loop_items_;         /*!< Item of each tag of the current loop if it is the _atom_site loop >*/
+            std::size_t number_of_loop_tags_;                   /*!< Number of tags (values per row) of the current loop >*/
+            std::size_t next_loop_tag_;                         /*!< Index of the tag of the next value of the current row >*/
+            std::string pending_tag_;                           /*!< Tag of a key-value pair whose value has not been read yet >*/
+            /*! \file
+              * An example of the _atom_site loop of an mmCIF file:
+              *     loop_
+              *     _atom_site.group_PDB
+              *     _atom_site.id
+              *     _atom_site.type_symbol
+              *     _atom_site.label_atom_id
+              *     _atom_site.label_alt_id
+              *     _atom_site.label_comp_id
+              *     _atom_site.label_asym_id
+              *     _atom_site.label_seq_id
+              *     _atom_site.pdbx_PDB_ins_code
+              *     _atom_site.Cartn_x
+              *     _atom_site.Cartn_y
+              *     _atom_site.Cartn_z
+              *     _atom_site.occupancy
+              *     _atom_site.B_iso_or_equiv
+              *     _atom_site.pdbx_formal_charge
+              *     _atom_site.auth_seq_id
+              *     _atom_site.auth_comp_id
+              *     _atom_site.auth_asym_id
+              *     _atom_site.auth_atom_id
+              *     _atom_site.pdbx_PDB_model_num
+              *     ATOM   1    N N   . MET A 1 1 ? 27.340 24.430 2.614  1.00 9.67  ? 1  MET A N   1
+              *     ATOM   2    C CA  . MET A 1 1 ? 26.266 25.413 2.842  1.00 10.38 ? 1  MET A CA  1
+              *     HETATM 603  O O   . HOH B 2 . ? 41.165 35.803 -2.153 1.00 27.62 ? 77 HOH A O   1
+              */
+    };
+}
+
+#endif // CIFFILE_HPP
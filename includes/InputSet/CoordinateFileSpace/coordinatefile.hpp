@@ -6,6 +6,8 @@
 #include <iostream>
 
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../GeometryTopology/unitcell.hpp"
+#include "../../memoryarena.hpp"
 
 /*! \namespace CoordinateFileSpace */
 namespace CoordinateFileSpace
@@ -61,6 +63,18 @@ namespace CoordinateFileSpace
               * @return coordinates_ attribute of the current object of this class
               */
             const std::vector<GeometryTopology::Coordinate*> GetCoordinates() const;
+            /*! \fn
+              * An accessor function in order to access to the periodic box of the current object
+              * The attribute is set by the box line at the end of a restart file
+              * @return Pointer to the box_ attribute of the current object of this class, NULL if the file has no box
+              */
+            GeometryTopology::UnitCell* GetBox();
+            /*! \fn
+              * An accessor function in order to access to the arena of the coordinates of the current object
+              * Coordinates that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
 
             //////////////////////////////////////////////////////////
             //                           MUTATOR                    //
@@ -97,6 +111,12 @@ namespace CoordinateFileSpace
               * @param title A string defines the title of the coordinate file which is extracted from the contents of the file
               */
             void AddCoordinate(GeometryTopology::Coordinate* coordinate);
+            /*! \fn
+              * A mutator function in order to set the periodic box of the current object
+              * Set the box_ attribute of the current object to a copy of the given box
+              * @param box The periodic box to be written as the last line of the file; NULL for no box
+              */
+            void SetBox(GeometryTopology::UnitCell* box);
 
             //////////////////////////////////////////////////////////
             //                         FUNCTIONS                    //
@@ -106,7 +126,7 @@ namespace CoordinateFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a coordinate file
               */
-            void Read(std::ifstream& in_file);
+            void Read(std::istream& in_file);
             /*! \fn
               * A function to write back the coordinate file
               * @param coordinate_file The output file path
@@ -137,6 +157,8 @@ namespace CoordinateFileSpace
             int number_of_coordinates_;                         /*!< Number of coordinates containing in the file; set by the second line of a coordinate file */
             std::vector<GeometryTopology::Coordinate*> coordinates_;    /*!< List of coordinates in a coordinate file; from the 3rd line of a coordinate file to
                                                                         the end of the file, lines are including coordinates */
+            GeometryTopology::UnitCell box_;                    /*!< Periodic box, left unset if the file has none; set by the optional last line of a restart file (a, b, c, alpha, beta, gamma) */
+            gmml::MemoryArena arena_;                           /*!< Storage of the coordinates that have been read from the file */
             /*! \file
               * An example of a coordinate file:
               *     ROH
@@ -6,12 +6,14 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PdbFileSpace
 {
-    class PdbAtom
+    class PdbAtom : public gmml::ArenaAllocated<PdbAtom>
     {
         public:
 
@@ -100,6 +102,12 @@ namespace PdbFileSpace
               * @return atom_orthogonal_coordinate_ attribute of the current object of this class
               */
             GeometryTopology::Coordinate GetAtomOrthogonalCoordinate();
+            /*! \fn
+              * An accessor function in order to access to the coordinates of the atom in the models of the file that have
+              * the same atoms as the model of the atom (see PdbFile::ParseModelCardConcurrently)
+              * @return atom_model_coordinates_ attribute of the current object of this class
+              */
+            const std::vector<GeometryTopology::Coordinate>& GetAtomModelCoordinates();
             /*! \fn
               * An accessor function in order to access to the atom occupancy in a pdb atom
               * @return atom_occupancy_ attribute of the current object of this class
@@ -177,6 +185,12 @@ namespace PdbFileSpace
               * @param atom_orthogonal_coordinate The atom orthogonal coordinate of the current object
               */
             void SetAtomOrthogonalCoordinate(GeometryTopology::Coordinate atom_orthogonal_coordinate);
+            /*! \fn
+              * A mutator function in order to add a coordinate of the atom in another model of the file
+              * Add to the atom_model_coordinates_ attribute of the current pdb atom
+              * @param atom_model_coordinate The atom coordinate in the next model with the same atoms
+              */
+            void AddAtomModelCoordinate(const GeometryTopology::Coordinate& atom_model_coordinate);
             /*! \fn
               * A mutator function in order to set the atom occupancy of the current object
               * Set the atom_occupancy_ attribute of the current pdb atom
@@ -234,6 +248,7 @@ namespace PdbFileSpace
             std::string atom_element_symbol_;                   /*!< Atom element symbol */
             std::string atom_charge_;                           /*!< Atom charge */
             std::string atom_card_index_in_residue_sequence_;
+            std::vector<GeometryTopology::Coordinate> atom_model_coordinates_;  /*!< Atom coordinates in the following models with the same atoms, in model order */
     };
 }
 
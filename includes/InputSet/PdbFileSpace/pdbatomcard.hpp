@@ -9,10 +9,12 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbAtom;
-    class PdbAtomCard
+    class PdbAtomCard : public gmml::ArenaAllocated<PdbAtomCard>
     {
         public:
             //////////////////////////////////////////////////////////
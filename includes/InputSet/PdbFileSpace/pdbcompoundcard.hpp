@@ -8,10 +8,12 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbCompoundSpecification;
-    class PdbCompoundCard
+    class PdbCompoundCard : public gmml::ArenaAllocated<PdbCompoundCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbCompoundSpecification
+    class PdbCompoundSpecification : public gmml::ArenaAllocated<PdbCompoundSpecification>
     {
         public:
             //////////////////////////////////////////////////////////
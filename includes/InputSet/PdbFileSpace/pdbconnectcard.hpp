@@ -10,9 +10,11 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbConnectCard
+    class PdbConnectCard : public gmml::ArenaAllocated<PdbConnectCard>
     {
         public:
 
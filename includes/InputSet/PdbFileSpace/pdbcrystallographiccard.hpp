@@ -8,9 +8,11 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbCrystallographicCard
+    class PdbCrystallographicCard : public gmml::ArenaAllocated<PdbCrystallographicCard>
     {
         public:
 
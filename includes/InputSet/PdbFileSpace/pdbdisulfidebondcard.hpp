@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbDisulfideResidueBond;
-    class PdbDisulfideBondCard
+    class PdbDisulfideBondCard : public gmml::ArenaAllocated<PdbDisulfideBondCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbDisulfideResidue
+    class PdbDisulfideResidue : public gmml::ArenaAllocated<PdbDisulfideResidue>
     {
         public:
             //////////////////////////////////////////////////////////
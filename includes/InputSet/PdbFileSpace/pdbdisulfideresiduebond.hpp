@@ -8,10 +8,12 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbDisulfideResidue;
-    class PdbDisulfideResidueBond
+    class PdbDisulfideResidueBond : public gmml::ArenaAllocated<PdbDisulfideResidueBond>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,6 +8,8 @@
 #include <vector>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbHeaderCard;
@@ -74,8 +76,10 @@ namespace PdbFileSpace
             /*! \fn
               * Constructor
               * @param pdb_file An existing pdb file path to be read
+              * @param number_of_model_threads Number of threads that parse the models of the file concurrently, see
+              * ParseModelCardConcurrently; 0 parses all models as one block as before
               */
-            PdbFile(const std::string& pdb_file);
+            PdbFile(const std::string& pdb_file, int number_of_model_threads = 0);
             /*! \fn
               * Load PDB file
               */
@@ -93,6 +97,12 @@ namespace PdbFileSpace
               * @return path_ attribute of the current object of this class
               */
             std::string GetPath();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
             /*! \fn
               * An accessor function in order to access to the header of the current object
               * @return header_ attribute of the current object of this class
@@ -256,7 +266,7 @@ namespace PdbFileSpace
               * @param residue_atom_map The map between residues and their atoms
               * @return atom The atom object of the given residue of the current object of this class
               */
-            PdbAtom* GetAtomOfResidueByName(PdbResidue* residue, std::string atom_name, PdbResidueAtomsMap residue_atom_map);
+            PdbAtom* GetAtomOfResidueByName(PdbResidue* residue, std::string atom_name, PdbResidueAtomsMap& residue_atom_map);
             /*! \fn
               * An accessor function in order to access to atom of a residue of the current object using the atom name
               * @param residue The given residue to return one of its atoms
@@ -554,279 +564,292 @@ namespace PdbFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a pdb file
               */
-            bool Read(std::ifstream& in_file);
+            bool Read(std::istream& in_file);
             /*! \fn
               * A function to parse the contents of a given stream of a file
               * @param in_stream A stream contains whole contents of a pdb file
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseCards(std::ifstream& in_stream);
+            bool ParseCards(std::istream& in_stream);
             /*! \fn
               * A function to parse the header crad that has been given as a stream
               * @param stream A stream contains header card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseHeaderCard(std::ifstream& stream, std::string& line);
+            bool ParseHeaderCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the obsolete crad that has been given as a stream
               * @param stream A stream contains obsolete card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseObsoleteCard(std::ifstream& stream, std::string& line);
+            bool ParseObsoleteCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the title crad that has been given as a stream
               * @param stream A stream contains title card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseTitleCard(std::ifstream& stream, std::string& line);
+            bool ParseTitleCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the split crad that has been given as a stream
               * @param stream A stream contains split card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSplitCard(std::ifstream& stream, std::string& line);
+            bool ParseSplitCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the caveat crad that has been given as a stream
               * @param stream A stream contains caveat card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseCaveatCard(std::ifstream& stream, std::string& line);
+            bool ParseCaveatCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the compound crad that has been given as a stream
               * @param stream A stream contains compound card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseCompoundCard(std::ifstream& stream, std::string& line);
+            bool ParseCompoundCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the source crad that has been given as a stream
               * @param stream A stream contains source card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSourceCard(std::ifstream& stream, std::string& line);
+            bool ParseSourceCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the keyword crad that has been given as a stream
               * @param stream A stream contains keyword card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseKeywordCard(std::ifstream& stream, std::string& line);
+            bool ParseKeywordCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the expiration date crad that has been given as a stream
               * @param stream A stream contains expiration date card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseExpirationDateCard(std::ifstream& stream, std::string& line);
+            bool ParseExpirationDateCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the num model crad that has been given as a stream
               * @param stream A stream contains num model card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseNumModelCard(std::ifstream& stream, std::string& line);
+            bool ParseNumModelCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the model type crad that has been given as a stream
               * @param stream A stream contains model type card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseModelTypeCard(std::ifstream& stream, std::string& line);
+            bool ParseModelTypeCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the author crad that has been given as a stream
               * @param stream A stream contains author card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseAuthorCard(std::ifstream& stream, std::string& line);
+            bool ParseAuthorCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the revision date crad that has been given as a stream
               * @param stream A stream contains revision date card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseRevisionDateCard(std::ifstream& stream, std::string& line);
+            bool ParseRevisionDateCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the superseded entries crad that has been given as a stream
               * @param stream A stream contains superseded entries card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSupersededEntriesCard(std::ifstream& stream, std::string& line);
+            bool ParseSupersededEntriesCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the journal crad that has been given as a stream
               * @param stream A stream contains journal card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseJournalCard(std::ifstream& stream, std::string& line);
+            bool ParseJournalCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the remark crad that has been given as a stream
               * @param stream A stream contains remark card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseRemarkCard(std::ifstream& stream, std::string& line);
+            bool ParseRemarkCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the database reference crad that has been given as a stream
               * @param stream A stream contains database reference card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseDatabaseReferenceCard(std::ifstream& stream, std::string& line);
+            bool ParseDatabaseReferenceCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the sequence advanced crad that has been given as a stream
               * @param stream A stream contains sequence advanced card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSequenceAdvancedCard(std::ifstream& stream, std::string& line);
+            bool ParseSequenceAdvancedCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the sequence residue crad that has been given as a stream
               * @param stream A stream contains sequence reisdue card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSequenceResidueCard(std::ifstream& stream, std::string& line);
+            bool ParseSequenceResidueCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the modification residue crad that has been given as a stream
               * @param stream A stream contains modification residue card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseModificationResidueCard(std::ifstream& stream, std::string& line);
+            bool ParseModificationResidueCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the heterogen crad that has been given as a stream
               * @param stream A stream contains heterogen card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseHeterogenCard(std::ifstream& stream, std::string& line);
+            bool ParseHeterogenCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the heterogen name crad that has been given as a stream
               * @param stream A stream contains heterogen name card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseHeterogenNameCard(std::ifstream& stream, std::string& line);
+            bool ParseHeterogenNameCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the heterogen synonym crad that has been given as a stream
               * @param stream A stream contains heterogen synonym card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseHeterogenSynonymCard(std::ifstream& stream, std::string& line);
+            bool ParseHeterogenSynonymCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the formula crad that has been given as a stream
               * @param stream A stream contains formula card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseFormulaCard(std::ifstream& stream, std::string& line);
+            bool ParseFormulaCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the helix crad that has been given as a stream
               * @param stream A stream contains helix card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseHelixCard(std::ifstream& stream, std::string& line);
+            bool ParseHelixCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the sheet crad that has been given as a stream
               * @param stream A stream contains sheet card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSheetCard(std::ifstream& stream, std::string& line);
+            bool ParseSheetCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the disulfide bond crad that has been given as a stream
               * @param stream A stream contains disulfide bond card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseDisulfideBondCard(std::ifstream& stream, std::string& line);
+            bool ParseDisulfideBondCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the link crad that has been given as a stream
               * @param stream A stream contains link card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseLinkCard(std::ifstream& stream, std::string& line);
+            bool ParseLinkCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the cis peptide crad that has been given as a stream
               * @param stream A stream contains cis peptide card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseCISPeptideCard(std::ifstream& stream, std::string& line);
+            bool ParseCISPeptideCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the site crad that has been given as a stream
               * @param stream A stream contains site card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseSiteCard(std::ifstream& stream, std::string& line);
+            bool ParseSiteCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the crystallography crad that has been given as a stream
               * @param stream A stream contains crystallography card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseCrystallographyCard(std::ifstream& stream, std::string& line);
+            bool ParseCrystallographyCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the origin crad that has been given as a stream
               * @param stream A stream contains origin card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseOriginCard(std::ifstream& stream, std::string& line);
+            bool ParseOriginCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the scale crad that has been given as a stream
               * @param stream A stream contains scale card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseScaleCard(std::ifstream& stream, std::string& line);
+            bool ParseScaleCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the matrix crad that has been given as a stream
               * @param stream A stream contains matrix card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseMatrixCard(std::ifstream& stream, std::string& line);
+            bool ParseMatrixCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the model crad that has been given as a stream
               * @param stream A stream contains model card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseModelCard(std::ifstream& stream, std::string& line);
+            bool ParseModelCard(std::istream& stream, std::string& line);
+            /*! \fn
+              * A function to parse the model card with several threads, used by ParseModelCard if the file has been opened with
+              * model threads
+              * The model card is split at its MODEL records and every model is scanned for its atoms and coordinates concurrently.
+              * The first model, i.e. the one with the lowest serial number, and every model whose atoms differ from it are parsed into
+              * PdbModel objects concurrently; a model with the same atoms in the same order only adds its coordinates to the atoms of
+              * the first model (see PdbAtom::GetAtomModelCoordinates and PdbModelCard::GetMergedModelSerialNumbers), so an ensemble
+              * of hundreds of models keeps a single set of atoms
+              * @param stream A stream contains model card of a pdb file
+              * @param line Current line in the stream
+              * @return Boolean value that indicates parsing has been done successfully or not
+              */
+            bool ParseModelCardConcurrently(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the connectivity crad that has been given as a stream
               * @param stream A stream contains connectivity card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseConnectivityCard(std::ifstream& stream, std::string& line);
+            bool ParseConnectivityCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the master crad that has been given as a stream
               * @param stream A stream contains master card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseMasterCard(std::ifstream& stream, std::string& line);
+            bool ParseMasterCard(std::istream& stream, std::string& line);
             /*! \fn
               * A function to parse the end crad that has been given as a stream
               * @param stream A stream contains end card of a pdb file
               * @param line Current line in the stream
               * @return Boolean value that indicates parsing has been done successfully or not
               */
-            bool ParseEndCard(std::ifstream& stream, std::string& line);
+            bool ParseEndCard(std::istream& stream, std::string& line);
 
             /// Writers
             /*! \fn
@@ -1023,6 +1046,8 @@ namespace PdbFileSpace
             void ResolveMatrixCard(std::ofstream& stream);
             /*! \fn
               * A function to write back model card of the pdb file into an output stream
+              * The models are written in the order of their serial numbers; a merged model (see ParseModelCardConcurrently) is
+              * written with the atoms of the first model and its own coordinates
               * @param stream Intermediate output stream in order to write model card
               */
             void ResolveModelCard(std::ofstream& stream);
@@ -1087,6 +1112,8 @@ namespace PdbFileSpace
             PdbConnectCard* connectivities_;                        /*!< Connectivity card >*/
             PdbSerialNumberMapping serial_number_mapping_;          /*!< A map that keeps track of serial numbers that have been changed during a process >*/
             PdbSequenceNumberMapping sequence_number_mapping_;      /*!< A map that keeps track of sequence numbers that have been changed during a process >*/
+            gmml::MemoryArena arena_;                               /*!< Storage of the records that have been read from the file >*/
+            int number_of_model_threads_;                           /*!< Threads that parse the models of the file, 0 to parse them as one block >*/
     };
 }
 
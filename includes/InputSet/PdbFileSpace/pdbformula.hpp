@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbFormula
+    class PdbFormula : public gmml::ArenaAllocated<PdbFormula>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbFormula;
-    class PdbFormulaCard
+    class PdbFormulaCard : public gmml::ArenaAllocated<PdbFormulaCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbHeaderCard
+    class PdbHeaderCard : public gmml::ArenaAllocated<PdbHeaderCard>
     {
         public:
             //////////////////////////////////////////////////////////
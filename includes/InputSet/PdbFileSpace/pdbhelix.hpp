@@ -8,6 +8,8 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
 /*! \enum
@@ -29,7 +31,7 @@ namespace PdbFileSpace
     };
 
     class PdbHelixResidue;
-    class PdbHelix
+    class PdbHelix : public gmml::ArenaAllocated<PdbHelix>
     {
         public:
             //////////////////////////////////////////////////////////
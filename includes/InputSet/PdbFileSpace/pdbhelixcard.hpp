@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbHelix;
-    class PdbHelixCard
+    class PdbHelixCard : public gmml::ArenaAllocated<PdbHelixCard>
     {
         public:
             //////////////////////////////////////////////////////////
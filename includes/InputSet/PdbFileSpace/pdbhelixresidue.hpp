@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbHelixResidue
+    class PdbHelixResidue : public gmml::ArenaAllocated<PdbHelixResidue>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbHeterogen
+    class PdbHeterogen : public gmml::ArenaAllocated<PdbHeterogen>
     {
         public:
             //////////////////////////////////////////////////////////
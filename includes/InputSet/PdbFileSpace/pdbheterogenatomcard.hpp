@@ -8,11 +8,13 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbAtom;
 
-    class PdbHeterogenAtomCard
+    class PdbHeterogenAtomCard : public gmml::ArenaAllocated<PdbHeterogenAtomCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbHeterogen;
-    class PdbHeterogenCard
+    class PdbHeterogenCard : public gmml::ArenaAllocated<PdbHeterogenCard>
     {
         public:
             //////////////////////////////////////////////////////////
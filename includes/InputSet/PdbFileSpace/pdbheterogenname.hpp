@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbHeterogenName
+    class PdbHeterogenName : public gmml::ArenaAllocated<PdbHeterogenName>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbHeterogenName;
-    class PdbHeterogenNameCard
+    class PdbHeterogenNameCard : public gmml::ArenaAllocated<PdbHeterogenNameCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbHeterogenSynonym
+    class PdbHeterogenSynonym : public gmml::ArenaAllocated<PdbHeterogenSynonym>
     {
         public:
             //////////////////////////////////////////////////////////
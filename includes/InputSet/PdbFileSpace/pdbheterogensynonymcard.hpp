@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbHeterogenSynonym;
-    class PdbHeterogenSynonymCard
+    class PdbHeterogenSynonymCard : public gmml::ArenaAllocated<PdbHeterogenSynonymCard>
     {
         public:
             //////////////////////////////////////////////////////////
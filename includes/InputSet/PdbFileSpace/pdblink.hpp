@@ -8,11 +8,13 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbLinkResidue;
 
-    class PdbLink
+    class PdbLink : public gmml::ArenaAllocated<PdbLink>
     {
         public:
             //////////////////////////////////////////////////////////
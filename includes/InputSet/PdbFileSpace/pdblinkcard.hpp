@@ -9,11 +9,13 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbLink;
 
-    class PdbLinkCard
+    class PdbLinkCard : public gmml::ArenaAllocated<PdbLinkCard>
     {
         public:
             //////////////////////////////////////////////////////////
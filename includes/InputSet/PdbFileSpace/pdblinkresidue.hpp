@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbLinkResidue
+    class PdbLinkResidue : public gmml::ArenaAllocated<PdbLinkResidue>
     {
         public:
             //////////////////////////////////////////////////////////
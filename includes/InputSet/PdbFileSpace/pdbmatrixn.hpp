@@ -8,10 +8,11 @@
 #include <iostream>
 
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PdbFileSpace
 {
-    class PdbMatrixN
+    class PdbMatrixN : public gmml::ArenaAllocated<PdbMatrixN>
     {
         public:
 
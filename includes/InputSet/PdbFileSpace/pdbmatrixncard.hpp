@@ -8,11 +8,13 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbMatrixN;
 
-    class PdbMatrixNCard
+    class PdbMatrixNCard : public gmml::ArenaAllocated<PdbMatrixNCard>
     {
         public:
             //////////////////////////////////////////////////////////
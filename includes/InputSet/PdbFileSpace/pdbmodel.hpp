@@ -8,11 +8,13 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbModelResidueSet;
 
-    class PdbModel
+    class PdbModel : public gmml::ArenaAllocated<PdbModel>
     {
         public:
             //////////////////////////////////////////////////////////
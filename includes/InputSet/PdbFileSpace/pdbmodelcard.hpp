@@ -6,14 +6,17 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbModel;
 
-    class PdbModelCard
+    class PdbModelCard : public gmml::ArenaAllocated<PdbModelCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -50,6 +53,12 @@ namespace PdbFileSpace
               * @return models_ attribute of the current object of this class
               */
             PdbModelMap GetModels();
+            /*! \fn
+              * An accessor function in order to access to the serial numbers of the models that have not been kept as models
+              * because they have the same atoms as the first model; their coordinates have been added to the atoms of the first model
+              * @return merged_model_serial_numbers_ attribute of the current object of this class
+              */
+            std::vector<int> GetMergedModelSerialNumbers();
 
             //////////////////////////////////////////////////////////
             //                       MUTATOR                        //
@@ -66,6 +75,12 @@ namespace PdbFileSpace
               * @param models The model attribute of the current object
               */
             void SetModels(PdbModelMap models);
+            /*! \fn
+              * A mutator function in order to set the serial numbers of the merged models of the current object
+              * Set the merged_model_serial_numbers_ attribute of the current model card
+              * @param merged_model_serial_numbers The serial numbers of the merged models, in the order of their coordinates in the atoms
+              */
+            void SetMergedModelSerialNumbers(std::vector<int> merged_model_serial_numbers);
 
             //////////////////////////////////////////////////////////
             //                        FUNCTIONS                     //
@@ -87,6 +102,7 @@ namespace PdbFileSpace
             //////////////////////////////////////////////////////////
             std::string record_name_;           /*!< Name of model card record which is in the first column of each line of a pdb file >*/
             PdbModelMap models_;                /*!< Models that are in model card of a pdb file >*/
+            std::vector<int> merged_model_serial_numbers_;  /*!< Serial numbers of the models that are only kept as coordinates of the atoms of the first model >*/
 
     };
 }
@@ -9,12 +9,14 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbAtomCard;
     class PdbHeterogenAtomCard;
 
-    class PdbModelResidueSet
+    class PdbModelResidueSet : public gmml::ArenaAllocated<PdbModelResidueSet>
     {
         public:
             //////////////////////////////////////////////////////////
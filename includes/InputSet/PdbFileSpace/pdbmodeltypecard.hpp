@@ -9,9 +9,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbModelTypeCard
+    class PdbModelTypeCard : public gmml::ArenaAllocated<PdbModelTypeCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbNumModelCard
+    class PdbNumModelCard : public gmml::ArenaAllocated<PdbNumModelCard>
     {
         public:
             //////////////////////////////////////////////////////////
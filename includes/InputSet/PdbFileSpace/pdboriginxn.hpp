@@ -9,10 +9,11 @@
 #include <iostream>
 
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PdbFileSpace
 {
-    class PdbOriginXn
+    class PdbOriginXn : public gmml::ArenaAllocated<PdbOriginXn>
     {
         public:
 
@@ -9,11 +9,13 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbOriginXn;
 
-    class PdbOriginXnCard
+    class PdbOriginXnCard : public gmml::ArenaAllocated<PdbOriginXnCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -4,9 +4,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbResidue
+    class PdbResidue : public gmml::ArenaAllocated<PdbResidue>
     {
         public:
             //////////////////////////////////////////////////////////
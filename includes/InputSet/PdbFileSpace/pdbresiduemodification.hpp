@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbResidueModification
+    class PdbResidueModification : public gmml::ArenaAllocated<PdbResidueModification>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbResidueModification;
-    class PdbResidueModificationCard
+    class PdbResidueModificationCard : public gmml::ArenaAllocated<PdbResidueModificationCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,9 +8,11 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbResidueSequence
+    class PdbResidueSequence : public gmml::ArenaAllocated<PdbResidueSequence>
     {
         public:
             //////////////////////////////////////////////////////////
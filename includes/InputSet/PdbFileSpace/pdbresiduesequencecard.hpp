@@ -8,10 +8,12 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbResidueSequence;
-    class PdbResidueSequenceCard
+    class PdbResidueSequenceCard : public gmml::ArenaAllocated<PdbResidueSequenceCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,11 @@
 #include <iostream>
 
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PdbFileSpace
 {
-    class PdbScaleN
+    class PdbScaleN : public gmml::ArenaAllocated<PdbScaleN>
     {
         public:
 
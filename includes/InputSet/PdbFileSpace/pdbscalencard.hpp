@@ -9,11 +9,13 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbScaleN;
 
-    class PdbScaleNCard
+    class PdbScaleNCard : public gmml::ArenaAllocated<PdbScaleNCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbSheetStrand;
-    class PdbSheet
+    class PdbSheet : public gmml::ArenaAllocated<PdbSheet>
     {
         public:
             //////////////////////////////////////////////////////////
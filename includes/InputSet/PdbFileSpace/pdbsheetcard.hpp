@@ -9,10 +9,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbSheet;
-    class PdbSheetCard
+    class PdbSheetCard : public gmml::ArenaAllocated<PdbSheetCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -8,6 +8,8 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
 /*! \enum
@@ -22,7 +24,7 @@ namespace PdbFileSpace
     };
 
     class PdbSheetStrandResidue;
-    class PdbSheetStrand
+    class PdbSheetStrand : public gmml::ArenaAllocated<PdbSheetStrand>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbSheetStrandResidue
+    class PdbSheetStrandResidue : public gmml::ArenaAllocated<PdbSheetStrandResidue>
     {
         public:
             //////////////////////////////////////////////////////////
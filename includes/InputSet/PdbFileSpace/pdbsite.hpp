@@ -9,11 +9,13 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbSiteResidue;
 
-    class PdbSite
+    class PdbSite : public gmml::ArenaAllocated<PdbSite>
     {
         public:
             //////////////////////////////////////////////////////////
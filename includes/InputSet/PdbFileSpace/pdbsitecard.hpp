@@ -9,11 +9,13 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
     class PdbSite;
 
-    class PdbSiteCard
+    class PdbSiteCard : public gmml::ArenaAllocated<PdbSiteCard>
     {
         public:
             //////////////////////////////////////////////////////////
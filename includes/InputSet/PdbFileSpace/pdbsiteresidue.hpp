@@ -7,9 +7,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbSiteResidue
+    class PdbSiteResidue : public gmml::ArenaAllocated<PdbSiteResidue>
     {
         public:
 
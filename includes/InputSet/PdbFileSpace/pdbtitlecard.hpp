@@ -8,9 +8,11 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbFileSpace
 {
-    class PdbTitleCard
+    class PdbTitleCard : public gmml::ArenaAllocated<PdbTitleCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -3,10 +3,11 @@
 
 #include <string>
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PdbqtFileSpace
 {
-    class PdbqtAtom
+    class PdbqtAtom : public gmml::ArenaAllocated<PdbqtAtom>
     {
         public:
 
@@ -6,10 +6,12 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtAtom;
-    class PdbqtAtomCard
+    class PdbqtAtomCard : public gmml::ArenaAllocated<PdbqtAtomCard>
     {
         public:
             //////////////////////////////////////////////////////////
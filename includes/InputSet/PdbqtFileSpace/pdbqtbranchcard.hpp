@@ -5,10 +5,12 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtAtomCard;
-    class PdbqtBranchCard
+    class PdbqtBranchCard : public gmml::ArenaAllocated<PdbqtBranchCard>
     {
         public:
 
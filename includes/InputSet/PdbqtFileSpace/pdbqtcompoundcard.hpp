@@ -4,9 +4,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
-    class PdbqtCompoundCard
+    class PdbqtCompoundCard : public gmml::ArenaAllocated<PdbqtCompoundCard>
     {
         public:
 
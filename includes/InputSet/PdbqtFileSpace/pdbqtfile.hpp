@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace{
 
     class PdbqtAtom;
@@ -55,6 +57,12 @@ namespace PdbqtFileSpace{
               * @return path_ attribute of the current object of this class
               */
             std::string GetPath();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
             /*! \fn
               * An accessor function in order to access to the models attribute of the current object
               * @return models_ attribute of the current object of this class
@@ -141,6 +149,7 @@ namespace PdbqtFileSpace{
             //////////////////////////////////////////////////////////
             std::string path_;
             PdbqtModelCard* models_;
+            gmml::MemoryArena arena_;           /*!< Storage of the records that have been read from the file >*/
 
     };
 }
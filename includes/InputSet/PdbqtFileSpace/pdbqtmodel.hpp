@@ -6,13 +6,15 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtRemarkCard;
     class PdbqtTorsionalDoFCard;
     class PdbqtModelResidueSet;
     class PdbqtCompoundCard;
-    class PdbqtModel
+    class PdbqtModel : public gmml::ArenaAllocated<PdbqtModel>
     {
         public:
             //////////////////////////////////////////////////////////
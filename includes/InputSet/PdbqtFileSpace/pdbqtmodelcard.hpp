@@ -6,10 +6,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtModel;
-    class PdbqtModelCard
+    class PdbqtModelCard : public gmml::ArenaAllocated<PdbqtModelCard>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -5,12 +5,14 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtRootCard;
     class PdbqtBranchCard;
     class PdbqtAtomCard;
-    class PdbqtModelResidueSet
+    class PdbqtModelResidueSet : public gmml::ArenaAllocated<PdbqtModelResidueSet>
     {
         public:
             //////////////////////////////////////////////////////////
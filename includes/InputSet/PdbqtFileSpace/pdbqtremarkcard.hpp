@@ -4,9 +4,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
-    class PdbqtRemarkCard
+    class PdbqtRemarkCard : public gmml::ArenaAllocated<PdbqtRemarkCard>
     {
         public:
 
@@ -5,10 +5,12 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
     class PdbqtAtomCard;
-    class PdbqtRootCard
+    class PdbqtRootCard : public gmml::ArenaAllocated<PdbqtRootCard>
     {
         public:
             //////////////////////////////////////////////////////////
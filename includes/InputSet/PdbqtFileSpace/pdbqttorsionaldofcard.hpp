@@ -4,9 +4,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace PdbqtFileSpace
 {
-    class PdbqtTorsionalDoFCard
+    class PdbqtTorsionalDoFCard : public gmml::ArenaAllocated<PdbqtTorsionalDoFCard>
     {
         public:
 
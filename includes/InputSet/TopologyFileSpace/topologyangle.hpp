@@ -5,11 +5,13 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyAngleType;
 
-    class TopologyAngle
+    class TopologyAngle : public gmml::ArenaAllocated<TopologyAngle>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -5,9 +5,11 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
-    class TopologyAngleType
+    class TopologyAngleType : public gmml::ArenaAllocated<TopologyAngleType>
     {
         public:
             //////////////////////////////////////////////////////////
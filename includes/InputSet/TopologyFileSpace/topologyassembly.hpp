@@ -7,11 +7,13 @@
 #include <vector>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyResidue;
 
-    class TopologyAssembly
+    class TopologyAssembly : public gmml::ArenaAllocated<TopologyAssembly>
     {
         public:
             //////////////////////////////////////////////////////////
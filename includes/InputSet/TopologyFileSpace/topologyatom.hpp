@@ -6,9 +6,11 @@
 #include <vector>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
-    class TopologyAtom
+    class TopologyAtom : public gmml::ArenaAllocated<TopologyAtom>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -72,6 +74,11 @@ namespace TopologyFileSpace
               * @return excluded_atoms_ attribute of the current object of this class
               */
             std::vector<std::string> GetExcludedAtoms();
+            /*! \fn
+              * An accessor function in order to access to the indices of the excluded atoms as they appear in the excluded atoms list of a topology file
+              * @return excluded_atom_indices_ attribute of the current object of this class
+              */
+            const std::vector<int>& GetExcludedAtomIndices();
             /*! \fn
               * An accessor function in order to access to the atom radii
               * @return radii_ attribute of the current object of this class
@@ -147,6 +154,12 @@ namespace TopologyFileSpace
               * @param excluded_atom The excluded atom to be added to the current object
               */
             void AddExcludedAtom(std::string excluded_atom);
+            /*! \fn
+              * A mutator function in order to set the indices of the excluded atoms of the current object
+              * Set the excluded_atom_indices_ attribute of the current topology atom
+              * @param excluded_atom_indices One based indices of the excluded atoms, each higher than the index of the current atom
+              */
+            void SetExcludedAtomIndices(std::vector<int> excluded_atom_indices);
             /*! \fn
               * A mutator function in order to set the radii of the current object
               * Set the radii_ attribute of the current topology atom
@@ -213,6 +226,7 @@ namespace TopologyFileSpace
             int atomic_number_;                         /*!< Atomic number of the atom that appears in a topology file >*/
             double atom_mass_;                          /*!< Mass of the atom  that appears in a topology file >*/
             std::vector<std::string> excluded_atoms_;   /*!< List of atom names that are excluded from interaction with the current atom >*/
+            std::vector<int> excluded_atom_indices_;    /*!< Indices of the atoms that are excluded from interaction with the current atom; written as they are >*/
             double radii_;                              /*!< Radius of the atom that appears in a topology file >*/
             double screen_;                             /*!< Screen value of the atom that appears in a topology file >*/
             std::string tree_chain_classification_;     /*!< Tree chain classification of the atom appears in a topology file in order to extract the bonding information inside a residue >*/
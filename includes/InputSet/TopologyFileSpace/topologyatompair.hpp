@@ -5,9 +5,11 @@
 #include <iostream>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
-    class TopologyAtomPair
+    class TopologyAtomPair : public gmml::ArenaAllocated<TopologyAtomPair>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -5,10 +5,12 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyBondType;
-    class TopologyBond
+    class TopologyBond : public gmml::ArenaAllocated<TopologyBond>
     {
         public:
             //////////////////////////////////////////////////////////
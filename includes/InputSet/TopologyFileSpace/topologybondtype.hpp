@@ -5,9 +5,11 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
-    class TopologyBondType
+    class TopologyBondType : public gmml::ArenaAllocated<TopologyBondType>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -5,10 +5,12 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyDihedralType;
-    class TopologyDihedral
+    class TopologyDihedral : public gmml::ArenaAllocated<TopologyDihedral>
     {
         public:
             //////////////////////////////////////////////////////////
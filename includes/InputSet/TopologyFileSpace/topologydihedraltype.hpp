@@ -5,9 +5,11 @@
 #include <iostream>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
-    class TopologyDihedralType
+    class TopologyDihedralType : public gmml::ArenaAllocated<TopologyDihedralType>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -6,6 +6,8 @@
 #include <map>
 #include <vector>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyAtomPair;
@@ -53,6 +55,12 @@ namespace TopologyFileSpace
               * @return path_ attribute of the current object of this class
               */
             std::string GetPath();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
             /*! \fn
               * An accessor function in order to access to the title
               * @return title_ attribute of the current object of this class
@@ -250,6 +258,11 @@ namespace TopologyFileSpace
               * @return bonds_ attribute of the current object of this class
               */
             TopologyBondMap GetBonds();
+            /*! \fn
+              * An accessor function in order to access to the atom indices of the bonds as they are given in the file
+              * @return bond_atom_indices_ attribute of the current object of this class
+              */
+            const std::vector<int>& GetBondAtomIndices();
             /*! \fn
               * An accessor function in order to access to the angles
               * @return angles_ attribute of the current object of this class
@@ -603,19 +616,19 @@ namespace TopologyFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a topology file
               */
-            void Read(std::ifstream& in_file);
+            void Read(std::istream& in_file);
             /*! \fn
               * A function to parse the contents of a given stream of a file
               * @param in_stream A stream contains whole contents of a topology file
               */
-            void ParseSections(std::ifstream& in_stream);
+            void ParseSections(std::istream& in_stream);
             /*! \fn
               * A function to partition a topology file to its sections
               * @param stream Input stream built from topology input file
               * @param line The line that the reader is currently at
               * @param section Stream that the output section will be written on
               */
-            void PartitionSection(std::ifstream& stream, std::string& line, std::stringstream& section);
+            void PartitionSection(std::istream& stream, std::string& line, std::stringstream& section);
             /*! \fn
               * A function to parse title section of a pdb file
               * @param stream Title section of a topology file as stream
@@ -907,8 +920,10 @@ namespace TopologyFileSpace
             TopologyAssembly* assembly_;
             RadiusSet radius_set_;
             TopologyBondMap bonds_;
+            std::vector<int> bond_atom_indices_;            /*!< Zero based indices of the two atoms of every bond, bonds including hydrogen first >*/
             TopologyAngleMap angles_;
             TopologyDihedralMap dihedrals_;
+            gmml::MemoryArena arena_;                       /*!< Storage of the records that have been read from the file >*/
     };
 }
 
@@ -6,11 +6,13 @@
 #include <vector>
 #include <map>
 
+#include "../../memoryarena.hpp"
+
 namespace TopologyFileSpace
 {
     class TopologyAtom;
 
-    class TopologyResidue
+    class TopologyResidue : public gmml::ArenaAllocated<TopologyResidue>
     {
         public:
             //////////////////////////////////////////////////////////
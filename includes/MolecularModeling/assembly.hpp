@@ -4,10 +4,13 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <set>
 
 #include "../GeometryTopology/coordinate.hpp"
 #include "../GeometryTopology/plane.hpp"
+#include "../GeometryTopology/unitcell.hpp"
 #include "../common.hpp"
+#include "../memoryarena.hpp"
 #include "../Glycan/chemicalcode.hpp"
 #include "../Glycan/sugarname.hpp"
 #include "../Glycan/monosaccharide.hpp"
@@ -16,17 +19,21 @@
 #include "../InputSet/PdbqtFileSpace/pdbqtfile.hpp"
 #include "../InputSet/TopologyFileSpace/topologyfile.hpp"
 #include "../InputSet/CoordinateFileSpace/coordinatefile.hpp"
+#include "../InputSet/CifFileSpace/ciffile.hpp"
 #include "../ParameterSet/PrepFileSpace/prepfile.hpp"
 #include "../ParameterSet/PrepFileSpace/prepfileresidue.hpp"
 #include "../ParameterSet/PrepFileSpace/prepfileatom.hpp"
 #include "../ParameterSet/LibraryFileSpace/libraryfile.hpp"
 #include "../ParameterSet/ParameterFileSpace/parameterfile.hpp"
+#include "../ParameterSet/ParameterFileSpace/layeredparameterfile.hpp"
 #include "../InputSet/PdbqtFileSpace/pdbqtmodelresidueset.hpp"
 #include "../InputSet/PdbFileSpace/pdbmodelresidueset.hpp"
 #include "../InputSet/PdbFileSpace/pdbmodelcard.hpp"
 #include "../InputSet/PdbFileSpace/pdbmodel.hpp"
 #include "../Glycan/oligosaccharide.hpp"
 #include "../InputSet/CondensedSequenceSpace/condensedsequence.hpp"
+#include "rotatabledihedral.hpp"
+#include "bondgraph.hpp"
 
 namespace MolecularModeling
 {
@@ -49,6 +56,15 @@ namespace MolecularModeling
             typedef std::map<std::string, std::map<std::string, std::vector<std::string> > > SelectPatternMap;
             typedef std::map<std::string, ResidueVector> HierarchicalContainmentMap;
             typedef std::map<Residue*, ResidueVector> ResidueAttachmentMap;
+            typedef std::map<std::string, CoordinateVector> PrepResidueCoordinateMap;
+            /*! \typedef
+              * Names of the bonded atoms of each atom of a residue template, by atom name
+              */
+            typedef std::map<std::string, std::vector<std::string> > AtomBondTemplateMap;
+            /*! \typedef
+              * Bond templates of the residues of a set of database files, by residue name
+              */
+            typedef std::map<std::string, AtomBondTemplateMap> ResidueBondTemplateMap;
 
             //////////////////////////////////////////////////////////
             //                       CONSTRUCTOR                    //
@@ -70,6 +86,12 @@ namespace MolecularModeling
               * @param types Set of inoput file types of the inputs which are selected from InputFileType enumerator
               */
             Assembly(std::vector<std::vector<std::string> > file_paths, std::vector<gmml::InputFileType> types);
+            /*! \fn
+              * The residues, atoms, nodes and coordinates that have been created while building the assembly are destroyed with it,
+              * including the placeholder head and tail atoms of residues built from prep templates, and so are the sub-assemblies
+              * that the constructor with several files has created; sub-assemblies added with AddAssembly or SetAssemblies are not
+              */
+            ~Assembly();
 
             //////////////////////////////////////////////////////////
             //                       ACCESSOR                       //
@@ -127,6 +149,13 @@ namespace MolecularModeling
               * @return Vector of all atoms in the current object of assembly
               */
             AtomVector GetAllAtomsOfAssembly();
+            /*! \fn
+              * An accessor function in order to access to the bond graph of the atoms of the assembly, indexed like GetAllAtomsOfAssembly
+              * The graph is built on first use and again after atoms or bonds have changed, also when they have been changed
+              * through AtomNode or Residue (see BondGraph::IsOutdated)
+              * @return bond_graph_ attribute of the current object of this class
+              */
+            const BondGraph& GetBondGraph();
             /*! \fn
               * A functions that extracts all atoms of an assembly except atoms of water residues
               * @return Vector of all atoms in the current object of assembly except atoms of water residues
@@ -142,6 +171,21 @@ namespace MolecularModeling
               * @return List of all coordinates of all atoms in all residues and assemblies of an assembly
               */
             CoordinateVector GetAllCoordinates();
+            /*! \fn
+              * An accessor function in order to access to the periodic box of the assembly
+              * @return Pointer to the unit_cell_ attribute of the current object of this class, NULL if no cell is set; valid as long as the assembly
+              */
+            GeometryTopology::UnitCell* GetUnitCell();
+            /*! \fn
+              * An accessor function in order to access to the unit cell that the neighbour searches wrap around
+              * @return Pointer to the unit_cell_ attribute of the current object of this class if it is set and the structure is periodic, NULL otherwise
+              */
+            GeometryTopology::UnitCell* GetPeriodicBox();
+            /*! \fn
+              * An accessor function in order to access to the serial numbers of the models of the pdb or cif file the assembly has been built from
+              * @return model_serial_numbers_ attribute of the current object of this class, the model of every coordinate set of the atoms
+              */
+            std::vector<int> GetModelSerialNumbers();
 
             //////////////////////////////////////////////////////////
             //                       MUTATOR                        //
@@ -214,32 +258,152 @@ namespace MolecularModeling
               * @param model_index The target model index attribute of the current object
               */
             void SetModelIndex(int model_index);
+            /*! \fn
+              * A mutator function in order to set the periodic box of the current object
+              * Set the unit_cell_ attribute of the current assembly to a copy of the given cell
+              * @param unit_cell The periodic box of the structure, NULL to clear the cell
+              */
+            void SetUnitCell(GeometryTopology::UnitCell* unit_cell);
+            /*! \fn
+              * A mutator function in order to set whether the unit cell of the current object is a periodic box
+              * Bond, clash and ion searches use the closest image of each atom only for a periodic structure
+              * @param periodic True for a periodic box, false for a unit cell that is only carried along (e.g. a crystal cell)
+              */
+            void SetPeriodic(bool periodic);
             //////////////////////////////////////////////////////////
             //                       FUNCTIONS                      //
             //////////////////////////////////////////////////////////
             void BuildAssemblyFromCondensedSequence(std::string sequence, std::string prep_file, std::string parameter_file, bool structure = false);
+            /*! \fn
+              * A function to build a structure from a condensed sequence using already parsed prep and parameter files
+              * The given files are only read, so the same instances can be shared by several threads
+              * @param sequence Condensed sequence of the glycan
+              * @param prep_file Parsed prep file that contains all residues of the sequence
+              * @param parameter_file Parsed parameter file, NULL to leave the masses and radii of the atoms unset
+              * @param structure Build the bonds and attach the residues of the sequence to each other
+              * @param template_coordinates Cartesian coordinates of the prep residues by residue name, NULL to instantiate the template of each prep residue
+              */
+            void BuildAssemblyFromCondensedSequence(std::string sequence, PrepFileSpace::PrepFile* prep_file, ParameterFileSpace::ParameterFile* parameter_file,
+                                                    bool structure = false, PrepResidueCoordinateMap* template_coordinates = NULL);
+            /*! \fn
+              * A function to build a structure for each one of a list of condensed sequences and write each one out as soon as it is built
+              * The prep and parameter files are parsed once for all sequences, residues are instantiated from the templates of the prep residues
+              * Output files are named by the output prefix followed by the index of the sequence (starting at 1) and the file extension
+              * @param sequences List of condensed sequences
+              * @param prep_file Path to the prep file that contains all residues of the sequences
+              * @param parameter_file Path to the parameter file
+              * @param output_prefix Path prefix of the output files
+              * @param output_types Output formats of each built structure, PDB (.pdb) and/or LIB (.off)
+              * @param number_of_threads Number of threads that build sequences concurrently
+              * @return Number of sequences that have been built successfully
+              */
+            int BuildAssembliesFromCondensedSequences(std::vector<std::string> sequences, std::string prep_file, std::string parameter_file,
+                                                      std::string output_prefix, std::vector<gmml::InputFileType> output_types, int number_of_threads = 1);
+            /*! \fn
+              * A function to convert the coordinates of all atoms (including dummy atoms) of a prep residue to cartesian coordinates
+              * @param prep_residue The prep residue
+              * @return Newly created cartesian coordinates in the order of the atoms of the prep residue
+              */
+            CoordinateVector GetCartesianCoordinatesOfPrepResidue(PrepFileSpace::PrepFileResidue* prep_residue);
             void AttachResidues(Residue* residue, Residue* parent_residue, std::string parameter_file);
+            void AttachResidues(Residue* residue, Residue* parent_residue, ParameterFileSpace::ParameterFile* parameter_file);
+            /*! \fn
+              * A function to find the rotatable dihedrals (phi, psi and omega for 1-6 linkages) of the glycosidic linkage between a residue
+              * and its parent residue, e.g. after building the structure of a condensed sequence
+              * The head atom of the residue (anomeric carbon) has to be bonded to the tail atom of the parent residue (linkage oxygen);
+              * the residue and everything attached to it are the moving side of each dihedral
+              * @param residue The attached residue
+              * @param parent_residue The residue that the given residue is attached to
+              * @return List of phi, psi and (if available) omega dihedrals, empty if the residues are not linked
+              */
+            std::vector<RotatableDihedral*> FindGlycosidicLinkageDihedrals(Residue* residue, Residue* parent_residue);
+            /*! \fn
+              * A function to enumerate all combinations of the given torsion values of a set of dihedrals and add the ones without clashes as new models
+              * Torsions are set in place on the given model; its original torsions are restored at the end
+              * @param dihedrals List of rotatable dihedrals, e.g. from FindGlycosidicLinkageDihedrals
+              * @param torsion_grids List of torsion values in degree for each dihedral
+              * @param clash_cutoff Atoms that are more than three bonds apart and closer than this distance are considered as a clash
+              * @param model_index The index of the model that is used as the starting structure
+              * @return Number of added models
+              */
+            int GenerateRotamers(std::vector<RotatableDihedral*> dihedrals, std::vector<std::vector<double> > torsion_grids,
+                                 double clash_cutoff = gmml::dClashCutoff, int model_index = 0);
+            /*! \fn
+              * A function to count the pairs of atoms that are more than three bonds apart but closer than the given distance
+              * The graph structure has to be built before calling this function
+              * @param clash_cutoff Clash distance
+              * @param model_index The index of the model that has to be checked
+              * @return Number of clashing atom pairs
+              */
+            int CountClashes(double clash_cutoff = gmml::dClashCutoff, int model_index = 0);
+            /*! \fn
+              * A function to count the clashing pairs among the given atoms
+              * @param atoms List of atoms that have to be checked
+              * @param excluded_atoms Indices (in the given list) of the atoms that can not clash with each atom, e.g. from FindAtomsWithinThreeBonds
+              * @param clash_cutoff Clash distance
+              * @param model_index The index of the model that has to be checked
+              * @return Number of clashing atom pairs
+              */
+            int CountClashes(AtomVector atoms, std::vector<std::set<int> >& excluded_atoms, double clash_cutoff = gmml::dClashCutoff, int model_index = 0);
+            /*! \fn
+              * A function to find the atoms that are at most three bonds apart from each of the given atoms
+              * @param atoms List of atoms
+              * @return Indices (in the given list) of the atoms within three bonds of each atom
+              */
+            std::vector<std::set<int> > FindAtomsWithinThreeBonds(AtomVector atoms);
             /*! \fn
               * A function to build a structure from a single pdb file
               * Imports data from pdb file data structure into central data structure
+              * The coordinates of the models of the file, merged ones included (see PdbFile::ParseModelCardConcurrently), become the
+              * coordinate sets of the atoms in the order of the serial numbers of the models, see GetModelSerialNumbers; an atom that a
+              * model lacks keeps its coordinate of the first model there, and such models are logged as warnings
               * @param pdb_file_path Path to a pdb file
+              * @param number_of_model_threads Number of threads that parse the models of the file, see PdbFile::PdbFile
+              * @param bond_by_templates If true and library or prep files are given, the residues are bonded by their templates
+              *         from the files that are already loaded, see BuildStructureByResidueBondTemplates; otherwise no bonds are built
               */
             void BuildAssemblyFromPdbFile(std::string pdb_file_path, std::vector<std::string> amino_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> glycam_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> other_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> prep_files = std::vector<std::string>(),
-                                          std::string parameter_file = "");
+                                          std::string parameter_file = "", int number_of_model_threads = 0, bool bond_by_templates = false);
             /*! \fn
               * A function to build a structure from a single pdb file
               * Imports data from pdb file data structure into central data structure
+              * The models of the file become the coordinate sets of the atoms as in the function above
               * @param pdb_file Pdb file object
+              * @param bond_by_templates If true and library or prep files are given, the residues are bonded by their templates, see above
               */
             void BuildAssemblyFromPdbFile(PdbFileSpace::PdbFile* pdb_file,
                                           std::vector<std::string> amino_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> glycam_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> other_lib_files = std::vector<std::string>(),
                                           std::vector<std::string> prep_files = std::vector<std::string>(),
-                                          std::string parameter_file = "");
+                                          std::string parameter_file = "", bool bond_by_templates = false);
+            /*! \fn
+              * A function to build a structure from a single mmCIF (PDBx) file
+              * Same as BuildAssemblyFromPdbFile for the structures that do not fit into the pdb format; residues are made in the
+              * order of the _atom_site loop, the atoms of the first model define the structure and the other models add coordinates;
+              * an atom that a later model lacks keeps its coordinate of the first model there, and such models are logged as warnings
+              * @param cif_file_path Path to an mmCIF file
+              * @param bond_by_templates If true and library or prep files are given, the residues are bonded by their templates as in BuildAssemblyFromPdbFile
+              */
+            void BuildAssemblyFromCifFile(std::string cif_file_path, std::vector<std::string> amino_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> glycam_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> other_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> prep_files = std::vector<std::string>(),
+                                          std::string parameter_file = "", bool bond_by_templates = false);
+            /*! \fn
+              * A function to build a structure from a single mmCIF (PDBx) file, see above
+              * @param cif_file Cif file object
+              * @param bond_by_templates If true and library or prep files are given, the residues are bonded by their templates
+              */
+            void BuildAssemblyFromCifFile(CifFileSpace::CifFile* cif_file,
+                                          std::vector<std::string> amino_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> glycam_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> other_lib_files = std::vector<std::string>(),
+                                          std::vector<std::string> prep_files = std::vector<std::string>(),
+                                          std::string parameter_file = "", bool bond_by_templates = false);
             /*! \fn
               * A function to build a structure from a single pdbqt file
               * Imports data from pdbqt file data structure into central data structure
@@ -309,6 +473,10 @@ namespace MolecularModeling
               * Exports data from assembly data structure into pdb file structure
               */
             PdbFileSpace::PdbFile* BuildPdbFileStructureFromAssembly();
+            /*! \fn
+              * A function to build a pdb file structure with one model per set of coordinates of the current assembly object
+              */
+            PdbFileSpace::PdbFile* BuildMultiModelPdbFileStructureFromAssembly();
             /*! \fn
               * A function to build a pdbqt file structure from the current assembly object
               * Exports data from assembly data structure into pdbqt file structure
@@ -322,12 +490,13 @@ namespace MolecularModeling
               * @param inserted_bond_types Bond types that have been already detected in the assembly structure
               * @param assembly_atom A source atom in a bond in the assembly structure
               * @param neighbor Second atom in a bond which is a neighbor of assembly_atom
-              * @param bonds All known bonds from parameter file
+              * @param parameters Layered view of the parameter files the types are looked up in
               * @param bond_type_counter A counter that indicates the number of bond types that have been already detected and also determines the index associated with it
               * @param topology_file Output topology file structure that the detected bond types belong to
               */
             void ExtractTopologyBondTypesFromAssembly(std::vector<std::vector<std::string> > &inserted_bond_types, Atom* assembly_atom, Atom* neighbor,
-                                                      ParameterFileSpace::ParameterFile::BondMap &bonds, int &bond_type_counter, TopologyFileSpace::TopologyFile* topology_file);
+                                                      const ParameterFileSpace::LayeredParameterFile& parameters, int &bond_type_counter,
+                                                      TopologyFileSpace::TopologyFile* topology_file);
             /*! \fn
               * A function to extract bond types from the current assembly object
               * @param inserted_bonds Bonds that have been already detected in the assembly structure
@@ -385,13 +554,13 @@ namespace MolecularModeling
               * @param neighbor_of_neighbor Third atom in an angle which is a neighbor of neighbor atom and it is not identical to assmebly_atom
               * @param inserted_angle_types Angle types that have been already detected in an assembly structure
               * @param angle_type_counter A counter that indicates the number of angle types that have been already detected and also determines the index associated with it
-              * @param topology_file Output topology file structure that the detected angle types belong to
+              * @param parameters Layered view of the parameter files the types are looked up in
               * @param angles All known angles from parameter file
               */
             void ExtractTopologyAngleTypesFromAssembly(Atom* assembly_atom, Atom* neighbor, Atom* neighbor_of_neighbor,
                                                        std::vector<std::vector<std::string> > &inserted_angle_types,
                                                        int &angle_type_counter, TopologyFileSpace::TopologyFile* topology_file,
-                                                       ParameterFileSpace::ParameterFile::AngleMap &angles);
+                                                       const ParameterFileSpace::LayeredParameterFile& parameters);
             /*! \fn
               * A function to build agnle types of topology file structure from the current assembly object
               * Exports data from assembly data structure to generate topology atom types
@@ -415,13 +584,24 @@ namespace MolecularModeling
               * @param neighbor_of_neighbor_of_neighbor Fourth atom in a dihedral which is a neighbor of neighbor of neighbor atom and it is not identical to neighbor atom
               * @param inserted_dihedrals_types Dihedral types that have been already detected in an assembly structure
               * @param dihedral_type_counter A counter that indicates the number of dihedral types that have been already detected and also determines the index associated with it
-              * @param topology_file Output topology file structure that the detected angle types belong to
+              * @param parameters Layered view of the parameter files the types are looked up in
               * @param dihedrals All known dihedrals from parameter file
               */
             void ExtractTopologyDihedralTypesFromAssembly(Atom* assembly_atom, Atom* neighbor, Atom* neighbor_of_neighbor, Atom* neighbor_of_neighbor_of_neighbor,
                                                        std::vector<std::string> &inserted_dihedral_types,
                                                        int &dihedral_type_counter, TopologyFileSpace::TopologyFile* topology_file,
-                                                       ParameterFileSpace::ParameterFile::DihedralMap &dihedrals);
+                                                       const ParameterFileSpace::LayeredParameterFile& parameters);
+            /*! \fn
+              * A function to build the improper dihedral types of topology file structure around an atom with three bonded atoms
+              * @param assembly_atom The center atom of the improper dihedral in the assembly structure
+              * @param inserted_dihedrals_types Dihedral types that have been already detected in an assembly structure
+              * @param dihedral_type_counter A counter that indicates the number of dihedral types that have been already detected and also determines the index associated with it
+              * @param parameters Layered view of the parameter files the types are looked up in
+              * @param dihedrals All known dihedrals from parameter file
+              */
+            void ExtractTopologyImproperDihedralTypesFromAssembly(Atom* assembly_atom, std::vector<std::string> &inserted_dihedral_types,
+                                                                  int &dihedral_type_counter, TopologyFileSpace::TopologyFile* topology_file,
+                                                                  const ParameterFileSpace::LayeredParameterFile& parameters);
             /*! \fn
               * A function to build dihedrals of topology file structure from the current assembly object
               * Exports data from assembly data structure to generate topology dihedrals
@@ -430,14 +610,26 @@ namespace MolecularModeling
               * @param neighbor_of_neighbor Third atom in a dihedral which is a neighbor of neighbor atom and it is not identical to assmebly_atom
               * @param neighbor_of_neighbor_of_neighbor Fourth atom in a dihedral which is a neighbor of neighbor of neighbor atom and it is not identical to neighbor atom
               * @param inserted_dihedrals Dihedrals that have been already detected in an assembly structure
-              * @param inserted_dihedral_types Dihedral types that have been already detected in an assembly structure
+              * @param parameters Layered view of the parameter files the types are looked up in
               * @param dihedrals All known dihedrals from parameter file
               * @param topology_file Output topology file structure that the detected angle types belong to
               */
             void ExtractTopologyDihedralsFromAssembly(Atom* assembly_atom, Atom* neighbor, Atom* neighbor_of_neighbor, Atom* neighbor_of_neighbor_of_neighbor,
                                                              std::vector<std::vector<std::string> > &inserted_dihedrals, std::vector<std::string> &inserted_dihedral_types,
-                                                             ParameterFileSpace::ParameterFile::DihedralMap &dihedrals,
+                                                             const ParameterFileSpace::LayeredParameterFile& parameters,
                                                              TopologyFileSpace::TopologyFile* topology_file);
+            /*! \fn
+              * A function to build the improper dihedrals of topology file structure around an atom with three bonded atoms
+              * @param assembly_atom The center atom of the improper dihedral in the assembly structure
+              * @param inserted_dihedrals Dihedrals that have been already detected in an assembly structure
+              * @param parameters Layered view of the parameter files the types are looked up in
+              * @param dihedrals All known dihedrals from parameter file
+              * @param topology_file Output topology file structure that the detected dihedrals belong to
+              */
+            void ExtractTopologyImproperDihedralsFromAssembly(Atom* assembly_atom, std::vector<std::vector<std::string> > &inserted_dihedrals,
+                                                              std::vector<std::string> &inserted_dihedral_types,
+                                                              const ParameterFileSpace::LayeredParameterFile& parameters,
+                                                              TopologyFileSpace::TopologyFile* topology_file);
 
             /*! \fn
               * A function to build a coordinate file structure from the current assembly object
@@ -454,15 +646,34 @@ namespace MolecularModeling
               * A function to build a graph structure (bonding information) for the current object of central data structure
               * @param building_option A building option that can be selected from BuildingStructureOption enumerator
               * @param options List of additional options that can be defined by user
-              * @param file_paths In the case that building structure based on the information of database files is selected this argument is a list of database file names
+              * @param file_paths In the case that building structure based on the information of database files is selected this argument is a list of database file names;
+              *         if it is empty, the library and prep files the assembly has been read from a pdb file with are used
               */
             void BuildStructure(gmml::BuildingStructureOption building_option, std::vector<std::string> options, std::vector<std::string> file_paths);
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the distance between the atoms of the structure
+              * The bonds found are added to the nodes the atoms already have, unless a rebuild is asked for
               * @param cutoff Threshold of closeness of the atoms to be considered as bonded
               * @param model_index In the case that the structure has multiple model (multiple coordinates for atoms, such as pdb) this arguments indicates the desired model index
+              * @param rebuild If true the nodes of an earlier build (e.g. the template bonds of BuildAssemblyFromPdbFile) are dropped first, so its bonds are replaced
+              */
+            void BuildStructureByDistance(int number_of_threads = 1, double cutoff = gmml::dCutOff, int model_index = 0, bool rebuild = false);
+            /*! \fn
+              * A function to build a graph structure based on the distance between the atoms using a cell list neighbour search
+              * If the assembly has a periodic box the minimum image convention is applied, so bonds across the box boundary are found
+              * The bonds found are added to the nodes the atoms already have, unless a rebuild is asked for
+              * @param cutoff Threshold of closeness of the atoms to be considered as bonded
+              * @param model_index In the case that the structure has multiple model (multiple coordinates for atoms, such as pdb) this arguments indicates the desired model index
+              * @param rebuild If true the nodes of an earlier build are dropped first, so its bonds are replaced
+              */
+            void BuildStructureByDistanceWithCellList(double cutoff = gmml::dCutOff, int model_index = 0, bool rebuild = false);
+            /*! \fn
+              * A function to undo the wrapping of molecules of a periodic structure into the box
+              * Atoms of each bonded fragment are moved to the periodic image closest to the atom they are bonded to
+              * The graph structure has to be built before calling this function
+              * @param model_index The index of the model (set of coordinates) that has to be updated
               */
-            void BuildStructureByDistance(int number_of_threads = 1, double cutoff = gmml::dCutOff, int model_index = 0);
+            void MakeMoleculesWhole(int model_index = 0);
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the bonding information provided in the original file
               */
@@ -475,6 +686,7 @@ namespace MolecularModeling
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the bonding information provided in
               * the original file in the case that the original file is a topology file
+              * The bonds are taken in one pass from the atom indices of the bond sections of the file
               */
             void BuildStructureByTOPFileInformation();
             /*! \fn
@@ -487,6 +699,12 @@ namespace MolecularModeling
               * the original file in the case that the original file is a prep file
               */
             void BuildStructureByPrepFileInformation();
+            /*! \fn
+              * A function to build a graph structure for the current object of central data structure based on the bonding information provided in
+              * an already parsed prep file
+              * @param prep_file The prep file that contains the residues of the current object
+              */
+            void BuildStructureByPrepFileInformation(PrepFileSpace::PrepFile* prep_file);
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the bonding information provided in
               * the given database files
@@ -494,6 +712,38 @@ namespace MolecularModeling
               * @param file_paths List of the database file paths
               */
             void BuildStructureByDatabaseFilesBondingInformation(std::vector<gmml::InputFileType> types, std::vector<std::string> file_paths);
+            /*! \fn
+              * A function to read the bonds of the given residues from the database files, each file is opened once and only the given residues are parsed
+              * A residue that is defined in more than one file is taken from the first of them
+              * @param types List of types of the database files (gmml::LIB or gmml::PREP)
+              * @param file_paths List of the database file paths
+              * @param residue_names Names of the residues whose templates are needed
+              * @return Bond templates of the residues by residue name
+              */
+            ResidueBondTemplateMap LoadResidueBondTemplates(std::vector<gmml::InputFileType> types, std::vector<std::string> file_paths, gmml::ResidueNameMap& residue_names);
+            /*! \fn
+              * A function to add the bonds of the given library residues to a set of bond templates
+              * Residues that already have a template are left as they are
+              * @param library_residues Library file residues by residue name
+              * @param templates Bond templates by residue name
+              */
+            void AddLibraryResidueBondTemplates(const LibraryFileSpace::LibraryFile::ResidueMap& library_residues, ResidueBondTemplateMap& templates);
+            /*! \fn
+              * A function to add the template bonds of the given prep residues to a set of bond templates
+              * Residues that already have a template are left as they are
+              * @param prep_residues Prep file residues by residue name
+              * @param templates Bond templates by residue name
+              */
+            void AddPrepResidueBondTemplates(PrepFileSpace::PrepFile::ResidueMap& prep_residues, ResidueBondTemplateMap& templates);
+            /*! \fn
+              * A function to build a graph structure for the current object of central data structure based on residue bond templates
+              * Atoms of a residue that has a template are bonded by the atom names of the template, looked up within the residue;
+              * bonds between residues, and the bonds of atoms that are not in any template, are found by a distance test over a cell list
+              * @param templates Bond templates by residue name, see LoadResidueBondTemplates
+              * @param cutoff Maximum length of a bond that is found by distance
+              * @param model_index Model (set of coordinates) that the distance test uses
+              */
+            void BuildStructureByResidueBondTemplates(ResidueBondTemplateMap& templates, double cutoff = gmml::dCutOff, int model_index = 0);
             /*! \fn
               * A function that counts the number of atoms in all assemblies and residues of the assembly
               * @return counter Number of atoms in all assemblies and residues in the current object of assembly
@@ -607,7 +857,21 @@ namespace MolecularModeling
             SelectPatternMap ParsePatternString(std::string pattern);
             void GetHierarchicalMapOfAssembly(HierarchicalContainmentMap& hierarchical_map, std::stringstream& index);
 
+            /*! \fn
+              * A function that removes the structure of the assembly
+              * The residues, atoms, nodes and coordinates that the assembly has built are destroyed; their storage is kept for the next structure
+              * Sub-assemblies that the assembly has created itself are deleted, the ones added from outside are only removed from the list
+              */
             void ClearAssembly();
+            /*! \fn
+              * A function that brings the assembly back to the state of a newly created one while keeping the storage of its structure,
+              * so a worker can build one structure after another with the same assembly
+              */
+            void Reset();
+            /*! \fn
+              * A function that builds the bond graph again, needed after atoms or bonds have been changed through residues or atom nodes directly
+              */
+            void UpdateBondGraph();
 
 //            void CycleDetection();
 //            std::vector<std::vector<std::string> > CreateAllCyclePermutations(std::string id1, std::string id2, std::string id3, std::string id4, std::string id5, std::string id6);
@@ -626,6 +890,26 @@ namespace MolecularModeling
               * @return all_residues_
               */
             PrepFileSpace::PrepFile::ResidueMap GetAllResiduesFromMultiplePrepFilesMap(std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to access to the given residues of the lib files, only these residues are parsed
+              * A residue of a later file replaces a residue with the same name of an earlier file
+              * @param lib_files The list of paths to library files
+              * @param residue_names Names of the residues to look up
+              * @param opened_lib_files The opened library files are added to this list; the caller deletes them once it is done with the residues
+              * @return The residues that have been found, by residue name
+              */
+            LibraryFileSpace::LibraryFile::ResidueMap GetResiduesFromMultipleLibFilesMap(std::vector<std::string> lib_files, gmml::ResidueNameMap& residue_names,
+                                                                                         std::vector<LibraryFileSpace::LibraryFile*>& opened_lib_files);
+            /*! \fn
+              * A function in order to access to the given residues of the prep files, only these residues are parsed
+              * A residue of a later file replaces a residue with the same name of an earlier file
+              * @param prep_files The list of paths to prep files
+              * @param residue_names Names of the residues to look up
+              * @param opened_prep_files The opened prep files are added to this list; the caller deletes them once it is done with the residues
+              * @return The residues that have been found, by residue name
+              */
+            PrepFileSpace::PrepFile::ResidueMap GetResiduesFromMultiplePrepFilesMap(std::vector<std::string> prep_files, gmml::ResidueNameMap& residue_names,
+                                                                                    std::vector<PrepFileSpace::PrepFile*>& opened_prep_files);
 
             /*! \fn
               * A function in order to extract all residue names existing in the given lib files
@@ -879,6 +1163,23 @@ namespace MolecularModeling
             void WriteHetAtoms(std::string file_name);
 
         private:
+            Assembly(const Assembly&);
+            Assembly& operator=(const Assembly&);
+            /*! \fn
+              * A function to remember the library and prep files an assembly has been read with, see BuildStructure
+              */
+            void SetDatabaseFiles(std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files,
+                                  std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function to set the type, charge, mass and radius of an atom read from a structure file by its residue template
+              * The library residues are searched first, then the prep residues; an atom whose residue is in neither is not changed
+              * @param atom The atom, its name has to be set
+              * @param residue_name Name of the residue of the atom
+              * @param parameter_atom_types Atom types of the parameter file, NULL if no parameter file is given
+              */
+            void SetAtomTypeFromTemplates(Atom* atom, const std::string& residue_name, LibraryFileSpace::LibraryFile::ResidueMap& lib_residues,
+                                          PrepFileSpace::PrepFile::ResidueMap& prep_residues, ParameterFileSpace::ParameterFile::AtomTypeMap* parameter_atom_types);
+
             //////////////////////////////////////////////////////////
             //                       ATTRIBUTES                     //
             //////////////////////////////////////////////////////////
@@ -892,6 +1193,15 @@ namespace MolecularModeling
             std::string source_file_;                       /*!< File name that the current assembly has been built upon >*/
             gmml::InputFileType source_file_type_;          /*!< Type of the file that the current assembly has been built upon >*/
             int model_index_;                               /*!< In case that there are more than one models for an assembly, this attribute indicated which model is the target model >*/
+            GeometryTopology::UnitCell unit_cell_;          /*!< Unit cell of the structure, owned by the assembly; set by the box line of a restart file or the CRYST1 card of a pdb file >*/
+            bool periodic_;                                 /*!< Whether unit_cell_ is a periodic box; true for a restart box and for a P 1 cell of a pdb file >*/
+            std::vector<int> model_serial_numbers_;         /*!< Serial number of the model of the pdb or cif file that each coordinate set of the atoms comes from >*/
+            std::vector<gmml::InputFileType> database_file_types_;  /*!< Types of the library and prep files the assembly has been read with >*/
+            std::vector<std::string> database_file_paths_;  /*!< Paths of the library and prep files the assembly has been read with >*/
+            BondGraph bond_graph_;                          /*!< Compact copy of the bonds of the atoms of the assembly, see GetBondGraph >*/
+            gmml::MemoryArena arena_;                       /*!< Storage of the residues, atoms, nodes and coordinates that the building functions create;
+                                                                 objects added from outside (e.g. AddResidue, AddAssembly) are not owned >*/
+            AssemblyVector owned_assemblies_;               /*!< Sub-assemblies created by the constructor with several files; deleted by ClearAssembly and the destructor >*/
     };
 
     struct DistanceCalculationThreadArgument{
@@ -900,6 +1210,7 @@ namespace MolecularModeling
             int model_index;
             double cutoff;
             Assembly* a;
+            gmml::MemoryArena* arena;
             DistanceCalculationThreadArgument()
             {
                 thread_index = 0;
@@ -907,15 +1218,58 @@ namespace MolecularModeling
                 model_index = 0;
                 cutoff = gmml::dCutOff;
                 a = NULL;
+                arena = NULL;
             }
 
-            DistanceCalculationThreadArgument(int ti, int tn, int mi, double c, Assembly* assembly)
+            DistanceCalculationThreadArgument(int ti, int tn, int mi, double c, Assembly* assembly, gmml::MemoryArena* thread_arena = NULL)
             {
                 thread_index = ti;
                 number_of_threads = tn;
                 model_index = mi;
                 cutoff = c;
                 a = assembly;
+                arena = thread_arena;
+            }
+    };
+
+    struct CondensedSequenceBuildThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            std::vector<std::string>* sequences;
+            PrepFileSpace::PrepFile* prep_file;
+            std::string prep_file_path;
+            ParameterFileSpace::ParameterFile* parameter_file;
+            std::string output_prefix;
+            std::vector<gmml::InputFileType>* output_types;
+            std::vector<bool>* built_sequences;
+            std::vector<std::string> messages;          /// Failures of the thread, reported by the caller after the join
+            CondensedSequenceBuildThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                sequences = NULL;
+                prep_file = NULL;
+                prep_file_path = "";
+                parameter_file = NULL;
+                output_prefix = "";
+                output_types = NULL;
+                built_sequences = NULL;
+                messages = std::vector<std::string>();
+            }
+
+            CondensedSequenceBuildThreadArgument(int ti, int tn, std::vector<std::string>* s, PrepFileSpace::PrepFile* prep, std::string prep_path,
+                                                 ParameterFileSpace::ParameterFile* parameter, std::string prefix, std::vector<gmml::InputFileType>* types, std::vector<bool>* built)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                sequences = s;
+                prep_file = prep;
+                prep_file_path = prep_path;
+                parameter_file = parameter;
+                output_prefix = prefix;
+                output_types = types;
+                built_sequences = built;
+                messages = std::vector<std::string>();
             }
     };
 }
@@ -6,10 +6,12 @@
 #include <iostream>
 #include <vector>
 
+#include "../memoryarena.hpp"
+
 namespace MolecularModeling
 {
     class Atom;
-    class AtomNode
+    class AtomNode : public gmml::ArenaAllocated<AtomNode>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -0,0 +1,211 @@
+#ifndef BONDGRAPH_HPP
+#define BONDGRAPH_HPP
+
+#include <vector>
+#include <utility>
+#include <atomic>
+
+namespace MolecularModeling
+{
+    class Atom;
+    /*! \class
+      * Compressed sparse row (CSR) copy of the bonds held by the atom nodes of a set of atoms
+      * Atoms are numbered by their position in the given atom list and the neighbors of all atoms are stored back to back in one
+      * array, so walking the graph touches two integer arrays instead of copying the neighbor list of every atom node.
+      * The neighbors of an atom keep the order of its atom node; bonds to atoms that are not in the list are left out. Like the
+      * BuildStructure functions of Assembly, the atom nodes are expected to list a bond on both of its atoms.
+      * The graph is a snapshot: it has to be built again after bonds have been added or removed. The mutators of AtomNode and
+      * Residue report their changes through MarkOutdated, so IsOutdated tells whether that is needed.
+      */
+    class BondGraph
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Atom*> AtomVector;
+            /*! \struct
+              * Bond between two atom indices, first < second
+              */
+            struct Bond
+            {
+                    int first;
+                    int second;
+            };
+            /*! \struct
+              * Angle first-center-last, first < last
+              */
+            struct Angle
+            {
+                    int first;
+                    int center;
+                    int last;
+            };
+            /*! \struct
+              * Proper dihedral first-second-third-fourth around the bond second-third, second < third
+              */
+            struct Dihedral
+            {
+                    int first;
+                    int second;
+                    int third;
+                    int fourth;
+            };
+
+            /*! \class
+              * Visits every bond of the graph once
+              */
+            class BondIterator
+            {
+                public:
+                    BondIterator(const BondGraph* graph, bool end);
+                    const Bond& operator*() const { return bond_; }
+                    const Bond* operator->() const { return &bond_; }
+                    BondIterator& operator++();
+                    bool operator==(const BondIterator& other) const { return position_ == other.position_; }
+                    bool operator!=(const BondIterator& other) const { return position_ != other.position_; }
+
+                private:
+                    bool IsValid() const;
+                    void Step();
+                    const BondGraph* graph_;        /*!< Graph that is walked >*/
+                    int position_;                  /*!< Position of the second atom in the neighbor array >*/
+                    Bond bond_;                     /*!< Current bond >*/
+            };
+
+            /*! \class
+              * Visits every angle of the graph once
+              */
+            class AngleIterator
+            {
+                public:
+                    AngleIterator(const BondGraph* graph, bool end);
+                    const Angle& operator*() const { return angle_; }
+                    const Angle* operator->() const { return &angle_; }
+                    AngleIterator& operator++();
+                    bool operator==(const AngleIterator& other) const { return angle_.center == other.angle_.center && first_ == other.first_ && last_ == other.last_; }
+                    bool operator!=(const AngleIterator& other) const { return !(*this == other); }
+
+                private:
+                    void Step();
+                    const BondGraph* graph_;        /*!< Graph that is walked >*/
+                    int first_;                     /*!< Position of the first atom in the neighbor array >*/
+                    int last_;                      /*!< Position of the last atom in the neighbor array >*/
+                    Angle angle_;                   /*!< Current angle >*/
+            };
+
+            /*! \class
+              * Visits every proper dihedral of the graph once
+              */
+            class DihedralIterator
+            {
+                public:
+                    DihedralIterator(const BondGraph* graph, bool end);
+                    const Dihedral& operator*() const { return dihedral_; }
+                    const Dihedral* operator->() const { return &dihedral_; }
+                    DihedralIterator& operator++();
+                    bool operator==(const DihedralIterator& other) const { return bond_ == other.bond_ && first_ == other.first_ && fourth_ == other.fourth_; }
+                    bool operator!=(const DihedralIterator& other) const { return !(*this == other); }
+
+                private:
+                    bool IsValid() const;
+                    void Step();
+                    const BondGraph* graph_;        /*!< Graph that is walked >*/
+                    BondIterator bond_;             /*!< Central bond >*/
+                    int first_;                     /*!< Position of the first atom in the neighbor array >*/
+                    int fourth_;                    /*!< Position of the fourth atom in the neighbor array >*/
+                    Dihedral dihedral_;             /*!< Current dihedral >*/
+            };
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, an empty graph
+              */
+            BondGraph();
+            /*! \fn
+              * Constructor to build the graph of the given atoms
+              * @param atoms List of atoms, the index of an atom in the graph is its position in the list
+              */
+            BondGraph(const AtomVector& atoms);
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            bool IsBuilt() const;
+            /*! \fn
+              * Check if atom nodes or residues have been changed since the graph has been built
+              */
+            bool IsOutdated() const;
+            int GetNumberOfAtoms() const;
+            int GetNumberOfBonds() const;
+            const AtomVector& GetAtoms() const;
+            Atom* GetAtom(int index) const;
+            /*! \fn
+              * Index of an atom in the graph
+              * @return Index of the atom, -1 if the atom is not in the graph
+              */
+            int GetIndex(Atom* atom) const;
+            int GetDegree(int index) const;
+            /*! \fn
+              * Neighbors of an atom are the indices in [NeighborsBegin(index), NeighborsEnd(index))
+              */
+            const int* NeighborsBegin(int index) const
+            {
+                return neighbors_.data() + offsets_[index];
+            }
+            const int* NeighborsEnd(int index) const
+            {
+                return neighbors_.data() + offsets_[index + 1];
+            }
+            bool AreBonded(int first, int second) const;
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Build the graph from the atom nodes of the given atoms, replacing the previous content
+              * @param atoms List of atoms, the index of an atom in the graph is its position in the list
+              */
+            void Build(const AtomVector& atoms);
+            void Clear();
+            /*! \fn
+              * Mark all graphs that have been built so far as outdated; called whenever bonds or atoms are added, removed or replaced
+              * The cost is two relaxed atomic loads, the store only happens for the first change after a graph has been built
+              */
+            static void MarkOutdated();
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            BondIterator BondsBegin() const;
+            BondIterator BondsEnd() const;
+            AngleIterator AnglesBegin() const;
+            AngleIterator AnglesEnd() const;
+            DihedralIterator DihedralsBegin() const;
+            DihedralIterator DihedralsEnd() const;
+            int CountAngles() const;
+            /*! \fn
+              * Find the atoms that are at most the given number of bonds away from each atom, e.g. the 1-2, 1-3 and 1-4 pairs of a force field
+              * @param excluded_atoms For each atom the sorted indices of the other atoms within number_of_bonds bonds
+              * @param number_of_bonds Maximum number of bonds between an atom and its excluded atoms
+              */
+            void FindExcludedAtoms(std::vector<std::vector<int> >& excluded_atoms, int number_of_bonds = 3) const;
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            static std::atomic<unsigned long> build_count_; /*!< Number of graphs that have been built in the process >*/
+            static std::atomic<unsigned long> last_change_; /*!< Value of build_count_ at the last change of an atom node or a residue >*/
+            bool built_;                                    /*!< The graph has been built >*/
+            unsigned long build_number_;                    /*!< Value of build_count_ when the graph has been built; changes at or after it outdate the graph >*/
+            AtomVector atoms_;                              /*!< Atom of each index >*/
+            std::vector<int> offsets_;                      /*!< Start of the neighbors of each atom in neighbors_, one extra entry at the end >*/
+            std::vector<int> neighbors_;                    /*!< Neighbor indices of all atoms back to back >*/
+            std::vector<std::pair<Atom*, int> > indices_;   /*!< Index of each atom, sorted by atom for binary search >*/
+    };
+}
+
+#endif // BONDGRAPH_HPP
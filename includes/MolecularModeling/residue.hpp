@@ -6,12 +6,13 @@
 #include <fstream>
 #include <vector>
 
+#include "../memoryarena.hpp"
 
 namespace MolecularModeling
 {
     class Assembly;
     class Atom;
-    class Residue
+    class Residue : public gmml::ArenaAllocated<Residue>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -0,0 +1,118 @@
+#ifndef ROTATABLEDIHEDRAL_HPP
+#define ROTATABLEDIHEDRAL_HPP
+
+#include <string>
+#include <iostream>
+#include <vector>
+
+namespace MolecularModeling
+{
+    class Atom;
+    /*! \class
+      * A dihedral of four bonded atoms whose central bond can be rotated
+      * The atoms that move with the fourth atom when the torsion changes are found once from the graph structure (AtomNode)
+      * of the atoms, so setting the torsion only rotates a precomputed list of coordinates in place
+      */
+    class RotatableDihedral
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Atom*> AtomVector;
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              */
+            RotatableDihedral();
+            /*! \fn
+              * Constructor that finds the moving atoms of the dihedral
+              * The graph structure of the assembly has to be built before
+              * @param atom1 First atom of the dihedral
+              * @param atom2 Second atom of the dihedral; it stays in place with the first atom
+              * @param atom3 Third atom of the dihedral; everything bonded to it on the side of the fourth atom moves
+              * @param atom4 Fourth atom of the dihedral
+              */
+            RotatableDihedral(Atom* atom1, Atom* atom2, Atom* atom3, Atom* atom4);
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the four atoms of the dihedral
+              * @return atoms_ attribute of the current object of this class
+              */
+            AtomVector GetAtoms();
+            /*! \fn
+              * An accessor function in order to access to the atoms that move when the torsion changes
+              * @return moving_atoms_ attribute of the current object of this class
+              */
+            AtomVector GetMovingAtoms();
+            /*! \fn
+              * Check if the central bond of the dihedral can be rotated
+              * @return False if the central bond is part of a ring (or the atoms have not been set)
+              */
+            bool IsRotatable();
+            /*! \fn
+              * Calculate the current torsion of the dihedral
+              * @param model_index Index of the model whose coordinates are used
+              * @return Torsion in degree, in the range (-180, 180]
+              */
+            double GetTorsion(int model_index = 0);
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A mutator function in order to set the atoms of the dihedral and find the moving atoms again
+              * @param atom1 First atom of the dihedral
+              * @param atom2 Second atom of the dihedral
+              * @param atom3 Third atom of the dihedral
+              * @param atom4 Fourth atom of the dihedral
+              */
+            void SetAtoms(Atom* atom1, Atom* atom2, Atom* atom3, Atom* atom4);
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Set the torsion of the dihedral by rotating the moving atoms around the central bond
+              * @param torsion The new torsion in degree
+              * @param model_index Index of the model whose coordinates are changed
+              */
+            void SetTorsion(double torsion, int model_index = 0);
+            /*! \fn
+              * Rotate the moving atoms around the central bond
+              * @param angle Rotation angle in degree
+              * @param model_index Index of the model whose coordinates are changed
+              */
+            void RotateTorsion(double angle, int model_index = 0);
+
+            //////////////////////////////////////////////////////////
+            //                       DISPLAY FUNCTION               //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to print out the atoms and the torsion of the dihedral
+              * @param out An output stream, the print result will be written in the given output stream
+              */
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            void FindMovingAtoms();
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            AtomVector atoms_;                  /*!< The four atoms of the dihedral >*/
+            AtomVector moving_atoms_;           /*!< Atoms on the side of the third atom (excluding it) that move with the fourth atom >*/
+            bool rotatable_;                    /*!< False if the central bond is part of a ring >*/
+    };
+}
+
+#endif // ROTATABLEDIHEDRAL_HPP
@@ -0,0 +1,342 @@
+#ifndef FORCEFIELDBUNDLE_HPP
+#define FORCEFIELDBUNDLE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+namespace ParameterFileSpace
+{
+    class ParameterFile;
+}
+namespace LibraryFileSpace
+{
+    class LibraryFile;
+}
+namespace PrepFileSpace
+{
+    class PrepFile;
+}
+
+namespace ForceFieldBundleSpace
+{
+    /*! \class
+      * Precompiled binary form of a force field: the parameter, library and prep files that a leaprc loads, in one file
+      * A bundle is compiled once from the text files (see Compile) and opened with a single read-only mmap; nothing is parsed
+      * when it is opened. All strings are interned in one table and every file of the bundle (a source) is a set of arrays of
+      * fixed size records that refer to the strings by index. The bond, angle, dihedral and atom type records of a parameter
+      * file are indexed by open addressing hash tables over their interned atom types, so single terms can be looked up in the
+      * mapped file without building any object (FindAtomType, FindBond, FindAngle, FindDihedral).
+      * LoadParameterFile, LoadLibraryFile and LoadPrepFile build the usual file objects from the records of a source, for the
+      * code that works with these interfaces.
+      * The records are stored in the byte order of the machine that has compiled the bundle; a bundle of another format version
+      * or byte order is rejected and has to be compiled again from the text files.
+      */
+    class ForceFieldBundle
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                     TYPE DEFINITION                  //
+            //////////////////////////////////////////////////////////
+            /*! \enum
+              * File type of a source of the bundle
+              */
+            enum SourceKind { kParameterSource = 0, kLibrarySource = 1, kPrepSource = 2 };
+            /*! \enum
+              * Tables of a source; the meaning of an entry depends on the kind of the source
+              */
+            enum ParameterTable { kAtomTypeTable = 0, kEquivalentTypeTable, kBondTable, kHbondCoefficientTable, kAngleTable,
+                                  kDihedralTable, kDihedralTermTable, kAtomTypeHashTable, kBondHashTable, kAngleHashTable,
+                                  kDihedralHashTable };
+            enum LibraryTable { kLibraryResidueTable = 0, kLibraryAtomTable, kLibraryBondedAtomTable };
+            enum PrepTable { kPrepResidueTable = 0, kPrepAtomTable, kPrepImproperTable, kPrepLoopTable };
+            static const int NUMBER_OF_TABLES = 11;
+            /*! \def
+              * Index of a string in the string table of the bundle
+              */
+            typedef uint32_t StringId;
+
+            /*! \struct
+              * Position of an array in the bundle
+              */
+            struct Table
+            {
+                    uint64_t offset;                        /*!< Byte offset of the first entry from the start of the bundle >*/
+                    uint64_t count;                         /*!< Number of entries >*/
+            };
+            /*! \struct
+              * Start of the bundle file
+              */
+            struct Header
+            {
+                    char magic[8];                          /*!< "GMMLFFB" >*/
+                    uint32_t version;                       /*!< FORMAT_VERSION of the code that has written the bundle >*/
+                    uint32_t byte_order;                    /*!< BYTE_ORDER_MARK as written by the machine that has compiled the bundle >*/
+                    uint64_t size;                          /*!< Size of the bundle file in bytes >*/
+                    Table string_offsets;                   /*!< Offset of each string in string_data, one extra entry at the end (uint64_t) >*/
+                    Table string_data;                      /*!< Characters of all strings, each terminated by a zero (char) >*/
+                    Table string_hash;                      /*!< Hash table of the strings (string id + 1, 0 for an empty slot) >*/
+                    Table sources;                          /*!< Files of the bundle (SourceRecord) >*/
+            };
+            /*! \struct
+              * A file of the bundle
+              */
+            struct SourceRecord
+            {
+                    uint32_t kind;                          /*!< SourceKind >*/
+                    uint32_t parameter_file_type;           /*!< gmml::ParameterFileType of a parameter file >*/
+                    StringId name;                          /*!< File name of the compiled file >*/
+                    StringId path;                          /*!< Path of the file that has been compiled >*/
+                    StringId title;                         /*!< Title of a parameter file >*/
+                    uint32_t padding;
+                    Table tables[NUMBER_OF_TABLES];         /*!< Tables of the source, see ParameterTable, LibraryTable and PrepTable >*/
+            };
+            struct AtomTypeRecord
+            {
+                    StringId type;
+                    StringId dscr;
+                    StringId mod4_dscr;
+                    uint32_t flags;                         /*!< IS_HYDROPHILIC, IS_EMPTY (the type is a key of the atom type map without an atom object) >*/
+                    uint32_t equivalent_first;              /*!< First entry in the equivalent type table >*/
+                    uint32_t equivalent_count;
+                    double mass;
+                    double polarizability;
+                    double radius;
+                    double well_depth;
+            };
+            struct BondRecord
+            {
+                    StringId types[2];
+                    StringId dscr;
+                    uint32_t hbond_coefficient_first;       /*!< First entry in the hbond coefficient table >*/
+                    uint32_t hbond_coefficient_count;
+                    uint32_t padding;
+                    double force_constant;
+                    double length;
+            };
+            struct AngleRecord
+            {
+                    StringId types[3];
+                    StringId dscr;
+                    double force_constant;
+                    double angle;
+            };
+            struct DihedralRecord
+            {
+                    StringId types[4];
+                    uint32_t term_first;                    /*!< First entry in the dihedral term table >*/
+                    uint32_t term_count;
+                    uint32_t flags;                         /*!< IS_GENERIC, IS_IMPROPER >*/
+                    uint32_t padding;
+                    double scee;
+                    double scnb;
+            };
+            struct DihedralTermRecord
+            {
+                    int32_t factor;
+                    StringId dscr;
+                    double force_constant;
+                    double phase;
+                    double periodicity;
+            };
+            struct LibraryResidueRecord
+            {
+                    StringId name;
+                    uint32_t atom_first;                    /*!< First entry in the library atom table >*/
+                    uint32_t atom_count;
+                    int32_t head_atom_index;
+                    int32_t tail_atom_index;
+                    uint32_t padding;
+                    double box_angle;
+                    double box_length;
+                    double box_width;
+                    double box_height;
+            };
+            struct LibraryAtomRecord
+            {
+                    StringId type;
+                    StringId name;
+                    int32_t residue_index;
+                    int32_t atom_index;
+                    int32_t atomic_number;
+                    int32_t atom_order;
+                    uint32_t bonded_atom_first;             /*!< First entry in the bonded atom table (int32_t) >*/
+                    uint32_t bonded_atom_count;
+                    double charge;
+                    double coordinate[3];
+            };
+            struct PrepResidueRecord
+            {
+                    StringId title;
+                    StringId name;
+                    StringId dummy_atom_type;
+                    int32_t coordinate_type;
+                    int32_t output_format;
+                    int32_t geometry_type;
+                    int32_t dummy_atom_omission;
+                    int32_t dummy_atom_position;
+                    uint32_t atom_first;                    /*!< First entry in the prep atom table >*/
+                    uint32_t atom_count;
+                    uint32_t improper_first;                /*!< First entry in the improper table: the number of atoms of each improper dihedral followed by their names (StringId) >*/
+                    uint32_t improper_count;                /*!< Number of entries, not of improper dihedrals >*/
+                    uint32_t loop_first;                    /*!< First entry in the loop table (pairs of int32_t) >*/
+                    uint32_t loop_count;
+                    double charge;
+            };
+            struct PrepAtomRecord
+            {
+                    int32_t index;
+                    StringId name;
+                    StringId type;
+                    int32_t topological_type;
+                    int32_t bond_index;
+                    int32_t angle_index;
+                    int32_t dihedral_index;
+                    uint32_t padding;
+                    double bond_length;
+                    double angle;
+                    double dihedral;
+                    double charge;
+            };
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, a bundle without any source
+              */
+            ForceFieldBundle();
+            /*! \fn
+              * Constructor to open a bundle file
+              * @param bundle_file Path of a bundle written by Compile
+              */
+            ForceFieldBundle(const std::string& bundle_file);
+            ~ForceFieldBundle();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            const std::string& GetFilePath() const;
+            int GetNumberOfSources() const;
+            SourceKind GetSourceKind(int source) const;
+            /*! \fn
+              * File name of a source without its directory
+              */
+            const char* GetSourceName(int source) const;
+            /*! \fn
+              * Path of the file a source has been compiled from
+              */
+            const char* GetSourcePath(int source) const;
+            /*! \fn
+              * Type of a parameter file source (gmml::MAIN, gmml::MODIFIED or gmml::IONICMOD)
+              */
+            int GetParameterFileType(int source) const;
+            /*! \fn
+              * Index of a source by its name or its compiled path, the first match in load order
+              * @return Index of the source, -1 if there is none
+              */
+            int FindSource(const std::string& name) const;
+            const char* GetString(StringId id) const;
+            /*! \fn
+              * Index of an interned string, found through the hash table of the strings
+              * @return true if the string is in the bundle
+              */
+            bool FindString(const std::string& value, StringId& id) const;
+            /*! \fn
+              * Records of a parameter file source found by their atom types, in the order they are given in the file
+              * @return The record, NULL if the source does not have it
+              */
+            const AtomTypeRecord* FindAtomType(int source, const std::string& type) const;
+            const BondRecord* FindBond(int source, const std::string& type1, const std::string& type2) const;
+            const AngleRecord* FindAngle(int source, const std::string& type1, const std::string& type2, const std::string& type3) const;
+            const DihedralRecord* FindDihedral(int source, const std::string& type1, const std::string& type2, const std::string& type3,
+                                               const std::string& type4) const;
+            /*! \fn
+              * Terms of a dihedral record are the entries [term_first, term_first + term_count) of this array
+              */
+            const DihedralTermRecord* GetDihedralTerms(int source) const;
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Map a bundle file, replacing the previous one
+              * @param bundle_file Path of a bundle written by Compile
+              */
+            void Open(const std::string& bundle_file);
+            void Close();
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Compile the files that a leaprc loads (loadamberparams, loadamberprep and loadOff commands) into a bundle
+              * The type of a parameter file is taken from its content: a frcmod file starts with a MASS section after its title and is
+              * an ionic one if it does not have bond, angle or dihedral sections.
+              * @param leaprc_file Path of the leaprc file
+              * @param search_paths Directories the loaded files are searched in after the directory of the leaprc file
+              * @param bundle_file Path of the bundle to be written
+              */
+            static void Compile(const std::string& leaprc_file, const std::vector<std::string>& search_paths, const std::string& bundle_file);
+            /*! \fn
+              * Compile already loaded files into a bundle; the sources are stored in the given order
+              * @param bundle_file Path of the bundle to be written
+              */
+            static void Compile(const std::vector<ParameterFileSpace::ParameterFile*>& parameter_files,
+                                const std::vector<LibraryFileSpace::LibraryFile*>& library_files,
+                                const std::vector<PrepFileSpace::PrepFile*>& prep_files, const std::string& bundle_file);
+            /*! \fn
+              * Build a parameter file object from a parameter file source; its records are created in the arena of the new object
+              * @return A new object owned by the caller
+              */
+            ParameterFileSpace::ParameterFile* LoadParameterFile(int source) const;
+            LibraryFileSpace::LibraryFile* LoadLibraryFile(int source) const;
+            PrepFileSpace::PrepFile* LoadPrepFile(int source) const;
+
+            static const uint32_t FORMAT_VERSION = 1;
+            static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+            static const uint32_t IS_HYDROPHILIC = 1;
+            static const uint32_t IS_EMPTY = 2;
+            static const uint32_t IS_GENERIC = 1;
+            static const uint32_t IS_IMPROPER = 2;
+
+        private:
+            ForceFieldBundle(const ForceFieldBundle&);
+            ForceFieldBundle& operator=(const ForceFieldBundle&);
+            const SourceRecord& GetSource(int source) const;
+            const SourceRecord& GetSource(int source, SourceKind kind) const;
+            /*! \fn
+              * Start of a table of a source, the bounds of the table have been checked by Open
+              */
+            template<class T>
+            const T* GetTable(const SourceRecord& source, int table) const
+            {
+                return reinterpret_cast<const T*>(data_ + source.tables[table].offset);
+            }
+            /*! \fn
+              * Record index of the given atom types in a hash table of a source
+              * @return Index of the record, -1 if the source does not have it
+              */
+            int FindRecord(const SourceRecord& source, int hash_table, int record_table, const std::string* types, int number_of_types) const;
+            void Validate() const;
+            /*! \fn
+              * Check the string indices, the ranges of other tables and the hash slots of the records of a source
+              * @param number_of_strings Number of strings of the bundle
+              */
+            void ValidateParameterSource(const SourceRecord& source, uint64_t number_of_strings) const;
+            void ValidateLibrarySource(const SourceRecord& source, uint64_t number_of_strings) const;
+            void ValidatePrepSource(const SourceRecord& source, uint64_t number_of_strings) const;
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            std::string path_;                      /*!< Path of the mapped bundle >*/
+            const char* data_;                      /*!< Start of the mapping, NULL if no bundle is open >*/
+            std::size_t size_;                      /*!< Size of the mapping >*/
+            const Header* header_;                  /*!< Header at the start of the mapping >*/
+            const SourceRecord* sources_;           /*!< Source directory of the bundle >*/
+    };
+}
+
+#endif // FORCEFIELDBUNDLE_HPP
@@ -0,0 +1,48 @@
+#ifndef FORCEFIELDBUNDLEPROCESSINGEXCEPTION_HPP
+#define FORCEFIELDBUNDLEPROCESSINGEXCEPTION_HPP
+
+#include <exception>
+#include <string>
+
+namespace ForceFieldBundleSpace
+{
+    class ForceFieldBundleProcessingException : public std::exception
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Constructor of exception handler of force field bundle class
+              * @param message An appropriate message corresponding to an exception
+              */
+            ForceFieldBundleProcessingException(const std::string& message);
+            /*! \fn
+              * Constructor of exception handler of force field bundle class feeded by the line number in which exception has been fired
+              * @param line_number The line number in which the exception has been occured
+              * @param message An appropriate message corresponding to an exception
+              */
+            ForceFieldBundleProcessingException(int line_number, const std::string& message);
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Virtual function to explain what is the reason of the occured exception
+              */
+            virtual const char *what() const throw();
+            /*! \fn
+              * Destructor
+              */
+            virtual ~ForceFieldBundleProcessingException() throw();
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            int line_number_;               /*!< Line number*/
+            std::string message_;           /*!< message*/
+            mutable std::string what_;      /*!< Explanation*/
+    };
+}
+
+#endif // FORCEFIELDBUNDLEPROCESSINGEXCEPTION_HPP
@@ -5,12 +5,20 @@
 #include <map>
 #include <iostream>
 #include <vector>
+#include <pthread.h>
 #include "../../common.hpp"
+#include "../../memoryarena.hpp"
 
 namespace LibraryFileSpace
 {
     class LibraryFileResidue;
     class LibraryFileAtom;
+    /*! \class
+      * A library file that has been opened by path is only indexed: the residue names of the index section and the position of
+      * the first section of every residue are recorded, and a residue is parsed the first time it is asked for by
+      * GetLibraryResidueByResidueName or GetAllAtomNamesOfResidue. GetResidues, Write and Print parse the residues that are
+      * still left. Lookups may be done from several threads at once.
+      */
     class LibraryFile
     {
         public:
@@ -47,9 +55,16 @@ namespace LibraryFileSpace
             const std::string& GetFilePath() const;
             /*! \fn
               * An accessor function in order to access to residue map created based on the content of the given file
+              * Residues that have not been parsed yet are parsed first
               * @return residues_ attribute of the current object of this class
               */
-            const ResidueMap& GetResidues() const;
+            const ResidueMap& GetResidues();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
             /*! \fn
               * An accessor function in order to access to all residue names of the current object
               * @return residue_names residue names of the current object of this class
@@ -91,13 +106,21 @@ namespace LibraryFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a library file
               */
-            void Read(std::ifstream& in_file);
+            void Read(std::istream& in_file);
             /*! \fn
               * Process a line of the atom section of a library file and create a new atom object
               * @param line A line from the atom section of a library file
               * @return A new LibraryFileAtom instance created by the information of the given line
               */
             LibraryFileAtom* ProcessAtom(std::string& line);
+            /*! \fn
+              * Process the sections of a residue, from its atom section to its velocities section
+              * @param in_file A stream positioned after the first line of the sections of the residue
+              * @param line The first line of the sections of the residue; the line after the sections when the function returns
+              * @param residue The residue to fill
+              * @return false if the end of the file has been reached
+              */
+            bool ProcessResidueSections(std::istream& in_file, std::string& line, LibraryFileResidue* residue);
             /*! \fn
               * A function in order to access to library file residue by a residue name
               * @param residue_name The name of the residue
@@ -210,11 +233,25 @@ namespace LibraryFileSpace
             void Print(std::ostream& out = std::cout);
 
         private:
+            /*! \fn
+              * Record the residue names of the index section and the position of the sections of every residue without parsing them
+              * @param in_file A stream contains whole contents of a library file
+              */
+            void IndexResidueSections(std::istream& in_file);
+            /*! \fn
+              * Parse the residues of the file that have not been parsed yet; the caller has to hold mutex_, which is released if parsing fails
+              * @param residue_name Name of the residue to parse, all remaining residues if empty
+              */
+            void LoadPendingResidues(const std::string& residue_name = "");
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
             std::string path_;          /*!< Path of the given library file */
             ResidueMap residues_;       /*!< Map of residues included in the given file mapped to their names */
+            std::map<std::string, std::streampos> pending_residues_;   /*!< Position in the file of the sections of the residues that have not been parsed yet, -1 if there are none */
+            pthread_mutex_t mutex_;     /*!< Guards the parsing of pending residues */
+            gmml::MemoryArena arena_;   /*!< Storage of the residues and atoms that have been read from the file */
     };
 }
 
@@ -5,10 +5,11 @@
 #include <vector>
 #include <iostream>
 #include "../../GeometryTopology/coordinate.hpp"
+#include "../../memoryarena.hpp"
 
 namespace LibraryFileSpace
 {
-    class LibraryFileAtom
+    class LibraryFileAtom : public gmml::ArenaAllocated<LibraryFileAtom>
     {
         public:
             //////////////////////////////////////////////////////////
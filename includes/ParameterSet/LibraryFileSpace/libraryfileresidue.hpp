@@ -6,10 +6,12 @@
 #include <map>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace LibraryFileSpace
 {
     class LibraryFileAtom;
-    class LibraryFileResidue
+    class LibraryFileResidue : public gmml::ArenaAllocated<LibraryFileResidue>
     {
         public:
             //////////////////////////////////////////////////////////
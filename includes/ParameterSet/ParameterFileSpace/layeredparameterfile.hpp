@@ -0,0 +1,112 @@
+#ifndef LAYEREDPARAMETERFILE_HPP
+#define LAYEREDPARAMETERFILE_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace ParameterFileSpace
+{
+    class ParameterFile;
+    class ParameterFileAtom;
+    class ParameterFileBond;
+    class ParameterFileAngle;
+    class ParameterFileDihedral;
+
+    /*! \class
+      * Read-only view of a parameter set made of a base parameter file and any number of frcmod files stacked over it
+      * Lookups follow the override rules of leap: an entry of a layer replaces the entry of the same atom types in all layers
+      * below it, bonds and angles match their atom types in both directions, proper dihedrals in both directions and improper
+      * dihedrals only in the given order. A dihedral of a layer replaces all terms of the dihedral below it. The mass and the
+      * nonbonded parameters of an atom type are separate entries, as in the MASS and NONB sections of a frcmod file.
+      * The view keeps one hash index over all layers that points to the objects of the parameter files, nothing is copied; the
+      * parameter files must outlive the view and must not change while it is used.
+      * A view can be stacked on another view (see the parent constructor), so the index of a large base set is built once and
+      * shared by all the views with different frcmod files over it.
+      */
+    class LayeredParameterFile
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Constructor of a view of a single parameter file, more layers can be added with AddLayer
+              * @param base_parameter_file Main parameter file at the bottom of the view
+              */
+            LayeredParameterFile(ParameterFile* base_parameter_file);
+            /*! \fn
+              * Constructor of a view over another view; the layers added to this view override the parent, which is not changed
+              * @param parent View at the bottom of this view, it must outlive this view
+              */
+            LayeredParameterFile(const LayeredParameterFile* parent);
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            const LayeredParameterFile* GetParent() const;
+            /*! \fn
+              * Layers of this view from the bottom to the top, without the layers of the parent
+              */
+            const std::vector<ParameterFile*>& GetLayers() const;
+            /*! \fn
+              * Atom type of the top-most layer that defines its mass
+              * @return The atom type, NULL if no layer has it
+              */
+            ParameterFileAtom* GetAtomType(const std::string& type) const;
+            /*! \fn
+              * Atom type of the top-most layer that defines its nonbonded (radius and well depth) parameters
+              * @return The atom type, NULL if no layer has them
+              */
+            ParameterFileAtom* GetNonbondedAtomType(const std::string& type) const;
+            /*! \fn
+              * @param types Two atom types in either order
+              * @return The bond of the top-most layer that has it, NULL if no layer has it
+              */
+            ParameterFileBond* GetBond(const std::vector<std::string>& types) const;
+            /*! \fn
+              * @param types Three atom types in either order
+              * @return The angle of the top-most layer that has it, NULL if no layer has it
+              */
+            ParameterFileAngle* GetAngle(const std::vector<std::string>& types) const;
+            /*! \fn
+              * @param types Four atom types, in either order for a proper dihedral
+              * @param is_improper Look the improper dihedrals up instead of the proper ones
+              * @return The dihedral of the top-most layer that has it, NULL if no layer has it
+              */
+            ParameterFileDihedral* GetDihedral(const std::vector<std::string>& types, bool is_improper = false) const;
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Stack a parameter file on top of the view, its entries override the entries of all layers below it
+              * @param parameter_file A frcmod (or another main) parameter file, it must outlive the view
+              */
+            void AddLayer(ParameterFile* parameter_file);
+
+        private:
+            typedef std::unordered_map<std::string, ParameterFileAtom*> AtomTypeIndex;
+            typedef std::unordered_map<std::string, ParameterFileBond*> BondIndex;
+            typedef std::unordered_map<std::string, ParameterFileAngle*> AngleIndex;
+            typedef std::unordered_map<std::string, ParameterFileDihedral*> DihedralIndex;
+
+            /*! \fn
+              * Key of a set of atom types in the index; the types are put in the smaller of both orders if the reverse order matches too
+              */
+            static std::string CreateKey(const std::vector<std::string>& types, bool either_direction, const char* prefix = "");
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            const LayeredParameterFile* parent_;    /*!< View below this one, NULL at the bottom >*/
+            std::vector<ParameterFile*> layers_;    /*!< Parameter files of this view from the bottom to the top >*/
+            AtomTypeIndex atom_types_;              /*!< Top-most atom type with a mass by its type >*/
+            AtomTypeIndex nonbonded_atom_types_;    /*!< Top-most atom type with nonbonded parameters by its type >*/
+            BondIndex bonds_;                       /*!< Top-most bond by its key >*/
+            AngleIndex angles_;                     /*!< Top-most angle by its key >*/
+            DihedralIndex dihedrals_;               /*!< Top-most proper and improper dihedral by its key >*/
+    };
+}
+
+#endif // LAYEREDPARAMETERFILE_HPP
@@ -6,6 +6,7 @@
 #include <map>
 #include <iostream>
 #include "../../common.hpp"
+#include "../../memoryarena.hpp"
 
 namespace ParameterFileSpace
 {
@@ -45,6 +46,11 @@ namespace ParameterFileSpace
               * @param param_file An existing library file path to be read
               */
             ParameterFile(std::string param_file, int type = gmml::MAIN);
+            /*! \fn
+              * Default constructor, an empty parameter file to be filled by the mutators
+              * @param type Type of the parameter file (MAIN, MODIFIED, IONICMOD), used when the file is written
+              */
+            explicit ParameterFile(int type = gmml::MAIN);
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
@@ -94,6 +100,12 @@ namespace ParameterFileSpace
               * @return proper_dihedrals proper dihedrals the current object of this class
               */
             DihedralMap GetAllproperDihedrals();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by the mutators, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
 
             //////////////////////////////////////////////////////////
             //                           MUTATOR                    //
@@ -104,6 +116,42 @@ namespace ParameterFileSpace
               * @param file_type The file type attribute of the current object
               */
             void SetParameterFileType(int file_type);
+            /*! \fn
+              * A mutator function in order to set the path of the current parameter file
+              * Set the path_ attribute of the current parameter file
+              * @param path The path attribute of the current object
+              */
+            void SetPath(const std::string& path);
+            /*! \fn
+              * A mutator function in order to set the title of the current parameter file
+              * Set the title_ attribute of the current parameter file
+              * @param title The title attribute of the current object
+              */
+            void SetTitle(const std::string& title);
+            /*! \fn
+              * A mutator function in order to set the atom types of the current parameter file
+              * Set the atom_types_ attribute of the current parameter file
+              * @param atom_types The atom type map attribute of the current object
+              */
+            void SetAtomTypes(const AtomTypeMap& atom_types);
+            /*! \fn
+              * A mutator function in order to set the bonds of the current parameter file
+              * Set the bonds_ attribute of the current parameter file
+              * @param bonds The bond map attribute of the current object
+              */
+            void SetBonds(const BondMap& bonds);
+            /*! \fn
+              * A mutator function in order to set the angles of the current parameter file
+              * Set the angles_ attribute of the current parameter file
+              * @param angles The angle map attribute of the current object
+              */
+            void SetAngles(const AngleMap& angles);
+            /*! \fn
+              * A mutator function in order to set the dihedrals of the current parameter file
+              * Set the dihedrals_ attribute of the current parameter file
+              * @param dihedrals The dihedral map attribute of the current object
+              */
+            void SetDihedrals(const DihedralMap& dihedrals);
             //////////////////////////////////////////////////////////
             //                         FUNCTIONS                    //
             //////////////////////////////////////////////////////////
@@ -112,19 +160,19 @@ namespace ParameterFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a parameter file
               */
-            void ReadMainParameter(std::ifstream& in_file);
+            void ReadMainParameter(std::istream& in_file);
             /*! \fn
               * A function to parse the contents of a given stream of a file
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a frcmod parameter file
               */
-            void ReadModifiedParameter(std::ifstream& in_file);
+            void ReadModifiedParameter(std::istream& in_file);
             /*! \fn
               * A function to parse the contents of a given stream of a file
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a frcmod parameter file containing ions
               */
-            void ReadIonicModifiedParameter(std::ifstream& in_file);
+            void ReadIonicModifiedParameter(std::istream& in_file);
             /*! \fn
               * A function that parses a line of atom type section of the current object
               * Process the atom type lines of the parameter file
@@ -156,7 +204,7 @@ namespace ParameterFileSpace
               * @param line_number The line number of the current read line from the parameter file
               * @param in_file A stream of the current parameter file
               */
-            void ProcessDihedral(std::string& line, int& line_number, std::ifstream& in_file);
+            void ProcessDihedral(std::string& line, int& line_number, std::istream& in_file);
             /*! \fn
               * A function that parses a line of improper dihedral section of the current object
               * Process the improper dihedral lines of the parameter file
@@ -164,7 +212,7 @@ namespace ParameterFileSpace
               * @param line_number The line number of the current read line from the parameter file
               * @param in_file A stream of the current parameter file
               */
-            void ProcessImproperDihedral(std::string& line, int& line_number, std::ifstream& in_file);
+            void ProcessImproperDihedral(std::string& line, int& line_number, std::istream& in_file);
             /*! \fn
               * A function that parses a line of hydrogen bond section of the current object
               * Process the hydrogen bond lines of the parameter file
@@ -278,6 +326,7 @@ namespace ParameterFileSpace
             AngleMap angles_;            /*!< A collection of mapping between angle (tripple atom types) and its attributes*/
             DihedralMap dihedrals_;      /*!< A collection of mapping between dihedral (quad atom types) and its attributes*/
             int file_type_;              /*!< An integer number that indicates main parameter file and modified one from each other >*/
+            gmml::MemoryArena arena_;    /*!< Storage of the parameters that have been read from the file >*/
 
     };
 }
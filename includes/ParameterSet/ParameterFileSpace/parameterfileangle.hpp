@@ -5,9 +5,11 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace ParameterFileSpace
 {
-    class ParameterFileAngle
+    class ParameterFileAngle : public gmml::ArenaAllocated<ParameterFileAngle>
     {
         public:
             //////////////////////////////////////////////////////////
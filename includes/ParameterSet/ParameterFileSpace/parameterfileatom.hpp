@@ -5,9 +5,11 @@
 #include <vector>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace ParameterFileSpace
 {
-    class ParameterFileAtom
+    class ParameterFileAtom : public gmml::ArenaAllocated<ParameterFileAtom>
     {
         public:
             //////////////////////////////////////////////////////////
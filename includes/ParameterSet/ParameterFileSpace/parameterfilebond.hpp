@@ -5,9 +5,11 @@
 #include <string>
 #include <iostream>
 
+#include "../../memoryarena.hpp"
+
 namespace ParameterFileSpace
 {
-    class ParameterFileBond
+    class ParameterFileBond : public gmml::ArenaAllocated<ParameterFileBond>
     {
         public:
             ///////////////////////////////////////////////////////////
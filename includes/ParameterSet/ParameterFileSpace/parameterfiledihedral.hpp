@@ -5,11 +5,12 @@
 #include <vector>
 #include <iostream>
 #include "../../common.hpp"
+#include "../../memoryarena.hpp"
 
 namespace ParameterFileSpace
 {
     class ParameterFileDihedralTerm;
-    class ParameterFileDihedral
+    class ParameterFileDihedral : public gmml::ArenaAllocated<ParameterFileDihedral>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -5,11 +5,18 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <pthread.h>
 #include "../../common.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PrepFileSpace
 {
     class PrepFileResidue;
+    /*! \class
+      * A prep file that has been opened by path is only indexed: the position of every residue section in the file is recorded
+      * and a residue is parsed the first time it is asked for, by GetPrepResidueByResidueName or GetAllAtomNamesOfResidue.
+      * GetResidues, Write and Print parse the residues that are still left. Lookups may be done from several threads at once.
+      */
     class PrepFile
     {
         public:
@@ -41,12 +48,24 @@ namespace PrepFileSpace
               * An accessor function in order to access to prep file path of the current object
               * @return path_ attribute of the current object of this class
               */
+            const std::string& GetFilePath() const;
+            /*! \fn
+              * An accessor function in order to access to the residue map of the current object
+              * Residues that have not been parsed yet are parsed first
+              * @return residues_ attribute of the current object of this class
+              */
             ResidueMap& GetResidues();
             /*! \fn
               * An accessor function in order to access to all residue names of the current object
               * @return residue_names residue names of the current object of this class
               */
             std::vector<std::string> GetAllResidueNames();
+            /*! \fn
+              * An accessor function in order to access to the arena of the records of the current object
+              * Records that are added after reading, e.g. by Assembly, should be created while this arena is current (see gmml::MemoryArenaScope)
+              * @return arena_ attribute of the current object of this class
+              */
+            gmml::MemoryArena* GetArena();
 
             //**************************************
             gmml::ResidueNameMap GetAllResidueNamesMap();
@@ -84,13 +103,19 @@ namespace PrepFileSpace
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a prep file
               */
-            void Read(std::ifstream& in_file);
+            void Read(std::istream& in_file);
             /*! \fn
               * A function to residue section of the current prep file
               * Parse the given stream and set the attributes of the current object accordingly
               * @param in_file A stream contains whole contents of a prep file
               */
-            PrepFileResidue* ProcessResidueSection(std::ifstream& in_file);
+            PrepFileResidue* ProcessResidueSection(std::istream& in_file);
+            /*! \fn
+              * A function in order to access to a prep file residue by a residue name, parsing it if it has not been used before
+              * @param residue_name The name of the residue
+              * @return The residue with the given name, NULL if the file does not have it
+              */
+            PrepFileResidue* GetPrepResidueByResidueName(std::string residue_name);
             /*! \fn
               * A function in order to write back a prep file into an output file
               * @param prep_file Output prep file name
@@ -113,11 +138,25 @@ namespace PrepFileSpace
             void Print(std::ostream& out = std::cout);
 
         private:
+            /*! \fn
+              * Record the position of every residue section of the file without parsing the sections
+              * @param in_file A stream contains whole contents of a prep file
+              */
+            void IndexResidueSections(std::istream& in_file);
+            /*! \fn
+              * Parse the residues of the file that have not been parsed yet; the caller has to hold mutex_, which is released if parsing fails
+              * @param residue_name Name of the residue to parse, all remaining residues if empty
+              */
+            void LoadPendingResidues(const std::string& residue_name = "");
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
             std::string path_;              /*!< Actual path of the given prep file */
             ResidueMap residues_;           /*!< Fill by PrepFileResidues */
+            std::map<std::string, std::streampos> pending_residues_;   /*!< Position in the file of the residues that have not been parsed yet */
+            pthread_mutex_t mutex_;         /*!< Guards the parsing of pending residues */
+            gmml::MemoryArena arena_;       /*!< Storage of the residues and atoms that have been read from the file */
             /*!< End of a prep file gets marked by STOP */
     };
 }
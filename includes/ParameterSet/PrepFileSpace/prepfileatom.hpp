@@ -2,13 +2,15 @@
 #define PREPFILEATOM_HPP
 
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <iostream>
 #include "../../common.hpp"
+#include "../../memoryarena.hpp"
 
 namespace PrepFileSpace
 {
-    class PrepFileAtom
+    class PrepFileAtom : public gmml::ArenaAllocated<PrepFileAtom>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -51,6 +53,12 @@ namespace PrepFileSpace
               * @return Topological type of the current atom that is in the given string stream
               */
             gmml::TopologicalType ExtractAtomTopologicalType(std::istream& ss);
+            /*! \fn
+              * A function to convert the topological type column of an atom line (M, S, B, E or 3) to the topological type
+              * @param type The topological type column of the atom line
+              * @return Topological type of the current atom
+              */
+            gmml::TopologicalType ExtractAtomTopologicalType(std::string_view type);
 
             //////////////////////////////////////////////////////////
             //                     DISPLAY FUNCTIONS                //
@@ -129,6 +137,11 @@ namespace PrepFileSpace
               * @return charge_ of the current object of this class
               */
             double GetCharge();
+            /*! \fn
+              * An accessor function in order to access to the version of the current object
+              * @return version_ of the current object of this class, increased by each mutator
+              */
+            unsigned int GetVersion();
             /*! \fn
               * Convert a value of TopologicalType enumerator to the string version of it
               * @param topological_type A value of TopologicalType has to be converted to string
@@ -232,6 +245,7 @@ namespace PrepFileSpace
             double angle_;                              /*!< Angle; fill by the 9th column of the residue section of the file */
             double dihedral_;                           /*!< Dihedral; fill by the 10th column of the residue section of the file */
             double charge_;                             /*!< Charge; fill by the 11th column of the residue section of the file */
+            unsigned int version_;                      /*!< Increased by each mutator, so a residue can detect changes of the atom after its template has been built */
             /*!< Sample line of the residue section of a prep file: 4 H1   H1  M  3  2  1  1.000    90.0     180.0     0.0 */
     };
 }
@@ -6,6 +6,10 @@
 #include <map>
 #include <iostream>
 
+#include "../../GeometryTopology/coordinate.hpp"
+#include "../../GeometryTopology/vector3.hpp"
+#include "../../memoryarena.hpp"
+
 namespace PrepFileSpace
 {
     /*! \enum
@@ -34,7 +38,7 @@ namespace PrepFileSpace
     enum SectionType { kSectionLoop, kSectionImproper, kSectionDone, kSectionOther };
     class PrepFileAtom;
 
-    class PrepFileResidue
+    class PrepFileResidue : public gmml::ArenaAllocated<PrepFileResidue>
     {
         public:
             //////////////////////////////////////////////////////////
@@ -60,6 +64,10 @@ namespace PrepFileSpace
               * Mapping between an atom index and atom indices that are bonded to it
               */
             typedef std::map<int, std::vector<int> > BondedAtomIndexMap;
+            /*! \typedef
+              * List of coordinates
+              */
+            typedef std::vector<GeometryTopology::Coordinate*> CoordinateVector;
 
             //////////////////////////////////////////////////////////
             //                       Constructor                    //
@@ -79,7 +87,7 @@ namespace PrepFileSpace
               * @param in_file A stream contains whole contents of a prep file
               * @return A residue that is contained in the given prep file
               */
-            PrepFileResidue* LoadFromStream(std::ifstream& in_file);
+            PrepFileResidue* LoadFromStream(std::istream& in_file);
             /*! \fn
               * A function that extracts the name of the residue from the given string stream
               * @param ss A string stream that contains the name of the residue
@@ -127,13 +135,13 @@ namespace PrepFileSpace
               * @param A file stream that contains loop section of the residue
               * @return A loop object that is a mapping between source and destination atoms in the residue
               */
-            Loop ExtractLoops(std::ifstream& in_file);
+            Loop ExtractLoops(std::istream& in_file);
             /*! \fn
               * A function to parse improper dihedral section and extraxt improper dihedral information of the residue from a given file stream
               * @param A file stream that contains improper dihedral section of the residue
               * @return A vector of improper dihedrals in the residue
               */
-            DihedralVector ExtractImproperDihedral(std::ifstream& in_file);
+            DihedralVector ExtractImproperDihedral(std::istream& in_file);
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
@@ -430,6 +438,52 @@ namespace PrepFileSpace
               * @return residue_charge Overal charge of the prep file residue
               */
             double CalculatePrepResidueCharge();
+            /*! \fn
+              * A function to (re)build the template of the residue: cartesian coordinates, bonds and head/tail atoms of the residue
+              * Internal coordinates are converted once here, instances of the residue only copy and transform the template
+              * The template is built when the residue is read from a file; mutators of the residue or of its atoms make it rebuild
+              * on the next access, so a residue that is shared between threads must not be changed while they use it
+              */
+            void BuildTemplate();
+            /*! \fn
+              * A function to check whether the template of the residue can be used as it is
+              * @return False if the template has not been built or an atom of the residue has changed since it was built
+              */
+            bool IsTemplateCurrent();
+            /*! \fn
+              * An accessor function in order to access to the cartesian coordinates of the template of the residue
+              * @return Coordinates of all atoms (including dummy atoms) in the order of the atoms of the residue
+              */
+            const std::vector<GeometryTopology::Vector3>& GetTemplateCoordinates();
+            /*! \fn
+              * An accessor function in order to access to the bonds of the template of the residue
+              * @return For each atom position in the residue the positions of its bonded atoms
+              */
+            const std::vector<std::vector<int> >& GetTemplateBonds();
+            /*! \fn
+              * An accessor function in order to access to the position of the head atom of the template
+              * The head atom is the first non-dummy atom of the main chain
+              * @return Position of the head atom in the atoms of the residue, -1 if there is no main chain atom
+              */
+            int GetTemplateHeadAtomPosition();
+            /*! \fn
+              * An accessor function in order to access to the position of the tail atom of the template
+              * The tail atom is the last non-dummy atom of the main chain
+              * @return Position of the tail atom in the atoms of the residue, -1 if there is no main chain atom
+              */
+            int GetTemplateTailAtomPosition();
+            /*! \fn
+              * A function to create a new set of coordinates for an instance of the residue from its template
+              * @return Newly created coordinates in the order of the atoms of the residue
+              */
+            CoordinateVector InstantiateTemplateCoordinates();
+            /*! \fn
+              * A function to create a new set of coordinates for an instance of the residue by a rigid transformation of its template
+              * @param rotation Rotation applied to each template coordinate
+              * @param translation Translation applied after the rotation
+              * @return Newly created coordinates in the order of the atoms of the residue
+              */
+            CoordinateVector InstantiateTemplateCoordinates(const GeometryTopology::Matrix3& rotation, const GeometryTopology::Vector3& translation);
 
             //////////////////////////////////////////////////////////
             //                     DISPLAY FUNCTIONS                //
@@ -456,6 +510,12 @@ namespace PrepFileSpace
             PrepFileAtomVector atoms_;          /*!< Atoms in the resisue; fill by all lines between 6th line of each residue section of the file and a blank line in that section */
             DihedralVector improper_dihedrals_;  /*!< Improper dihedrals; fill by all lines between IMPROPER title in each residue section of the file and a blank line in that section */
             Loop loops_;                                /*!< Loops; fill by all lines between LOOP title in each residue section of the file and a blank line in that section */
+            std::vector<GeometryTopology::Vector3> template_coordinates_;     /*!< Cartesian coordinates of all atoms of the residue; see BuildTemplate */
+            std::vector<std::vector<int> > template_bonds_;                 /*!< Bonded atom positions of each atom position of the residue */
+            int template_head_atom_position_;           /*!< Position of the head atom of the residue, -1 if not available */
+            int template_tail_atom_position_;           /*!< Position of the tail atom of the residue, -1 if not available */
+            bool template_is_built_;                    /*!< False if the template has to be rebuilt before it is used */
+            unsigned long template_atom_version_;       /*!< Sum of the versions of the atoms when the template was built */
             /*!< End of each residue section gets marked by DONE */
             /*! \example
             * A Sample of residue section in a prep file:
@@ -10,6 +10,7 @@
 #include "../../InputSet//PdbFileSpace/pdbatom.hpp"
 #include "../../ParameterSet/LibraryFileSpace/libraryfile.hpp"
 #include "../../ParameterSet/PrepFileSpace/prepfile.hpp"
+#include "../../GeometryTopology/celllist.hpp"
 #include "../../common.hpp"
 
 namespace PdbPreprocessorSpace
@@ -23,6 +24,7 @@ namespace PdbPreprocessorSpace
     class PdbPreprocessorReplacedHydrogen;
     class PdbPreprocessorAlternateResidue;
     class PdbPreprocessorResidueInfo;
+    class PdbPreprocessorContext;
     class PdbPreprocessor
     {
         public:
@@ -89,6 +91,14 @@ namespace PdbPreprocessorSpace
               * A mapping between residue key and its corresponding residue info object
               */
             typedef std::map<std::string, PdbPreprocessorResidueInfo*> PdbPreprocessorResidueInfoMap;
+            /*! \typedef
+              * A pair of atoms of two residues that are close enough to be covalently linked
+              */
+            typedef std::pair<PdbFileSpace::PdbAtom*, PdbFileSpace::PdbAtom*> PdbPreprocessorAtomPair;
+            /*! \typedef
+              * List of linked atom pairs
+              */
+            typedef std::vector<PdbPreprocessorAtomPair> PdbPreprocessorAtomPairVector;
 
             //////////////////////////////////////////////////////////
             //                       CONSTRUCTOR                    //
@@ -395,6 +405,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractUnrecognizedResidues(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to extract the unrecognized residues of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractUnrecognizedResidues(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to remove the unrecognized residues of a pdb file
               * @param pdb_file The object of a pdb file
@@ -424,6 +440,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractRecognizedResidues(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to extract the recognized residues of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractRecognizedResidues(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to access to the list of CYS residues
               * @param pdb_residues The list of pdb residues
@@ -438,7 +460,7 @@ namespace PdbPreprocessorSpace
               * @param residue_atom_map A map between a residue and its atoms
               * @return distance
               */
-            double GetDistanceofCYS(PdbFileSpace::PdbResidue* first_residue, PdbFileSpace::PdbResidue* second_residue, PdbFileSpace::PdbFile* pdb_file, PdbFileSpace::PdbFile::PdbResidueAtomsMap residue_atom_map);
+            double GetDistanceofCYS(PdbFileSpace::PdbResidue* first_residue, PdbFileSpace::PdbResidue* second_residue, PdbFileSpace::PdbFile* pdb_file, PdbFileSpace::PdbFile::PdbResidueAtomsMap& residue_atom_map);
             /*! \fn
               * A function in order to extract the CYS residues of a pdb file
               * @param pdb_file_path The path to the pdb file
@@ -451,6 +473,54 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractCYSResidues(PdbFileSpace::PdbFile* pdb_file);
+            /*! \fn
+              * A function in order to extract the CYS residues of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractCYSResidues(PdbPreprocessorContext* context);
+            /*! \fn
+              * A function in order to access to the atoms with the given name of all residues with one of the given names
+              * @param context The preprocessing context of the pdb file
+              * @param residue_names Names of the residues, an empty list stands for all residues
+              * @param atom_name Name of the atom that is looked up in each residue
+              * @return List of atoms in the order of the residues of the ATOM cards
+              */
+            PdbFileSpace::PdbFile::PdbAtomVector GetAtomsOfResiduesByName(PdbPreprocessorContext* context, std::vector<std::string> residue_names, std::string atom_name);
+            /*! \fn
+              * A function in order to find the pairs of atoms of two lists that are closer than a cutoff, using a cell list
+              * instead of comparing all pairs
+              * If the same list is given twice every pair is reported once
+              * @param first_atoms First list of atoms
+              * @param second_atoms Second list of atoms
+              * @param cutoff Distance cutoff
+              * @return Index pairs (first list, second list) sorted by the first and then by the second index
+              */
+            GeometryTopology::CellList::IndexPairVector FindAtomPairsWithinCutoff(PdbFileSpace::PdbFile::PdbAtomVector& first_atoms, PdbFileSpace::PdbFile::PdbAtomVector& second_atoms, double cutoff);
+            /*! \fn
+              * A function in order to extract covalent cross links between two kinds of residues
+              * @param context The preprocessing context of the pdb file
+              * @param first_residue_names Names of the residues on the first side of the link, an empty list stands for all residues
+              * @param first_atom_name Name of the linking atom of the first residue
+              * @param second_residue_names Names of the residues on the second side of the link, an empty list stands for all residues
+              * @param second_atom_name Name of the linking atom of the second residue
+              * @param cutoff Largest distance of the linked atoms
+              * @return Pairs of linked atoms (first side, second side)
+              */
+            PdbPreprocessorAtomPairVector ExtractCrossLinks(PdbPreprocessorContext* context, std::vector<std::string> first_residue_names, std::string first_atom_name,
+                                                            std::vector<std::string> second_residue_names, std::string second_atom_name, double cutoff = gmml::dCutOff);
+            /*! \fn
+              * A function in order to extract the N-glycosylation links (ND2 of ASN to C1 of a glycan residue) of a pdb file
+              * @param context The preprocessing context of the pdb file
+              * @return Pairs of linked atoms (ND2, C1)
+              */
+            PdbPreprocessorAtomPairVector ExtractNGlycosylationLinks(PdbPreprocessorContext* context);
+            /*! \fn
+              * A function in order to extract the O-glycosylation links (OG of SER, OG1 of THR to C1 of a glycan residue) of a pdb file
+              * @param context The preprocessing context of the pdb file
+              * @return Pairs of linked atoms (OG/OG1, C1)
+              */
+            PdbPreprocessorAtomPairVector ExtractOGlycosylationLinks(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to remove the unknown heavy atoms of a pdb file
               * @param pdb_file The object of a pdb file
@@ -482,6 +552,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractHISResidues(PdbFileSpace::PdbFile* pdb_file);
+            /*! \fn
+              * A function in order to extract the HIS residues of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractHISResidues(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to update histidine mapping of a pdb file
               * @param pdb_file The object of a pdb file
@@ -563,6 +639,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractUnknownHeavyAtoms(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to extract the unknown heavy atoms of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractUnknownHeavyAtoms(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to remove the unknown heavy atoms of a pdb file
               * @param pdb_file The object of a pdb file
@@ -621,6 +703,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractRemovedHydrogens(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to extract the removed hydrogens of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractRemovedHydrogens(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to remove the removed hydrogens of a pdb file
               * @param pdb_file The object of a pdb file
@@ -654,6 +742,25 @@ namespace PdbPreprocessorSpace
 
             //**************************************************
             bool ExtractAminoAcidChains(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files);
+            /*! \fn
+              * A function in order to extract the amino acid chains of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractAminoAcidChains(PdbPreprocessorContext* context);
+            /*! \fn
+              * A function in order to check that no chain has non amino acid residues between its amino acid residues
+              * @param context The preprocessing context of the pdb file
+              * @return bool value, false if a chain cannot be processed
+              */
+            bool CheckAminoAcidChainSegments(PdbPreprocessorContext* context);
+            /*! \fn
+              * A function in order to extract the terminations of the amino acid residues of a single chain
+              * @param context The preprocessing context of the pdb file
+              * @param chain_id Chain id of the chain
+              * @return chain termination, NULL if the chain has no amino acid residue
+              */
+            PdbPreprocessorChainTermination* ExtractAminoAcidChain(PdbPreprocessorContext* context, char chain_id);
 
             //**************************************************
             /*! \fn
@@ -694,6 +801,19 @@ namespace PdbPreprocessorSpace
 
             //***************************************************
              bool ExtractGapsInAminoAcidChains(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files);
+            /*! \fn
+              * A function in order to extract the gaps in the amino acid chains of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractGapsInAminoAcidChains(PdbPreprocessorContext* context);
+            /*! \fn
+              * A function in order to extract the gaps in the amino acid residues of a single chain
+              * @param context The preprocessing context of the pdb file
+              * @param chain_id Chain id of the chain
+              * @return List of gaps of the chain in the order of the residues
+              */
+            PdbPreprocessorMissingResidueVector ExtractGapsInAminoAcidChain(PdbPreprocessorContext* context, std::string chain_id);
 
             //************************************************
             /*! \fn
@@ -731,6 +851,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractAlternateResidue(PdbFileSpace::PdbFile* pdb_file);
+            /*! \fn
+              * A function in order to extract the alternate residues of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractAlternateResidue(PdbPreprocessorContext* context);
             /*! \fn
               * A function in order to remove unselected alternate residues of a pdb file
               * @param pdb_file The object of a pdb file
@@ -751,6 +877,17 @@ namespace PdbPreprocessorSpace
               * @param prep_files_path Paths of prep files as database in order for preprocessing of the given pdb file
               */
             void Preprocess(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files_path, std::vector<std::string> glycam_lib_files_path, std::vector<std::string> other_lib_files_path, std::vector<std::string> prep_files_path);
+            /*! \fn
+              * A function to do all preprocessing on a number of threads
+              * The extraction stages and the per chain termination/gap analysis are independent tasks that share one preprocessing context;
+              * the results of the chains are merged in the order of the chain ids, so the result is the same as the sequential version
+              * @param pdb_file Pdb file object that has to be preprocessed
+              * @param lib_files_path Paths of library files as database in order for preprocessing of the given pdb file
+              * @param prep_files_path Paths of prep files as database in order for preprocessing of the given pdb file
+              * @param number_of_threads Number of threads, 1 or less runs the sequential version
+              */
+            void Preprocess(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files_path, std::vector<std::string> glycam_lib_files_path,
+                            std::vector<std::string> other_lib_files_path, std::vector<std::string> prep_files_path, int number_of_threads);
             /*! \fn
               * A function to apply all the updates on a pdb file
               * @param pdb_file A pdb file object that has to modified to reflect the updates
@@ -788,6 +925,12 @@ namespace PdbPreprocessorSpace
               * @return bool value
               */
             bool ExtractResidueInfo(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to extract the residues info of a pdb file using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return bool value
+              */
+            bool ExtractResidueInfo(PdbPreprocessorContext* context);
             /*! \fn
               * A function to calculate the overall charge of the model
               * @param pdb_file_path The path to the pdb file
@@ -802,6 +945,12 @@ namespace PdbPreprocessorSpace
               * @return model_charge Overal charge of the model
               */
             double CalculateModelCharge(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files, std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * A function in order to calculate the overall charge of the model using the indices of a preprocessing context
+              * @param context The preprocessing context of the pdb file
+              * @return model_charge Overal charge of the model
+              */
+            double CalculateModelCharge(PdbPreprocessorContext* context);
 
             //////////////////////////////////////////////////////////
             //                       DISPLAY FUNCTION               //
@@ -831,6 +980,53 @@ namespace PdbPreprocessorSpace
             PdbPreprocessorResidueInfoMap residue_info_map_;                        /*!< Map of residues in a pdb file >*/
 
     };
+
+    /*! \enum
+      * Preprocessing tasks that only read the preprocessing context and write their own result list; the per chain tasks follow them
+      */
+    enum PreprocessingStage
+    {
+        HIS_STAGE = 0,
+        CYS_STAGE = 1,
+        ALTERNATE_RESIDUE_STAGE = 2,
+        UNRECOGNIZED_RESIDUE_STAGE = 3,
+        UNKNOWN_HEAVY_ATOM_STAGE = 4,
+        REMOVED_HYDROGEN_STAGE = 5,
+        RESIDUE_INFO_STAGE = 6,
+        NUMBER_OF_STAGES = 7
+    };
+
+    struct PreprocessingThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            PdbPreprocessor* preprocessor;
+            PdbPreprocessorContext* context;
+            std::vector<std::string>* chain_ids;
+            PdbPreprocessor::PdbPreprocessorChainTerminationVector* chain_terminations;
+            std::vector<PdbPreprocessor::PdbPreprocessorMissingResidueVector>* missing_residues;
+            PreprocessingThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                preprocessor = NULL;
+                context = NULL;
+                chain_ids = NULL;
+                chain_terminations = NULL;
+                missing_residues = NULL;
+            }
+
+            PreprocessingThreadArgument(int ti, int tn, PdbPreprocessor* p, PdbPreprocessorContext* c, std::vector<std::string>* ids,
+                                        PdbPreprocessor::PdbPreprocessorChainTerminationVector* terminations, std::vector<PdbPreprocessor::PdbPreprocessorMissingResidueVector>* gaps)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                preprocessor = p;
+                context = c;
+                chain_ids = ids;
+                chain_terminations = terminations;
+                missing_residues = gaps;
+            }
+    };
 }
 
 #endif // PDBPREPROCESSOR_HPP
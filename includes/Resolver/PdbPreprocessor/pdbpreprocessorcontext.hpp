@@ -0,0 +1,201 @@
+#ifndef PDBPREPROCESSORCONTEXT_HPP
+#define PDBPREPROCESSORCONTEXT_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "../../InputSet/PdbFileSpace/pdbfile.hpp"
+#include "../../ParameterSet/LibraryFileSpace/libraryfile.hpp"
+#include "../../ParameterSet/PrepFileSpace/prepfile.hpp"
+#include "../../common.hpp"
+
+namespace PdbFileSpace
+{
+    class PdbResidue;
+    class PdbAtom;
+}
+
+namespace PdbPreprocessorSpace
+{
+    /*! \class
+      * Shared indices of a pdb file and of the dataset (lib/prep) files for the preprocessing stages
+      * The residue lists, the per residue atom index, the chain partitioning and the dataset residue/atom name tables are built
+      * once when the context is created, so the stages of PdbPreprocessor::Preprocess do not walk the pdb file or read the
+      * dataset files again
+      * The context owns everything it builds (residues, atom lists, dataset files); pointers taken from it are only valid while it exists,
+      * and it has to be rebuilt if the pdb file changes
+      */
+    class PdbPreprocessorContext
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            /*! \typedef
+              * A mapping between a chain id (or a chain segment key) and the residues in it
+              */
+            typedef std::map<std::string, PdbFileSpace::PdbFile::PdbResidueVector > ChainIdResidueMap;
+            /*! \typedef
+              * A mapping between a chain id and the amino acid/non amino acid segments of that chain (keys A_<chain>_<n> and NA_<chain>_<n>)
+              */
+            typedef std::map<std::string, ChainIdResidueMap> ChainIdSegmentsMap;
+            /*! \typedef
+              * A mapping between residue chain id and the sequence numbers of its amino acid residues
+              */
+            typedef std::map<char, std::vector<int> > ChainIdSequenceNumbersMap;
+            /*! \typedef
+              * A mapping between residue chain id and the insertion codes of its amino acid residues
+              */
+            typedef std::map<char, std::vector<char> > ChainIdInsertionCodeMap;
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Constructor that only builds the indices of the pdb file (for the stages that do not need the dataset files)
+              * @param pdb_file The pdb file that is going to be preprocessed
+              */
+            PdbPreprocessorContext(PdbFileSpace::PdbFile* pdb_file);
+            /*! \fn
+              * Constructor that builds the indices of the pdb file and reads each dataset file once
+              * @param pdb_file The pdb file that is going to be preprocessed
+              * @param amino_lib_files List of amino acid library files
+              * @param glycam_lib_files List of glycam library files
+              * @param other_lib_files List of other library files
+              * @param prep_files List of prep files
+              */
+            PdbPreprocessorContext(PdbFileSpace::PdbFile* pdb_file, std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files,
+                                   std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * Destructor, releases everything that has been built by the context
+              */
+            ~PdbPreprocessorContext();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            PdbFileSpace::PdbFile* GetPdbFile();
+            /*! \fn
+              * All residues of the first model (see PdbFile::GetAllResidues)
+              */
+            const PdbFileSpace::PdbFile::PdbResidueVector& GetResidues();
+            /*! \fn
+              * Residues of the ATOM cards of the first model (see PdbFile::GetAllResiduesFromAtomCard)
+              */
+            const PdbFileSpace::PdbFile::PdbResidueVector& GetResiduesFromAtomCard();
+            /*! \fn
+              * Residue names of the pdb file with their start/end flags (see PdbFile::GetAllResidueNames)
+              */
+            const PdbFileSpace::PdbFile::PdbPairVectorAtomNamePositionFlag& GetResidueNames();
+            /*! \fn
+              * Residues of the ATOM cards grouped by chain id
+              */
+            const ChainIdResidueMap& GetChainResidues();
+            /*! \fn
+              * Amino acid and non amino acid segments of each chain, see BuildAminoAcidChains
+              */
+            const ChainIdSegmentsMap& GetChainSegments();
+            /*! \fn
+              * Amino acid residues of each chain in the order of the pdb file
+              */
+            const ChainIdResidueMap& GetChainAminoAcidResidues();
+            const ChainIdSequenceNumbersMap& GetChainSequenceNumbers();
+            const ChainIdInsertionCodeMap& GetChainInsertionCodes();
+            /*! \fn
+              * All lib files (amino, glycam and other) in the order of the constructor arguments
+              */
+            const std::vector<std::string>& GetLibFiles();
+            const std::vector<std::string>& GetPrepFiles();
+            /*! \fn
+              * Residues of the lib files that the pdb file refers to by name, directly or as N/C terminal variant; a residue of a later file replaces a residue with the same name of an earlier file
+              */
+            const LibraryFileSpace::LibraryFile::ResidueMap& GetLibraryResidues();
+            /*! \fn
+              * Residues of the prep files that the pdb file refers to by name, directly or as N/C terminal variant; a residue of a later file replaces a residue with the same name of an earlier file
+              */
+            const PrepFileSpace::PrepFile::ResidueMap& GetPrepResidues();
+            /*! \fn
+              * Residue names of the amino acid lib files
+              */
+            const gmml::ResidueNameMap& GetAminoAcidResidueNames();
+            /*! \fn
+              * Residue names of all lib and prep files
+              */
+            const gmml::ResidueNameMap& GetDatasetResidueNames();
+            /*! \fn
+              * Atom names of the residues of GetLibraryResidues and GetPrepResidues; prep residues replace lib residues with the same name
+              */
+            const gmml::ResidueNameAtomNamesMap& GetDatasetResidueAtomNames();
+            /*! \fn
+              * Residues of GetResidues whose names are (not) defined in the dataset files
+              */
+            const PdbFileSpace::PdbFile::PdbResidueVector& GetRecognizedResidues();
+            const PdbFileSpace::PdbFile::PdbResidueVector& GetUnrecognizedResidues();
+            /*! \fn
+              * Check if the residue name (with the given start/end flag) appears in the pdb file
+              */
+            bool HasResidueNameWithFlag(const std::string& residue_name, const std::string& flag);
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Build the key of a residue that is used by the atom index (name_chain_sequence_insertion_alternate)
+              */
+            static std::string GetResidueKey(PdbFileSpace::PdbResidue* residue);
+            /*! \fn
+              * Atoms of a residue from the atom index
+              * @return Atoms of the residue, an empty list if the residue is not in the index
+              */
+            const PdbFileSpace::PdbFile::PdbAtomVector& GetAtomsOfResidue(PdbFileSpace::PdbResidue* residue);
+            /*! \fn
+              * Find an atom of a residue by name using the atom index
+              * @return The atom, NULL if the residue does not have an atom with the given name
+              */
+            PdbFileSpace::PdbAtom* GetAtomOfResidueByName(PdbFileSpace::PdbResidue* residue, const std::string& atom_name);
+
+        private:
+            PdbPreprocessorContext(const PdbPreprocessorContext&);
+            PdbPreprocessorContext& operator=(const PdbPreprocessorContext&);
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            void BuildPdbIndices();
+            void LoadDataset(std::vector<std::string> amino_lib_files, std::vector<std::string> glycam_lib_files,
+                             std::vector<std::string> other_lib_files, std::vector<std::string> prep_files);
+            /*! \fn
+              * Split each chain into consecutive segments of amino acid and non amino acid residues, as used by the chain and gap stages
+              */
+            void BuildAminoAcidChains();
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            PdbFileSpace::PdbFile* pdb_file_;                                       /*!< The pdb file that is preprocessed >*/
+            PdbFileSpace::PdbFile::PdbResidueVector residues_;                      /*!< All residues of the first model >*/
+            PdbFileSpace::PdbFile::PdbResidueVector residues_from_atom_card_;       /*!< Residues of the ATOM cards >*/
+            PdbFileSpace::PdbFile::PdbPairVectorAtomNamePositionFlag residue_names_;    /*!< Residue names with start/end flags >*/
+            std::map<std::pair<std::string, std::string>, bool> residue_name_flags_;    /*!< Lookup table of residue_names_ >*/
+            PdbFileSpace::PdbFile::PdbResidueAtomsMap residue_atoms_;               /*!< Atoms of each residue by residue key >*/
+            ChainIdResidueMap chain_residues_;                                      /*!< ATOM card residues by chain id >*/
+            ChainIdSegmentsMap chain_segments_;                                     /*!< Amino acid/non amino acid segments of each chain >*/
+            ChainIdResidueMap chain_amino_acid_residues_;                           /*!< Amino acid residues of each chain >*/
+            ChainIdSequenceNumbersMap chain_sequence_numbers_;                      /*!< Sequence numbers of the amino acid residues of each chain >*/
+            ChainIdInsertionCodeMap chain_insertion_codes_;                         /*!< Insertion codes of the amino acid residues of each chain >*/
+            std::vector<std::string> lib_files_;                                    /*!< Paths of all lib files >*/
+            std::vector<std::string> prep_files_;                                   /*!< Paths of all prep files >*/
+            std::vector<LibraryFileSpace::LibraryFile*> loaded_lib_files_;          /*!< Lib files that have been read by the context >*/
+            std::vector<PrepFileSpace::PrepFile*> loaded_prep_files_;               /*!< Prep files that have been read by the context >*/
+            LibraryFileSpace::LibraryFile::ResidueMap lib_residues_;                /*!< Residues of the lib files that the pdb file refers to >*/
+            PrepFileSpace::PrepFile::ResidueMap prep_residues_;                     /*!< Residues of the prep files that the pdb file refers to >*/
+            gmml::ResidueNameMap amino_acid_residue_names_;                         /*!< Residue names of the amino acid lib files >*/
+            gmml::ResidueNameMap dataset_residue_names_;                            /*!< Residue names of all dataset files >*/
+            gmml::ResidueNameAtomNamesMap dataset_residue_atom_names_;              /*!< Atom names of lib_residues_ and prep_residues_ >*/
+            PdbFileSpace::PdbFile::PdbResidueVector recognized_residues_;           /*!< Residues with a dataset entry >*/
+            PdbFileSpace::PdbFile::PdbResidueVector unrecognized_residues_;         /*!< Residues without a dataset entry >*/
+            PdbFileSpace::PdbFile::PdbAtomVector empty_atoms_;                      /*!< Returned for residues that are not in the atom index >*/
+    };
+}
+
+#endif // PDBPREPROCESSORCONTEXT_HPP
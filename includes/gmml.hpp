@@ -3,6 +3,14 @@
 
 #include "common.hpp"
 #include "utils.hpp"
+#include "textparsing.hpp"
+#include "logger.hpp"
+#include "instrumentation.hpp"
+#include "memoryarena.hpp"
+#include "inputfilestream.hpp"
+#include "InputSet/CifFileSpace/cifatomsite.hpp"
+#include "InputSet/CifFileSpace/ciffile.hpp"
+#include "InputSet/CifFileSpace/ciffileprocessingexception.hpp"
 #include "InputSet/CoordinateFileSpace/coordinatefile.hpp"
 #include "InputSet/CoordinateFileSpace/coordinatefileprocessingexception.hpp"
 #include "InputSet/PdbFileSpace/pdbatom.hpp"
@@ -84,6 +92,10 @@
 #include "GeometryTopology/plane.hpp"
 #include "GeometryTopology/cell.hpp"
 #include "GeometryTopology/grid.hpp"
+#include "GeometryTopology/unitcell.hpp"
+#include "GeometryTopology/celllist.hpp"
+#include "GeometryTopology/vector3.hpp"
+#include "GeometryTopology/geometrykernels.hpp"
 #include "GeometryTopology/InternalCoordinate/angle.hpp"
 #include "GeometryTopology/InternalCoordinate/dihedral.hpp"
 #include "GeometryTopology/InternalCoordinate/distance.hpp"
@@ -94,15 +106,20 @@
 #include "MolecularModeling/assembly.hpp"
 #include "MolecularModeling/atom.hpp"
 #include "MolecularModeling/atomnode.hpp"
+#include "MolecularModeling/bondgraph.hpp"
+#include "MolecularModeling/rotatabledihedral.hpp"
 #include "MolecularModeling/dockingatom.hpp"
 #include "MolecularModeling/element.hpp"
 #include "MolecularModeling/moleculardynamicatom.hpp"
 #include "MolecularModeling/quantommechanicatom.hpp"
 #include "MolecularModeling/residue.hpp"
+#include "ParameterSet/ForceFieldBundleSpace/forcefieldbundle.hpp"
+#include "ParameterSet/ForceFieldBundleSpace/forcefieldbundleprocessingexception.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfile.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfileatom.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfileprocessingexception.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfileresidue.hpp"
+#include "ParameterSet/ParameterFileSpace/layeredparameterfile.hpp"
 #include "ParameterSet/ParameterFileSpace/parameterfile.hpp"
 #include "ParameterSet/ParameterFileSpace/parameterfileangle.hpp"
 #include "ParameterSet/ParameterFileSpace/parameterfileatom.hpp"
@@ -117,6 +134,7 @@
 #include "Resolver/PdbPreprocessor/pdbpreprocessor.hpp"
 #include "Resolver/PdbPreprocessor/pdbpreprocessoralternateresidue.hpp"
 #include "Resolver/PdbPreprocessor/pdbpreprocessorchaintermination.hpp"
+#include "Resolver/PdbPreprocessor/pdbpreprocessorcontext.hpp"
 #include "Resolver/PdbPreprocessor/pdbpreprocessordisulfidebond.hpp"
 #include "Resolver/PdbPreprocessor/pdbpreprocessorhistidinemapping.hpp"
 #include "Resolver/PdbPreprocessor/pdbpreprocessormissingresidue.hpp"
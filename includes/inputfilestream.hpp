@@ -0,0 +1,152 @@
+#ifndef INPUTFILESTREAM_HPP
+#define INPUTFILESTREAM_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <streambuf>
+
+namespace gmml
+{
+    /*! \class
+      * Stream buffer over the decompressed contents of a gzip file
+      * Plain gzip files, including files of several concatenated gzip members, are inflated sequentially. Block compressed
+      * (bgzip) files consist of independent gzip members of at most 64 KB of data each that state their compressed and
+      * uncompressed sizes in their headers, so a batch of blocks is read at once and its blocks are inflated by several threads.
+      * Positions are offsets into the decompressed data: seeking forward inflates up to the position, seeking backward starts
+      * over from the beginning of the file.
+      */
+    class DecompressingBuffer : public std::streambuf
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            DecompressingBuffer();
+            ~DecompressingBuffer();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            bool IsOpen() const;
+            /*! \fn
+              * @return True if the open file is in the block compressed (bgzip) format
+              */
+            bool IsBlockCompressed() const;
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Open a gzip file
+              * @param path Path of the file
+              * @param number_of_threads Number of threads that inflate the blocks of a bgzip file
+              * @return False if the file cannot be opened or is not a gzip file
+              */
+            bool Open(const std::string& path, int number_of_threads);
+            void Close();
+
+        protected:
+            //////////////////////////////////////////////////////////
+            //                 STREAMBUF INTERFACE                  //
+            //////////////////////////////////////////////////////////
+            int_type underflow();
+            pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode = std::ios_base::in);
+            pos_type seekpos(pos_type position, std::ios_base::openmode mode = std::ios_base::in);
+
+        private:
+            DecompressingBuffer(const DecompressingBuffer&);
+            DecompressingBuffer& operator=(const DecompressingBuffer&);
+            /*! \fn
+              * Replace the data of the buffer with the next part of the decompressed contents, keeping the last few characters
+              * in front of it so they can be put back
+              * @return False at the end of the file or on an error, which is logged
+              */
+            bool Refill();
+            /*! \fn
+              * Inflate the next part of a plain gzip file into decompressed_
+              */
+            bool InflateStream();
+            /*! \fn
+              * Read the next batch of blocks of a bgzip file and inflate them into decompressed_
+              */
+            bool InflateBlocks();
+            /*! \fn
+              * Go back to the beginning of the file
+              */
+            bool Rewind();
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::FILE* file_;                       /*!< The compressed file >*/
+            bool block_compressed_;                 /*!< True for a bgzip file >*/
+            int number_of_threads_;                 /*!< Threads that inflate the blocks of a bgzip file >*/
+            void* stream_;                          /*!< z_stream of a plain gzip file >*/
+            bool end_of_file_;                      /*!< True once all data of the file has been decompressed >*/
+            bool member_ended_;                     /*!< True if the last gzip member of a plain gzip file has been inflated completely >*/
+            std::vector<char> compressed_;          /*!< Compressed data read from the file but not inflated yet >*/
+            std::vector<char> decompressed_;        /*!< Put back area followed by the current part of the decompressed data >*/
+            std::streamoff buffer_offset_;          /*!< Offset in the decompressed data of the first character of decompressed_ >*/
+    };
+
+    /*! \class
+      * Input file stream that reads gzip and bgzip compressed files transparently
+      * Whether a file is compressed is decided by its first bytes, not by its name. An uncompressed file is read through a
+      * std::filebuf exactly like with std::ifstream; the interface follows std::ifstream, so the readers only have to change the
+      * type of their stream and take a std::istream in their parse functions.
+      */
+    class InputFileStream : public std::istream
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            InputFileStream();
+            /*! \fn
+              * Constructor that opens a file, see open
+              */
+            InputFileStream(const std::string& path, int number_of_threads = 0);
+            ~InputFileStream();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            bool is_open() const;
+            /*! \fn
+              * @return True if the open file is gzip or bgzip compressed
+              */
+            bool IsCompressed() const;
+            bool IsBlockCompressed() const;
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Open a file for reading; sets the failbit of the stream if it cannot be opened
+              * @param path Path of the file, compressed or not
+              * @param number_of_threads Number of threads that inflate the blocks of a bgzip file, the number of processors if 0
+              */
+            void open(const std::string& path, int number_of_threads = 0);
+            void close();
+            /*! \fn
+              * Check the first bytes of a file for the gzip magic number
+              */
+            static bool IsCompressedFile(const std::string& path);
+
+        private:
+            InputFileStream(const InputFileStream&);
+            InputFileStream& operator=(const InputFileStream&);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::filebuf file_buffer_;                      /*!< Buffer of an uncompressed file >*/
+            DecompressingBuffer decompressing_buffer_;      /*!< Buffer of a compressed file >*/
+            bool compressed_;                               /*!< True if the open file is read through decompressing_buffer_ >*/
+    };
+}
+
+#endif // INPUTFILESTREAM_HPP
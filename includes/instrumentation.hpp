@@ -0,0 +1,143 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <string>
+#include <map>
+#include <iostream>
+#include <atomic>
+#include <pthread.h>
+
+#define GMML_INSTRUMENTATION_CONCATENATE_(a, b) a##b
+#define GMML_INSTRUMENTATION_CONCATENATE(a, b) GMML_INSTRUMENTATION_CONCATENATE_(a, b)
+/*! \def
+  * Time the rest of the enclosing scope under the given name, e.g. GMML_SCOPED_TIMER("Assembly::ExtractSugars")
+  */
+#define GMML_SCOPED_TIMER(name) gmml::ScopedTimer GMML_INSTRUMENTATION_CONCATENATE(gmml_scoped_timer_, __LINE__)(name)
+/*! \def
+  * Add a value to the counter with the given name, e.g. GMML_COUNT("bonds found", pairs.size())
+  */
+#define GMML_COUNT(name, value) \
+    do \
+    { \
+        if(gmml::Instrumentation::IsEnabled()) \
+            gmml::Instrumentation::GetInstance()->AddCount(name, (long)(value)); \
+    } while(0)
+
+namespace gmml
+{
+    /*! \class
+      * Opt-in timers, counters and peak memory of the major operations of a run
+      * Instrumentation is off unless Enable is called or the GMML_INSTRUMENTATION environment variable is set; when it is off,
+      * the timers and counters only check a flag. If GMML_INSTRUMENTATION_REPORT names a file, instrumentation is turned on
+      * and the report is written to that file at exit.
+      * The report is a JSON document with the timers (calls, total/min/max seconds, peak resident memory when the timer ended),
+      * the counters and the peak resident memory of the process.
+      */
+    class Instrumentation
+    {
+        public:
+            /*! \struct
+              * Accumulated statistics of a timer
+              */
+            struct TimerStatistics
+            {
+                    TimerStatistics() : calls(0), total_seconds(0.0), min_seconds(0.0), max_seconds(0.0), peak_memory_kb(0) {}
+                    long calls;                     /*!< Number of times the timed scope has been left >*/
+                    double total_seconds;           /*!< Total wall clock time spent in the timed scope >*/
+                    double min_seconds;             /*!< Shortest call >*/
+                    double max_seconds;             /*!< Longest call >*/
+                    long peak_memory_kb;            /*!< Largest peak resident memory seen at the end of a call >*/
+            };
+            typedef std::map<std::string, TimerStatistics> TimerMap;
+            typedef std::map<std::string, long> CounterMap;
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            static Instrumentation* GetInstance();
+            static bool IsEnabled()
+            {
+                return enabled_.load(std::memory_order_relaxed);
+            }
+            TimerMap GetTimers();
+            CounterMap GetCounters();
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            static void Enable(bool enabled = true);
+            /*! \fn
+              * Drop all the timers and counters collected so far
+              */
+            void Reset();
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            void AddTime(const std::string& name, double seconds);
+            void AddCount(const std::string& name, long value);
+            /*! \fn
+              * Peak resident memory of the process in kilobytes
+              */
+            static long GetPeakMemory();
+            /*! \fn
+              * Monotonic wall clock time in seconds
+              */
+            static double GetTime();
+
+            //////////////////////////////////////////////////////////
+            //                       DISPLAY FUNCTIONS              //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Write the machine-readable (JSON) report of the run
+              */
+            void WriteReport(std::ostream& out);
+            void WriteReport(const std::string& file_path);
+
+        private:
+            Instrumentation();
+            Instrumentation(const Instrumentation&);
+            Instrumentation& operator=(const Instrumentation&);
+            static void CreateInstance();
+            static void WriteReportAtExit();
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            static std::atomic<bool> enabled_;      /*!< Instrumentation is collected >*/
+            TimerMap timers_;                       /*!< Statistics of each timer by name >*/
+            CounterMap counters_;                   /*!< Value of each counter by name >*/
+            double start_time_;                     /*!< Time the instrumentation has been created or reset >*/
+            pthread_mutex_t mutex_;                 /*!< Guards timers_ and counters_ >*/
+    };
+
+    /*! \class
+      * Adds the time between its construction and its destruction to a timer of the Instrumentation
+      */
+    class ScopedTimer
+    {
+        public:
+            /*! \fn
+              * @param name Name of the timer, has to outlive the scoped timer (normally a string literal)
+              */
+            ScopedTimer(const char* name) : name_(name), start_(0.0), active_(Instrumentation::IsEnabled())
+            {
+                if(active_)
+                    start_ = Instrumentation::GetTime();
+            }
+            ~ScopedTimer()
+            {
+                if(active_)
+                    Instrumentation::GetInstance()->AddTime(name_, Instrumentation::GetTime() - start_);
+            }
+
+        private:
+            ScopedTimer(const ScopedTimer&);
+            ScopedTimer& operator=(const ScopedTimer&);
+            const char* name_;                      /*!< Name of the timer >*/
+            double start_;                          /*!< Time the scope has been entered >*/
+            bool active_;                           /*!< Instrumentation was on when the scope has been entered >*/
+    };
+}
+
+#endif // INSTRUMENTATION_HPP
@@ -0,0 +1,203 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <ctime>
+#include <string>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <pthread.h>
+
+#include "common.hpp"
+
+/*! \def
+  * Log a message that is built with stream operators, e.g. GMML_LOG(gmml::INF, "Residue " << name << " has " << n << " atoms")
+  * The message is only formatted if the level is enabled, so this is the form to use inside loops
+  */
+#define GMML_LOG(level, message) \
+    do \
+    { \
+        if(gmml::Logger::IsEnabled(level)) \
+        { \
+            std::stringstream gmml_log_stream; \
+            gmml_log_stream << message; \
+            gmml::Logger::GetInstance()->Log(__LINE__, __FILE__, level, gmml_log_stream.str()); \
+        } \
+    } while(0)
+
+namespace gmml
+{
+    /*! \struct
+      * A single log message as it is passed from the producing thread to the writer thread
+      */
+    struct LogRecord
+    {
+            time_t time;                    /*!< Time the message has been produced >*/
+            int line;                       /*!< Line number producing the message >*/
+            LogLevel level;                 /*!< Type of the message >*/
+            std::string file_path;          /*!< Source file producing the message >*/
+            std::string message;            /*!< Content of the message >*/
+            std::string out_file_name;      /*!< Log file the message is meant for >*/
+    };
+
+    /*! \class
+      * Destination of the log records; Write is only called from the writer thread, one record at a time
+      */
+    class LogSink
+    {
+        public:
+            virtual ~LogSink() {}
+            virtual void Write(const LogRecord& record) = 0;
+            /*! \fn
+              * Called after each batch of records
+              */
+            virtual void Flush() {}
+    };
+
+    /*! \class
+      * Sink that appends the records to their log files (log.log unless another file has been given); the files are kept open
+      */
+    class FileLogSink : public LogSink
+    {
+        public:
+            FileLogSink();
+            ~FileLogSink();
+            void Write(const LogRecord& record);
+            void Flush();
+
+        private:
+            std::map<std::string, std::ofstream*> files_;      /*!< Open log files by name >*/
+    };
+
+    /*! \class
+      * Sink that writes the records to an output stream, e.g. std::cerr
+      */
+    class StreamLogSink : public LogSink
+    {
+        public:
+            StreamLogSink(std::ostream& out);
+            void Write(const LogRecord& record);
+            void Flush();
+
+        private:
+            std::ostream& out_;             /*!< Output stream >*/
+    };
+
+    /*! \class
+      * Buffered logging used by gmml::log
+      * Producers put their records in a bounded lock free ring buffer and a background thread formats them and hands them
+      * to the sink, so logging does not open/close a file per message. Disabled levels return before anything is copied.
+      * The library reports its progress here (INF) instead of on the console.
+      * By default only warnings and errors are logged to log.log; the GMML_LOG_LEVEL environment variable (none, error, warning, info)
+      * or SetLevel change that.
+      */
+    class Logger
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * The process wide logger, created on first use
+              */
+            static Logger* GetInstance();
+            /*! \fn
+              * Check if the messages of the given level are logged
+              */
+            static bool IsEnabled(LogLevel level)
+            {
+                return (enabled_levels_.load(std::memory_order_relaxed) & LevelMask(level)) != 0;
+            }
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Log the given level and every level that is more severe (INF < WAR < ERR)
+              */
+            static void SetLevel(LogLevel level);
+            /*! \fn
+              * Turn the logging of a single level on or off
+              */
+            static void EnableLevel(LogLevel level, bool enabled);
+            /*! \fn
+              * Turn off all logging
+              */
+            static void Disable();
+            /*! \fn
+              * Replace the sink; the pending records are written to the old sink first. The logger takes the ownership of the sink.
+              */
+            void SetSink(LogSink* sink);
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Queue a message for the writer thread
+              * @param line The line number producing the message
+              * @param file_path The file path of the file which the message has been produced within in
+              * @param level The type of the produced message INF/WAR/ERR
+              * @param msg The message content that has been produced
+              * @param out_file_name The name of the output log file
+              */
+            void Log(int line, const std::string& file_path, LogLevel level, const std::string& msg, const std::string& out_file_name = "log.log");
+            /*! \fn
+              * Wait until all the queued messages have been written
+              */
+            void Flush();
+            /*! \fn
+              * Write the pending messages and stop the writer thread; later messages start it again
+              */
+            void Shutdown();
+            /*! \fn
+              * Format a record the way log.log has always been written
+              */
+            static std::string Format(const LogRecord& record);
+
+        private:
+            struct Slot
+            {
+                    std::atomic<size_t> sequence;
+                    LogRecord record;
+            };
+
+            Logger(size_t capacity);
+            Logger(const Logger&);
+            Logger& operator=(const Logger&);
+
+            static int LevelMask(LogLevel level)
+            {
+                return 1 << (int)level;
+            }
+            static void CreateInstance();
+            static void* WriterThread(void* args);
+            static void ShutdownAtExit();
+            bool TryPush(LogRecord& record);
+            bool TryPop(LogRecord& record);
+            void StartWriter();
+            void WritePending();
+            void WakeWriter();
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            static std::atomic<int> enabled_levels_;        /*!< Bit mask of the logged levels >*/
+            Slot* slots_;                                   /*!< Ring buffer of the queued records >*/
+            size_t mask_;                                   /*!< Capacity of the ring buffer - 1, the capacity is a power of two >*/
+            std::atomic<size_t> enqueue_position_;          /*!< Number of records that have been queued >*/
+            std::atomic<size_t> dequeue_position_;          /*!< Number of records that have been taken by the writer >*/
+            std::atomic<size_t> written_;                   /*!< Number of records that have been handed to the sink >*/
+            std::atomic<bool> running_;                     /*!< The writer thread has to keep waiting for records >*/
+            std::atomic<bool> writer_waiting_;              /*!< The writer thread is waiting on writer_condition_ (or about to) >*/
+            std::atomic<bool> synchronous_;                 /*!< Records are written by the logging thread (set at exit) >*/
+            bool writer_started_;                           /*!< The writer thread exists >*/
+            pthread_t writer_;                              /*!< The writer thread >*/
+            pthread_mutex_t writer_mutex_;                  /*!< Guards starting/stopping the writer thread and the sink >*/
+            pthread_cond_t writer_condition_;               /*!< Signalled when a record is queued to a waiting writer or the writer is stopped >*/
+            LogSink* sink_;                                 /*!< Destination of the records >*/
+    };
+}
+
+#endif // LOGGER_HPP
@@ -0,0 +1,158 @@
+#ifndef MEMORYARENA_HPP
+#define MEMORYARENA_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace gmml
+{
+    /*! \class
+      * Block allocator for the object graph of a file or an assembly
+      * Objects of classes that derive from ArenaAllocated are placed into the arena that is current in the allocating thread
+      * (see MemoryArenaScope) instead of getting their own heap allocation; outside of any scope they are allocated on the heap
+      * as before. Releasing the arena calls the destructors of the objects that are still alive, in the reverse order of their
+      * creation, and frees all blocks in one step, so the pointers to these objects must not outlive the arena.
+      * An arena is not thread safe: a thread that allocates objects for a file while other threads do the same has to use its
+      * own arena and hand it over with Absorb.
+      */
+    class MemoryArena
+    {
+        public:
+            typedef void (*DestroyFunction)(void*);
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * @param block_size Size in bytes of the blocks the objects are placed in; larger objects get a block of their own
+              */
+            MemoryArena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+            ~MemoryArena();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Arena of the innermost MemoryArenaScope of the calling thread, NULL if there is none
+              */
+            static MemoryArena* GetCurrent();
+            std::size_t GetNumberOfObjects() const;
+            std::size_t GetNumberOfBlocks() const;
+            /*! \fn
+              * Total size of the blocks of the arena in bytes
+              */
+            std::size_t GetReservedBytes() const;
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Destroy all objects of the arena and free its blocks; the arena can be used again afterwards
+              */
+            void Release();
+            /*! \fn
+              * Destroy all objects of the arena but keep its regular blocks for the objects that are created next
+              * Used when the owner of the arena is cleared to hold another structure of similar size
+              */
+            void Rewind();
+            /*! \fn
+              * Take over the objects and blocks of another arena, which is left empty
+              * Used to collect the objects that worker threads have created for the same file
+              */
+            void Absorb(MemoryArena& other);
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Reserve memory for an object of the given size in this arena
+              * @param destroy Function that calls the destructor of the object when the arena is released
+              */
+            void* Allocate(std::size_t size, DestroyFunction destroy);
+            /*! \fn
+              * Allocation used by ArenaAllocated: in the current arena of the thread if there is one, on the heap otherwise
+              */
+            static void* AllocateObject(std::size_t size, DestroyFunction destroy);
+            /*! \fn
+              * Counterpart of AllocateObject, called after the destructor of the object has run
+              * Heap objects are freed right away; the memory of arena objects is reclaimed when their arena is released
+              */
+            static void DeallocateObject(void* object);
+
+            static const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        private:
+            /*! \struct
+              * Bookkeeping in front of every object created through AllocateObject
+              */
+            struct ObjectHeader
+            {
+                    DestroyFunction destroy;        /*!< Destructor call of a live arena object, NULL once the object is gone >*/
+                    MemoryArena* arena;             /*!< Arena of the object, NULL if the object lives on the heap >*/
+                    ObjectHeader* previous;         /*!< Object created before this one in the same arena >*/
+            };
+
+            MemoryArena(const MemoryArena&);
+            MemoryArena& operator=(const MemoryArena&);
+            char* AllocateBlock(std::size_t size);
+            void DestroyObjects();
+            static std::size_t HeaderSize();
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            std::size_t block_size_;                /*!< Size of a regular block >*/
+            std::vector<char*> blocks_;             /*!< Regular blocks of the arena; the ones after the current block are free >*/
+            std::vector<char*> large_blocks_;       /*!< Blocks holding a single large object >*/
+            std::size_t current_block_;             /*!< Index of the block the objects are currently placed in >*/
+            std::size_t reserved_bytes_;            /*!< Total size of the blocks >*/
+            char* cursor_;                          /*!< Next free byte of the current block >*/
+            char* end_;                             /*!< End of the current block >*/
+            ObjectHeader* last_object_;             /*!< Most recently created object, start of the destruction list >*/
+            std::size_t number_of_objects_;         /*!< Number of objects created in the arena >*/
+
+            friend class MemoryArenaScope;
+    };
+
+    /*! \class
+      * Makes an arena the current arena of the calling thread for the lifetime of the scope; scopes can be nested
+      */
+    class MemoryArenaScope
+    {
+        public:
+            MemoryArenaScope(MemoryArena* arena);
+            ~MemoryArenaScope();
+
+        private:
+            MemoryArenaScope(const MemoryArenaScope&);
+            MemoryArenaScope& operator=(const MemoryArenaScope&);
+            MemoryArena* previous_;                 /*!< Arena that was current when the scope has been entered >*/
+    };
+
+    /*! \class
+      * Base class of the objects that are allocated in the arena of their owner while it is read or built,
+      * e.g. class PdbAtom : public gmml::ArenaAllocated<PdbAtom>
+      * Only final classes may derive from it, the destructor of the arena object is called as ~T
+      */
+    template<class T>
+    class ArenaAllocated
+    {
+        public:
+            static void* operator new(std::size_t size)
+            {
+                return MemoryArena::AllocateObject(size, &ArenaAllocated<T>::Destroy);
+            }
+            static void operator delete(void* object)
+            {
+                MemoryArena::DeallocateObject(object);
+            }
+
+        private:
+            static void Destroy(void* object)
+            {
+                static_cast<T*>(object)->~T();
+            }
+    };
+}
+
+#endif // MEMORYARENA_HPP
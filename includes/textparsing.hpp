@@ -0,0 +1,449 @@
+#ifndef TEXTPARSING_HPP
+#define TEXTPARSING_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <charconv>
+
+namespace gmml
+{
+    /*! \fn
+      * Whitespace as the stream extractors see it in the classic locale
+      */
+    inline bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    /*! \fn
+      * View of the given text without the space characters on both sides; nothing is copied
+      * @param text Text with spaces either in the beginning or at the end
+      * @return The part of the text between the first and the last non-space character, empty if there is none
+      */
+    inline std::string_view TrimView(std::string_view text)
+    {
+        std::size_t first = text.find_first_not_of(' ');
+        if(first == std::string_view::npos)
+            return std::string_view();
+        return text.substr(first, text.find_last_not_of(' ') - first + 1);
+    }
+
+    /*! \fn
+      * View of a fixed-width column of a line; a column that runs over the end of the line is cut at the end of it
+      * @param line A line of a fixed-column file
+      * @param start Zero-based index of the first character of the column
+      * @param length Width of the column
+      * @return The characters of the column, empty if the line ends before the column
+      */
+    inline std::string_view Column(std::string_view line, std::size_t start, std::size_t length)
+    {
+        if(start >= line.size())
+            return std::string_view();
+        return line.substr(start, length);
+    }
+
+    /*! \fn
+      * Trimmed view of a fixed-width column of a line, see Column
+      */
+    inline std::string_view TrimmedColumn(std::string_view line, std::size_t start, std::size_t length)
+    {
+        return TrimView(Column(line, start, length));
+    }
+
+    /*! \fn
+      * Pad a line with spaces at the end up to the given length; a longer line is not changed
+      */
+    inline void PadLine(std::string& line, std::size_t length)
+    {
+        if(line.size() < length)
+            line.append(length - line.size(), ' ');
+    }
+
+    /*! \fn
+      * Parse an integer from the beginning of the given text the way a stream extracts it: leading whitespace and a plus sign
+      * are skipped and the longest valid prefix is taken, so "12.5" gives 12
+      * @param text Text that starts with the number
+      * @param value The parsed number; not changed if there is no number at the beginning of the text
+      * @return Number of characters consumed including the leading whitespace, 0 if there is no number
+      */
+    template<typename T>
+    inline std::size_t ScanInteger(std::string_view text, T& value)
+    {
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        const char* first = begin;
+        while(first != end && IsBlank(*first))
+            first++;
+        if(first != end && *first == '+' && first + 1 != end && *(first + 1) != '-')
+            first++;
+        std::from_chars_result result = std::from_chars(first, end, value);
+        if(result.ec != std::errc())
+            return 0;
+        return result.ptr - begin;
+    }
+
+    /*! \fn
+      * Parse a floating point number from the beginning of the given text the way a stream extracts it, see ScanInteger
+      * Fixed and scientific notations are both accepted, e.g. "1.5", "-.5" and "0.12345678E+01"
+      */
+    template<typename T>
+    inline std::size_t ScanFloat(std::string_view text, T& value)
+    {
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        const char* first = begin;
+        while(first != end && IsBlank(*first))
+            first++;
+        if(first != end && *first == '+' && first + 1 != end && *(first + 1) != '-')
+            first++;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        std::from_chars_result result = std::from_chars(first, end, value);
+        if(result.ec != std::errc())
+            return 0;
+        return result.ptr - begin;
+#else
+        /// Older libraries only parse integers with from_chars; fall back to strtod on a bounded copy of the number
+        char buffer[64];
+        std::size_t length = 0;
+        while(first + length != end && length < sizeof(buffer) - 1 && !IsBlank(first[length]))
+            length++;
+        std::memcpy(buffer, first, length);
+        buffer[length] = '\0';
+        char* last = NULL;
+        double parsed = std::strtod(buffer, &last);
+        if(last == buffer)
+            return 0;
+        value = static_cast<T>(parsed);
+        return (first - begin) + (last - buffer);
+#endif
+    }
+
+    /*! \fn
+      * Parse the integer at the beginning of the given text, see ScanInteger
+      * @return True if the text starts with an integer
+      */
+    template<typename T>
+    inline bool ParseInteger(std::string_view text, T& value)
+    {
+        return ScanInteger(text, value) != 0;
+    }
+
+    /*! \fn
+      * Parse the floating point number at the beginning of the given text, see ScanFloat
+      * @return True if the text starts with a number
+      */
+    template<typename T>
+    inline bool ParseFloat(std::string_view text, T& value)
+    {
+        return ScanFloat(text, value) != 0;
+    }
+
+    /*! \fn
+      * Convert the beginning of the given text to the given type with the same result as extracting it from a stream
+      * Numbers and strings are parsed without any allocation beyond the result; other types go through a stream
+      * @param text Text that starts with the value
+      * @return The value, a value-initialized one (0 for numbers) if the text does not start with a valid value
+      */
+    template<typename T>
+    inline T ParseValue(std::string_view text)
+    {
+        T value = T();
+        std::istringstream ss{std::string(text)};
+        ss >> value;
+        return value;
+    }
+
+    template<>
+    inline int ParseValue<int>(std::string_view text)
+    {
+        int value = 0;
+        ScanInteger(text, value);
+        return value;
+    }
+
+    template<>
+    inline long ParseValue<long>(std::string_view text)
+    {
+        long value = 0;
+        ScanInteger(text, value);
+        return value;
+    }
+
+    template<>
+    inline long long ParseValue<long long>(std::string_view text)
+    {
+        long long value = 0;
+        ScanInteger(text, value);
+        return value;
+    }
+
+    template<>
+    inline float ParseValue<float>(std::string_view text)
+    {
+        float value = 0;
+        ScanFloat(text, value);
+        return value;
+    }
+
+    template<>
+    inline double ParseValue<double>(std::string_view text)
+    {
+        double value = 0;
+        ScanFloat(text, value);
+        return value;
+    }
+
+    template<>
+    inline char ParseValue<char>(std::string_view text)
+    {
+        for(std::string_view::const_iterator it = text.begin(); it != text.end(); it++)
+        {
+            if(!IsBlank(*it))
+                return *it;
+        }
+        return char();
+    }
+
+    template<>
+    inline std::string ParseValue<std::string>(std::string_view text)
+    {
+        std::size_t first = 0;
+        while(first < text.size() && IsBlank(text[first]))
+            first++;
+        std::size_t last = first;
+        while(last < text.size() && !IsBlank(text[last]))
+            last++;
+        return std::string(text.substr(first, last - first));
+    }
+
+    /*! \fn
+      * Parse a fixed-width numeric column of a line
+      * @param default_value Value returned for a blank column or a column past the end of the line
+      */
+    template<typename T>
+    inline T ColumnValue(std::string_view line, std::size_t start, std::size_t length, T default_value)
+    {
+        std::string_view column = TrimmedColumn(line, start, length);
+        if(column.empty())
+            return default_value;
+        return ParseValue<T>(column);
+    }
+
+    /*! \class
+      * Splits a text into tokens separated by any of a set of delimiter characters, without copying the text
+      * Empty tokens are dropped, as boost::char_separator does with dropped delimiters. The text and the delimiters must
+      * outlive the tokenizer and the tokens it returns.
+      */
+    class Tokenizer
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * @param text Text to be split
+              * @param delimiters Every character of this string separates two tokens
+              */
+            Tokenizer(std::string_view text, std::string_view delimiters = " ") : text_(text), delimiters_(delimiters), position_(0) {}
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Move to the next token of the text
+              * @param token The next token, a view into the text
+              * @return False if there is no token left
+              */
+            bool Next(std::string_view& token)
+            {
+                std::size_t first = text_.find_first_not_of(delimiters_, position_);
+                if(first == std::string_view::npos)
+                {
+                    position_ = text_.size();
+                    return false;
+                }
+                std::size_t last = text_.find_first_of(delimiters_, first);
+                if(last == std::string_view::npos)
+                    last = text_.size();
+                token = text_.substr(first, last - first);
+                position_ = last;
+                return true;
+            }
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::string_view text_;         /*!< Text that is split >*/
+            std::string_view delimiters_;   /*!< Delimiter characters >*/
+            std::size_t position_;          /*!< Index of the first character that has not been tokenized yet >*/
+    };
+
+    /*! \fn
+      * Split a text into views of its tokens; the capacity of the given vector is reused from call to call
+      * @param text Text to be split, it must outlive the tokens
+      * @param delimiters Every character of this string separates two tokens
+      * @param tokens Cleared and filled with the tokens of the text
+      * @return Number of tokens
+      */
+    inline std::size_t SplitInto(std::string_view text, std::string_view delimiters, std::vector<std::string_view>& tokens)
+    {
+        tokens.clear();
+        Tokenizer tokenizer(text, delimiters);
+        std::string_view token;
+        while(tokenizer.Next(token))
+            tokens.push_back(token);
+        return tokens.size();
+    }
+
+    /*! \class
+      * Reads the whitespace separated fields of a line the way an istringstream does, without the stream
+      * Each extraction skips leading whitespace; a word can be limited to a number of characters as with std::setw, numbers
+      * take the longest valid prefix. After the first failed extraction the scanner fails and later extractions do nothing,
+      * so a chain of extractions can be checked once at the end with Fail.
+      */
+    class LineScanner
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * @param line Line to be read, it must outlive the scanner
+              */
+            LineScanner(std::string_view line) : line_(line), position_(0), fail_(false) {}
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            bool Fail() const
+            {
+                return fail_;
+            }
+            /*! \fn
+              * Part of the line that has not been read yet
+              */
+            std::string_view GetRest() const
+            {
+                return line_.substr(position_);
+            }
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Read the next word
+              * @param word View of the word in the line
+              * @param width Maximum number of characters of the word, 0 for no limit
+              */
+            LineScanner& Word(std::string_view& word, std::size_t width = 0)
+            {
+                if(fail_ || !SkipBlanks())
+                    return *this;
+                std::size_t last = position_;
+                while(last < line_.size() && !IsBlank(line_[last]) && (width == 0 || last - position_ < width))
+                    last++;
+                word = line_.substr(position_, last - position_);
+                position_ = last;
+                return *this;
+            }
+            LineScanner& Word(std::string& word, std::size_t width = 0)
+            {
+                std::string_view view;
+                if(!Word(view, width).fail_)
+                    word.assign(view.data(), view.size());
+                return *this;
+            }
+            /*! \fn
+              * Read the next non-whitespace character
+              */
+            LineScanner& Char(char& c)
+            {
+                if(fail_ || !SkipBlanks())
+                    return *this;
+                c = line_[position_++];
+                return *this;
+            }
+            /*! \fn
+              * Read the next integer; it is set to 0 if there is none
+              */
+            template<typename T>
+            LineScanner& Integer(T& value)
+            {
+                if(fail_)
+                    return *this;
+                std::size_t consumed = ScanInteger(line_.substr(position_), value);
+                return Advance(consumed, value);
+            }
+            /*! \fn
+              * Read the next floating point number; it is set to 0 if there is none
+              */
+            template<typename T>
+            LineScanner& Float(T& value)
+            {
+                if(fail_)
+                    return *this;
+                std::size_t consumed = ScanFloat(line_.substr(position_), value);
+                return Advance(consumed, value);
+            }
+            LineScanner& operator>>(int& value)
+            {
+                return Integer(value);
+            }
+            LineScanner& operator>>(double& value)
+            {
+                return Float(value);
+            }
+            LineScanner& operator>>(std::string_view& word)
+            {
+                return Word(word);
+            }
+            LineScanner& operator>>(std::string& word)
+            {
+                return Word(word);
+            }
+            LineScanner& operator>>(char& c)
+            {
+                return Char(c);
+            }
+
+        private:
+            /*! \fn
+              * Skip the whitespace in front of the next field; fails the scanner at the end of the line
+              */
+            bool SkipBlanks()
+            {
+                while(position_ < line_.size() && IsBlank(line_[position_]))
+                    position_++;
+                if(position_ == line_.size())
+                    fail_ = true;
+                return !fail_;
+            }
+            template<typename T>
+            LineScanner& Advance(std::size_t consumed, T& value)
+            {
+                if(consumed == 0)
+                {
+                    value = 0;
+                    fail_ = true;
+                }
+                else
+                    position_ += consumed;
+                return *this;
+            }
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            std::string_view line_;         /*!< Line that is read >*/
+            std::size_t position_;          /*!< Index of the first character that has not been read yet >*/
+            bool fail_;                     /*!< Set by the first extraction that failed >*/
+    };
+}
+
+#endif // TEXTPARSING_HPP
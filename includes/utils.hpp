@@ -12,7 +12,10 @@
 #include "boost/tokenizer.hpp"
 #include "boost/foreach.hpp"
 #include "common.hpp"
+#include "logger.hpp"
+#include "textparsing.hpp"
 #include "GeometryTopology/coordinate.hpp"
+#include "GeometryTopology/geometrykernels.hpp"
 
 #include <fstream>
 
@@ -55,13 +58,15 @@ namespace gmml
       * @param line Input string in order to be split by the given delimiter
       * @param delim Series of delimiters (each delimiter character is followed by the next one in a single string variable) in order to split the given string
       * @return Vector of elements of the given string that have been split by the given delimiter(s)
+      * Readers that only look at the tokens should use Tokenizer or SplitInto, which do not copy them
       */
-    inline std::vector<std::string> Split(std::string line, std::string delim)
+    inline std::vector<std::string> Split(const std::string& line, const std::string& delim)
     {
-        boost::char_separator<char> separator(delim.c_str());
-        boost::tokenizer< boost::char_separator<char> > tokens(line, separator);
         std::vector<std::string> vectorTokens = std::vector<std::string>();
-        vectorTokens.assign(tokens.begin(), tokens.end());
+        Tokenizer tokenizer(line, delim);
+        std::string_view token;
+        while(tokenizer.Next(token))
+            vectorTokens.push_back(std::string(token));
         return vectorTokens;
     }
 
@@ -69,16 +74,11 @@ namespace gmml
       * Convert string to the defined type
       * @param str String that has to be converted to the defined type
       * @return The given type version of the given string
+      * Same as ParseValue, which also takes a view of a column without copying it
       */
     template<typename T>
     inline T ConvertString(const std::string& str) {
-        T val;
-        std::stringstream ss(str);
-        ss >> val;
-//        if (ss >> val)
-        return val;
-
-        throw std::invalid_argument("ConvertString: invalid conversion of string " + str);
+        return ParseValue<T>(str);
     }
 
     /*! \fn
@@ -101,17 +101,9 @@ namespace gmml
       */
     inline std::string ExpandLine(std::string line, int length)
     {
-        int l = line.length();
-        if(l >= length)
-            return line;
-        else
-        {
-            int space = length - l;
-            std::stringstream ss;
-            ss << line << std::setw(space) << " ";
-            line = ss.str();
-            return line;
-        }
+        if(length > 0)
+            PadLine(line, length);
+        return line;
     }
 
     /*! \fn
@@ -133,6 +125,8 @@ namespace gmml
             return TOP;
         if(type.compare("TOP_CRD") == 0)
             return TOP_CRD;
+        if(type.compare("CIF") == 0)
+            return CIF;
         if(type.compare("MULTIPLE") == 0)
             return MULTIPLE;
         return UNKNOWN;
@@ -159,6 +153,8 @@ namespace gmml
                 return "TOP";
             case TOP_CRD:
                 return "TOP_CRD";
+            case CIF:
+                return "CIF";
             case MULTIPLE:
                 return "MULTIPLE";
             case UNKNOWN:
@@ -256,80 +252,9 @@ namespace gmml
       */
     inline GeometryTopology::Coordinate* ConvertInternalCoordinate2CartesianCoordinate(std::vector<GeometryTopology::Coordinate*> coordinate_list, double distance, double angle, double torsion)
     {
-        if(coordinate_list.size() == 0)
-        {
-            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate();
-            return coordinate;
-        }
-        if(coordinate_list.size() == 1)
-        {
-            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(coordinate_list.at(0)->GetX() + distance, 0.0, 0.0);
-            return coordinate;
-        }
-        if(coordinate_list.size() == 2)
-        {
-            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(coordinate_list.at(1)->GetX() - cos(gmml::ConvertDegree2Radian(angle) * distance),
-                                                                        sin(gmml::ConvertDegree2Radian(angle)) * distance, 0.0);
-            return coordinate;
-        }
-        else
-        {
-            torsion = gmml::PI_DEGREE - torsion;
-
-            GeometryTopology::Coordinate great_grandparent_vector = GeometryTopology::Coordinate(coordinate_list.at(0)->GetX(), coordinate_list.at(0)->GetY(), coordinate_list.at(0)->GetZ());
-            GeometryTopology::Coordinate grandparent_vector = GeometryTopology::Coordinate(coordinate_list.at(1)->GetX(), coordinate_list.at(1)->GetY(), coordinate_list.at(1)->GetZ());
-            GeometryTopology::Coordinate parent_vector = GeometryTopology::Coordinate(coordinate_list.at(2)->GetX(), coordinate_list.at(2)->GetY(), coordinate_list.at(2)->GetZ());
-
-            GeometryTopology::Coordinate v1 = GeometryTopology::Coordinate(great_grandparent_vector);
-            GeometryTopology::Coordinate v2 = GeometryTopology::Coordinate(grandparent_vector);
-
-            v1.operator-(grandparent_vector);
-            v2.operator-(parent_vector);
-
-            v1.Normalize();
-            v2.Normalize();
-
-            if(abs(v1.GetX() + v2.GetX()) < gmml::EPSILON &&
-                    abs(v1.GetY() + v2.GetY()) < gmml::EPSILON &&
-                    abs(v1.GetZ() + v2.GetZ()) < gmml::EPSILON)
-            {
-                great_grandparent_vector.Translate(10.0, -1.0, 3);
-                v1 = GeometryTopology::Coordinate(grandparent_vector);
-                v1.operator-(great_grandparent_vector);
-            }
-
-            GeometryTopology::Coordinate v1_cross_v2 = GeometryTopology::Coordinate(v1);
-            v1_cross_v2.CrossProduct(v2);
-            v1_cross_v2.Normalize();
-            double matrix[3][4];
-            matrix[0][1] = v1_cross_v2.GetX();
-            matrix[1][1] = v1_cross_v2.GetY();
-            matrix[2][1] = v1_cross_v2.GetZ();
-
-            matrix[0][2] = v2.GetX();
-            matrix[1][2] = v2.GetY();
-            matrix[2][2] = v2.GetZ();
-
-            GeometryTopology::Coordinate v1_cross_v2_cross_v2 = GeometryTopology::Coordinate(v1_cross_v2);
-            v1_cross_v2_cross_v2.CrossProduct(v2);
-
-            matrix[0][0] = v1_cross_v2_cross_v2.GetX();
-            matrix[1][0] = v1_cross_v2_cross_v2.GetY();
-            matrix[2][0] = v1_cross_v2_cross_v2.GetZ();
-
-            matrix[0][3] = parent_vector.GetX();
-            matrix[1][3] = parent_vector.GetY();
-            matrix[2][3] = parent_vector.GetZ();
-
-            GeometryTopology::Coordinate v = GeometryTopology::Coordinate(distance * sin(ConvertDegree2Radian(angle)) * cos(ConvertDegree2Radian(torsion)),
-                                                                          distance * sin(ConvertDegree2Radian(angle)) * sin(ConvertDegree2Radian(torsion)),
-                                                                          distance * cos(ConvertDegree2Radian(angle)));
-
-            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matrix[0][0] * v.GetX() + matrix[0][1] * v.GetY() + matrix[0][2] * v.GetZ() + matrix[0][3],
-                                                                                        matrix[1][0] * v.GetX() + matrix[1][1] * v.GetY() + matrix[1][2] * v.GetZ() + matrix[1][3],
-                                                                                        matrix[2][0] * v.GetX() + matrix[2][1] * v.GetY() + matrix[2][2] * v.GetZ() + matrix[2][3]);
-            return coordinate;
-        }
+        GeometryTopology::Vector3 position = GeometryTopology::ConvertInternalCoordinate2CartesianCoordinate(GeometryTopology::GatherCoordinates(coordinate_list),
+                                                                                                              distance, angle, torsion);
+        return new GeometryTopology::Coordinate(position.GetX(), position.GetY(), position.GetZ());
     }
 
     inline GeometryTopology::Coordinate* ConvertCartesianCoordinate2InternalCoordinate(GeometryTopology::Coordinate* coordinate, std::vector<GeometryTopology::Coordinate*> coordinate_list)
@@ -464,35 +389,19 @@ namespace gmml
 
     /*! \fn
       * A function in order to write the information/warning/error messages produced by the program into a log file
+      * The message is handed to the buffered logger (see Logger in logger.hpp) and written by its background thread;
+      * nothing is done if the level is disabled
       * @param line The line number producing the message
       * @param file_path The file path of the file which the message has been produced within in
       * @param level The type of the produced message INF/WAR/ERR
       * @param msg The message content that has been produced
       * @param out_file_name The name of the output log file
       */
-    inline void log(int line, std::string file_path, LogLevel level, std::string msg, std::string out_file_name = "log.log")
+    inline void log(int line, const std::string& file_path, LogLevel level, const std::string& msg, const std::string& out_file_name = "log.log")
     {
-        std::ofstream file;
-        file.open(out_file_name.c_str(), std::ios_base::app);
-
-        time_t t = time(0);
-        std::string time_str = std::asctime(std::localtime(&t));
-        file << time_str.substr(0, time_str.size() - 1) << " >>> " << file_path << ":" << line << " >>>";
-        switch(level)
-        {
-            case INF:
-                file << " [INFO]: ";
-                break;
-            case ERR:
-                file << " [ERROR]: ";
-                break;
-            case WAR:
-                file << " [WARNING]: ";
-                break;
-        }
-        file << msg << std::endl;
-
-        file.close();
+        if(!Logger::IsEnabled(level))
+            return;
+        Logger::GetInstance()->Log(line, file_path, level, msg, out_file_name);
     }
 }
 
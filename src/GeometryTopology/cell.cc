@@ -2,6 +2,7 @@
 #include "../../includes/GeometryTopology/cell.hpp"
 #include "../../includes/GeometryTopology/coordinate.hpp"
 #include "../../includes/MolecularModeling/assembly.hpp"
+#include "../../includes/GeometryTopology/unitcell.hpp"
 
 using namespace gmml;
 using namespace GeometryTopology;
@@ -54,6 +55,12 @@ Cell::Cell(Grid *grid, Coordinate *min, Coordinate *max, double charge, double p
     grid_ = grid;
 }
 
+Cell::~Cell()
+{
+    delete min_corner_;
+    delete max_corner_;
+}
+
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -132,11 +139,11 @@ void Cell::SetGrid(Grid *grid)
 //////////////////////////////////////////////////////////+
 //                         FUNCTIONS                    //
 //////////////////////////////////////////////////////////
-GeometryTopology::Coordinate* Cell::GetCellCenter()
+GeometryTopology::Coordinate Cell::GetCellCenter()
 {
-    return new Coordinate(min_corner_->GetX() + (max_corner_->GetX() - min_corner_->GetX()) / 2,
-                          min_corner_->GetY() + (max_corner_->GetY() - min_corner_->GetY()) / 2,
-                          min_corner_->GetZ() + (max_corner_->GetZ() - min_corner_->GetZ()) / 2);
+    return Coordinate(min_corner_->GetX() + (max_corner_->GetX() - min_corner_->GetX()) / 2,
+                      min_corner_->GetY() + (max_corner_->GetY() - min_corner_->GetY()) / 2,
+                      min_corner_->GetZ() + (max_corner_->GetZ() - min_corner_->GetZ()) / 2);
 }
 
 void Cell::CalculateCellCharge()
@@ -161,16 +168,22 @@ void Cell::CalculateCellPotentialEnergy(double ion_radius)
 {
     double potential_energy = 0.0;
     Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
-    Coordinate* center_of_cell = this->GetCellCenter();
+    Coordinate center_of_cell = this->GetCellCenter();
+    UnitCell* unit_cell = this->grid_->GetAssembly()->GetPeriodicBox();
     for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
-        double dist = sqrt((center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
-                           (center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) +
-                           (center_of_cell->GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) *
-                           (center_of_cell->GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) +
-                           (center_of_cell->GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()) *
-                           (center_of_cell->GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()));
+        double dist = 0.0;
+        /// Ions placed in a periodic box interact with the closest image of each atom
+        if(unit_cell != NULL && unit_cell->IsSet())
+            dist = unit_cell->MinimumImageDistance(&center_of_cell, atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex()));
+        else
+            dist = sqrt((center_of_cell.GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
+                        (center_of_cell.GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) +
+                        (center_of_cell.GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) *
+                        (center_of_cell.GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) +
+                        (center_of_cell.GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()) *
+                        (center_of_cell.GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()));
 
         double radius = (atom->MolecularDynamicAtom::GetRadius() != dNotSet) ? atom->MolecularDynamicAtom::GetRadius() : MINIMUM_RADIUS;
         if(dist < radius + GRID_OFFSET + ion_radius)
@@ -208,16 +221,22 @@ void Cell::CalculateBoxPotentialEnergy()
 {
     double potential_energy = 0.0;
     Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
-    Coordinate* center_of_cell = this->GetCellCenter();
+    Coordinate center_of_cell = this->GetCellCenter();
+    UnitCell* unit_cell = this->grid_->GetAssembly()->GetPeriodicBox();
     for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
-        double dist = sqrt((center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
-                           (center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) +
-                           (center_of_cell->GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) *
-                           (center_of_cell->GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) +
-                           (center_of_cell->GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()) *
-                           (center_of_cell->GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()));
+        double dist = 0.0;
+        /// Ions placed in a periodic box interact with the closest image of each atom
+        if(unit_cell != NULL && unit_cell->IsSet())
+            dist = unit_cell->MinimumImageDistance(&center_of_cell, atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex()));
+        else
+            dist = sqrt((center_of_cell.GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
+                        (center_of_cell.GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) +
+                        (center_of_cell.GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) *
+                        (center_of_cell.GetY() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetY()) +
+                        (center_of_cell.GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()) *
+                        (center_of_cell.GetZ() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetZ()));
         if(dist == 0.0)
             dist = DIST_EPSILON;
         else
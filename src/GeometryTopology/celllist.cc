@@ -0,0 +1,263 @@
+#include <math.h>
+#include <algorithm>
+
+#include "../../includes/GeometryTopology/celllist.hpp"
+#include "../../includes/common.hpp"
+
+using namespace std;
+using namespace GeometryTopology;
+using namespace gmml;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+CellList::CellList() : cutoff_(dCutOff), unit_cell_(NULL)
+{
+    coordinates_ = CoordinateVector();
+    for(int i = 0; i < 3; i++)
+    {
+        number_of_cells_[i] = 1;
+        origin_[i] = 0.0;
+        cell_size_[i] = dCutOff;
+    }
+    cell_heads_ = vector<int>(1, -1);
+    next_ = vector<int>();
+}
+
+CellList::CellList(CoordinateVector coordinates, double cutoff, UnitCell *unit_cell)
+{
+    this->Build(coordinates, cutoff, unit_cell);
+}
+
+//////////////////////////////////////////////////////////
+//                           ACCESSOR                   //
+//////////////////////////////////////////////////////////
+double CellList::GetCutoff()
+{
+    return cutoff_;
+}
+
+UnitCell* CellList::GetUnitCell()
+{
+    return unit_cell_;
+}
+
+CellList::CoordinateVector CellList::GetCoordinates()
+{
+    return coordinates_;
+}
+
+int CellList::GetNumberOfCells(int axis)
+{
+    return number_of_cells_[axis];
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void CellList::Build(CoordinateVector coordinates, double cutoff, UnitCell *unit_cell)
+{
+    coordinates_ = coordinates;
+    cutoff_ = cutoff;
+    unit_cell_ = (unit_cell != NULL && unit_cell->IsSet()) ? unit_cell : NULL;
+    int size = coordinates_.size();
+
+    if(unit_cell_ != NULL)
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            number_of_cells_[i] = max(1, (int)floor(unit_cell_->GetPerpendicularWidth(i) / cutoff_));
+            origin_[i] = 0.0;
+            cell_size_[i] = 1.0 / number_of_cells_[i];
+        }
+    }
+    else
+    {
+        double min_corner[3] = {INFINITY, INFINITY, INFINITY};
+        double max_corner[3] = {-INFINITY, -INFINITY, -INFINITY};
+        for(CoordinateVector::iterator it = coordinates_.begin(); it != coordinates_.end(); it++)
+        {
+            Coordinate* coordinate = *it;
+            double position[3] = {coordinate->GetX(), coordinate->GetY(), coordinate->GetZ()};
+            for(int i = 0; i < 3; i++)
+            {
+                min_corner[i] = min(min_corner[i], position[i]);
+                max_corner[i] = max(max_corner[i], position[i]);
+            }
+        }
+        double size_of_cell = cutoff_;
+        /// Keep the number of cells in the order of the number of positions for sparse sets (e.g. two distant molecules)
+        double maximum_cells = max(27.0, 2.0 * size);
+        while(true)
+        {
+            double total = 1.0;
+            for(int i = 0; i < 3; i++)
+            {
+                origin_[i] = (size == 0) ? 0.0 : min_corner[i];
+                double extent = (size == 0) ? 0.0 : max_corner[i] - min_corner[i];
+                number_of_cells_[i] = (int)floor(extent / size_of_cell) + 1;
+                cell_size_[i] = size_of_cell;
+                total *= number_of_cells_[i];
+            }
+            if(total <= maximum_cells)
+                break;
+            size_of_cell *= 1.26;
+        }
+    }
+
+    cell_heads_ = vector<int>(number_of_cells_[0] * number_of_cells_[1] * number_of_cells_[2], -1);
+    next_ = vector<int>(size, -1);
+    /// Insert in reverse order so that each cell lists its positions in increasing index order
+    for(int index = size - 1; index >= 0; index--)
+    {
+        int cell_indices[3];
+        GetCellIndices(coordinates_.at(index), cell_indices);
+        int key = GetCellKey(cell_indices[0], cell_indices[1], cell_indices[2]);
+        next_.at(index) = cell_heads_.at(key);
+        cell_heads_.at(key) = index;
+    }
+}
+
+CellList::IndexPairVector CellList::FindPairsWithinCutoff()
+{
+    IndexPairVector pairs = IndexPairVector();
+    double squared_cutoff = cutoff_ * cutoff_;
+    for(int i = 0; i < number_of_cells_[0]; i++)
+    {
+        for(int j = 0; j < number_of_cells_[1]; j++)
+        {
+            for(int k = 0; k < number_of_cells_[2]; k++)
+            {
+                int key = GetCellKey(i, j, k);
+                if(cell_heads_.at(key) == -1)
+                    continue;
+                int cell_indices[3] = {i, j, k};
+                vector<int> neighbor_keys = GetNeighborCellKeys(cell_indices);
+                for(vector<int>::iterator it = neighbor_keys.begin(); it != neighbor_keys.end(); it++)
+                {
+                    int neighbor_key = *it;
+                    /// Every pair of cells is visited once
+                    if(neighbor_key < key)
+                        continue;
+                    for(int first = cell_heads_.at(key); first != -1; first = next_.at(first))
+                    {
+                        for(int second = cell_heads_.at(neighbor_key); second != -1; second = next_.at(second))
+                        {
+                            if(neighbor_key == key && second <= first)
+                                continue;
+                            if(SquaredDistance(first, second) < squared_cutoff)
+                            {
+                                if(first < second)
+                                    pairs.push_back(IndexPair(first, second));
+                                else
+                                    pairs.push_back(IndexPair(second, first));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+vector<int> CellList::FindNeighbors(Coordinate *position, double distance)
+{
+    vector<int> neighbors = vector<int>();
+    double squared_distance = distance * distance;
+    int cell_indices[3];
+    GetCellIndices(position, cell_indices);
+    vector<int> neighbor_keys = GetNeighborCellKeys(cell_indices);
+    for(vector<int>::iterator it = neighbor_keys.begin(); it != neighbor_keys.end(); it++)
+    {
+        for(int index = cell_heads_.at(*it); index != -1; index = next_.at(index))
+        {
+            if(SquaredDistance(position, coordinates_.at(index)) < squared_distance)
+                neighbors.push_back(index);
+        }
+    }
+    sort(neighbors.begin(), neighbors.end());
+    return neighbors;
+}
+
+double CellList::SquaredDistance(int first, int second)
+{
+    return SquaredDistance(coordinates_.at(first), coordinates_.at(second));
+}
+
+double CellList::SquaredDistance(Coordinate *first, Coordinate *second)
+{
+    if(unit_cell_ != NULL)
+        return unit_cell_->MinimumImageSquaredDistance(first, second);
+    double dx = first->GetX() - second->GetX();
+    double dy = first->GetY() - second->GetY();
+    double dz = first->GetZ() - second->GetZ();
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void CellList::GetCellIndices(Coordinate *position, int cell_indices[3])
+{
+    double reduced[3];
+    if(unit_cell_ != NULL)
+    {
+        unit_cell_->CartesianToFractional(position->GetX(), position->GetY(), position->GetZ(), reduced);
+        for(int i = 0; i < 3; i++)
+            reduced[i] -= floor(reduced[i]);
+    }
+    else
+    {
+        reduced[0] = position->GetX();
+        reduced[1] = position->GetY();
+        reduced[2] = position->GetZ();
+    }
+    for(int i = 0; i < 3; i++)
+    {
+        int index = (int)floor((reduced[i] - origin_[i]) / cell_size_[i]);
+        /// Query positions of an open system may lie outside of the bounding box
+        cell_indices[i] = min(max(index, 0), number_of_cells_[i] - 1);
+    }
+}
+
+int CellList::GetCellKey(int i, int j, int k)
+{
+    return (i * number_of_cells_[1] + j) * number_of_cells_[2] + k;
+}
+
+vector<int> CellList::GetNeighborCellKeys(int cell_indices[3])
+{
+    vector<int> keys = vector<int>();
+    for(int di = -1; di <= 1; di++)
+    {
+        for(int dj = -1; dj <= 1; dj++)
+        {
+            for(int dk = -1; dk <= 1; dk++)
+            {
+                int neighbor[3] = {cell_indices[0] + di, cell_indices[1] + dj, cell_indices[2] + dk};
+                bool inside = true;
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    if(unit_cell_ != NULL)
+                        neighbor[axis] = (neighbor[axis] + number_of_cells_[axis]) % number_of_cells_[axis];
+                    else if(neighbor[axis] < 0 || neighbor[axis] >= number_of_cells_[axis])
+                        inside = false;
+                }
+                if(inside)
+                    keys.push_back(GetCellKey(neighbor[0], neighbor[1], neighbor[2]));
+            }
+        }
+    }
+    /// Small periodic boxes map several offsets onto the same cell
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void CellList::Print(ostream &out)
+{
+    out << "Cell list: " << coordinates_.size() << " positions in " << number_of_cells_[0] << "x" << number_of_cells_[1] << "x"
+        << number_of_cells_[2] << " cells, cutoff " << cutoff_ << ((unit_cell_ != NULL) ? ", periodic" : ", open") << endl;
+}
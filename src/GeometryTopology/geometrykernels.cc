@@ -0,0 +1,149 @@
+#include <math.h>
+
+#include "../../includes/GeometryTopology/geometrykernels.hpp"
+#include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
+
+using namespace std;
+using namespace GeometryTopology;
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+Vector3Vector GeometryTopology::GatherCoordinates(const vector<Coordinate*>& coordinates)
+{
+    Vector3Vector vectors = Vector3Vector();
+    vectors.reserve(coordinates.size());
+    for(vector<Coordinate*>::const_iterator it = coordinates.begin(); it != coordinates.end(); it++)
+        vectors.push_back(Vector3(*(*it)));
+    return vectors;
+}
+
+void GeometryTopology::ScatterCoordinates(const Vector3Vector& vectors, const vector<Coordinate*>& coordinates)
+{
+    for(unsigned int i = 0; i < vectors.size() && i < coordinates.size(); i++)
+        vectors[i].CopyTo(coordinates[i]);
+}
+
+void GeometryTopology::TranslateCoordinates(Vector3Vector& positions, const Vector3& offset)
+{
+    for(Vector3Vector::iterator it = positions.begin(); it != positions.end(); it++)
+        (*it) += offset;
+}
+
+void GeometryTopology::TranslateCoordinates(const vector<Coordinate*>& coordinates, const Vector3& offset)
+{
+    for(vector<Coordinate*>::const_iterator it = coordinates.begin(); it != coordinates.end(); it++)
+        (*it)->Translate(offset.GetX(), offset.GetY(), offset.GetZ());
+}
+
+void GeometryTopology::TransformCoordinates(Vector3Vector& positions, const Matrix3& rotation, const Vector3& translation)
+{
+    for(Vector3Vector::iterator it = positions.begin(); it != positions.end(); it++)
+        (*it) = rotation * (*it) + translation;
+}
+
+void GeometryTopology::TransformCoordinates(const vector<Coordinate*>& coordinates, const Matrix3& rotation, const Vector3& translation)
+{
+    for(vector<Coordinate*>::const_iterator it = coordinates.begin(); it != coordinates.end(); it++)
+        (rotation * Vector3(*(*it)) + translation).CopyTo(*it);
+}
+
+void GeometryTopology::RotateCoordinates(Vector3Vector& positions, const Matrix3& rotation, const Vector3& origin)
+{
+    TransformCoordinates(positions, rotation, origin - rotation * origin);
+}
+
+void GeometryTopology::RotateCoordinates(const vector<Coordinate*>& coordinates, const Matrix3& rotation, const Vector3& origin)
+{
+    TransformCoordinates(coordinates, rotation, origin - rotation * origin);
+}
+
+Vector3 GeometryTopology::CalculateCentroid(const Vector3Vector& positions)
+{
+    Vector3 sum = Vector3();
+    if(positions.empty())
+        return sum;
+    for(Vector3Vector::const_iterator it = positions.begin(); it != positions.end(); it++)
+        sum += (*it);
+    return sum / positions.size();
+}
+
+Vector3 GeometryTopology::CalculateCentroid(const vector<Coordinate*>& coordinates)
+{
+    Vector3 sum = Vector3();
+    if(coordinates.empty())
+        return sum;
+    for(vector<Coordinate*>::const_iterator it = coordinates.begin(); it != coordinates.end(); it++)
+        sum += Vector3(*(*it));
+    return sum / coordinates.size();
+}
+
+double GeometryTopology::CalculateRMSD(const Vector3Vector& positions, const Vector3Vector& reference_positions)
+{
+    if(positions.empty() || positions.size() != reference_positions.size())
+        return gmml::dNotSet;
+    double sum = 0.0;
+    for(unsigned int i = 0; i < positions.size(); i++)
+        sum += positions[i].SquaredDistance(reference_positions[i]);
+    return sqrt(sum / positions.size());
+}
+
+double GeometryTopology::CalculateRMSD(const vector<Coordinate*>& coordinates, const vector<Coordinate*>& reference_coordinates)
+{
+    return CalculateRMSD(GatherCoordinates(coordinates), GatherCoordinates(reference_coordinates));
+}
+
+vector<double> GeometryTopology::CalculateDistanceMatrix(const Vector3Vector& positions)
+{
+    unsigned int size = positions.size();
+    vector<double> distances = vector<double>(size * size, 0.0);
+    for(unsigned int i = 0; i < size; i++)
+    {
+        for(unsigned int j = i + 1; j < size; j++)
+        {
+            double distance = positions[i].Distance(positions[j]);
+            distances[i * size + j] = distance;
+            distances[j * size + i] = distance;
+        }
+    }
+    return distances;
+}
+
+vector<double> GeometryTopology::CalculateDistanceMatrix(const vector<Coordinate*>& coordinates)
+{
+    return CalculateDistanceMatrix(GatherCoordinates(coordinates));
+}
+
+Vector3 GeometryTopology::ConvertInternalCoordinate2CartesianCoordinate(const Vector3Vector& reference_positions, double distance, double angle, double torsion)
+{
+    if(reference_positions.size() == 0)
+        return Vector3();
+    if(reference_positions.size() == 1)
+        return Vector3(reference_positions[0].GetX() + distance, 0.0, 0.0);
+    if(reference_positions.size() == 2)
+        return Vector3(reference_positions[1].GetX() - cos(gmml::ConvertDegree2Radian(angle) * distance), sin(gmml::ConvertDegree2Radian(angle)) * distance, 0.0);
+
+    torsion = gmml::PI_DEGREE - torsion;
+    Vector3 great_grandparent = reference_positions[0];
+    const Vector3& grandparent = reference_positions[1];
+    const Vector3& parent = reference_positions[2];
+
+    Vector3 v1 = (great_grandparent - grandparent).Normalized();
+    Vector3 v2 = (grandparent - parent).Normalized();
+    /// Collinear reference atoms do not define a plane, so an arbitrary off-axis point is used instead
+    if(fabs(v1.GetX() + v2.GetX()) < gmml::EPSILON && fabs(v1.GetY() + v2.GetY()) < gmml::EPSILON && fabs(v1.GetZ() + v2.GetZ()) < gmml::EPSILON)
+    {
+        great_grandparent += Vector3(10.0, -1.0, 3.0);
+        v1 = grandparent - great_grandparent;
+    }
+    Vector3 v1_cross_v2 = v1.CrossProduct(v2).Normalized();
+    Matrix3 frame = Matrix3::FromColumns(v1_cross_v2.CrossProduct(v2), v1_cross_v2, v2);
+
+    double angle_in_radian = gmml::ConvertDegree2Radian(angle);
+    double torsion_in_radian = gmml::ConvertDegree2Radian(torsion);
+    Vector3 v = Vector3(distance * sin(angle_in_radian) * cos(torsion_in_radian),
+                        distance * sin(angle_in_radian) * sin(torsion_in_radian),
+                        distance * cos(angle_in_radian));
+    return frame * v + parent;
+}
@@ -2,11 +2,19 @@
 #include "../../includes/GeometryTopology/cell.hpp"
 #include "../../includes/GeometryTopology/grid.hpp"
 #include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
 
 using namespace std;
 using namespace GeometryTopology;
 using namespace MolecularModeling;
 using namespace gmml;
+
+/// Cells copy their corners
+static Cell* NewCell(Grid* grid, Coordinate min_corner, Coordinate max_corner)
+{
+    return new Cell(grid, &min_corner, &max_corner);
+}
+
 //////////////////////////////////////////////////////////
 //                       Constructor                    //
 //////////////////////////////////////////////////////////
@@ -27,6 +35,14 @@ Grid::Grid(Assembly *assembly, Coordinate *min, Coordinate *max, double ion_radi
     this->UpdateGrid(ion_charge);
 }
 
+Grid::~Grid()
+{
+    for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+        delete (*it);
+    delete min_corner_;
+    delete max_corner_;
+}
+
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -55,12 +71,16 @@ Assembly* Grid::GetAssembly()
 //////////////////////////////////////////////////////////
 void Grid::SetMinCorner(Coordinate *min)
 {
-    min_corner_ = min;
+    min_corner_->SetX(min->GetX());
+    min_corner_->SetY(min->GetY());
+    min_corner_->SetZ(min->GetZ());
 }
 
 void Grid::SetMaxCorner(Coordinate *max)
 {
-    max_corner_ = max;
+    max_corner_->SetX(max->GetX());
+    max_corner_->SetY(max->GetY());
+    max_corner_->SetZ(max->GetZ());
 }
 
 void Grid::SetCells(CellVector cells)
@@ -89,9 +109,9 @@ void Grid::UpdateGrid(double ion_charge)
     double max_y = this->GetMaxCorner()->GetY();
     double max_z = this->GetMaxCorner()->GetZ();
 
-    Coordinate* min_boundary = new Coordinate();
-    Coordinate* max_boundary = new Coordinate();
-    this->assembly_->GetBoundary(min_boundary, max_boundary);
+    Coordinate min_boundary = Coordinate();
+    Coordinate max_boundary = Coordinate();
+    this->assembly_->GetBoundary(&min_boundary, &max_boundary);
 
     if(max_x - min_x <= DEFAULT_BOX_LENGTH && max_y - min_y <= DEFAULT_BOX_WIDTH && max_z - min_z <= DEFAULT_BOX_HEIGHT)
     {
@@ -102,115 +122,22 @@ void Grid::UpdateGrid(double ion_charge)
             {
                 for(double k = min_z; k <= max_z; k += DEFAULT_GRID_HEIGHT)
                 {
-                    if(i + DEFAULT_GRID_LENGTH <= max_x)
+                    /// The last cell in each direction is cut at the corner of the grid
+                    Coordinate cell_min_corner = Coordinate(i, j, k);
+                    Coordinate cell_max_corner = Coordinate((i + DEFAULT_GRID_LENGTH <= max_x) ? i + DEFAULT_GRID_LENGTH : max_x,
+                                                            (j + DEFAULT_GRID_WIDTH <= max_y) ? j + DEFAULT_GRID_WIDTH : max_y,
+                                                            (k + DEFAULT_GRID_HEIGHT <= max_z) ? k + DEFAULT_GRID_HEIGHT : max_z);
+                    Cell* new_cell = new Cell(&cell_min_corner, &cell_max_corner);
+                    Coordinate cell_center = new_cell->GetCellCenter();
+                    if(!(cell_center.GetX() > min_boundary.GetX() && cell_center.GetX() < max_boundary.GetX() &&
+                            cell_center.GetY() > min_boundary.GetY() && cell_center.GetY() < max_boundary.GetY() &&
+                            cell_center.GetZ() > min_boundary.GetZ() && cell_center.GetZ() < max_boundary.GetZ()))
                     {
-                        if(j + DEFAULT_GRID_WIDTH <= max_y)
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k),
-                                                         new Coordinate(i + DEFAULT_GRID_LENGTH, j + DEFAULT_GRID_WIDTH, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, j + DEFAULT_GRID_WIDTH, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, max_y, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, max_y, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
+                        new_cell->SetGrid(this);
+                        grid_cells.push_back(new_cell);
                     }
                     else
-                    {
-                        if(j + DEFAULT_GRID_WIDTH <= max_y)
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + DEFAULT_GRID_WIDTH, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + DEFAULT_GRID_WIDTH, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                        new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                        new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-
-                            }
-                        }
-                    }
+                        delete new_cell;
                 }
             }
         }
@@ -220,6 +147,7 @@ void Grid::UpdateGrid(double ion_charge)
     else
     {
         Grid* temp_grid = new Grid();
+        temp_grid->SetAssembly(this->assembly_);
         temp_grid->SetMaxCorner(this->GetMaxCorner());
         temp_grid->SetMinCorner(this->GetMinCorner());
         double min_x = temp_grid->GetMinCorner()->GetX();
@@ -229,71 +157,69 @@ void Grid::UpdateGrid(double ion_charge)
         double max_y = temp_grid->GetMaxCorner()->GetY();
         double max_z = temp_grid->GetMaxCorner()->GetZ();
         Grid::CellVector grid_cells = Grid::CellVector();
-        grid_cells.push_back(new Cell(temp_grid,
-                                 temp_grid->GetMinCorner(),
-                                 new Coordinate(
+        grid_cells.push_back(NewCell(temp_grid,
+                                 *temp_grid->GetMinCorner(),
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                             temp_grid->GetMinCorner()->GetY(),
                                             temp_grid->GetMinCorner()->GetZ()),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_x),
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX(),
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX(),
                                             temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                             temp_grid->GetMinCorner()->GetZ()),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                             temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                             temp_grid->GetMinCorner()->GetZ()),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX(),
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX(),
                                             temp_grid->GetMinCorner()->GetY(),
                                             temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_y) / 2,
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                             temp_grid->GetMinCorner()->GetY(),
                                             temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX(),
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX(),
                                             temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                             temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                 new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
+        grid_cells.push_back(NewCell(temp_grid,
+                                 Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
                                             temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
                                             temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                 new Coordinate(
+                                 Coordinate(
                                      temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
                                      temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
                                      temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
 
-
-
         temp_grid->SetCells(grid_cells);
 
         temp_grid->CalculateBoxCharge();
@@ -306,16 +232,22 @@ void Grid::UpdateGrid(double ion_charge)
             new_grid->SetMaxCorner(best_box->GetMaxCorner());
             new_grid->SetMinCorner(best_box->GetMinCorner());
             new_grid->UpdateGrid(ion_charge);
-            this->SetCells(new_grid->GetCells());
+            /// The cells of the refined grid are handed over to this grid
+            Grid::CellVector new_cells = new_grid->GetCells();
+            for(Grid::CellVector::iterator it = new_cells.begin(); it != new_cells.end(); it++)
+                (*it)->SetGrid(this);
+            this->SetCells(new_cells);
+            new_grid->SetCells(Grid::CellVector());
+            delete new_grid;
+            delete temp_grid;
             return;
         }
         else
         {
-            cout << "Can't create an appropriate grid!" << endl;
+            gmml::log(__LINE__, __FILE__, gmml::WAR, "Can't create an appropriate grid!");
+            delete temp_grid;
             return;
         }
-
-
     }
 }
 
@@ -427,7 +359,7 @@ vector<Coordinate*> Grid::GetBestPositions(double ion_charge)
             if((*it)->GetCellPotentialEnergy() == INFINITY)
                 continue;
             if(fabs(min_value - (*it)->GetCellPotentialEnergy()) < THRESHOLD)
-                best_coordinates.push_back(new Coordinate((*it)->GetCellCenter()->GetX(), (*it)->GetCellCenter()->GetY(), (*it)->GetCellCenter()->GetZ()));
+                best_coordinates.push_back(new Coordinate((*it)->GetCellCenter().GetX(), (*it)->GetCellCenter().GetY(), (*it)->GetCellCenter().GetZ()));
         }
     }
     else if(ion_charge < 0)
@@ -445,7 +377,7 @@ vector<Coordinate*> Grid::GetBestPositions(double ion_charge)
             if((*it)->GetCellPotentialEnergy() == INFINITY)
                 continue;
             if(fabs(max_value - (*it)->GetCellPotentialEnergy()) < THRESHOLD)
-                best_coordinates.push_back(new Coordinate((*it)->GetCellCenter()->GetX(), (*it)->GetCellCenter()->GetY(), (*it)->GetCellCenter()->GetZ()));
+                best_coordinates.push_back(new Coordinate((*it)->GetCellCenter().GetX(), (*it)->GetCellCenter().GetY(), (*it)->GetCellCenter().GetZ()));
         }
     }
     return best_coordinates;
@@ -461,7 +393,7 @@ void Grid::Print(ostream &out)
         if((*it)->GetCellPotentialEnergy() != INFINITY)
         {
             Cell* cell = *it;
-            cell->GetCellCenter()->Print(out);
+            cell->GetCellCenter().Print(out);
             out << ":  " << cell->GetCellPotentialEnergy() << endl;
         }
     }
@@ -0,0 +1,263 @@
+#include <math.h>
+
+#include "../../includes/GeometryTopology/unitcell.hpp"
+#include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
+
+using namespace std;
+using namespace GeometryTopology;
+using namespace gmml;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+UnitCell::UnitCell() : a_(dNotSet), b_(dNotSet), c_(dNotSet), alpha_(dNotSet), beta_(dNotSet), gamma_(dNotSet), orthorhombic_(true)
+{
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 3; j++)
+        {
+            box_[i][j] = 0.0;
+            inverse_box_[i][j] = 0.0;
+        }
+}
+
+UnitCell::UnitCell(double a, double b, double c, double alpha, double beta, double gamma)
+{
+    this->SetCellParameters(a, b, c, alpha, beta, gamma);
+}
+
+UnitCell::UnitCell(const UnitCell &unit_cell) : a_(unit_cell.a_), b_(unit_cell.b_), c_(unit_cell.c_),
+    alpha_(unit_cell.alpha_), beta_(unit_cell.beta_), gamma_(unit_cell.gamma_), orthorhombic_(unit_cell.orthorhombic_)
+{
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 3; j++)
+        {
+            box_[i][j] = unit_cell.box_[i][j];
+            inverse_box_[i][j] = unit_cell.inverse_box_[i][j];
+        }
+}
+
+//////////////////////////////////////////////////////////
+//                           ACCESSOR                   //
+//////////////////////////////////////////////////////////
+double UnitCell::GetA()
+{
+    return a_;
+}
+
+double UnitCell::GetB()
+{
+    return b_;
+}
+
+double UnitCell::GetC()
+{
+    return c_;
+}
+
+double UnitCell::GetAlpha()
+{
+    return alpha_;
+}
+
+double UnitCell::GetBeta()
+{
+    return beta_;
+}
+
+double UnitCell::GetGamma()
+{
+    return gamma_;
+}
+
+Coordinate UnitCell::GetBoxVector(int index)
+{
+    return Coordinate(box_[index][0], box_[index][1], box_[index][2]);
+}
+
+//////////////////////////////////////////////////////////
+//                           MUTATOR                    //
+//////////////////////////////////////////////////////////
+void UnitCell::SetCellParameters(double a, double b, double c, double alpha, double beta, double gamma)
+{
+    a_ = a;
+    b_ = b;
+    c_ = c;
+    /// Restart files and CRYST1 cards of non-crystal boxes may leave the angles empty
+    alpha_ = (alpha == dNotSet) ? 90.0 : alpha;
+    beta_ = (beta == dNotSet) ? 90.0 : beta;
+    gamma_ = (gamma == dNotSet) ? 90.0 : gamma;
+    this->UpdateBoxMatrices();
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+bool UnitCell::IsSet()
+{
+    /// PDB files of NMR and cryo-EM structures usually carry a dummy 1x1x1 CRYST1 card
+    return a_ != dNotSet && b_ != dNotSet && c_ != dNotSet &&
+            a_ > 1.0 && b_ > 1.0 && c_ > 1.0 &&
+            !isinf(a_) && !isinf(b_) && !isinf(c_);
+}
+
+bool UnitCell::IsPeriodicBox(string space_group)
+{
+    Trim(space_group);
+    return this->IsSet() && (space_group.compare("P 1") == 0 || space_group.compare("P1") == 0) &&
+            !(a_ == 1.0 && b_ == 1.0 && c_ == 1.0);
+}
+
+bool UnitCell::IsOrthorhombic()
+{
+    return orthorhombic_;
+}
+
+double UnitCell::GetVolume()
+{
+    return box_[0][0] * box_[1][1] * box_[2][2];
+}
+
+double UnitCell::GetPerpendicularWidth(int index)
+{
+    int j = (index + 1) % 3;
+    int k = (index + 2) % 3;
+    Coordinate cross = Coordinate(box_[j][0], box_[j][1], box_[j][2]);
+    cross.CrossProduct(Coordinate(box_[k][0], box_[k][1], box_[k][2]));
+    double area = cross.length();
+    if(area == 0.0)
+        return 0.0;
+    return GetVolume() / area;
+}
+
+void UnitCell::CartesianToFractional(double x, double y, double z, double fractional[3])
+{
+    fractional[0] = x * inverse_box_[0][0] + y * inverse_box_[1][0] + z * inverse_box_[2][0];
+    fractional[1] = x * inverse_box_[0][1] + y * inverse_box_[1][1] + z * inverse_box_[2][1];
+    fractional[2] = x * inverse_box_[0][2] + y * inverse_box_[1][2] + z * inverse_box_[2][2];
+}
+
+void UnitCell::FractionalToCartesian(const double fractional[3], double cartesian[3])
+{
+    cartesian[0] = fractional[0] * box_[0][0] + fractional[1] * box_[1][0] + fractional[2] * box_[2][0];
+    cartesian[1] = fractional[0] * box_[0][1] + fractional[1] * box_[1][1] + fractional[2] * box_[2][1];
+    cartesian[2] = fractional[0] * box_[0][2] + fractional[1] * box_[1][2] + fractional[2] * box_[2][2];
+}
+
+void UnitCell::MinimumImage(double &dx, double &dy, double &dz)
+{
+    if(orthorhombic_)
+    {
+        dx -= box_[0][0] * floor(dx / box_[0][0] + 0.5);
+        dy -= box_[1][1] * floor(dy / box_[1][1] + 0.5);
+        dz -= box_[2][2] * floor(dz / box_[2][2] + 0.5);
+        return;
+    }
+    double fractional[3];
+    CartesianToFractional(dx, dy, dz, fractional);
+    for(int i = 0; i < 3; i++)
+        fractional[i] -= floor(fractional[i] + 0.5);
+    double reduced[3];
+    FractionalToCartesian(fractional, reduced);
+    /// Rounding in fractional space is not always the shortest image of a skewed cell, so check the surrounding images
+    double best[3] = {reduced[0], reduced[1], reduced[2]};
+    double best_squared = best[0] * best[0] + best[1] * best[1] + best[2] * best[2];
+    for(int i = -1; i <= 1; i++)
+        for(int j = -1; j <= 1; j++)
+            for(int k = -1; k <= 1; k++)
+            {
+                if(i == 0 && j == 0 && k == 0)
+                    continue;
+                double x = reduced[0] + i * box_[0][0] + j * box_[1][0] + k * box_[2][0];
+                double y = reduced[1] + i * box_[0][1] + j * box_[1][1] + k * box_[2][1];
+                double z = reduced[2] + i * box_[0][2] + j * box_[1][2] + k * box_[2][2];
+                double squared = x * x + y * y + z * z;
+                if(squared < best_squared)
+                {
+                    best_squared = squared;
+                    best[0] = x;
+                    best[1] = y;
+                    best[2] = z;
+                }
+            }
+    dx = best[0];
+    dy = best[1];
+    dz = best[2];
+}
+
+double UnitCell::MinimumImageSquaredDistance(Coordinate *first, Coordinate *second)
+{
+    double dx = second->GetX() - first->GetX();
+    double dy = second->GetY() - first->GetY();
+    double dz = second->GetZ() - first->GetZ();
+    MinimumImage(dx, dy, dz);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+double UnitCell::MinimumImageDistance(Coordinate *first, Coordinate *second)
+{
+    return sqrt(MinimumImageSquaredDistance(first, second));
+}
+
+void UnitCell::Wrap(Coordinate *coordinate)
+{
+    double fractional[3];
+    CartesianToFractional(coordinate->GetX(), coordinate->GetY(), coordinate->GetZ(), fractional);
+    for(int i = 0; i < 3; i++)
+        fractional[i] -= floor(fractional[i]);
+    double cartesian[3];
+    FractionalToCartesian(fractional, cartesian);
+    coordinate->SetX(cartesian[0]);
+    coordinate->SetY(cartesian[1]);
+    coordinate->SetZ(cartesian[2]);
+}
+
+void UnitCell::UpdateBoxMatrices()
+{
+    double cos_alpha = cos(ConvertDegree2Radian(alpha_));
+    double cos_beta = cos(ConvertDegree2Radian(beta_));
+    double cos_gamma = cos(ConvertDegree2Radian(gamma_));
+    double sin_gamma = sin(ConvertDegree2Radian(gamma_));
+    orthorhombic_ = fabs(cos_alpha) < DIST_EPSILON && fabs(cos_beta) < DIST_EPSILON && fabs(cos_gamma) < DIST_EPSILON;
+
+    box_[0][0] = a_;
+    box_[0][1] = 0.0;
+    box_[0][2] = 0.0;
+    box_[1][0] = b_ * cos_gamma;
+    box_[1][1] = b_ * sin_gamma;
+    box_[1][2] = 0.0;
+    box_[2][0] = c_ * cos_beta;
+    box_[2][1] = c_ * (cos_alpha - cos_beta * cos_gamma) / sin_gamma;
+    double z_squared = c_ * c_ - box_[2][0] * box_[2][0] - box_[2][1] * box_[2][1];
+    box_[2][2] = (z_squared > 0.0) ? sqrt(z_squared) : 0.0;
+    if(orthorhombic_)
+    {
+        box_[1][0] = 0.0;
+        box_[2][0] = 0.0;
+        box_[2][1] = 0.0;
+    }
+
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 3; j++)
+            inverse_box_[i][j] = 0.0;
+    if(box_[0][0] == 0.0 || box_[1][1] == 0.0 || box_[2][2] == 0.0)
+        return;
+    /// Inverse of a lower triangular matrix is lower triangular
+    inverse_box_[0][0] = 1.0 / box_[0][0];
+    inverse_box_[1][1] = 1.0 / box_[1][1];
+    inverse_box_[2][2] = 1.0 / box_[2][2];
+    inverse_box_[1][0] = -box_[1][0] / (box_[0][0] * box_[1][1]);
+    inverse_box_[2][1] = -box_[2][1] / (box_[1][1] * box_[2][2]);
+    inverse_box_[2][0] = (box_[1][0] * box_[2][1] - box_[1][1] * box_[2][0]) / (box_[0][0] * box_[1][1] * box_[2][2]);
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void UnitCell::Print(ostream &out)
+{
+    out << "Unit cell: a " << a_ << ", b " << b_ << ", c " << c_
+        << ", alpha " << alpha_ << ", beta " << beta_ << ", gamma " << gamma_ << endl;
+    for(int i = 0; i < 3; i++)
+        out << "  v" << i + 1 << ": " << box_[i][0] << ", " << box_[i][1] << ", " << box_[i][2] << endl;
+}
@@ -0,0 +1,300 @@
+#include "../../../includes/common.hpp"
+#include "../../../includes/textparsing.hpp"
+#include "../../../includes/InputSet/CifFileSpace/cifatomsite.hpp"
+
+using namespace std;
+using namespace gmml;
+using namespace CifFileSpace;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+CifAtomSite::CifAtomSite() {}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+int CifAtomSite::GetNumberOfRows() const
+{
+    return serial_numbers_.size();
+}
+
+bool CifAtomSite::GetIsHeterogen(int row) const
+{
+    return is_heterogen_[row] != 0;
+}
+
+int CifAtomSite::GetSerialNumber(int row) const
+{
+    return serial_numbers_[row];
+}
+
+const string& CifAtomSite::GetElementSymbol(int row) const
+{
+    return element_symbols_[row];
+}
+
+const string& CifAtomSite::GetAtomName(int row) const
+{
+    return atom_names_[row];
+}
+
+const string& CifAtomSite::GetAlternateLocation(int row) const
+{
+    return alternate_locations_[row];
+}
+
+const string& CifAtomSite::GetResidueName(int row) const
+{
+    return residue_names_[row];
+}
+
+const string& CifAtomSite::GetChainId(int row) const
+{
+    return chain_ids_[row];
+}
+
+int CifAtomSite::GetResidueSequenceNumber(int row) const
+{
+    return residue_sequence_numbers_[row];
+}
+
+const string& CifAtomSite::GetInsertionCode(int row) const
+{
+    return insertion_codes_[row];
+}
+
+double CifAtomSite::GetX(int row) const
+{
+    return x_[row];
+}
+
+double CifAtomSite::GetY(int row) const
+{
+    return y_[row];
+}
+
+double CifAtomSite::GetZ(int row) const
+{
+    return z_[row];
+}
+
+double CifAtomSite::GetOccupancy(int row) const
+{
+    return occupancies_[row];
+}
+
+double CifAtomSite::GetTemperatureFactor(int row) const
+{
+    return temperature_factors_[row];
+}
+
+const string& CifAtomSite::GetFormalCharge(int row) const
+{
+    return formal_charges_[row];
+}
+
+int CifAtomSite::GetModelNumber(int row) const
+{
+    return model_numbers_[row];
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void CifAtomSite::AddRow()
+{
+    is_heterogen_.push_back(0);
+    serial_numbers_.push_back(iNotSet);
+    element_symbols_.push_back(string());
+    atom_names_.push_back(string());
+    alternate_locations_.push_back(string());
+    residue_names_.push_back(string());
+    chain_ids_.push_back(string());
+    residue_sequence_numbers_.push_back(iNotSet);
+    insertion_codes_.push_back(string());
+    x_.push_back(dNotSet);
+    y_.push_back(dNotSet);
+    z_.push_back(dNotSet);
+    occupancies_.push_back(dNotSet);
+    temperature_factors_.push_back(dNotSet);
+    formal_charges_.push_back(string());
+    model_numbers_.push_back(1);
+}
+
+void CifAtomSite::SetValue(Item item, string_view value)
+{
+    /// '.' marks an inapplicable and '?' an unknown value; both leave the item of the row unset
+    if(value.size() == 1 && (value[0] == '.' || value[0] == '?'))
+        return;
+    switch(item)
+    {
+        case kGroup:
+            is_heterogen_.back() = (value == "HETATM") ? 1 : 0;
+            break;
+        case kId:
+            serial_numbers_.back() = ParseValue<int>(value);
+            break;
+        case kTypeSymbol:
+            element_symbols_.back().assign(value.data(), value.size());
+            break;
+        case kAuthAtomId:
+            atom_names_.back().assign(value.data(), value.size());
+            break;
+        case kLabelAtomId:
+            if(atom_names_.back().empty())
+                atom_names_.back().assign(value.data(), value.size());
+            break;
+        case kLabelAltId:
+            alternate_locations_.back().assign(value.data(), value.size());
+            break;
+        case kAuthCompId:
+            residue_names_.back().assign(value.data(), value.size());
+            break;
+        case kLabelCompId:
+            if(residue_names_.back().empty())
+                residue_names_.back().assign(value.data(), value.size());
+            break;
+        case kAuthAsymId:
+            chain_ids_.back().assign(value.data(), value.size());
+            break;
+        case kLabelAsymId:
+            if(chain_ids_.back().empty())
+                chain_ids_.back().assign(value.data(), value.size());
+            break;
+        case kAuthSeqId:
+            residue_sequence_numbers_.back() = ParseValue<int>(value);
+            break;
+        case kLabelSeqId:
+            if(residue_sequence_numbers_.back() == iNotSet)
+                residue_sequence_numbers_.back() = ParseValue<int>(value);
+            break;
+        case kInsertionCode:
+            insertion_codes_.back().assign(value.data(), value.size());
+            break;
+        case kCartnX:
+            x_.back() = ParseValue<double>(value);
+            break;
+        case kCartnY:
+            y_.back() = ParseValue<double>(value);
+            break;
+        case kCartnZ:
+            z_.back() = ParseValue<double>(value);
+            break;
+        case kOccupancy:
+            occupancies_.back() = ParseValue<double>(value);
+            break;
+        case kBFactor:
+            temperature_factors_.back() = ParseValue<double>(value);
+            break;
+        case kFormalCharge:
+            formal_charges_.back().assign(value.data(), value.size());
+            break;
+        case kModelNumber:
+            model_numbers_.back() = ParseValue<int>(value);
+            break;
+        case kUnknownItem:
+            break;
+    }
+}
+
+void CifAtomSite::Reserve(int number_of_rows)
+{
+    is_heterogen_.reserve(number_of_rows);
+    serial_numbers_.reserve(number_of_rows);
+    element_symbols_.reserve(number_of_rows);
+    atom_names_.reserve(number_of_rows);
+    alternate_locations_.reserve(number_of_rows);
+    residue_names_.reserve(number_of_rows);
+    chain_ids_.reserve(number_of_rows);
+    residue_sequence_numbers_.reserve(number_of_rows);
+    insertion_codes_.reserve(number_of_rows);
+    x_.reserve(number_of_rows);
+    y_.reserve(number_of_rows);
+    z_.reserve(number_of_rows);
+    occupancies_.reserve(number_of_rows);
+    temperature_factors_.reserve(number_of_rows);
+    formal_charges_.reserve(number_of_rows);
+    model_numbers_.reserve(number_of_rows);
+}
+
+void CifAtomSite::Clear()
+{
+    is_heterogen_.clear();
+    serial_numbers_.clear();
+    element_symbols_.clear();
+    atom_names_.clear();
+    alternate_locations_.clear();
+    residue_names_.clear();
+    chain_ids_.clear();
+    residue_sequence_numbers_.clear();
+    insertion_codes_.clear();
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    occupancies_.clear();
+    temperature_factors_.clear();
+    formal_charges_.clear();
+    model_numbers_.clear();
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+CifAtomSite::Item CifAtomSite::GetItem(string_view tag)
+{
+    if(tag == "group_PDB")
+        return kGroup;
+    if(tag == "id")
+        return kId;
+    if(tag == "type_symbol")
+        return kTypeSymbol;
+    if(tag == "label_atom_id")
+        return kLabelAtomId;
+    if(tag == "auth_atom_id")
+        return kAuthAtomId;
+    if(tag == "label_alt_id")
+        return kLabelAltId;
+    if(tag == "label_comp_id")
+        return kLabelCompId;
+    if(tag == "auth_comp_id")
+        return kAuthCompId;
+    if(tag == "label_asym_id")
+        return kLabelAsymId;
+    if(tag == "auth_asym_id")
+        return kAuthAsymId;
+    if(tag == "label_seq_id")
+        return kLabelSeqId;
+    if(tag == "auth_seq_id")
+        return kAuthSeqId;
+    if(tag == "pdbx_PDB_ins_code")
+        return kInsertionCode;
+    if(tag == "Cartn_x")
+        return kCartnX;
+    if(tag == "Cartn_y")
+        return kCartnY;
+    if(tag == "Cartn_z")
+        return kCartnZ;
+    if(tag == "occupancy")
+        return kOccupancy;
+    if(tag == "B_iso_or_equiv")
+        return kBFactor;
+    if(tag == "pdbx_formal_charge")
+        return kFormalCharge;
+    if(tag == "pdbx_PDB_model_num")
+        return kModelNumber;
+    return kUnknownItem;
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void CifAtomSite::Print(ostream &out)
+{
+    for(int i = 0; i < this->GetNumberOfRows(); i++)
+    {
+        out << ((is_heterogen_[i]) ? "HETATM" : "ATOM") << " " << serial_numbers_[i] << " " << atom_names_[i] << " " << residue_names_[i]
+            << " " << chain_ids_[i] << " " << residue_sequence_numbers_[i] << " " << x_[i] << " " << y_[i] << " " << z_[i]
+            << " " << model_numbers_[i] << endl;
+    }
+}
@@ -0,0 +1,245 @@
+#include <fstream>
+
+#include "../../../includes/common.hpp"
+#include "../../../includes/textparsing.hpp"
+#include "../../../includes/inputfilestream.hpp"
+#include "../../../includes/instrumentation.hpp"
+#include "../../../includes/InputSet/CifFileSpace/ciffile.hpp"
+#include "../../../includes/InputSet/CifFileSpace/ciffileprocessingexception.hpp"
+
+using namespace std;
+using namespace gmml;
+using namespace CifFileSpace;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+CifFile::CifFile() : path_("GMML-Generated"), in_loop_header_(false), in_loop_(false), number_of_loop_tags_(0), next_loop_tag_(0)
+{
+    for(int i = 0; i < 6; i++)
+        cell_[i] = dNotSet;
+}
+
+CifFile::CifFile(const string &cif_file) : path_(cif_file), in_loop_header_(false), in_loop_(false), number_of_loop_tags_(0), next_loop_tag_(0)
+{
+    for(int i = 0; i < 6; i++)
+        cell_[i] = dNotSet;
+    gmml::InputFileStream in_file(cif_file);
+    if(!in_file)
+    {
+        throw CifFileProcessingException(__LINE__, "Cif file not found");
+    }
+    Read(in_file);
+    in_file.close();
+}
+
+//////////////////////////////////////////////////////////
+//                           ACCESSOR                   //
+//////////////////////////////////////////////////////////
+const string& CifFile::GetFilePath() const
+{
+    return path_;
+}
+
+const string& CifFile::GetDataBlockName() const
+{
+    return data_block_name_;
+}
+
+const CifAtomSite& CifFile::GetAtomSite() const
+{
+    return atom_site_;
+}
+
+bool CifFile::HasUnitCell() const
+{
+    for(int i = 0; i < 6; i++)
+    {
+        if(cell_[i] == dNotSet)
+            return false;
+    }
+    return true;
+}
+
+GeometryTopology::UnitCell CifFile::GetUnitCell() const
+{
+    return GeometryTopology::UnitCell(cell_[0], cell_[1], cell_[2], cell_[3], cell_[4], cell_[5]);
+}
+
+const string& CifFile::GetSpaceGroup() const
+{
+    return space_group_;
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void CifFile::Read(std::istream& in_file)
+{
+    GMML_SCOPED_TIMER("CifFile::Read");
+    string line;
+    string text_field;
+    int line_number = 0;
+    bool in_data_block = false;
+    while(getline(in_file, line))
+    {
+        line_number++;
+        if(!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        if(!line.empty() && line[0] == ';')
+        {
+            /// A text field is a single value that runs from a line starting with ';' to the next line starting with ';'
+            text_field.assign(line, 1, string::npos);
+            bool closed = false;
+            while(getline(in_file, line))
+            {
+                line_number++;
+                if(!line.empty() && line[line.size() - 1] == '\r')
+                    line.erase(line.size() - 1);
+                if(!line.empty() && line[0] == ';')
+                {
+                    closed = true;
+                    break;
+                }
+                text_field += "\n" + line;
+            }
+            if(!closed)
+                throw CifFileProcessingException(line_number, "Unterminated text field");
+            ProcessValue(text_field);
+            continue;
+        }
+        string_view view(line);
+        size_t position = 0;
+        string_view token;
+        bool quoted = false;
+        while(NextToken(view, position, token, quoted))
+        {
+            if(!quoted && token.compare(0, 5, "data_") == 0)
+            {
+                /// A new data block or loop may not cut off the last row of a loop
+                if(in_loop_ && next_loop_tag_ != 0)
+                    throw CifFileProcessingException(line_number, "Incomplete row in a loop");
+                /// Only the first data block is read; an mmCIF file of a single entry has only one
+                if(in_data_block)
+                    return;
+                in_data_block = true;
+                data_block_name_ = string(token.substr(5));
+                in_loop_header_ = false;
+                in_loop_ = false;
+                pending_tag_.clear();
+            }
+            else if(!quoted && token == "loop_")
+            {
+                if(in_loop_ && next_loop_tag_ != 0)
+                    throw CifFileProcessingException(line_number, "Incomplete row in a loop");
+                in_loop_header_ = true;
+                in_loop_ = true;
+                loop_items_.clear();
+                number_of_loop_tags_ = 0;
+                next_loop_tag_ = 0;
+                pending_tag_.clear();
+            }
+            else if(!quoted && token[0] == '_')
+            {
+                if(in_loop_header_)
+                {
+                    /// Items are only recorded for the _atom_site loop, the values of every other loop are counted and skipped
+                    if(token.compare(0, 11, "_atom_site.") == 0 && loop_items_.size() == number_of_loop_tags_)
+                        loop_items_.push_back(CifAtomSite::GetItem(token.substr(11)));
+                    else
+                        loop_items_.clear();
+                    number_of_loop_tags_++;
+                }
+                else
+                {
+                    if(in_loop_ && next_loop_tag_ != 0)
+                        throw CifFileProcessingException(line_number, "Incomplete row in a loop");
+                    in_loop_ = false;
+                    pending_tag_.assign(token.data(), token.size());
+                }
+            }
+            else
+                ProcessValue(token);
+        }
+    }
+    if(in_loop_ && next_loop_tag_ != 0)
+        throw CifFileProcessingException(line_number, "Incomplete row in a loop");
+    GMML_COUNT("cif atoms read", atom_site_.GetNumberOfRows());
+}
+
+bool CifFile::NextToken(string_view line, size_t& position, string_view& token, bool& quoted)
+{
+    while(position < line.size() && IsBlank(line[position]))
+        position++;
+    if(position >= line.size() || line[position] == '#')
+    {
+        position = line.size();
+        return false;
+    }
+    char quote = line[position];
+    if(quote == '\'' || quote == '"')
+    {
+        /// A quoted value ends at the first matching quote followed by whitespace, so "C1'" and 'N,N' are single values
+        size_t end = position + 1;
+        while(end < line.size() && !(line[end] == quote && (end + 1 == line.size() || IsBlank(line[end + 1]))))
+            end++;
+        if(end < line.size())
+        {
+            token = line.substr(position + 1, end - position - 1);
+            position = end + 1;
+            quoted = true;
+            return true;
+        }
+    }
+    size_t end = position;
+    while(end < line.size() && !IsBlank(line[end]))
+        end++;
+    token = line.substr(position, end - position);
+    position = end;
+    quoted = false;
+    return true;
+}
+
+void CifFile::ProcessValue(string_view value)
+{
+    if(in_loop_)
+    {
+        if(in_loop_header_)
+        {
+            in_loop_header_ = false;
+            if(number_of_loop_tags_ == 0)
+                throw CifFileProcessingException("Loop without tags");
+            if(loop_items_.size() != number_of_loop_tags_)
+                loop_items_.clear();
+        }
+        if(!loop_items_.empty())
+        {
+            if(next_loop_tag_ == 0)
+                atom_site_.AddRow();
+            atom_site_.SetValue(loop_items_[next_loop_tag_], value);
+        }
+        next_loop_tag_ = (next_loop_tag_ + 1) % number_of_loop_tags_;
+    }
+    else if(!pending_tag_.empty())
+    {
+        const char* cell_tags[6] = {"_cell.length_a", "_cell.length_b", "_cell.length_c", "_cell.angle_alpha", "_cell.angle_beta", "_cell.angle_gamma"};
+        for(int i = 0; i < 6; i++)
+        {
+            if(pending_tag_.compare(cell_tags[i]) == 0 && !(value == "?" || value == "."))
+                cell_[i] = ParseValue<double>(value);
+        }
+        if((pending_tag_.compare("_symmetry.space_group_name_H-M") == 0 || pending_tag_.compare("_space_group.name_H-M_alt") == 0) &&
+                !(value == "?" || value == "."))
+            space_group_.assign(value.data(), value.size());
+        pending_tag_.clear();
+    }
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void CifFile::Print(ostream &out)
+{
+    out << "data_" << data_block_name_ << endl;
+    atom_site_.Print(out);
+}
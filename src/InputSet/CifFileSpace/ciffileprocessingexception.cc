@@ -0,0 +1,36 @@
+#include <string>
+
+#include "../../../includes/common.hpp"
+#include "../../../includes/utils.hpp"
+#include "../../../includes/InputSet/CifFileSpace/ciffileprocessingexception.hpp"
+
+using namespace gmml;
+using namespace CifFileSpace;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+CifFileProcessingException::CifFileProcessingException(const std::string &message)
+    : line_number_(dNotSet), message_(message), what_("CifFile: " + message) {}
+
+/// The explanation is built here since what() must not throw
+CifFileProcessingException::CifFileProcessingException(int line_number, const std::string &message)
+    : line_number_(line_number), message_(message), what_("CifFile: " + message)
+{
+    if(line_number_ != dNotSet)
+        what_ += " (line " + std::to_string(line_number_) + ")";
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+/// Exception handler for cif file exceptions
+const char* CifFileProcessingException::what() const throw()
+{
+    gmml::log(__LINE__, __FILE__, gmml::ERR, what_.c_str());
+    return what_.c_str();
+}
+
+CifFileProcessingException::~CifFileProcessingException() throw() {}
+
+
@@ -4,6 +4,7 @@
 #include <boost/foreach.hpp>
 
 #include "../../../includes/utils.hpp"
+#include "../../../includes/inputfilestream.hpp"
 #include "../../../includes/InputSet/CoordinateFileSpace/coordinatefile.hpp"
 #include "../../../includes/InputSet/CoordinateFileSpace/coordinatefileprocessingexception.hpp"
 
@@ -18,18 +19,21 @@ using namespace gmml;
 CoordinateFile::CoordinateFile()
 {
     path_ = "GMML-Generated";
+    box_ = UnitCell();
 }
 
 CoordinateFile::CoordinateFile(const string &crd_file)
 {
     path_ = crd_file;
-    std::ifstream in_file;        
+    box_ = UnitCell();
+    gmml::InputFileStream in_file;        
     if(std::ifstream(crd_file.c_str()))
         in_file.open(crd_file.c_str());
     else
     {
         throw CoordinateFileProcessingException(__LINE__, "Coordinate file not found");
     }
+    gmml::MemoryArenaScope arena_scope(&arena_);
     Read(in_file);
     in_file.close();            /// Close the parameter files
 }
@@ -71,6 +75,19 @@ const std::vector<GeometryTopology::Coordinate*> CoordinateFile::GetCoordinates(
     return coordinates_;
 }
 
+/// Return the periodic box given at the end of the coordinate file
+GeometryTopology::UnitCell* CoordinateFile::GetBox()
+{
+    if(box_.IsSet())
+        return &box_;
+    return NULL;
+}
+
+gmml::MemoryArena* CoordinateFile::GetArena()
+{
+    return &arena_;
+}
+
 //////////////////////////////////////////////////////////
 //                           MUTATOR                    //
 //////////////////////////////////////////////////////////
@@ -108,10 +125,19 @@ void CoordinateFile::AddCoordinate(GeometryTopology::Coordinate* coordinate)
     coordinates_.push_back(coordinate);
 }
 
+/// Set the periodic box of the coordinate file
+void CoordinateFile::SetBox(GeometryTopology::UnitCell* box)
+{
+    if(box != NULL)
+        box_ = *box;
+    else
+        box_ = UnitCell();
+}
+
 //////////////////////////////////////////////////////////
 //                         FUNCTIONS                    //
 //////////////////////////////////////////////////////////
-void CoordinateFile::Read(std::ifstream& in_file)
+void CoordinateFile::Read(std::istream& in_file)
 {
     string line;
 
@@ -126,36 +152,75 @@ void CoordinateFile::Read(std::ifstream& in_file)
 
     /// Extract the number of coordinates in the file
     getline(in_file, line);                         /// Read the next line
-    int number_of_coordinates;
-    stringstream ss(line);                          /// Create a stream from the read line
-    ss >> number_of_coordinates;
-    number_of_coordinates_ = number_of_coordinates; /// Set the number of coordinates attribute
+    number_of_coordinates_ = ParseValue<int>(line); /// Set the number of coordinates attribute
 
+    vector<string_view> vectorTokens = vector<string_view>();
     getline(in_file, line);                         /// Read the next line
-    while(!Trim(line).empty())                      /// Read until the end of the file
+    while(!Trim(line).empty())                      /// Read until all the coordinates have been read
     {
         // Tokenizing the read line
-        boost::char_separator<char> separator(" ");
-        boost::tokenizer< boost::char_separator<char> > tokens(line, separator);
-        vector<string> vectorTokens = vector<string>();
-        vectorTokens.assign(tokens.begin(), tokens.end());
+        SplitInto(line, " ", vectorTokens);
         switch(vectorTokens.size())
         {
             /// One coordinate in the read line
             case 3:
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(0)), ConvertString<double>(vectorTokens.at(1)),
-                                                      ConvertString<double>(vectorTokens.at(2))));
+                coordinates_.push_back(new Coordinate(ParseValue<double>(vectorTokens[0]), ParseValue<double>(vectorTokens[1]),
+                                                      ParseValue<double>(vectorTokens[2])));
                 break;
             /// Two coordinates in the read line
             case 6:
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(0)), ConvertString<double>(vectorTokens.at(1)),
-                                                      ConvertString<double>(vectorTokens.at(2))));
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(3)), ConvertString<double>(vectorTokens.at(4)),
-                                                      ConvertString<double>(vectorTokens.at(5))));
+                coordinates_.push_back(new Coordinate(ParseValue<double>(vectorTokens[0]), ParseValue<double>(vectorTokens[1]),
+                                                      ParseValue<double>(vectorTokens[2])));
+                coordinates_.push_back(new Coordinate(ParseValue<double>(vectorTokens[3]), ParseValue<double>(vectorTokens[4]),
+                                                      ParseValue<double>(vectorTokens[5])));
                 break;
         }
+        if((int)coordinates_.size() >= number_of_coordinates_)
+            break;
         getline(in_file, line);
     }
+
+    /// A restart file may continue with a velocity block (same layout as the coordinates) and a box line
+    vector<string> remaining_lines = vector<string>();
+    while(getline(in_file, line))
+    {
+        if(!Trim(line).empty())
+            remaining_lines.push_back(line);
+    }
+    int velocity_lines = (number_of_coordinates_ + 1) / 2;
+    vector<string_view> box_tokens = vector<string_view>();
+    if(!remaining_lines.empty())
+        SplitInto(remaining_lines.back(), " ", box_tokens);
+    bool box_line = false;
+    if((int)remaining_lines.size() == velocity_lines + 1)
+        box_line = true;
+    else if(remaining_lines.size() == 1 && velocity_lines != 1)
+        box_line = true;
+    /// For one or two atoms a single line is either the velocities or the box; the velocities of one atom have 3 values, and a
+    /// 6 value line of two atoms is taken as the box when it has positive lengths and angles a box can have
+    else if(remaining_lines.size() == 1 && box_tokens.size() == 6)
+    {
+        if(number_of_coordinates_ == 1)
+            box_line = true;
+        else
+        {
+            box_line = true;
+            for(unsigned int i = 0; i < 6; i++)
+            {
+                double value = ParseValue<double>(box_tokens[i]);
+                if((i < 3 && value <= 0.0) || (i >= 3 && (value < 30.0 || value > 150.0)))
+                    box_line = false;
+            }
+        }
+    }
+    if(box_line)
+    {
+        if(box_tokens.size() == 6)
+            box_ = UnitCell(ParseValue<double>(box_tokens[0]), ParseValue<double>(box_tokens[1]), ParseValue<double>(box_tokens[2]),
+                            ParseValue<double>(box_tokens[3]), ParseValue<double>(box_tokens[4]), ParseValue<double>(box_tokens[5]));
+        else if(box_tokens.size() == 3)
+            box_ = UnitCell(ParseValue<double>(box_tokens[0]), ParseValue<double>(box_tokens[1]), ParseValue<double>(box_tokens[2]));
+    }
     if((int)coordinates_.size() != number_of_coordinates_)
     {
         throw CoordinateFileProcessingException(__LINE__, "Corrupted file");
@@ -193,7 +258,19 @@ void CoordinateFile::BuildCoordinateFile(ofstream &stream)
         if(i%2 == 1)
             stream << endl;
     }
-    stream << endl;
+    if(box_.IsSet())
+    {
+        if(coordinates_.size()%2 == 1)
+            stream << endl;
+        stream << right << setw(12) << fixed << setprecision(7) << box_.GetA()
+               << right << setw(12) << fixed << setprecision(7) << box_.GetB()
+               << right << setw(12) << fixed << setprecision(7) << box_.GetC()
+               << right << setw(12) << fixed << setprecision(7) << box_.GetAlpha()
+               << right << setw(12) << fixed << setprecision(7) << box_.GetBeta()
+               << right << setw(12) << fixed << setprecision(7) << box_.GetGamma() << endl;
+    }
+    else
+        stream << endl;
 }
 
 //////////////////////////////////////////////////////////
@@ -14,137 +14,39 @@ PdbAtom::PdbAtom():atom_orthogonal_coordinate_() {}
 
 PdbAtom::PdbAtom(string &line)
 {
-    string temp = line.substr(6, 5);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_serial_number_ =  iNotSet;
-    }
-    else
-    {
-        atom_serial_number_ = ConvertString<int>(temp);
-    }
+    atom_serial_number_ = ColumnValue<int>(line, 6, 5, iNotSet);
 
-    atom_name_ = line.substr(12, 4);
-    Trim(atom_name_);
+    atom_name_ = string(TrimmedColumn(line, 12, 4));
 
-    temp = line.substr(16,1);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_alternate_location_ = BLANK_SPACE;
-    }
-    else
-    {
-        atom_alternate_location_ = ConvertString<char>(temp);
-    }
+    atom_alternate_location_ = ColumnValue<char>(line, 16, 1, BLANK_SPACE);
 
-    temp = line.substr(17,3);
-    temp = Trim(temp);
+    string_view temp = TrimmedColumn(line, 17, 3);
     if(temp.empty())
     {
         atom_residue_name_ = " ";
     }
     else
     {
-        atom_residue_name_ = temp;
+        atom_residue_name_ = string(temp);
     }
 
-    temp = line.substr(21,1);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_chain_id_ = BLANK_SPACE;
-    }
-    else
-    {
-        atom_chain_id_ = ConvertString<char>(temp);
-    }
-
-    temp = line.substr(22,4);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_residue_sequence_number_ = iNotSet;
-    }
-    else
-    {
-        atom_residue_sequence_number_ = ConvertString<int>(temp);
-    }
+    atom_chain_id_ = ColumnValue<char>(line, 21, 1, BLANK_SPACE);
 
-    temp = line.substr(26,1);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_insertion_code_ = BLANK_SPACE;
-    }
-    else
-    {
-        atom_insertion_code_ = ConvertString<char>(temp);
-    }
-
-    temp = line.substr(30, 8);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_orthogonal_coordinate_.SetX(dNotSet);
-    }
-    else
-    {
-        atom_orthogonal_coordinate_.SetX(ConvertString<double>(temp));
-    }
+    atom_residue_sequence_number_ = ColumnValue<int>(line, 22, 4, iNotSet);
 
-    temp = line.substr(38,8);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_orthogonal_coordinate_.SetY(dNotSet);
-    }
-    else
-    {
-        atom_orthogonal_coordinate_.SetY( ConvertString<double>(line.substr(38,8)));
-    }
+    atom_insertion_code_ = ColumnValue<char>(line, 26, 1, BLANK_SPACE);
 
-    temp = line.substr(46,8);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_orthogonal_coordinate_.SetZ(dNotSet);
-    }
-    else
-    {
-        atom_orthogonal_coordinate_.SetZ( ConvertString<double>(temp));
-    }
+    atom_orthogonal_coordinate_.SetX(ColumnValue<double>(line, 30, 8, dNotSet));
+    atom_orthogonal_coordinate_.SetY(ColumnValue<double>(line, 38, 8, dNotSet));
+    atom_orthogonal_coordinate_.SetZ(ColumnValue<double>(line, 46, 8, dNotSet));
 
-    temp = line.substr(54, 6);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_occupancy_ = dNotSet;
-    }
-    else
-    {
-        atom_occupancy_ = ConvertString<double>(temp);
-    }
+    atom_occupancy_ = ColumnValue<double>(line, 54, 6, dNotSet);
 
-    temp = line.substr(60, 6);
-    temp = Trim(temp);
-    if(temp.empty())
-    {
-        atom_temperature_factor_ = dNotSet;
-    }
-    else
-    {
-        atom_temperature_factor_ = ConvertString<double>(temp);
-    }
+    atom_temperature_factor_ = ColumnValue<double>(line, 60, 6, dNotSet);
 
-    temp = line.substr(76, 2);
-    temp = Trim(temp);
-    atom_element_symbol_ = temp;
+    atom_element_symbol_ = string(TrimmedColumn(line, 76, 2));
 
-    temp = line.substr(78, 2);
-    temp = Trim(temp);
-    atom_charge_ = temp;
+    atom_charge_ = string(TrimmedColumn(line, 78, 2));
 }
 PdbAtom::PdbAtom(char residue_chain_id, string atom_name, string residue_name, int residue_sequence_number, char residue_insertion_code, char atom_alternate_location) :
     atom_chain_id_(residue_chain_id), atom_name_(atom_name), atom_residue_name_(residue_name), atom_residue_sequence_number_(residue_sequence_number),
@@ -192,6 +94,10 @@ GeometryTopology::Coordinate PdbAtom::GetAtomOrthogonalCoordinate(){
     return atom_orthogonal_coordinate_;
 }
 
+const vector<GeometryTopology::Coordinate>& PdbAtom::GetAtomModelCoordinates(){
+    return atom_model_coordinates_;
+}
+
 double PdbAtom::GetAtomOccupancy(){
     return atom_occupancy_;
 }
@@ -247,6 +153,10 @@ void PdbAtom::SetAtomOrthogonalCoordinate(GeometryTopology::Coordinate atom_orth
     atom_orthogonal_coordinate_ = atom_orthogonal_coordinate;
 }
 
+void PdbAtom::AddAtomModelCoordinate(const GeometryTopology::Coordinate& atom_model_coordinate){
+    atom_model_coordinates_.push_back(atom_model_coordinate);
+}
+
 void PdbAtom::SetAtomOccupancy(double atom_occupancy){
     atom_occupancy_ = atom_occupancy;
 }
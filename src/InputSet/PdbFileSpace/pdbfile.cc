@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <exception>
 #include <cctype>
+#include <pthread.h>
 
 #include "../../../includes/InputSet/PdbFileSpace/pdbfile.hpp"
 #include "../../../includes/InputSet/PdbFileSpace/pdbheadercard.hpp"
@@ -60,12 +61,133 @@
 #include "../../../includes/InputSet/PdbFileSpace/pdbfileprocessingexception.hpp"
 #include "../../../includes/InputSet/PdbFileSpace/pdbresidue.hpp"
 #include "../../../includes/utils.hpp"
+#include "../../../includes/textparsing.hpp"
+#include "../../../includes/inputfilestream.hpp"
+#include "../../../includes/instrumentation.hpp"
 #include "../../../includes/common.hpp"
 
 using namespace std;
 using namespace PdbFileSpace;
 using namespace gmml;
 
+/*! \struct
+  * Lines of one model of the model card and what the threads of ParseModelCardConcurrently get out of them
+  */
+struct PdbModelBlock
+{
+        string lines;                                           /*!< MODEL, ATOM, ANISOU, TER, HETATM and ENDMDL lines of the model >*/
+        int serial_number;                                      /*!< Serial number of the MODEL record, 1 without a MODEL record >*/
+        string atoms;                                           /*!< Record name, serial number, name and residue of every atom and every TER, in file order >*/
+        vector<int> atom_serial_numbers;                        /*!< Serial numbers of the atoms in file order >*/
+        vector<GeometryTopology::Coordinate> coordinates;       /*!< Coordinates of the atoms in file order >*/
+        bool parse;                                             /*!< Set if the model is parsed into a PdbModel >*/
+        PdbModel* model;                                        /*!< The parsed model >*/
+        MemoryArena* arena;                                     /*!< Storage of the parsed model until the file absorbs it >*/
+};
+
+/*! \struct
+  * Argument of the threads of ParseModelCardConcurrently; thread i handles the models i, i + n, i + 2n ...
+  */
+struct PdbModelBlocksArgument
+{
+        vector<PdbModelBlock>* blocks;
+        size_t first_block;
+        size_t stride;
+        bool parse;                                             /*!< False to scan the atoms of the models, true to parse the models that are marked >*/
+};
+
+static void ScanPdbModelBlock(PdbModelBlock& block)
+{
+    string_view lines = block.lines;
+    size_t start = 0;
+    while(start < lines.size())
+    {
+        size_t end = lines.find('\n', start);
+        if(end == string_view::npos)
+            end = lines.size();
+        string_view line = lines.substr(start, end - start);
+        start = end + 1;
+        string_view record_name = TrimmedColumn(line, 0, 6);
+        if(record_name == "ATOM" || record_name == "HETATM")
+        {
+            /// Columns 1 to 27 identify the atom: record name, serial number, name, alternate location, residue, chain and insertion code
+            block.atoms.append(Column(line, 0, 27));
+            block.atoms += '\n';
+            block.atom_serial_numbers.push_back(ColumnValue<int>(line, 6, 5, iNotSet));
+            block.coordinates.push_back(GeometryTopology::Coordinate(ColumnValue<double>(line, 30, 8, dNotSet),
+                                                                     ColumnValue<double>(line, 38, 8, dNotSet),
+                                                                     ColumnValue<double>(line, 46, 8, dNotSet)));
+        }
+        else if(record_name == "TER")
+            block.atoms += "TER\n";
+        else if(record_name == "MODEL")
+            block.serial_number = ColumnValue<int>(line, 10, 4, iNotSet);
+    }
+}
+
+static void* ParsePdbModelBlocksThread(void* argument)
+{
+    PdbModelBlocksArgument* blocks_argument = (PdbModelBlocksArgument*)argument;
+    vector<PdbModelBlock>& blocks = *blocks_argument->blocks;
+    for(size_t i = blocks_argument->first_block; i < blocks.size(); i += blocks_argument->stride)
+    {
+        if(!blocks_argument->parse)
+            ScanPdbModelBlock(blocks[i]);
+        else if(blocks[i].parse)
+        {
+            /// Every model gets an arena of its own, the arena of the file is only touched by the thread that reads the file
+            blocks[i].arena = new MemoryArena();
+            MemoryArenaScope arena_scope(blocks[i].arena);
+            stringstream model_block(blocks[i].lines);
+            blocks[i].model = new PdbModel(model_block);
+        }
+    }
+    return NULL;
+}
+
+static void RunPdbModelBlocksThreads(vector<PdbModelBlock>& blocks, size_t number_of_threads, bool parse)
+{
+    if(number_of_threads > blocks.size())
+        number_of_threads = blocks.size();
+    vector<PdbModelBlocksArgument> arguments = vector<PdbModelBlocksArgument>(number_of_threads);
+    for(size_t i = 0; i < number_of_threads; i++)
+    {
+        arguments[i].blocks = &blocks;
+        arguments[i].first_block = i;
+        arguments[i].stride = number_of_threads;
+        arguments[i].parse = parse;
+    }
+    if(number_of_threads == 1)
+        ParsePdbModelBlocksThread(&arguments[0]);
+    else
+    {
+        /// The models of a thread that cannot be started are handled by this thread, only the started threads are joined
+        vector<pthread_t> threads = vector<pthread_t>(number_of_threads);
+        vector<bool> started = vector<bool>(number_of_threads, false);
+        for(size_t i = 0; i < number_of_threads; i++)
+        {
+            started[i] = (pthread_create(&threads[i], NULL, &ParsePdbModelBlocksThread, &arguments[i]) == 0);
+            if(!started[i])
+                ParsePdbModelBlocksThread(&arguments[i]);
+        }
+        for(size_t i = 0; i < number_of_threads; i++)
+        {
+            if(started[i])
+                pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+/// Coordinate of an atom of the first model in the merged model of the given index, see PdbAtom::GetAtomModelCoordinates; -1 stands for
+/// the first model itself, and an atom without a coordinate in the merged model keeps the one of the first model
+static GeometryTopology::Coordinate GetPdbAtomModelCoordinate(PdbAtom* atom, int merged_model)
+{
+    const vector<GeometryTopology::Coordinate>& model_coordinates = atom->GetAtomModelCoordinates();
+    if(merged_model >= 0 && merged_model < (int)model_coordinates.size())
+        return model_coordinates.at(merged_model);
+    return atom->GetAtomOrthogonalCoordinate();
+}
+
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
@@ -96,10 +218,12 @@ PdbFile::PdbFile()
     connectivities_ = NULL;
     serial_number_mapping_ = PdbFile::PdbSerialNumberMapping();
     sequence_number_mapping_ = PdbFile::PdbSequenceNumberMapping();
+    number_of_model_threads_ = 0;
 }
 
-PdbFile::PdbFile(const std::string &pdb_file)
+PdbFile::PdbFile(const std::string &pdb_file, int number_of_model_threads)
 {
+    GMML_SCOPED_TIMER("PdbFile::PdbFile");
     path_ = pdb_file;
     header_ = NULL;
     title_ = NULL;
@@ -125,12 +249,12 @@ PdbFile::PdbFile(const std::string &pdb_file)
     connectivities_ = NULL;
     serial_number_mapping_ = PdbFile::PdbSerialNumberMapping();
     sequence_number_mapping_ = PdbFile::PdbSequenceNumberMapping();
+    number_of_model_threads_ = number_of_model_threads;
 
-    std::ifstream in_file;
+    gmml::InputFileStream in_file;
     if(std::ifstream(pdb_file.c_str()))
     {
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Opening PDB file ...");
-        cout << "Opening PDB file ..." << endl;
         in_file.open(pdb_file.c_str());
     }
     else
@@ -149,13 +273,25 @@ PdbFile::PdbFile(const std::string &pdb_file)
         {
             temp = line.substr(0,6);
             temp = Trim(temp);
-            if(temp.find("END") != string::npos || temp.compare("END") == 0)
-                break;            
+            /// Without model threads ENDMDL ends the file as well, so only the first model of a file with several models is read
+            if(temp.compare("END") == 0 || (temp.find("END") != string::npos && number_of_model_threads_ == 0))
+                break;
             else if(!line.empty())
                 ss << line << endl;
         }
     }
+    bool compressed = in_file.IsCompressed();
     in_file.close();
+    if(compressed)
+    {
+        /// A compressed file is not rewritten with its END card like a plain file, the cleaned up lines are read from memory
+        ss << "END";
+        if(!Read(ss))
+        {
+            throw PdbFileProcessingException(__LINE__, "Reading PDB file exception");
+        }
+        return;
+    }
     if(temp.find("END") == string::npos || temp.compare("END") != 0)
     {
         std::ofstream out_file;
@@ -196,6 +332,11 @@ string PdbFile::GetPath()
     return path_;
 }
 
+gmml::MemoryArena* PdbFile::GetArena()
+{
+    return &arena_;
+}
+
 PdbHeaderCard* PdbFile::GetHeader()
 {
     return header_;
@@ -680,7 +821,7 @@ PdbFile::PdbResidueAtomsMap PdbFile::GetAllAtomsInOrder(vector<string>& key_orde
     return residue_atom_map;
 }
 
-PdbFileSpace::PdbAtom* PdbFile::GetAtomOfResidueByName(PdbResidue *residue, string atom_name, PdbFile::PdbResidueAtomsMap residue_atom_map)
+PdbFileSpace::PdbAtom* PdbFile::GetAtomOfResidueByName(PdbResidue *residue, string atom_name, PdbFile::PdbResidueAtomsMap& residue_atom_map)
 {
     string target_residue_name = residue->GetResidueName();
     char target_residue_chain_id = residue->GetResidueChainId();
@@ -690,8 +831,11 @@ PdbFileSpace::PdbAtom* PdbFile::GetAtomOfResidueByName(PdbResidue *residue, stri
     stringstream ss;
     ss << target_residue_name << "_" << target_residue_chain_id << "_" << target_residue_sequence_number << "_" << target_residue_insertion_code << "_" << target_residue_alternate_location;
     string target_key = ss.str();
-    PdbAtomVector* atoms = residue_atom_map[target_key];
-    
+    PdbResidueAtomsMap::iterator residue_atoms = residue_atom_map.find(target_key);
+    if(residue_atoms == residue_atom_map.end() || (*residue_atoms).second == NULL)
+        return NULL;
+    PdbAtomVector* atoms = (*residue_atoms).second;
+
     for(PdbAtomVector::iterator it = atoms->begin(); it != atoms->end(); it++)
     {
         PdbAtom* atom = (*it);
@@ -2855,13 +2999,15 @@ void PdbFile::UpdateConnectCard()
 //////////////////////////////////////////////////////////
 //                        FUNCTIONS                     //
 //////////////////////////////////////////////////////////
-bool PdbFile::Read(ifstream &in_file)
+bool PdbFile::Read(istream &in_file)
 {
+    gmml::MemoryArenaScope arena_scope(&arena_);
     if(!this->ParseCards(in_file))
         return false;
+    return true;
 }
 
-bool PdbFile::ParseCards(ifstream &in_stream)
+bool PdbFile::ParseCards(istream &in_stream)
 {
     string line;
     
@@ -2869,11 +3015,10 @@ bool PdbFile::ParseCards(ifstream &in_stream)
     if (!getline(in_stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-        cout << "Wrong input file format" << endl;
         throw PdbFileProcessingException("Error reading file");
     }
 
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     if(record_name.compare("HEADER") == 0)
@@ -3132,7 +3277,6 @@ bool PdbFile::ParseCards(ifstream &in_stream)
     if(record_name.compare("MODEL") == 0)
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Multiple connect card between model cards --> Unexpected entry");
-        cout << "Multiple connect card between model cards --> Unexpected entry" << endl;
         return false;
     }
     if(record_name.compare("MASTER") == 0)
@@ -3151,25 +3295,22 @@ bool PdbFile::ParseCards(ifstream &in_stream)
     else
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
     return true;
 }
 
-bool PdbFile::ParseHeaderCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseHeaderCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Header card corupption");
-        cout << "Header card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3178,16 +3319,14 @@ bool PdbFile::ParseHeaderCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Header card corruption");
-            cout << "Header card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3196,19 +3335,17 @@ bool PdbFile::ParseHeaderCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseObsoleteCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseObsoleteCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Obsolete card corruption");
-        cout << "Obsolete card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3217,35 +3354,31 @@ bool PdbFile::ParseObsoleteCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-        line = ExpandLine(line, iPdbLineLength);
+        PadLine(line, iPdbLineLength);
         record_name = line.substr(0,6);
         record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Obsolete card corruption");
-            cout << "Obsolete card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseTitleCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseTitleCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Title card corruption");
-        cout << "Title card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3254,16 +3387,14 @@ bool PdbFile::ParseTitleCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Title card corruption");
-            cout << "Title card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format");
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3272,19 +3403,17 @@ bool PdbFile::ParseTitleCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseSplitCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSplitCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Split card corruption" );
-        cout << "Split card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3293,35 +3422,31 @@ bool PdbFile::ParseSplitCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Split card corruption" );
-            cout << "Split card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseCaveatCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseCaveatCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Caveat card corruption" );
-        cout << "Caveat card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3330,35 +3455,31 @@ bool PdbFile::ParseCaveatCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Caveat card corruption" );
-            cout << "Caveat card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseCompoundCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseCompoundCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Compound card corruption" );
-        cout << "Compound card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3367,16 +3488,14 @@ bool PdbFile::ParseCompoundCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Compound card corruption" );
-            cout << "Compound card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3385,19 +3504,17 @@ bool PdbFile::ParseCompoundCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseSourceCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSourceCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Source card corruption" );
-        cout << "Source card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3406,35 +3523,31 @@ bool PdbFile::ParseSourceCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Source card corruption" );
-            cout << "Source card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseKeywordCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseKeywordCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Keyword card corruption" );
-        cout << "Keyword card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3443,35 +3556,31 @@ bool PdbFile::ParseKeywordCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Keyword card corruption" );
-            cout << "Keyword card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseExpirationDateCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseExpirationDateCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Expiration date card corruption" );
-        cout << "Expiration date card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3480,35 +3589,31 @@ bool PdbFile::ParseExpirationDateCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Expiration date card corruption" );
-            cout << "Expiration date card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseNumModelCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseNumModelCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Number of model card corruption" );
-        cout << "Number of model card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3517,16 +3622,14 @@ bool PdbFile::ParseNumModelCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Number of model card corruption" );
-            cout << "Number of model card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3535,19 +3638,17 @@ bool PdbFile::ParseNumModelCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseModelTypeCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseModelTypeCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Model type card corruption" );
-        cout << "Model type card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3556,16 +3657,14 @@ bool PdbFile::ParseModelTypeCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Model type card corruption" );
-            cout << "Model type card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3574,19 +3673,17 @@ bool PdbFile::ParseModelTypeCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseAuthorCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseAuthorCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Author card corruption" );
-        cout << "Author card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3595,35 +3692,31 @@ bool PdbFile::ParseAuthorCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Author card corruption" );
-            cout << "Author card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseRevisionDateCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseRevisionDateCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Revision date card corruption" );
-        cout << "Revision date card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3632,35 +3725,31 @@ bool PdbFile::ParseRevisionDateCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Revision date card corruption" );
-            cout << "Revision date card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseSupersededEntriesCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSupersededEntriesCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Superseded entries card corruption" );
-        cout << "Superseded entries card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3669,35 +3758,31 @@ bool PdbFile::ParseSupersededEntriesCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Superseded entries card corruption" );
-            cout << "Superseded entries card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseJournalCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseJournalCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Journal card corruption" );
-        cout << "Journal card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3706,35 +3791,31 @@ bool PdbFile::ParseJournalCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Journal card corruption" );
-            cout << "Journal card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseRemarkCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseRemarkCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Remark card corruption" );
-        cout << "Remark card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3743,35 +3824,31 @@ bool PdbFile::ParseRemarkCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Remark card corruption" );
-            cout << "Remark card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseDatabaseReferenceCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseDatabaseReferenceCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "database reference card corruption" );
-        cout << "database reference card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3780,35 +3857,31 @@ bool PdbFile::ParseDatabaseReferenceCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "database reference card corruption" );
-            cout << "database reference card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseSequenceAdvancedCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSequenceAdvancedCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sequence advanced card corruption" );
-        cout << "Sequence advanced card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3817,35 +3890,31 @@ bool PdbFile::ParseSequenceAdvancedCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sequence advanced card corruption" );
-            cout << "Sequence advanced card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseSequenceResidueCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSequenceResidueCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sequence residue card corruption" );
-        cout << "Sequence residue card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3854,16 +3923,14 @@ bool PdbFile::ParseSequenceResidueCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sequence residue card corruption" );
-            cout << "Sequence residue card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3872,19 +3939,17 @@ bool PdbFile::ParseSequenceResidueCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseModificationResidueCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseModificationResidueCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Modification residue card corruption" );
-        cout << "Modification residue card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3893,16 +3958,14 @@ bool PdbFile::ParseModificationResidueCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Modification residue card corruption" );
-            cout << "Modification residue card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3911,19 +3974,17 @@ bool PdbFile::ParseModificationResidueCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseHeterogenCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseHeterogenCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen card corruption" );
-        cout << "Heterogen card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3932,16 +3993,14 @@ bool PdbFile::ParseHeterogenCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen card corruption" );
-            cout << "Heterogen card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3950,19 +4009,17 @@ bool PdbFile::ParseHeterogenCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseHeterogenNameCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseHeterogenNameCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen name card corruption" );
-        cout << "Heterogen name card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -3971,16 +4028,14 @@ bool PdbFile::ParseHeterogenNameCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen name card corruption" );
-            cout << "Heterogen name card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -3989,19 +4044,17 @@ bool PdbFile::ParseHeterogenNameCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseHeterogenSynonymCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseHeterogenSynonymCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen synonym card corruption" );
-        cout << "Heterogen synonym card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4010,16 +4063,14 @@ bool PdbFile::ParseHeterogenSynonymCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Heterogen synonym card corruption" );
-            cout << "Heterogen synonym card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4028,19 +4079,17 @@ bool PdbFile::ParseHeterogenSynonymCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseFormulaCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseFormulaCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Formula card corruption" );
-        cout << "Formula card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4049,16 +4098,14 @@ bool PdbFile::ParseFormulaCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Formula card corruption" );
-            cout << "Formula card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4067,19 +4114,17 @@ bool PdbFile::ParseFormulaCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseHelixCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseHelixCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Helix card corruption" );
-        cout << "Helix card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4088,16 +4133,14 @@ bool PdbFile::ParseHelixCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Helix card corruption" );
-            cout << "Helix card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4106,19 +4149,17 @@ bool PdbFile::ParseHelixCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseSheetCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSheetCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sheet card corruption" );
-        cout << "Sheet card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
 
@@ -4127,16 +4168,14 @@ bool PdbFile::ParseSheetCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Sheet card corruption" );
-            cout << "Sheet card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4145,19 +4184,17 @@ bool PdbFile::ParseSheetCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseDisulfideBondCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseDisulfideBondCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Disulfide bond card corruption" );
-        cout << "Disulfide bond card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4166,16 +4203,14 @@ bool PdbFile::ParseDisulfideBondCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Disulfide bond card corruption" );
-            cout << "Disulfide bond card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4184,19 +4219,17 @@ bool PdbFile::ParseDisulfideBondCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseLinkCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseLinkCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Link card corruption" );
-        cout << "Link card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4205,16 +4238,14 @@ bool PdbFile::ParseLinkCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Link card corruption" );
-            cout << "Link card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4223,19 +4254,17 @@ bool PdbFile::ParseLinkCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseCISPeptideCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseCISPeptideCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "CIS peptide card corruption" );
-        cout << "CIS peptide card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4244,35 +4273,31 @@ bool PdbFile::ParseCISPeptideCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "CIS peptide card corruption" );
-            cout << "CIS peptide card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseSiteCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseSiteCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Site card corruption" );
-        cout << "Site card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4281,16 +4306,14 @@ bool PdbFile::ParseSiteCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Site card corruption" );
-            cout << "Site card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4299,19 +4322,17 @@ bool PdbFile::ParseSiteCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseCrystallographyCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseCrystallographyCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Crystallography card corruption" );
-        cout << "Crystallography card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4320,16 +4341,14 @@ bool PdbFile::ParseCrystallographyCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Crystallography card corruption" );
-            cout << "Crystallography card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4338,19 +4357,17 @@ bool PdbFile::ParseCrystallographyCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseOriginCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseOriginCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Origin card corruption" );
-        cout << "Origin card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,5);
     record_name = Trim(record_name);
     
@@ -4359,16 +4376,14 @@ bool PdbFile::ParseOriginCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,5);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Origin card corruption" );
-            cout << "Origin card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4377,19 +4392,17 @@ bool PdbFile::ParseOriginCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseScaleCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseScaleCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Scale card corruption" );
-        cout << "Scale card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,5);
     record_name = Trim(record_name);
     
@@ -4398,16 +4411,14 @@ bool PdbFile::ParseScaleCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,5);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Scale card corruption" );
-            cout << "Scale card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4416,19 +4427,17 @@ bool PdbFile::ParseScaleCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseMatrixCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseMatrixCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Matrix card corruption" );
-        cout << "Matrix card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,5);
     record_name = Trim(record_name);
     
@@ -4437,16 +4446,14 @@ bool PdbFile::ParseMatrixCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,5);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Matrix card corruption" );
-            cout << "Matrix card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4455,19 +4462,19 @@ bool PdbFile::ParseMatrixCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseModelCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseModelCard(std::istream& stream, string& line)
 {
+    if(number_of_model_threads_ > 0)
+        return ParseModelCardConcurrently(stream, line);
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Model card corruption" );
-        cout << "Model card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
 
@@ -4478,16 +4485,14 @@ bool PdbFile::ParseModelCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Model card corruption" );
-            cout << "Model card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4498,19 +4503,127 @@ bool PdbFile::ParseModelCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseConnectivityCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseModelCardConcurrently(std::istream& stream, string& line)
+{
+    GMML_SCOPED_TIMER("PdbFile::ParseModelCardConcurrently");
+    vector<PdbModelBlock> blocks = vector<PdbModelBlock>();
+    string record_name = line.substr(0,6);
+    record_name = Trim(record_name);
+    while(record_name.compare("MODEL") == 0 || record_name.compare("ATOM") == 0 || record_name.compare("ANISOU") == 0
+          || record_name.compare("TER") == 0 || record_name.compare("HETATM") == 0 || record_name.compare("ENDMDL") == 0)
+    {
+        if(record_name.compare("MODEL") == 0 || blocks.empty())
+        {
+            PdbModelBlock block = PdbModelBlock();
+            block.serial_number = 1;
+            block.parse = false;
+            block.model = NULL;
+            block.arena = NULL;
+            blocks.push_back(block);
+        }
+        blocks.back().lines += line;
+        blocks.back().lines += '\n';
+        if(getline(stream, line))
+        {
+            PadLine(line, iPdbLineLength);
+            record_name = line.substr(0,6);
+            record_name = Trim(record_name);
+        }
+        else
+        {
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "Model card corruption" );
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
+            return false;
+        }
+    }
+
+    /// The model with the lowest serial number is the first model of the model map, which the atoms of an assembly are built from;
+    /// it is always parsed, another model only if its atoms are not the atoms of the first model
+    RunPdbModelBlocksThreads(blocks, number_of_model_threads_, false);
+    size_t first = 0;
+    for(size_t i = 1; i < blocks.size(); i++)
+    {
+        if(blocks[i].serial_number < blocks[first].serial_number)
+            first = i;
+    }
+    for(size_t i = 0; i < blocks.size(); i++)
+        blocks[i].parse = (i == first || blocks[i].atoms != blocks[first].atoms);
+    RunPdbModelBlocksThreads(blocks, number_of_model_threads_, true);
+
+    PdbModelCard::PdbModelMap models = PdbModelCard::PdbModelMap();
+    for(size_t i = 0; i < blocks.size(); i++)
+    {
+        if(!blocks[i].parse)
+            continue;
+        arena_.Absorb(*blocks[i].arena);
+        delete blocks[i].arena;
+        /// A later model with the serial number of an earlier one does not replace it, so the first model stays the first of the map
+        if(!models.insert(make_pair(blocks[i].model->GetModelSerialNumber(), blocks[i].model)).second)
+        {
+            stringstream ss;
+            ss << "Model " << blocks[i].model->GetModelSerialNumber() << " occurs more than once, only its first occurrence is kept";
+            gmml::log(__LINE__, __FILE__, gmml::WAR, ss.str());
+        }
+    }
+
+    /// Atoms of the first model in the order of its lines; a serial number that occurs twice only gets the coordinates of its first line
+    PdbAtomCard::PdbAtomMap first_model_atoms = PdbAtomCard::PdbAtomMap();
+    PdbModelResidueSet* residue_set = blocks[first].model->GetModelResidueSet();
+    PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
+    for(PdbModelResidueSet::AtomCardVector::iterator it = atom_cards.begin(); it != atom_cards.end(); it++)
+    {
+        PdbAtomCard::PdbAtomMap atoms = (*it)->GetAtoms();
+        first_model_atoms.insert(atoms.begin(), atoms.end());
+    }
+    PdbModelResidueSet::HeterogenAtomCardVector heterogen_atom_cards = residue_set->GetHeterogenAtoms();
+    for(PdbModelResidueSet::HeterogenAtomCardVector::iterator it = heterogen_atom_cards.begin(); it != heterogen_atom_cards.end(); it++)
+    {
+        PdbHeterogenAtomCard::PdbHeterogenAtomMap heterogen_atoms = (*it)->GetHeterogenAtoms();
+        first_model_atoms.insert(heterogen_atoms.begin(), heterogen_atoms.end());
+    }
+    vector<PdbAtom*> atoms_in_order = vector<PdbAtom*>(blocks[first].atom_serial_numbers.size(), (PdbAtom*)NULL);
+    for(size_t i = 0; i < atoms_in_order.size(); i++)
+    {
+        PdbAtomCard::PdbAtomMap::iterator atom = first_model_atoms.find(blocks[first].atom_serial_numbers[i]);
+        if(atom != first_model_atoms.end())
+        {
+            atoms_in_order[i] = atom->second;
+            first_model_atoms.erase(atom);
+        }
+    }
+    vector<int> merged_model_serial_numbers = vector<int>();
+    for(size_t i = 0; i < blocks.size(); i++)
+    {
+        if(blocks[i].parse)
+            continue;
+        for(size_t j = 0; j < atoms_in_order.size(); j++)
+        {
+            if(atoms_in_order[j] != NULL)
+                atoms_in_order[j]->AddAtomModelCoordinate(blocks[i].coordinates[j]);
+        }
+        merged_model_serial_numbers.push_back(blocks[i].serial_number);
+    }
+    GMML_COUNT("pdb models parsed", models.size());
+    GMML_COUNT("pdb models merged", merged_model_serial_numbers.size());
+
+    models_ = new PdbModelCard();
+    models_->SetRecordName("MODEL");
+    models_->SetModels(models);
+    models_->SetMergedModelSerialNumbers(merged_model_serial_numbers);
+    return true;
+}
+
+bool PdbFile::ParseConnectivityCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Connectivity card corruption" );
-        cout << "Connectivity card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4519,16 +4632,14 @@ bool PdbFile::ParseConnectivityCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Connectivity card corruption" );
-            cout << "Connectivity card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
@@ -4537,19 +4648,17 @@ bool PdbFile::ParseConnectivityCard(std::ifstream& stream, string& line)
     return true;
 }
 
-bool PdbFile::ParseMasterCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseMasterCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Master card corruption" );
-        cout << "Master card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-        cout << "Wrong input file format" << endl;
         return false;
     }
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     
@@ -4558,34 +4667,31 @@ bool PdbFile::ParseMasterCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Master card corruption" );
-            cout << "Master card corruption" << endl;
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "Wrong input file format" );
-            cout << "Wrong input file format" << endl;
             return false;
         }
     }
     return true;
 }
 
-bool PdbFile::ParseEndCard(std::ifstream& stream, string& line)
+bool PdbFile::ParseEndCard(std::istream& stream, string& line)
 {
     stringstream stream_block;
     stream_block << line << endl;
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::INF, "End of file" );
-        cout << "End of file" << endl;
         return true;
     }
 
-    line = ExpandLine(line, iPdbLineLength);
+    PadLine(line, iPdbLineLength);
     string record_name = line.substr(0,6);
     record_name = Trim(record_name);
     while(record_name.find("END") != string::npos || record_name.compare("END") == 0)
@@ -4593,7 +4699,7 @@ bool PdbFile::ParseEndCard(std::ifstream& stream, string& line)
         stream_block << line << endl;
         if(getline(stream, line))
         {
-            line = ExpandLine(line, iPdbLineLength);
+            PadLine(line, iPdbLineLength);
             record_name = line.substr(0,6);
             record_name = Trim(record_name);
         }
@@ -6311,7 +6417,8 @@ void PdbFile::ResolveMatrixCard(std::ofstream& stream)
 void PdbFile::ResolveModelCard(std::ofstream& stream)
 {
     PdbModelCard::PdbModelMap models = models_->GetModels();
-    int number_of_models = models.size();
+    vector<int> merged_model_serial_numbers = models_->GetMergedModelSerialNumbers();
+    int number_of_models = models.size() + merged_model_serial_numbers.size();
     if(number_of_models == 1)
     {
         for(PdbModelCard::PdbModelMap::iterator it = models.begin(); it != models.end(); it++)
@@ -6474,13 +6581,22 @@ void PdbFile::ResolveModelCard(std::ofstream& stream)
     }
     else
     {
+        /// Every model in the order of the serial numbers; a merged model is written with the atoms of the first model and its own coordinates
+        vector<pair<int, int> > model_order = vector<pair<int, int> >();
         for(PdbModelCard::PdbModelMap::iterator it = models.begin(); it != models.end(); it++)
-        {
-            PdbModel* model = (*it).second;
+            model_order.push_back(make_pair((*it).first, -1));
+        for(unsigned int i = 0; i < merged_model_serial_numbers.size(); i++)
+            model_order.push_back(make_pair(merged_model_serial_numbers.at(i), (int)i));
+        sort(model_order.begin(), model_order.end());
+        for(vector<pair<int, int> >::iterator it = model_order.begin(); it != model_order.end(); it++)
+        {
+            int model_serial_number = (*it).first;
+            int merged_model = (*it).second;
+            PdbModel* model = (merged_model < 0) ? models[model_serial_number] : (*models.begin()).second;
             stream << left << setw(6) << models_->GetRecordName()
                    << left << setw(4) << " ";
-            if(model->GetModelSerialNumber() != iNotSet)
-                stream << right << setw(4) << model->GetModelSerialNumber();
+            if(model_serial_number != iNotSet)
+                stream << right << setw(4) << model_serial_number;
             else
                 stream << right << setw(4) << " ";
             stream << left << setw(66) << " "
@@ -6526,10 +6642,11 @@ void PdbFile::ResolveModelCard(std::ofstream& stream)
                     else
                         stream << left << setw(1) << atom->GetAtomInsertionCode();
                     stream << left << setw(3) << " ";
-                    if(atom->GetAtomOrthogonalCoordinate().CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
-                        stream << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetX()
-                               << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetY()
-                               << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetZ();
+                    GeometryTopology::Coordinate coordinate = GetPdbAtomModelCoordinate(atom, merged_model);
+                    if(coordinate.CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
+                        stream << right << setw(8) << fixed << setprecision(3) << coordinate.GetX()
+                               << right << setw(8) << fixed << setprecision(3) << coordinate.GetY()
+                               << right << setw(8) << fixed << setprecision(3) << coordinate.GetZ();
                     else
                         stream << right << setw(8) << " "
                                << right << setw(8) << " "
@@ -6608,10 +6725,11 @@ void PdbFile::ResolveModelCard(std::ofstream& stream)
                     else
                         stream << left << setw(1) << heterogen_atom->GetAtomInsertionCode();
                     stream << left << setw(3) << " ";
-                    if(heterogen_atom->GetAtomOrthogonalCoordinate().CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
-                        stream << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetX()
-                               << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetY()
-                               << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetZ();
+                    GeometryTopology::Coordinate coordinate = GetPdbAtomModelCoordinate(heterogen_atom, merged_model);
+                    if(coordinate.CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
+                        stream << right << setw(8) << fixed << setprecision(3) << coordinate.GetX()
+                               << right << setw(8) << fixed << setprecision(3) << coordinate.GetY()
+                               << right << setw(8) << fixed << setprecision(3) << coordinate.GetZ();
                     else
                         stream << right << setw(8) << " "
                                << right << setw(8) << " "
@@ -6642,7 +6760,22 @@ void PdbFile::ResolveModelCardWithTheGivenModelNumber(std::ofstream& stream, int
     PdbModelCard::PdbModelMap models = models_->GetModels();
     if(models.size() != 0)
     {
-        PdbModel* model = models[model_number];
+        /// A merged model is written with the atoms of the first model and its own coordinates
+        vector<int> merged_model_serial_numbers = models_->GetMergedModelSerialNumbers();
+        int merged_model = -1;
+        if(models.find(model_number) == models.end())
+        {
+            vector<int>::iterator merged = find(merged_model_serial_numbers.begin(), merged_model_serial_numbers.end(), model_number);
+            if(merged == merged_model_serial_numbers.end())
+            {
+                stringstream ss;
+                ss << "Model " << model_number << " is not in the file";
+                gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
+                return;
+            }
+            merged_model = merged - merged_model_serial_numbers.begin();
+        }
+        PdbModel* model = (merged_model < 0) ? models[model_number] : (*models.begin()).second;
         PdbModelResidueSet* residue_set = model->GetModelResidueSet();
         PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
         for(PdbModelResidueSet::AtomCardVector::iterator it1 = atom_cards.begin(); it1 != atom_cards.end(); it1++)
@@ -6684,11 +6817,12 @@ void PdbFile::ResolveModelCardWithTheGivenModelNumber(std::ofstream& stream, int
                 else
                     stream << left << setw(1) << atom->GetAtomInsertionCode();
                 stream << left << setw(3) << " ";
-                if(atom->GetAtomOrthogonalCoordinate().CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
+                GeometryTopology::Coordinate coordinate = GetPdbAtomModelCoordinate(atom, merged_model);
+                if(coordinate.CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
                 {
-                    stream << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetX()
-                           << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetY()
-                           << right << setw(8) << fixed << setprecision(3) << atom->GetAtomOrthogonalCoordinate().GetZ();
+                    stream << right << setw(8) << fixed << setprecision(3) << coordinate.GetX()
+                           << right << setw(8) << fixed << setprecision(3) << coordinate.GetY()
+                           << right << setw(8) << fixed << setprecision(3) << coordinate.GetZ();
                 }
                 else
                 {
@@ -6770,11 +6904,12 @@ void PdbFile::ResolveModelCardWithTheGivenModelNumber(std::ofstream& stream, int
                 else
                     stream << left << setw(1) << heterogen_atom->GetAtomInsertionCode();
                 stream << left << setw(3) << " ";
-                if(heterogen_atom->GetAtomOrthogonalCoordinate().CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
+                GeometryTopology::Coordinate coordinate = GetPdbAtomModelCoordinate(heterogen_atom, merged_model);
+                if(coordinate.CompareTo(GeometryTopology::Coordinate(dNotSet, dNotSet, dNotSet)) == false)
                 {
-                    stream << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetX()
-                           << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetY()
-                           << right << setw(8) << fixed << setprecision(3) << heterogen_atom->GetAtomOrthogonalCoordinate().GetZ();
+                    stream << right << setw(8) << fixed << setprecision(3) << coordinate.GetX()
+                           << right << setw(8) << fixed << setprecision(3) << coordinate.GetY()
+                           << right << setw(8) << fixed << setprecision(3) << coordinate.GetZ();
                 }
                 else
                 {
@@ -72,6 +72,10 @@ PdbModelCard::PdbModelMap PdbModelCard::GetModels(){
     return models_;
 }
 
+vector<int> PdbModelCard::GetMergedModelSerialNumbers(){
+    return merged_model_serial_numbers_;
+}
+
 //////////////////////////////////////////////////////////
 //                       MUTATOR                        //
 //////////////////////////////////////////////////////////
@@ -84,6 +88,10 @@ void PdbModelCard::SetModels(PdbModelMap models){
     models_ = models;
 }
 
+void PdbModelCard::SetMergedModelSerialNumbers(vector<int> merged_model_serial_numbers){
+    merged_model_serial_numbers_ = merged_model_serial_numbers;
+}
+
 //////////////////////////////////////////////////////////
 //                        FUNCTIONS                     //
 //////////////////////////////////////////////////////////
@@ -36,7 +36,6 @@ PdbqtFile::PdbqtFile(const string &pdbqt_file)
     if(ifstream(pdbqt_file.c_str()))
     {
         gmml::log(__LINE__, __FILE__,  gmml::INF,"Opening PDBQT file ...");
-        cout << "Opening PDBQT file ..." << endl;
         in_file.open(pdbqt_file.c_str());
     }
     else
@@ -48,7 +47,6 @@ PdbqtFile::PdbqtFile(const string &pdbqt_file)
         throw PdbqtFileProcessingException(__LINE__, "Reading PDBQT file exception");
     }
     gmml::log(__LINE__, __FILE__,  gmml::INF,"End of file");
-    cout << "End of file" << endl;
     in_file.close();            /// Close the pdbqt files
 }
 
@@ -72,6 +70,11 @@ string PdbqtFile::GetPath()
     return path_;
 }
 
+gmml::MemoryArena* PdbqtFile::GetArena()
+{
+    return &arena_;
+}
+
 PdbqtModelCard* PdbqtFile::GetModels()
 {
     return models_;
@@ -127,8 +130,10 @@ void PdbqtFile::SetModels(PdbqtModelCard *models)
 //////////////////////////////////////////////////////////
 bool PdbqtFile::Read(ifstream &in_file)
 {
+    gmml::MemoryArenaScope arena_scope(&arena_);
     if(!this->ParseCards(in_file))
         return false;
+    return true;
 }
 
 bool PdbqtFile::ParseCards(ifstream &in_stream)
@@ -139,7 +144,6 @@ bool PdbqtFile::ParseCards(ifstream &in_stream)
     if (!getline(in_stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR,"Wrong input file format");
-        cout << "Wrong input file format" << endl;
         throw PdbqtFileProcessingException("Error reading file");
     }
     string record_name = Split(line, " ").at(0);
@@ -151,7 +155,6 @@ bool PdbqtFile::ParseCards(ifstream &in_stream)
     else
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR,"Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
     return true;
@@ -164,9 +167,7 @@ bool PdbqtFile::ParseModelCard(ifstream &stream, string &line)
     if(!getline(stream, line))
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR,"Model card corruption");
-        cout << "Model card corruption" << endl;
         gmml::log(__LINE__, __FILE__,  gmml::ERR,"Wrong input file format");
-        cout << "Wrong input file format" << endl;
         return false;
     }
     string record_name = Split(line, " ").at(0);
@@ -190,9 +191,7 @@ bool PdbqtFile::ParseModelCard(ifstream &stream, string &line)
             else
             {
                 gmml::log(__LINE__, __FILE__,  gmml::ERR,"Model card corruption");
-                cout << "Model card corruption" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR,"Wrong input file format");
-                cout << "Wrong input file format" << endl;
                 return false;
             }
         }
@@ -61,6 +61,10 @@ vector<string> TopologyAtom::GetExcludedAtoms()
 {
     return excluded_atoms_;
 }
+const vector<int>& TopologyAtom::GetExcludedAtomIndices()
+{
+    return excluded_atom_indices_;
+}
 double TopologyAtom::GetRadii()
 {
     return radii_;
@@ -121,6 +125,10 @@ void TopologyAtom::AddExcludedAtom(string excluded_atom)
 {
         excluded_atoms_.push_back(excluded_atom);
 }
+void TopologyAtom::SetExcludedAtomIndices(vector<int> excluded_atom_indices)
+{
+    excluded_atom_indices_ = excluded_atom_indices;
+}
 void TopologyAtom::SetRadii(double radii)
 {
     radii_ = radii;
@@ -17,6 +17,8 @@
 #include "../../../includes/InputSet/TopologyFileSpace/topologydihedral.hpp"
 #include "../../../includes/InputSet/TopologyFileSpace/topologyfileprocessingexception.hpp"
 #include "../../../includes/utils.hpp"
+#include "../../../includes/inputfilestream.hpp"
+#include "../../../includes/instrumentation.hpp"
 
 using namespace std;
 using namespace TopologyFileSpace;
@@ -74,8 +76,9 @@ TopologyFile::TopologyFile()
 
 TopologyFile::TopologyFile(const string &top_file)
 {
+    GMML_SCOPED_TIMER("TopologyFile::TopologyFile");
     path_ = top_file;
-    ifstream in_file;        
+    gmml::InputFileStream in_file;        
     if(std::ifstream(top_file.c_str()))
         in_file.open(top_file.c_str());
     else
@@ -93,6 +96,11 @@ string TopologyFile::GetPath()
 {
     return path_;
 }
+
+gmml::MemoryArena* TopologyFile::GetArena()
+{
+    return &arena_;
+}
 string TopologyFile::GetTitle()
 {
     return title_;
@@ -254,6 +262,10 @@ TopologyFile::TopologyBondMap TopologyFile::GetBonds()
 {
     return bonds_;
 }
+const vector<int>& TopologyFile::GetBondAtomIndices()
+{
+    return bond_atom_indices_;
+}
 TopologyFile::TopologyAngleMap TopologyFile::GetAngles()
 {
     return angles_;
@@ -600,12 +612,13 @@ void TopologyFile::AddAtomPair(TopologyAtomPair *pair)
 //////////////////////////////////////////////////////////
 //                        FUNCTIONS                     //
 //////////////////////////////////////////////////////////
-void TopologyFile::Read(ifstream &in_file)
+void TopologyFile::Read(istream &in_file)
 {
+    gmml::MemoryArenaScope arena_scope(&arena_);
     this->ParseSections(in_file);
 }
 
-void TopologyFile::ParseSections(ifstream &in_stream)
+void TopologyFile::ParseSections(istream &in_stream)
 {
     string line;
     /// Unable to read file
@@ -875,7 +888,6 @@ void TopologyFile::ParseSections(ifstream &in_stream)
     // Lennard Jones coefficients for atom pairs
     if(nonbonded_parm_indexes.size() != number_of_types_ * number_of_types_)
     {
-        cout << "Lennard Jones coefficients section of the file is not written properly. This section will be ignored!" << endl;
         gmml::log(__LINE__, __FILE__, gmml::INF, "Lennard Jones coefficients section of the file is not written properly. This section will be ignored!");
     }
     else
@@ -915,6 +927,8 @@ void TopologyFile::ParseSections(ifstream &in_stream)
 
     // Bonds, Angles, Dihedrals
     //Bonds in topology file    
+    bond_atom_indices_.clear();
+    bond_atom_indices_.reserve(2 * (number_of_bonds_including_hydrogen_ + number_of_bonds_excluding_hydrogen_));
     for(int i = 0; i < number_of_bonds_including_hydrogen_; i++)
     {
         vector<string> bonds = vector<string>();
@@ -922,6 +936,8 @@ void TopologyFile::ParseSections(ifstream &in_stream)
 
         int first_atom_index = (bonds_inc_hydrogens[i*3])/3;
         int second_atom_index = (bonds_inc_hydrogens[i*3+1])/3;
+        bond_atom_indices_.push_back(first_atom_index);
+        bond_atom_indices_.push_back(second_atom_index);
 
         bonds.push_back(atom_names[first_atom_index]);
         bonds.push_back(atom_names[second_atom_index]);
@@ -983,6 +999,8 @@ void TopologyFile::ParseSections(ifstream &in_stream)
 
         int first_atom_index = (bonds_without_hydrogens[i*3])/3;
         int second_atom_index = (bonds_without_hydrogens[i*3+1])/3;
+        bond_atom_indices_.push_back(first_atom_index);
+        bond_atom_indices_.push_back(second_atom_index);
 
         bonds.push_back(atom_names[first_atom_index]);
         bonds.push_back(atom_names[second_atom_index]);
@@ -1472,10 +1490,12 @@ void TopologyFile::ParseSections(ifstream &in_stream)
         for(int i = starting_atom_index - 1; i < ending_atom_index - 1; i++)
         {
             TopologyAtom::ExcludedAtomNames excluded_atoms = TopologyAtom::ExcludedAtomNames();
+            vector<int> excluded_atom_indices = vector<int>();
             if(i > 0)
                 start_index += number_excluded_atoms.at(i-1);
             for(int j = start_index; j < start_index + number_excluded_atoms.at(i); j++)
             {
+                excluded_atom_indices.push_back(excluded_atoms_lists.at(j));
                 string excluded_atom_residue_name;
                 int index = (excluded_atoms_lists.at(j) - 1 == -1) ? 0 : excluded_atoms_lists.at(j) - 1;
                 for(int k = 0; k < number_of_residues_; k++)
@@ -1500,6 +1520,7 @@ void TopologyFile::ParseSections(ifstream &in_stream)
             }
             atoms[atom_names.at(i)] = new TopologyAtom(i + 1, atom_names.at(i), amber_atom_types.at(i), charges.at(i), atomic_numbers.at(i), masses.at(i), excluded_atoms,
                                                        number_excluded_atoms.at(i), radiis.at(i), screens.at(i), tree_chain_classifications.at(i), residue_name);
+            atoms[atom_names.at(i)]->SetExcludedAtomIndices(excluded_atom_indices);
         }
         stringstream residue_key;
         residue_key << residue_name << "_" << residue_index;
@@ -1511,7 +1532,7 @@ void TopologyFile::ParseSections(ifstream &in_stream)
     assembly_->SetResidues(residues);
 }
 
-void TopologyFile::PartitionSection(ifstream &stream, string &line, stringstream& section)
+void TopologyFile::PartitionSection(istream &stream, string &line, stringstream& section)
 {
     while(line[0] == '%')
     {
@@ -1656,80 +1677,45 @@ template<typename T>
 vector<T> TopologyFile::PartitionLine(string line, string format)
 {
     vector<T> items = vector<T>();
+    int number_of_items = 0;
+    int item_length = 0;
     if(format.compare("10I8") == 0)
     {
-        int number_of_items = 10;
-        int item_length = 8;
-        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
-        {
-            string token = line.substr(i*item_length, item_length);
-            token = Trim(token);
-            items.push_back(ConvertString<T>(token));
-        }
-        return items;
+        number_of_items = 10;
+        item_length = 8;
     }
-    if(format.compare("20a4") == 0)
+    else if(format.compare("20a4") == 0)
     {
-        int number_of_items = 20;
-        int item_length = 4;
-        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
-        {
-            string token = line.substr(i*item_length, item_length);
-            token = Trim(token);
-            items.push_back(ConvertString<T>(token));
-        }
-        return items;
+        number_of_items = 20;
+        item_length = 4;
     }
-    if(format.compare("5E16.8") == 0)
+    else if(format.compare("5E16.8") == 0)
     {
-        int number_of_items = 5;
-        int item_length = 16;
-        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
-        {
-            string token = line.substr(i*item_length, item_length);
-            token = Trim(token);
-            double base = ConvertString<double>(Split(token, "E")[0]);
-            int power = ConvertString<int>(Split(token, "E")[1]);
-            stringstream temp, format;
-            double result = base * pow10(power);
-            format << setw(16) << fixed << setprecision(8);
-            temp << format.str() << result;
-            T item = ConvertString<T>(temp.str());
-            items.push_back(item);
-        }
-        return items;
+        number_of_items = 5;
+        item_length = 16;
     }
-    if(format.compare("1a80") == 0)
+    else if(format.compare("1a80") == 0)
     {
-        int number_of_items = 1;
-        int item_length = 80;
-        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
-        {
-            string token = line.substr(i*item_length, item_length);
-            std::replace_if(token.begin(), token.end(), ::isspace, '#');
-            token = Trim(token);
-            items.push_back(ConvertString<T>(token));
-        }
-
-        return items;
+        /// A title may have spaces in it, they are kept as '#' so the whole column becomes a single item
+        std::replace_if(line.begin(), line.end(), ::isspace, '#');
+        number_of_items = 1;
+        item_length = 80;
     }
-    if(format.compare("1I8") == 0)
+    else if(format.compare("1I8") == 0)
     {
-        int number_of_items = 1;
-        int item_length = 8;
-        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
-        {
-            string token = line.substr(i*item_length, item_length);
-            token = Trim(token);
-            items.push_back(ConvertString<T>(token));
-        }
-        return items;
+        number_of_items = 1;
+        item_length = 8;
+    }
+    for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
+    {
+        items.push_back(ParseValue<T>(TrimmedColumn(line, i*item_length, item_length)));
     }
     return items;
 }
 
 void TopologyFile::Write(const string &top_file)
 {
+    GMML_SCOPED_TIMER("TopologyFile::Write");
     std::ofstream out_file;
     try
     {
@@ -2130,7 +2116,11 @@ void TopologyFile::ResolveNumberExcludedAtomsSection(ofstream& out)
         {
             TopologyAtom* atom = residue->GetAtomByIndex(index+1);
             index++;
-            out << setw(ITEM_LENGTH) << right << atom->GetExcludedAtoms().size();
+            int number_of_excluded_atoms = atom->GetExcludedAtoms().size();
+            /// Atoms that carry the indices of their excluded atoms are written as amber expects, with a single 0 for an empty list
+            if(!atom->GetExcludedAtomIndices().empty() || atom->GetExcludedAtoms().empty())
+                number_of_excluded_atoms = (atom->GetExcludedAtomIndices().empty()) ? 1 : atom->GetExcludedAtomIndices().size();
+            out << setw(ITEM_LENGTH) << right << number_of_excluded_atoms;
             count++;
             total_count++;
             if(count == MAX_IN_LINE)
@@ -3014,6 +3004,24 @@ void TopologyFile::ResolveExcludedAtomsListSection(ofstream& out)
         {
             TopologyAtom* atom = residue->GetAtomByIndex(index+1);
             index++;
+            if(!atom->GetExcludedAtomIndices().empty() || atom->GetExcludedAtoms().empty())
+            {
+                vector<int> excluded_atom_indices = atom->GetExcludedAtomIndices();
+                if(excluded_atom_indices.empty())
+                    excluded_atom_indices.push_back(0);
+                for(vector<int>::iterator it = excluded_atom_indices.begin(); it != excluded_atom_indices.end(); it++)
+                {
+                    out << setw(ITEM_LENGTH) << right << (*it);
+                    count++;
+                    total_count++;
+                    if(count == MAX_IN_LINE)
+                    {
+                        count = 0;
+                        out << endl;
+                    }
+                }
+                continue;
+            }
             vector<string> excluded_atoms = atom->GetExcludedAtoms();
             for(vector<string>::iterator it = excluded_atoms.begin(); it != excluded_atoms.end(); it++)
             {
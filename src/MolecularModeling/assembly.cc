@@ -2,8 +2,10 @@
 #include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unordered_map>
 
 #include "../../includes/MolecularModeling/assembly.hpp"
+#include "../../includes/instrumentation.hpp"
 #include "../../includes/MolecularModeling/residue.hpp"
 #include "../../includes/MolecularModeling/atom.hpp"
 #include "../../includes/MolecularModeling/atomnode.hpp"
@@ -22,11 +24,15 @@
 #include "../../includes/InputSet/TopologyFileSpace/topologydihedraltype.hpp"
 #include "../../includes/InputSet/TopologyFileSpace/topologyatompair.hpp"
 #include "../../includes/InputSet/CoordinateFileSpace/coordinatefile.hpp"
+#include "../../includes/InputSet/CifFileSpace/ciffile.hpp"
+#include "../../includes/InputSet/CifFileSpace/cifatomsite.hpp"
+#include "../../includes/InputSet/CifFileSpace/ciffileprocessingexception.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfile.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
 #include "../../includes/InputSet/PdbFileSpace/pdbfile.hpp"
 #include "../../includes/InputSet/PdbFileSpace/pdbtitlecard.hpp"
+#include "../../includes/InputSet/PdbFileSpace/pdbcrystallographiccard.hpp"
 #include "../../includes/InputSet/PdbFileSpace/pdbmodelcard.hpp"
 #include "../../includes/InputSet/PdbFileSpace/pdbmodel.hpp"
 #include "../../includes/InputSet/PdbFileSpace/pdbmodelresidueset.hpp"
@@ -50,6 +56,7 @@
 #include "../../includes/ParameterSet/ParameterFileSpace/parameterfiledihedral.hpp"
 #include "../../includes/ParameterSet/ParameterFileSpace/parameterfiledihedralterm.hpp"
 #include "../../includes/ParameterSet/ParameterFileSpace/parameterfileatom.hpp"
+#include "../../includes/ParameterSet/ParameterFileSpace/layeredparameterfile.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfile.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
 #include "../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
@@ -57,6 +64,10 @@
 #include "../../includes/common.hpp"
 #include "../../includes/GeometryTopology/grid.hpp"
 #include "../../includes/GeometryTopology/cell.hpp"
+#include "../../includes/GeometryTopology/unitcell.hpp"
+#include "../../includes/GeometryTopology/celllist.hpp"
+#include "../../includes/GeometryTopology/geometrykernels.hpp"
+#include "../../includes/MolecularModeling/rotatabledihedral.hpp"
 
 //#include "raptor2/raptor.h"
 //#include "raptor2/raptor2.h"
@@ -122,6 +133,7 @@ using namespace std;
 using namespace MolecularModeling;
 using namespace TopologyFileSpace;
 using namespace CoordinateFileSpace;
+using namespace CifFileSpace;
 using namespace PrepFileSpace;
 using namespace PdbFileSpace;
 using namespace PdbqtFileSpace;
@@ -132,10 +144,134 @@ using namespace gmml;
 using namespace Glycan;
 using namespace CondensedSequenceSpace;
 
+/*! \struct
+  * One coordinate set of the atoms of an assembly built from a pdb file, i.e. one model of the file
+  */
+struct PdbModelCoordinateSet
+{
+        int serial_number;                                      /*!< Serial number of the model >*/
+        PdbModel* model;                                        /*!< The parsed model, NULL for a model that has been merged into the first model >*/
+        int merged_model;                                       /*!< Index of a merged model in PdbAtom::GetAtomModelCoordinates of the atoms of the first model >*/
+        unordered_map<string, PdbAtom*> atoms;                  /*!< Atoms of a parsed model keyed by card index and serial number, see GetPdbModelAtomKey >*/
+        int missing_atoms;                                      /*!< Number of atoms of the first model that the model lacks >*/
+};
+
+static string GetPdbModelAtomKey(PdbAtom* atom)
+{
+    stringstream ss;
+    ss << atom->GetAtomCardIndexInResidueSet() << "_" << atom->GetAtomSerialNumber();
+    return ss.str();
+}
+
+/// The models of the pdb file in the order of their serial numbers; the first one is the first model of the model map, whose atoms make the assembly
+static vector<PdbModelCoordinateSet> GetPdbModelCoordinateSets(PdbFile* pdb_file)
+{
+    vector<PdbModelCoordinateSet> coordinate_sets = vector<PdbModelCoordinateSet>();
+    PdbModelCard::PdbModelMap models = pdb_file->GetModels()->GetModels();
+    vector<int> merged_model_serial_numbers = pdb_file->GetModels()->GetMergedModelSerialNumbers();
+    vector<pair<int, int> > model_order = vector<pair<int, int> >();
+    for(PdbModelCard::PdbModelMap::iterator it = models.begin(); it != models.end(); it++)
+        model_order.push_back(make_pair((*it).first, -1));
+    for(unsigned int i = 0; i < merged_model_serial_numbers.size(); i++)
+        model_order.push_back(make_pair(merged_model_serial_numbers.at(i), (int)i));
+    sort(model_order.begin(), model_order.end());
+    coordinate_sets.resize(model_order.size());
+    for(unsigned int i = 0; i < model_order.size(); i++)
+    {
+        PdbModelCoordinateSet& coordinate_set = coordinate_sets.at(i);
+        coordinate_set.serial_number = model_order.at(i).first;
+        coordinate_set.merged_model = model_order.at(i).second;
+        coordinate_set.model = (coordinate_set.merged_model < 0) ? models[coordinate_set.serial_number] : NULL;
+        coordinate_set.missing_atoms = 0;
+        /// The atoms of the first model are the atoms of the assembly themselves
+        if(i == 0 || coordinate_set.model == NULL)
+            continue;
+        PdbModelResidueSet* residue_set = coordinate_set.model->GetModelResidueSet();
+        PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
+        for(PdbModelResidueSet::AtomCardVector::iterator it = atom_cards.begin(); it != atom_cards.end(); it++)
+        {
+            PdbAtomCard::PdbAtomMap atoms = (*it)->GetAtoms();
+            for(PdbAtomCard::PdbAtomMap::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
+                coordinate_set.atoms[GetPdbModelAtomKey((*it1).second)] = (*it1).second;
+        }
+        PdbModelResidueSet::HeterogenAtomCardVector heterogen_atom_cards = residue_set->GetHeterogenAtoms();
+        for(PdbModelResidueSet::HeterogenAtomCardVector::iterator it = heterogen_atom_cards.begin(); it != heterogen_atom_cards.end(); it++)
+        {
+            PdbHeterogenAtomCard::PdbHeterogenAtomMap heterogen_atoms = (*it)->GetHeterogenAtoms();
+            for(PdbHeterogenAtomCard::PdbHeterogenAtomMap::iterator it1 = heterogen_atoms.begin(); it1 != heterogen_atoms.end(); it1++)
+                coordinate_set.atoms[GetPdbModelAtomKey((*it1).second)] = (*it1).second;
+        }
+    }
+    return coordinate_sets;
+}
+
+/// Adds a coordinate of every model to an atom built from an atom of the first model; an atom that a model lacks, i.e. has no atom with
+/// the same card index, serial number and residue, keeps its coordinate of the first model in the set of that model
+static void AddPdbModelCoordinates(Atom* new_atom, PdbAtom* atom, vector<PdbModelCoordinateSet>& coordinate_sets)
+{
+    const vector<GeometryTopology::Coordinate>& model_coordinates = atom->GetAtomModelCoordinates();
+    string atom_key = "";
+    for(unsigned int i = 0; i < coordinate_sets.size(); i++)
+    {
+        PdbModelCoordinateSet& coordinate_set = coordinate_sets.at(i);
+        if(i == 0)
+        {
+            new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+            continue;
+        }
+        if(coordinate_set.model == NULL)
+        {
+            if(coordinate_set.merged_model < (int)model_coordinates.size())
+            {
+                new_atom->AddCoordinate(new GeometryTopology::Coordinate(model_coordinates.at(coordinate_set.merged_model)));
+                continue;
+            }
+        }
+        else
+        {
+            if(atom_key.empty())
+                atom_key = GetPdbModelAtomKey(atom);
+            unordered_map<string, PdbAtom*>::iterator matching = coordinate_set.atoms.find(atom_key);
+            if(matching != coordinate_set.atoms.end())
+            {
+                PdbAtom* matching_atom = (*matching).second;
+                if(matching_atom->GetAtomResidueName() == atom->GetAtomResidueName() && matching_atom->GetAtomChainId() == atom->GetAtomChainId() &&
+                        matching_atom->GetAtomResidueSequenceNumber() == atom->GetAtomResidueSequenceNumber() &&
+                        matching_atom->GetAtomInsertionCode() == atom->GetAtomInsertionCode() &&
+                        matching_atom->GetAtomAlternateLocation() == atom->GetAtomAlternateLocation())
+                {
+                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate()));
+                    continue;
+                }
+            }
+        }
+        new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+        coordinate_set.missing_atoms++;
+    }
+}
+
+/// Warns about the models whose missing atoms AddPdbModelCoordinates has padded and returns the serial numbers of the coordinate sets
+static vector<int> GetPdbModelSerialNumbers(const vector<PdbModelCoordinateSet>& coordinate_sets, const string& pdb_file_path)
+{
+    vector<int> serial_numbers = vector<int>();
+    for(unsigned int i = 0; i < coordinate_sets.size(); i++)
+    {
+        serial_numbers.push_back(coordinate_sets.at(i).serial_number);
+        if(coordinate_sets.at(i).missing_atoms != 0)
+        {
+            stringstream ss;
+            ss << "Model " << coordinate_sets.at(i).serial_number << " of " << pdb_file_path << ": " << coordinate_sets.at(i).missing_atoms
+               << " atom(s) of the first model are missing and keep their coordinates of the first model";
+            gmml::log(__LINE__, __FILE__, gmml::WAR, ss.str());
+        }
+    }
+    return serial_numbers;
+}
+
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
-Assembly::Assembly() : description_(""), model_index_(0), sequence_number_(1), id_("1")
+Assembly::Assembly() : description_(""), model_index_(0), sequence_number_(1), id_("1"), unit_cell_(GeometryTopology::UnitCell()), periodic_(false)
 {
     residues_ = ResidueVector();
     assemblies_ = AssemblyVector();
@@ -148,6 +284,8 @@ Assembly::Assembly(vector<string> file_paths, gmml::InputFileType type)
     model_index_ = 0;
     sequence_number_ = 1;
     id_ = "1";
+    unit_cell_ = GeometryTopology::UnitCell();
+    periodic_ = false;
     switch(type)
     {
         case gmml::PDB:
@@ -186,6 +324,12 @@ Assembly::Assembly(vector<string> file_paths, gmml::InputFileType type)
             BuildAssemblyFromTopologyCoordinateFile(file_paths.at(0), file_paths.at(1));
             assemblies_ = AssemblyVector();
             break;
+        case gmml::CIF:
+            source_file_ = file_paths.at(0);
+            residues_ = ResidueVector();
+            BuildAssemblyFromCifFile(source_file_);
+            assemblies_ = AssemblyVector();
+            break;
         case gmml::MULTIPLE:
             break;
         case gmml::UNKNOWN:
@@ -199,6 +343,8 @@ Assembly::Assembly(vector<vector<string> > file_paths, vector<gmml::InputFileTyp
     stringstream source_file;
     sequence_number_ = 1;
     id_ = "1";
+    unit_cell_ = GeometryTopology::UnitCell();
+    periodic_ = false;
     for(unsigned int i = 0; i < file_paths.size(); i++)
     {
         vector<string> file = file_paths.at(i);
@@ -209,6 +355,7 @@ Assembly::Assembly(vector<vector<string> > file_paths, vector<gmml::InputFileTyp
         ss << id_ << "." << i + 1;
         assembly->SetId(ss.str());
         assemblies_.push_back(assembly);
+        owned_assemblies_.push_back(assembly);
         if(i < file_paths.size() - 1)
         {
             name << assembly->GetName() << "-";
@@ -225,6 +372,12 @@ Assembly::Assembly(vector<vector<string> > file_paths, vector<gmml::InputFileTyp
     model_index_ = 0;
 }
 
+Assembly::~Assembly()
+{
+    for(AssemblyVector::iterator it = owned_assemblies_.begin(); it != owned_assemblies_.end(); it++)
+        delete (*it);
+}
+
 //////////////////////////////////////////////////////////
 //                         ACCESSOR                     //
 //////////////////////////////////////////////////////////
@@ -550,6 +703,13 @@ Assembly::AtomVector Assembly::GetAllAtomsOfAssembly()
     }
     return all_atoms_of_assembly;
 }
+const BondGraph& Assembly::GetBondGraph()
+{
+    if(!bond_graph_.IsBuilt() || bond_graph_.IsOutdated())
+        bond_graph_.Build(this->GetAllAtomsOfAssembly());
+    return bond_graph_;
+}
+
 Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms()
 {
     AtomVector all_atoms_of_assembly = AtomVector();
@@ -610,7 +770,6 @@ Assembly::CoordinateVector Assembly::GetAllCoordinates()
         CoordinateVector assembly_coordinate = assembly->GetAllCoordinates();
         if(assembly_coordinate.size() == 0)
         {
-            cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
             gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
             return CoordinateVector();
         }
@@ -628,7 +787,6 @@ Assembly::CoordinateVector Assembly::GetAllCoordinates()
             Atom* atom = (*it1);
             if(atom->GetCoordinates().size() == 0)
             {
-                cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
                 gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
                 return CoordinateVector();
             }
@@ -641,6 +799,25 @@ Assembly::CoordinateVector Assembly::GetAllCoordinates()
     return coordinates;
 }
 
+GeometryTopology::UnitCell* Assembly::GetUnitCell()
+{
+    if(unit_cell_.IsSet())
+        return &unit_cell_;
+    return NULL;
+}
+
+GeometryTopology::UnitCell* Assembly::GetPeriodicBox()
+{
+    if(periodic_ && unit_cell_.IsSet())
+        return &unit_cell_;
+    return NULL;
+}
+
+vector<int> Assembly::GetModelSerialNumbers()
+{
+    return model_serial_numbers_;
+}
+
 //////////////////////////////////////////////////////////
 //                          MUTATOR                     //
 //////////////////////////////////////////////////////////
@@ -650,6 +827,7 @@ void Assembly::SetName(string name)
 }
 void Assembly::SetAssemblies(AssemblyVector assemblies)
 {
+    bond_graph_.Clear();
     assemblies_.clear();
     for(AssemblyVector::iterator it = assemblies.begin(); it != assemblies.end(); it++)
     {
@@ -658,6 +836,7 @@ void Assembly::SetAssemblies(AssemblyVector assemblies)
 }
 void Assembly::AddAssembly(Assembly *assembly)
 {
+    bond_graph_.Clear();
     stringstream ss;
     ss << this->name_ << "-" << assembly->GetName();
     this->name_ = ss.str();
@@ -709,6 +888,7 @@ void Assembly::UpdateIds(string new_id)
 }
 void Assembly::SetResidues(ResidueVector residues)
 {
+    bond_graph_.Clear();
     residues_.clear();
     for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
     {
@@ -717,6 +897,7 @@ void Assembly::SetResidues(ResidueVector residues)
 }
 void Assembly::AddResidue(Residue *residue)
 {
+    bond_graph_.Clear();
     residues_.push_back(residue);
 }
 void Assembly::SetChemicalType(string chemical_type)
@@ -748,23 +929,42 @@ void Assembly::SetModelIndex(int model_index)
     model_index_ = model_index;
 }
 
+void Assembly::SetUnitCell(GeometryTopology::UnitCell* unit_cell)
+{
+    if(unit_cell != NULL)
+        unit_cell_ = *unit_cell;
+    else
+        unit_cell_ = GeometryTopology::UnitCell();
+}
+
+void Assembly::SetPeriodic(bool periodic)
+{
+    periodic_ = periodic;
+}
+
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
 void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_file, string parameter_file, bool structure)
 {
-    ResidueAttachmentMap attachment_map = ResidueAttachmentMap();
-    CondensedSequence* condensed_sequence = new CondensedSequence(sequence);
-    CondensedSequence::CondensedSequenceAmberPrepResidueTree amber_prep_residues = condensed_sequence->GetCondensedSequenceAmberPrepResidueTree();
     PrepFile* prep = new PrepFile(prep_file);
-    PrepFile::ResidueMap prep_residue_map = prep->GetResidues();
     ParameterFile* parameter = NULL;
-    ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
-    {
         parameter = new ParameterFile(parameter_file);
-        atom_type_map = parameter->GetAtomTypes();
-    }
+    this->BuildAssemblyFromCondensedSequence(sequence, prep, parameter, structure);
+    this->SetSourceFile(prep_file);
+    delete prep;
+    delete parameter;
+}
+
+void Assembly::BuildAssemblyFromCondensedSequence(string sequence, PrepFile* prep_file, ParameterFile* parameter_file, bool structure,
+                                                  PrepResidueCoordinateMap* template_coordinates)
+{
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    ResidueAttachmentMap attachment_map = ResidueAttachmentMap();
+    CondensedSequence* condensed_sequence = new CondensedSequence(sequence);
+    CondensedSequence::CondensedSequenceAmberPrepResidueTree amber_prep_residues = condensed_sequence->GetCondensedSequenceAmberPrepResidueTree();
+    /// The prep and parameter files may be shared between threads, so only look up their residues
     int sequence_number = 0;
     stringstream ss;
     for(CondensedSequence::CondensedSequenceAmberPrepResidueTree::iterator it = amber_prep_residues.begin(); it != amber_prep_residues.end(); ++it)
@@ -773,17 +973,14 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
         string amber_prep_residue_name = amber_prep_residue->GetName();
         string amber_prep_residue_parent_oxygen = amber_prep_residue->GetParentOxygen();
 
-        if(prep_residue_map.find(amber_prep_residue_name) != prep_residue_map.end())
+        PrepFileResidue* prep_residue = prep_file->GetPrepResidueByResidueName(amber_prep_residue_name);
+        if(prep_residue != NULL)
         {
-            PrepFileResidue* prep_residue = prep_residue_map[amber_prep_residue_name];
 
             // Build residue from prep residue
             sequence_number++;
-            CoordinateVector cartesian_coordinate_list = CoordinateVector();
-            int head_atom_index = INFINITY;
-            int tail_atom_index = -INFINITY;
-            Atom* head_atom = new Atom();
-            Atom* tail_atom = new Atom();
+            Atom* head_atom = NULL;
+            Atom* tail_atom = NULL;
 
             Residue* assembly_residue = new Residue();
             assembly_residue->SetAssembly(this);
@@ -799,6 +996,16 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                 ss << prep_residue_name << "-";
 
             PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+            CoordinateVector cartesian_coordinate_list = CoordinateVector();
+            PrepResidueCoordinateMap::iterator template_search = (template_coordinates != NULL) ?
+                        template_coordinates->find(prep_residue->GetName()) : PrepResidueCoordinateMap::iterator();
+            if(template_coordinates != NULL && template_search != template_coordinates->end())
+            {
+                for(CoordinateVector::iterator it1 = template_search->second.begin(); it1 != template_search->second.end(); it1++)
+                    cartesian_coordinate_list.push_back(new Coordinate(*(*it1)));
+            }
+            else
+                cartesian_coordinate_list = prep_residue->InstantiateTemplateCoordinates();
             int serial_number = 0;
             for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
             {
@@ -814,11 +1021,13 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
 
                 assembly_atom->MolecularDynamicAtom::SetAtomType(prep_atom->GetType());
                 assembly_atom->MolecularDynamicAtom::SetCharge(prep_atom->GetCharge());
-                if(parameter != NULL)
+                if(parameter_file != NULL)
                 {
-                    if(atom_type_map.find(assembly_atom->GetAtomType()) != atom_type_map.end())
+                    const ParameterFile::AtomTypeMap& atom_type_map = parameter_file->GetAtomTypes();
+                    ParameterFile::AtomTypeMap::const_iterator atom_type_search = atom_type_map.find(assembly_atom->GetAtomType());
+                    if(atom_type_search != atom_type_map.end())
                     {
-                        ParameterFileAtom* parameter_atom = atom_type_map[assembly_atom->GetAtomType()];
+                        ParameterFileAtom* parameter_atom = atom_type_search->second;
                         assembly_atom->MolecularDynamicAtom::SetMass(parameter_atom->GetMass());
                         assembly_atom->MolecularDynamicAtom::SetRadius(parameter_atom->GetRadius());
                     }
@@ -841,70 +1050,17 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                 else if(atom_name.compare("C" + amber_prep_residue_parent_oxygen[1]) == 0 && prep_residue_name.compare("ACX") == 0)
                     assembly_atom->MolecularDynamicAtom::SetCharge(assembly_atom->MolecularDynamicAtom::GetCharge() + 0.008);
 
-                if(prep_residue->GetCoordinateType() == PrepFileSpace::kINT)
-                {
-                    vector<Coordinate*> coordinate_list = vector<Coordinate*>();
-                    int index = distance(prep_atoms.begin(), it1);
-                    if(index == 0)
-                    {
-                    }
-                    if(index == 1)
-                    {
-                        int parent_index = prep_atom->GetBondIndex() - 1;
-                        Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                        coordinate_list.push_back(parent_coordinate);
-                    }
-                    if(index == 2)
-                    {
-                        int grandparent_index = prep_atom->GetAngleIndex() - 1;
-                        int parent_index = prep_atom->GetBondIndex() - 1;
-                        Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
-                        Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                        coordinate_list.push_back(grandparent_coordinate);
-                        coordinate_list.push_back(parent_coordinate);
-                    }
-                    if(index > 2)
-                    {
-                        int great_grandparent_index = prep_atom->GetDihedralIndex() - 1;
-                        int grandparent_index = prep_atom->GetAngleIndex() - 1;
-                        int parent_index = prep_atom->GetBondIndex() - 1;
-
-                        Coordinate* great_grandparent_coordinate = cartesian_coordinate_list.at(great_grandparent_index);
-                        Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
-                        Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                        coordinate_list.push_back(great_grandparent_coordinate);
-                        coordinate_list.push_back(grandparent_coordinate);
-                        coordinate_list.push_back(parent_coordinate);
-                    }
-                    Coordinate* coordinate = new Coordinate();
-                    coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                     prep_atom->GetAngle(), prep_atom->GetDihedral());
-                    cartesian_coordinate_list.push_back(coordinate);
-
-                    assembly_atom->AddCoordinate(coordinate);
-                }
-                else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
-                {
-                    assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
-                }
-                if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(prep_residue->GetDummyAtomType()) != 0)
-                {
-                    if(head_atom_index > prep_atom->GetIndex())
-                    {
-                        head_atom_index = prep_atom->GetIndex();
-                        head_atom = assembly_atom;
-                    }
-                    if(tail_atom_index < prep_atom->GetIndex())
-                    {
-                        tail_atom_index = prep_atom->GetIndex();
-                        tail_atom = assembly_atom;
-                    }
-                }
+                assembly_atom->AddCoordinate(cartesian_coordinate_list.at(distance(prep_atoms.begin(), it1)));
+                if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateHeadAtomPosition())
+                    head_atom = assembly_atom;
+                if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateTailAtomPosition())
+                    tail_atom = assembly_atom;
                 if(assembly_atom->GetAtomType().compare("DU") != 0)
                     assembly_residue->AddAtom(assembly_atom);
             }
-            assembly_residue->AddHeadAtom(head_atom);
-            assembly_residue->AddTailAtom(tail_atom);
+            /// A residue without a template head or tail gets an empty placeholder atom, allocated in the arena like its other atoms
+            assembly_residue->AddHeadAtom((head_atom != NULL) ? head_atom : new Atom());
+            assembly_residue->AddTailAtom((tail_atom != NULL) ? tail_atom : new Atom());
             residues_.push_back(assembly_residue);
             if(sequence_number > 1)
             {
@@ -914,16 +1070,17 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
         }
         else
         {
-            cout << "Residue " << amber_prep_residue_name << " has not been found in the database" << endl;
+            stringstream warning;
+            warning << "Residue " << amber_prep_residue_name << " has not been found in the database";
+            gmml::log(__LINE__, __FILE__, gmml::WAR, warning.str());
         }
     }
 
     name_ = ss.str();
-    this->SetSourceFile(prep_file);
 
     if(structure)
     {
-        this->BuildStructureByPrepFileInformation();
+        this->BuildStructureByPrepFileInformation(prep_file);
         for(ResidueAttachmentMap::iterator it = attachment_map.begin(); it != attachment_map.end(); it++)
         {
             Residue* parent_residue = (*it).first;
@@ -937,10 +1094,72 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
     }
 }
 
+Assembly::CoordinateVector Assembly::GetCartesianCoordinatesOfPrepResidue(PrepFileResidue *prep_residue)
+{
+    CoordinateVector cartesian_coordinate_list = CoordinateVector();
+    PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+    for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
+    {
+        PrepFileAtom* prep_atom = (*it1);
+        if(prep_residue->GetCoordinateType() == PrepFileSpace::kINT)
+        {
+            vector<Coordinate*> coordinate_list = vector<Coordinate*>();
+            int index = distance(prep_atoms.begin(), it1);
+            if(index == 0)
+            {
+            }
+            if(index == 1)
+            {
+                int parent_index = prep_atom->GetBondIndex() - 1;
+                Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
+                coordinate_list.push_back(parent_coordinate);
+            }
+            if(index == 2)
+            {
+                int grandparent_index = prep_atom->GetAngleIndex() - 1;
+                int parent_index = prep_atom->GetBondIndex() - 1;
+                Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
+                Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
+                coordinate_list.push_back(grandparent_coordinate);
+                coordinate_list.push_back(parent_coordinate);
+            }
+            if(index > 2)
+            {
+                int great_grandparent_index = prep_atom->GetDihedralIndex() - 1;
+                int grandparent_index = prep_atom->GetAngleIndex() - 1;
+                int parent_index = prep_atom->GetBondIndex() - 1;
+
+                Coordinate* great_grandparent_coordinate = cartesian_coordinate_list.at(great_grandparent_index);
+                Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
+                Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
+                coordinate_list.push_back(great_grandparent_coordinate);
+                coordinate_list.push_back(grandparent_coordinate);
+                coordinate_list.push_back(parent_coordinate);
+            }
+            Coordinate* coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
+                                                                                         prep_atom->GetAngle(), prep_atom->GetDihedral());
+            cartesian_coordinate_list.push_back(coordinate);
+        }
+        else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
+        {
+            cartesian_coordinate_list.push_back(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+        }
+    }
+    return cartesian_coordinate_list;
+}
+
 void Assembly::AttachResidues(Residue *residue, Residue *parent_residue, string parameter_file)
 {
-    ParameterFile* parameter = new ParameterFile(parameter_file);
-    ParameterFile::BondMap parameter_bonds = parameter->GetBonds();
+    ParameterFile* parameter = NULL;
+    if(parameter_file.compare("") != 0)
+        parameter = new ParameterFile(parameter_file);
+    this->AttachResidues(residue, parent_residue, parameter);
+    delete parameter;
+}
+
+void Assembly::AttachResidues(Residue *residue, Residue *parent_residue, ParameterFile *parameter_file)
+{
+    bond_graph_.Clear();
     Atom* residue_head_atom = residue->GetHeadAtoms().at(0);
     Atom* parent_target_atom = parent_residue->GetTailAtoms().at(0);
     AtomVector residue_head_atom_adjacent_atoms = AtomVector();
@@ -953,124 +1172,60 @@ void Assembly::AttachResidues(Residue *residue, Residue *parent_residue, string
     vector<string> reverse_bond = vector<string>();
     reverse_bond.push_back(parent_target_atom->GetAtomType());
     reverse_bond.push_back(residue_head_atom->GetAtomType());
-    if(parameter_bonds.find(bond) != parameter_bonds.end())
-        bond_length = parameter_bonds[bond]->GetLength();
-    else if(parameter_bonds.find(reverse_bond) != parameter_bonds.end())
-        bond_length = parameter_bonds[reverse_bond]->GetLength();
+    if(parameter_file != NULL)
+    {
+        const ParameterFile::BondMap& parameter_bonds = parameter_file->GetBonds();
+        if(parameter_bonds.find(bond) != parameter_bonds.end())
+            bond_length = parameter_bonds.find(bond)->second->GetLength();
+        else if(parameter_bonds.find(reverse_bond) != parameter_bonds.end())
+            bond_length = parameter_bonds.find(reverse_bond)->second->GetLength();
+    }
 
     residue_head_atom->GetNode()->AddNodeNeighbor(parent_target_atom);
     parent_target_atom->GetNode()->AddNodeNeighbor(residue_head_atom);
     residue_head_atom_adjacent_atoms = residue_head_atom->GetNode()->GetNodeNeighbors();
     parent_target_atom_adjacent_atoms = parent_target_atom->GetNode()->GetNodeNeighbors();
 
-    Coordinate* residue_direction = new Coordinate();
+    Vector3 residue_direction = Vector3();
     for(AtomVector::iterator it = residue_head_atom_adjacent_atoms.begin(); it != residue_head_atom_adjacent_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetId().compare(parent_target_atom->GetId()) != 0)
         {
-            Coordinate* dist = new Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
-            dist->operator -(*atom->GetCoordinates().at(model_index_));
-            dist->Normalize();
-            residue_direction->operator +(*dist);
-            residue_direction->Normalize();
+            Vector3 dist = Vector3(*residue_head_atom->GetCoordinates().at(model_index_)) - Vector3(*atom->GetCoordinates().at(model_index_));
+            residue_direction = (residue_direction + dist.Normalized()).Normalized();
         }
     }
-
-    residue_direction->Normalize();
-    residue_direction->operator *(bond_length);
-
-    residue_direction->operator +(*residue_head_atom->GetCoordinates().at(model_index_));
-//    residue_direction->operator +(*parent_target_atom->GetCoordinates().at(model_index_));
-
-    Coordinate* oxygen_position = new Coordinate(residue_direction->GetX(), residue_direction->GetY(), residue_direction->GetZ());
-    Coordinate* offset = new Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
-    offset->operator -(*oxygen_position);
+    Vector3 oxygen_position = residue_direction.Normalized() * bond_length + Vector3(*residue_head_atom->GetCoordinates().at(model_index_));
+    Vector3 parent_target_position = Vector3(*parent_target_atom->GetCoordinates().at(model_index_));
 
     AtomVector all_atoms_of_attached_residue = residue->GetAtoms();
+    CoordinateVector coordinates_of_attached_residue = CoordinateVector();
+    coordinates_of_attached_residue.reserve(all_atoms_of_attached_residue.size());
     for(AtomVector::iterator it = all_atoms_of_attached_residue.begin(); it != all_atoms_of_attached_residue.end(); it++)
-        (*it)->GetCoordinates().at(model_index_)->Translate(offset->GetX(), offset->GetY(), offset->GetZ());
+        coordinates_of_attached_residue.push_back((*it)->GetCoordinates().at(model_index_));
+    TranslateCoordinates(coordinates_of_attached_residue, parent_target_position - oxygen_position);
     /**/
-    Coordinate* carbon_direction = new Coordinate();
+    Vector3 carbon_direction = Vector3();
     for(AtomVector::iterator it = parent_target_atom_adjacent_atoms.begin(); it != parent_target_atom_adjacent_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetId().compare(residue_head_atom->GetId()) != 0)
         {
-            Coordinate* dist = new Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
-            dist->operator -(*atom->GetCoordinates().at(model_index_));
-            dist->Normalize();
-            carbon_direction->operator +(*dist);
-            carbon_direction->Normalize();
+            Vector3 dist = parent_target_position - Vector3(*atom->GetCoordinates().at(model_index_));
+            carbon_direction = (carbon_direction + dist.Normalized()).Normalized();
         }
     }
+    Vector3 carbon_position = carbon_direction.Normalized() * bond_length + parent_target_position;
 
-    carbon_direction->Normalize();
-    carbon_direction->operator *(bond_length);
-    carbon_direction->operator +(*parent_target_atom->GetCoordinates().at(model_index_));
-
-    Coordinate* carbon_position = new Coordinate(*carbon_direction);
-
-    Coordinate* carbon_target = new Coordinate(*carbon_position);
-    carbon_target->operator -(*parent_target_atom->GetCoordinates().at(model_index_));
-
-    Coordinate* head_target = new Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
-    head_target->operator -(*parent_target_atom->GetCoordinates().at(model_index_));
+    Vector3 carbon_target = carbon_position - parent_target_position;
+    Vector3 head_target = Vector3(*residue_head_atom->GetCoordinates().at(model_index_)) - parent_target_position;
 
-    double angle = acos((carbon_target->DotProduct(*head_target)) / (carbon_target->length() * head_target->length()));
+    double angle = acos((carbon_target.DotProduct(head_target)) / (carbon_target.Length() * head_target.Length()));
     double rotation_angle = ConvertDegree2Radian(PI_DEGREE - ROTATION_ANGLE) - angle;
 
-    double rotation_matrix[3][4];
-    Coordinate* direction = new Coordinate(*carbon_target);
-    direction->CrossProduct(*head_target);
-    direction->Normalize();
-    double u = direction->GetX();
-    double v = direction->GetY();
-    double w = direction->GetZ();
-
-    double a = parent_target_atom->GetCoordinates().at(model_index_)->GetX();
-    double b = parent_target_atom->GetCoordinates().at(model_index_)->GetY();
-    double c = parent_target_atom->GetCoordinates().at(model_index_)->GetZ();
-
-    double u2 = u*u;
-    double v2 = v*v;
-    double w2 = w*w;
-    double cos_rotation_angle = cos(rotation_angle);
-    double sin_rotation_angle = sin(rotation_angle);
-
-    rotation_matrix[0][3] = a * (v2 + w2) - u * (b * v + c * w) + (u * (b * v + c * w) - a * (v2 + w2)) * cos_rotation_angle + (b * w - c * v) * sin_rotation_angle;
-    rotation_matrix[1][3] = b * (u2 + w2) - v * (a * u + c * w) + (v * (a * u + c * w) - b * (u2 + w2)) * cos_rotation_angle + (c * u - a * w) * sin_rotation_angle;
-    rotation_matrix[2][3] = c * (u2 + v2) - w * (a * u + b * v) + (w * (a * u + b * v) - c * (u2 + v2)) * cos_rotation_angle + (a * v - b * u) * sin_rotation_angle;
-
-    rotation_matrix[0][0] = u2 + (v2 + w2) * cos_rotation_angle;
-    rotation_matrix[0][1] = u * v * (1 - cos_rotation_angle) - w * sin_rotation_angle;
-    rotation_matrix[0][2] = u * w * (1 - cos_rotation_angle) + v * sin_rotation_angle;
-
-    rotation_matrix[1][0] = u * v * (1 - cos_rotation_angle) + w * sin_rotation_angle;
-    rotation_matrix[1][1] = v2 + (u2 + w2) * cos_rotation_angle;
-    rotation_matrix[1][2] = v * w * (1 - cos_rotation_angle) - u * sin_rotation_angle;
-
-    rotation_matrix[2][0] = u * w * (1 - cos_rotation_angle) - v * sin_rotation_angle;
-    rotation_matrix[2][1] = v * w * (1 - cos_rotation_angle) + u * sin_rotation_angle;
-    rotation_matrix[2][2] = w2 + (u2 + v2) * cos_rotation_angle;
-
-    all_atoms_of_attached_residue = residue->GetAtoms();
-    for(AtomVector::iterator it = all_atoms_of_attached_residue.begin(); it != all_atoms_of_attached_residue.end(); it++)
-    {
-        Coordinate* atom_coordinate = (*it)->GetCoordinates().at(model_index_);
-        Coordinate* result = new Coordinate();
-        result->SetX(rotation_matrix[0][0] * atom_coordinate->GetX() + rotation_matrix[0][1] * atom_coordinate->GetY() +
-                     rotation_matrix[0][2] * atom_coordinate->GetZ() + rotation_matrix[0][3]);
-        result->SetY(rotation_matrix[1][0] * atom_coordinate->GetX() + rotation_matrix[1][1] * atom_coordinate->GetY() +
-                     rotation_matrix[1][2] * atom_coordinate->GetZ() + rotation_matrix[1][3]);
-        result->SetZ(rotation_matrix[2][0] * atom_coordinate->GetX() + rotation_matrix[2][1] * atom_coordinate->GetY() +
-                     rotation_matrix[2][2] * atom_coordinate->GetZ() + rotation_matrix[2][3]);
-
-        (*it)->GetCoordinates().at(model_index_)->SetX(result->GetX());
-        (*it)->GetCoordinates().at(model_index_)->SetY(result->GetY());
-        (*it)->GetCoordinates().at(model_index_)->SetZ(result->GetZ());
-    }
-
+    Vector3 direction = carbon_target.CrossProduct(head_target).Normalized();
+    RotateCoordinates(coordinates_of_attached_residue, Matrix3::RotationAroundAxis(direction, rotation_angle), parent_target_position);
 
     Atom* carbon = NULL;
     for(AtomVector::iterator it = parent_target_atom_adjacent_atoms.begin(); it != parent_target_atom_adjacent_atoms.end(); it++)
@@ -1102,92 +1257,313 @@ void Assembly::AttachResidues(Residue *residue, Residue *parent_residue, string
         }
         if(oxygen != NULL)
         {
-            Coordinate* oxygen_coordinate = oxygen->GetCoordinates().at(model_index_);
-
-            Coordinate* oxygen_head = new Coordinate(*oxygen_coordinate);
-            oxygen_head->operator -(*residue_head_atom->GetCoordinates().at(model_index_));
-
-            Coordinate* target_carbon = new Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
-            target_carbon->operator -(*carbon_position);
+            Vector3 oxygen_head = Vector3(*oxygen->GetCoordinates().at(model_index_)) - Vector3(*residue_head_atom->GetCoordinates().at(model_index_));
+            Vector3 target_carbon = parent_target_position - carbon_position;
+            Vector3 head_target_x_oxygen_head = head_target.CrossProduct(oxygen_head);
+            Vector3 target_carbon_x_head_target = target_carbon.CrossProduct(head_target);
 
-            Coordinate* head_target_x_oxygen_head = new Coordinate(*head_target);
-            head_target_x_oxygen_head->CrossProduct(*oxygen_head);
+            double torsion = atan2((target_carbon * head_target.Length()).DotProduct(head_target_x_oxygen_head),
+                                   target_carbon_x_head_target.DotProduct(head_target_x_oxygen_head));
 
-            Coordinate* target_carbon_x_head_target = new Coordinate(*target_carbon);
-            target_carbon_x_head_target->CrossProduct(*head_target);
+            double rotation_torsion = ConvertDegree2Radian(191.6) - torsion;
+            stringstream torsions;
+            torsions << "Attachment torsion " << torsion << ", rotation " << rotation_torsion;
+            gmml::log(__LINE__, __FILE__, gmml::INF, torsions.str());
 
-            Coordinate* target_carbon_mul_head_target = new Coordinate(*target_carbon);
-            target_carbon_mul_head_target->operator *(head_target->length());
+            RotateCoordinates(coordinates_of_attached_residue, Matrix3::RotationAroundAxis(direction, rotation_torsion), parent_target_position);
+        }
+    }
+    /**/
+}
 
-            double torsion = atan2(target_carbon_mul_head_target->DotProduct(*head_target_x_oxygen_head),
-                                   target_carbon_x_head_target->DotProduct(*head_target_x_oxygen_head));
+vector<RotatableDihedral*> Assembly::FindGlycosidicLinkageDihedrals(Residue *residue, Residue *parent_residue)
+{
+    vector<RotatableDihedral*> dihedrals = vector<RotatableDihedral*>();
+    if(residue->GetHeadAtoms().empty() || parent_residue->GetTailAtoms().empty())
+        return dihedrals;
+    Atom* anomeric_carbon = residue->GetHeadAtoms().at(0);
+    Atom* linkage_oxygen = parent_residue->GetTailAtoms().at(0);
+    if(anomeric_carbon->GetNode() == NULL || linkage_oxygen->GetNode() == NULL)
+        return dihedrals;
+    AtomVector anomeric_carbon_neighbors = anomeric_carbon->GetNode()->GetNodeNeighbors();
+    if(find(anomeric_carbon_neighbors.begin(), anomeric_carbon_neighbors.end(), linkage_oxygen) == anomeric_carbon_neighbors.end())
+        return dihedrals;
 
-            double rotation_torsion = ConvertDegree2Radian(191.6) - torsion;
-            cout << torsion << " " << rotation_torsion << endl;
+    /// Phi: ring oxygen - anomeric carbon - linkage oxygen - parent carbon
+    Atom* ring_oxygen = NULL;
+    for(AtomVector::iterator it = anomeric_carbon_neighbors.begin(); it != anomeric_carbon_neighbors.end(); it++)
+    {
+        Atom* neighbor = *it;
+        if(neighbor != linkage_oxygen && neighbor->GetName()[0] == 'O' && neighbor->GetResidue() == residue)
+        {
+            ring_oxygen = neighbor;
+            break;
+        }
+    }
+    Atom* parent_carbon = NULL;
+    AtomVector linkage_oxygen_neighbors = linkage_oxygen->GetNode()->GetNodeNeighbors();
+    for(AtomVector::iterator it = linkage_oxygen_neighbors.begin(); it != linkage_oxygen_neighbors.end(); it++)
+    {
+        if((*it) != anomeric_carbon && (*it)->GetName()[0] == 'C')
+        {
+            parent_carbon = *it;
+            break;
+        }
+    }
+    if(ring_oxygen == NULL || parent_carbon == NULL)
+        return dihedrals;
+    dihedrals.push_back(new RotatableDihedral(parent_carbon, linkage_oxygen, anomeric_carbon, ring_oxygen));
 
-            double torsion_matrix[3][4];
-            Coordinate* torsion_direction = new Coordinate(*head_target);
-            torsion_direction->Normalize();
-            double u1 = direction->GetX();
-            double v1 = direction->GetY();
-            double w1 = direction->GetZ();
+    /// Psi: anomeric carbon - linkage oxygen - parent carbon - preceding carbon of the parent (e.g. C3 for a 1-4 linkage)
+    Atom* preceding_carbon = NULL;
+    AtomVector parent_carbon_neighbors = parent_carbon->GetNode()->GetNodeNeighbors();
+    for(AtomVector::iterator it = parent_carbon_neighbors.begin(); it != parent_carbon_neighbors.end(); it++)
+    {
+        Atom* neighbor = *it;
+        if(neighbor != linkage_oxygen && neighbor->GetName()[0] == 'C' &&
+                (preceding_carbon == NULL || neighbor->GetName().compare(preceding_carbon->GetName()) < 0))
+            preceding_carbon = neighbor;
+    }
+    if(preceding_carbon == NULL)
+        return dihedrals;
+    dihedrals.push_back(new RotatableDihedral(preceding_carbon, parent_carbon, linkage_oxygen, anomeric_carbon));
 
-            double a1 = parent_target_atom->GetCoordinates().at(model_index_)->GetX();
-            double b1 = parent_target_atom->GetCoordinates().at(model_index_)->GetY();
-            double c1 = parent_target_atom->GetCoordinates().at(model_index_)->GetZ();
+    /// Omega: linkage oxygen - exocyclic carbon (e.g. C6) - ring carbon (e.g. C5) - ring oxygen of the parent
+    int heavy_neighbors_of_parent_carbon = 0;
+    for(AtomVector::iterator it = parent_carbon_neighbors.begin(); it != parent_carbon_neighbors.end(); it++)
+    {
+        if((*it)->GetName()[0] != 'H')
+            heavy_neighbors_of_parent_carbon++;
+    }
+    if(heavy_neighbors_of_parent_carbon == 2)
+    {
+        Atom* parent_ring_oxygen = NULL;
+        AtomVector preceding_carbon_neighbors = preceding_carbon->GetNode()->GetNodeNeighbors();
+        for(AtomVector::iterator it = preceding_carbon_neighbors.begin(); it != preceding_carbon_neighbors.end(); it++)
+        {
+            if((*it) != parent_carbon && (*it)->GetName()[0] == 'O')
+            {
+                parent_ring_oxygen = *it;
+                break;
+            }
+        }
+        if(parent_ring_oxygen != NULL)
+            dihedrals.push_back(new RotatableDihedral(parent_ring_oxygen, preceding_carbon, parent_carbon, linkage_oxygen));
+    }
+    return dihedrals;
+}
 
-            double u12 = u1*u1;
-            double v12 = v1*v1;
-            double w12 = w1*w1;
-            double cos_torsion_angle = cos(rotation_torsion);
-            double sin_torsion_angle = sin(rotation_torsion);
+int Assembly::GenerateRotamers(vector<RotatableDihedral*> dihedrals, vector<vector<double> > torsion_grids, double clash_cutoff, int model_index)
+{
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Generating rotamers ...");
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    if(dihedrals.size() != torsion_grids.size())
+        return 0;
+    vector<double> original_torsions = vector<double>();
+    for(vector<RotatableDihedral*>::iterator it = dihedrals.begin(); it != dihedrals.end(); it++)
+    {
+        original_torsions.push_back((*it)->GetTorsion(model_index));
+        if(torsion_grids.at(distance(dihedrals.begin(), it)).empty())
+            return 0;
+    }
 
-            torsion_matrix[0][3] = a1 * (v12 + w12) - u1 * (b1 * v1 + c1 * w1) + (u1 * (b1 * v1 + c1 * w1) - a1 * (v12 + w12)) * cos_torsion_angle + (b1 * w1 - c1 * v1) * sin_torsion_angle;
-            torsion_matrix[1][3] = b1 * (u12 + w12) - v1 * (a1 * u1 + c1 * w1) + (v1 * (a1 * u1 + c1 * w1) - b1 * (u12 + w12)) * cos_torsion_angle + (c1 * u1 - a1 * w1) * sin_torsion_angle;
-            torsion_matrix[2][3] = c1 * (u12 + v12) - w1 * (a1 * u1 + b1 * v1) + (w1 * (a1 * u1 + b1 * v1) - c1 * (u12 + v12)) * cos_torsion_angle + (a1 * v1 - b1 * u1) * sin_torsion_angle;
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    vector<set<int> > excluded_atoms = this->FindAtomsWithinThreeBonds(all_atoms_of_assembly);
+    int number_of_models = 0;
+    vector<unsigned int> grid_indices = vector<unsigned int>(dihedrals.size(), 0);
+    while(true)
+    {
+        for(unsigned int i = 0; i < dihedrals.size(); i++)
+            dihedrals.at(i)->SetTorsion(torsion_grids.at(i).at(grid_indices.at(i)), model_index);
+        if(this->CountClashes(all_atoms_of_assembly, excluded_atoms, clash_cutoff, model_index) == 0)
+        {
+            for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+                (*it)->AddCoordinate(new Coordinate(*(*it)->GetCoordinates().at(model_index)));
+            number_of_models++;
+        }
+        /// Next combination of the grids, the last dihedral changes fastest
+        int position = dihedrals.size() - 1;
+        while(position >= 0)
+        {
+            grid_indices.at(position)++;
+            if(grid_indices.at(position) < torsion_grids.at(position).size())
+                break;
+            grid_indices.at(position) = 0;
+            position--;
+        }
+        if(position < 0)
+            break;
+    }
+    for(int i = dihedrals.size() - 1; i >= 0; i--)
+        dihedrals.at(i)->SetTorsion(original_torsions.at(i), model_index);
 
-            torsion_matrix[0][0] = u12 + (v12 + w12) * cos_torsion_angle;
-            torsion_matrix[0][1] = u1 * v1 * (1 - cos_torsion_angle) - w1 * sin_torsion_angle;
-            torsion_matrix[0][2] = u1 * w1 * (1 - cos_torsion_angle) + v1 * sin_torsion_angle;
+    stringstream ss;
+    ss << number_of_models << " rotamers without clashes have been added as new models";
+    gmml::log(__LINE__, __FILE__, gmml::INF, ss.str());
+    return number_of_models;
+}
 
-            torsion_matrix[1][0] = u1 * v1 * (1 - cos_torsion_angle) + w1 * sin_torsion_angle;
-            torsion_matrix[1][1] = v12 + (u12 + w12) * cos_torsion_angle;
-            torsion_matrix[1][2] = v1 * w1 * (1 - cos_torsion_angle) - u1 * sin_torsion_angle;
+int Assembly::CountClashes(double clash_cutoff, int model_index)
+{
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    vector<set<int> > excluded_atoms = this->FindAtomsWithinThreeBonds(all_atoms_of_assembly);
+    return this->CountClashes(all_atoms_of_assembly, excluded_atoms, clash_cutoff, model_index);
+}
 
-            torsion_matrix[2][0] = u1 * w1 * (1 - cos_torsion_angle) - v1 * sin_torsion_angle;
-            torsion_matrix[2][1] = v1 * w1 * (1 - cos_torsion_angle) + u1 * sin_torsion_angle;
-            torsion_matrix[2][2] = w12 + (u12 + v12) * cos_torsion_angle;
+int Assembly::CountClashes(AtomVector atoms, vector<set<int> > &excluded_atoms, double clash_cutoff, int model_index)
+{
+    CoordinateVector coordinates = CoordinateVector();
+    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+        coordinates.push_back((*it)->GetCoordinates().at(model_index));
+    GeometryTopology::CellList cell_list = GeometryTopology::CellList(coordinates, clash_cutoff, this->GetPeriodicBox());
+    GeometryTopology::CellList::IndexPairVector pairs = cell_list.FindPairsWithinCutoff();
+    int number_of_clashes = 0;
+    for(GeometryTopology::CellList::IndexPairVector::iterator it = pairs.begin(); it != pairs.end(); it++)
+    {
+        if(excluded_atoms.at((*it).first).find((*it).second) == excluded_atoms.at((*it).first).end())
+            number_of_clashes++;
+    }
+    return number_of_clashes;
+}
 
-            all_atoms_of_attached_residue = residue->GetAtoms();
-            for(AtomVector::iterator it = all_atoms_of_attached_residue.begin(); it != all_atoms_of_attached_residue.end(); it++)
+vector<set<int> > Assembly::FindAtomsWithinThreeBonds(AtomVector atoms)
+{
+    BondGraph bond_graph = BondGraph(atoms);
+    vector<set<int> > excluded_atoms = vector<set<int> >(atoms.size(), set<int>());
+    vector<int> current_shell = vector<int>();
+    vector<int> next_shell = vector<int>();
+    for(unsigned int i = 0; i < atoms.size(); i++)
+    {
+        current_shell.assign(1, i);
+        for(int depth = 0; depth < 3; depth++)
+        {
+            next_shell.clear();
+            for(vector<int>::iterator it = current_shell.begin(); it != current_shell.end(); it++)
             {
-                Coordinate* atom_coordinate = (*it)->GetCoordinates().at(model_index_);
-                Coordinate* result = new Coordinate();
-                result->SetX(torsion_matrix[0][0] * atom_coordinate->GetX() + torsion_matrix[0][1] * atom_coordinate->GetY() +
-                             torsion_matrix[0][2] * atom_coordinate->GetZ() + torsion_matrix[0][3]);
-                result->SetY(torsion_matrix[1][0] * atom_coordinate->GetX() + torsion_matrix[1][1] * atom_coordinate->GetY() +
-                             torsion_matrix[1][2] * atom_coordinate->GetZ() + torsion_matrix[1][3]);
-                result->SetZ(torsion_matrix[2][0] * atom_coordinate->GetX() + torsion_matrix[2][1] * atom_coordinate->GetY() +
-                             torsion_matrix[2][2] * atom_coordinate->GetZ() + torsion_matrix[2][3]);
+                for(const int* it1 = bond_graph.NeighborsBegin(*it); it1 != bond_graph.NeighborsEnd(*it); it1++)
+                {
+                    if(excluded_atoms.at(i).insert(*it1).second)
+                        next_shell.push_back(*it1);
+                }
+            }
+            current_shell.swap(next_shell);
+        }
+    }
+    return excluded_atoms;
+}
 
-                (*it)->GetCoordinates().at(model_index_)->SetX(result->GetX());
-                (*it)->GetCoordinates().at(model_index_)->SetY(result->GetY());
-                (*it)->GetCoordinates().at(model_index_)->SetZ(result->GetZ());
+pthread_mutex_t condensed_sequence_mutex = PTHREAD_MUTEX_INITIALIZER;
+void* BuildAssembliesFromCondensedSequencesThread(void* args)
+{
+    CondensedSequenceBuildThreadArgument* arg = (CondensedSequenceBuildThreadArgument*)args;
+    int number_of_sequences = arg->sequences->size();
+    Assembly assembly;
+    /// Interleave the sequences between the threads, neighbouring sequences of a combinatorial library have similar sizes
+    for(int i = arg->thread_index; i < number_of_sequences; i += arg->number_of_threads)
+    {
+        stringstream index;
+        index << i + 1;
+        try
+        {
+            /// The storage of the previous structure of the thread is reused for this one
+            assembly.Reset();
+            assembly.SetId(index.str());
+            assembly.BuildAssemblyFromCondensedSequence(arg->sequences->at(i), arg->prep_file, arg->parameter_file, true);
+            assembly.SetSourceFile(arg->prep_file_path);
+            for(vector<gmml::InputFileType>::iterator it = arg->output_types->begin(); it != arg->output_types->end(); it++)
+            {
+                if(*it == gmml::PDB)
+                {
+                    PdbFile* pdb_file = assembly.BuildPdbFileStructureFromAssembly();
+                    pdb_file->Write(arg->output_prefix + index.str() + ".pdb");
+                    delete pdb_file;
+                }
+                else if(*it == gmml::LIB)
+                {
+                    LibraryFile* library_file = assembly.BuildLibraryFileStructureFromAssembly();
+                    library_file->Write(arg->output_prefix + index.str() + ".off");
+                    delete library_file;
+                }
             }
+            pthread_mutex_lock(&condensed_sequence_mutex);
+            arg->built_sequences->at(i) = true;
+            pthread_mutex_unlock(&condensed_sequence_mutex);
+        }
+        catch(...)
+        {
+            stringstream ss;
+            ss << "Building condensed sequence " << arg->sequences->at(i) << " failed";
+            arg->messages.push_back(ss.str());
         }
     }
-    /**/
+    pthread_exit(NULL);
+}
+
+int Assembly::BuildAssembliesFromCondensedSequences(vector<string> sequences, string prep_file, string parameter_file, string output_prefix,
+                                                    vector<gmml::InputFileType> output_types, int number_of_threads)
+{
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building assemblies from condensed sequences ...");
+    /// The files are shared by the workers and live until they have been joined
+    PrepFile prep(prep_file);
+    ParameterFile* parameter = NULL;
+    if(parameter_file.compare("") != 0)
+        parameter = new ParameterFile(parameter_file);
+
+    if(number_of_threads < 1)
+        number_of_threads = 1;
+    vector<bool> built_sequences = vector<bool>(sequences.size(), false);
+    pthread_t threads[number_of_threads];
+    CondensedSequenceBuildThreadArgument arg[number_of_threads];
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        arg[i] = CondensedSequenceBuildThreadArgument(i, number_of_threads, &sequences, &prep, prep_file, parameter,
+                                                      output_prefix, &output_types, &built_sequences);
+        pthread_create(&threads[i], NULL, &BuildAssembliesFromCondensedSequencesThread, &arg[i]);
+    }
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    delete parameter;
+    /// The builders of the workers only log through the thread safe logger; failures are reported here in thread order
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        for(vector<string>::iterator it = arg[i].messages.begin(); it != arg[i].messages.end(); it++)
+        {
+            gmml::log(__LINE__, __FILE__, gmml::ERR, *it);
+        }
+    }
+
+    int number_of_built_sequences = count(built_sequences.begin(), built_sequences.end(), true);
+    stringstream ss;
+    ss << number_of_built_sequences << " out of " << sequences.size() << " condensed sequences have been built";
+    gmml::log(__LINE__, __FILE__, gmml::INF, ss.str());
+    return number_of_built_sequences;
 }
 
 void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> amino_lib_files, vector<string> glycam_lib_files,
-                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file)
+                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file,
+                                        int number_of_model_threads, bool bond_by_templates)
 {
-    cout << "Building assembly from pdb file ..." << endl;
+    GMML_SCOPED_TIMER("Assembly::BuildAssemblyFromPdbFile");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from pdb file ...");
     try
     {
         this->ClearAssembly();
-        PdbFile* pdb_file = new PdbFile(pdb_file_path);
+        this->SetDatabaseFiles(amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+        gmml::MemoryArenaScope arena_scope(&arena_);
+        PdbFile* pdb_file = new PdbFile(pdb_file_path, number_of_model_threads);
+        PdbCrystallographicCard* crystallography = pdb_file->GetCrystallography();
+        if(crystallography != NULL)
+        {
+            GeometryTopology::UnitCell unit_cell = GeometryTopology::UnitCell(crystallography->GetA(), crystallography->GetB(), crystallography->GetC(),
+                                                                              crystallography->GetAlpha(), crystallography->GetBeta(), crystallography->GetGamma());
+            if(unit_cell.IsSet())
+            {
+                unit_cell_ = unit_cell;
+                periodic_ = unit_cell.IsPeriodicBox(crystallography->GetSpaceGroup());
+            }
+        }
         ParameterFile* parameter = NULL;
         ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
         if(parameter_file.compare("") != 0)
@@ -1209,14 +1585,23 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
             for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
                 lib_files.push_back(*it);
 
+        vector<string> key_order = vector<string>();
+        PdbFile::PdbResidueAtomsMap residue_atoms_map = pdb_file->GetAllAtomsInOrder(key_order);
+        /// Only the residues of the database files that the pdb file uses are parsed
+        ResidueNameMap residue_names = ResidueNameMap();
+        for(PdbFile::PdbResidueAtomsMap::iterator it = residue_atoms_map.begin(); it != residue_atoms_map.end(); it++)
+            for(PdbFile::PdbAtomVector::iterator it1 = (*it).second->begin(); it1 != (*it).second->end(); it1++)
+                residue_names[(*it1)->GetAtomResidueName()] = (*it1)->GetAtomResidueName();
+        vector<LibraryFile*> opened_lib_files = vector<LibraryFile*>();
+        vector<PrepFile*> opened_prep_files = vector<PrepFile*>();
         if(lib_files.size() != 0)
-            lib_residues = GetAllResiduesFromMultipleLibFilesMap(lib_files);
+            lib_residues = GetResiduesFromMultipleLibFilesMap(lib_files, residue_names, opened_lib_files);
 
         if(prep_files.size() != 0)
-            prep_residues = GetAllResiduesFromMultiplePrepFilesMap(prep_files);
+            prep_residues = GetResiduesFromMultiplePrepFilesMap(prep_files, residue_names, opened_prep_files);
 
-        vector<string> key_order = vector<string>();
-        PdbFile::PdbResidueAtomsMap residue_atoms_map = pdb_file->GetAllAtomsInOrder(key_order);
+        /// Every model adds a coordinate set to the atoms, in the order of the serial numbers of the models
+        vector<PdbModelCoordinateSet> coordinate_sets = GetPdbModelCoordinateSets(pdb_file);
         for(vector<string>::iterator it = key_order.begin(); it != key_order.end(); it++)
         {
             string residue_key = *it;
@@ -1323,93 +1708,65 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                 stringstream atom_key;
                 atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
                 new_atom->SetId(atom_key.str());
-                PdbModelCard* models = pdb_file->GetModels();
-                PdbModelCard::PdbModelMap model_maps = models->GetModels();
-                if(model_maps.size() == 1)
+                AddPdbModelCoordinates(new_atom, atom, coordinate_sets);
+                vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
+                if(card_index.at(0).compare("ATOM") == 0)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
-                    vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
-                    if(card_index.at(0).compare("ATOM") == 0)
-                    {
-                        new_atom->SetDescription("Atom;");
-                    }
-                    else if(card_index.at(0).compare("HETATOM") == 0)
-                    {
-                        new_atom->SetDescription("Het;");
-                    }
+                    new_atom->SetDescription("Atom;");
                 }
-                else
+                else if(card_index.at(0).compare("HETATOM") == 0)
                 {
-                    for(PdbModelCard::PdbModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
-                    {
-                        PdbModel* model = (*it2).second;
-                        PdbModelResidueSet* residue_set = model->GetModelResidueSet();
-                        PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
-                        vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
-                        if(card_index.at(0).compare("ATOM") == 0)
-                        {
-                            PdbAtomCard* atom_card = atom_cards.at(gmml::ConvertString<int>(card_index.at(1)));
-                            PdbAtomCard::PdbAtomMap atom_map = atom_card->GetAtoms();
-                            PdbAtom* matching_atom = atom_map[atom->GetAtomSerialNumber()];
-                            string matching_residue_name = matching_atom->GetAtomResidueName();
-                            char matching_chain_id = matching_atom->GetAtomChainId();
-                            int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
-                            char matching_insertion_code = matching_atom->GetAtomInsertionCode();
-                            char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                            stringstream sss;
-                            sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                                << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                            string matching_key = sss.str();
-
-                            if(key.compare(matching_key) == 0)
-                            {
-                                GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
-                                new_atom->AddCoordinate(coordinate);
-                                new_atom->SetDescription("Atom;");
-                            }
-                        }
-                        else if(card_index.at(0).compare("HETATOM") == 0)
-                        {
-                            PdbModelResidueSet::HeterogenAtomCardVector heterogen_atom_cards = residue_set->GetHeterogenAtoms();
-                            PdbHeterogenAtomCard* heterogen_atom_card = heterogen_atom_cards.at(gmml::ConvertString<int>(card_index.at(1)));
-                            PdbAtomCard::PdbAtomMap heterogen_atom_map = heterogen_atom_card->GetHeterogenAtoms();
-                            PdbAtom* matching_heterogen_atom = heterogen_atom_map[atom->GetAtomSerialNumber()];
-                            string matching_heterogen_residue_name = matching_heterogen_atom->GetAtomResidueName();
-                            char matching_heterogen_chain_id = matching_heterogen_atom->GetAtomChainId();
-                            int matching_heterogen_sequence_number = matching_heterogen_atom->GetAtomResidueSequenceNumber();
-                            char matching_heterogen_insertion_code = matching_heterogen_atom->GetAtomInsertionCode();
-                            char matching_heterogen_alternate_location = matching_heterogen_atom->GetAtomAlternateLocation();
-                            stringstream ssss;
-                            ssss << matching_heterogen_residue_name << "_" << matching_heterogen_chain_id << "_" << matching_heterogen_sequence_number << "_"
-                                 << matching_heterogen_insertion_code << "_" << matching_heterogen_alternate_location << "_" << id_;
-                            string matching_heterogen_key = ssss.str();
-
-                            if(key.compare(matching_heterogen_key) == 0)
-                            {
-                                GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate());
-                                new_atom->AddCoordinate(coordinate);
-                                new_atom->SetDescription("Het;");
-                            }
-                        }
-                    }
+                    new_atom->SetDescription("Het;");
                 }
                 residue->AddAtom(new_atom);
             }
             this->AddResidue(residue);
-        }
+            GMML_COUNT("atoms parsed", residue->GetAtoms().size());
+        }
+        model_serial_numbers_ = GetPdbModelSerialNumbers(coordinate_sets, pdb_file->GetPath());
+        /// On request the residues are bonded by the templates of the files loaded above for the atom types
+        if(bond_by_templates && (!lib_files.empty() || !prep_files.empty()))
+        {
+            ResidueBondTemplateMap templates = ResidueBondTemplateMap();
+            this->AddLibraryResidueBondTemplates(lib_residues, templates);
+            this->AddPrepResidueBondTemplates(prep_residues, templates);
+            this->BuildStructureByResidueBondTemplates(templates);
+        }
+        for(vector<LibraryFile*>::iterator it = opened_lib_files.begin(); it != opened_lib_files.end(); it++)
+            delete (*it);
+        for(vector<PrepFile*>::iterator it = opened_prep_files.begin(); it != opened_prep_files.end(); it++)
+            delete (*it);
+        /// The atoms of the assembly have copies of everything they need from the file
+        for(PdbFile::PdbResidueAtomsMap::iterator it = residue_atoms_map.begin(); it != residue_atoms_map.end(); it++)
+            delete (*it).second;
+        delete parameter;
+        delete pdb_file;
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
 }
 
 void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files,
-                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file)
+                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file, bool bond_by_templates)
 {
-    cout << "Building assembly from pdb file ..." << endl;
+    GMML_SCOPED_TIMER("Assembly::BuildAssemblyFromPdbFile");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from pdb file ...");
     try
     {
         this->ClearAssembly();
+        this->SetDatabaseFiles(amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+        gmml::MemoryArenaScope arena_scope(&arena_);
+        PdbCrystallographicCard* crystallography = pdb_file->GetCrystallography();
+        if(crystallography != NULL)
+        {
+            GeometryTopology::UnitCell unit_cell = GeometryTopology::UnitCell(crystallography->GetA(), crystallography->GetB(), crystallography->GetC(),
+                                                                              crystallography->GetAlpha(), crystallography->GetBeta(), crystallography->GetGamma());
+            if(unit_cell.IsSet())
+            {
+                unit_cell_ = unit_cell;
+                periodic_ = unit_cell.IsPeriodicBox(crystallography->GetSpaceGroup());
+            }
+        }
         ParameterFile* parameter = NULL;
         ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
         if(parameter_file.compare("") != 0)
@@ -1431,14 +1788,23 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
             for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
                 lib_files.push_back(*it);
 
+        vector<string> key_order = vector<string>();
+        PdbFile::PdbResidueAtomsMap residue_atoms_map = pdb_file->GetAllAtomsInOrder(key_order);
+        /// Only the residues of the database files that the pdb file uses are parsed
+        ResidueNameMap residue_names = ResidueNameMap();
+        for(PdbFile::PdbResidueAtomsMap::iterator it = residue_atoms_map.begin(); it != residue_atoms_map.end(); it++)
+            for(PdbFile::PdbAtomVector::iterator it1 = (*it).second->begin(); it1 != (*it).second->end(); it1++)
+                residue_names[(*it1)->GetAtomResidueName()] = (*it1)->GetAtomResidueName();
+        vector<LibraryFile*> opened_lib_files = vector<LibraryFile*>();
+        vector<PrepFile*> opened_prep_files = vector<PrepFile*>();
         if(lib_files.size() != 0)
-            lib_residues = GetAllResiduesFromMultipleLibFilesMap(lib_files);
+            lib_residues = GetResiduesFromMultipleLibFilesMap(lib_files, residue_names, opened_lib_files);
 
         if(prep_files.size() != 0)
-            prep_residues = GetAllResiduesFromMultiplePrepFilesMap(prep_files);
+            prep_residues = GetResiduesFromMultiplePrepFilesMap(prep_files, residue_names, opened_prep_files);
 
-        vector<string> key_order = vector<string>();
-        PdbFile::PdbResidueAtomsMap residue_atoms_map = pdb_file->GetAllAtomsInOrder(key_order);
+        /// Every model adds a coordinate set to the atoms, in the order of the serial numbers of the models
+        vector<PdbModelCoordinateSet> coordinate_sets = GetPdbModelCoordinateSets(pdb_file);
         for(vector<string>::iterator it = key_order.begin(); it != key_order.end(); it++)
         {
             string residue_key = *it;
@@ -1545,92 +1911,244 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                 stringstream atom_key;
                 atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
                 new_atom->SetId(atom_key.str());
-                PdbModelCard* models = pdb_file->GetModels();
-                PdbModelCard::PdbModelMap model_maps = models->GetModels();
-                if(model_maps.size() == 1)
+                AddPdbModelCoordinates(new_atom, atom, coordinate_sets);
+                vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
+                if(card_index.at(0).compare("ATOM") == 0)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
-                    vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
-                    if(card_index.at(0).compare("ATOM") == 0)
-                    {
-                        new_atom->SetDescription("Atom;");
-                    }
-                    else if(card_index.at(0).compare("HETATOM") == 0)
-                    {
-                        new_atom->SetDescription("Het;");
-                    }
+                    new_atom->SetDescription("Atom;");
                 }
-                else
+                else if(card_index.at(0).compare("HETATOM") == 0)
                 {
-                    for(PdbModelCard::PdbModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
-                    {
-                        PdbModel* model = (*it2).second;
-                        PdbModelResidueSet* residue_set = model->GetModelResidueSet();
-                        PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
-                        vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
-                        if(card_index.at(0).compare("ATOM") == 0)
-                        {
-                            PdbAtomCard* atom_card = atom_cards.at(gmml::ConvertString<int>(card_index.at(1)));
-                            PdbAtomCard::PdbAtomMap atom_map = atom_card->GetAtoms();
-                            PdbAtom* matching_atom = atom_map[atom->GetAtomSerialNumber()];
-                            string matching_residue_name = matching_atom->GetAtomResidueName();
-                            char matching_chain_id = matching_atom->GetAtomChainId();
-                            int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
-                            char matching_insertion_code = matching_atom->GetAtomInsertionCode();
-                            char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                            stringstream sss;
-                            sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                                << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                            string matching_key = sss.str();
-
-                            if(key.compare(matching_key) == 0)
-                            {
-                                GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
-                                new_atom->AddCoordinate(coordinate);
-                                new_atom->SetDescription("Atom;");
-                            }
-                        }
-                        else if(card_index.at(0).compare("HETATOM") == 0)
-                        {
-                            PdbModelResidueSet::HeterogenAtomCardVector heterogen_atom_cards = residue_set->GetHeterogenAtoms();
-                            PdbHeterogenAtomCard* heterogen_atom_card = heterogen_atom_cards.at(gmml::ConvertString<int>(card_index.at(1)));
-                            PdbAtomCard::PdbAtomMap heterogen_atom_map = heterogen_atom_card->GetHeterogenAtoms();
-                            PdbAtom* matching_heterogen_atom = heterogen_atom_map[atom->GetAtomSerialNumber()];
-                            string matching_heterogen_residue_name = matching_heterogen_atom->GetAtomResidueName();
-                            char matching_heterogen_chain_id = matching_heterogen_atom->GetAtomChainId();
-                            int matching_heterogen_sequence_number = matching_heterogen_atom->GetAtomResidueSequenceNumber();
-                            char matching_heterogen_insertion_code = matching_heterogen_atom->GetAtomInsertionCode();
-                            char matching_heterogen_alternate_location = matching_heterogen_atom->GetAtomAlternateLocation();
-                            stringstream ssss;
-                            ssss << matching_heterogen_residue_name << "_" << matching_heterogen_chain_id << "_" << matching_heterogen_sequence_number << "_"
-                                 << matching_heterogen_insertion_code << "_" << matching_heterogen_alternate_location << "_" << id_;
-                            string matching_heterogen_key = ssss.str();
-
-                            if(key.compare(matching_heterogen_key) == 0)
-                            {
-                                GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate());
-                                new_atom->AddCoordinate(coordinate);
-                                new_atom->SetDescription("Het;");
-                            }
-                        }
-                    }
+                    new_atom->SetDescription("Het;");
                 }
                 residue->AddAtom(new_atom);
             }
             this->AddResidue(residue);
+            GMML_COUNT("atoms parsed", residue->GetAtoms().size());
+        }
+        model_serial_numbers_ = GetPdbModelSerialNumbers(coordinate_sets, pdb_file->GetPath());
+        /// On request the residues are bonded by the templates of the files loaded above for the atom types
+        if(bond_by_templates && (!lib_files.empty() || !prep_files.empty()))
+        {
+            ResidueBondTemplateMap templates = ResidueBondTemplateMap();
+            this->AddLibraryResidueBondTemplates(lib_residues, templates);
+            this->AddPrepResidueBondTemplates(prep_residues, templates);
+            this->BuildStructureByResidueBondTemplates(templates);
         }
+        for(vector<LibraryFile*>::iterator it = opened_lib_files.begin(); it != opened_lib_files.end(); it++)
+            delete (*it);
+        for(vector<PrepFile*>::iterator it = opened_prep_files.begin(); it != opened_prep_files.end(); it++)
+            delete (*it);
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
 }
 
+void Assembly::BuildAssemblyFromCifFile(string cif_file_path, vector<string> amino_lib_files, vector<string> glycam_lib_files,
+                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file, bool bond_by_templates)
+{
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from cif file ...");
+    CifFile* cif_file = NULL;
+    try
+    {
+        cif_file = new CifFile(cif_file_path);
+    }
+    catch(CifFileSpace::CifFileProcessingException &ex)
+    {
+        ex.what();
+        return;
+    }
+    this->BuildAssemblyFromCifFile(cif_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files, parameter_file, bond_by_templates);
+    delete cif_file;
+}
+
+void Assembly::BuildAssemblyFromCifFile(CifFile *cif_file, vector<string> amino_lib_files, vector<string> glycam_lib_files,
+                                        vector<string> other_lib_files, vector<string> prep_files, string parameter_file, bool bond_by_templates)
+{
+    GMML_SCOPED_TIMER("Assembly::BuildAssemblyFromCifFile");
+    this->ClearAssembly();
+    this->SetDatabaseFiles(amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    if(cif_file->HasUnitCell())
+    {
+        GeometryTopology::UnitCell unit_cell = cif_file->GetUnitCell();
+        if(unit_cell.IsSet())
+        {
+            unit_cell_ = unit_cell;
+            periodic_ = unit_cell.IsPeriodicBox(cif_file->GetSpaceGroup());
+        }
+    }
+    ParameterFile* parameter = NULL;
+    ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
+    if(parameter_file.compare("") != 0)
+    {
+        parameter = new ParameterFile(parameter_file);
+        atom_type_map = parameter->GetAtomTypes();
+    }
+    vector<string> lib_files = amino_lib_files;
+    lib_files.insert(lib_files.end(), glycam_lib_files.begin(), glycam_lib_files.end());
+    lib_files.insert(lib_files.end(), other_lib_files.begin(), other_lib_files.end());
+    const CifAtomSite& atom_site = cif_file->GetAtomSite();
+    int number_of_rows = atom_site.GetNumberOfRows();
+    if(number_of_rows == 0)
+    {
+        delete parameter;
+        return;
+    }
+    /// Only the residues of the database files that the cif file uses are parsed
+    ResidueNameMap residue_names = ResidueNameMap();
+    for(int i = 0; i < number_of_rows; i++)
+        residue_names[atom_site.GetResidueName(i)] = atom_site.GetResidueName(i);
+    LibraryFile::ResidueMap lib_residues = LibraryFile::ResidueMap();
+    PrepFile::ResidueMap prep_residues = PrepFile::ResidueMap();
+    vector<LibraryFile*> opened_lib_files = vector<LibraryFile*>();
+    vector<PrepFile*> opened_prep_files = vector<PrepFile*>();
+    if(!lib_files.empty())
+        lib_residues = GetResiduesFromMultipleLibFilesMap(lib_files, residue_names, opened_lib_files);
+    if(!prep_files.empty())
+        prep_residues = GetResiduesFromMultiplePrepFilesMap(prep_files, residue_names, opened_prep_files);
+    bool has_templates = !lib_residues.empty() || !prep_residues.empty();
+    /// The rows of the first model make the atoms; residues are keyed as in BuildAssemblyFromPdbFile and the blank
+    /// identifiers of the file are written as gmml::BLANK_SPACE, so both files of the same entry give the same ids
+    int first_model = atom_site.GetModelNumber(0);
+    unordered_map<string, Residue*> residues_by_key = unordered_map<string, Residue*>();
+    AtomVector first_model_atoms = AtomVector();
+    Residue* residue = NULL;
+    string key = "";
+    int previous_row = -1;
+    int row = 0;
+    for(; row < number_of_rows && atom_site.GetModelNumber(row) == first_model; row++)
+    {
+        const string& residue_name = atom_site.GetResidueName(row);
+        /// Consecutive rows of the same residue reuse its key; it is only built again when an identifier changes
+        if(previous_row < 0 || residue_name != atom_site.GetResidueName(previous_row) || atom_site.GetChainId(row) != atom_site.GetChainId(previous_row) ||
+                atom_site.GetResidueSequenceNumber(row) != atom_site.GetResidueSequenceNumber(previous_row) ||
+                atom_site.GetInsertionCode(row) != atom_site.GetInsertionCode(previous_row) ||
+                atom_site.GetAlternateLocation(row) != atom_site.GetAlternateLocation(previous_row))
+        {
+            stringstream ss;
+            ss << residue_name << "_" << ((atom_site.GetChainId(row).empty()) ? string(1, BLANK_SPACE) : atom_site.GetChainId(row)) << "_"
+               << atom_site.GetResidueSequenceNumber(row) << "_"
+               << ((atom_site.GetInsertionCode(row).empty()) ? string(1, BLANK_SPACE) : atom_site.GetInsertionCode(row)) << "_"
+               << ((atom_site.GetAlternateLocation(row).empty()) ? string(1, BLANK_SPACE) : atom_site.GetAlternateLocation(row)) << "_" << id_;
+            key = ss.str();
+            unordered_map<string, Residue*>::iterator found = residues_by_key.find(key);
+            if(found != residues_by_key.end())
+                residue = found->second;
+            else
+            {
+                residue = new Residue();
+                residue->SetAssembly(this);
+                residue->SetName(residue_name);
+                residue->SetId(key);
+                residues_by_key[key] = residue;
+                this->AddResidue(residue);
+            }
+        }
+        previous_row = row;
+
+        Atom* new_atom = new Atom();
+        new_atom->SetName(atom_site.GetAtomName(row));
+        new_atom->SetElementSymbol(atom_site.GetElementSymbol(row));
+        if(has_templates)
+            this->SetAtomTypeFromTemplates(new_atom, residue_name, lib_residues, prep_residues, (parameter != NULL) ? &atom_type_map : NULL);
+        new_atom->SetResidue(residue);
+        stringstream atom_key;
+        atom_key << atom_site.GetAtomName(row) << "_" << atom_site.GetSerialNumber(row) << "_" << key;
+        new_atom->SetId(atom_key.str());
+        new_atom->SetDescription((atom_site.GetIsHeterogen(row)) ? "Het;" : "Atom;");
+        new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom_site.GetX(row), atom_site.GetY(row), atom_site.GetZ(row)));
+        residue->AddAtom(new_atom);
+        first_model_atoms.push_back(new_atom);
+    }
+    GMML_COUNT("atoms parsed", first_model_atoms.size());
+    model_serial_numbers_.push_back(first_model);
+
+    /// Every other model adds a coordinate set to the atoms of the first model; a model normally lists the atoms in the same order,
+    /// otherwise its atoms are matched by atom name and residue. An atom that a model lacks keeps its coordinate of the first model
+    /// in the set of that model, so the coordinate sets stay in the order of the models
+    unordered_map<string, int> atom_indices_by_name = unordered_map<string, int>();
+    vector<GeometryTopology::Coordinate*> model_coordinates = vector<GeometryTopology::Coordinate*>();
+    while(row < number_of_rows)
+    {
+        int model_number = atom_site.GetModelNumber(row);
+        int model_start = row;
+        model_serial_numbers_.push_back(model_number);
+        int unmatched_atoms = 0;
+        model_coordinates.assign(first_model_atoms.size(), NULL);
+        for(; row < number_of_rows && atom_site.GetModelNumber(row) == model_number; row++)
+        {
+            int index = row - model_start;
+            if(!(index < (int)first_model_atoms.size() && atom_site.GetAtomName(row) == atom_site.GetAtomName(index) &&
+                    atom_site.GetResidueName(row) == atom_site.GetResidueName(index) && atom_site.GetChainId(row) == atom_site.GetChainId(index) &&
+                    atom_site.GetResidueSequenceNumber(row) == atom_site.GetResidueSequenceNumber(index) &&
+                    atom_site.GetInsertionCode(row) == atom_site.GetInsertionCode(index) &&
+                    atom_site.GetAlternateLocation(row) == atom_site.GetAlternateLocation(index)))
+            {
+                if(atom_indices_by_name.empty())
+                {
+                    for(int i = 0; i < (int)first_model_atoms.size(); i++)
+                    {
+                        stringstream ss;
+                        ss << atom_site.GetAtomName(i) << "_" << atom_site.GetResidueName(i) << "_" << atom_site.GetChainId(i) << "_"
+                           << atom_site.GetResidueSequenceNumber(i) << "_" << atom_site.GetInsertionCode(i) << "_" << atom_site.GetAlternateLocation(i);
+                        atom_indices_by_name[ss.str()] = i;
+                    }
+                }
+                stringstream ss;
+                ss << atom_site.GetAtomName(row) << "_" << atom_site.GetResidueName(row) << "_" << atom_site.GetChainId(row) << "_"
+                   << atom_site.GetResidueSequenceNumber(row) << "_" << atom_site.GetInsertionCode(row) << "_" << atom_site.GetAlternateLocation(row);
+                unordered_map<string, int>::iterator found = atom_indices_by_name.find(ss.str());
+                index = (found != atom_indices_by_name.end()) ? found->second : -1;
+            }
+            /// Atoms that are not in the first model, or are listed twice, have nowhere to go
+            if(index < 0 || model_coordinates.at(index) != NULL)
+            {
+                unmatched_atoms++;
+                continue;
+            }
+            model_coordinates.at(index) = new GeometryTopology::Coordinate(atom_site.GetX(row), atom_site.GetY(row), atom_site.GetZ(row));
+        }
+        int missing_atoms = 0;
+        for(unsigned int i = 0; i < first_model_atoms.size(); i++)
+        {
+            if(model_coordinates.at(i) == NULL)
+            {
+                model_coordinates.at(i) = new GeometryTopology::Coordinate(*first_model_atoms.at(i)->GetCoordinates().at(0));
+                missing_atoms++;
+            }
+            first_model_atoms.at(i)->AddCoordinate(model_coordinates.at(i));
+        }
+        if(unmatched_atoms != 0 || missing_atoms != 0)
+        {
+            stringstream ss;
+            ss << "Model " << model_number << " of " << cif_file->GetFilePath() << ": " << unmatched_atoms << " atom(s) without a match in the first model are ignored, "
+               << missing_atoms << " atom(s) of the first model are missing and keep their coordinates of the first model";
+            gmml::log(__LINE__, __FILE__, gmml::WAR, ss.str());
+        }
+    }
+    /// On request the residues are bonded by the templates of the files loaded above for the atom types
+    if(bond_by_templates && (!lib_files.empty() || !prep_files.empty()))
+    {
+        ResidueBondTemplateMap templates = ResidueBondTemplateMap();
+        this->AddLibraryResidueBondTemplates(lib_residues, templates);
+        this->AddPrepResidueBondTemplates(prep_residues, templates);
+        this->BuildStructureByResidueBondTemplates(templates);
+    }
+    for(vector<LibraryFile*>::iterator it = opened_lib_files.begin(); it != opened_lib_files.end(); it++)
+        delete (*it);
+    for(vector<PrepFile*>::iterator it = opened_prep_files.begin(); it != opened_prep_files.end(); it++)
+        delete (*it);
+    delete parameter;
+}
+
 void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string parameter_file)
 {
-    cout << "Building assembly from pdbqt file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from pdbqt file ...");
     try
     {
         this->ClearAssembly();
+        gmml::MemoryArenaScope arena_scope(&arena_);
         PdbqtFile* pdbqt_file = new PdbqtFile(pdbqt_file_path);
         ParameterFile* parameter = NULL;
         ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
@@ -1750,11 +2268,11 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
 
 void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string parameter_file)
 {
-    cout << "Building assembly from pdbqt file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from pdbqt file ...");
     try
     {
         this->ClearAssembly();
+        gmml::MemoryArenaScope arena_scope(&arena_);
         ParameterFile* parameter = NULL;
         ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
         if(parameter_file.compare("") != 0)
@@ -1873,9 +2391,9 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
 
 void Assembly::BuildAssemblyFromTopologyFile(string topology_file_path, string parameter_file)
 {
-    cout << "Building assembly from topology file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from topology file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     TopologyFile* topology_file = new TopologyFile(topology_file_path);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
@@ -1941,9 +2459,10 @@ void Assembly::BuildAssemblyFromTopologyFile(string topology_file_path, string p
 }
 void Assembly::BuildAssemblyFromTopologyFile(TopologyFile *topology_file, string parameter_file)
 {
-    cout << "Building assembly from topology file ..." << endl;
+    GMML_SCOPED_TIMER("Assembly::BuildAssemblyFromTopologyFile");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from topology file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -2009,9 +2528,9 @@ void Assembly::BuildAssemblyFromTopologyFile(TopologyFile *topology_file, string
 
 void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string parameter_file)
 {
-    cout << "Building assembly from library file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from library file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     LibraryFile* library_file = new LibraryFile(library_file_path);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
@@ -2098,9 +2617,9 @@ void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string par
 }
 void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string parameter_file)
 {
-    cout << "Building assembly from library file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from library file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -2187,10 +2706,14 @@ void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string pa
 
 void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path, string coordinate_file_path, string parameter_file)
 {
-    cout << "Building assembly from topology and coordinate files ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from topology and coordinate files ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     TopologyFile* topology_file = new TopologyFile(topology_file_path);
+    CoordinateFile* coordinate_file = new CoordinateFile(coordinate_file_path);
+    vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
+    this->SetUnitCell(coordinate_file->GetBox());
+    periodic_ = unit_cell_.IsPeriodicBox();
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -2251,9 +2774,7 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path
             assembly_atom->SetResidue(assembly_residue);
             assembly_atom->SetName(topology_atom->GetAtomName());
 
-            CoordinateFile* coordinate_file = new CoordinateFile(coordinate_file_path);
-            vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
-            assembly_atom->AddCoordinate(coord_file_coordinates.at(topology_atom_index-1));
+            assembly_atom->AddCoordinate(new Coordinate(*coord_file_coordinates.at(topology_atom_index-1)));
             assembly_residue->AddAtom(assembly_atom);
         }
         residues_.push_back(assembly_residue);
@@ -2261,9 +2782,13 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path
 }
 void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_file, CoordinateFile *coordinate_file, string parameter_file)
 {
-    cout << "Building assembly from topology and coordinate files ..." << endl;
+    GMML_SCOPED_TIMER("Assembly::BuildAssemblyFromTopologyCoordinateFile");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from topology and coordinate files ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
+    this->SetUnitCell(coordinate_file->GetBox());
+    periodic_ = unit_cell_.IsPeriodicBox();
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -2325,8 +2850,7 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_fi
             assembly_atom->SetResidue(assembly_residue);
             assembly_atom->SetName(topology_atom->GetAtomName());
 
-            vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
-            assembly_atom->AddCoordinate(coord_file_coordinates.at(topology_atom_index-1));
+            assembly_atom->AddCoordinate(new Coordinate(*coord_file_coordinates.at(topology_atom_index-1)));
             assembly_residue->AddAtom(assembly_atom);
         }
         residues_.push_back(assembly_residue);
@@ -2335,9 +2859,9 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_fi
 
 void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter_file)
 {
-    cout << "Building assembly from prep file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from prep file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     PrepFile* prep_file = new PrepFile(prep_file_path);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
@@ -2354,11 +2878,8 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
     for(PrepFile::ResidueMap::iterator it = prep_residues.begin(); it != prep_residues.end(); it++)
     {
         sequence_number++;
-        CoordinateVector cartesian_coordinate_list = CoordinateVector();
-        int head_atom_index = INFINITY;
-        int tail_atom_index = -INFINITY;
-        Atom* head_atom = new Atom();
-        Atom* tail_atom = new Atom();
+        Atom* head_atom = NULL;
+        Atom* tail_atom = NULL;
 
         Residue* assembly_residue = new Residue();
         assembly_residue->SetAssembly(this);
@@ -2374,6 +2895,7 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
         else
             ss << prep_residue_name << "-";
         PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+        CoordinateVector cartesian_coordinate_list = prep_residue->InstantiateTemplateCoordinates();
         int serial_number = 0;
         for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
         {
@@ -2409,79 +2931,28 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
                 assembly_atom->MolecularDynamicAtom::SetRadius(dNotSet);
             }
 
-            if(prep_residue->GetCoordinateType() == PrepFileSpace::kINT)
-            {
-                vector<Coordinate*> coordinate_list = vector<Coordinate*>();
-                int index = distance(prep_atoms.begin(), it1);
-                if(index == 0)
-                {
-                }
-                if(index == 1)
-                {
-                    int parent_index = prep_atom->GetBondIndex() - 1;
-                    Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                    coordinate_list.push_back(parent_coordinate);
-                }
-                if(index == 2)
-                {
-                    int grandparent_index = prep_atom->GetAngleIndex() - 1;
-                    int parent_index = prep_atom->GetBondIndex() - 1;
-                    Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
-                    Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                    coordinate_list.push_back(grandparent_coordinate);
-                    coordinate_list.push_back(parent_coordinate);
-                }
-                if(index > 2)
-                {
-                    int great_grandparent_index = prep_atom->GetDihedralIndex() - 1;
-                    int grandparent_index = prep_atom->GetAngleIndex() - 1;
-                    int parent_index = prep_atom->GetBondIndex() - 1;
-
-                    Coordinate* great_grandparent_coordinate = cartesian_coordinate_list.at(great_grandparent_index);
-                    Coordinate* grandparent_coordinate = cartesian_coordinate_list.at(grandparent_index);
-                    Coordinate* parent_coordinate = cartesian_coordinate_list.at(parent_index);
-                    coordinate_list.push_back(great_grandparent_coordinate);
-                    coordinate_list.push_back(grandparent_coordinate);
-                    coordinate_list.push_back(parent_coordinate);
-                }
-                Coordinate* coordinate = new Coordinate();
-                coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                 prep_atom->GetAngle(), prep_atom->GetDihedral());
-                cartesian_coordinate_list.push_back(coordinate);
-
-                assembly_atom->AddCoordinate(coordinate);
-            }
-            else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
-            {
-                assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
-            }
-            if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(prep_residue->GetDummyAtomType()) != 0)
-            {
-                if(head_atom_index > prep_atom->GetIndex())
-                {
-                    head_atom_index = prep_atom->GetIndex();
-                    head_atom = assembly_atom;
-                }
-                if(tail_atom_index < prep_atom->GetIndex())
-                {
-                    tail_atom_index = prep_atom->GetIndex();
-                    tail_atom = assembly_atom;
-                }
-            }
+            assembly_atom->AddCoordinate(cartesian_coordinate_list.at(distance(prep_atoms.begin(), it1)));
+            if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateHeadAtomPosition())
+                head_atom = assembly_atom;
+            if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateTailAtomPosition())
+                tail_atom = assembly_atom;
             if(assembly_atom->GetAtomType().compare("DU") != 0)
                 assembly_residue->AddAtom(assembly_atom);
         }
-        assembly_residue->AddHeadAtom(head_atom);
-        assembly_residue->AddTailAtom(tail_atom);
+        /// A residue without a template head or tail gets an empty placeholder atom, allocated in the arena like its other atoms
+        assembly_residue->AddHeadAtom((head_atom != NULL) ? head_atom : new Atom());
+        assembly_residue->AddTailAtom((tail_atom != NULL) ? tail_atom : new Atom());
         residues_.push_back(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
+    delete prep_file;
 }
 void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_file)
 {
-    cout << "Build assembly from prep file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from prep file ...");
     this->ClearAssembly();
+    gmml::MemoryArenaScope arena_scope(&arena_);
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -2497,11 +2968,8 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
     for(PrepFile::ResidueMap::iterator it = prep_residues.begin(); it != prep_residues.end(); it++)
     {
         sequence_number++;
-        CoordinateVector cartesian_coordinate_list = CoordinateVector();
-        int head_atom_index = INFINITY;
-        int tail_atom_index = -INFINITY;
-        Atom* head_atom = new Atom();
-        Atom* tail_atom = new Atom();
+        Atom* head_atom = NULL;
+        Atom* tail_atom = NULL;
 
         Residue* assembly_residue = new Residue();
         assembly_residue->SetAssembly(this);
@@ -2518,6 +2986,7 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
         else
             ss << prep_residue_name << "-";
         PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+        CoordinateVector cartesian_coordinate_list = CoordinateVector();
         PrepFileResidue::PrepFileAtomVector parent_atoms = prep_residue->GetAtomsParentVector();
         int serial_number = 0;
         for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
@@ -2555,6 +3024,7 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
                 assembly_atom->MolecularDynamicAtom::SetRadius(dNotSet);
             }
 
+            /// Unlike the template of the residue, the references of an atom are taken from the chain of its parent atoms
             if(prep_residue->GetCoordinateType() == PrepFileSpace::kINT)
             {
                 vector<Coordinate*> coordinate_list = vector<Coordinate*>();
@@ -2600,38 +3070,45 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
             {
                 assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
             }
-            if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(prep_residue->GetDummyAtomType()) != 0)
-            {
-                if(head_atom_index > prep_atom->GetIndex())
-                {
-                    head_atom_index = prep_atom->GetIndex();
-                    head_atom = assembly_atom;
-                }
-                if(tail_atom_index < prep_atom->GetIndex())
-                {
-                    tail_atom_index = prep_atom->GetIndex();
-                    tail_atom = assembly_atom;
-                }
-            }
+            if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateHeadAtomPosition())
+                head_atom = assembly_atom;
+            if(distance(prep_atoms.begin(), it1) == prep_residue->GetTemplateTailAtomPosition())
+                tail_atom = assembly_atom;
             if(assembly_atom->GetAtomType().compare("DU") != 0)
                 assembly_residue->AddAtom(assembly_atom);
         }
-        assembly_residue->AddHeadAtom(head_atom);
-        assembly_residue->AddTailAtom(tail_atom);
+        /// A residue without a template head or tail gets an empty placeholder atom, allocated in the arena like its other atoms
+        assembly_residue->AddHeadAtom((head_atom != NULL) ? head_atom : new Atom());
+        assembly_residue->AddTailAtom((tail_atom != NULL) ? tail_atom : new Atom());
         residues_.push_back(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
 }
 
 PdbFile* Assembly::BuildPdbFileStructureFromAssembly()
 {
-    cout << "Creating PDB file" << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating PDB file ...");
     PdbFile* pdb_file = new PdbFile();
+    gmml::MemoryArenaScope arena_scope(pdb_file->GetArena());
     PdbTitleCard* title_card = new PdbTitleCard();
     title_card->SetTitle("Generated by GMML");
     // Set pdb_file title card
     pdb_file->SetTitle(title_card);
+    if(unit_cell_.IsSet())
+    {
+        PdbCrystallographicCard* crystallography = new PdbCrystallographicCard();
+        crystallography->SetRecordName("CRYST1");
+        crystallography->SetA(unit_cell_.GetA());
+        crystallography->SetB(unit_cell_.GetB());
+        crystallography->SetC(unit_cell_.GetC());
+        crystallography->SetAlpha(unit_cell_.GetAlpha());
+        crystallography->SetBeta(unit_cell_.GetBeta());
+        crystallography->SetGamma(unit_cell_.GetGamma());
+        crystallography->SetSpaceGroup("P 1");
+        crystallography->SetZValue(1);
+        pdb_file->SetCrystallography(crystallography);
+    }
 
     PdbModelCard* model_card = new PdbModelCard();
     PdbModelCard::PdbModelMap models = PdbModelCard::PdbModelMap();
@@ -2651,11 +3128,36 @@ PdbFile* Assembly::BuildPdbFileStructureFromAssembly()
     return pdb_file;
 }
 
+PdbFile* Assembly::BuildMultiModelPdbFileStructureFromAssembly()
+{
+    PdbFile* pdb_file = this->BuildPdbFileStructureFromAssembly();
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    if(all_atoms_of_assembly.empty())
+        return pdb_file;
+    int number_of_models = all_atoms_of_assembly.at(0)->GetCoordinates().size();
+    PdbModelCard* model_card = new PdbModelCard();
+    PdbModelCard::PdbModelMap models = PdbModelCard::PdbModelMap();
+    for(int i = 0; i < number_of_models; i++)
+    {
+        PdbModel* model = new PdbModel();
+        model->SetModelSerialNumber(i + 1);
+        PdbModelResidueSet* residue_set = new PdbModelResidueSet();
+        int serial_number = 1;
+        int sequence_number = 1;
+        ExtractPdbModelCardFromAssembly(residue_set, serial_number, sequence_number, i);
+        model->SetModelResidueSet(residue_set);
+        models[i + 1] = model;
+    }
+    model_card->SetModels(models);
+    pdb_file->SetModels(model_card);
+    return pdb_file;
+}
+
 PdbqtFile* Assembly::BuildPdbqtFileStructureFromAssembly()
 {
-    cout << "Creating PDBQT file" << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating PDBQT file ...");
     PdbqtFile* pdbqt_file = new PdbqtFile();
+    gmml::MemoryArenaScope arena_scope(pdbqt_file->GetArena());
 
     PdbqtModelCard* model_card = new PdbqtModelCard();
     PdbqtModelCard::PdbqtModelMap models = PdbqtModelCard::PdbqtModelMap();
@@ -2861,9 +3363,9 @@ void Assembly::ExtractPdbqtModelCardFromAssembly(PdbqtModelResidueSet* residue_s
 
 PrepFile* Assembly::BuildPrepFileStructureFromAssembly(string parameter_file_path)
 {
-    cout << "Creating prep file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating prep file ...");
     PrepFile* prep_file = new PrepFile();
+    gmml::MemoryArenaScope arena_scope(prep_file->GetArena());
     ResidueVector assembly_residues = this->GetAllResiduesOfAssembly();
     PrepFile::ResidueMap prep_residues = PrepFile::ResidueMap();
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
@@ -3439,9 +3941,10 @@ vector<TopologicalType> Assembly::GetAllTopologicalTypesOfAtomsOfResidue(AtomVec
 
 TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_file_path, string ion_parameter_file_path)
 {
-    cout << "Creating topology file ..." << endl;
+    GMML_SCOPED_TIMER("Assembly::BuildTopologyFileStructureFromAssembly");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating topology file ...");
     TopologyFile* topology_file = new TopologyFile();
+    gmml::MemoryArenaScope arena_scope(topology_file->GetArena());
 
     topology_file->SetNumberOfAtoms(this->CountNumberOfAtoms());
     topology_file->SetNumberOfTypes(this->CountNumberOfAtomTypes());
@@ -3453,7 +3956,6 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     topology_file->SetNumberOfDihedralsExcludingHydrogen(this->CountNumberOfDihedralsExcludingHydrogen(parameter_file_path));
     //    topology_file->SetNumberOfHydrogenParameters();
     //    topology_file->SetNumberOfParameters();
-    topology_file->SetNumberOfExcludedAtoms(this->CountNumberOfExcludedAtoms());   // Does not match
     topology_file->SetNumberOfResidues(this->CountNumberOfResidues());
     topology_file->SetTotalNumberOfBonds(this->CountNumberOfBondsExcludingHydrogen(parameter_file_path));
     topology_file->SetTotalNumberOfAngles(this->CountNumberOfAnglesExcludingHydrogen(parameter_file_path));
@@ -3491,20 +3993,18 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     vector<vector<string> > inserted_dihedrals = vector<vector<string> >();
     TopologyFile::TopologyAtomPairMap pairs = TopologyFile::TopologyAtomPairMap();
     int pair_count = 1;
-    vector<string> inserted_pairs = vector<string>();
-    vector<string> excluded_atom_list = vector<string>();
+    set<string> inserted_pairs = set<string>();
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
-    ParameterFileSpace::ParameterFile::BondMap bonds = parameter_file->GetBonds();
-    ParameterFileSpace::ParameterFile::AngleMap angles = parameter_file->GetAngles();
-    ParameterFileSpace::ParameterFile::DihedralMap dihedrals = parameter_file->GetDihedrals();
-    ParameterFileSpace::ParameterFile::AtomTypeMap atom_types_map = parameter_file->GetAtomTypes();
+    /// Every parameter is looked up through the layered view; the ion parameters are a frcmod layer over the main parameter file
+    LayeredParameterFile layered_parameters = LayeredParameterFile(parameter_file);
     ParameterFile* ion_parameter_file = NULL;
-    ParameterFileSpace::ParameterFile::AtomTypeMap ion_atom_types_map = ParameterFile::AtomTypeMap();
     if(ion_parameter_file_path.compare("") != 0)
     {
         ion_parameter_file = new ParameterFile(ion_parameter_file_path, gmml::IONICMOD);
-        ion_atom_types_map = ion_parameter_file->GetAtomTypes();
+        layered_parameters.AddLayer(ion_parameter_file);
     }
+    const BondGraph& bond_graph = this->GetBondGraph();
+    vector<TopologyAtom*> topology_atoms_of_graph = vector<TopologyAtom*>(bond_graph.GetNumberOfAtoms(), NULL);
     for(ResidueVector::iterator it = assembly_residues.begin(); it != assembly_residues.end(); it++)
     {
         Residue* assembly_residue = *it;
@@ -3527,8 +4027,6 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
         for(AtomVector::iterator it1 = assembly_atoms.begin(); it1 != assembly_atoms.end(); it1++)
         {
             Atom* assembly_atom = (*it1);
-            stringstream key1;
-            key1 << assembly_atom->GetId();
             TopologyAtom* topology_atom = new TopologyAtom();
             topology_atom->SetAtomName(assembly_atom->GetName());
             topology_atom->SetAtomCharge(assembly_atom->MolecularDynamicAtom::GetCharge() * CHARGE_DIVIDER);
@@ -3545,104 +4043,94 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
             atom_counter++;
             atom_index++;
 
-            ///Bond Types, Bonds
-            AtomNode* atom_node = assembly_atom->GetNode();
-            if(atom_node != NULL)
-            {
-                AtomVector neighbors = atom_node->GetNodeNeighbors();
-                for(AtomVector::iterator it2 = neighbors.begin(); it2 != neighbors.end(); it2++)
-                {
-                    Atom* neighbor = (*it2);
-                    stringstream key2;
-                    key2 << neighbor->GetId();
-                    ExtractTopologyBondTypesFromAssembly(inserted_bond_types, assembly_atom, neighbor, bonds, bond_type_counter, topology_file);
-                    ExtractTopologyBondsFromAssembly(inserted_bonds, inserted_bond_types, assembly_atom, neighbor, topology_file);
-
-                    ///Excluded Atoms
-                    stringstream first_order_interaction;
-                    stringstream reverse_first_order_interaction;
-                    first_order_interaction << key1.str() << "-" << key2.str();
-                    reverse_first_order_interaction << key2.str() << "-" << key1.str();
-                    if(find(excluded_atom_list.begin(), excluded_atom_list.end(), first_order_interaction.str()) == excluded_atom_list.end() &&
-                            find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_first_order_interaction.str()) == excluded_atom_list.end())
-                    {
-                        excluded_atom_list.push_back(first_order_interaction.str());
-                        topology_atom->AddExcludedAtom(key2.str());
-                    }
+            int atom_graph_index = bond_graph.GetIndex(assembly_atom);
+            if(atom_graph_index >= 0)
+                topology_atoms_of_graph.at(atom_graph_index) = topology_atom;
+        }
+        topology_assembly->AddResidue(topology_residue);
+    }
 
-                    ///Angle Types, Angle
-                    AtomNode* neighbor_node = neighbor->GetNode();
-                    AtomVector neighbors_of_neighbor = neighbor_node->GetNodeNeighbors();
+    ///Bond Types, Bonds
+    for(BondGraph::BondIterator it = bond_graph.BondsBegin(); it != bond_graph.BondsEnd(); ++it)
+    {
+        Atom* assembly_atom = bond_graph.GetAtom(it->first);
+        Atom* neighbor = bond_graph.GetAtom(it->second);
+        ExtractTopologyBondTypesFromAssembly(inserted_bond_types, assembly_atom, neighbor, layered_parameters, bond_type_counter, topology_file);
+        ExtractTopologyBondsFromAssembly(inserted_bonds, inserted_bond_types, assembly_atom, neighbor, topology_file);
+    }
 
-                    for(AtomVector::iterator it3 = neighbors_of_neighbor.begin(); it3 != neighbors_of_neighbor.end(); it3++)
-                    {
-                        Atom* neighbor_of_neighbor = (*it3);
-                        stringstream key3;
-                        key3 << neighbor_of_neighbor->GetId();
-                        if(key1.str().compare(key3.str()) != 0)
-                        {
-                            ExtractTopologyAngleTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angle_types, angle_type_counter,
-                                                                  topology_file, angles);
-                            ExtractTopologyAnglesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angles, inserted_angle_types, topology_file);
-
-                            ///Excluded Atoms
-                            stringstream second_order_interaction;
-                            stringstream reverse_second_order_interaction;
-                            second_order_interaction << key1.str() << "-" << key3.str();
-                            reverse_second_order_interaction << key3.str() << "-" << key1.str();
-                            if(find(excluded_atom_list.begin(), excluded_atom_list.end(), second_order_interaction.str()) == excluded_atom_list.end() &&
-                                    find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_second_order_interaction.str()) == excluded_atom_list.end())
-                            {
-                                excluded_atom_list.push_back(second_order_interaction.str());
-                                topology_atom->AddExcludedAtom(key3.str());
-                            }
+    ///Angle Types, Angles
+    for(BondGraph::AngleIterator it = bond_graph.AnglesBegin(); it != bond_graph.AnglesEnd(); ++it)
+    {
+        Atom* assembly_atom = bond_graph.GetAtom(it->first);
+        Atom* neighbor = bond_graph.GetAtom(it->center);
+        Atom* neighbor_of_neighbor = bond_graph.GetAtom(it->last);
+        ExtractTopologyAngleTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angle_types, angle_type_counter, topology_file, layered_parameters);
+        ExtractTopologyAnglesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angles, inserted_angle_types, topology_file);
+    }
 
-                            //Dihedral Types, Dihedrals
-                            AtomNode* neighbor_of_neighbor_node = neighbor_of_neighbor->GetNode();
-                            AtomVector neighbors_of_neighbor_neighbor = neighbor_of_neighbor_node->GetNodeNeighbors();
-                            for(AtomVector::iterator it4 =  neighbors_of_neighbor_neighbor.begin(); it4 != neighbors_of_neighbor_neighbor.end(); it4++)
-                            {
-                                Atom* neighbor_of_neighbor_of_neighbor = (*it4);
-                                stringstream key4;
-                                key4 << neighbor_of_neighbor_of_neighbor->GetId();
-                                if(key2.str().compare(key4.str()) != 0)
-                                {
-                                    ExtractTopologyDihedralTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
-                                                                             inserted_dihedral_types, dihedral_type_counter, topology_file, dihedrals);
-                                    ExtractTopologyDihedralsFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
-                                                                         inserted_dihedrals, inserted_dihedral_types, dihedrals, topology_file);
-
-                                    ///Excluded Atoms
-                                    stringstream third_order_interaction;
-                                    stringstream reverse_third_order_interaction;
-                                    third_order_interaction << key1.str() << "-" << key4.str();
-                                    reverse_third_order_interaction << key4.str() << "-" << key1.str();
-                                    if(find(excluded_atom_list.begin(), excluded_atom_list.end(), third_order_interaction.str()) == excluded_atom_list.end() &&
-                                            find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_third_order_interaction.str()) == excluded_atom_list.end())
-                                    {
-                                        excluded_atom_list.push_back(third_order_interaction.str());
-                                        topology_atom->AddExcludedAtom(key4.str());
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+    ///Dihedral Types, Dihedrals
+    for(BondGraph::DihedralIterator it = bond_graph.DihedralsBegin(); it != bond_graph.DihedralsEnd(); ++it)
+    {
+        Atom* assembly_atom = bond_graph.GetAtom(it->first);
+        Atom* neighbor = bond_graph.GetAtom(it->second);
+        Atom* neighbor_of_neighbor = bond_graph.GetAtom(it->third);
+        Atom* neighbor_of_neighbor_of_neighbor = bond_graph.GetAtom(it->fourth);
+        ExtractTopologyDihedralTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
+                                                 inserted_dihedral_types, dihedral_type_counter, topology_file, layered_parameters);
+        ExtractTopologyDihedralsFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
+                                             inserted_dihedrals, inserted_dihedral_types, layered_parameters, topology_file);
+    }
+
+    ///Improper Dihedral Types, Improper Dihedrals, every atom with three bonded atoms is the center of one
+    for(int i = 0; i < bond_graph.GetNumberOfAtoms(); i++)
+    {
+        Atom* assembly_atom = bond_graph.GetAtom(i);
+        ExtractTopologyImproperDihedralTypesFromAssembly(assembly_atom, inserted_dihedral_types, dihedral_type_counter, topology_file, layered_parameters);
+        ExtractTopologyImproperDihedralsFromAssembly(assembly_atom, inserted_dihedrals, inserted_dihedral_types, layered_parameters, topology_file);
+    }
+
+    ///Excluded Atoms, every pair of atoms at most three bonds apart is listed once, at the atom with the lower index
+    vector<vector<int> > excluded_atoms = vector<vector<int> >();
+    bond_graph.FindExcludedAtoms(excluded_atoms);
+    int number_of_excluded_atoms = 0;
+    for(unsigned int i = 0; i < topology_atoms_of_graph.size(); i++)
+    {
+        TopologyAtom* topology_atom = topology_atoms_of_graph.at(i);
+        if(topology_atom == NULL)
+            continue;
+        vector<int> excluded_atom_indices = vector<int>();
+        for(vector<int>::iterator it = excluded_atoms.at(i).begin(); it != excluded_atoms.at(i).end(); it++)
+        {
+            TopologyAtom* excluded_topology_atom = topology_atoms_of_graph.at(*it);
+            if(excluded_topology_atom != NULL && excluded_topology_atom->GetIndex() > topology_atom->GetIndex())
+            {
+                excluded_atom_indices.push_back(excluded_topology_atom->GetIndex());
+                topology_atom->AddExcludedAtom(bond_graph.GetAtom(*it)->GetId());
             }
         }
-        topology_assembly->AddResidue(topology_residue);
+        sort(excluded_atom_indices.begin(), excluded_atom_indices.end());
+        /// An atom without excluded atoms has a single 0 in the list
+        number_of_excluded_atoms += (excluded_atom_indices.empty()) ? 1 : excluded_atom_indices.size();
+        topology_atom->SetExcludedAtomIndices(excluded_atom_indices);
     }
+    topology_file->SetNumberOfExcludedAtoms(number_of_excluded_atoms);
 
+    ///Pairs, every combination of the atom types of the assembly in the order the types appear first
     AtomVector all_atoms = this->GetAllAtomsOfAssembly();
+    vector<string> atom_types = vector<string>();
+    set<string> distinct_atom_types = set<string>();
     for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
-        Atom* assembly_atom = *it;
-        ///Pairs
-        for(AtomVector::iterator it2 = all_atoms.begin(); it2 != all_atoms.end(); it2++)
+        if(distinct_atom_types.insert((*it)->GetAtomType()).second)
+            atom_types.push_back((*it)->GetAtomType());
+    }
+    for(vector<string>::iterator it = atom_types.begin(); it != atom_types.end(); it++)
+    {
+        for(vector<string>::iterator it2 = atom_types.begin(); it2 != atom_types.end(); it2++)
         {
-            Atom* pair_assembly_atom = (*it2);
-            string atom_type1 = assembly_atom->GetAtomType();
-            string atom_type2 = pair_assembly_atom->GetAtomType();
+            string atom_type1 = (*it);
+            string atom_type2 = (*it2);
             vector<string> pair_vector = vector<string>();
             pair_vector.push_back(atom_type1);
             pair_vector.push_back(atom_type2);
@@ -3650,31 +4138,19 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
             sss << atom_type1 << "-" << atom_type2;
             stringstream reverse_sss;
             reverse_sss << atom_type2 << "-" << atom_type1;
-            if(find(inserted_pairs.begin(), inserted_pairs.end(), sss.str()) == inserted_pairs.end() &&
-                    find(inserted_pairs.begin(), inserted_pairs.end(), reverse_sss.str()) == inserted_pairs.end())
+            if(inserted_pairs.find(sss.str()) == inserted_pairs.end() && inserted_pairs.find(reverse_sss.str()) == inserted_pairs.end())
             {
+                GMML_COUNT("parameter lookups", 1);
                 TopologyAtomPair* topology_atom_pair = new TopologyAtomPair();
-                if(atom_types_map.find(atom_type1) != atom_types_map.end() && atom_types_map.find(atom_type2) != atom_types_map.end())
-                {
-                    ParameterFileAtom* parameter_atom1 = atom_types_map[atom_type1];
-                    ParameterFileAtom* parameter_atom2 = atom_types_map[atom_type2];
-                    double epsilon = sqrt(parameter_atom1->GetWellDepth() * parameter_atom2->GetWellDepth());
-                    double sigma = pow(parameter_atom1->GetRadius() + parameter_atom2->GetRadius(), 6);
-                    double coefficient_a = epsilon * sigma * sigma;
-                    double coefficient_b = 2 * epsilon * sigma;
-                    topology_atom_pair->SetCoefficientA(coefficient_a);
-                    topology_atom_pair->SetCoefficientB(coefficient_b);
-                    topology_atom_pair->SetPairType(sss.str());
-                    topology_atom_pair->SetIndex(pair_count);
-                    pair_count++;
-                    inserted_pairs.push_back(sss.str());
-                    pairs[sss.str()] = topology_atom_pair;
-                }
-                else if(!ion_atom_types_map.empty() && ion_atom_types_map.find(atom_type1) != ion_atom_types_map.end() &&
-                        ion_atom_types_map.find(atom_type2) != ion_atom_types_map.end())
+                ParameterFileAtom* parameter_atom1 = layered_parameters.GetNonbondedAtomType(atom_type1);
+                ParameterFileAtom* parameter_atom2 = layered_parameters.GetNonbondedAtomType(atom_type2);
+                /// Atom types without nonbonded parameters are used with their mass entry, as they were before
+                if(parameter_atom1 == NULL)
+                    parameter_atom1 = layered_parameters.GetAtomType(atom_type1);
+                if(parameter_atom2 == NULL)
+                    parameter_atom2 = layered_parameters.GetAtomType(atom_type2);
+                if(parameter_atom1 != NULL && parameter_atom2 != NULL)
                 {
-                    ParameterFileAtom* parameter_atom1 = ion_atom_types_map[atom_type1];
-                    ParameterFileAtom* parameter_atom2 = ion_atom_types_map[atom_type2];
                     double epsilon = sqrt(parameter_atom1->GetWellDepth() * parameter_atom2->GetWellDepth());
                     double sigma = pow(parameter_atom1->GetRadius() + parameter_atom2->GetRadius(), 6);
                     double coefficient_a = epsilon * sigma * sigma;
@@ -3684,41 +4160,7 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
                     topology_atom_pair->SetPairType(sss.str());
                     topology_atom_pair->SetIndex(pair_count);
                     pair_count++;
-                    inserted_pairs.push_back(sss.str());
-                    pairs[sss.str()] = topology_atom_pair;
-                }
-                else if(atom_types_map.find(atom_type1) != atom_types_map.end() && !ion_atom_types_map.empty() &&
-                        ion_atom_types_map.find(atom_type2) != ion_atom_types_map.end())
-                {
-                    ParameterFileAtom* parameter_atom1 = atom_types_map[atom_type1];
-                    ParameterFileAtom* parameter_atom2 = ion_atom_types_map[atom_type2];
-                    double epsilon = sqrt(parameter_atom1->GetWellDepth() * parameter_atom2->GetWellDepth());
-                    double sigma = pow(parameter_atom1->GetRadius() + parameter_atom2->GetRadius(), 6);
-                    double coefficient_a = epsilon * sigma * sigma;
-                    double coefficient_b = 2 * epsilon * sigma;
-                    topology_atom_pair->SetCoefficientA(coefficient_a);
-                    topology_atom_pair->SetCoefficientB(coefficient_b);
-                    topology_atom_pair->SetPairType(sss.str());
-                    topology_atom_pair->SetIndex(pair_count);
-                    pair_count++;
-                    inserted_pairs.push_back(sss.str());
-                    pairs[sss.str()] = topology_atom_pair;
-                }
-                else if(!ion_atom_types_map.empty() && ion_atom_types_map.find(atom_type1) != ion_atom_types_map.end() &&
-                        atom_types_map.find(atom_type2) != atom_types_map.end())
-                {
-                    ParameterFileAtom* parameter_atom1 = ion_atom_types_map[atom_type1];
-                    ParameterFileAtom* parameter_atom2 = atom_types_map[atom_type2];
-                    double epsilon = sqrt(parameter_atom1->GetWellDepth() * parameter_atom2->GetWellDepth());
-                    double sigma = pow(parameter_atom1->GetRadius() + parameter_atom2->GetRadius(), 6);
-                    double coefficient_a = epsilon * sigma * sigma;
-                    double coefficient_b = 2 * epsilon * sigma;
-                    topology_atom_pair->SetCoefficientA(coefficient_a);
-                    topology_atom_pair->SetCoefficientB(coefficient_b);
-                    topology_atom_pair->SetPairType(sss.str());
-                    topology_atom_pair->SetIndex(pair_count);
-                    pair_count++;
-                    inserted_pairs.push_back(sss.str());
+                    inserted_pairs.insert(sss.str());
                     pairs[sss.str()] = topology_atom_pair;
                 }
             }
@@ -3732,7 +4174,7 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     return topology_file;
 }
 
-void Assembly::ExtractTopologyBondTypesFromAssembly(vector<vector<string> > &inserted_bond_types, Atom* assembly_atom, Atom* neighbor, ParameterFileSpace::ParameterFile::BondMap &bonds,
+void Assembly::ExtractTopologyBondTypesFromAssembly(vector<vector<string> > &inserted_bond_types, Atom* assembly_atom, Atom* neighbor, const LayeredParameterFile& parameters,
                                                     int &bond_type_counter, TopologyFile* topology_file)
 {
     vector<string> atom_pair_type = vector<string>();
@@ -3747,22 +4189,16 @@ void Assembly::ExtractTopologyBondTypesFromAssembly(vector<vector<string> > &ins
     if(find(inserted_bond_types.begin(), inserted_bond_types.end(), atom_pair_type) == inserted_bond_types.end() &&
             find(inserted_bond_types.begin(), inserted_bond_types.end(), reverse_atom_pair_type) == inserted_bond_types.end())
     {
-        ParameterFileBond* parameter_file_bond;
-        if(bonds.find(atom_pair_type) != bonds.end())
-        {
-            parameter_file_bond = bonds[atom_pair_type];
+        GMML_COUNT("parameter lookups", 1);
+        ParameterFileBond* parameter_file_bond = parameters.GetBond(atom_pair_type);
+        if(parameter_file_bond != NULL)
             inserted_bond_types.push_back(atom_pair_type);
-        }
-        else if(bonds.find(reverse_atom_pair_type) != bonds.end())
-        {
-            parameter_file_bond = bonds[reverse_atom_pair_type];
+        else if((parameter_file_bond = parameters.GetBond(reverse_atom_pair_type)) != NULL)
             inserted_bond_types.push_back(reverse_atom_pair_type);
-        }
         else
         {
             stringstream ss;
             ss << atom_pair_type.at(0) << "-" << atom_pair_type.at(1) << " bond type does not exist in the parameter files";
-            cout << ss.str() << endl;
             gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
             return;
         }
@@ -3842,7 +4278,6 @@ void Assembly::ExtractTopologyBondsFromAssembly(vector<vector<string> > &inserte
         {
             stringstream ss;
             ss << atom_pair_type.at(0) << "-" << atom_pair_type.at(1) << " bond type does not exist in the parameter files";
-            cout << ss.str() << endl;
             gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
             return;
         }
@@ -3854,7 +4289,7 @@ void Assembly::ExtractTopologyBondsFromAssembly(vector<vector<string> > &inserte
 
 
 void Assembly::ExtractTopologyAngleTypesFromAssembly(Atom* assembly_atom, Atom* neighbor, Atom* neighbor_of_neighbor, vector<vector<string> > &inserted_angle_types,
-                                                     int &angle_type_counter, TopologyFile* topology_file, ParameterFileSpace::ParameterFile::AngleMap &angles)
+                                                     int &angle_type_counter, TopologyFile* topology_file, const LayeredParameterFile& parameters)
 {
     vector<string> angle_type = vector<string>();
     vector<string> reverse_angle_type = vector<string>();
@@ -3868,22 +4303,16 @@ void Assembly::ExtractTopologyAngleTypesFromAssembly(Atom* assembly_atom, Atom*
     if(find(inserted_angle_types.begin(), inserted_angle_types.end(), angle_type) == inserted_angle_types.end() &&
             find(inserted_angle_types.begin(), inserted_angle_types.end(), reverse_angle_type) == inserted_angle_types.end())
     {
-        ParameterFileAngle* parameter_file_angle;
-        if(angles.find(angle_type) != angles.end())
-        {
-            parameter_file_angle = angles[angle_type];
+        GMML_COUNT("parameter lookups", 1);
+        ParameterFileAngle* parameter_file_angle = parameters.GetAngle(angle_type);
+        if(parameter_file_angle != NULL)
             inserted_angle_types.push_back(angle_type);
-        }
-        else if(angles.find(reverse_angle_type) != angles.end())
-        {
-            parameter_file_angle = angles[reverse_angle_type];
+        else if((parameter_file_angle = parameters.GetAngle(reverse_angle_type)) != NULL)
             inserted_angle_types.push_back(reverse_angle_type);
-        }
         else
         {
             stringstream ss;
             ss << angle_type.at(0) << "-" << angle_type.at(1) << "-" << angle_type.at(2) << " angle type does not exist in the parameter files";
-            cout << ss.str() << endl;
             gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
             return;
         }
@@ -3973,7 +4402,6 @@ void Assembly::ExtractTopologyAnglesFromAssembly(Atom* assembly_atom, Atom* neig
         {
             stringstream ss;
             ss << angle_type.at(0) << "-" << angle_type.at(1) << "-" << angle_type.at(2) << " angle type does not exist in the parameter files";
-            cout << ss.str() << endl;
             gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
             return;
         }
@@ -3983,21 +4411,22 @@ void Assembly::ExtractTopologyAnglesFromAssembly(Atom* assembly_atom, Atom* neig
 }
 
 void Assembly::ExtractTopologyDihedralTypesFromAssembly(Atom *assembly_atom, Atom *neighbor, Atom *neighbor_of_neighbor, Atom *neighbor_of_neighbor_of_neighbor,
-                                                        vector<string>& inserted_dihedral_types, int &dihedral_type_counter, TopologyFile *topology_file, ParameterFile::DihedralMap& dihedrals)
+                                                        vector<string>& inserted_dihedral_types, int &dihedral_type_counter, TopologyFile *topology_file, const LayeredParameterFile& parameters)
 {
     vector<vector<string> > all_atom_type_permutations = CreateAllAtomTypePermutationsforDihedralType(assembly_atom->GetAtomType(), neighbor->GetAtomType(),
                                                                                                       neighbor_of_neighbor->GetAtomType(), neighbor_of_neighbor_of_neighbor->GetAtomType());
+    GMML_COUNT("parameter lookups", 1);
     bool is_found = false;
     for(vector<vector<string> >::iterator it = all_atom_type_permutations.begin(); it != all_atom_type_permutations.end(); it++)
     {
         vector<string> atom_types = (*it);
-        if(dihedrals[atom_types] != NULL)
+        if(parameters.GetDihedral(atom_types) != NULL)
         {
             stringstream ss;
             ss << atom_types.at(0) << "_" << atom_types.at(1) << "_" << atom_types.at(2) << "_" << atom_types.at(3);
             if(find(inserted_dihedral_types.begin(), inserted_dihedral_types.end(), ss.str()) == inserted_dihedral_types.end())
             {
-                ParameterFileDihedral* parameter_file_dihedral = dihedrals[atom_types];
+                ParameterFileDihedral* parameter_file_dihedral = parameters.GetDihedral(atom_types);
                 vector<ParameterFileDihedralTerm> dihedral_terms = parameter_file_dihedral->GetTerms();
                 for(vector<ParameterFileDihedralTerm>::iterator it1 = dihedral_terms.begin(); it1 != dihedral_terms.end(); it1++)
                 {
@@ -4026,9 +4455,14 @@ void Assembly::ExtractTopologyDihedralTypesFromAssembly(Atom *assembly_atom, Ato
         //        cout << ss.str() << endl;
         gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
     }
+}
 
-    ///Improper Dihedrals
+void Assembly::ExtractTopologyImproperDihedralTypesFromAssembly(Atom *assembly_atom, vector<string>& inserted_dihedral_types, int &dihedral_type_counter,
+                                                                TopologyFile *topology_file, const LayeredParameterFile& parameters)
+{
     AtomNode* atom_node = assembly_atom->GetNode();
+    if(atom_node == NULL)
+        return;
     AtomVector neighbors = atom_node->GetNodeNeighbors();
     if(neighbors.size() == 3)
     {
@@ -4041,13 +4475,13 @@ void Assembly::ExtractTopologyDihedralTypesFromAssembly(Atom *assembly_atom, Ato
         for(vector<vector<string> >::iterator it = all_improper_dihedrals_atom_type_permutations.begin(); it != all_improper_dihedrals_atom_type_permutations.end(); it++)
         {
             vector<string> improper_dihedral_permutation = (*it);
-            if(dihedrals[improper_dihedral_permutation] != NULL)
+            if(parameters.GetDihedral(improper_dihedral_permutation, true) != NULL)
             {
                 stringstream ss;
                 ss << improper_dihedral_permutation.at(0) << "_" << improper_dihedral_permutation.at(1) << "_" << improper_dihedral_permutation.at(2) << "_" << improper_dihedral_permutation.at(3);
                 if(find(inserted_dihedral_types.begin(), inserted_dihedral_types.end(), ss.str()) == inserted_dihedral_types.end())
                 {
-                    ParameterFileDihedral* parameter_file_dihedral = dihedrals[improper_dihedral_permutation];
+                    ParameterFileDihedral* parameter_file_dihedral = parameters.GetDihedral(improper_dihedral_permutation, true);
                     vector<ParameterFileDihedralTerm> dihedral_terms = parameter_file_dihedral->GetTerms();
                     for(vector<ParameterFileDihedralTerm>::iterator it1 = dihedral_terms.begin(); it1 != dihedral_terms.end(); it1++)
                     {
@@ -4082,7 +4516,7 @@ void Assembly::ExtractTopologyDihedralTypesFromAssembly(Atom *assembly_atom, Ato
 
 void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *neighbor, Atom *neighbor_of_neighbor, Atom *neighbor_of_neighbor_of_neighbor,
                                                     vector<vector<string> >& inserted_dihedrals, vector<string>& inserted_dihedral_types,
-                                                    ParameterFile::DihedralMap &dihedrals, TopologyFile *topology_file)
+                                                    const LayeredParameterFile& parameters, TopologyFile *topology_file)
 {
     vector<vector<string> > all_atom_type_permutations = CreateAllAtomTypePermutationsforDihedralType(assembly_atom->GetAtomType(), neighbor->GetAtomType(),
                                                                                                       neighbor_of_neighbor->GetAtomType(), neighbor_of_neighbor_of_neighbor->GetAtomType());
@@ -4137,7 +4571,7 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
             if(find(inserted_dihedrals.begin(), inserted_dihedrals.end(), dihedral) == inserted_dihedrals.end() &&
                     find(inserted_dihedrals.begin(), inserted_dihedrals.end(), reverse_dihedral) == inserted_dihedrals.end())
             {
-                ParameterFileDihedral* parameter_file_dihedral = dihedrals[atom_types];
+                ParameterFileDihedral* parameter_file_dihedral = parameters.GetDihedral(atom_types);
                 vector<ParameterFileDihedralTerm> dihedral_terms = parameter_file_dihedral->GetTerms();
                 for(vector<ParameterFileDihedralTerm>::iterator it1 = dihedral_terms.begin(); it1 != dihedral_terms.end(); it1++)
                 {
@@ -4189,9 +4623,14 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
             }
         }
     }
-    /**/
-    ///Improper Dihedrals
+}
+
+void Assembly::ExtractTopologyImproperDihedralsFromAssembly(Atom *assembly_atom, vector<vector<string> >& inserted_dihedrals, vector<string>& inserted_dihedral_types,
+                                                            const LayeredParameterFile& parameters, TopologyFile *topology_file)
+{
     AtomNode* atom_node = assembly_atom->GetNode();
+    if(atom_node == NULL)
+        return;
     AtomVector neighbors = atom_node->GetNodeNeighbors();
     if(neighbors.size() == 3)
     {
@@ -4321,7 +4760,7 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
                         find(inserted_dihedrals.begin(), inserted_dihedrals.end(), reverse_dihedral3) == inserted_dihedrals.end())
                 {
                     int permutation_index = distance(all_improper_dihedrals_atom_type_permutations.begin(), it);
-                    ParameterFileDihedral* parameter_file_dihedral = dihedrals[improper_dihedral_permutation];
+                    ParameterFileDihedral* parameter_file_dihedral = parameters.GetDihedral(improper_dihedral_permutation, true);
                     vector<ParameterFileDihedralTerm> dihedral_terms = parameter_file_dihedral->GetTerms();
                     for(vector<ParameterFileDihedralTerm>::iterator it1 = dihedral_terms.begin(); it1 != dihedral_terms.end(); it1++)
                     {
@@ -4408,27 +4847,31 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
             }
         }
     }
-    /**/
 }
 
 CoordinateFile* Assembly::BuildCoordinateFileStructureFromAssembly()
 {
-    cout << "Creating coordinate file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating coordinate file ...");
-    vector<Coordinate*> coordinates = this->GetAllCoordinates();
     CoordinateFile* coordinate_file = new CoordinateFile();
+    gmml::MemoryArenaScope arena_scope(coordinate_file->GetArena());
+    /// The coordinate file gets copies, so it can outlive the assembly
+    vector<Coordinate*> coordinates = vector<Coordinate*>();
+    vector<Coordinate*> assembly_coordinates = this->GetAllCoordinates();
+    for(vector<Coordinate*>::iterator it = assembly_coordinates.begin(); it != assembly_coordinates.end(); it++)
+        coordinates.push_back(new Coordinate(*(*it)));
     coordinate_file->SetCoordinates(coordinates);
     coordinate_file->SetNumberOfCoordinates(coordinates.size());
     string title = "Generated by GMML";
     coordinate_file->SetTitle(title);
+    coordinate_file->SetBox(this->GetUnitCell());
     return coordinate_file;
 }
 
 LibraryFile* Assembly::BuildLibraryFileStructureFromAssembly()
 {
-    cout << "Creating library file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating library file ...");
     LibraryFile* library_file = new LibraryFile();
+    gmml::MemoryArenaScope arena_scope(library_file->GetArena());
     LibraryFile::ResidueMap residue_map = LibraryFile::ResidueMap();
     ResidueVector residues_of_assembly = this->GetAllResiduesOfAssembly();
     for(ResidueVector::iterator it = residues_of_assembly.begin(); it != residues_of_assembly.end(); it++)
@@ -4484,6 +4927,7 @@ LibraryFile* Assembly::BuildLibraryFileStructureFromAssembly()
 
 void Assembly::BuildStructure(gmml::BuildingStructureOption building_option, vector<string> options, vector<string> file_paths)
 {
+    GMML_SCOPED_TIMER("Assembly::BuildStructure");
     switch(building_option)
     {
         case gmml::DISTANCE:
@@ -4550,10 +4994,16 @@ void Assembly::BuildStructure(gmml::BuildingStructureOption building_option, vec
                     types.push_back(type);
                 }
             }
+            if(types.empty() && file_paths.empty())
+            {
+                /// Without database files the templates come from the library and prep files the assembly has been read with
+                types = database_file_types_;
+                file_paths = database_file_paths_;
+            }
             if(types.size() == file_paths.size())
             {
                 stringstream ss(description_);
-                ss << "Building option: Distance;";
+                ss << "Building option: Database;";
                 for(unsigned int i = 0; i < types.size(); i++)
                 {
                     ss << "File type: " << types.at(i) << ";" << "File path: " << file_paths.at(i) << ";";
@@ -4575,9 +5025,11 @@ void* BuildStructureByDistanceThread(void* args){
     int t = arg->number_of_threads;
 
     //    cout << "Thread" << ti << " start" << endl;
+    gmml::MemoryArenaScope arena_scope(arg->arena);
     Assembly::AtomVector all_atoms_of_assembly = arg->a->GetAllAtomsOfAssembly();
     int atoms_size = all_atoms_of_assembly.size();
     int i = ti * (atoms_size/t);
+    int bonds_found = 0;
 
     for(Assembly::AtomVector::iterator it = all_atoms_of_assembly.begin() + ti * (atoms_size/t); ; it++)
     {
@@ -4633,6 +5085,7 @@ void* BuildStructureByDistanceThread(void* args){
                             neighbor_node->AddNodeNeighbor(atom);
                             neighbor_atom->SetNode(neighbor_node);
                             pthread_mutex_unlock(&mutex1);
+                            bonds_found++;
                         }
                     }
                 }
@@ -4642,25 +5095,131 @@ void* BuildStructureByDistanceThread(void* args){
     }
 
     //    cout << "Thread" << ti << " END" << endl;
+    GMML_COUNT("bonds found", bonds_found);
     pthread_exit((void*) ti);
 }
 
-void Assembly::BuildStructureByDistance(int number_of_threads, double cutoff, int model_index)
+void Assembly::BuildStructureByDistance(int number_of_threads, double cutoff, int model_index, bool rebuild)
 {
-    cout << "Building structure by distance ..." << endl;
+    bond_graph_.Clear();
+    GMML_SCOPED_TIMER("Assembly::BuildStructureByDistance");
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by distance ...");
     model_index_ = model_index;
+    /// On a rebuild the bonds of an earlier build, e.g. the template bonds of BuildAssemblyFromPdbFile, are replaced rather than added to
+    if(rebuild)
+    {
+        AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+        for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+            (*it)->SetNode(NULL);
+    }
+
+    /// The pairwise search below knows nothing about periodicity
+    if(this->GetPeriodicBox() != NULL)
+    {
+        this->BuildStructureByDistanceWithCellList(cutoff, model_index);
+        return;
+    }
 
     pthread_t threads[number_of_threads];
     DistanceCalculationThreadArgument arg[number_of_threads];
+    /// Every thread creates its nodes in an arena of its own, the assembly takes them over once the threads are done
+    vector<gmml::MemoryArena*> thread_arenas = vector<gmml::MemoryArena*>();
     for(int i = 0; i < number_of_threads; i++)
     {
-        arg[i] = DistanceCalculationThreadArgument(i, number_of_threads, model_index, cutoff, this);
+        thread_arenas.push_back(new gmml::MemoryArena());
+        arg[i] = DistanceCalculationThreadArgument(i, number_of_threads, model_index, cutoff, this, thread_arenas.at(i));
         pthread_create(&threads[i], NULL, &BuildStructureByDistanceThread, &arg[i]);
     }
     for(int i = 0; i < number_of_threads; i++)
     {
         pthread_join(threads[i], NULL);
+        arena_.Absorb(*thread_arenas.at(i));
+        delete thread_arenas.at(i);
+    }
+}
+
+void Assembly::BuildStructureByDistanceWithCellList(double cutoff, int model_index, bool rebuild)
+{
+    bond_graph_.Clear();
+    GMML_SCOPED_TIMER("Assembly::BuildStructureByDistanceWithCellList");
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by distance using cell list ...");
+    model_index_ = model_index;
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    CoordinateVector coordinates = CoordinateVector();
+    int i = 0;
+    /// On a rebuild every atom gets a new node, so the bonds of an earlier build are replaced rather than added to
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        Atom* atom = (*it);
+        AtomNode* atom_node = (rebuild) ? NULL : atom->GetNode();
+        if(atom_node == NULL)
+        {
+            atom_node = new AtomNode();
+            atom_node->SetAtom(atom);
+            atom->SetNode(atom_node);
+        }
+        atom_node->SetId(i);
+        i++;
+        coordinates.push_back(atom->GetCoordinates().at(model_index));
+    }
+
+    GeometryTopology::CellList cell_list = GeometryTopology::CellList(coordinates, cutoff, this->GetPeriodicBox());
+    GeometryTopology::CellList::IndexPairVector pairs = cell_list.FindPairsWithinCutoff();
+    for(GeometryTopology::CellList::IndexPairVector::iterator it = pairs.begin(); it != pairs.end(); it++)
+    {
+        Atom* atom = all_atoms_of_assembly.at((*it).first);
+        Atom* neighbor_atom = all_atoms_of_assembly.at((*it).second);
+        atom->GetNode()->AddNodeNeighbor(neighbor_atom);
+        neighbor_atom->GetNode()->AddNodeNeighbor(atom);
+    }
+    GMML_COUNT("bonds found", pairs.size());
+    stringstream ss;
+    ss << pairs.size() << " bonds found using " << cell_list.GetNumberOfCells(0) << "x" << cell_list.GetNumberOfCells(1) << "x"
+       << cell_list.GetNumberOfCells(2) << " cells" << ((cell_list.GetUnitCell() != NULL) ? " (periodic)" : "");
+    gmml::log(__LINE__, __FILE__, gmml::INF, ss.str());
+}
+
+void Assembly::MakeMoleculesWhole(int model_index)
+{
+    GeometryTopology::UnitCell* periodic_box = this->GetPeriodicBox();
+    if(periodic_box == NULL)
+        return;
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    map<Atom*, bool> visited = map<Atom*, bool>();
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        Atom* root = (*it);
+        if(visited[root])
+            continue;
+        visited[root] = true;
+        /// Breadth first walk over the bonded fragment; every atom is placed next to the atom it was reached from
+        AtomVector queue = AtomVector();
+        queue.push_back(root);
+        for(unsigned int index = 0; index < queue.size(); index++)
+        {
+            Atom* atom = queue.at(index);
+            if(atom->GetNode() == NULL)
+                continue;
+            Coordinate* position = atom->GetCoordinates().at(model_index);
+            AtomVector neighbors = atom->GetNode()->GetNodeNeighbors();
+            for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
+            {
+                Atom* neighbor = (*it1);
+                if(visited[neighbor])
+                    continue;
+                visited[neighbor] = true;
+                Coordinate* neighbor_position = neighbor->GetCoordinates().at(model_index);
+                double dx = neighbor_position->GetX() - position->GetX();
+                double dy = neighbor_position->GetY() - position->GetY();
+                double dz = neighbor_position->GetZ() - position->GetZ();
+                periodic_box->MinimumImage(dx, dy, dz);
+                neighbor_position->SetX(position->GetX() + dx);
+                neighbor_position->SetY(position->GetY() + dy);
+                neighbor_position->SetZ(position->GetZ() + dz);
+                queue.push_back(neighbor);
+            }
+        }
     }
 }
 
@@ -4685,6 +5244,8 @@ void Assembly::BuildStructureByOriginalFileBondingInformation()
             break;
         case gmml::TOP_CRD:
             break;
+        case gmml::CIF:
+            break;
         case gmml::MULTIPLE:
             break;
         case gmml::UNKNOWN:
@@ -4695,8 +5256,9 @@ void Assembly::BuildStructureByOriginalFileBondingInformation()
 void Assembly::BuildStructureByPDBFileInformation()
 {
     try{
-        cout << "Building structure by pdb file information ..." << endl;
+        bond_graph_.Clear();
         gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by pdb file information ...");
+        gmml::MemoryArenaScope arena_scope(&arena_);
         PdbFile* pdb_file = new PdbFile(this->GetSourceFile());
         AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
         int i = 0;
@@ -4747,61 +5309,67 @@ void Assembly::BuildStructureByPDBFileInformation()
 
 void Assembly::BuildStructureByTOPFileInformation()
 {
-    cout << "Building structure by topology file information ..." << endl;
+    bond_graph_.Clear();
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by topology file information ...");
     TopologyFile* topology_file = new TopologyFile(gmml::Split(this->GetSourceFile(), ";")[0]);
+    gmml::MemoryArenaScope arena_scope(&arena_);
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    /// The id of an atom built from a topology file carries the residue name, the residue index and the atom name of its topology atom
+    unordered_map<string, Atom*> atoms_by_key = unordered_map<string, Atom*>();
     int i = 0;
-    for (AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
-        Atom* atom_1 = (*it);
+        Atom* atom = (*it);
         AtomNode* atom_node = new AtomNode();
-        atom_node->SetAtom(atom_1);
+        atom_node->SetAtom(atom);
         atom_node->SetId(i);
         i++;
-        for(AtomVector::iterator it1 = all_atoms_of_assembly.begin(); it1 != all_atoms_of_assembly.end(); it1++)
+        atom->SetNode(atom_node);
+        vector<string> atom_id_tokens = gmml::Split(atom->GetId(), "_");
+        stringstream key;
+        key << atom_id_tokens.at(2) << "(" << atom_id_tokens.at(4) << "):" << atom_id_tokens.at(0);
+        atoms_by_key[key.str()] = atom;
+    }
+    /// Assembly atom of each topology atom index
+    AtomVector atoms_by_index = AtomVector(topology_file->GetNumberOfAtoms(), NULL);
+    TopologyAssembly::TopologyResidueMap topology_residues = topology_file->GetAssembly()->GetResidues();
+    for(TopologyAssembly::TopologyResidueMap::iterator it = topology_residues.begin(); it != topology_residues.end(); it++)
+    {
+        TopologyResidue* topology_residue = (*it).second;
+        TopologyResidue::TopologyAtomMap topology_atoms = topology_residue->GetAtoms();
+        for(TopologyResidue::TopologyAtomMap::iterator it1 = topology_atoms.begin(); it1 != topology_atoms.end(); it1++)
         {
-            if(it != it1)
-            {
-                Atom* atom_2 = (*it1);
-                stringstream ss;
-                ss << gmml::Split(atom_1->GetId(), "_").at(2) << "(" << gmml::Split(atom_1->GetId(), "_").at(4) << ")"
-                   << ":" << gmml::Split(atom_1->GetId(), "_").at(0) << "-"
-                   << gmml::Split(atom_2->GetId(), "_").at(2) << "(" << gmml::Split(atom_2->GetId(), "_").at(4) << ")"
-                   << ":" << gmml::Split(atom_2->GetId(), "_").at(0);
-                string key = ss.str();
-                TopologyFile::TopologyBondMap topology_bond = topology_file->GetBonds();
-                for(TopologyFile::TopologyBondMap::iterator it2 = topology_bond.begin(); it2 != topology_bond.end(); it2++)
-                {
-                    TopologyBond* bond = (*it2).second;
-                    stringstream sss;
-                    sss << bond->GetResidueNames().at(0) << ":" << bond->GetBonds().at(0) << "-" << bond->GetResidueNames().at(1) << ":" << bond->GetBonds().at(1);
-                    string topology_bond_key = sss.str();
-                    if(key.compare(topology_bond_key) == 0)
-                    {
-                        atom_node->AddNodeNeighbor(atom_2);
-                        break;
-                    }
-                    stringstream ssss;
-                    ssss << bond->GetResidueNames().at(1) << ":" << bond->GetBonds().at(1) << "-" << bond->GetResidueNames().at(0) << ":" << bond->GetBonds().at(0);
-                    topology_bond_key = ssss.str();
-                    if(key.compare(topology_bond_key) == 0)
-                    {
-                        atom_node->AddNodeNeighbor(atom_2);
-                        break;
-                    }
-                }
-            }
+            TopologyAtom* topology_atom = (*it1).second;
+            stringstream key;
+            key << topology_residue->GetResidueName() << "(" << topology_residue->GetIndex() << "):" << topology_atom->GetAtomName();
+            unordered_map<string, Atom*>::iterator atom_search = atoms_by_key.find(key.str());
+            if(atom_search != atoms_by_key.end() && topology_atom->GetIndex() > 0 && topology_atom->GetIndex() <= (int)atoms_by_index.size())
+                atoms_by_index.at(topology_atom->GetIndex() - 1) = atom_search->second;
         }
-        atom_1->SetNode(atom_node);
     }
+    /// One pass over the bond arrays of the file
+    const vector<int>& bond_atom_indices = topology_file->GetBondAtomIndices();
+    for(unsigned int j = 0; j + 1 < bond_atom_indices.size(); j += 2)
+    {
+        if(bond_atom_indices.at(j) < 0 || bond_atom_indices.at(j) >= (int)atoms_by_index.size() ||
+                bond_atom_indices.at(j + 1) < 0 || bond_atom_indices.at(j + 1) >= (int)atoms_by_index.size())
+            continue;
+        Atom* atom_1 = atoms_by_index.at(bond_atom_indices.at(j));
+        Atom* atom_2 = atoms_by_index.at(bond_atom_indices.at(j + 1));
+        if(atom_1 == NULL || atom_2 == NULL || atom_1 == atom_2)
+            continue;
+        atom_1->GetNode()->AddNodeNeighbor(atom_2);
+        atom_2->GetNode()->AddNodeNeighbor(atom_1);
+    }
+    delete topology_file;
 }
 
 void Assembly::BuildStructureByLIBFileInformation()
 {
-    cout << "Building structure by library file information..." << endl;
+    bond_graph_.Clear();
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by library file information ...");
     LibraryFile* library_file = new LibraryFile(this->GetSourceFile());
+    gmml::MemoryArenaScope arena_scope(&arena_);
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
     int i = 0;
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
@@ -4842,63 +5410,177 @@ void Assembly::BuildStructureByLIBFileInformation()
                 }
             }
         }
-        atom->SetNode(atom_node);
+        atom->SetNode(atom_node);
+    }
+    delete library_file;
+}
+
+void Assembly::BuildStructureByPrepFileInformation()
+{
+    PrepFile* prep_file = new PrepFile(this->GetSourceFile());
+    this->BuildStructureByPrepFileInformation(prep_file);
+    delete prep_file;
+}
+
+void Assembly::BuildStructureByPrepFileInformation(PrepFile *prep_file)
+{
+    bond_graph_.Clear();
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by prep file information ...");
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    int i = 0;
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        Atom* atom = (*it);
+        AtomNode* atom_node = new AtomNode();
+        atom_node->SetAtom(atom);
+        atom_node->SetId(i);
+        i++;
+        Residue* assembly_residue = atom->GetResidue();
+        //        cout << assembly_residue->GetName() << endl;
+        PrepFileResidue* prep_residue = prep_file->GetPrepResidueByResidueName(assembly_residue->GetName());
+        if(prep_residue != NULL)
+        {
+            PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+            const vector<vector<int> >& template_bonds = prep_residue->GetTemplateBonds();
+            int prep_atom_position = -1;
+            for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
+            {
+                if((*it1)->GetName().compare(atom->GetName()) == 0)
+                {
+                    prep_atom_position = distance(prep_atoms.begin(), it1);
+                    break;
+                }
+            }
+            if(prep_atom_position != -1)
+            {
+                const vector<int>& bonded_atom_positions = template_bonds.at(prep_atom_position);
+                /// Bonds of a prep residue never leave the residue, so only the atoms of the same residue are candidates
+                AtomVector residue_atoms = assembly_residue->GetAtoms();
+                for(vector<int>::const_iterator it1 = bonded_atom_positions.begin(); it1 != bonded_atom_positions.end(); it1++)
+                {
+                    string bonded_atom_name = prep_atoms.at(*it1)->GetName();
+                    for(AtomVector::iterator it2 = residue_atoms.begin(); it2 != residue_atoms.end(); it2++)
+                    {
+                        Atom* assembly_atom = (*it2);
+                        if(assembly_atom->GetName().compare(bonded_atom_name) == 0)
+                        {
+                            atom_node->AddNodeNeighbor(assembly_atom);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        atom->SetNode(atom_node);
+    }
+}
+
+void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::InputFileType> types, vector<string> file_paths)
+{
+    GMML_SCOPED_TIMER("Assembly::BuildStructureByDatabaseFilesBondingInformation");
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by dataset files information ...");
+    ResidueNameMap residue_names = ResidueNameMap();
+    ResidueVector residues = this->GetAllResiduesOfAssembly();
+    for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
+        residue_names[(*it)->GetName()] = (*it)->GetName();
+    ResidueBondTemplateMap templates = this->LoadResidueBondTemplates(types, file_paths, residue_names);
+    this->BuildStructureByResidueBondTemplates(templates);
+}
+
+Assembly::ResidueBondTemplateMap Assembly::LoadResidueBondTemplates(vector<gmml::InputFileType> types, vector<string> file_paths, ResidueNameMap& residue_names)
+{
+    ResidueBondTemplateMap templates = ResidueBondTemplateMap();
+    for(unsigned int i = 0; i < types.size() && i < file_paths.size(); i++)
+    {
+        if(types.at(i) == gmml::LIB)
+        {
+            LibraryFile* library_file = new LibraryFile(file_paths.at(i));
+            LibraryFile::ResidueMap library_residues = LibraryFile::ResidueMap();
+            for(ResidueNameMap::iterator it = residue_names.begin(); it != residue_names.end(); it++)
+            {
+                if(templates.find((*it).first) != templates.end())
+                    continue;
+                LibraryFileResidue* library_residue = library_file->GetLibraryResidueByResidueName((*it).first);
+                if(library_residue != NULL)
+                    library_residues[(*it).first] = library_residue;
+            }
+            this->AddLibraryResidueBondTemplates(library_residues, templates);
+            delete library_file;
+        }
+        else if(types.at(i) == gmml::PREP)
+        {
+            PrepFile* prep_file = new PrepFile(file_paths.at(i));
+            PrepFile::ResidueMap prep_residues = PrepFile::ResidueMap();
+            for(ResidueNameMap::iterator it = residue_names.begin(); it != residue_names.end(); it++)
+            {
+                if(templates.find((*it).first) != templates.end())
+                    continue;
+                PrepFileResidue* prep_residue = prep_file->GetPrepResidueByResidueName((*it).first);
+                if(prep_residue != NULL)
+                    prep_residues[(*it).first] = prep_residue;
+            }
+            this->AddPrepResidueBondTemplates(prep_residues, templates);
+            delete prep_file;
+        }
+    }
+    return templates;
+}
+
+void Assembly::AddLibraryResidueBondTemplates(const LibraryFile::ResidueMap& library_residues, ResidueBondTemplateMap& templates)
+{
+    for(LibraryFile::ResidueMap::const_iterator it = library_residues.begin(); it != library_residues.end(); it++)
+    {
+        if(templates.find((*it).first) != templates.end())
+            continue;
+        AtomBondTemplateMap& residue_template = templates[(*it).first];
+        LibraryFileResidue::AtomMap library_atoms = (*it).second->GetAtoms();
+        for(LibraryFileResidue::AtomMap::iterator it1 = library_atoms.begin(); it1 != library_atoms.end(); it1++)
+        {
+            LibraryFileAtom* library_atom = (*it1).second;
+            vector<string>& bonded_atom_names = residue_template[library_atom->GetName()];
+            vector<int> library_bonded_atom_indices = library_atom->GetBondedAtomsIndices();
+            for(vector<int>::iterator it2 = library_bonded_atom_indices.begin(); it2 != library_bonded_atom_indices.end(); it2++)
+            {
+                LibraryFileResidue::AtomMap::iterator bonded_atom_search = library_atoms.find(*it2);
+                if(bonded_atom_search != library_atoms.end())
+                    bonded_atom_names.push_back(bonded_atom_search->second->GetName());
+            }
+        }
     }
 }
 
-void Assembly::BuildStructureByPrepFileInformation()
+void Assembly::AddPrepResidueBondTemplates(PrepFile::ResidueMap& prep_residues, ResidueBondTemplateMap& templates)
 {
-    cout << "Building structure by prep file information ..." << endl;
-    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by prep file information ...");
-    PrepFile* prep_file = new PrepFile(this->GetSourceFile());
-    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
-    int i = 0;
-    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    for(PrepFile::ResidueMap::iterator it = prep_residues.begin(); it != prep_residues.end(); it++)
     {
-        Atom* atom = (*it);
-        AtomNode* atom_node = new AtomNode();
-        atom_node->SetAtom(atom);
-        atom_node->SetId(i);
-        i++;
-        Residue* assembly_residue = atom->GetResidue();
-        //        cout << assembly_residue->GetName() << endl;
-        PrepFileResidue* prep_residue = prep_file->GetResidues()[assembly_residue->GetName()];
-        if(prep_residue != NULL)
+        if(templates.find((*it).first) != templates.end())
+            continue;
+        AtomBondTemplateMap& residue_template = templates[(*it).first];
+        PrepFileResidue* prep_residue = (*it).second;
+        PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
+        const vector<vector<int> >& template_bonds = prep_residue->GetTemplateBonds();
+        for(unsigned int j = 0; j < prep_atoms.size() && j < template_bonds.size(); j++)
         {
-            PrepFileAtom* prep_atom = prep_residue->GetPrepAtomByName(atom->GetName());
-            if(prep_atom != NULL)
-            {
-                vector<int> bonded_atoms_index = prep_residue->GetBondingsOfResidue()[prep_residue->GetAtomIndexByName(atom->GetName())];
-                for(vector<int>::iterator it1 = bonded_atoms_index.begin(); it1 != bonded_atoms_index.end(); it1++)
-                {
-                    int bonded_atom_index = (*it1);
-                    PrepFileAtom* bonded_atom = prep_residue->GetPrepAtomByName(prep_residue->GetAtomNameByIndex(bonded_atom_index));
-                    stringstream ss;
-                    ss << prep_residue->GetName() << ":" << bonded_atom->GetName();
-                    for(AtomVector::iterator it2 = all_atoms_of_assembly.begin(); it2 != all_atoms_of_assembly.end(); it2++)
-                    {
-                        Atom* assembly_atom = (*it2);
-                        vector<string> atom_id_tokens = gmml::Split(assembly_atom->GetId(), "_");
-                        stringstream sss;
-                        sss << atom_id_tokens.at(2) << ":" << atom_id_tokens.at(0);
-                        if(sss.str().compare(ss.str()) == 0)
-                        {
-                            atom_node->AddNodeNeighbor(assembly_atom);
-                            break;
-                        }
-                    }
-                }
-            }
+            if(prep_atoms.at(j)->GetType().compare("DU") == 0)
+                continue;
+            vector<string>& bonded_atom_names = residue_template[prep_atoms.at(j)->GetName()];
+            for(vector<int>::const_iterator it1 = template_bonds.at(j).begin(); it1 != template_bonds.at(j).end(); it1++)
+                bonded_atom_names.push_back(prep_atoms.at(*it1)->GetName());
         }
-        atom->SetNode(atom_node);
     }
 }
 
-void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::InputFileType> types, vector<string> file_paths)
+void Assembly::BuildStructureByResidueBondTemplates(ResidueBondTemplateMap& templates, double cutoff, int model_index)
 {
-    cout << "Building structure by dataset files information ..." << endl;
-    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by dataset files information ...");
+    bond_graph_.Clear();
+    GMML_SCOPED_TIMER("Assembly::BuildStructureByResidueBondTemplates");
+    gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by residue bond templates ...");
+    model_index_ = model_index;
+    gmml::MemoryArenaScope arena_scope(&arena_);
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    /// Whether the bonds of each atom are given by a template
+    vector<bool> templated = vector<bool>(all_atoms_of_assembly.size(), false);
     int i = 0;
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
@@ -4907,75 +5589,85 @@ void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::Inpu
         atom_node->SetAtom(atom);
         atom_node->SetId(i);
         i++;
-        Residue* assembly_residue = atom->GetResidue();
-        for(unsigned int i = 0; i < types.size(); i++)
+        atom->SetNode(atom_node);
+    }
+
+    /// Bonds inside the residues, the template atom names are resolved among the atoms of the same residue only
+    int number_of_template_bonds = 0;
+    int atom_index = 0;
+    unordered_map<string, Atom*> residue_atoms_by_name = unordered_map<string, Atom*>();
+    ResidueVector all_residues_of_assembly = this->GetAllResiduesOfAssembly();
+    for(ResidueVector::iterator it = all_residues_of_assembly.begin(); it != all_residues_of_assembly.end(); it++)
+    {
+        Residue* residue = (*it);
+        AtomVector residue_atoms = residue->GetAtoms();
+        ResidueBondTemplateMap::iterator template_search = templates.find(residue->GetName());
+        if(template_search == templates.end())
         {
-            if(types.at(i) == gmml::LIB)
-            {
-                string lib_path = file_paths.at(i);
-                LibraryFile* library_file = new LibraryFile(lib_path);
-                LibraryFileResidue* library_residue = library_file->GetLibraryResidueByResidueName(assembly_residue->GetName());
-                if(library_residue != NULL)
-                {
-                    LibraryFileAtom* library_atom = library_residue->GetLibraryAtomByAtomName(atom->GetName());
-                    if(library_atom != NULL)
-                    {
-                        vector<int> library_bonded_atom_indices = library_atom->GetBondedAtomsIndices();
-                        for(vector<int>::iterator it1 = library_bonded_atom_indices.begin(); it1 != library_bonded_atom_indices.end(); it1++)
-                        {
-                            int library_bonded_atom_index = (*it1);
-                            LibraryFileAtom* library_atom = library_residue->GetAtomByIndex(library_bonded_atom_index);
-                            for(AtomVector::iterator it2 = all_atoms_of_assembly.begin(); it2 != all_atoms_of_assembly.end(); it2++)
-                            {
-                                Atom* assembly_atom = (*it2);
-                                string assembly_atom_id = assembly_atom->GetId();
-                                stringstream ss;
-                                ss << library_residue->GetName() << ":" << library_atom->GetName();
-                                string library_atom_id = ss.str();
-                                if(assembly_atom_id.compare(library_atom_id) == 0)
-                                {
-                                    atom_node->AddNodeNeighbor(assembly_atom);
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            if(types.at(i) == gmml::PREP)
+            atom_index += residue_atoms.size();
+            continue;
+        }
+        AtomBondTemplateMap& residue_template = template_search->second;
+        residue_atoms_by_name.clear();
+        for(AtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++)
+            residue_atoms_by_name[(*it1)->GetName()] = (*it1);
+        for(AtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++, atom_index++)
+        {
+            Atom* atom = (*it1);
+            AtomBondTemplateMap::iterator atom_template_search = residue_template.find(atom->GetName());
+            if(atom_template_search == residue_template.end())
+                continue;
+            templated.at(atom_index) = true;
+            vector<string>& bonded_atom_names = atom_template_search->second;
+            for(vector<string>::iterator it2 = bonded_atom_names.begin(); it2 != bonded_atom_names.end(); it2++)
             {
-                string prep_path = file_paths.at(i);
-                PrepFile* prep_file = new PrepFile(prep_path);
-                PrepFileResidue* prep_residue = prep_file->GetResidues()[assembly_residue->GetName()];
-                if(prep_residue != NULL)
-                {
-                    PrepFileAtom* prep_atom = prep_residue->GetPrepAtomByName(atom->GetName());
-                    if(prep_atom != NULL)
-                    {
-                        vector<int> bonded_atoms_index = prep_residue->GetBondingsOfResidue()[prep_residue->GetAtomIndexByName(atom->GetName())];
-                        for(vector<int>::iterator it1 = bonded_atoms_index.begin(); it1 != bonded_atoms_index.end(); it1++)
-                        {
-                            int bonded_atom_index = (*it1);
-                            PrepFileAtom* bonded_atom = prep_residue->GetPrepAtomByName(prep_residue->GetAtomNameByIndex(bonded_atom_index));
-                            stringstream ss;
-                            ss << prep_residue->GetName() << ":" << bonded_atom->GetName();
-                            for(AtomVector::iterator it2 = all_atoms_of_assembly.begin(); it2 != all_atoms_of_assembly.end(); it2++)
-                            {
-                                Atom* assembly_atom = (*it2);
-                                if(assembly_atom->GetId().compare(ss.str()) == 0)
-                                {
-                                    atom_node->AddNodeNeighbor(assembly_atom);
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-
+                unordered_map<string, Atom*>::iterator bonded_atom_search = residue_atoms_by_name.find(*it2);
+                if(bonded_atom_search == residue_atoms_by_name.end() || bonded_atom_search->second == atom)
+                    continue;
+                Atom* bonded_atom = bonded_atom_search->second;
+                AtomVector neighbors = atom->GetNode()->GetNodeNeighbors();
+                if(find(neighbors.begin(), neighbors.end(), bonded_atom) != neighbors.end())
+                    continue;
+                atom->GetNode()->AddNodeNeighbor(bonded_atom);
+                bonded_atom->GetNode()->AddNodeNeighbor(atom);
+                number_of_template_bonds++;
             }
-            atom->SetNode(atom_node);
         }
     }
+
+    /// Linkages between residues and atoms without a template: distance test over a cell list
+    CoordinateVector coordinates = CoordinateVector();
+    vector<int> coordinate_atom_indices = vector<int>();
+    for(unsigned int j = 0; j < all_atoms_of_assembly.size(); j++)
+    {
+        CoordinateVector atom_coordinates = all_atoms_of_assembly.at(j)->GetCoordinates();
+        if((int)atom_coordinates.size() <= model_index)
+            continue;
+        coordinates.push_back(atom_coordinates.at(model_index));
+        coordinate_atom_indices.push_back(j);
+    }
+    int number_of_distance_bonds = 0;
+    GeometryTopology::CellList cell_list = GeometryTopology::CellList(coordinates, cutoff, this->GetPeriodicBox());
+    GeometryTopology::CellList::IndexPairVector pairs = cell_list.FindPairsWithinCutoff();
+    for(GeometryTopology::CellList::IndexPairVector::iterator it = pairs.begin(); it != pairs.end(); it++)
+    {
+        int first = coordinate_atom_indices.at((*it).first);
+        int second = coordinate_atom_indices.at((*it).second);
+        Atom* atom = all_atoms_of_assembly.at(first);
+        Atom* neighbor_atom = all_atoms_of_assembly.at(second);
+        if(atom->GetResidue() == neighbor_atom->GetResidue() && templated.at(first) && templated.at(second))
+            continue;
+        AtomVector neighbors = atom->GetNode()->GetNodeNeighbors();
+        if(find(neighbors.begin(), neighbors.end(), neighbor_atom) != neighbors.end())
+            continue;
+        atom->GetNode()->AddNodeNeighbor(neighbor_atom);
+        neighbor_atom->GetNode()->AddNodeNeighbor(atom);
+        number_of_distance_bonds++;
+    }
+    GMML_COUNT("bonds found", number_of_template_bonds + number_of_distance_bonds);
+    stringstream ss;
+    ss << number_of_template_bonds << " bonds from residue templates, " << number_of_distance_bonds << " bonds by distance";
+    gmml::log(__LINE__, __FILE__, gmml::INF, ss.str());
 }
 
 int Assembly::CountNumberOfAtoms()
@@ -5118,19 +5810,7 @@ int Assembly::CountNumberOfBondsExcludingHydrogen(string parameter_file_path)
 
 int Assembly::CountNumberOfBonds()
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
-    int counter = 0;
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        AtomNode* atom_node = atom->GetNode();
-        if(atom_node != NULL)
-        {
-            AtomVector node_neighbors = atom_node->GetNodeNeighbors();
-            counter += node_neighbors.size();
-        }
-    }
-    return counter/2;
+    return this->GetBondGraph().GetNumberOfBonds();
 }
 
 int Assembly::CountNumberOfBondTypes(string parameter_file_path)
@@ -5289,36 +5969,7 @@ int Assembly::CountNumberOfAnglesExcludingHydrogen(string parameter_file_path)
 
 int Assembly::CountNumberOfAngles()
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
-    int counter = 0;
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        stringstream ss;
-        ss << atom->GetId();
-        AtomNode* atom_node = atom->GetNode();
-        if(atom_node != NULL)
-        {
-            AtomVector neighbors = atom_node->GetNodeNeighbors();
-            for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
-            {
-                Atom* neighbor = (*it1);
-                AtomNode* neighbor_atom_node = neighbor->GetNode();
-                AtomVector neighbors_of_neighbor = neighbor_atom_node->GetNodeNeighbors();
-                for(AtomVector::iterator it2 = neighbors_of_neighbor.begin(); it2 != neighbors_of_neighbor.end(); it2++)
-                {
-                    Atom* neighbor_of_neighbor = (*it2);
-                    stringstream ss1;
-                    ss1 << neighbor_of_neighbor->GetId();
-                    if(ss.str().compare(ss1.str()) != 0)
-                    {
-                        counter++;
-                    }
-                }
-            }
-        }
-    }
-    return counter/2;
+    return this->GetBondGraph().CountAngles();
 }
 
 int Assembly::CountNumberOfAngleTypes(string parameter_file_path)
@@ -6119,84 +6770,25 @@ vector<vector<string> > Assembly::CreateAllAtomTypePermutationsforImproperDihedr
 
 Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyWithAtLeastThreeNeighbors()
 {
-    AtomVector all_atoms = GetAllAtomsOfAssembly();
+    const BondGraph& bond_graph = this->GetBondGraph();
     AtomVector atoms_with_at_least_three_neighbors = AtomVector();
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    for(int i = 0; i < bond_graph.GetNumberOfAtoms(); i++)
     {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        AtomVector neighbors = node->GetNodeNeighbors();
-        if(neighbors.size() > 2)
-            atoms_with_at_least_three_neighbors.push_back(atom);
+        if(bond_graph.GetDegree(i) > 2)
+            atoms_with_at_least_three_neighbors.push_back(bond_graph.GetAtom(i));
     }
     return atoms_with_at_least_three_neighbors;
 }
 
 int Assembly::CountNumberOfExcludedAtoms()
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
-    vector<string> excluded_atom_list = vector<string>();
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        stringstream ss;
-        ss << atom->GetId();
-        AtomNode* node = atom->GetNode();
-        if(node != NULL)
-        {
-            AtomVector neighbors = node->GetNodeNeighbors();
-            for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
-            {
-                Atom* neighbor = (*it1);
-                stringstream ss1;
-                ss1 << neighbor->GetId();
-                stringstream first_order_interaction;
-                stringstream reverse_first_order_interaction;
-                first_order_interaction << ss.str() << "-" << ss1.str();
-                reverse_first_order_interaction << ss1.str() << "-" << ss.str();
-                if(find(excluded_atom_list.begin(), excluded_atom_list.end(), first_order_interaction.str()) == excluded_atom_list.end() &&
-                        find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_first_order_interaction.str()) == excluded_atom_list.end())
-                    excluded_atom_list.push_back(first_order_interaction.str());
-                AtomNode* neighbor_node = neighbor->GetNode();
-                AtomVector neighbor_of_neighbors = neighbor_node->GetNodeNeighbors();
-                for(AtomVector::iterator it2 = neighbor_of_neighbors.begin(); it2 != neighbor_of_neighbors.end(); it2++)
-                {
-                    Atom* neighbor_of_neighbor = (*it2);
-                    stringstream ss2;
-                    ss2 << neighbor_of_neighbor->GetId();
-                    if(ss.str().compare(ss2.str()) != 0)
-                    {
-                        stringstream second_order_interaction;
-                        stringstream reverse_second_order_interaction;
-                        second_order_interaction << ss.str() << "-" << ss2.str();
-                        reverse_second_order_interaction << ss2.str() << "-" << ss.str();
-                        if(find(excluded_atom_list.begin(), excluded_atom_list.end(), second_order_interaction.str()) == excluded_atom_list.end() &&
-                                find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_second_order_interaction.str()) == excluded_atom_list.end())
-                            excluded_atom_list.push_back(second_order_interaction.str());
-                        AtomNode* neighbor_of_neighbor_node = neighbor_of_neighbor->GetNode();
-                        AtomVector neighbor_of_neighbor_of_neighbors = neighbor_of_neighbor_node->GetNodeNeighbors();
-                        for(AtomVector::iterator it3 = neighbor_of_neighbor_of_neighbors.begin(); it3 != neighbor_of_neighbor_of_neighbors.end(); it3++)
-                        {
-                            Atom* neighbor_of_neighbor_of_neighbor = (*it3);
-                            stringstream ss3;
-                            ss3 << neighbor_of_neighbor_of_neighbor->GetId();
-                            if(ss1.str().compare(ss3.str()) != 0)
-                            {
-                                stringstream third_order_interaction;
-                                stringstream reverse_third_order_interaction;
-                                third_order_interaction << ss.str() << "-" << ss3.str();
-                                reverse_third_order_interaction << ss3.str() << "-" << ss.str();
-                                if(find(excluded_atom_list.begin(), excluded_atom_list.end(), third_order_interaction.str()) == excluded_atom_list.end() &&
-                                        find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_third_order_interaction.str()) == excluded_atom_list.end())
-                                    excluded_atom_list.push_back(third_order_interaction.str());
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return excluded_atom_list.size();
+    vector<vector<int> > excluded_atoms = vector<vector<int> >();
+    this->GetBondGraph().FindExcludedAtoms(excluded_atoms);
+    /// Every pair is counted once, at the atom with the lower index
+    int counter = 0;
+    for(unsigned int i = 0; i < excluded_atoms.size(); i++)
+        counter += excluded_atoms.at(i).end() - upper_bound(excluded_atoms.at(i).begin(), excluded_atoms.at(i).end(), (int)i);
+    return counter;
 }
 
 int Assembly::CountMaxNumberOfAtomsInLargestResidue()
@@ -6228,7 +6820,11 @@ Assembly::AtomVector Assembly::Select(string pattern)
     this->GetHierarchicalMapOfAssembly(hierarchical_map, index);
 
     for(HierarchicalContainmentMap::iterator it = hierarchical_map.begin(); it != hierarchical_map.end(); it++)
-        cout << (*it).first << " " << (*it).second.size() << endl;
+    {
+        stringstream level;
+        level << (*it).first << " " << (*it).second.size();
+        gmml::log(__LINE__, __FILE__, gmml::INF, level.str());
+    }
 
     SelectPatternMap select_pattern_map = ParsePatternString(pattern);
 
@@ -8398,6 +8994,16 @@ void Assembly::ClearAssembly()
 {
     this->residues_.clear();
     this->assemblies_.clear();
+    for(AssemblyVector::iterator it = owned_assemblies_.begin(); it != owned_assemblies_.end(); it++)
+        delete (*it);
+    this->owned_assemblies_.clear();
+    this->unit_cell_ = GeometryTopology::UnitCell();
+    this->periodic_ = false;
+    this->database_file_types_.clear();
+    this->database_file_paths_.clear();
+    this->model_serial_numbers_.clear();
+    this->bond_graph_.Clear();
+    this->arena_.Rewind();
     //    this->source_file_ = "";
     //    this->source_file_type_ = UNKNOWN;
     //    this->chemical_type_ = "";
@@ -8409,6 +9015,91 @@ void Assembly::ClearAssembly()
     //    this->model_index_ = 0;
 }
 
+void Assembly::SetDatabaseFiles(vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files,
+                                vector<string> prep_files)
+{
+    database_file_types_.clear();
+    database_file_paths_.clear();
+    vector<string> lib_files = amino_lib_files;
+    lib_files.insert(lib_files.end(), glycam_lib_files.begin(), glycam_lib_files.end());
+    lib_files.insert(lib_files.end(), other_lib_files.begin(), other_lib_files.end());
+    for(vector<string>::iterator it = lib_files.begin(); it != lib_files.end(); it++)
+    {
+        database_file_types_.push_back(gmml::LIB);
+        database_file_paths_.push_back(*it);
+    }
+    for(vector<string>::iterator it = prep_files.begin(); it != prep_files.end(); it++)
+    {
+        database_file_types_.push_back(gmml::PREP);
+        database_file_paths_.push_back(*it);
+    }
+}
+
+void Assembly::SetAtomTypeFromTemplates(Atom* atom, const string& residue_name, LibraryFile::ResidueMap& lib_residues, PrepFile::ResidueMap& prep_residues,
+                                        ParameterFile::AtomTypeMap* parameter_atom_types)
+{
+    string atom_type = "";
+    double charge = dNotSet;
+    LibraryFile::ResidueMap::iterator lib_residue = lib_residues.find(residue_name);
+    PrepFile::ResidueMap::iterator prep_residue = prep_residues.find(residue_name);
+    if(lib_residue != lib_residues.end())
+    {
+        LibraryFileAtom* lib_atom = lib_residue->second->GetLibraryAtomByAtomName(atom->GetName());
+        if(lib_atom != NULL)
+        {
+            atom_type = lib_atom->GetType();
+            charge = lib_atom->GetCharge();
+        }
+    }
+    else if(prep_residue != prep_residues.end())
+    {
+        PrepFileAtom* prep_atom = prep_residue->second->GetPrepAtomByName(atom->GetName());
+        if(prep_atom != NULL)
+        {
+            atom_type = prep_atom->GetType();
+            charge = prep_atom->GetCharge();
+        }
+    }
+    else
+        return;
+
+    double mass = dNotSet;
+    double radius = dNotSet;
+    if(atom_type.empty())
+        atom_type = "UNK";
+    else if(parameter_atom_types != NULL)
+    {
+        ParameterFile::AtomTypeMap::iterator parameter_atom = parameter_atom_types->find(atom_type);
+        if(parameter_atom != parameter_atom_types->end())
+        {
+            mass = parameter_atom->second->GetMass();
+            radius = parameter_atom->second->GetRadius();
+        }
+    }
+    atom->MolecularDynamicAtom::SetAtomType(atom_type);
+    atom->MolecularDynamicAtom::SetCharge(charge);
+    atom->MolecularDynamicAtom::SetMass(mass);
+    atom->MolecularDynamicAtom::SetRadius(radius);
+}
+
+void Assembly::UpdateBondGraph()
+{
+    bond_graph_.Build(this->GetAllAtomsOfAssembly());
+}
+
+void Assembly::Reset()
+{
+    this->ClearAssembly();
+    this->name_ = "";
+    this->chemical_type_ = "";
+    this->description_ = "";
+    this->sequence_number_ = 1;
+    this->id_ = "1";
+    this->source_file_ = "";
+    this->source_file_type_ = gmml::UNKNOWN;
+    this->model_index_ = 0;
+}
+
 LibraryFileSpace::LibraryFile::ResidueMap Assembly::GetAllResiduesFromMultipleLibFilesMap(vector<string> lib_files)
 {
     LibraryFileSpace::LibraryFile::ResidueMap all_residues;
@@ -8443,6 +9134,48 @@ PrepFileSpace::PrepFile::ResidueMap Assembly::GetAllResiduesFromMultiplePrepFile
     return all_residues;
 }
 
+LibraryFileSpace::LibraryFile::ResidueMap Assembly::GetResiduesFromMultipleLibFilesMap(vector<string> lib_files, ResidueNameMap& residue_names,
+                                                                                      vector<LibraryFileSpace::LibraryFile*>& opened_lib_files)
+{
+    LibraryFileSpace::LibraryFile::ResidueMap residues;
+    /// The last file that has a residue wins, as in GetAllResiduesFromMultipleLibFilesMap, so the files are searched from the back
+    for(vector<string>::reverse_iterator it = lib_files.rbegin(); it != lib_files.rend(); it++)
+    {
+        LibraryFileSpace::LibraryFile* lib_file = new LibraryFileSpace::LibraryFile(*it);
+        opened_lib_files.push_back(lib_file);
+        for(ResidueNameMap::iterator it1 = residue_names.begin(); it1 != residue_names.end(); it1++)
+        {
+            if(residues.find((*it1).first) != residues.end())
+                continue;
+            LibraryFileSpace::LibraryFileResidue* lib_residue = lib_file->GetLibraryResidueByResidueName((*it1).first);
+            if(lib_residue != NULL)
+                residues[(*it1).first] = lib_residue;
+        }
+    }
+    return residues;
+}
+
+PrepFileSpace::PrepFile::ResidueMap Assembly::GetResiduesFromMultiplePrepFilesMap(vector<string> prep_files, ResidueNameMap& residue_names,
+                                                                                  vector<PrepFileSpace::PrepFile*>& opened_prep_files)
+{
+    PrepFileSpace::PrepFile::ResidueMap residues;
+    /// The last file that has a residue wins, as in GetAllResiduesFromMultiplePrepFilesMap, so the files are searched from the back
+    for(vector<string>::reverse_iterator it = prep_files.rbegin(); it != prep_files.rend(); it++)
+    {
+        PrepFileSpace::PrepFile* prep_file = new PrepFileSpace::PrepFile(*it);
+        opened_prep_files.push_back(prep_file);
+        for(ResidueNameMap::iterator it1 = residue_names.begin(); it1 != residue_names.end(); it1++)
+        {
+            if(residues.find((*it1).first) != residues.end())
+                continue;
+            PrepFileSpace::PrepFileResidue* prep_residue = prep_file->GetPrepResidueByResidueName((*it1).first);
+            if(prep_residue != NULL)
+                residues[(*it1).first] = prep_residue;
+        }
+    }
+    return residues;
+}
+
 ResidueNameMap Assembly::GetAllResidueNamesFromMultipleLibFilesMap(vector<string> lib_files)
 {
     ResidueNameMap all_residue_names;
@@ -8462,6 +9195,7 @@ ResidueNameMap Assembly::GetAllResidueNamesFromMultipleLibFilesMap(vector<string
 
 vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
 {
+    GMML_SCOPED_TIMER("Assembly::ExtractSugars");
     ResidueNameMap dataset_residue_names = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
     /////////////////////////
     //    ResidueVector residuess = GetAllResiduesOfAssembly();
@@ -8494,18 +9228,15 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
     //    CycleMap cycles = DetectCyclesByDFS();
 
 
-    cout << endl << "All detected cycles" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF,"All detected cycles");
     for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
     {
         string cycle_atoms_str = (*it).first;
-        cout << cycle_atoms_str << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, cycle_atoms_str);
     }
 
     RemoveFusedCycles(cycles);
     FilterAllCarbonCycles(cycles);
-    cout << endl << "Cycles after discarding rings that are all-carbon" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Cycles after discarding rings that are all-carbon");
     CycleMap sorted_cycles = CycleMap();
     vector<string> anomeric_carbons_status = vector<string>();
@@ -8513,7 +9244,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
     {
         string cycle_atoms_str = (*it).first;
         AtomVector cycle_atoms = (*it).second;
-        cout << cycle_atoms_str << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, cycle_atoms_str);
         Atom* anomeric = FindAnomericCarbon(anomeric_carbons_status, cycle_atoms, cycle_atoms_str);
         if(anomeric != NULL)
@@ -8525,7 +9255,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
         }
     }
     cycles = sorted_cycles;
-    cout << endl << "Detailed information of sorted cycles after discarding fused or oxygenless rings: " << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Detailed information of sorted cycles after discarding fused or oxygenless rings: ");
 
     vector<Monosaccharide*> monos = vector<Monosaccharide*>();
@@ -8540,14 +9269,12 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
 
         stringstream ring_atoms;
         ring_atoms << "Ring atoms: " << cycle_atoms_str;
-        cout << ring_atoms.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, ring_atoms.str());
 
         mono->cycle_atoms_str_ = cycle_atoms_str;
         mono->cycle_atoms_ = cycle;
         vector<string> orientations = GetSideGroupOrientations(mono, cycle_atoms_str);
 
-        cout << "Side group atoms: " << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Side group atoms: ");
         for(vector<AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
         {
@@ -8558,20 +9285,17 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 if(sides.at(0) != NULL && sides.at(1) != NULL)
                 {
                     side_atoms << "[1] -> " << sides.at(0)->GetId() << ", " << sides.at(1)->GetId();
-                    cout << side_atoms.str() << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::INF, side_atoms.str());
                 }
                 else if(sides.at(1) != NULL)
                 {
                     side_atoms << "[1] -> " << sides.at(1)->GetId();
-                    cout << side_atoms.str() << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::INF, side_atoms.str());
 
                 }
                 else if(sides.at(0) != NULL)
                 {
                     side_atoms << "[1] -> " << sides.at(0)->GetId();
-                    cout << side_atoms.str() << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::INF, side_atoms.str());
 
                 }
@@ -8582,7 +9306,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 if(sides.at(0) != NULL)
                 {
                     side_atoms << sides.at(0)->GetId();
-                    cout << side_atoms.str() << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::INF, side_atoms.str());
                 }
             }
@@ -8590,13 +9313,11 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
             {
                 int cycle_atom_index = distance(mono->side_atoms_.begin(), it1);
                 side_atoms << "[" << cycle_atom_index + 1 << "] -> " << sides.at(1)->GetId();
-                cout << side_atoms.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, side_atoms.str());
             }
         }
         stringstream anomeric_status;
         anomeric_status << mono->anomeric_status_ << mono->cycle_atoms_.at(0)->GetId();
-        cout << endl << anomeric_status.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, anomeric_status.str());
 
 
@@ -8606,11 +9327,8 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
         {
             mono->chemical_code_ = code;
         }
-        cout << endl << "Stereo chemistry chemical code:"  << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Stereo chemistry chemical code:");
 
-        code->Print(cout);
-        cout << endl;
         string code_str = code->toString();
         gmml::log(__LINE__, __FILE__,  gmml::INF, code_str);
 
@@ -8627,7 +9345,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 string value = (*it1).second;
                 stringstream derivatives;
                 derivatives << "Carbon at position " << key << " is attached to " << value;
-                cout << derivatives.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, derivatives.str());
             }
 
@@ -8642,7 +9359,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 string value = (*it1).second;
                 stringstream derivatives;
                 derivatives << "Carbon at position " << key << " is attached to " << value;
-                cout << derivatives.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, derivatives.str());
             }
 
@@ -8678,7 +9394,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 //update chemical code
                 UpdateComplexSugarChemicalCode(mono);
 
-                cout << "Complex structure side group atoms: " << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "Complex structure side group atoms: ");
                 for(vector<AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
                 {
@@ -8689,20 +9404,17 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                         if(sides.at(0) != NULL && sides.at(1) != NULL)
                         {
                             complex_structure_side << "[1] -> " << sides.at(0)->GetId() << ", " << sides.at(1)->GetId();
-                            cout << complex_structure_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_structure_side.str());
 
                         }
                         else if(sides.at(1) != NULL)
                         {
                             complex_structure_side << "[1] -> " << sides.at(1)->GetId() ;
-                            cout << complex_structure_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_structure_side.str());
                         }
                         else if(sides.at(0) != NULL)
                         {
                             complex_structure_side << "[1] -> " << sides.at(0)->GetId();
-                            cout << complex_structure_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_structure_side.str());
                         }
                     }
@@ -8711,21 +9423,17 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                         complex_structure_side << "[" << mono->cycle_atoms_.size() - 1 << "]";
                         for(int i = 0; i < plus_sides.size() ; i++)
                             complex_structure_side << " -> " << sides.at(i)->GetId();
-                        cout << complex_structure_side.str() << endl;
                         gmml::log(__LINE__, __FILE__,  gmml::INF, complex_structure_side.str());
                     }
                     else if(sides.at(1) != NULL)
                     {
                         int cycle_atom_index = distance(mono->side_atoms_.begin(), it1);
                         complex_structure_side << "[" << cycle_atom_index + 1 << "] -> " << sides.at(1)->GetId();
-                        cout << complex_structure_side.str() << endl;
                         gmml::log(__LINE__, __FILE__,  gmml::INF, complex_structure_side.str());
                     }
                 }
-                cout << endl << "Complex sugar chemical code:" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "Complex sugar chemical code:");
                 gmml::log(__LINE__, __FILE__,  gmml::INF, mono->chemical_code_->toString());
-                mono->chemical_code_->Print(cout);
                 //lookup in complex map
                 mono->sugar_name_ = ComplexSugarNameLookup(mono->chemical_code_->toString());
 
@@ -8755,31 +9463,26 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                 //update chemical code
                 UpdateComplexSugarChemicalCode(mono);
 
-                cout << "Complex structure side group atoms: " << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "Complex structure side group atoms: ");
                 for(vector<AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
                 {
                     stringstream complex_sugar_side;
                     AtomVector sides = (*it1);
-                    cout << "side atom size" << sides.size() << endl;
                     if(it1 == mono->side_atoms_.begin())///side atoms of anomeric carbon
                     {
                         if(sides.at(0) != NULL && sides.at(1) != NULL)
                         {
                             complex_sugar_side << "[1] -> " << sides.at(0)->GetId() << ", " << sides.at(1)->GetId();
-                            cout << complex_sugar_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_sugar_side.str());
                         }
                         else if(sides.at(1) != NULL)
                         {
                             complex_sugar_side << "[1] -> " << sides.at(1)->GetId();
-                            cout << complex_sugar_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_sugar_side.str());
                         }
                         else if(sides.at(0) != NULL)
                         {
                             complex_sugar_side << "[1] -> " << sides.at(0)->GetId();
-                            cout << complex_sugar_side.str() << endl;
                             gmml::log(__LINE__, __FILE__,  gmml::INF, complex_sugar_side.str());
                         }
                     }
@@ -8790,22 +9493,18 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
                         {
                             complex_sugar_side << " -> " << sides.at(i)->GetId();
                         }
-                        cout << complex_sugar_side.str() << endl;
                         gmml::log(__LINE__, __FILE__,  gmml::INF, complex_sugar_side.str());
                     }
                     else if(sides.at(1) != NULL)
                     {
                         int cycle_atom_index = distance(mono->side_atoms_.begin(), it1);
                         complex_sugar_side << "[" << cycle_atom_index + 1 << "] -> " << sides.at(1)->GetId();
-                        cout << complex_sugar_side.str() << endl;
                         gmml::log(__LINE__, __FILE__,  gmml::INF, complex_sugar_side.str());
                     }
                 }
 
-                cout << endl << "Complex sugar chemical code:" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "Complex sugar chemical code:");
                 gmml::log(__LINE__, __FILE__,  gmml::INF, mono->chemical_code_->toString());
-                mono->chemical_code_->Print(cout);
                 //lookup in complex map
                 mono->sugar_name_ = ComplexSugarNameLookup(mono->chemical_code_->toString());
                 //generate complete name
@@ -8813,7 +9512,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
             }
 
         }
-        cout << endl;
         if(mono->sugar_name_.monosaccharide_stereochemistry_name_.compare("") == 0 && mono->sugar_name_.monosaccharide_name_.compare("") == 0)
         {
             mono->sugar_name_.monosaccharide_stereochemistry_name_ = "Unknown";
@@ -8823,37 +9521,35 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files)
         }
         stringstream stereo;
         stereo << "Stereochemistry name: " << mono->sugar_name_.monosaccharide_stereochemistry_name_;
-        cout << stereo.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, stereo.str());
 
         stringstream stereo_short;
         stereo_short << "Stereochemistry short name: " << mono->sugar_name_.monosaccharide_stereochemistry_short_name_;
-        cout << stereo_short.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, stereo_short.str());
 
         stringstream mono_name;
         mono_name << "Complete name: " << mono->sugar_name_.monosaccharide_name_;
-        cout << mono_name.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, mono_name.str());
 
         stringstream mono_short;
         mono_short << "Short name: " << mono->sugar_name_.monosaccharide_short_name_;
-        cout << mono_short.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, mono_short.str());
 
-        cout << "-------------------------------------------------------------------------------------------------------------------------------------------" << endl;
 
         mono_id++;
         mono->mono_id = mono_id;
         monos.push_back(mono);
     }
-    cout << endl << "Oligosaccharides:" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Oligosaccharides:");
     string terminal_residue_name = "";
     vector<Oligosaccharide*> oligosaccharides = ExtractOligosaccharides(monos, dataset_residue_names, terminal_residue_name);
     //    cout << "EXTRACTED" << endl;
     for(vector<Oligosaccharide*>::iterator it = oligosaccharides.begin(); it != oligosaccharides.end(); it++)
-        (*it)->Print(terminal_residue_name, cout);
+    {
+        stringstream oligosaccharide;
+        (*it)->Print(terminal_residue_name, oligosaccharide);
+        gmml::log(__LINE__, __FILE__, gmml::INF, oligosaccharide.str());
+    }
 
     return oligosaccharides;
 
@@ -9171,6 +9867,7 @@ void Assembly::PopulateResidue(stringstream& pdb_stream, stringstream& residue_s
 
 Assembly::CycleMap Assembly::DetectCyclesByExhaustiveRingPerception()
 {
+    GMML_SCOPED_TIMER("Assembly::DetectCyclesByExhaustiveRingPerception");
     CycleMap cycles = CycleMap();
     AtomVector atoms = GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms();
     map<string, Atom*> IdAtom = map<string, Atom*>();
@@ -9233,6 +9930,7 @@ Assembly::CycleMap Assembly::DetectCyclesByExhaustiveRingPerception()
         //            }
     }
 
+    GMML_COUNT("cycles tested", cycless.size());
     for(vector<string>::iterator it = cycless.begin(); it != cycless.end(); it++)
     {
         string cycle = (*it);
@@ -9372,68 +10070,52 @@ void Assembly::ReducePathGraph(vector<string> path_graph_edges, vector<string> p
 
 void Assembly::PruneGraph(AtomVector& all_atoms)
 {
-    AtomVector atoms_with_more_than_two_neighbors = AtomVector();
-    vector<string> het_atom_ids = vector<string>();
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    /// Repeatedly drop the atoms with less than two neighbors among the remaining atoms, what is left are the cycles and the paths between them
+    BondGraph bond_graph = BondGraph(all_atoms);
+    int number_of_atoms = bond_graph.GetNumberOfAtoms();
+    vector<int> degrees = vector<int>(number_of_atoms, 0);
+    vector<bool> removed = vector<bool>(number_of_atoms, false);
+    vector<int> queue = vector<int>();
+    for(int i = 0; i < number_of_atoms; i++)
     {
-        Atom* atom = *it;
-        het_atom_ids.push_back(atom->GetId());
+        degrees.at(i) = bond_graph.GetDegree(i);
+        if(degrees.at(i) < 2)
+            queue.push_back(i);
     }
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    while(!queue.empty())
     {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        int count = 0;
-        for(int i = 0; i < node->GetNodeNeighbors().size(); i++)
+        int index = queue.back();
+        queue.pop_back();
+        if(removed.at(index))
+            continue;
+        removed.at(index) = true;
+        for(const int* it = bond_graph.NeighborsBegin(index); it != bond_graph.NeighborsEnd(index); it++)
         {
-            Atom* neighbor = node->GetNodeNeighbors().at(i);
-            if(find(het_atom_ids.begin(), het_atom_ids.end(), neighbor->GetId()) != het_atom_ids.end())
-                count++;
+            if(!removed.at(*it) && --degrees.at(*it) < 2)
+                queue.push_back(*it);
         }
-        if(count > 1)
-            atoms_with_more_than_two_neighbors.push_back(atom);
-    }
-    if(atoms_with_more_than_two_neighbors.size() != all_atoms.size())
-    {
-        all_atoms = atoms_with_more_than_two_neighbors;
-        PruneGraph(all_atoms);
     }
-    else
-        return;
+    AtomVector remaining_atoms = AtomVector();
+    for(int i = 0; i < number_of_atoms; i++)
+        if(!removed.at(i))
+            remaining_atoms.push_back(all_atoms.at(i));
+    all_atoms = remaining_atoms;
 }
 
 void Assembly::ConvertIntoPathGraph(vector<string>& path_graph_edges, vector<string>& path_graph_labels, AtomVector atoms)
 {
-    vector<string> atoms_id = vector<string>();
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+    /// Every bond between the given atoms once, from the atom that comes first in the list
+    BondGraph bond_graph = BondGraph(atoms);
+    for(BondGraph::BondIterator it = bond_graph.BondsBegin(); it != bond_graph.BondsEnd(); ++it)
     {
-        Atom* atom = *it;
-        atoms_id.push_back(atom->GetId());
-    }
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        AtomVector neighbors = node->GetNodeNeighbors();
-        for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
-        {
-            Atom* neighbor = (*it1);
-            if(find(atoms_id.begin(), atoms_id.end(), neighbor->GetId()) != atoms_id.end())
-            {
-                stringstream ss;
-                ss << atom->GetId() << "," << neighbor->GetId();
-                stringstream reverse_ss;
-                reverse_ss << neighbor->GetId() << "," << atom->GetId();
-                if(find(path_graph_edges.begin(), path_graph_edges.end(), ss.str()) == path_graph_edges.end() &&
-                        find(path_graph_edges.begin(), path_graph_edges.end(), reverse_ss.str()) == path_graph_edges.end()) ///path not existed before
-                {
-                    stringstream path;
-                    path << atom->GetId() << "-" << neighbor->GetId();
-                    path_graph_edges.push_back(ss.str());
-                    path_graph_labels.push_back(path.str());
-                }
-            }
-        }
+        Atom* atom = bond_graph.GetAtom(it->first);
+        Atom* neighbor = bond_graph.GetAtom(it->second);
+        stringstream ss;
+        ss << atom->GetId() << "," << neighbor->GetId();
+        stringstream path;
+        path << atom->GetId() << "-" << neighbor->GetId();
+        path_graph_edges.push_back(ss.str());
+        path_graph_labels.push_back(path.str());
     }
 }
 
@@ -9467,7 +10149,6 @@ Assembly::CycleMap Assembly::DetectCyclesByDFS()
 
     stringstream n_of_cycle;
     n_of_cycle << "Number of cycles found: " << counter;
-    cout << n_of_cycle.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, n_of_cycle.str());
     for(AtomIdAtomMap::iterator it = src_dest_map.begin(); it != src_dest_map.end(); it++)
     {
@@ -10905,17 +11586,17 @@ string Assembly::CheckxCOO(Atom *target, string cycle_atoms_str)
 
 void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file, int ion_count)
 {
+    GMML_SCOPED_TIMER("Assembly::Ionizing");
+    gmml::MemoryArenaScope arena_scope(&arena_);
     if(ion_count == 0)
     {
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Neutralizing .......");
-        cout << "Neutralizing ......." << endl;
         LibraryFile* lib = new LibraryFile(lib_file);
         ParameterFile* param = new ParameterFile(parameter_file, gmml::IONICMOD);
         double charge = this->GetTotalCharge();
         if(fabs(charge) < CHARGE_TOLERANCE)
         {
             gmml::log(__LINE__, __FILE__,  gmml::INF, "The assembly has 0 charge and is neutral.");
-            cout << "The assembly has 0 charge and is neutral." << endl;
             return;
         }
         else
@@ -10923,7 +11604,6 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
             stringstream ss;
             ss << "Total charge of the assembly is " << charge;
             gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-            cout << ss.str() << endl;
         }
         double ion_charge = 0;
         string ion_residue_name = "";
@@ -10937,19 +11617,16 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
             if(ion_charge == 0)
             {
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "The ion has 0 charge");
-                cout << "The ion has 0 charge" << endl;
                 return;
             }
             else if(ion_charge > 0 && charge > 0)
             {
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
-                cout << "The assembly and the given ion have positive charges, neutralizing process is aborted." << endl;
                 return;
             }
             else if(ion_charge < 0 && charge < 0)
             {
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
-                cout << "The assembly and the given ion have negative charges, neutralizing process is aborted." << endl;
                 return;
             }
             else
@@ -10967,19 +11644,19 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                     ion_radius = atom_type_map[ion_name]->GetRadius();
                     ion_mass = atom_type_map[ion_name]->GetMass();
                 }
-                Coordinate* minimum_boundary = new Coordinate();
-                Coordinate* maximum_boundary = new Coordinate();
-                this->GetBoundary(minimum_boundary, maximum_boundary);
-                if(minimum_boundary->GetX() == INFINITY || minimum_boundary->GetY() == INFINITY || minimum_boundary->GetZ() == INFINITY ||
-                        maximum_boundary->GetX() == -INFINITY || maximum_boundary->GetY() == -INFINITY || maximum_boundary->GetZ() == -INFINITY)
+                Coordinate minimum_boundary = Coordinate();
+                Coordinate maximum_boundary = Coordinate();
+                this->GetBoundary(&minimum_boundary, &maximum_boundary);
+                if(minimum_boundary.GetX() == INFINITY || minimum_boundary.GetY() == INFINITY || minimum_boundary.GetZ() == INFINITY ||
+                        maximum_boundary.GetX() == -INFINITY || maximum_boundary.GetY() == -INFINITY || maximum_boundary.GetZ() == -INFINITY)
                     return;
 
-                minimum_boundary->operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
-                maximum_boundary->operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
+                minimum_boundary.operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
+                maximum_boundary.operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
 
                 for(int i = 0; i < number_of_neutralizing_ion; i++)
                 {
-                    Grid* grid = new Grid(this, minimum_boundary, maximum_boundary, ion_radius, ion_charge);
+                    Grid* grid = new Grid(this, &minimum_boundary, &maximum_boundary, ion_radius, ion_charge);
                     grid->CalculateCellsCharge();
                     grid->CalculateCellsPotentialEnergy(ion_radius);
                     CoordinateVector best_positions = grid->GetBestPositions(ion_charge);
@@ -10987,7 +11664,7 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                     if(best_positions.size() == 0)
                     {
                         gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
-                        cout << "There is no optimum position to place the ion" << endl;
+                        delete grid;
                         return;
                     }
                     else
@@ -10995,15 +11672,17 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                         int index = rand() % best_positions.size();
                         Coordinate* best_position = new Coordinate(best_positions.at(index)->GetX(),
                                                                    best_positions.at(index)->GetY(), best_positions.at(index)->GetZ());
+                        for(CoordinateVector::iterator it = best_positions.begin(); it != best_positions.end(); it++)
+                            delete (*it);
                         Grid::CellVector cells = grid->GetCells();
                         for(Grid::CellVector::iterator it = cells.begin(); it != cells.end(); it++)
                         {
-                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetZ() &&
-                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetZ())
+                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetX() &&
+                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetY() &&
+                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetZ() &&
+                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetX() &&
+                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetY() &&
+                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetZ())
                             {
                                 (*it)->SetCellPotentialEnergy(INFINITY);
                             }
@@ -11031,26 +11710,24 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
 
                         this->AddResidue(ion);
                     }
+                    delete grid;
                 }
             }
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::WAR, "The ion has not been found in the library file.");
-            cout << "The ion has not been found in the library file." << endl;
         }
     }
     else if (ion_count > 0)
     {
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Ionizing .......");
-        cout << "Ionizing ......." << endl;
         LibraryFile* lib = new LibraryFile(lib_file);
         ParameterFile* param = new ParameterFile(parameter_file, gmml::IONICMOD);
         double charge = this->GetTotalCharge();
         stringstream ss;
         ss << "Total charge of the assembly is " << charge;
         gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-        cout << ss.str() << endl;
         double ion_charge = 0;
         string ion_residue_name = "";
         vector<string> ion_list = lib->GetAllResidueNames();
@@ -11063,7 +11740,6 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
             if(ion_charge == 0)
             {
                 gmml::log(__LINE__, __FILE__,  gmml::INF, "The ion has 0 charge");
-                cout << "The ion has 0 charge" << endl;
                 return;
             }
             else
@@ -11071,7 +11747,6 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                 stringstream ss;
                 ss << "The assembly will be charged by " << ion_count << " ion(s)" ;
                 gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-                cout << ss.str() << endl;
 
                 ParameterFile::AtomTypeMap atom_type_map = param->GetAtomTypes();
                 double ion_radius = MINIMUM_RADIUS;
@@ -11081,19 +11756,19 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                     ion_radius = atom_type_map[ion_name]->GetRadius();
                     ion_mass = atom_type_map[ion_name]->GetMass();
                 }
-                Coordinate* minimum_boundary = new Coordinate();
-                Coordinate* maximum_boundary = new Coordinate();
-                this->GetBoundary(minimum_boundary, maximum_boundary);
+                Coordinate minimum_boundary = Coordinate();
+                Coordinate maximum_boundary = Coordinate();
+                this->GetBoundary(&minimum_boundary, &maximum_boundary);
 
-                if(minimum_boundary->GetX() == INFINITY || minimum_boundary->GetY() == INFINITY || minimum_boundary->GetZ() == INFINITY ||
-                        maximum_boundary->GetX() == -INFINITY || maximum_boundary->GetY() == -INFINITY || maximum_boundary->GetZ() == -INFINITY)
+                if(minimum_boundary.GetX() == INFINITY || minimum_boundary.GetY() == INFINITY || minimum_boundary.GetZ() == INFINITY ||
+                        maximum_boundary.GetX() == -INFINITY || maximum_boundary.GetY() == -INFINITY || maximum_boundary.GetZ() == -INFINITY)
                     return;
-                minimum_boundary->operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
-                maximum_boundary->operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
+                minimum_boundary.operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
+                maximum_boundary.operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
 
                 for(int i = 0; i < ion_count; i++)
                 {
-                    Grid* grid = new Grid(this, minimum_boundary, maximum_boundary, ion_radius, ion_charge);
+                    Grid* grid = new Grid(this, &minimum_boundary, &maximum_boundary, ion_radius, ion_charge);
                     grid->CalculateCellsCharge();
                     grid->CalculateCellsPotentialEnergy(ion_radius);
                     CoordinateVector best_positions = grid->GetBestPositions(ion_charge);
@@ -11101,7 +11776,7 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                     if(best_positions.size() == 0)
                     {
                         gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
-                        cout << "There is no optimum position to place the ion" << endl;
+                        delete grid;
                         return;
                     }
                     else
@@ -11109,15 +11784,17 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
                         int index = rand() % best_positions.size();
                         Coordinate* best_position = new Coordinate(best_positions.at(index)->GetX(),
                                                                    best_positions.at(index)->GetY(), best_positions.at(index)->GetZ());
+                        for(CoordinateVector::iterator it = best_positions.begin(); it != best_positions.end(); it++)
+                            delete (*it);
                         Grid::CellVector cells = grid->GetCells();
                         for(Grid::CellVector::iterator it = cells.begin(); it != cells.end(); it++)
                         {
-                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetZ() &&
-                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetZ())
+                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetX() &&
+                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetY() &&
+                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter().GetZ() &&
+                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetX() &&
+                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetY() &&
+                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter().GetZ())
                             {
                                 (*it)->SetCellPotentialEnergy(INFINITY);
                             }
@@ -11145,19 +11822,18 @@ void Assembly::Ionizing(string ion_name, string lib_file, string parameter_file,
 
                         this->AddResidue(ion);
                     }
+                    delete grid;
                 }
             }
         }
         else
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "The ion has not been found in the library file.");
-            cout << "The ion has not been found in the library file." << endl;
         }
     }
     else
     {
         gmml::log(__LINE__, __FILE__,  gmml::ERR, "Please have a non-negative number as the number of ion(s) want to add");
-        cout << "Please have a non-negative number as the number of ion(s) want to add" << endl;
     }
 }
 
@@ -11178,18 +11854,18 @@ double Assembly::GetTotalCharge()
 double Assembly::GetRadius()
 {
     double radius = -INFINITY;
-    Coordinate* geometric_center = new Coordinate();
-    this->GetCenterOfGeometry(geometric_center);
+    Coordinate geometric_center = Coordinate();
+    this->GetCenterOfGeometry(&geometric_center);
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = *it;
-        double dist = sqrt((geometric_center->GetX() - atom->GetCoordinates().at(model_index_)->GetX()) *
-                           (geometric_center->GetX() - atom->GetCoordinates().at(model_index_)->GetX()) +
-                           (geometric_center->GetY() - atom->GetCoordinates().at(model_index_)->GetY()) *
-                           (geometric_center->GetY() - atom->GetCoordinates().at(model_index_)->GetY()) +
-                           (geometric_center->GetZ() - atom->GetCoordinates().at(model_index_)->GetZ()) *
-                           (geometric_center->GetZ() - atom->GetCoordinates().at(model_index_)->GetZ()));
+        double dist = sqrt((geometric_center.GetX() - atom->GetCoordinates().at(model_index_)->GetX()) *
+                           (geometric_center.GetX() - atom->GetCoordinates().at(model_index_)->GetX()) +
+                           (geometric_center.GetY() - atom->GetCoordinates().at(model_index_)->GetY()) *
+                           (geometric_center.GetY() - atom->GetCoordinates().at(model_index_)->GetY()) +
+                           (geometric_center.GetZ() - atom->GetCoordinates().at(model_index_)->GetZ()) *
+                           (geometric_center.GetZ() - atom->GetCoordinates().at(model_index_)->GetZ()));
         double atom_radius = atom->MolecularDynamicAtom::GetRadius();
         if(atom_radius == dNotSet)
             atom_radius = MINIMUM_RADIUS;
@@ -11266,12 +11942,10 @@ void Assembly::GetBoundary(Coordinate* lower_left_back_corner, Coordinate* upper
         if(atom->MolecularDynamicAtom::GetRadius() == dNotSet)
         {
             gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no information of the atom type/radius/charge of the atoms in the given library/parameter file");
-            cout << "There is no information of the atom type/radius/charge of the atoms in the given library/parameter file" << endl;
             atom->MolecularDynamicAtom::SetRadius(DEFAULT_RADIUS);
             stringstream ss;
             ss << "The default value has been set for " << atom->GetId();
             gmml::log(__LINE__, __FILE__,  gmml::ERR, ss.str());
-            cout << ss.str() << endl;
             //            return;
         }
         double upper_right_front_x = atom->GetCoordinates().at(model_index_)->GetX() + atom->MolecularDynamicAtom::GetRadius();
@@ -11311,7 +11985,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "CH-N is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "CH-N is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11335,12 +12008,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             }
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "CH-N is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "CH-N is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "CH-N is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "CH-N is at error position: 5");
             }
             else
@@ -11358,7 +12029,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "C-N-C=OCH3 is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "C-N-C=OCH3 is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11383,12 +12053,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
 
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "C-N-C=OCH3 is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-C=OCH3 is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "C-N-C=OCH3 is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-C=OCH3 is at error position: 5");
             }
             else
@@ -11405,7 +12073,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "C-N-C=OCH2OH is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "C-N-C=OCH2OH is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11430,12 +12097,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
 
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "C-N-C=OCH2OH is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-C=OCH2OH is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "C-N-C=OCH2OH is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-C=OCH2OH is at error position: 5");
             }
             else
@@ -11452,7 +12117,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "C-N-SO3 is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "C-N-SO3 is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11476,12 +12140,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             }
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "C-N-SO3 is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-SO3 is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "C-N-SO3 is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-SO3 is at error position: 5");
             }
             else
@@ -11498,7 +12160,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "C-N-PO3 is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "C-N-PO3 is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11523,12 +12184,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
 
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "C-N-PO3 is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-PO3 is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "C-N-PO3 is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-PO3 is at error position: 5");
             }
             else
@@ -11545,7 +12204,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
         {
             if(key.compare("a") == 0)
             {
-                cout << "C-N-CH3 is at warning position: anomeric" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "C-N-CH3 is at warning position: anomeric");
             }
             else if(key.compare("2") == 0 && mono->sugar_name_.ring_type_.compare("P") == 0 &&
@@ -11570,12 +12228,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
 
             else if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
             {
-                cout << "C-N-CH3 is at error position: 4" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-CH3 is at error position: 4");
             }
             else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
             {
-                cout << "C-N-CH3 is at error position: 5" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-N-CH3 is at error position: 5");
             }
             else
@@ -11607,12 +12263,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             {
                 if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
                 {
-                    cout << "C-O-C=OCH3 is at error position: 4" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-C=OCH3 is at error position: 4");
                 }
                 else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
                 {
-                    cout << "C-O-C=OCH3 is at error position: 5" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-C=OCH3 is at error position: 5");
                 }
                 else
@@ -11644,12 +12298,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             {
                 if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
                 {
-                    cout << "C-O-C=OCH2OH is at error position: 4" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-C=OCH2OH is at error position: 4");
                 }
                 else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
                 {
-                    cout << "C-O-C=OCH2OH is at error position: 5" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-C=OCH2OH is at error position: 5");
                 }
                 else
@@ -11681,12 +12333,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             {
                 if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
                 {
-                    cout << "C-O-SO3 is at error position: 4" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-SO3 is at error position: 4");
                 }
                 else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
                 {
-                    cout << "C-O-SO3 is at error position: 5" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-SO3 is at error position: 5");
                 }
                 else
@@ -11718,12 +12368,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             {
                 if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
                 {
-                    cout << "C-O-PO3 is at error position: 4" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-PO3 is at error position: 4");
                 }
                 else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
                 {
-                    cout << "C-O-PO3 is at error position: 5" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-SO3 is at error position: 5");
                 }
                 else
@@ -11755,12 +12403,10 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             {
                 if(mono->sugar_name_.ring_type_.compare("F") == 0 && key.compare("4") == 0)
                 {
-                    cout << "C-O-CH3 is at error position: 4" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-CH3 is at error position: 4");
                 }
                 else if(mono->sugar_name_.ring_type_.compare("P") == 0 && key.compare("5") == 0)
                 {
-                    cout << "C-O-CH3 is at error position: 5" << endl;
                     gmml::log(__LINE__, __FILE__,  gmml::ERR, "C-O-CH3 is at error position: 5");
                 }
                 else
@@ -11782,7 +12428,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             if((key.compare("-1") == 0 || key.compare("+2") == 0 || key.compare("+3") == 0) && mono->sugar_name_.monosaccharide_stereochemistry_name_.compare("") != 0)
             {
                 err_pos << "C-(O,OH) is at error position: " << key;
-                cout << err_pos.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, err_pos.str());
 
                 tail << "-ulosonic acid";
@@ -11813,7 +12458,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             else
             {
                 err_pos << "C-(O,OH) is at error position: " << key;
-                cout << err_pos.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, err_pos.str());
             }
         }
@@ -11823,7 +12467,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             if((key.compare("-1") == 0 || key.compare("+2") == 0 || key.compare("+3") == 0) && mono->sugar_name_.monosaccharide_stereochemistry_name_.compare("") != 0)
             {
                 err_pos << "C-(O,O) is at error position: " << key;
-                cout << err_pos.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, err_pos.str());
 
                 tail << "-ulosonate";
@@ -11854,7 +12497,6 @@ void Assembly::GenerateCompleteSugarName(Monosaccharide *mono)
             else
             {
                 err_pos << "C-(O,O) is at error position: " << key;
-                cout << err_pos.str() << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, err_pos.str());
             }
         }
@@ -12215,15 +12857,10 @@ string Assembly::CalculateRSOrientations(Atom *prev_atom, Atom *target, Atom *ne
 {
     string orientation = "";
     ///Calculating the plane based on the two ring neighbors of the current atom
-    Coordinate prev_atom_coord = Coordinate(*prev_atom->GetCoordinates().at(model_index_));
-    Coordinate current_atom_coord = Coordinate(*target->GetCoordinates().at(model_index_));
-    Coordinate next_atom_coord = Coordinate(*next_atom->GetCoordinates().at(model_index_));
-    prev_atom_coord.operator -(current_atom_coord) ;
-    next_atom_coord.operator -(current_atom_coord) ;
-    Plane plane = Plane();
-    plane.SetV1(prev_atom_coord);
-    plane.SetV2(next_atom_coord);
-    Coordinate normal_v = plane.GetUnitNormalVector();
+    Vector3 current_atom_coord = Vector3(*target->GetCoordinates().at(model_index_));
+    Vector3 prev_atom_coord = Vector3(*prev_atom->GetCoordinates().at(model_index_)) - current_atom_coord;
+    Vector3 next_atom_coord = Vector3(*next_atom->GetCoordinates().at(model_index_)) - current_atom_coord;
+    Vector3 normal_v = prev_atom_coord.CrossProduct(next_atom_coord).Normalized();
 
     AtomNode* node = target->GetNode();
     AtomVector neighbors = node->GetNodeNeighbors();
@@ -12232,12 +12869,9 @@ string Assembly::CalculateRSOrientations(Atom *prev_atom, Atom *target, Atom *ne
         Atom* neighbor = (*it1);
         if(neighbor->GetId().at(0) == 'O')
         {
-            Coordinate side_atom_coord = Coordinate(*neighbor->GetCoordinates().at(model_index_));
-            side_atom_coord.operator -(current_atom_coord);
-            side_atom_coord.Normalize();
-            Coordinate normal_v_x_side_atom = normal_v;
-            normal_v_x_side_atom.CrossProduct(side_atom_coord); ///cross product (perpendicular vector to plan's normal vector and the normal vector of side atom oxygen)
-            double sin_theta = normal_v_x_side_atom.length()/(normal_v.length()*side_atom_coord.length());
+            Vector3 side_atom_coord = (Vector3(*neighbor->GetCoordinates().at(model_index_)) - current_atom_coord).Normalized();
+            Vector3 normal_v_x_side_atom = normal_v.CrossProduct(side_atom_coord); ///cross product (perpendicular vector to plan's normal vector and the normal vector of side atom oxygen)
+            double sin_theta = normal_v_x_side_atom.Length()/(normal_v.Length()*side_atom_coord.Length());
 
             if(sin_theta >= 0) ///theta between plan's normal vector and the vector of side oxygen is between 0 to 180 degree
                 orientation = "R";
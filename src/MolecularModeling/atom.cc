@@ -4,6 +4,7 @@
 #include "../../includes/MolecularModeling/dockingatom.hpp"
 #include "../../includes/MolecularModeling/atomnode.hpp"
 #include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/MolecularModeling/bondgraph.hpp"
 
 using namespace std;
 using namespace MolecularModeling;
@@ -102,6 +103,7 @@ void Atom::SetElementSymbol(string element_symbol)
 }
 void Atom::SetNode(AtomNode *node)
 {
+    BondGraph::MarkOutdated();
     node_ = node;
 }
 void Atom::SetId(string id)
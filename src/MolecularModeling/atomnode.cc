@@ -1,6 +1,7 @@
 #include "../../includes/MolecularModeling/atomnode.hpp"
 #include "../../includes/MolecularModeling/atom.hpp"
 #include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/MolecularModeling/bondgraph.hpp"
 
 using namespace std;
 using namespace MolecularModeling;
@@ -37,6 +38,7 @@ void AtomNode::SetAtom(Atom *atom)
 }
 void AtomNode::SetNodeNeighbors(AtomVector node_neighbors)
 {
+    BondGraph::MarkOutdated();
     node_neighbors_.clear();
     for(AtomVector::iterator it = node_neighbors.begin(); it != node_neighbors.end(); it++)
     {
@@ -45,6 +47,7 @@ void AtomNode::SetNodeNeighbors(AtomVector node_neighbors)
 }
 void AtomNode::AddNodeNeighbor(Atom *node_neighbor)
 {
+    BondGraph::MarkOutdated();
     node_neighbors_.push_back(node_neighbor);
 }
 
@@ -54,6 +57,7 @@ void AtomNode::SetId(int id)
 }
 void AtomNode::RemoveNodeNeighbor(Atom *node_neighbor)
 {
+    BondGraph::MarkOutdated();
     for(AtomVector::iterator it = node_neighbors_.begin(); it != node_neighbors_.end(); it++)
     {
         Atom* atom = (*it);
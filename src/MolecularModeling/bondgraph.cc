@@ -0,0 +1,354 @@
+#include <algorithm>
+
+#include "../../includes/MolecularModeling/bondgraph.hpp"
+#include "../../includes/MolecularModeling/atom.hpp"
+#include "../../includes/MolecularModeling/atomnode.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+
+atomic<unsigned long> BondGraph::build_count_(0);
+atomic<unsigned long> BondGraph::last_change_(0);
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+BondGraph::BondGraph() : built_(false), build_number_(0)
+{
+    offsets_.push_back(0);
+}
+
+BondGraph::BondGraph(const AtomVector& atoms) : built_(false), build_number_(0)
+{
+    this->Build(atoms);
+}
+
+BondGraph::BondIterator::BondIterator(const BondGraph* graph, bool end) : graph_(graph), position_(0)
+{
+    bond_.first = 0;
+    bond_.second = 0;
+    if(end)
+    {
+        position_ = graph_->neighbors_.size();
+        bond_.first = graph_->GetNumberOfAtoms();
+        return;
+    }
+    position_ = -1;
+    ++(*this);
+}
+
+BondGraph::AngleIterator::AngleIterator(const BondGraph* graph, bool end) : graph_(graph)
+{
+    angle_.center = (end) ? graph_->GetNumberOfAtoms() : 0;
+    angle_.first = 0;
+    angle_.last = 0;
+    first_ = graph_->offsets_[angle_.center];
+    last_ = first_;
+    if(!end)
+        ++(*this);
+}
+
+BondGraph::DihedralIterator::DihedralIterator(const BondGraph* graph, bool end) : graph_(graph), bond_(graph, end)
+{
+    dihedral_.first = 0;
+    dihedral_.second = 0;
+    dihedral_.third = 0;
+    dihedral_.fourth = 0;
+    if(bond_ == graph_->BondsEnd())
+    {
+        first_ = graph_->neighbors_.size();
+        fourth_ = first_;
+        return;
+    }
+    first_ = graph_->offsets_[bond_->first];
+    fourth_ = graph_->offsets_[bond_->second];
+    if(!this->IsValid())
+        ++(*this);
+    else
+    {
+        dihedral_.first = graph_->neighbors_[first_];
+        dihedral_.second = bond_->first;
+        dihedral_.third = bond_->second;
+        dihedral_.fourth = graph_->neighbors_[fourth_];
+    }
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+bool BondGraph::IsBuilt() const
+{
+    return built_;
+}
+
+bool BondGraph::IsOutdated() const
+{
+    return built_ && last_change_.load(memory_order_relaxed) >= build_number_;
+}
+
+int BondGraph::GetNumberOfAtoms() const
+{
+    return atoms_.size();
+}
+
+int BondGraph::GetNumberOfBonds() const
+{
+    return neighbors_.size() / 2;
+}
+
+const BondGraph::AtomVector& BondGraph::GetAtoms() const
+{
+    return atoms_;
+}
+
+Atom* BondGraph::GetAtom(int index) const
+{
+    return atoms_.at(index);
+}
+
+int BondGraph::GetIndex(Atom* atom) const
+{
+    vector<pair<Atom*, int> >::const_iterator it = lower_bound(indices_.begin(), indices_.end(), make_pair(atom, -1));
+    if(it == indices_.end() || it->first != atom)
+        return -1;
+    return it->second;
+}
+
+int BondGraph::GetDegree(int index) const
+{
+    return offsets_[index + 1] - offsets_[index];
+}
+
+bool BondGraph::AreBonded(int first, int second) const
+{
+    /// Degrees are small, a scan of the shorter neighbor list is faster than anything else
+    if(this->GetDegree(second) < this->GetDegree(first))
+        swap(first, second);
+    return find(this->NeighborsBegin(first), this->NeighborsEnd(first), second) != this->NeighborsEnd(first);
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void BondGraph::Build(const AtomVector& atoms)
+{
+    this->Clear();
+    build_number_ = build_count_.fetch_add(1, memory_order_relaxed) + 1;
+    atoms_ = atoms;
+    indices_.reserve(atoms.size());
+    for(unsigned int i = 0; i < atoms.size(); i++)
+        indices_.push_back(make_pair(atoms.at(i), (int)i));
+    sort(indices_.begin(), indices_.end());
+
+    offsets_.reserve(atoms.size() + 1);
+    for(unsigned int i = 0; i < atoms.size(); i++)
+    {
+        AtomNode* node = atoms.at(i)->GetNode();
+        if(node != NULL)
+        {
+            AtomVector node_neighbors = node->GetNodeNeighbors();
+            for(AtomVector::iterator it = node_neighbors.begin(); it != node_neighbors.end(); it++)
+            {
+                int index = this->GetIndex(*it);
+                if(index < 0 || index == (int)i)
+                    continue;
+                /// An atom node may list a neighbor more than once
+                if(find(neighbors_.begin() + offsets_.back(), neighbors_.end(), index) == neighbors_.end())
+                    neighbors_.push_back(index);
+            }
+        }
+        offsets_.push_back(neighbors_.size());
+    }
+    built_ = true;
+}
+
+void BondGraph::MarkOutdated()
+{
+    unsigned long build_count = build_count_.load(memory_order_relaxed);
+    if(last_change_.load(memory_order_relaxed) != build_count)
+        last_change_.store(build_count, memory_order_relaxed);
+}
+
+void BondGraph::Clear()
+{
+    built_ = false;
+    atoms_.clear();
+    indices_.clear();
+    neighbors_.clear();
+    offsets_.clear();
+    offsets_.push_back(0);
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+BondGraph::BondIterator BondGraph::BondsBegin() const
+{
+    return BondIterator(this, false);
+}
+
+BondGraph::BondIterator BondGraph::BondsEnd() const
+{
+    return BondIterator(this, true);
+}
+
+BondGraph::AngleIterator BondGraph::AnglesBegin() const
+{
+    return AngleIterator(this, false);
+}
+
+BondGraph::AngleIterator BondGraph::AnglesEnd() const
+{
+    return AngleIterator(this, true);
+}
+
+BondGraph::DihedralIterator BondGraph::DihedralsBegin() const
+{
+    return DihedralIterator(this, false);
+}
+
+BondGraph::DihedralIterator BondGraph::DihedralsEnd() const
+{
+    return DihedralIterator(this, true);
+}
+
+int BondGraph::CountAngles() const
+{
+    int count = 0;
+    for(int i = 0; i < this->GetNumberOfAtoms(); i++)
+        count += this->GetDegree(i) * (this->GetDegree(i) - 1) / 2;
+    return count;
+}
+
+void BondGraph::FindExcludedAtoms(vector<vector<int> >& excluded_atoms, int number_of_bonds) const
+{
+    int number_of_atoms = this->GetNumberOfAtoms();
+    excluded_atoms.assign(number_of_atoms, vector<int>());
+    /// Breadth first search from every atom; an atom is marked with the index of the search that has reached it, so the marks never need a reset
+    vector<int> reached_from = vector<int>(number_of_atoms, -1);
+    vector<int> current_shell = vector<int>();
+    vector<int> next_shell = vector<int>();
+    for(int i = 0; i < number_of_atoms; i++)
+    {
+        reached_from[i] = i;
+        current_shell.assign(1, i);
+        for(int depth = 0; depth < number_of_bonds && !current_shell.empty(); depth++)
+        {
+            next_shell.clear();
+            for(vector<int>::iterator it = current_shell.begin(); it != current_shell.end(); it++)
+            {
+                for(const int* it1 = this->NeighborsBegin(*it); it1 != this->NeighborsEnd(*it); it1++)
+                {
+                    if(reached_from[*it1] == i)
+                        continue;
+                    reached_from[*it1] = i;
+                    next_shell.push_back(*it1);
+                    excluded_atoms[i].push_back(*it1);
+                }
+            }
+            current_shell.swap(next_shell);
+        }
+        sort(excluded_atoms[i].begin(), excluded_atoms[i].end());
+    }
+}
+
+BondGraph::BondIterator& BondGraph::BondIterator::operator++()
+{
+    do
+    {
+        this->Step();
+    }
+    while(position_ < (int)graph_->neighbors_.size() && !this->IsValid());
+    if(position_ < (int)graph_->neighbors_.size())
+        bond_.second = graph_->neighbors_[position_];
+    return *this;
+}
+
+bool BondGraph::BondIterator::IsValid() const
+{
+    /// Every bond is stored in the rows of both atoms, it is visited from the row of the smaller index
+    return graph_->neighbors_[position_] > bond_.first;
+}
+
+void BondGraph::BondIterator::Step()
+{
+    position_++;
+    while(bond_.first < graph_->GetNumberOfAtoms() && position_ >= graph_->offsets_[bond_.first + 1])
+        bond_.first++;
+}
+
+BondGraph::AngleIterator& BondGraph::AngleIterator::operator++()
+{
+    this->Step();
+    if(angle_.center < graph_->GetNumberOfAtoms())
+    {
+        angle_.first = min(graph_->neighbors_[first_], graph_->neighbors_[last_]);
+        angle_.last = max(graph_->neighbors_[first_], graph_->neighbors_[last_]);
+    }
+    return *this;
+}
+
+void BondGraph::AngleIterator::Step()
+{
+    if(angle_.center == graph_->GetNumberOfAtoms())
+        return;
+    last_++;
+    if(last_ < graph_->offsets_[angle_.center + 1])
+        return;
+    first_++;
+    last_ = first_ + 1;
+    /// Move on to the next center with a pair of neighbors left
+    while(angle_.center < graph_->GetNumberOfAtoms() && last_ >= graph_->offsets_[angle_.center + 1])
+    {
+        angle_.center++;
+        first_ = graph_->offsets_[angle_.center];
+        last_ = first_ + 1;
+    }
+    if(angle_.center == graph_->GetNumberOfAtoms())
+        last_ = first_;
+}
+
+BondGraph::DihedralIterator& BondGraph::DihedralIterator::operator++()
+{
+    do
+    {
+        this->Step();
+    }
+    while(bond_ != graph_->BondsEnd() && !this->IsValid());
+    if(bond_ != graph_->BondsEnd())
+    {
+        dihedral_.first = graph_->neighbors_[first_];
+        dihedral_.second = bond_->first;
+        dihedral_.third = bond_->second;
+        dihedral_.fourth = graph_->neighbors_[fourth_];
+    }
+    return *this;
+}
+
+bool BondGraph::DihedralIterator::IsValid() const
+{
+    int first = graph_->neighbors_[first_];
+    int fourth = graph_->neighbors_[fourth_];
+    /// The outer atoms may not be the central atoms, nor the same atom (three membered ring)
+    return first != bond_->second && fourth != bond_->first && first != fourth;
+}
+
+void BondGraph::DihedralIterator::Step()
+{
+    fourth_++;
+    if(fourth_ < graph_->offsets_[bond_->second + 1])
+        return;
+    first_++;
+    fourth_ = graph_->offsets_[bond_->second];
+    if(first_ < graph_->offsets_[bond_->first + 1])
+        return;
+    ++bond_;
+    if(bond_ == graph_->BondsEnd())
+    {
+        first_ = graph_->neighbors_.size();
+        fourth_ = first_;
+        return;
+    }
+    first_ = graph_->offsets_[bond_->first];
+    fourth_ = graph_->offsets_[bond_->second];
+}
@@ -2,6 +2,7 @@
 #include "../../includes/MolecularModeling/assembly.hpp"
 #include "../../includes/MolecularModeling/atom.hpp"
 #include "../../includes/MolecularModeling/atomnode.hpp"
+#include "../../includes/MolecularModeling/bondgraph.hpp"
 
 using namespace std;
 using namespace MolecularModeling;
@@ -71,6 +72,7 @@ void Residue::SetName(string name)
 }
 void Residue::SetAtoms(AtomVector atoms)
 {
+    BondGraph::MarkOutdated();
     atoms_.clear();
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -79,6 +81,7 @@ void Residue::SetAtoms(AtomVector atoms)
 }
 void Residue::AddAtom(Atom *atom)
 {
+    BondGraph::MarkOutdated();
     atoms_.push_back(atom);
 }
 void Residue::SetHeadAtoms(AtomVector head_atoms)
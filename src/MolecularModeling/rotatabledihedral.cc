@@ -0,0 +1,154 @@
+#include <math.h>
+#include <map>
+
+#include "../../includes/MolecularModeling/rotatabledihedral.hpp"
+#include "../../includes/MolecularModeling/atom.hpp"
+#include "../../includes/MolecularModeling/atomnode.hpp"
+#include "../../includes/GeometryTopology/coordinate.hpp"
+#include "../../includes/GeometryTopology/geometrykernels.hpp"
+#include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+using namespace GeometryTopology;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+RotatableDihedral::RotatableDihedral() : rotatable_(false)
+{
+    atoms_ = AtomVector();
+    moving_atoms_ = AtomVector();
+}
+
+RotatableDihedral::RotatableDihedral(Atom *atom1, Atom *atom2, Atom *atom3, Atom *atom4)
+{
+    this->SetAtoms(atom1, atom2, atom3, atom4);
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+RotatableDihedral::AtomVector RotatableDihedral::GetAtoms()
+{
+    return atoms_;
+}
+
+RotatableDihedral::AtomVector RotatableDihedral::GetMovingAtoms()
+{
+    return moving_atoms_;
+}
+
+bool RotatableDihedral::IsRotatable()
+{
+    return rotatable_;
+}
+
+double RotatableDihedral::GetTorsion(int model_index)
+{
+    if(atoms_.size() != 4)
+        return gmml::dNotSet;
+    Vector3 b1 = Vector3(*atoms_.at(1)->GetCoordinates().at(model_index)) - Vector3(*atoms_.at(0)->GetCoordinates().at(model_index));
+    Vector3 b2 = Vector3(*atoms_.at(2)->GetCoordinates().at(model_index)) - Vector3(*atoms_.at(1)->GetCoordinates().at(model_index));
+    Vector3 b3 = Vector3(*atoms_.at(3)->GetCoordinates().at(model_index)) - Vector3(*atoms_.at(2)->GetCoordinates().at(model_index));
+    Vector3 n1 = b1.CrossProduct(b2);
+    Vector3 n2 = b2.CrossProduct(b3);
+    double y = b2.Length() * b1.DotProduct(n2);
+    double x = n1.DotProduct(n2);
+    return atan2(y, x) * gmml::PI_DEGREE / gmml::PI_RADIAN;
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void RotatableDihedral::SetAtoms(Atom *atom1, Atom *atom2, Atom *atom3, Atom *atom4)
+{
+    atoms_ = AtomVector();
+    atoms_.push_back(atom1);
+    atoms_.push_back(atom2);
+    atoms_.push_back(atom3);
+    atoms_.push_back(atom4);
+    this->FindMovingAtoms();
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void RotatableDihedral::SetTorsion(double torsion, int model_index)
+{
+    this->RotateTorsion(torsion - this->GetTorsion(model_index), model_index);
+}
+
+void RotatableDihedral::RotateTorsion(double angle, int model_index)
+{
+    if(!rotatable_)
+        return;
+    Vector3 origin = Vector3(*atoms_.at(2)->GetCoordinates().at(model_index));
+    Vector3 axis = origin - Vector3(*atoms_.at(1)->GetCoordinates().at(model_index));
+    if(axis.Length() < gmml::DIST_EPSILON)
+        return;
+
+    /// Rotation about the axis from the second to the third atom, following the right hand rule
+    vector<Coordinate*> moving_coordinates = vector<Coordinate*>();
+    moving_coordinates.reserve(moving_atoms_.size());
+    for(AtomVector::iterator it = moving_atoms_.begin(); it != moving_atoms_.end(); it++)
+        moving_coordinates.push_back((*it)->GetCoordinates().at(model_index));
+    RotateCoordinates(moving_coordinates, Matrix3::RotationAroundAxis(axis, gmml::ConvertDegree2Radian(angle)), origin);
+}
+
+void RotatableDihedral::FindMovingAtoms()
+{
+    moving_atoms_ = AtomVector();
+    rotatable_ = false;
+    Atom* fixed_atom = atoms_.at(1);
+    Atom* pivot_atom = atoms_.at(2);
+    if(fixed_atom == NULL || pivot_atom == NULL || pivot_atom->GetNode() == NULL)
+        return;
+
+    /// Walk the graph from the third atom without crossing the central bond; reaching the second atom again means a ring
+    map<Atom*, bool> visited = map<Atom*, bool>();
+    visited[pivot_atom] = true;
+    AtomVector stack = AtomVector();
+    AtomVector pivot_neighbors = pivot_atom->GetNode()->GetNodeNeighbors();
+    for(AtomVector::iterator it = pivot_neighbors.begin(); it != pivot_neighbors.end(); it++)
+    {
+        if((*it) != fixed_atom)
+            stack.push_back(*it);
+    }
+    while(!stack.empty())
+    {
+        Atom* atom = stack.back();
+        stack.pop_back();
+        if(visited.find(atom) != visited.end())
+            continue;
+        if(atom == fixed_atom)
+        {
+            moving_atoms_.clear();
+            return;
+        }
+        visited[atom] = true;
+        moving_atoms_.push_back(atom);
+        if(atom->GetNode() == NULL)
+            continue;
+        AtomVector neighbors = atom->GetNode()->GetNodeNeighbors();
+        for(AtomVector::iterator it = neighbors.begin(); it != neighbors.end(); it++)
+        {
+            if(visited.find(*it) == visited.end())
+                stack.push_back(*it);
+        }
+    }
+    rotatable_ = true;
+}
+
+//////////////////////////////////////////////////////////
+//                      DISPLAY FUNCTION                //
+//////////////////////////////////////////////////////////
+void RotatableDihedral::Print(ostream &out)
+{
+    if(atoms_.size() != 4)
+        return;
+    out << "Dihedral " << atoms_.at(0)->GetId() << " " << atoms_.at(1)->GetId() << " " << atoms_.at(2)->GetId() << " " << atoms_.at(3)->GetId()
+        << ": " << this->GetTorsion() << " degree, " << moving_atoms_.size() << " moving atoms"
+        << (rotatable_ ? "" : " (not rotatable)") << endl;
+}
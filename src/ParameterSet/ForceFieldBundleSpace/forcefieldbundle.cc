@@ -0,0 +1,1209 @@
+#include <fstream>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../../../includes/utils.hpp"
+#include "../../../includes/common.hpp"
+#include "../../../includes/instrumentation.hpp"
+#include "../../../includes/ParameterSet/ForceFieldBundleSpace/forcefieldbundle.hpp"
+#include "../../../includes/ParameterSet/ForceFieldBundleSpace/forcefieldbundleprocessingexception.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfile.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfileatom.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfilebond.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfileangle.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfiledihedral.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfiledihedralterm.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfile.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfileresidue.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfileatom.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfile.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
+#include "../../../includes/GeometryTopology/coordinate.hpp"
+
+using namespace std;
+using namespace gmml;
+using namespace ForceFieldBundleSpace;
+
+const uint32_t ForceFieldBundle::FORMAT_VERSION;
+const uint32_t ForceFieldBundle::BYTE_ORDER_MARK;
+const uint32_t ForceFieldBundle::IS_HYDROPHILIC;
+const uint32_t ForceFieldBundle::IS_EMPTY;
+const uint32_t ForceFieldBundle::IS_GENERIC;
+const uint32_t ForceFieldBundle::IS_IMPROPER;
+
+static const char BUNDLE_MAGIC[8] = { 'G', 'M', 'M', 'L', 'F', 'F', 'B', '\0' };
+/// Alignment of every table in the bundle, enough for the doubles of the records
+static const size_t BUNDLE_ALIGNMENT = 8;
+
+/// 32 bit FNV-1a hash
+static uint32_t Hash(const void* data, size_t size, uint32_t hash = 2166136261u)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t HashTypes(const ForceFieldBundle::StringId* types, int number_of_types)
+{
+    return Hash(types, number_of_types * sizeof(ForceFieldBundle::StringId));
+}
+
+/// Number of slots of a hash table for the given number of entries: a power of two with at most half of the slots in use
+static size_t HashTableSize(size_t number_of_entries)
+{
+    if(number_of_entries == 0)
+        return 0;
+    size_t size = 1;
+    while(size < 2 * number_of_entries)
+        size <<= 1;
+    return size;
+}
+
+/// Size of an entry of a table of a source, 0 if the kind of the source does not have the table
+static size_t TableEntrySize(uint32_t kind, int table)
+{
+    switch(kind)
+    {
+        case ForceFieldBundle::kParameterSource:
+            switch(table)
+            {
+                case ForceFieldBundle::kAtomTypeTable: return sizeof(ForceFieldBundle::AtomTypeRecord);
+                case ForceFieldBundle::kEquivalentTypeTable: return sizeof(ForceFieldBundle::StringId);
+                case ForceFieldBundle::kBondTable: return sizeof(ForceFieldBundle::BondRecord);
+                case ForceFieldBundle::kHbondCoefficientTable: return sizeof(double);
+                case ForceFieldBundle::kAngleTable: return sizeof(ForceFieldBundle::AngleRecord);
+                case ForceFieldBundle::kDihedralTable: return sizeof(ForceFieldBundle::DihedralRecord);
+                case ForceFieldBundle::kDihedralTermTable: return sizeof(ForceFieldBundle::DihedralTermRecord);
+                case ForceFieldBundle::kAtomTypeHashTable:
+                case ForceFieldBundle::kBondHashTable:
+                case ForceFieldBundle::kAngleHashTable:
+                case ForceFieldBundle::kDihedralHashTable: return sizeof(uint32_t);
+            }
+            break;
+        case ForceFieldBundle::kLibrarySource:
+            switch(table)
+            {
+                case ForceFieldBundle::kLibraryResidueTable: return sizeof(ForceFieldBundle::LibraryResidueRecord);
+                case ForceFieldBundle::kLibraryAtomTable: return sizeof(ForceFieldBundle::LibraryAtomRecord);
+                case ForceFieldBundle::kLibraryBondedAtomTable: return sizeof(int32_t);
+            }
+            break;
+        case ForceFieldBundle::kPrepSource:
+            switch(table)
+            {
+                case ForceFieldBundle::kPrepResidueTable: return sizeof(ForceFieldBundle::PrepResidueRecord);
+                case ForceFieldBundle::kPrepAtomTable: return sizeof(ForceFieldBundle::PrepAtomRecord);
+                case ForceFieldBundle::kPrepImproperTable: return sizeof(uint32_t);
+                case ForceFieldBundle::kPrepLoopTable: return 2 * sizeof(int32_t);
+            }
+            break;
+    }
+    return 0;
+}
+
+/// Whether the entries [first, first + count) lie within a table of the given number of entries
+static bool IsInTable(uint64_t first, uint64_t count, uint64_t table_count)
+{
+    return first <= table_count && count <= table_count - first;
+}
+
+static string BaseName(const string& path)
+{
+    size_t position = path.find_last_of('/');
+    return (position == string::npos) ? path : path.substr(position + 1);
+}
+
+/// Type of a parameter file from its content: frcmod files have a MASS section right after the title, the ionic ones have no
+/// bond, angle or dihedral sections
+static int DetectParameterFileType(const string& path)
+{
+    ifstream in_file(path.c_str());
+    string line;
+    getline(in_file, line);
+    if(!getline(in_file, line) || Trim(line) != "MASS")
+        return MAIN;
+    while(getline(in_file, line))
+    {
+        string keyword = Trim(line);
+        if(keyword == "BOND" || keyword == "ANGL" || keyword == "ANGLE" || keyword == "DIHE" || keyword == "DIHEDRAL" ||
+                keyword == "IMPR" || keyword == "IMPROPER")
+            return MODIFIED;
+    }
+    return IONICMOD;
+}
+
+namespace
+{
+    /*! \class
+      * Builds the content of a bundle file in memory
+      */
+    class BundleWriter
+    {
+        public:
+            BundleWriter()
+            {
+                buffer_.resize(sizeof(ForceFieldBundle::Header), 0);
+            }
+
+            ForceFieldBundle::StringId Intern(const string& value)
+            {
+                map<string, ForceFieldBundle::StringId>::iterator it = string_ids_.find(value);
+                if(it != string_ids_.end())
+                    return it->second;
+                ForceFieldBundle::StringId id = strings_.size();
+                strings_.push_back(value);
+                string_ids_[value] = id;
+                return id;
+            }
+
+            template<class T>
+            ForceFieldBundle::Table Append(const vector<T>& entries)
+            {
+                ForceFieldBundle::Table table;
+                buffer_.resize((buffer_.size() + BUNDLE_ALIGNMENT - 1) & ~(BUNDLE_ALIGNMENT - 1), 0);
+                table.offset = buffer_.size();
+                table.count = entries.size();
+                if(!entries.empty())
+                {
+                    const char* data = reinterpret_cast<const char*>(&entries[0]);
+                    buffer_.insert(buffer_.end(), data, data + entries.size() * sizeof(T));
+                }
+                return table;
+            }
+
+            /// Open addressing hash table over the atom types of the given records, a slot holds the record index + 1
+            template<class T>
+            ForceFieldBundle::Table AppendHashTable(const vector<T>& records, int number_of_types)
+            {
+                vector<uint32_t> slots = vector<uint32_t>(HashTableSize(records.size()), 0);
+                for(unsigned int i = 0; i < records.size(); i++)
+                {
+                    size_t slot = HashTypes(records[i].types, number_of_types) & (slots.size() - 1);
+                    while(slots[slot] != 0)
+                        slot = (slot + 1) & (slots.size() - 1);
+                    slots[slot] = i + 1;
+                }
+                return this->Append(slots);
+            }
+
+            ForceFieldBundle::Table AppendAtomTypeHashTable(const vector<ForceFieldBundle::AtomTypeRecord>& records)
+            {
+                vector<uint32_t> slots = vector<uint32_t>(HashTableSize(records.size()), 0);
+                for(unsigned int i = 0; i < records.size(); i++)
+                {
+                    size_t slot = HashTypes(&records[i].type, 1) & (slots.size() - 1);
+                    while(slots[slot] != 0)
+                        slot = (slot + 1) & (slots.size() - 1);
+                    slots[slot] = i + 1;
+                }
+                return this->Append(slots);
+            }
+
+            void AddSource(const ForceFieldBundle::SourceRecord& source)
+            {
+                sources_.push_back(source);
+            }
+
+            /// The string table and the source directory go last, after all strings have been interned
+            void Write(const string& bundle_file)
+            {
+                ForceFieldBundle::Header header;
+                memset(&header, 0, sizeof(header));
+                memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+                header.version = ForceFieldBundle::FORMAT_VERSION;
+                header.byte_order = ForceFieldBundle::BYTE_ORDER_MARK;
+
+                vector<uint64_t> offsets = vector<uint64_t>();
+                vector<char> characters = vector<char>();
+                vector<uint32_t> slots = vector<uint32_t>(HashTableSize(strings_.size()), 0);
+                for(unsigned int i = 0; i < strings_.size(); i++)
+                {
+                    offsets.push_back(characters.size());
+                    characters.insert(characters.end(), strings_[i].begin(), strings_[i].end());
+                    characters.push_back('\0');
+                    size_t slot = Hash(strings_[i].data(), strings_[i].size()) & (slots.size() - 1);
+                    while(slots[slot] != 0)
+                        slot = (slot + 1) & (slots.size() - 1);
+                    slots[slot] = i + 1;
+                }
+                offsets.push_back(characters.size());
+                header.string_offsets = this->Append(offsets);
+                header.string_data = this->Append(characters);
+                header.string_hash = this->Append(slots);
+                header.sources = this->Append(sources_);
+                header.size = buffer_.size();
+                memcpy(&buffer_[0], &header, sizeof(header));
+
+                ofstream out_file(bundle_file.c_str(), ios::out | ios::binary | ios::trunc);
+                if(!out_file.write(&buffer_[0], buffer_.size()))
+                    throw ForceFieldBundleProcessingException(__LINE__, "Error writing the bundle file " + bundle_file);
+                out_file.close();
+            }
+
+        private:
+            vector<char> buffer_;                                   /*!< Content of the bundle >*/
+            vector<string> strings_;                                /*!< Interned strings by id >*/
+            map<string, ForceFieldBundle::StringId> string_ids_;    /*!< Id of each interned string >*/
+            vector<ForceFieldBundle::SourceRecord> sources_;        /*!< Source directory >*/
+    };
+
+    template<class T>
+    void CopyTypes(BundleWriter& writer, const vector<string>& types, T& record, unsigned int number_of_types)
+    {
+        if(types.size() != number_of_types)
+            throw ForceFieldBundleProcessingException(__LINE__, "Unexpected number of atom types in a parameter");
+        for(unsigned int i = 0; i < number_of_types; i++)
+            record.types[i] = writer.Intern(types[i]);
+    }
+
+    ForceFieldBundle::SourceRecord NewSource(BundleWriter& writer, ForceFieldBundle::SourceKind kind, const string& path)
+    {
+        ForceFieldBundle::SourceRecord source;
+        memset(&source, 0, sizeof(source));
+        source.kind = kind;
+        source.name = writer.Intern(BaseName(path));
+        source.path = writer.Intern(path);
+        source.title = writer.Intern("");
+        return source;
+    }
+
+    void AddParameterFile(BundleWriter& writer, ParameterFileSpace::ParameterFile* parameter_file)
+    {
+        using namespace ParameterFileSpace;
+        ForceFieldBundle::SourceRecord source = NewSource(writer, ForceFieldBundle::kParameterSource, parameter_file->GetFilePath());
+        source.parameter_file_type = parameter_file->GetParameterFileType();
+        source.title = writer.Intern(parameter_file->GetTitle());
+
+        vector<ForceFieldBundle::AtomTypeRecord> atom_types = vector<ForceFieldBundle::AtomTypeRecord>();
+        vector<ForceFieldBundle::StringId> equivalent_types = vector<ForceFieldBundle::StringId>();
+        const ParameterFile::AtomTypeMap& atom_type_map = parameter_file->GetAtomTypes();
+        for(ParameterFile::AtomTypeMap::const_iterator it = atom_type_map.begin(); it != atom_type_map.end(); it++)
+        {
+            ForceFieldBundle::AtomTypeRecord record;
+            memset(&record, 0, sizeof(record));
+            record.type = writer.Intern(it->first);
+            record.dscr = writer.Intern("");
+            record.mod4_dscr = record.dscr;
+            ParameterFileAtom* atom = it->second;
+            if(atom == NULL)
+                record.flags = ForceFieldBundle::IS_EMPTY;
+            else
+            {
+                record.dscr = writer.Intern(atom->GetDscr());
+                record.mod4_dscr = writer.Intern(atom->GetMod4Dscr());
+                record.flags = (atom->GetIsHydrophilic()) ? ForceFieldBundle::IS_HYDROPHILIC : 0;
+                record.mass = atom->GetMass();
+                record.polarizability = atom->GetPolarizability();
+                record.radius = atom->GetRadius();
+                record.well_depth = atom->GetWellDepth();
+                vector<string> equivalent_list = atom->GetEquivalentList();
+                record.equivalent_first = equivalent_types.size();
+                record.equivalent_count = equivalent_list.size();
+                for(vector<string>::iterator it1 = equivalent_list.begin(); it1 != equivalent_list.end(); it1++)
+                    equivalent_types.push_back(writer.Intern(*it1));
+            }
+            atom_types.push_back(record);
+        }
+
+        vector<ForceFieldBundle::BondRecord> bonds = vector<ForceFieldBundle::BondRecord>();
+        vector<double> hbond_coefficients = vector<double>();
+        const ParameterFile::BondMap& bond_map = parameter_file->GetBonds();
+        for(ParameterFile::BondMap::const_iterator it = bond_map.begin(); it != bond_map.end(); it++)
+        {
+            ParameterFileBond* bond = it->second;
+            if(bond == NULL)
+                continue;
+            ForceFieldBundle::BondRecord record;
+            memset(&record, 0, sizeof(record));
+            CopyTypes(writer, it->first, record, 2);
+            record.dscr = writer.Intern(bond->GetDscr());
+            record.force_constant = bond->GetForceConstant();
+            record.length = bond->GetLength();
+            vector<double> coefficients = bond->GetHbondCoefficients();
+            record.hbond_coefficient_first = hbond_coefficients.size();
+            record.hbond_coefficient_count = coefficients.size();
+            hbond_coefficients.insert(hbond_coefficients.end(), coefficients.begin(), coefficients.end());
+            bonds.push_back(record);
+        }
+
+        vector<ForceFieldBundle::AngleRecord> angles = vector<ForceFieldBundle::AngleRecord>();
+        const ParameterFile::AngleMap& angle_map = parameter_file->GetAngles();
+        for(ParameterFile::AngleMap::const_iterator it = angle_map.begin(); it != angle_map.end(); it++)
+        {
+            ParameterFileAngle* angle = it->second;
+            if(angle == NULL)
+                continue;
+            ForceFieldBundle::AngleRecord record;
+            memset(&record, 0, sizeof(record));
+            CopyTypes(writer, it->first, record, 3);
+            record.dscr = writer.Intern(angle->GetDscr());
+            record.force_constant = angle->GetForceConstant();
+            record.angle = angle->GetAngle();
+            angles.push_back(record);
+        }
+
+        vector<ForceFieldBundle::DihedralRecord> dihedrals = vector<ForceFieldBundle::DihedralRecord>();
+        vector<ForceFieldBundle::DihedralTermRecord> dihedral_terms = vector<ForceFieldBundle::DihedralTermRecord>();
+        const ParameterFile::DihedralMap& dihedral_map = parameter_file->GetDihedrals();
+        for(ParameterFile::DihedralMap::const_iterator it = dihedral_map.begin(); it != dihedral_map.end(); it++)
+        {
+            ParameterFileDihedral* dihedral = it->second;
+            if(dihedral == NULL)
+                continue;
+            ForceFieldBundle::DihedralRecord record;
+            memset(&record, 0, sizeof(record));
+            CopyTypes(writer, it->first, record, 4);
+            record.flags = ((dihedral->GetIsGeneric()) ? ForceFieldBundle::IS_GENERIC : 0) |
+                    ((dihedral->GetIsImproper()) ? ForceFieldBundle::IS_IMPROPER : 0);
+            record.scee = dihedral->GetScee();
+            record.scnb = dihedral->GetScnb();
+            vector<ParameterFileDihedralTerm> terms = dihedral->GetTerms();
+            record.term_first = dihedral_terms.size();
+            record.term_count = terms.size();
+            for(vector<ParameterFileDihedralTerm>::iterator it1 = terms.begin(); it1 != terms.end(); it1++)
+            {
+                ForceFieldBundle::DihedralTermRecord term;
+                memset(&term, 0, sizeof(term));
+                term.factor = it1->GetFactor();
+                term.dscr = writer.Intern(it1->GetDscr());
+                term.force_constant = it1->GetForceConstant();
+                term.phase = it1->GetPhase();
+                term.periodicity = it1->GetPeriodicity();
+                dihedral_terms.push_back(term);
+            }
+            dihedrals.push_back(record);
+        }
+
+        source.tables[ForceFieldBundle::kAtomTypeTable] = writer.Append(atom_types);
+        source.tables[ForceFieldBundle::kEquivalentTypeTable] = writer.Append(equivalent_types);
+        source.tables[ForceFieldBundle::kBondTable] = writer.Append(bonds);
+        source.tables[ForceFieldBundle::kHbondCoefficientTable] = writer.Append(hbond_coefficients);
+        source.tables[ForceFieldBundle::kAngleTable] = writer.Append(angles);
+        source.tables[ForceFieldBundle::kDihedralTable] = writer.Append(dihedrals);
+        source.tables[ForceFieldBundle::kDihedralTermTable] = writer.Append(dihedral_terms);
+        source.tables[ForceFieldBundle::kAtomTypeHashTable] = writer.AppendAtomTypeHashTable(atom_types);
+        source.tables[ForceFieldBundle::kBondHashTable] = writer.AppendHashTable(bonds, 2);
+        source.tables[ForceFieldBundle::kAngleHashTable] = writer.AppendHashTable(angles, 3);
+        source.tables[ForceFieldBundle::kDihedralHashTable] = writer.AppendHashTable(dihedrals, 4);
+        writer.AddSource(source);
+    }
+
+    void AddLibraryFile(BundleWriter& writer, LibraryFileSpace::LibraryFile* library_file)
+    {
+        using namespace LibraryFileSpace;
+        ForceFieldBundle::SourceRecord source = NewSource(writer, ForceFieldBundle::kLibrarySource, library_file->GetFilePath());
+        vector<ForceFieldBundle::LibraryResidueRecord> residues = vector<ForceFieldBundle::LibraryResidueRecord>();
+        vector<ForceFieldBundle::LibraryAtomRecord> atoms = vector<ForceFieldBundle::LibraryAtomRecord>();
+        vector<int32_t> bonded_atoms = vector<int32_t>();
+        const LibraryFile::ResidueMap& residue_map = library_file->GetResidues();
+        for(LibraryFile::ResidueMap::const_iterator it = residue_map.begin(); it != residue_map.end(); it++)
+        {
+            LibraryFileResidue* residue = it->second;
+            ForceFieldBundle::LibraryResidueRecord record;
+            memset(&record, 0, sizeof(record));
+            record.name = writer.Intern(it->first);
+            record.head_atom_index = residue->GetHeadAtomIndex();
+            record.tail_atom_index = residue->GetTailAtomIndex();
+            record.box_angle = residue->GetBoxAngle();
+            record.box_length = residue->GetBoxLength();
+            record.box_width = residue->GetBoxWidth();
+            record.box_height = residue->GetBoxHeight();
+            LibraryFileResidue::AtomMap atom_map = residue->GetAtoms();
+            record.atom_first = atoms.size();
+            record.atom_count = atom_map.size();
+            for(LibraryFileResidue::AtomMap::iterator it1 = atom_map.begin(); it1 != atom_map.end(); it1++)
+            {
+                LibraryFileAtom* atom = it1->second;
+                ForceFieldBundle::LibraryAtomRecord atom_record;
+                memset(&atom_record, 0, sizeof(atom_record));
+                atom_record.type = writer.Intern(atom->GetType());
+                atom_record.name = writer.Intern(atom->GetName());
+                atom_record.residue_index = atom->GetResidueIndex();
+                atom_record.atom_index = atom->GetAtomIndex();
+                atom_record.atomic_number = atom->GetAtomicNumber();
+                atom_record.atom_order = atom->GetAtomOrder();
+                atom_record.charge = atom->GetCharge();
+                GeometryTopology::Coordinate coordinate = atom->GetCoordinate();
+                atom_record.coordinate[0] = coordinate.GetX();
+                atom_record.coordinate[1] = coordinate.GetY();
+                atom_record.coordinate[2] = coordinate.GetZ();
+                vector<int> bonded_atom_indices = atom->GetBondedAtomsIndices();
+                atom_record.bonded_atom_first = bonded_atoms.size();
+                atom_record.bonded_atom_count = bonded_atom_indices.size();
+                bonded_atoms.insert(bonded_atoms.end(), bonded_atom_indices.begin(), bonded_atom_indices.end());
+                atoms.push_back(atom_record);
+            }
+            residues.push_back(record);
+        }
+        source.tables[ForceFieldBundle::kLibraryResidueTable] = writer.Append(residues);
+        source.tables[ForceFieldBundle::kLibraryAtomTable] = writer.Append(atoms);
+        source.tables[ForceFieldBundle::kLibraryBondedAtomTable] = writer.Append(bonded_atoms);
+        writer.AddSource(source);
+    }
+
+    void AddPrepFile(BundleWriter& writer, PrepFileSpace::PrepFile* prep_file)
+    {
+        using namespace PrepFileSpace;
+        ForceFieldBundle::SourceRecord source = NewSource(writer, ForceFieldBundle::kPrepSource, prep_file->GetFilePath());
+        vector<ForceFieldBundle::PrepResidueRecord> residues = vector<ForceFieldBundle::PrepResidueRecord>();
+        vector<ForceFieldBundle::PrepAtomRecord> atoms = vector<ForceFieldBundle::PrepAtomRecord>();
+        vector<uint32_t> impropers = vector<uint32_t>();
+        vector<int32_t> loops = vector<int32_t>();
+        PrepFile::ResidueMap& residue_map = prep_file->GetResidues();
+        for(PrepFile::ResidueMap::iterator it = residue_map.begin(); it != residue_map.end(); it++)
+        {
+            PrepFileResidue* residue = it->second;
+            ForceFieldBundle::PrepResidueRecord record;
+            memset(&record, 0, sizeof(record));
+            record.title = writer.Intern(residue->GetTitle());
+            record.name = writer.Intern(it->first);
+            record.dummy_atom_type = writer.Intern(residue->GetDummyAtomType());
+            record.coordinate_type = residue->GetCoordinateType();
+            record.output_format = residue->GetOutputFormat();
+            record.geometry_type = residue->GetGeometryType();
+            record.dummy_atom_omission = residue->GetDummyAtomOmission();
+            record.dummy_atom_position = residue->GetDummyAtomPosition();
+            record.charge = residue->GetCharge();
+            PrepFileResidue::PrepFileAtomVector residue_atoms = residue->GetAtoms();
+            record.atom_first = atoms.size();
+            record.atom_count = residue_atoms.size();
+            for(PrepFileResidue::PrepFileAtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++)
+            {
+                PrepFileAtom* atom = *it1;
+                ForceFieldBundle::PrepAtomRecord atom_record;
+                memset(&atom_record, 0, sizeof(atom_record));
+                atom_record.index = atom->GetIndex();
+                atom_record.name = writer.Intern(atom->GetName());
+                atom_record.type = writer.Intern(atom->GetType());
+                atom_record.topological_type = atom->GetTopologicalType();
+                atom_record.bond_index = atom->GetBondIndex();
+                atom_record.angle_index = atom->GetAngleIndex();
+                atom_record.dihedral_index = atom->GetDihedralIndex();
+                atom_record.bond_length = atom->GetBondLength();
+                atom_record.angle = atom->GetAngle();
+                atom_record.dihedral = atom->GetDihedral();
+                atom_record.charge = atom->GetCharge();
+                atoms.push_back(atom_record);
+            }
+            PrepFileResidue::DihedralVector improper_dihedrals = residue->GetImproperDihedrals();
+            record.improper_first = impropers.size();
+            for(PrepFileResidue::DihedralVector::iterator it1 = improper_dihedrals.begin(); it1 != improper_dihedrals.end(); it1++)
+            {
+                impropers.push_back(it1->size());
+                for(PrepFileResidue::Dihedral::iterator it2 = it1->begin(); it2 != it1->end(); it2++)
+                    impropers.push_back(writer.Intern(*it2));
+            }
+            record.improper_count = impropers.size() - record.improper_first;
+            PrepFileResidue::Loop residue_loops = residue->GetLoops();
+            record.loop_first = loops.size() / 2;
+            record.loop_count = residue_loops.size();
+            for(PrepFileResidue::Loop::iterator it1 = residue_loops.begin(); it1 != residue_loops.end(); it1++)
+            {
+                loops.push_back(it1->first);
+                loops.push_back(it1->second);
+            }
+            residues.push_back(record);
+        }
+        source.tables[ForceFieldBundle::kPrepResidueTable] = writer.Append(residues);
+        source.tables[ForceFieldBundle::kPrepAtomTable] = writer.Append(atoms);
+        source.tables[ForceFieldBundle::kPrepImproperTable] = writer.Append(impropers);
+        source.tables[ForceFieldBundle::kPrepLoopTable] = writer.Append(loops);
+        source.tables[ForceFieldBundle::kPrepLoopTable].count /= 2;
+        writer.AddSource(source);
+    }
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+ForceFieldBundle::ForceFieldBundle() : path_(""), data_(NULL), size_(0), header_(NULL), sources_(NULL) {}
+
+ForceFieldBundle::ForceFieldBundle(const string& bundle_file) : path_(""), data_(NULL), size_(0), header_(NULL), sources_(NULL)
+{
+    this->Open(bundle_file);
+}
+
+ForceFieldBundle::~ForceFieldBundle()
+{
+    this->Close();
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+const string& ForceFieldBundle::GetFilePath() const
+{
+    return path_;
+}
+
+int ForceFieldBundle::GetNumberOfSources() const
+{
+    return (header_ == NULL) ? 0 : header_->sources.count;
+}
+
+ForceFieldBundle::SourceKind ForceFieldBundle::GetSourceKind(int source) const
+{
+    return (SourceKind)this->GetSource(source).kind;
+}
+
+const char* ForceFieldBundle::GetSourceName(int source) const
+{
+    return this->GetString(this->GetSource(source).name);
+}
+
+const char* ForceFieldBundle::GetSourcePath(int source) const
+{
+    return this->GetString(this->GetSource(source).path);
+}
+
+int ForceFieldBundle::GetParameterFileType(int source) const
+{
+    return this->GetSource(source, kParameterSource).parameter_file_type;
+}
+
+int ForceFieldBundle::FindSource(const string& name) const
+{
+    for(int i = 0; i < this->GetNumberOfSources(); i++)
+    {
+        if(name == this->GetString(sources_[i].name) || name == this->GetString(sources_[i].path))
+            return i;
+    }
+    return -1;
+}
+
+const char* ForceFieldBundle::GetString(StringId id) const
+{
+    if(header_ == NULL || (uint64_t)id + 1 >= header_->string_offsets.count)
+        throw ForceFieldBundleProcessingException(__LINE__, "Invalid string index");
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data_ + header_->string_offsets.offset);
+    return data_ + header_->string_data.offset + offsets[id];
+}
+
+bool ForceFieldBundle::FindString(const string& value, StringId& id) const
+{
+    if(header_ == NULL || header_->string_hash.count == 0)
+        return false;
+    const uint32_t* slots = reinterpret_cast<const uint32_t*>(data_ + header_->string_hash.offset);
+    size_t mask = header_->string_hash.count - 1;
+    /// A table without an empty slot ends the probing after one round
+    size_t probes = 0;
+    for(size_t slot = Hash(value.data(), value.size()) & mask; slots[slot] != 0 && probes < header_->string_hash.count; slot = (slot + 1) & mask, probes++)
+    {
+        if(value == this->GetString(slots[slot] - 1))
+        {
+            id = slots[slot] - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+const ForceFieldBundle::AtomTypeRecord* ForceFieldBundle::FindAtomType(int source, const string& type) const
+{
+    const SourceRecord& record = this->GetSource(source, kParameterSource);
+    int index = this->FindRecord(record, kAtomTypeHashTable, kAtomTypeTable, &type, 1);
+    return (index < 0) ? NULL : this->GetTable<AtomTypeRecord>(record, kAtomTypeTable) + index;
+}
+
+const ForceFieldBundle::BondRecord* ForceFieldBundle::FindBond(int source, const string& type1, const string& type2) const
+{
+    const SourceRecord& record = this->GetSource(source, kParameterSource);
+    string types[2] = { type1, type2 };
+    int index = this->FindRecord(record, kBondHashTable, kBondTable, types, 2);
+    return (index < 0) ? NULL : this->GetTable<BondRecord>(record, kBondTable) + index;
+}
+
+const ForceFieldBundle::AngleRecord* ForceFieldBundle::FindAngle(int source, const string& type1, const string& type2, const string& type3) const
+{
+    const SourceRecord& record = this->GetSource(source, kParameterSource);
+    string types[3] = { type1, type2, type3 };
+    int index = this->FindRecord(record, kAngleHashTable, kAngleTable, types, 3);
+    return (index < 0) ? NULL : this->GetTable<AngleRecord>(record, kAngleTable) + index;
+}
+
+const ForceFieldBundle::DihedralRecord* ForceFieldBundle::FindDihedral(int source, const string& type1, const string& type2, const string& type3,
+                                                                       const string& type4) const
+{
+    const SourceRecord& record = this->GetSource(source, kParameterSource);
+    string types[4] = { type1, type2, type3, type4 };
+    int index = this->FindRecord(record, kDihedralHashTable, kDihedralTable, types, 4);
+    return (index < 0) ? NULL : this->GetTable<DihedralRecord>(record, kDihedralTable) + index;
+}
+
+const ForceFieldBundle::DihedralTermRecord* ForceFieldBundle::GetDihedralTerms(int source) const
+{
+    return this->GetTable<DihedralTermRecord>(this->GetSource(source, kParameterSource), kDihedralTermTable);
+}
+
+const ForceFieldBundle::SourceRecord& ForceFieldBundle::GetSource(int source) const
+{
+    if(source < 0 || source >= this->GetNumberOfSources())
+        throw ForceFieldBundleProcessingException(__LINE__, "Invalid source index");
+    return sources_[source];
+}
+
+const ForceFieldBundle::SourceRecord& ForceFieldBundle::GetSource(int source, SourceKind kind) const
+{
+    const SourceRecord& record = this->GetSource(source);
+    if(record.kind != (uint32_t)kind)
+        throw ForceFieldBundleProcessingException(__LINE__, "The source " + string(this->GetString(record.name)) + " has another file type");
+    return record;
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void ForceFieldBundle::Open(const string& bundle_file)
+{
+    GMML_SCOPED_TIMER("ForceFieldBundle::Open");
+    this->Close();
+    int descriptor = open(bundle_file.c_str(), O_RDONLY);
+    if(descriptor < 0)
+        throw ForceFieldBundleProcessingException(__LINE__, "Bundle file not found");
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(Header))
+    {
+        close(descriptor);
+        throw ForceFieldBundleProcessingException(__LINE__, "Invalid bundle file " + bundle_file);
+    }
+    void* mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    /// The mapping stays valid after the descriptor has been closed
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+        throw ForceFieldBundleProcessingException(__LINE__, "Unable to map the bundle file " + bundle_file);
+    data_ = (const char*)mapping;
+    size_ = status.st_size;
+    header_ = reinterpret_cast<const Header*>(data_);
+    path_ = bundle_file;
+    try
+    {
+        this->Validate();
+    }
+    catch(...)
+    {
+        this->Close();
+        throw;
+    }
+    sources_ = reinterpret_cast<const SourceRecord*>(data_ + header_->sources.offset);
+    GMML_COUNT("force field bundles opened", 1);
+}
+
+void ForceFieldBundle::Close()
+{
+    if(data_ != NULL)
+        munmap((void*)data_, size_);
+    path_ = "";
+    data_ = NULL;
+    size_ = 0;
+    header_ = NULL;
+    sources_ = NULL;
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void ForceFieldBundle::Compile(const string& leaprc_file, const vector<string>& search_paths, const string& bundle_file)
+{
+    GMML_SCOPED_TIMER("ForceFieldBundle::Compile");
+    ifstream in_file(leaprc_file.c_str());
+    if(!in_file)
+        throw ForceFieldBundleProcessingException(__LINE__, "Leaprc file not found");
+    size_t position = leaprc_file.find_last_of('/');
+    vector<string> directories = vector<string>(1, (position == string::npos) ? "." : leaprc_file.substr(0, position));
+    directories.insert(directories.end(), search_paths.begin(), search_paths.end());
+
+    vector<ParameterFileSpace::ParameterFile*> parameter_files = vector<ParameterFileSpace::ParameterFile*>();
+    vector<LibraryFileSpace::LibraryFile*> library_files = vector<LibraryFileSpace::LibraryFile*>();
+    vector<PrepFileSpace::PrepFile*> prep_files = vector<PrepFileSpace::PrepFile*>();
+    string line;
+    int line_number = 0;
+    try
+    {
+        while(getline(in_file, line))
+        {
+            line_number++;
+            /// Commands are "[variable =] command file", the rest of the line after a # is a comment
+            line = line.substr(0, line.find('#'));
+            vector<string> tokens = Split(line, " \t\r");
+            if(tokens.size() >= 3 && tokens.at(1) == "=")
+                tokens.erase(tokens.begin(), tokens.begin() + 2);
+            if(tokens.size() < 2)
+                continue;
+            string command = tokens.at(0);
+            transform(command.begin(), command.end(), command.begin(), ::tolower);
+            if(command != "loadamberparams" && command != "loadoff" && command != "loadamberprep")
+                continue;
+            string path = "";
+            if(tokens.at(1).at(0) == '/')
+                path = tokens.at(1);
+            for(vector<string>::iterator it = directories.begin(); path.empty() && it != directories.end(); it++)
+            {
+                if(ifstream((*it + "/" + tokens.at(1)).c_str()))
+                    path = *it + "/" + tokens.at(1);
+            }
+            if(path.empty() || !ifstream(path.c_str()))
+                throw ForceFieldBundleProcessingException(line_number, "File not found: " + tokens.at(1));
+            if(command == "loadamberparams")
+                parameter_files.push_back(new ParameterFileSpace::ParameterFile(path, DetectParameterFileType(path)));
+            else if(command == "loadoff")
+                library_files.push_back(new LibraryFileSpace::LibraryFile(path));
+            else
+                prep_files.push_back(new PrepFileSpace::PrepFile(path));
+        }
+        Compile(parameter_files, library_files, prep_files, bundle_file);
+    }
+    catch(...)
+    {
+        for(unsigned int i = 0; i < parameter_files.size(); i++)
+            delete parameter_files[i];
+        for(unsigned int i = 0; i < library_files.size(); i++)
+            delete library_files[i];
+        for(unsigned int i = 0; i < prep_files.size(); i++)
+            delete prep_files[i];
+        throw;
+    }
+    for(unsigned int i = 0; i < parameter_files.size(); i++)
+        delete parameter_files[i];
+    for(unsigned int i = 0; i < library_files.size(); i++)
+        delete library_files[i];
+    for(unsigned int i = 0; i < prep_files.size(); i++)
+        delete prep_files[i];
+}
+
+void ForceFieldBundle::Compile(const vector<ParameterFileSpace::ParameterFile*>& parameter_files,
+                               const vector<LibraryFileSpace::LibraryFile*>& library_files,
+                               const vector<PrepFileSpace::PrepFile*>& prep_files, const string& bundle_file)
+{
+    BundleWriter writer = BundleWriter();
+    for(vector<ParameterFileSpace::ParameterFile*>::const_iterator it = parameter_files.begin(); it != parameter_files.end(); it++)
+        AddParameterFile(writer, *it);
+    for(vector<LibraryFileSpace::LibraryFile*>::const_iterator it = library_files.begin(); it != library_files.end(); it++)
+        AddLibraryFile(writer, *it);
+    for(vector<PrepFileSpace::PrepFile*>::const_iterator it = prep_files.begin(); it != prep_files.end(); it++)
+        AddPrepFile(writer, *it);
+    writer.Write(bundle_file);
+}
+
+ParameterFileSpace::ParameterFile* ForceFieldBundle::LoadParameterFile(int source) const
+{
+    using namespace ParameterFileSpace;
+    GMML_SCOPED_TIMER("ForceFieldBundle::LoadParameterFile");
+    const SourceRecord& record = this->GetSource(source, kParameterSource);
+    ParameterFile* parameter_file = new ParameterFile(record.parameter_file_type);
+    parameter_file->SetPath(this->GetString(record.path));
+    parameter_file->SetTitle(this->GetString(record.title));
+    MemoryArenaScope arena_scope(parameter_file->GetArena());
+
+    ParameterFile::AtomTypeMap atom_types = ParameterFile::AtomTypeMap();
+    const AtomTypeRecord* atom_type_records = this->GetTable<AtomTypeRecord>(record, kAtomTypeTable);
+    const StringId* equivalent_types = this->GetTable<StringId>(record, kEquivalentTypeTable);
+    for(uint64_t i = 0; i < record.tables[kAtomTypeTable].count; i++)
+    {
+        const AtomTypeRecord& atom_type = atom_type_records[i];
+        string type = this->GetString(atom_type.type);
+        if((atom_type.flags & IS_EMPTY) != 0)
+        {
+            atom_types[type] = NULL;
+            continue;
+        }
+        ParameterFileAtom* atom = new ParameterFileAtom(type, atom_type.mass, atom_type.polarizability, this->GetString(atom_type.dscr));
+        atom->SetRadius(atom_type.radius);
+        atom->SetWellDepth(atom_type.well_depth);
+        atom->SetMod4Dscr(this->GetString(atom_type.mod4_dscr));
+        atom->SetIsHydrophilic((atom_type.flags & IS_HYDROPHILIC) != 0);
+        vector<string> equivalent_list = vector<string>();
+        for(uint32_t j = 0; j < atom_type.equivalent_count; j++)
+            equivalent_list.push_back(this->GetString(equivalent_types[atom_type.equivalent_first + j]));
+        atom->SetEquivalentList(equivalent_list);
+        atom_types[type] = atom;
+    }
+
+    ParameterFile::BondMap bonds = ParameterFile::BondMap();
+    const BondRecord* bond_records = this->GetTable<BondRecord>(record, kBondTable);
+    const double* hbond_coefficients = this->GetTable<double>(record, kHbondCoefficientTable);
+    for(uint64_t i = 0; i < record.tables[kBondTable].count; i++)
+    {
+        const BondRecord& bond_record = bond_records[i];
+        vector<string> types = vector<string>();
+        types.push_back(this->GetString(bond_record.types[0]));
+        types.push_back(this->GetString(bond_record.types[1]));
+        ParameterFileBond* bond = new ParameterFileBond(types, bond_record.force_constant, bond_record.length, this->GetString(bond_record.dscr));
+        bond->SetHbondCoefficients(vector<double>(hbond_coefficients + bond_record.hbond_coefficient_first,
+                                                  hbond_coefficients + bond_record.hbond_coefficient_first + bond_record.hbond_coefficient_count));
+        bonds[types] = bond;
+    }
+
+    ParameterFile::AngleMap angles = ParameterFile::AngleMap();
+    const AngleRecord* angle_records = this->GetTable<AngleRecord>(record, kAngleTable);
+    for(uint64_t i = 0; i < record.tables[kAngleTable].count; i++)
+    {
+        const AngleRecord& angle_record = angle_records[i];
+        vector<string> types = vector<string>();
+        for(int j = 0; j < 3; j++)
+            types.push_back(this->GetString(angle_record.types[j]));
+        angles[types] = new ParameterFileAngle(types, angle_record.force_constant, angle_record.angle, this->GetString(angle_record.dscr));
+    }
+
+    ParameterFile::DihedralMap dihedrals = ParameterFile::DihedralMap();
+    const DihedralRecord* dihedral_records = this->GetTable<DihedralRecord>(record, kDihedralTable);
+    const DihedralTermRecord* term_records = this->GetTable<DihedralTermRecord>(record, kDihedralTermTable);
+    for(uint64_t i = 0; i < record.tables[kDihedralTable].count; i++)
+    {
+        const DihedralRecord& dihedral_record = dihedral_records[i];
+        vector<string> types = vector<string>();
+        for(int j = 0; j < 4; j++)
+            types.push_back(this->GetString(dihedral_record.types[j]));
+        ParameterFileDihedral* dihedral = new ParameterFileDihedral();
+        dihedral->SetTypes(types);
+        for(uint32_t j = 0; j < dihedral_record.term_count; j++)
+        {
+            const DihedralTermRecord& term = term_records[dihedral_record.term_first + j];
+            dihedral->AddTerm(ParameterFileDihedralTerm(term.factor, term.force_constant, term.phase, term.periodicity, this->GetString(term.dscr)));
+        }
+        dihedral->SetScee(dihedral_record.scee);
+        dihedral->SetScnb(dihedral_record.scnb);
+        dihedral->SetIsGeneric((dihedral_record.flags & IS_GENERIC) != 0);
+        dihedral->SetIsImproper((dihedral_record.flags & IS_IMPROPER) != 0);
+        dihedrals[types] = dihedral;
+    }
+
+    parameter_file->SetAtomTypes(atom_types);
+    parameter_file->SetBonds(bonds);
+    parameter_file->SetAngles(angles);
+    parameter_file->SetDihedrals(dihedrals);
+    return parameter_file;
+}
+
+LibraryFileSpace::LibraryFile* ForceFieldBundle::LoadLibraryFile(int source) const
+{
+    using namespace LibraryFileSpace;
+    GMML_SCOPED_TIMER("ForceFieldBundle::LoadLibraryFile");
+    const SourceRecord& record = this->GetSource(source, kLibrarySource);
+    LibraryFile* library_file = new LibraryFile();
+    library_file->SetPath(this->GetString(record.path));
+    MemoryArenaScope arena_scope(library_file->GetArena());
+
+    LibraryFile::ResidueMap residues = LibraryFile::ResidueMap();
+    const LibraryResidueRecord* residue_records = this->GetTable<LibraryResidueRecord>(record, kLibraryResidueTable);
+    const LibraryAtomRecord* atom_records = this->GetTable<LibraryAtomRecord>(record, kLibraryAtomTable);
+    const int32_t* bonded_atoms = this->GetTable<int32_t>(record, kLibraryBondedAtomTable);
+    for(uint64_t i = 0; i < record.tables[kLibraryResidueTable].count; i++)
+    {
+        const LibraryResidueRecord& residue_record = residue_records[i];
+        string name = this->GetString(residue_record.name);
+        LibraryFileResidue* residue = new LibraryFileResidue(name);
+        residue->SetBoxAngle(residue_record.box_angle);
+        residue->SetBoxLength(residue_record.box_length);
+        residue->SetBoxWidth(residue_record.box_width);
+        residue->SetBoxHeight(residue_record.box_height);
+        residue->SetHeadAtomIndex(residue_record.head_atom_index);
+        residue->SetTailAtomIndex(residue_record.tail_atom_index);
+        for(uint32_t j = 0; j < residue_record.atom_count; j++)
+        {
+            const LibraryAtomRecord& atom_record = atom_records[residue_record.atom_first + j];
+            LibraryFileAtom* atom = new LibraryFileAtom(this->GetString(atom_record.type), this->GetString(atom_record.name), atom_record.residue_index,
+                                                        atom_record.atom_index, atom_record.atomic_number, atom_record.charge);
+            GeometryTopology::Coordinate coordinate = GeometryTopology::Coordinate(atom_record.coordinate[0], atom_record.coordinate[1], atom_record.coordinate[2]);
+            atom->SetCoordinate(coordinate);
+            atom->SetBondedAtomsIndices(vector<int>(bonded_atoms + atom_record.bonded_atom_first,
+                                                    bonded_atoms + atom_record.bonded_atom_first + atom_record.bonded_atom_count));
+            atom->SetAtomOrder(atom_record.atom_order);
+            residue->AddAtom(atom);
+        }
+        residues[name] = residue;
+    }
+    library_file->SetResidues(residues);
+    return library_file;
+}
+
+PrepFileSpace::PrepFile* ForceFieldBundle::LoadPrepFile(int source) const
+{
+    using namespace PrepFileSpace;
+    GMML_SCOPED_TIMER("ForceFieldBundle::LoadPrepFile");
+    const SourceRecord& record = this->GetSource(source, kPrepSource);
+    PrepFile* prep_file = new PrepFile();
+    prep_file->SetPath(this->GetString(record.path));
+    MemoryArenaScope arena_scope(prep_file->GetArena());
+
+    PrepFile::ResidueMap residues = PrepFile::ResidueMap();
+    const PrepResidueRecord* residue_records = this->GetTable<PrepResidueRecord>(record, kPrepResidueTable);
+    const PrepAtomRecord* atom_records = this->GetTable<PrepAtomRecord>(record, kPrepAtomTable);
+    const uint32_t* impropers = this->GetTable<uint32_t>(record, kPrepImproperTable);
+    const int32_t* loops = this->GetTable<int32_t>(record, kPrepLoopTable);
+    for(uint64_t i = 0; i < record.tables[kPrepResidueTable].count; i++)
+    {
+        const PrepResidueRecord& residue_record = residue_records[i];
+        string name = this->GetString(residue_record.name);
+        PrepFileResidue* residue = new PrepFileResidue();
+        residue->SetTitle(this->GetString(residue_record.title));
+        residue->SetName(name);
+        residue->SetCoordinateType((CoordinateType)residue_record.coordinate_type);
+        residue->SetOutputFormat((OutputFormat)residue_record.output_format);
+        residue->SetGeometryType((GeometryType)residue_record.geometry_type);
+        residue->SetDummyAtomOmission((DummyAtomOmission)residue_record.dummy_atom_omission);
+        residue->SetDummyAtomType(this->GetString(residue_record.dummy_atom_type));
+        residue->SetDummyAtomPosition((DummyAtomPosition)residue_record.dummy_atom_position);
+        residue->SetCharge(residue_record.charge);
+        for(uint32_t j = 0; j < residue_record.atom_count; j++)
+        {
+            const PrepAtomRecord& atom_record = atom_records[residue_record.atom_first + j];
+            PrepFileAtom* atom = new PrepFileAtom();
+            atom->SetIndex(atom_record.index);
+            atom->SetName(this->GetString(atom_record.name));
+            atom->SetType(this->GetString(atom_record.type));
+            atom->SetTopologicalType((TopologicalType)atom_record.topological_type);
+            atom->SetBondIndex(atom_record.bond_index);
+            atom->SetAngleIndex(atom_record.angle_index);
+            atom->SetDihedralIndex(atom_record.dihedral_index);
+            atom->SetBondLength(atom_record.bond_length);
+            atom->SetAngle(atom_record.angle);
+            atom->SetDihedral(atom_record.dihedral);
+            atom->SetCharge(atom_record.charge);
+            residue->AddAtom(atom);
+        }
+        PrepFileResidue::DihedralVector improper_dihedrals = PrepFileResidue::DihedralVector();
+        for(uint32_t j = residue_record.improper_first; j < residue_record.improper_first + residue_record.improper_count; j += impropers[j] + 1)
+        {
+            PrepFileResidue::Dihedral improper_dihedral = PrepFileResidue::Dihedral();
+            for(uint32_t k = 1; k <= impropers[j]; k++)
+                improper_dihedral.push_back(this->GetString(impropers[j + k]));
+            improper_dihedrals.push_back(improper_dihedral);
+        }
+        residue->SetImproperDihedrals(improper_dihedrals);
+        PrepFileResidue::Loop residue_loops = PrepFileResidue::Loop();
+        for(uint32_t j = residue_record.loop_first; j < residue_record.loop_first + residue_record.loop_count; j++)
+            residue_loops[loops[2 * j]] = loops[2 * j + 1];
+        residue->SetLoops(residue_loops);
+        residue->BuildTemplate();
+        residues[name] = residue;
+    }
+    prep_file->SetResidues(residues);
+    return prep_file;
+}
+
+int ForceFieldBundle::FindRecord(const SourceRecord& source, int hash_table, int record_table, const string* types, int number_of_types) const
+{
+    StringId ids[4];
+    for(int i = 0; i < number_of_types; i++)
+    {
+        /// A type that is not in the bundle is not in any of its records either
+        if(!this->FindString(types[i], ids[i]))
+            return -1;
+    }
+    uint64_t size = source.tables[hash_table].count;
+    if(size == 0)
+        return -1;
+    const uint32_t* slots = this->GetTable<uint32_t>(source, hash_table);
+    const char* records = data_ + source.tables[record_table].offset;
+    size_t record_size = TableEntrySize(source.kind, record_table);
+    size_t probes = 0;
+    for(size_t slot = HashTypes(ids, number_of_types) & (size - 1); slots[slot] != 0 && probes < size; slot = (slot + 1) & (size - 1), probes++)
+    {
+        /// The atom types are the first member of every record that is hashed
+        const StringId* record_types = reinterpret_cast<const StringId*>(records + (slots[slot] - 1) * record_size);
+        if(equal(ids, ids + number_of_types, record_types))
+            return slots[slot] - 1;
+    }
+    return -1;
+}
+
+/// Check the header, that every table lies within the mapping and that every index a record holds (strings, ranges of other tables
+/// and hash table slots) lies within its table, so the accessors and the lookups can use the tables without bound checks
+void ForceFieldBundle::Validate() const
+{
+    if(memcmp(header_->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0)
+        throw ForceFieldBundleProcessingException(__LINE__, "Not a force field bundle: " + path_);
+    if(header_->byte_order != BYTE_ORDER_MARK)
+        throw ForceFieldBundleProcessingException(__LINE__, "The bundle has been compiled on a machine of another byte order, compile it again");
+    if(header_->version != FORMAT_VERSION)
+        throw ForceFieldBundleProcessingException(__LINE__, "The bundle has another format version, compile it again");
+    if(header_->size != size_)
+        throw ForceFieldBundleProcessingException(__LINE__, "Truncated bundle file " + path_);
+
+    const Table* header_tables[4] = { &header_->string_offsets, &header_->string_data, &header_->string_hash, &header_->sources };
+    size_t header_entry_sizes[4] = { sizeof(uint64_t), sizeof(char), sizeof(uint32_t), sizeof(SourceRecord) };
+    for(int i = 0; i < 4; i++)
+    {
+        if(header_tables[i]->offset % BUNDLE_ALIGNMENT != 0 || header_tables[i]->offset > size_ ||
+                header_tables[i]->count > (size_ - header_tables[i]->offset) / header_entry_sizes[i])
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+    }
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data_ + header_->string_offsets.offset);
+    if(header_->string_offsets.count == 0 || offsets[header_->string_offsets.count - 1] > header_->string_data.count ||
+            (header_->string_hash.count & (header_->string_hash.count - 1)) != 0)
+        throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+    /// Every string has to end with its terminator before the next one starts
+    uint64_t number_of_strings = header_->string_offsets.count - 1;
+    const char* string_data = data_ + header_->string_data.offset;
+    for(uint64_t i = 0; i < number_of_strings; i++)
+    {
+        if(offsets[i] >= offsets[i + 1] || offsets[i + 1] > header_->string_data.count || string_data[offsets[i + 1] - 1] != '\0')
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt string table in bundle file " + path_);
+    }
+    const uint32_t* string_slots = reinterpret_cast<const uint32_t*>(data_ + header_->string_hash.offset);
+    for(uint64_t i = 0; i < header_->string_hash.count; i++)
+    {
+        if(string_slots[i] > number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt string hash table in bundle file " + path_);
+    }
+
+    const SourceRecord* sources = reinterpret_cast<const SourceRecord*>(data_ + header_->sources.offset);
+    for(uint64_t i = 0; i < header_->sources.count; i++)
+    {
+        for(int j = 0; j < NUMBER_OF_TABLES; j++)
+        {
+            const Table& table = sources[i].tables[j];
+            size_t entry_size = TableEntrySize(sources[i].kind, j);
+            if(table.count == 0)
+                continue;
+            if(entry_size == 0 || table.offset % BUNDLE_ALIGNMENT != 0 || table.offset > size_ || table.count > (size_ - table.offset) / entry_size)
+                throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+        }
+        if(sources[i].name >= number_of_strings || sources[i].path >= number_of_strings || sources[i].title >= number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+        switch(sources[i].kind)
+        {
+            case kParameterSource:
+                this->ValidateParameterSource(sources[i], number_of_strings);
+                break;
+            case kLibrarySource:
+                this->ValidateLibrarySource(sources[i], number_of_strings);
+                break;
+            case kPrepSource:
+                this->ValidatePrepSource(sources[i], number_of_strings);
+                break;
+            default:
+                throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+        }
+    }
+}
+
+void ForceFieldBundle::ValidateParameterSource(const SourceRecord& source, uint64_t number_of_strings) const
+{
+    const Table* tables = source.tables;
+    for(int j = kAtomTypeHashTable; j <= kDihedralHashTable; j++)
+    {
+        if((tables[j].count & (tables[j].count - 1)) != 0)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bundle file " + path_);
+    }
+
+    const StringId* equivalent_types = this->GetTable<StringId>(source, kEquivalentTypeTable);
+    for(uint64_t i = 0; i < tables[kEquivalentTypeTable].count; i++)
+    {
+        if(equivalent_types[i] >= number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt equivalent atom type table in bundle file " + path_);
+    }
+    const AtomTypeRecord* atom_types = this->GetTable<AtomTypeRecord>(source, kAtomTypeTable);
+    for(uint64_t i = 0; i < tables[kAtomTypeTable].count; i++)
+    {
+        const AtomTypeRecord& atom_type = atom_types[i];
+        if(atom_type.type >= number_of_strings || atom_type.dscr >= number_of_strings || atom_type.mod4_dscr >= number_of_strings ||
+                !IsInTable(atom_type.equivalent_first, atom_type.equivalent_count, tables[kEquivalentTypeTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt atom type table in bundle file " + path_);
+    }
+    const BondRecord* bonds = this->GetTable<BondRecord>(source, kBondTable);
+    for(uint64_t i = 0; i < tables[kBondTable].count; i++)
+    {
+        const BondRecord& bond = bonds[i];
+        if(bond.types[0] >= number_of_strings || bond.types[1] >= number_of_strings || bond.dscr >= number_of_strings ||
+                !IsInTable(bond.hbond_coefficient_first, bond.hbond_coefficient_count, tables[kHbondCoefficientTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt bond table in bundle file " + path_);
+    }
+    const AngleRecord* angles = this->GetTable<AngleRecord>(source, kAngleTable);
+    for(uint64_t i = 0; i < tables[kAngleTable].count; i++)
+    {
+        const AngleRecord& angle = angles[i];
+        if(angle.types[0] >= number_of_strings || angle.types[1] >= number_of_strings || angle.types[2] >= number_of_strings ||
+                angle.dscr >= number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt angle table in bundle file " + path_);
+    }
+    const DihedralTermRecord* terms = this->GetTable<DihedralTermRecord>(source, kDihedralTermTable);
+    for(uint64_t i = 0; i < tables[kDihedralTermTable].count; i++)
+    {
+        if(terms[i].dscr >= number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt dihedral term table in bundle file " + path_);
+    }
+    const DihedralRecord* dihedrals = this->GetTable<DihedralRecord>(source, kDihedralTable);
+    for(uint64_t i = 0; i < tables[kDihedralTable].count; i++)
+    {
+        const DihedralRecord& dihedral = dihedrals[i];
+        if(dihedral.types[0] >= number_of_strings || dihedral.types[1] >= number_of_strings || dihedral.types[2] >= number_of_strings ||
+                dihedral.types[3] >= number_of_strings || !IsInTable(dihedral.term_first, dihedral.term_count, tables[kDihedralTermTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt dihedral table in bundle file " + path_);
+    }
+
+    /// A slot holds the index of its record + 1, FindRecord reads the atom types of that record
+    int record_tables[4] = { kAtomTypeTable, kBondTable, kAngleTable, kDihedralTable };
+    for(int j = kAtomTypeHashTable; j <= kDihedralHashTable; j++)
+    {
+        const uint32_t* slots = this->GetTable<uint32_t>(source, j);
+        for(uint64_t i = 0; i < tables[j].count; i++)
+        {
+            if(slots[i] > tables[record_tables[j - kAtomTypeHashTable]].count)
+                throw ForceFieldBundleProcessingException(__LINE__, "Corrupt hash table in bundle file " + path_);
+        }
+    }
+}
+
+void ForceFieldBundle::ValidateLibrarySource(const SourceRecord& source, uint64_t number_of_strings) const
+{
+    const Table* tables = source.tables;
+    const LibraryAtomRecord* atoms = this->GetTable<LibraryAtomRecord>(source, kLibraryAtomTable);
+    for(uint64_t i = 0; i < tables[kLibraryAtomTable].count; i++)
+    {
+        const LibraryAtomRecord& atom = atoms[i];
+        if(atom.type >= number_of_strings || atom.name >= number_of_strings ||
+                !IsInTable(atom.bonded_atom_first, atom.bonded_atom_count, tables[kLibraryBondedAtomTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt library atom table in bundle file " + path_);
+    }
+    const LibraryResidueRecord* residues = this->GetTable<LibraryResidueRecord>(source, kLibraryResidueTable);
+    for(uint64_t i = 0; i < tables[kLibraryResidueTable].count; i++)
+    {
+        if(residues[i].name >= number_of_strings || !IsInTable(residues[i].atom_first, residues[i].atom_count, tables[kLibraryAtomTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt library residue table in bundle file " + path_);
+    }
+}
+
+void ForceFieldBundle::ValidatePrepSource(const SourceRecord& source, uint64_t number_of_strings) const
+{
+    const Table* tables = source.tables;
+    const PrepAtomRecord* atoms = this->GetTable<PrepAtomRecord>(source, kPrepAtomTable);
+    for(uint64_t i = 0; i < tables[kPrepAtomTable].count; i++)
+    {
+        if(atoms[i].name >= number_of_strings || atoms[i].type >= number_of_strings)
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt prep atom table in bundle file " + path_);
+    }
+    const uint32_t* impropers = this->GetTable<uint32_t>(source, kPrepImproperTable);
+    const PrepResidueRecord* residues = this->GetTable<PrepResidueRecord>(source, kPrepResidueTable);
+    for(uint64_t i = 0; i < tables[kPrepResidueTable].count; i++)
+    {
+        const PrepResidueRecord& residue = residues[i];
+        if(residue.title >= number_of_strings || residue.name >= number_of_strings || residue.dummy_atom_type >= number_of_strings ||
+                !IsInTable(residue.atom_first, residue.atom_count, tables[kPrepAtomTable].count) ||
+                !IsInTable(residue.improper_first, residue.improper_count, tables[kPrepImproperTable].count) ||
+                !IsInTable(residue.loop_first, residue.loop_count, tables[kPrepLoopTable].count))
+            throw ForceFieldBundleProcessingException(__LINE__, "Corrupt prep residue table in bundle file " + path_);
+        /// Each improper dihedral is its number of atoms followed by the atom names, and has to end within the range of the residue
+        uint64_t end = (uint64_t)residue.improper_first + residue.improper_count;
+        for(uint64_t j = residue.improper_first; j < end; j += (uint64_t)impropers[j] + 1)
+        {
+            if(impropers[j] >= end - j)
+                throw ForceFieldBundleProcessingException(__LINE__, "Corrupt prep improper table in bundle file " + path_);
+            for(uint64_t k = 1; k <= impropers[j]; k++)
+            {
+                if(impropers[j + k] >= number_of_strings)
+                    throw ForceFieldBundleProcessingException(__LINE__, "Corrupt prep improper table in bundle file " + path_);
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "../../../includes/common.hpp"
+#include "../../../includes/utils.hpp"
+#include "../../../includes/ParameterSet/ForceFieldBundleSpace/forcefieldbundleprocessingexception.hpp"
+
+using namespace gmml;
+using namespace ForceFieldBundleSpace;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+ForceFieldBundleProcessingException::ForceFieldBundleProcessingException(const std::string &message)
+    : line_number_(dNotSet), message_(message) {}
+
+ForceFieldBundleProcessingException::ForceFieldBundleProcessingException(int line_number, const std::string &message)
+    : line_number_(line_number), message_(message) {}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+/// Exception handler for force field bundle exceptions
+const char* ForceFieldBundleProcessingException::what() const throw()
+{
+    what_ = "ForceFieldBundle: " + message_;
+    if (line_number_ != dNotSet)
+    {
+        std::stringstream ss;
+        if(ss << line_number_)
+        {
+            what_ += " (line " + ss.str() + ")";
+            gmml::log(__LINE__, __FILE__, gmml::ERR, what_.c_str());
+            return what_.c_str();
+        }
+        else
+        {
+            gmml::log(__LINE__, __FILE__, gmml::ERR, "to_string: invalid conversion");
+            throw std::invalid_argument("to_string: invalid conversion");       /// Invalid conversion from int to string
+        }
+    }
+    gmml::log(__LINE__, __FILE__, gmml::ERR, what_.c_str());
+    return what_.c_str();
+}
+
+ForceFieldBundleProcessingException::~ForceFieldBundleProcessingException() throw() {}
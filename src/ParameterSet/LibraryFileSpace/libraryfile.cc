@@ -3,6 +3,7 @@
 #include <iomanip>
 
 #include "utils.hpp"
+#include "inputfilestream.hpp"
 #include "common.hpp"
 #include "../../../includes/ParameterSet/LibraryFileSpace/libraryfile.hpp"
 #include "../../../includes/ParameterSet/LibraryFileSpace/libraryfileatom.hpp"
@@ -17,23 +18,34 @@ using namespace GeometryTopology;
 //////////////////////////////////////////////////////////
 //                       Constructor                    //
 //////////////////////////////////////////////////////////
-LibraryFile::LibraryFile() : path_("GMML-Generated"){}
+LibraryFile::LibraryFile() : path_("GMML-Generated")
+{
+    pthread_mutex_init(&mutex_, NULL);
+}
 
 LibraryFile::LibraryFile(const std::string &lib_file)
 {
+    pthread_mutex_init(&mutex_, NULL);
     path_ = lib_file;
-    std::ifstream in_file;
+    gmml::InputFileStream in_file;
     if(std::ifstream(lib_file.c_str()))
         in_file.open(lib_file.c_str());
     else
     {
         throw LibraryFileProcessingException(__LINE__, "Library file not found");
     }
-    Read(in_file);
+    /// A compressed file can only be positioned by inflating it from the start, so its residues are parsed right away
+    if(in_file.IsCompressed())
+        Read(in_file);
+    else
+        IndexResidueSections(in_file);
     in_file.close();            /// Close the parameter files
 }
 
-LibraryFile::~LibraryFile(){}
+LibraryFile::~LibraryFile()
+{
+    pthread_mutex_destroy(&mutex_);
+}
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -44,14 +56,23 @@ const std::string& LibraryFile::GetFilePath() const
 }
 
 /// Return a map of residues including in the file mapped to the names of the residues
-const LibraryFile::ResidueMap& LibraryFile::GetResidues() const
+const LibraryFile::ResidueMap& LibraryFile::GetResidues()
 {
+    pthread_mutex_lock(&mutex_);
+    LoadPendingResidues();
+    pthread_mutex_unlock(&mutex_);
     return residues_;
 }
+
+gmml::MemoryArena* LibraryFile::GetArena()
+{
+    return &arena_;
+}
 vector<string> LibraryFile::GetAllResidueNames()
 {
     vector<string> residue_names;
-    for(LibraryFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
+    ResidueNameMap residue_names_map = GetAllResidueNamesMap();
+    for(ResidueNameMap::iterator it = residue_names_map.begin(); it != residue_names_map.end(); it++)
     {
         string residue_name = (*it).first;
         residue_names.push_back(residue_name);
@@ -62,19 +83,28 @@ vector<string> LibraryFile::GetAllResidueNames()
 ResidueNameMap LibraryFile::GetAllResidueNamesMap()
 {
     ResidueNameMap residue_names = ResidueNameMap();
+    pthread_mutex_lock(&mutex_);
     for(LibraryFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
         string residue_name = (*it).first;
         residue_names[residue_name] = residue_name;
     }
+    /// Names of the residues that have not been parsed yet come from the index
+    for(map<string, streampos>::iterator it = pending_residues_.begin(); it != pending_residues_.end(); it++)
+    {
+        string residue_name = (*it).first;
+        residue_names[residue_name] = residue_name;
+    }
+    pthread_mutex_unlock(&mutex_);
     return residue_names;
 }
 
 vector<string> LibraryFile::GetAllAtomNamesOfResidue(string residue_name)
 {
     vector<string> atom_names_of_residue;
-    ResidueMap residue_map = GetResidues();
-    LibraryFileResidue* library_file_residue = residue_map[residue_name];
+    LibraryFileResidue* library_file_residue = GetLibraryResidueByResidueName(residue_name);
+    if(library_file_residue == NULL)
+        return atom_names_of_residue;
     LibraryFileResidue::AtomMap atoms = library_file_residue->GetAtoms();
     for(LibraryFileResidue::AtomMap::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -95,6 +125,7 @@ void LibraryFile::SetPath(string path)
 void LibraryFile::SetResidues(ResidueMap residues)
 {
     residues_.clear();
+    pending_residues_.clear();
     for(ResidueMap::iterator it = residues.begin(); it != residues.end(); it++)
     {
         LibraryFileResidue* residue = (*it).second;
@@ -107,8 +138,9 @@ void LibraryFile::SetResidues(ResidueMap residues)
 //                         FUNCTIONS                    //
 //////////////////////////////////////////////////////////
 /// Read the given file and extract all required fileds into the library file data structure
-void LibraryFile::Read(std::ifstream& in_file)
+void LibraryFile::Read(std::istream& in_file)
 {
+    gmml::MemoryArenaScope arena_scope(&arena_);
     string line;
 
     /// Unable to read file
@@ -145,371 +177,360 @@ void LibraryFile::Read(std::ifstream& in_file)
     /// Iterate on all residues indicated in the index section of the file
     for(LibraryFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
-        /// Process the atom section of the file for the corresponding residue
-        if(line.find("atoms") != string::npos)
+        pending_residues_.erase(it->first);
+        if(!ProcessResidueSections(in_file, line, it->second))
+            return;
+    }
+}
+
+bool LibraryFile::ProcessResidueSections(istream& in_file, string& line, LibraryFileResidue* residue)
+{
+    /// Process the atom section of the file for the corresponding residue
+    if(line.find("atoms") != string::npos)
+    {
+        int order = 0;
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            int order = 0;
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process atom section
-                    order++;
-                    LibraryFileAtom* newAtom = ProcessAtom(line);
-                    newAtom->SetAtomOrder(order);;
-                    it->second->AddAtom(newAtom);               /// Add the atom into the list of atoms of the corresponding residue
-
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing atom section");
-                }
+                /// Process atom section
+                order++;
+                LibraryFileAtom* newAtom = ProcessAtom(line);
+                newAtom->SetAtomOrder(order);;
+                residue->AddAtom(newAtom);               /// Add the atom into the list of atoms of the corresponding residue
+
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing atom section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the atompertinfo section of the file for the corresponding residue
-        if(line.find("atomspertinfo") != string::npos)
+    /// Process the atompertinfo section of the file for the corresponding residue
+    if(line.find("atomspertinfo") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process atompertinfo section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing atom pert info section");
-                }
+                /// Process atompertinfo section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing atom pert info section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
-        /// Process the boundbox section of the file for the corresponding residue
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
+    /// Process the boundbox section of the file for the corresponding residue
 
-        if(line.find("boundbox") != string::npos)
+    if(line.find("boundbox") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
+                /// Process boundbox section
+                double is_box_set = ParseValue<double>(line);
+                if(is_box_set < 0)              /// If the number written in the first line of the section is negative then boundbox attributes have not been defined in the file
                 {
-                    /// Process boundbox section
-                    double is_box_set;
-                    istringstream ss(line);
-                    ss >> is_box_set;
-                    if(is_box_set < 0)              /// If the number written in the first line of the section is negative then boundbox attributes have not been defined in the file
-                    {
-                        getline(in_file, line);
-                        it->second->SetBoxAngle(dNotSet);
-                        getline(in_file, line);
-                        it->second->SetBoxLength(dNotSet);
-                        getline(in_file, line);
-                        it->second->SetBoxWidth(dNotSet);
-                        getline(in_file, line);
-                        it->second->SetBoxHeight(dNotSet);
-                    }
-                    else                        /// If the number written in the first line of the section is positive then set the attributes of the boundbox section
-                    {
-                        getline(in_file, line);
-                        double val;
-
-                        ss.str(line);
-                        ss >> val;
-                        it->second->SetBoxAngle(val);
-                        getline(in_file, line);
-
-                        ss.str(line);
-                        ss >> val;
-                        it->second->SetBoxLength(val);
-                        getline(in_file, line);
-
-                        ss.str(line);
-                        ss >> val;
-                        it->second->SetBoxWidth(val);
-                        getline(in_file, line);
-
-                        ss.str(line);
-                        ss >> val;
-                        it->second->SetBoxHeight(val);
-                    }
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
+                    getline(in_file, line);
+                    residue->SetBoxAngle(dNotSet);
+                    getline(in_file, line);
+                    residue->SetBoxLength(dNotSet);
+                    getline(in_file, line);
+                    residue->SetBoxWidth(dNotSet);
+                    getline(in_file, line);
+                    residue->SetBoxHeight(dNotSet);
+                }
+                else                        /// If the number written in the first line of the section is positive then set the attributes of the boundbox section
                 {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing bound box section");
+                    getline(in_file, line);
+                    residue->SetBoxAngle(ParseValue<double>(line));
+                    getline(in_file, line);
+                    residue->SetBoxLength(ParseValue<double>(line));
+                    getline(in_file, line);
+                    residue->SetBoxWidth(ParseValue<double>(line));
+                    getline(in_file, line);
+                    residue->SetBoxHeight(ParseValue<double>(line));
                 }
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing bound box section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the childsequence section of the file for the corresponding residue
-        if(line.find("childsequence") != string::npos)
+    /// Process the childsequence section of the file for the corresponding residue
+    if(line.find("childsequence") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process childsequence section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing child sequence section");
-                }
+                /// Process childsequence section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing child sequence section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the connect section of the file for the corresponding residue
-        if(line.find("connect") != string::npos)
+    /// Process the connect section of the file for the corresponding residue
+    if(line.find("connect") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process connect section
-                    int head_index;
-                    istringstream ss(line);
-                    ss >> head_index;
-                    getline(in_file,line);
+                /// Process connect section
+                int head_index = ParseValue<int>(line);
+                getline(in_file,line);
 
-                    int tail_index;
-                    istringstream sss(line);
-                    sss >> tail_index;
-                    getline(in_file,line);
+                int tail_index = ParseValue<int>(line);
+                getline(in_file,line);
 
-                    it->second->SetHeadAtomIndex(head_index);
-                    it->second->SetTailAtomIndex(tail_index);
+                residue->SetHeadAtomIndex(head_index);
+                residue->SetTailAtomIndex(tail_index);
 
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing connect section");
-                }
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing connect section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the connectivity section of the file for the corresponding residue
-        if(line.find("connectivity") != string::npos)
+    /// Process the connectivity section of the file for the corresponding residue
+    if(line.find("connectivity") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process connectivity section
-                    istringstream ss(line);
-                    int from;
-                    int to;
-                    int t_int;
-                    ss >> from >> to >> t_int;
-                    it -> second -> GetAtomByIndex(from)->AddBondedAtomIndex(to);
-                    it -> second -> GetAtomByIndex(to)->AddBondedAtomIndex(from);
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing connectivity section");
-                }
+                /// Process connectivity section
+                LineScanner ss(line);
+                int from;
+                int to;
+                int t_int;
+                ss >> from >> to >> t_int;
+                residue->GetAtomByIndex(from)->AddBondedAtomIndex(to);
+                residue->GetAtomByIndex(to)->AddBondedAtomIndex(from);
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing connectivity section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the hierarchy section of the file for the corresponding residue
-        if(line.find("hierarchy") != string::npos)
+    /// Process the hierarchy section of the file for the corresponding residue
+    if(line.find("hierarchy") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process hierarchy section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing hierarchy section");
-                }
+                /// Process hierarchy section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing hierarchy section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the name section of the file for the corresponding residue
-        if(line.find("name") != string::npos)
+    /// Process the name section of the file for the corresponding residue
+    if(line.find("name") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process name section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing name section");
-                }
+                /// Process name section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing name section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the positions section of the file for the corresponding residue
-        if(line.find("positions") != string::npos)
+    /// Process the positions section of the file for the corresponding residue
+    if(line.find("positions") != string::npos)
+    {
+        int order = 0;
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            int order = 0;
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process positions section
-                    order ++;
-                    istringstream ss(line);
-                    double x, y, z;
-                    ss >> x >> y >> z;
-                    Coordinate crd(x, y, z);
-                    it->second->GetAtomByOrder(order)->SetCoordinate(crd);
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing positions section");
-                }
+                /// Process positions section
+                order ++;
+                LineScanner ss(line);
+                double x, y, z;
+                ss >> x >> y >> z;
+                Coordinate crd(x, y, z);
+                residue->GetAtomByOrder(order)->SetCoordinate(crd);
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing positions section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the residueconnect section of the file for the corresponding residue
-        if(line.find("residueconnect") != string::npos)
+    /// Process the residueconnect section of the file for the corresponding residue
+    if(line.find("residueconnect") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process residueconnect section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing residue connect section");
-                }
+                /// Process residueconnect section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing residue connect section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the residues section of the file for the corresponding residue
-        if(line.find("residues") != string::npos)
+    /// Process the residues section of the file for the corresponding residue
+    if(line.find("residues") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process residues section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing residues section");
-                }
+                /// Process residues section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing residues section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the residuesPdbSequenceNumber section of the file for the corresponding residue
-        if(line.find("residuesPdbSequenceNumber") != string::npos)
+    /// Process the residuesPdbSequenceNumber section of the file for the corresponding residue
+    if(line.find("residuesPdbSequenceNumber") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process residuesPdbSequenceNumber section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing residuePdbSequenceNumber section");
-                }
+                /// Process residuesPdbSequenceNumber section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing residuePdbSequenceNumber section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the solventcap section of the file for the corresponding residue
-        if(line.find("solventcap") != string::npos)
+    /// Process the solventcap section of the file for the corresponding residue
+    if(line.find("solventcap") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process solventcap section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    getline(in_file,line);      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing solventcap section");
-                }
+                /// Process solventcap section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                getline(in_file,line);      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing solventcap section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
+    }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
 
-        /// Process the velocities section of the file for the corresponding residue
-        if(line.find("velocities") != string::npos)
+    /// Process the velocities section of the file for the corresponding residue
+    if(line.find("velocities") != string::npos)
+    {
+        getline(in_file, line);                 /// Get the first line of the section
+        while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
         {
-            getline(in_file, line);                 /// Get the first line of the section
-            while(line[0] != '!')                   /// Iterate until to the next section that indicates by ! at the begining of the read line
+            try
             {
-                try
-                {
-                    /// Process velocities section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
-                    if(!getline(in_file,line))
-                        return;      /// Read the next line
-                } catch(...)
-                {
-                    throw LibraryFileProcessingException(__LINE__, "Error processing velocities section");
-                }
+                /// Process velocities section -> This section doesn't have any useful information -> Ignore the section by reading the file until the next section
+                if(!getline(in_file,line))
+                    return false;      /// Read the next line
+            } catch(...)
+            {
+                throw LibraryFileProcessingException(__LINE__, "Error processing velocities section");
             }
         }
-//        else
-//        {
-//            throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
-//        }
     }
+//    else
+//    {
+//        throw LibraryFileProcessingException(__LINE__, "Unknown section or missing section");
+//    }
+    return true;
 }
 
 /// Process a line from the atom section of the file and return a new atom object
@@ -523,7 +544,7 @@ LibraryFileAtom* LibraryFile::ProcessAtom(string &line)
     double charge;
     int int_t;
 
-    istringstream ss(line);             /// Create a stream from the given line
+    LineScanner ss(line);               /// Scan the fields of the given line
     ss >> name >> type >> int_t >> residue_index >> int_t >> atom_index >> atomic_number >> charge;     /// Split the line by space to extract attributes of the atom
 
     RemoveQuotes(name);
@@ -535,15 +556,110 @@ LibraryFileAtom* LibraryFile::ProcessAtom(string &line)
 
 LibraryFileResidue* LibraryFile::GetLibraryResidueByResidueName(string residue_name)
 {
-    ResidueMap residue_map = this->GetResidues();
-    for(ResidueMap::iterator it = residue_map.begin(); it != residue_map.end(); it++)
+    pthread_mutex_lock(&mutex_);
+    if(!residue_name.empty())
+        LoadPendingResidues(residue_name);
+    ResidueMap::iterator residue_search = residues_.find(residue_name);
+    LibraryFileResidue* residue = (residue_search != residues_.end()) ? residue_search->second : NULL;
+    pthread_mutex_unlock(&mutex_);
+    return residue;
+}
+
+void LibraryFile::IndexResidueSections(istream& in_file)
+{
+    string line;
+
+    /// Unable to read file
+    if (!getline(in_file, line))
     {
-        string name = (*it).first;
-        LibraryFileResidue* residue = (*it).second;
-        if(name.compare(residue_name) == 0)
-            return residue;
+        throw LibraryFileProcessingException("Error reading file");
+    }
+
+    /// Skip blank lines at the begining of the file
+    while(line[0] != '!')
+    {
+        getline(in_file, line);
+    }
+
+    if(line.find("index") != string::npos)
+    {
+        getline(in_file, line);
+        while(line[0] != '!')
+        {
+            /// Residues of the index section; a residue without sections in the file stays empty
+            RemoveQuotes(line);
+            RemoveSpaces(line);
+            pending_residues_[line] = streampos(-1);
+            getline(in_file,line);      /// Read the next line
+        }
+    }
+
+    /// The sections of a residue start at its first line of the form !entry.<residue name>.unit.<section name>
+    const string entry_prefix = "!entry.";
+    streampos line_start = in_file.tellg() - streamoff(line.size() + 1);
+    do
+    {
+        if(line.compare(0, entry_prefix.size(), entry_prefix) == 0)
+        {
+            size_t name_end = line.find(".unit.", entry_prefix.size());
+            if(name_end != string::npos)
+            {
+                string residue_name = line.substr(entry_prefix.size(), name_end - entry_prefix.size());
+                map<string, streampos>::iterator residue_search = pending_residues_.find(residue_name);
+                if(residue_search != pending_residues_.end() && residue_search->second == streampos(-1))
+                    residue_search->second = line_start;
+            }
+        }
+        line_start += streamoff(line.size() + 1);
+    }
+    while(getline(in_file, line));
+}
+
+void LibraryFile::LoadPendingResidues(const string& residue_name)
+{
+    map<string, streampos>::iterator first = pending_residues_.begin();
+    map<string, streampos>::iterator last = pending_residues_.end();
+    if(!residue_name.empty())
+    {
+        first = pending_residues_.find(residue_name);
+        if(first == pending_residues_.end())
+            return;
+        last = first;
+        last++;
+    }
+    if(first == last)
+        return;
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    gmml::InputFileStream in_file(path_);
+    if(!in_file)
+    {
+        pthread_mutex_unlock(&mutex_);
+        throw LibraryFileProcessingException(__LINE__, "Library file not found");
+    }
+    try
+    {
+        for(map<string, streampos>::iterator it = first; it != last; it++)
+        {
+            string name = (*it).first;
+            LibraryFileResidue* residue = new LibraryFileResidue(name);
+            if((*it).second != streampos(-1))
+            {
+                string line;
+                in_file.clear();
+                in_file.seekg((*it).second);
+                getline(in_file, line);
+                ProcessResidueSections(in_file, line, residue);
+            }
+            residues_[name] = residue;
+        }
+    }
+    catch(...)
+    {
+        pthread_mutex_unlock(&mutex_);
+        throw;
     }
-    return NULL;
+    pending_residues_.erase(first, last);
+    in_file.close();
 }
 void LibraryFile::Write(const string& library_file)
 {
@@ -567,6 +683,7 @@ void LibraryFile::Write(const string& library_file)
 }
 void LibraryFile::BuildLibraryFile(ofstream& out_stream)
 {
+    GetResidues();
     out_stream << "!!index array str" << endl;
     for(ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
@@ -716,6 +833,7 @@ void LibraryFile::ResolveVelocitiesSection(ofstream& stream, LibraryFileResidue*
 //////////////////////////////////////////////////////////
 void LibraryFile::Print(std::ostream& out)
 {
+    GetResidues();
     for(LibraryFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
         //        for(unsigned int i = 0; i < it -> second -> GetAtoms().size(); i++)
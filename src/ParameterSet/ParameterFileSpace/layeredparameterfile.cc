@@ -0,0 +1,139 @@
+#include <algorithm>
+
+#include "../../../includes/common.hpp"
+#include "../../../includes/instrumentation.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/layeredparameterfile.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfile.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfileatom.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfilebond.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfileangle.hpp"
+#include "../../../includes/ParameterSet/ParameterFileSpace/parameterfiledihedral.hpp"
+
+using namespace std;
+using namespace gmml;
+using namespace ParameterFileSpace;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+LayeredParameterFile::LayeredParameterFile(ParameterFile* base_parameter_file) : parent_(NULL)
+{
+    this->AddLayer(base_parameter_file);
+}
+
+LayeredParameterFile::LayeredParameterFile(const LayeredParameterFile* parent) : parent_(parent) {}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+const LayeredParameterFile* LayeredParameterFile::GetParent() const
+{
+    return parent_;
+}
+
+const vector<ParameterFile*>& LayeredParameterFile::GetLayers() const
+{
+    return layers_;
+}
+
+ParameterFileAtom* LayeredParameterFile::GetAtomType(const string& type) const
+{
+    AtomTypeIndex::const_iterator it = atom_types_.find(type);
+    if(it != atom_types_.end())
+        return it->second;
+    return (parent_ == NULL) ? NULL : parent_->GetAtomType(type);
+}
+
+ParameterFileAtom* LayeredParameterFile::GetNonbondedAtomType(const string& type) const
+{
+    AtomTypeIndex::const_iterator it = nonbonded_atom_types_.find(type);
+    if(it != nonbonded_atom_types_.end())
+        return it->second;
+    return (parent_ == NULL) ? NULL : parent_->GetNonbondedAtomType(type);
+}
+
+ParameterFileBond* LayeredParameterFile::GetBond(const vector<string>& types) const
+{
+    BondIndex::const_iterator it = bonds_.find(CreateKey(types, true));
+    if(it != bonds_.end())
+        return it->second;
+    return (parent_ == NULL) ? NULL : parent_->GetBond(types);
+}
+
+ParameterFileAngle* LayeredParameterFile::GetAngle(const vector<string>& types) const
+{
+    AngleIndex::const_iterator it = angles_.find(CreateKey(types, true));
+    if(it != angles_.end())
+        return it->second;
+    return (parent_ == NULL) ? NULL : parent_->GetAngle(types);
+}
+
+ParameterFileDihedral* LayeredParameterFile::GetDihedral(const vector<string>& types, bool is_improper) const
+{
+    DihedralIndex::const_iterator it = dihedrals_.find(CreateKey(types, !is_improper, (is_improper) ? "I" : "P"));
+    if(it != dihedrals_.end())
+        return it->second;
+    return (parent_ == NULL) ? NULL : parent_->GetDihedral(types, is_improper);
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void LayeredParameterFile::AddLayer(ParameterFile* parameter_file)
+{
+    GMML_SCOPED_TIMER("LayeredParameterFile::AddLayer");
+    layers_.push_back(parameter_file);
+    /// Only the entries of the new layer are indexed; they replace whatever the layers below have for the same atom types
+    const ParameterFile::AtomTypeMap& atom_types = parameter_file->GetAtomTypes();
+    for(ParameterFile::AtomTypeMap::const_iterator it = atom_types.begin(); it != atom_types.end(); it++)
+    {
+        ParameterFileAtom* atom = it->second;
+        if(atom == NULL)
+            continue;
+        if(atom->GetMass() != dNotSet)
+            atom_types_[it->first] = atom;
+        if(atom->GetRadius() != dNotSet)
+            nonbonded_atom_types_[it->first] = atom;
+    }
+    const ParameterFile::BondMap& bonds = parameter_file->GetBonds();
+    for(ParameterFile::BondMap::const_iterator it = bonds.begin(); it != bonds.end(); it++)
+    {
+        if(it->second != NULL)
+            bonds_[CreateKey(it->first, true)] = it->second;
+    }
+    const ParameterFile::AngleMap& angles = parameter_file->GetAngles();
+    for(ParameterFile::AngleMap::const_iterator it = angles.begin(); it != angles.end(); it++)
+    {
+        if(it->second != NULL)
+            angles_[CreateKey(it->first, true)] = it->second;
+    }
+    const ParameterFile::DihedralMap& dihedrals = parameter_file->GetDihedrals();
+    for(ParameterFile::DihedralMap::const_iterator it = dihedrals.begin(); it != dihedrals.end(); it++)
+    {
+        ParameterFileDihedral* dihedral = it->second;
+        if(dihedral == NULL)
+            continue;
+        bool is_improper = dihedral->GetIsImproper();
+        dihedrals_[CreateKey(it->first, !is_improper, (is_improper) ? "I" : "P")] = dihedral;
+    }
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+string LayeredParameterFile::CreateKey(const vector<string>& types, bool either_direction, const char* prefix)
+{
+    string key = prefix;
+    bool reverse = either_direction && lexicographical_compare(types.rbegin(), types.rend(), types.begin(), types.end());
+    if(reverse)
+    {
+        for(vector<string>::const_reverse_iterator it = types.rbegin(); it != types.rend(); it++)
+            key += " " + *it;
+    }
+    else
+    {
+        for(vector<string>::const_iterator it = types.begin(); it != types.end(); it++)
+            key += " " + *it;
+    }
+    return key;
+}
@@ -3,6 +3,8 @@
 #include <iomanip>
 
 #include "../../../includes/utils.hpp"
+#include "../../../includes/inputfilestream.hpp"
+#include "../../../includes/instrumentation.hpp"
 #include "../../../includes/common.hpp"
 #include "../../../includes/ParameterSet/ParameterFileSpace/parameterfile.hpp"
 #include "../../../includes/ParameterSet/ParameterFileSpace/parameterfileatom.hpp"
@@ -21,15 +23,18 @@ using namespace ParameterFileSpace;
 //////////////////////////////////////////////////////////
 ParameterFile::ParameterFile(std::string param_file, int file_type)
 {
+    GMML_SCOPED_TIMER("ParameterFile::ParameterFile");
+    GMML_COUNT("parameter files read", 1);
     path_ = param_file;
     file_type_ = file_type;
-    std::ifstream in_file;
+    gmml::InputFileStream in_file;
     if(std::ifstream(param_file.c_str()))
         in_file.open(param_file.c_str());
     else
     {
         throw ParameterFileProcessingException(__LINE__, "Parameter file not found");
     }
+    gmml::MemoryArenaScope arena_scope(&arena_);
     switch(file_type_)
     {
         case MAIN:
@@ -46,6 +51,13 @@ ParameterFile::ParameterFile(std::string param_file, int file_type)
 
 }
 
+ParameterFile::ParameterFile(int file_type)
+{
+    path_ = "";
+    title_ = "";
+    file_type_ = file_type;
+}
+
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -99,6 +111,10 @@ ParameterFile::DihedralMap ParameterFile::GetAllproperDihedrals()
     }
     return proper_dihedral_map;
 }
+gmml::MemoryArena* ParameterFile::GetArena()
+{
+    return &arena_;
+}
 
 //////////////////////////////////////////////////////////
 //                         MUTATOR                      //
@@ -107,6 +123,30 @@ void ParameterFile::SetParameterFileType(int file_type)
 {
     file_type_ = file_type;
 }
+void ParameterFile::SetPath(const string& path)
+{
+    path_ = path;
+}
+void ParameterFile::SetTitle(const string& title)
+{
+    title_ = title;
+}
+void ParameterFile::SetAtomTypes(const AtomTypeMap& atom_types)
+{
+    atom_types_ = atom_types;
+}
+void ParameterFile::SetBonds(const BondMap& bonds)
+{
+    bonds_ = bonds;
+}
+void ParameterFile::SetAngles(const AngleMap& angles)
+{
+    angles_ = angles;
+}
+void ParameterFile::SetDihedrals(const DihedralMap& dihedrals)
+{
+    dihedrals_ = dihedrals;
+}
 
 //////////////////////////////////////////////////////////
 //                         FUNCTIONS                    //
@@ -114,7 +154,7 @@ void ParameterFile::SetParameterFileType(int file_type)
 /// Read from the given stream and extract into the parameter file data structure
 /// This function reads the stream line-by-line and uses the whole structure of the file to point to the right position for data extraction
 /// For more information check a sample parameter file to find out how the function works
-void ParameterFile::ReadMainParameter(std::ifstream& in_file)
+void ParameterFile::ReadMainParameter(std::istream& in_file)
 {
     string line;
     int line_number = 0;
@@ -276,7 +316,7 @@ void ParameterFile::ReadMainParameter(std::ifstream& in_file)
     }
 }
 
-void ParameterFile::ReadModifiedParameter(std::ifstream& in_file)
+void ParameterFile::ReadModifiedParameter(std::istream& in_file)
 {
     string line;
     int line_number = 0;
@@ -418,7 +458,7 @@ void ParameterFile::ReadModifiedParameter(std::ifstream& in_file)
     }
 }
 
-void ParameterFile::ReadIonicModifiedParameter(std::ifstream& in_file)
+void ParameterFile::ReadIonicModifiedParameter(std::istream& in_file)
 {
     string line;
     int line_number = 0;
@@ -479,22 +519,22 @@ void ParameterFile::ReadIonicModifiedParameter(std::ifstream& in_file)
 /// Process the atom type lines of the parameter file
 void ParameterFile::ProcessAtomType(const std::string& line)
 {
-    double mass, polarizability;
+    double mass = 0, polarizability = 0;
     string type, dscr;
 
-    istringstream in(line);
+    LineScanner in(line);
     switch(this->file_type_)
     {
         case MAIN:
         case MODIFIED:
-            in >> std::setw(2) >> type                          /// Extract type from the line
-               >> std::setw(10) >> mass                         /// Extract mass from the line
-               >> std::setw(10) >> polarizability;              /// Extract polarizability from the line
+            in.Word(type, 2)                                    /// Extract type from the line
+              .Float(mass)                                      /// Extract mass from the line
+              .Float(polarizability);                           /// Extract polarizability from the line
             break;
         case IONICMOD:
-            in >> std::setw(3) >> type                          /// Extract type from the line
-               >> std::setw(10) >> mass                         /// Extract mass from the line
-               >> std::setw(10) >> polarizability;              /// Extract polarizability from the line
+            in.Word(type, 3)                                    /// Extract type from the line
+              .Float(mass)                                      /// Extract mass from the line
+              .Float(polarizability);                           /// Extract polarizability from the line
             break;
     }
 
@@ -512,8 +552,8 @@ void ParameterFile::ProcessAtomType(const std::string& line)
 void ParameterFile::ProcessHydrophilicAtomType(const std::string& line)
 {
     string type;
-    istringstream in(line);             /// Create an stream from the read line
-    while (in >> std::setw(4) >> type && !Trim(type).empty())         /// Iterate on the tokens in the read line
+    LineScanner in(line);               /// Scan the tokens of the read line
+    while (!in.Word(type, 4).Fail() && !Trim(type).empty())          /// Iterate on the tokens in the read line
     {
         if(distance(atom_types_.begin(), atom_types_.find(type)) >= 0)         /// Check for the existing atom type in the map
         {
@@ -530,13 +570,13 @@ void ParameterFile::ProcessBond(const std::string& line)
     string dscr;
     double force_constant, length;
 
-    istringstream in(line);                 /// Create an stream from the read bond line
-    in >> std::setw(2) >> types[0] >> c
-       >> std::setw(2) >> types[1];         /// Tokenize the bond atom types by '-'
-    in >> std::setw(10) >> force_constant
+    LineScanner in(line);                   /// Scan the read bond line
+    in.Word(types[0], 2).Char(c)
+      .Word(types[1], 2);                   /// Tokenize the bond atom types by '-'
+    in >> force_constant
        >> length;                           /// Tokenize the rest of the line into the corresponding variables
 
-    if (in.fail())                  /// Invalid template of the read line
+    if (in.Fail())                  /// Invalid template of the read line
         throw std::exception();
     if (line.size() > 26)           /// Line has description
         dscr = line.substr(26);
@@ -554,14 +594,14 @@ void ParameterFile::ProcessAngle(const std::string& line)
     string dscr;
     double force_constant, angle;
 
-    istringstream in(line);                 /// Create an stream from the read bond line
-    in >> std::setw(2) >> types[0] >> c
-       >> std::setw(2) >> types[1] >> c
-       >> std::setw(2) >> types[2];         /// Tokenize the angle atom types by '-'
-    in >> std::setw(10) >> force_constant
-       >> std::setw(10) >> angle;           /// Tokenize the rest of the line into the corresponding variables
+    LineScanner in(line);                   /// Scan the read angle line
+    in.Word(types[0], 2).Char(c)
+      .Word(types[1], 2).Char(c)
+      .Word(types[2], 2);                   /// Tokenize the angle atom types by '-'
+    in >> force_constant
+       >> angle;                            /// Tokenize the rest of the line into the corresponding variables
 
-    if (in.fail())                          /// Invalid template of the read line
+    if (in.Fail())                          /// Invalid template of the read line
         throw std::exception();
     if (line.size() > 29)                   /// Line has description
         dscr = line.substr(29);
@@ -572,7 +612,7 @@ void ParameterFile::ProcessAngle(const std::string& line)
 }
 
 /// Process the dihedral lines of the parameter file
-void ParameterFile::ProcessDihedral(string &line, int &line_number, std::ifstream &in_file)
+void ParameterFile::ProcessDihedral(string &line, int &line_number, std::istream &in_file)
 {
     char c;
     vector<string> types(4);
@@ -582,22 +622,22 @@ void ParameterFile::ProcessDihedral(string &line, int &line_number, std::ifstrea
     double scee, scnb, temp_force_constant, temp_phase, temp_periodicity;
     int temp_factor;
 
-    istringstream in(line);                 /// Create an stream from the read bond line
-    in >> std::setw(2) >> types[0] >> c
-       >> std::setw(2) >> types[1] >> c
-       >> std::setw(2) >> types[2] >> c
-       >> std::setw(2) >> types[3];         /// Tokenize the angle atom types by '-'
-    in >> std::setw(4) >> temp_factor
-       >> std::setw(15) >> temp_force_constant
-       >> std::setw(15) >> temp_phase
-       >> std::setw(15) >> temp_periodicity;  /// Tokenize the rest of the line into the corresponding variables
+    LineScanner in(line);                   /// Scan the read dihedral line
+    in.Word(types[0], 2).Char(c)
+      .Word(types[1], 2).Char(c)
+      .Word(types[2], 2).Char(c)
+      .Word(types[3], 2);                   /// Tokenize the dihedral atom types by '-'
+    in >> temp_factor
+       >> temp_force_constant
+       >> temp_phase
+       >> temp_periodicity;                 /// Tokenize the rest of the line into the corresponding variables
 
     t.SetFactor(temp_factor);
     t.SetForceConstant(temp_force_constant);
     t.SetPhase(temp_phase);
     t.SetPeriodicity(temp_periodicity);
 
-    if (in.fail())
+    if (in.Fail())
         throw std::exception();
 
     if (line.size() > 60)                   /// Line has description
@@ -619,18 +659,18 @@ void ParameterFile::ProcessDihedral(string &line, int &line_number, std::ifstrea
         line_number++;                              /// Increment the line counter
         ParameterFileDihedralTerm new_term;
 
-        istringstream in2(line.substr(11));         /// Skip the first column of the line which is the same dihedral atom types
-        in2 >> std::setw(4) >> temp_factor
-            >> std::setw(15) >> temp_force_constant
-            >> std::setw(15) >> temp_phase
-            >> std::setw(15) >> temp_periodicity;      /// Tokenize the rest of the line into the corresponding variables
+        LineScanner in2(Column(line, 11, string::npos));    /// Skip the first column of the line which is the same dihedral atom types
+        in2 >> temp_factor
+            >> temp_force_constant
+            >> temp_phase
+            >> temp_periodicity;                    /// Tokenize the rest of the line into the corresponding variables
 
         new_term.SetFactor(temp_factor);
         new_term.SetForceConstant(temp_force_constant);
         new_term.SetPhase(temp_phase);
         new_term.SetPeriodicity(temp_periodicity);
 
-        if (in2.fail())                             /// Ivalid entry
+        if (in2.Fail())                             /// Ivalid entry
         {
             throw ParameterFileProcessingException(line_number, "Error processing dihedral term");
         }
@@ -670,7 +710,7 @@ void ParameterFile::ProcessDihedral(string &line, int &line_number, std::ifstrea
 }
 
 /// Process the improper dihedral lines of the parameter file
-void ParameterFile::ProcessImproperDihedral(string &line, int &line_number, std::ifstream &in_file)
+void ParameterFile::ProcessImproperDihedral(string &line, int &line_number, std::istream &in_file)
 {
     char c;
     vector<string> types(4);
@@ -679,20 +719,20 @@ void ParameterFile::ProcessImproperDihedral(string &line, int &line_number, std:
     string dscr;
     double scee, scnb, temp_force_constant, temp_phase, temp_periodicity;
 
-    istringstream in(line);                     /// Create an stream from the read bond line
-    in >> std::setw(2) >> types[0] >> c
-       >> std::setw(2) >> types[1] >> c
-       >> std::setw(2) >> types[2] >> c
-       >> std::setw(2) >> types[3];             /// Tokenize the angle atom types by '-'
-    in >> std::setw(15) >> temp_force_constant
-       >> std::setw(15) >> temp_phase
-       >> std::setw(15) >> temp_periodicity;      /// Tokenize the rest of the line into the corresponding variables
+    LineScanner in(line);                       /// Scan the read improper dihedral line
+    in.Word(types[0], 2).Char(c)
+      .Word(types[1], 2).Char(c)
+      .Word(types[2], 2).Char(c)
+      .Word(types[3], 2);                       /// Tokenize the dihedral atom types by '-'
+    in >> temp_force_constant
+       >> temp_phase
+       >> temp_periodicity;                     /// Tokenize the rest of the line into the corresponding variables
 
     t.SetForceConstant(temp_force_constant);
     t.SetPhase(temp_phase);
     t.SetPeriodicity(temp_periodicity);
 
-    if (in.fail())                              /// Invalid entry
+    if (in.Fail())                              /// Invalid entry
         throw std::exception();
 
     t.SetFactor(iNotSet);                        /// Improper dihedral doesn't have factor
@@ -716,16 +756,16 @@ void ParameterFile::ProcessImproperDihedral(string &line, int &line_number, std:
         line_number++;                              /// Increment the line counter
         ParameterFileDihedralTerm new_term;
 
-        istringstream in2(line.substr(11));             /// Skip the first column of the line which is the same dihedral atom types
-        in2 >> std::setw(15) >> temp_force_constant
-            >> std::setw(15) >> temp_phase
-            >> std::setw(15) >> temp_periodicity;  /// Tokenize the rest of the line into the corresponding variables
+        LineScanner in2(Column(line, 11, string::npos));    /// Skip the first column of the line which is the same dihedral atom types
+        in2 >> temp_force_constant
+            >> temp_phase
+            >> temp_periodicity;                    /// Tokenize the rest of the line into the corresponding variables
 
         new_term.SetForceConstant(temp_force_constant);
         new_term.SetPhase(temp_phase);
         new_term.SetPeriodicity(temp_periodicity);
 
-        if (in2.fail())
+        if (in2.Fail())
         {
             throw ParameterFileProcessingException(line_number, "Error processing dihedral term");
         }
@@ -766,11 +806,11 @@ void ParameterFile::ProcessHydrogenBond(const std::string& line)
     vector<double> coefficients(2);
     string dscr;
 
-    istringstream in(line);                         /// Create an stream from the read bond line
+    LineScanner in(line);                           /// Scan the read hydrogen-bond line
     in >> types[0] >> types[1]
        >> coefficients[0] >> coefficients[1];       /// Tokenize the read line to the types and coefficients
 
-    if (in.fail())                                  /// Invalid entry
+    if (in.Fail())                                  /// Invalid entry
         throw std::exception();
 
     if (line.size() > 58)                           /// Line has description
@@ -815,10 +855,10 @@ void ParameterFile::ProcessEquivalentSymbols(const std::string& line)
 
     /// New style: Create an equivalent list for all atoms in the line
     string type;
-    istringstream in(line);         /// Create an stream from the read line
+    LineScanner in(line);           /// Scan the tokens of the read line
     vector<string> types;
 
-    while (in >> std::setw(4) >> type && !Trim(type).empty())     /// Read until the end of the line
+    while (!in.Word(type, 4).Fail() && !Trim(type).empty())      /// Read until the end of the line
     {
         types.push_back(type);;     /// Add the read atom type into the temporary atom list
     }
@@ -840,10 +880,10 @@ void ParameterFile::ProcessPotentialParameter(const std::string& line)
     string type, dscr;
     double radius, depth;
 
-    istringstream in(line);             /// Create an stream from the read line
+    LineScanner in(line);               /// Scan the read line
     in >> type >> radius >> depth;      /// Tokenize the read line into the type, radius and well depth
 
-    if (in.fail())                      /// Invalid entry
+    if (in.Fail())                      /// Invalid entry
         throw std::exception();
 
     if (line.size() > 38)               /// Line has description
@@ -890,9 +930,7 @@ double ParameterFile::ProcessDoubleDihedralDescription(const std::string& dscr,
     size_t pos = dscr.find(string(key + "="));      /// Find the starting position of the value of the given key in the given description
     if (pos == string::npos)                        /// Key is not found
         return dNotSet;
-    std::istringstream ss(dscr.substr(pos + key.size() + 1));
-    ss >> val;                                      /// Extract the value of the key from the found position
-    if (ss.fail())
+    if (!ParseFloat(Column(dscr, pos + key.size() + 1, string::npos), val))    /// Extract the value of the key from the found position
         return dNotSet;
     return val;
 }
@@ -1,9 +1,11 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 #include "../../../includes/common.hpp"
 #include "../../../includes/utils.hpp"
+#include "../../../includes/inputfilestream.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfile.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfileprocessingexception.hpp"
@@ -18,20 +20,26 @@ using namespace PrepFileSpace;
 //////////////////////////////////////////////////////////
 PrepFile::PrepFile(const std::string& prep_file)
 {
+    pthread_mutex_init(&mutex_, NULL);
     path_ = prep_file;
-    std::ifstream in_file;
+    gmml::InputFileStream in_file;
     if(std::ifstream(prep_file.c_str()))
         in_file.open(prep_file.c_str());
     else
     {
         throw PrepFileProcessingException(__LINE__, "Prep file not found");
     }
-    Read(in_file);
+    /// A compressed file can only be positioned by inflating it from the start, so its residues are parsed right away
+    if(in_file.IsCompressed())
+        Read(in_file);
+    else
+        IndexResidueSections(in_file);
     in_file.close();            /// Close the prep files
 }
 
 PrepFile::PrepFile()
 {
+    pthread_mutex_init(&mutex_, NULL);
     path_ = "";
     residues_ = ResidueMap();
 }
@@ -40,40 +48,63 @@ PrepFile::~PrepFile()
 {
     residues_.clear();
     residues_ = ResidueMap();
+    pthread_mutex_destroy(&mutex_);
 }
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
+const string& PrepFile::GetFilePath() const
+{
+    return path_;
+}
+
 PrepFile::ResidueMap& PrepFile::GetResidues()
 {
+    pthread_mutex_lock(&mutex_);
+    LoadPendingResidues();
+    pthread_mutex_unlock(&mutex_);
     return residues_;
 }
 
 vector<string> PrepFile::GetAllResidueNames()
 {    
     vector<string> residue_names;
-    for(PrepFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++){
+    ResidueNameMap residue_names_map = GetAllResidueNamesMap();
+    for(ResidueNameMap::iterator it = residue_names_map.begin(); it != residue_names_map.end(); it++){
         string residue_name = (*it).first;
         residue_names.push_back(residue_name);
     }
     return residue_names;
 }
 
+gmml::MemoryArena* PrepFile::GetArena()
+{
+    return &arena_;
+}
+
 ResidueNameMap PrepFile::GetAllResidueNamesMap()
 {
     ResidueNameMap residue_names = ResidueNameMap();
+    pthread_mutex_lock(&mutex_);
     for(PrepFile::ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++){
         string residue_name = (*it).first;
         residue_names[residue_name] = residue_name;
     }
+    /// Names of the residues that have not been parsed yet come from the index
+    for(map<string, streampos>::iterator it = pending_residues_.begin(); it != pending_residues_.end(); it++){
+        string residue_name = (*it).first;
+        residue_names[residue_name] = residue_name;
+    }
+    pthread_mutex_unlock(&mutex_);
     return residue_names;
 }
 
 vector<string> PrepFile::GetAllAtomNamesOfResidue(string residue_name)
 {
     vector<string> atom_names_of_residue;
-    ResidueMap residue_map = GetResidues();
-    PrepFileResidue* prep_file_residue = residue_map[residue_name];
+    PrepFileResidue* prep_file_residue = GetPrepResidueByResidueName(residue_name);
+    if(prep_file_residue == NULL)
+        return atom_names_of_residue;
     vector<PrepFileAtom*> atoms = prep_file_residue->GetAtoms();
     for(vector<PrepFileAtom*>::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -94,6 +125,7 @@ void PrepFile::SetPath(string path)
 void PrepFile::SetResidues(ResidueMap residues)
 {
     residues_.clear();
+    pending_residues_.clear();
     for(ResidueMap::iterator it = residues.begin(); it != residues.end(); it++)
     {
         PrepFileResidue* residue = (*it).second;
@@ -105,8 +137,9 @@ void PrepFile::SetResidues(ResidueMap residues)
 //////////////////////////////////////////////////////////
 //                         FUNCTIONS                    //
 //////////////////////////////////////////////////////////
-void PrepFile::Read(ifstream &in_file)
+void PrepFile::Read(istream &in_file)
 {
+    gmml::MemoryArenaScope arena_scope(&arena_);
     string header1, header2;
     getline(in_file, header1);
     getline(in_file, header2);
@@ -115,16 +148,93 @@ void PrepFile::Read(ifstream &in_file)
     while (residue != NULL)
     {
         residues_[residue->name_] = residue;
+        pending_residues_.erase(residue->name_);
         residue = ProcessResidueSection(in_file);        
     }
 }
 
-PrepFileResidue* PrepFile::ProcessResidueSection(ifstream &in_file)
+PrepFileResidue* PrepFile::ProcessResidueSection(istream &in_file)
 {
     PrepFileResidue* residue = new PrepFileResidue();
     residue = residue->LoadFromStream(in_file);
     return residue;
 }
+
+PrepFileResidue* PrepFile::GetPrepResidueByResidueName(string residue_name)
+{
+    pthread_mutex_lock(&mutex_);
+    if(!residue_name.empty())
+        LoadPendingResidues(residue_name);
+    ResidueMap::iterator residue_search = residues_.find(residue_name);
+    PrepFileResidue* residue = (residue_search != residues_.end()) ? residue_search->second : NULL;
+    pthread_mutex_unlock(&mutex_);
+    return residue;
+}
+
+void PrepFile::IndexResidueSections(istream &in_file)
+{
+    string line;
+    getline(in_file, line);
+    getline(in_file, line);
+    while(in_file)
+    {
+        /// A residue section starts with its title line; the name is the first column of its 3rd line
+        streampos section_start = in_file.tellg();
+        if(!getline(in_file, line) || Trim(line).find("STOP") != string::npos)
+            break;
+        getline(in_file, line);
+        getline(in_file, line);
+        istringstream ss(line);
+        string residue_name;
+        ss >> residue_name;
+        pending_residues_[residue_name] = section_start;
+        /// Skip the rest of the section
+        while(getline(in_file, line) && Trim(line).compare("DONE") != 0)
+        {
+        }
+    }
+}
+
+void PrepFile::LoadPendingResidues(const string& residue_name)
+{
+    map<string, streampos>::iterator first = pending_residues_.begin();
+    map<string, streampos>::iterator last = pending_residues_.end();
+    if(!residue_name.empty())
+    {
+        first = pending_residues_.find(residue_name);
+        if(first == pending_residues_.end())
+            return;
+        last = first;
+        last++;
+    }
+    if(first == last)
+        return;
+    gmml::MemoryArenaScope arena_scope(&arena_);
+    gmml::InputFileStream in_file(path_);
+    if(!in_file)
+    {
+        pthread_mutex_unlock(&mutex_);
+        throw PrepFileProcessingException(__LINE__, "Prep file not found");
+    }
+    try
+    {
+        for(map<string, streampos>::iterator it = first; it != last; it++)
+        {
+            in_file.clear();
+            in_file.seekg((*it).second);
+            PrepFileResidue* residue = ProcessResidueSection(in_file);
+            if(residue != NULL)
+                residues_[(*it).first] = residue;
+        }
+    }
+    catch(...)
+    {
+        pthread_mutex_unlock(&mutex_);
+        throw;
+    }
+    pending_residues_.erase(first, last);
+    in_file.close();
+}
 void PrepFile::Write(const string& prep_file)
 {
     std::ofstream out_file;
@@ -147,6 +257,7 @@ void PrepFile::Write(const string& prep_file)
 }
 void PrepFile::BuildPrepFile(ofstream &stream)
 {
+    GetResidues();
     stream << endl
            << endl;
     for(ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
@@ -213,6 +324,7 @@ void PrepFile::BuildPrepFile(ofstream &stream)
 //////////////////////////////////////////////////////////
 void PrepFile::Print(std::ostream& out)
 {
+    GetResidues();
     for(ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
         out << "**********************************************************************************" << endl;
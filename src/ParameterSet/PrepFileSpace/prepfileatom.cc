@@ -2,6 +2,7 @@
 #include <iomanip>
 
 #include "../../../includes/common.hpp"
+#include "../../../includes/textparsing.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
 
 using namespace std;
@@ -12,22 +13,24 @@ using namespace PrepFileSpace;
 //                       Constructor                    //
 //////////////////////////////////////////////////////////
 PrepFileAtom::PrepFileAtom() : index_(0), name_(""), type_(""), topological_type_(kTopTypeM), bond_index_(0), angle_index_(0), dihedral_index_(0),
-    bond_length_(dNotSet), angle_(dNotSet), dihedral_(dNotSet), charge_(dNotSet) {}
+    bond_length_(dNotSet), angle_(dNotSet), dihedral_(dNotSet), charge_(dNotSet), version_(0) {}
 
 PrepFileAtom::PrepFileAtom(int index, const string& name, const string& type, TopologicalType topological_type, int bond_index, int angle_index, int dihedral_index,
                            double bond_length, double angle, double dihedral, double charge) :
     index_(index), name_(name), type_(type), topological_type_(topological_type), bond_index_(bond_index), angle_index_(angle_index), dihedral_index_(dihedral_index),
-    bond_length_(bond_length), angle_(angle), dihedral_(dihedral), charge_(charge) {}
+    bond_length_(bond_length), angle_(angle), dihedral_(dihedral), charge_(charge), version_(0) {}
 
 /// Create a prep file atom by a formatted line
-PrepFileAtom::PrepFileAtom(std::string& line)
+PrepFileAtom::PrepFileAtom(std::string& line) : version_(0)
 {
-    std::stringstream ss(line);
+    string_view topological_type;
+    LineScanner ss(line);
     ss >> index_
        >> name_
-       >> type_;
+       >> type_
+       >> topological_type;
 
-    topological_type_ = ExtractAtomTopologicalType(ss);
+    topological_type_ = ExtractAtomTopologicalType(topological_type);
 
     ss >> bond_index_
        >> angle_index_
@@ -52,6 +55,12 @@ TopologicalType PrepFileAtom::ExtractAtomTopologicalType(istream &ss)
 {
     string s;
     ss >> s;
+    return ExtractAtomTopologicalType(string_view(s));
+}
+
+/// Convert the topological type column of an atom line to the corresponding enumeration type
+TopologicalType PrepFileAtom::ExtractAtomTopologicalType(string_view s)
+{
     if (s == "M")
         return kTopTypeM;
     else if (s == "S")
@@ -110,6 +119,10 @@ double PrepFileAtom::GetDihedral(){
 double PrepFileAtom::GetCharge(){
     return charge_;
 }
+
+unsigned int PrepFileAtom::GetVersion(){
+    return version_;
+}
 string PrepFileAtom::GetStringFormatOfTopologicalType(TopologicalType topological_type)
 {
     switch(topological_type)
@@ -174,46 +187,57 @@ TopologicalType PrepFileAtom::GetTopologicalTypeFromString(string topological_ty
 
 void PrepFileAtom::SetIndex(int index){
     index_ = index;
+    version_++;
 }
 
 void PrepFileAtom::SetName(const std::string name){
     name_ = name;
+    version_++;
 }
 
 void PrepFileAtom::SetType(const std::string type){
     type_ = type;
+    version_++;
 }
 
 void PrepFileAtom::SetTopologicalType(TopologicalType topological_type){
     topological_type_ = topological_type;
+    version_++;
 }
 
 void PrepFileAtom::SetBondIndex(int bond_index){
     bond_index_ = bond_index;
+    version_++;
 }
 
 void PrepFileAtom::SetAngleIndex(int angle_index){
     angle_index_ = angle_index;
+    version_++;
 }
 
 void PrepFileAtom::SetDihedralIndex(int dihedral_index){
     dihedral_index_ = dihedral_index;
+    version_++;
 }
 
 void PrepFileAtom::SetBondLength(double bond_length){
     bond_length_ = bond_length;
+    version_++;
 }
 
 void PrepFileAtom::SetAngle(double angle){
     angle_ = angle;
+    version_++;
 }
 
 void PrepFileAtom::SetDihedral(double dihedral){
     dihedral_ = dihedral;
+    version_++;
 }
 
 void PrepFileAtom::SetCharge(double charge){
     charge_ = charge;
+    version_++;
 }
 
 //////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
 #include "../../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
+#include "../../../includes/GeometryTopology/coordinate.hpp"
 
 using namespace std;
 using namespace gmml;
@@ -16,7 +17,8 @@ using namespace PrepFileSpace;
 //                       Constructor                    //
 //////////////////////////////////////////////////////////
 PrepFileResidue::PrepFileResidue() : title_(""), name_(""), coordinate_type_(kINT), output_format_(kFormatted), geometry_type_(kGeometryCorrect),
-    dummy_atom_omission_(kOmit), dummy_atom_type_("DU"), dummy_atom_position_(kPositionBeg), charge_(0.0)
+    dummy_atom_omission_(kOmit), dummy_atom_type_("DU"), dummy_atom_position_(kPositionBeg), charge_(0.0),
+    template_head_atom_position_(-1), template_tail_atom_position_(-1), template_is_built_(false), template_atom_version_(0)
 {
     atoms_ = PrepFileAtomVector();
     improper_dihedrals_ = DihedralVector();
@@ -573,6 +575,7 @@ void PrepFileResidue::SetName(const string name){
 
 void PrepFileResidue::SetCoordinateType(CoordinateType coordinate_type){
     coordinate_type_ = coordinate_type;
+    template_is_built_ = false;
 }
 
 void PrepFileResidue::SetOutputFormat(OutputFormat output_format){
@@ -589,6 +592,7 @@ void PrepFileResidue::SetDummyAtomOmission(DummyAtomOmission dummy_atom_omission
 
 void PrepFileResidue::SetDummyAtomType(const string dummy_atom_type){
     dummy_atom_type_ = dummy_atom_type;
+    template_is_built_ = false;
 }
 
 void PrepFileResidue::SetDummyAtomPosition(DummyAtomPosition dummy_atom_position){
@@ -601,6 +605,7 @@ void PrepFileResidue::SetCharge(double charge){
 
 void PrepFileResidue::SetAtoms(PrepFileAtomVector atoms){
     atoms_.clear();
+    template_is_built_ = false;
     for(PrepFileAtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
         atoms_.push_back(*it);
@@ -609,6 +614,7 @@ void PrepFileResidue::SetAtoms(PrepFileAtomVector atoms){
 
 void PrepFileResidue::AddAtom(PrepFileAtom* atom){
     atoms_.push_back(atom);
+    template_is_built_ = false;
 }
 
 void PrepFileResidue::SetImproperDihedrals(DihedralVector improper_dihedrals){
@@ -625,6 +631,7 @@ void PrepFileResidue::AddImproperDihedral(Dihedral improper_dihedral){
 
 void PrepFileResidue::SetLoops(Loop loops){
     loops_ = loops;
+    template_is_built_ = false;
 }
 
 
@@ -632,7 +639,7 @@ void PrepFileResidue::SetLoops(Loop loops){
 //                         FUNCTIONS                    //
 //////////////////////////////////////////////////////////
 /// Create a new residue from a given stream
-PrepFileResidue* PrepFileResidue::LoadFromStream(std::ifstream& in_file)
+PrepFileResidue* PrepFileResidue::LoadFromStream(std::istream& in_file)
 {
     string line, name, dummy_atom_type;
     istringstream ss;
@@ -720,11 +727,11 @@ PrepFileResidue* PrepFileResidue::LoadFromStream(std::ifstream& in_file)
                 done = true;
                 break;
             case kSectionOther:
-                cout << "Unrecognized section in prep file";
                 gmml::log(__LINE__, __FILE__,  gmml::WAR, "Unrecognized section in prep file" );
                 break;
         }
     }
+    residue->BuildTemplate();
 
     return residue;
 }
@@ -805,7 +812,7 @@ SectionType PrepFileResidue::ExtractSectionType(string &line)
 }
 
 /// Parse the loop section of each residue section and return a loop map
-PrepFileResidue::Loop PrepFileResidue::ExtractLoops(ifstream &in_file)
+PrepFileResidue::Loop PrepFileResidue::ExtractLoops(istream &in_file)
 {
     Loop loops;
     string line;
@@ -833,7 +840,7 @@ PrepFileResidue::Loop PrepFileResidue::ExtractLoops(ifstream &in_file)
 }
 
 /// Parse the improper dihedral section of each residue section and return a vector of improper dihedrals
-vector<PrepFileResidue::Dihedral> PrepFileResidue::ExtractImproperDihedral(ifstream &in_file)
+vector<PrepFileResidue::Dihedral> PrepFileResidue::ExtractImproperDihedral(istream &in_file)
 {
     string line;
     std::stringstream ss;
@@ -876,6 +883,134 @@ vector<PrepFileResidue::Dihedral> PrepFileResidue::ExtractImproperDihedral(ifstr
     return residue_charge;
  }
 
+void PrepFileResidue::BuildTemplate()
+{
+    template_coordinates_.clear();
+    template_bonds_ = vector<vector<int> >(atoms_.size(), vector<int>());
+    template_head_atom_position_ = -1;
+    template_tail_atom_position_ = -1;
+
+    template_coordinates_.reserve(atoms_.size());
+    map<int, int> atom_index_position_map = map<int, int>();
+    for(PrepFileAtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
+    {
+        PrepFileAtom* prep_atom = (*it);
+        int index = distance(atoms_.begin(), it);
+        atom_index_position_map[prep_atom->GetIndex()] = index;
+        if(coordinate_type_ == kINT)
+        {
+            /// Only atoms that precede the current one can be used as references; a malformed entry (e.g. an atom bonded to itself)
+            /// is placed with the references that are valid instead of failing the whole file
+            int reference_indices[3] = {prep_atom->GetDihedralIndex(), prep_atom->GetAngleIndex(), prep_atom->GetBondIndex()};
+            GeometryTopology::Vector3Vector reference_positions = GeometryTopology::Vector3Vector();
+            bool valid_references = true;
+            for(int i = 3 - min(index, 3); i < 3; i++)
+            {
+                if(reference_indices[i] >= 1 && reference_indices[i] <= index)
+                    reference_positions.push_back(template_coordinates_.at(reference_indices[i] - 1));
+                else
+                    valid_references = false;
+            }
+            if(!valid_references)
+            {
+                stringstream ss;
+                ss << "Invalid internal coordinate references of atom " << prep_atom->GetName() << " in prep residue " << name_;
+                gmml::log(__LINE__, __FILE__, gmml::WAR, ss.str());
+            }
+            template_coordinates_.push_back(GeometryTopology::ConvertInternalCoordinate2CartesianCoordinate(reference_positions, prep_atom->GetBondLength(),
+                                                                                                            prep_atom->GetAngle(), prep_atom->GetDihedral()));
+        }
+        else
+            template_coordinates_.push_back(GeometryTopology::Vector3(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+
+        if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(dummy_atom_type_) != 0)
+        {
+            if(template_head_atom_position_ == -1 || atoms_.at(template_head_atom_position_)->GetIndex() > prep_atom->GetIndex())
+                template_head_atom_position_ = index;
+            if(template_tail_atom_position_ == -1 || atoms_.at(template_tail_atom_position_)->GetIndex() < prep_atom->GetIndex())
+                template_tail_atom_position_ = index;
+        }
+    }
+
+    BondedAtomIndexMap bonded_atoms_map = this->GetBondingsOfResidue();
+    for(BondedAtomIndexMap::iterator it = bonded_atoms_map.begin(); it != bonded_atoms_map.end(); it++)
+    {
+        if(atom_index_position_map.find((*it).first) == atom_index_position_map.end())
+            continue;
+        int position = atom_index_position_map[(*it).first];
+        for(vector<int>::iterator it1 = (*it).second.begin(); it1 != (*it).second.end(); it1++)
+        {
+            if(atom_index_position_map.find(*it1) != atom_index_position_map.end())
+                template_bonds_.at(position).push_back(atom_index_position_map[*it1]);
+        }
+    }
+    template_atom_version_ = 0;
+    for(PrepFileAtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
+        template_atom_version_ += (*it)->GetVersion();
+    template_is_built_ = true;
+}
+
+bool PrepFileResidue::IsTemplateCurrent()
+{
+    if(!template_is_built_)
+        return false;
+    /// Versions only increase, so any change of an atom changes the sum
+    unsigned long atom_version = 0;
+    for(PrepFileAtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
+        atom_version += (*it)->GetVersion();
+    return atom_version == template_atom_version_;
+}
+
+const vector<GeometryTopology::Vector3>& PrepFileResidue::GetTemplateCoordinates()
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    return template_coordinates_;
+}
+
+const vector<vector<int> >& PrepFileResidue::GetTemplateBonds()
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    return template_bonds_;
+}
+
+int PrepFileResidue::GetTemplateHeadAtomPosition()
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    return template_head_atom_position_;
+}
+
+int PrepFileResidue::GetTemplateTailAtomPosition()
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    return template_tail_atom_position_;
+}
+
+PrepFileResidue::CoordinateVector PrepFileResidue::InstantiateTemplateCoordinates()
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    CoordinateVector coordinates = CoordinateVector();
+    coordinates.reserve(template_coordinates_.size());
+    for(vector<GeometryTopology::Vector3>::iterator it = template_coordinates_.begin(); it != template_coordinates_.end(); it++)
+        coordinates.push_back(new GeometryTopology::Coordinate((*it).ToCoordinate()));
+    return coordinates;
+}
+
+PrepFileResidue::CoordinateVector PrepFileResidue::InstantiateTemplateCoordinates(const GeometryTopology::Matrix3& rotation, const GeometryTopology::Vector3& translation)
+{
+    if(!this->IsTemplateCurrent())
+        this->BuildTemplate();
+    CoordinateVector coordinates = CoordinateVector();
+    coordinates.reserve(template_coordinates_.size());
+    for(vector<GeometryTopology::Vector3>::iterator it = template_coordinates_.begin(); it != template_coordinates_.end(); it++)
+        coordinates.push_back(new GeometryTopology::Coordinate((rotation * (*it) + translation).ToCoordinate()));
+    return coordinates;
+}
+
 //////////////////////////////////////////////////////////
 //                     DISPLAY FUNCTIONS                //
 //////////////////////////////////////////////////////////
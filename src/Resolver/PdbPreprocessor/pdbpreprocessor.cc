@@ -1,5 +1,7 @@
 #include <cctype>
 #include <ctime>
+#include <unordered_map>
+#include <pthread.h>
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessor.hpp"
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessordisulfidebond.hpp"
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessorchaintermination.hpp"
@@ -10,6 +12,7 @@
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessorreplacedhydrogen.hpp"
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessoralternateresidue.hpp"
 #include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessorresidueinfo.hpp"
+#include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessorcontext.hpp"
 #include "../../../includes/InputSet/PdbFileSpace/pdbresidue.hpp"
 #include "../../../includes/InputSet/PdbFileSpace/pdbfile.hpp"
 #include "../../../includes/ParameterSet/LibraryFileSpace/libraryfile.hpp"
@@ -23,6 +26,7 @@
 #include "../../../includes/InputSet/PdbFileSpace/pdbfileprocessingexception.hpp"
 #include "../../../includes/common.hpp"
 #include "../../../includes/utils.hpp"
+#include "../../../includes/instrumentation.hpp"
 using namespace std;
 using namespace PdbPreprocessorSpace;
 using namespace PdbFileSpace;
@@ -226,7 +230,6 @@ vector<string> PdbPreprocessor::GetUnrecognizedResidueNames(PdbFile::PdbPairVect
             }
         }
     }
-    cout << "HIS residue(s) found" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "HIS residue(s) found" );
     return unrecognized_residue_names;
 }
@@ -272,7 +275,6 @@ ResidueNameMap PdbPreprocessor::GetUnrecognizedResidueNamesMap(PdbFile::PdbPairV
             }
         }
     }
-    cout << "HIS residue(s) found" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "HIS residue(s) found" );
     return unrecognized_residue_names;
 }
@@ -319,7 +321,6 @@ vector<string> PdbPreprocessor::GetRecognizedResidueNames(PdbFile::PdbPairVector
             recognized_residue_names.push_back(pdb_residue_name);
         }
     }
-    cout << "HIS residue(s) found" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "HIS residue(s) found" );
     return recognized_residue_names;
 }
@@ -366,7 +367,6 @@ ResidueNameMap PdbPreprocessor::GetRecognizedResidueNamesMap(PdbFile::PdbPairVec
             recognized_residue_names[pdb_residue_name] = pdb_residue_name;
         }
     }
-    cout << "HIS residue(s) found" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "HIS residue(s) found" );
     return recognized_residue_names;
 }
@@ -678,85 +678,18 @@ bool PdbPreprocessor::ExtractUnrecognizedResidues(string pdb_file_path, vector<s
 }
 bool PdbPreprocessor::ExtractUnrecognizedResidues(PdbFile* pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    // Slow version
-//    vector<string> dataset_residue_names = GetAllResidueNamesFromDatasetFiles(lib_files, prep_files);
-    // Advanced version
-    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromDatasetFilesMap(lib_files, prep_files);
-    PdbFile::PdbPairVectorAtomNamePositionFlag pdb_residue_names = pdb_file->GetAllResidueNames();
-    // Slow version
-//    vector<string> unrecognized_residue_names = GetUnrecognizedResidueNames(pdb_residue_names, dataset_residue_names);
-    // Advanced version
-    ResidueNameMap unrecognized_residue_names = GetUnrecognizedResidueNamesMap(pdb_residue_names, dataset_residue_names);
-
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-    PdbFileSpace::PdbFile::PdbResidueVector unrecognized_residues = GetUnrecognizedResidues(pdb_residues, unrecognized_residue_names);
-
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues_atom_card = pdb_file->GetAllResiduesFromAtomCard();
-    PdbPreprocessorChainIdResidueMap all_chain_map_residue;
-    PdbPreprocessor::PdbPreprocessorChainIdSequenceNumbersMap chain_map_sequence_number;
-    PdbPreprocessor::PdbPreprocessorChainIdInsertionCodeMap chain_map_insertion_code;
-
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues_atom_card.begin(); it != pdb_residues_atom_card.end(); it++)
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return ExtractUnrecognizedResidues(&context);
+}
+bool PdbPreprocessor::ExtractUnrecognizedResidues(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractUnrecognizedResidues");
+    const PdbFileSpace::PdbFile::PdbResidueVector& unrecognized_residues = context->GetUnrecognizedResidues();
+    const PdbPreprocessorContext::ChainIdSegmentsMap& chain_segments = context->GetChainSegments();
+    for(PdbPreprocessorContext::ChainIdSegmentsMap::const_iterator it = chain_segments.begin(); it != chain_segments.end(); it++)
     {
-        PdbFileSpace::PdbResidue* residue = *it;
-        char chain_id = residue->GetResidueChainId();
-
-        stringstream ss;
-        ss << chain_id;
-        all_chain_map_residue[ss.str()].push_back(residue);
-    }
-
-    // Slower version
-//        vector<string> amino_lib_residue_names = GetAllResidueNamesFromMultipleLibFiles(lib_files);
-    // Advanced version
-    ResidueNameMap amino_lib_residue_names_map = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
-    PdbPreprocessorChainIdResidueMap chain_map_residue;
-    PdbFileSpace::PdbFile::PdbResidueVector residues;
-    PdbFile::PdbResidueVector pdb_residues_in_chain;
-    for(PdbPreprocessorChainIdResidueMap::iterator it = all_chain_map_residue.begin(); it != all_chain_map_residue.end(); it++)
-    {
-        int internal_amino_acid_chain_counter = 0;
-        chain_map_residue = PdbPreprocessorChainIdResidueMap();
-        string chain_id = (*it).first;
-        residues = (*it).second;
-
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
-        {
-            PdbResidue* residue = (*it1);
-            if(amino_lib_residue_names_map.find(residue->GetResidueName()) != amino_lib_residue_names_map.end())
-            {
-                stringstream ss;
-                ss << "A_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                chain_map_residue[ss.str()].push_back(residue);
-                stringstream sss(chain_id);
-                char c_id;
-                sss >> c_id;
-                chain_map_sequence_number[c_id].push_back(residue->GetResidueSequenceNumber());
-                chain_map_insertion_code[c_id].push_back(residue->GetResidueInsertionCode());
-            }
-            else
-            {
-                stringstream ss;
-                ss << "NA_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                chain_map_residue[ss.str()].push_back(residue);
-                internal_amino_acid_chain_counter++;
-            }
-        }
-
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = unrecognized_residues.begin(); it1 != unrecognized_residues.end(); it1++)
+        const PdbPreprocessorChainIdResidueMap& chain_map_residue = (*it).second;
+        for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it1 = unrecognized_residues.begin(); it1 != unrecognized_residues.end(); it1++)
         {
             PdbResidue* pdb_residue = (*it1);
             PdbPreprocessorUnrecognizedResidue* unrecognized_residue =
@@ -766,12 +699,12 @@ bool PdbPreprocessor::ExtractUnrecognizedResidues(PdbFile* pdb_file, vector<stri
                 unrecognized_residue->SetMiddleOfChain(false);
             else
             {
-                for(PdbPreprocessorChainIdResidueMap::iterator it2 = chain_map_residue.begin(); it2 != chain_map_residue.end(); it2++)
+                for(PdbPreprocessorChainIdResidueMap::const_iterator it2 = chain_map_residue.begin(); it2 != chain_map_residue.end(); it2++)
                 {
                     string key = (*it2).first;
-                    pdb_residues_in_chain = (*it2).second;
+                    const PdbFile::PdbResidueVector& pdb_residues_in_chain = (*it2).second;
                     int dist = distance(chain_map_residue.begin(), it2);
-                    if(key.substr(0, 2).compare("NA") == 0 && dist != 0 && dist != chain_map_residue.size() - 1)
+                    if(key.substr(0, 2).compare("NA") == 0 && dist != 0 && dist != (int)chain_map_residue.size() - 1)
                     {
                         if(find(pdb_residues_in_chain.begin(), pdb_residues_in_chain.end(), pdb_residue) != pdb_residues_in_chain.end())
                         {
@@ -863,32 +796,13 @@ bool PdbPreprocessor::ExtractRecognizedResidues(string pdb_file_path, vector<str
 }
 bool PdbPreprocessor::ExtractRecognizedResidues(PdbFile* pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    // Slow version
-//    vector<string> dataset_residue_names = GetAllResidueNamesFromDatasetFiles(lib_files, prep_files);
-    // Advanced version
-    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromDatasetFilesMap(lib_files, prep_files);
-    PdbFile::PdbPairVectorAtomNamePositionFlag pdb_residue_names = pdb_file->GetAllResidueNames();
-    // Slow version
-//    vector<string> unrecognized_residue_names = GetRecognizedResidueNames(pdb_residue_names, dataset_residue_names);
-    // Advanced version
-    ResidueNameMap unrecognized_residue_names = GetRecognizedResidueNamesMap(pdb_residue_names, dataset_residue_names);
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-    PdbFileSpace::PdbFile::PdbResidueVector recognized_residues = GetRecognizedResidues(pdb_residues, unrecognized_residue_names);
-
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return ExtractRecognizedResidues(&context);
+}
+bool PdbPreprocessor::ExtractRecognizedResidues(PdbPreprocessorContext* context)
+{
+    const PdbFileSpace::PdbFile::PdbResidueVector& recognized_residues = context->GetRecognizedResidues();
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
     {
         PdbResidue* pdb_residue = (*it);
         PdbPreprocessorUnrecognizedResidue* recognized_residue =
@@ -913,7 +827,7 @@ PdbFileSpace::PdbFile::PdbResidueVector PdbPreprocessor::GetAllCYSResidues(PdbFi
     return all_cys_residues;
 }
 
-double PdbPreprocessor::GetDistanceofCYS(PdbResidue* first_residue, PdbResidue* second_residue, PdbFile* pdb_file, PdbFile::PdbResidueAtomsMap residue_atom_map)
+double PdbPreprocessor::GetDistanceofCYS(PdbResidue* first_residue, PdbResidue* second_residue, PdbFile* pdb_file, PdbFile::PdbResidueAtomsMap& residue_atom_map)
 {
     double distance = 0.0;
     PdbAtom* first_residue_sulfur_atom = pdb_file->GetAtomOfResidueByName(first_residue, "SG", residue_atom_map);
@@ -927,59 +841,126 @@ bool PdbPreprocessor::ExtractCYSResidues(string pdb_file_path)
     try
     {
         PdbFile* pdb_file = new PdbFile(pdb_file_path);
-        PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResiduesFromAtomCard();
-        PdbFileSpace::PdbFile::PdbResidueVector cys_residues = GetAllCYSResidues(pdb_residues);
-        PdbFile::PdbResidueAtomsMap residue_atom_map = pdb_file->GetAllAtomsOfResidues();
-
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = cys_residues.begin(); it != cys_residues.end(); it++)
-        {
-            PdbResidue* first_residue = (*it);
-            for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = it+1 ; it1 != cys_residues.end(); it1++)
-            {
-                PdbResidue* second_residue = (*it1);
-                double distance = GetDistanceofCYS(first_residue, second_residue, pdb_file, residue_atom_map);
-                if (distance < dSulfurCutoff)
-                {
-                    PdbPreprocessorDisulfideBond* disulfide_bond =
-                            new PdbPreprocessorDisulfideBond(first_residue->GetResidueChainId(), second_residue->GetResidueChainId(),
-                                                             first_residue->GetResidueSequenceNumber(), second_residue->GetResidueSequenceNumber(),
-                                                             distance, true, first_residue->GetResidueInsertionCode(), second_residue->GetResidueInsertionCode(),
-                                                             first_residue->GetResidueAlternateLocation(), second_residue->GetResidueAlternateLocation() );
-                    disulfide_bonds_.push_back(disulfide_bond);
-                }
-            }
-        }
-        return true;
+        return ExtractCYSResidues(pdb_file);
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
 }
 bool PdbPreprocessor::ExtractCYSResidues(PdbFile* pdb_file)
 {
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResiduesFromAtomCard();
-    PdbFileSpace::PdbFile::PdbResidueVector cys_residues = GetAllCYSResidues(pdb_residues);
-    PdbFile::PdbResidueAtomsMap residue_atom_map = pdb_file->GetAllAtomsOfResidues();
-
+    PdbPreprocessorContext context(pdb_file);
+    return ExtractCYSResidues(&context);
+}
+bool PdbPreprocessor::ExtractCYSResidues(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractCYSResidues");
+    PdbFileSpace::PdbFile::PdbResidueVector cys_residues = GetAllCYSResidues(context->GetResiduesFromAtomCard());
+    /// Only CYS residues with a sulfur atom can be bonded; the sulfur atoms are put in a cell list so only the close pairs are examined
+    PdbFileSpace::PdbFile::PdbResidueVector sulfur_residues = PdbFileSpace::PdbFile::PdbResidueVector();
+    PdbFile::PdbAtomVector sulfur_atoms = PdbFile::PdbAtomVector();
     for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = cys_residues.begin(); it != cys_residues.end(); it++)
     {
-        PdbResidue* first_residue = (*it);
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = it+1 ; it1 != cys_residues.end(); it1++)
+        PdbAtom* sulfur_atom = context->GetAtomOfResidueByName(*it, "SG");
+        if(sulfur_atom != NULL)
         {
-            PdbResidue* second_residue = (*it1);
-            double distance = GetDistanceofCYS(first_residue, second_residue, pdb_file, residue_atom_map);
-            if (distance < dSulfurCutoff)
-            {
-                PdbPreprocessorDisulfideBond* disulfide_bond =
-                        new PdbPreprocessorDisulfideBond(first_residue->GetResidueChainId(), second_residue->GetResidueChainId(),
-                                                         first_residue->GetResidueSequenceNumber(), second_residue->GetResidueSequenceNumber(),
-                                                         distance, true, first_residue->GetResidueInsertionCode(), second_residue->GetResidueInsertionCode(),
-                                                         first_residue->GetResidueAlternateLocation(), second_residue->GetResidueAlternateLocation() );
-                disulfide_bonds_.push_back(disulfide_bond);
-            }
+            sulfur_residues.push_back(*it);
+            sulfur_atoms.push_back(sulfur_atom);
         }
     }
+
+    GeometryTopology::CellList::IndexPairVector pairs = FindAtomPairsWithinCutoff(sulfur_atoms, sulfur_atoms, dSulfurCutoff);
+    for(GeometryTopology::CellList::IndexPairVector::iterator it = pairs.begin(); it != pairs.end(); it++)
+    {
+        PdbResidue* first_residue = sulfur_residues.at((*it).first);
+        PdbResidue* second_residue = sulfur_residues.at((*it).second);
+        double distance = sulfur_atoms.at((*it).first)->GetAtomOrthogonalCoordinate().Distance(sulfur_atoms.at((*it).second)->GetAtomOrthogonalCoordinate());
+        PdbPreprocessorDisulfideBond* disulfide_bond =
+                new PdbPreprocessorDisulfideBond(first_residue->GetResidueChainId(), second_residue->GetResidueChainId(),
+                                                 first_residue->GetResidueSequenceNumber(), second_residue->GetResidueSequenceNumber(),
+                                                 distance, true, first_residue->GetResidueInsertionCode(), second_residue->GetResidueInsertionCode(),
+                                                 first_residue->GetResidueAlternateLocation(), second_residue->GetResidueAlternateLocation() );
+        disulfide_bonds_.push_back(disulfide_bond);
+    }
     return true;
 }
+PdbFileSpace::PdbFile::PdbAtomVector PdbPreprocessor::GetAtomsOfResiduesByName(PdbPreprocessorContext* context, vector<string> residue_names, string atom_name)
+{
+    PdbFile::PdbAtomVector atoms = PdbFile::PdbAtomVector();
+    const PdbFileSpace::PdbFile::PdbResidueVector& pdb_residues = context->GetResiduesFromAtomCard();
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
+    {
+        PdbResidue* residue = (*it);
+        if(!residue_names.empty() && find(residue_names.begin(), residue_names.end(), residue->GetResidueName()) == residue_names.end())
+            continue;
+        PdbAtom* atom = context->GetAtomOfResidueByName(residue, atom_name);
+        if(atom != NULL)
+            atoms.push_back(atom);
+    }
+    return atoms;
+}
+GeometryTopology::CellList::IndexPairVector PdbPreprocessor::FindAtomPairsWithinCutoff(PdbFile::PdbAtomVector& first_atoms, PdbFile::PdbAtomVector& second_atoms, double cutoff)
+{
+    GeometryTopology::CellList::IndexPairVector pairs = GeometryTopology::CellList::IndexPairVector();
+    if(first_atoms.empty() || second_atoms.empty())
+        return pairs;
+    bool same_atoms = (&first_atoms == &second_atoms);
+
+    /// The cell list keeps pointers to the coordinates, so the copies have to stay alive while it is searched
+    vector<GeometryTopology::Coordinate> second_coordinates = vector<GeometryTopology::Coordinate>();
+    second_coordinates.reserve(second_atoms.size());
+    for(PdbFile::PdbAtomVector::iterator it = second_atoms.begin(); it != second_atoms.end(); it++)
+        second_coordinates.push_back((*it)->GetAtomOrthogonalCoordinate());
+    GeometryTopology::CellList::CoordinateVector second_positions = GeometryTopology::CellList::CoordinateVector();
+    for(vector<GeometryTopology::Coordinate>::iterator it = second_coordinates.begin(); it != second_coordinates.end(); it++)
+        second_positions.push_back(&(*it));
+    GeometryTopology::CellList cell_list = GeometryTopology::CellList(second_positions, cutoff);
+
+    for(unsigned int i = 0; i < first_atoms.size(); i++)
+    {
+        GeometryTopology::Coordinate position = first_atoms.at(i)->GetAtomOrthogonalCoordinate();
+        vector<int> neighbors = cell_list.FindNeighbors(&position, cutoff);
+        for(vector<int>::iterator it = neighbors.begin(); it != neighbors.end(); it++)
+        {
+            int j = (*it);
+            if((same_atoms && j <= (int)i) || first_atoms.at(i) == second_atoms.at(j))
+                continue;
+            pairs.push_back(GeometryTopology::CellList::IndexPair(i, j));
+        }
+    }
+    return pairs;
+}
+PdbPreprocessor::PdbPreprocessorAtomPairVector PdbPreprocessor::ExtractCrossLinks(PdbPreprocessorContext* context, vector<string> first_residue_names, string first_atom_name,
+                                                                                  vector<string> second_residue_names, string second_atom_name, double cutoff)
+{
+    PdbPreprocessorAtomPairVector links = PdbPreprocessorAtomPairVector();
+    PdbFile::PdbAtomVector first_atoms = GetAtomsOfResiduesByName(context, first_residue_names, first_atom_name);
+    GeometryTopology::CellList::IndexPairVector pairs;
+    PdbFile::PdbAtomVector second_atoms;
+    if(first_residue_names == second_residue_names && first_atom_name.compare(second_atom_name) == 0)
+    {
+        pairs = FindAtomPairsWithinCutoff(first_atoms, first_atoms, cutoff);
+        second_atoms = first_atoms;
+    }
+    else
+    {
+        second_atoms = GetAtomsOfResiduesByName(context, second_residue_names, second_atom_name);
+        pairs = FindAtomPairsWithinCutoff(first_atoms, second_atoms, cutoff);
+    }
+    for(GeometryTopology::CellList::IndexPairVector::iterator it = pairs.begin(); it != pairs.end(); it++)
+        links.push_back(PdbPreprocessorAtomPair(first_atoms.at((*it).first), second_atoms.at((*it).second)));
+    return links;
+}
+PdbPreprocessor::PdbPreprocessorAtomPairVector PdbPreprocessor::ExtractNGlycosylationLinks(PdbPreprocessorContext* context)
+{
+    return ExtractCrossLinks(context, vector<string>(1, "ASN"), "ND2", vector<string>(), "C1");
+}
+PdbPreprocessor::PdbPreprocessorAtomPairVector PdbPreprocessor::ExtractOGlycosylationLinks(PdbPreprocessorContext* context)
+{
+    PdbPreprocessorAtomPairVector links = ExtractCrossLinks(context, vector<string>(1, "SER"), "OG", vector<string>(), "C1");
+    PdbPreprocessorAtomPairVector threonine_links = ExtractCrossLinks(context, vector<string>(1, "THR"), "OG1", vector<string>(), "C1");
+    links.insert(links.end(), threonine_links.begin(), threonine_links.end());
+    return links;
+}
 void PdbPreprocessor::UpdateCYSResidues(PdbFile *pdb_file, PdbPreprocessorDisulfideBondVector disulfide_bonds)
 {
     to_be_deleted_atoms_.clear();
@@ -1151,43 +1132,31 @@ bool PdbPreprocessor::ExtractHISResidues(string pdb_file_path)
 }
 bool PdbPreprocessor::ExtractHISResidues(PdbFile* pdb_file)
 {
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResiduesFromAtomCard();
+    PdbPreprocessorContext context(pdb_file);
+    return ExtractHISResidues(&context);
+}
+bool PdbPreprocessor::ExtractHISResidues(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractHISResidues");
+    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = context->GetResiduesFromAtomCard();
     PdbFileSpace::PdbFile::PdbResidueVector his_residues = GetAllHISResidues(pdb_residues);
     for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = his_residues.begin(); it != his_residues.end(); it++)
     {
         PdbResidue* his_residue = (*it);
-
-        // HIE residue
-        if(pdb_file->GetAtomOfResidueByName(his_residue, "HE2") != NULL && pdb_file->GetAtomOfResidueByName(his_residue, "HD1") == NULL)
-        {
-            PdbPreprocessorHistidineMapping* histidine_mapping =
-                    new PdbPreprocessorHistidineMapping(his_residue->GetResidueChainId(), his_residue->GetResidueSequenceNumber(), HIE,
-                                                        his_residue->GetResidueInsertionCode(), his_residue->GetResidueAlternateLocation());
-            histidine_mappings_.push_back(histidine_mapping);
-        }
+        bool has_he2 = context->GetAtomOfResidueByName(his_residue, "HE2") != NULL;
+        bool has_hd1 = context->GetAtomOfResidueByName(his_residue, "HD1") != NULL;
+        // HIE residue, also the default if none of the protons is there
+        PdbPreprocessorHISMapping mapping = HIE;
         // HID residue
-        else if(pdb_file->GetAtomOfResidueByName(his_residue, "HE2") == NULL && pdb_file->GetAtomOfResidueByName(his_residue, "HD1") != NULL)
-        {
-            PdbPreprocessorHistidineMapping* histidine_mapping =
-                    new PdbPreprocessorHistidineMapping(his_residue->GetResidueChainId(), his_residue->GetResidueSequenceNumber(), HID,
-                                                        his_residue->GetResidueInsertionCode(), his_residue->GetResidueAlternateLocation());
-            histidine_mappings_.push_back(histidine_mapping);
-        }
+        if(!has_he2 && has_hd1)
+            mapping = HID;
         // HIP residue
-        else if(pdb_file->GetAtomOfResidueByName(his_residue, "HE2") != NULL && pdb_file->GetAtomOfResidueByName(his_residue, "HD1") != NULL)
-        {
-            PdbPreprocessorHistidineMapping* histidine_mapping =
-                    new PdbPreprocessorHistidineMapping(his_residue->GetResidueChainId(), his_residue->GetResidueSequenceNumber(), HIP,
-                                                        his_residue->GetResidueInsertionCode(), his_residue->GetResidueAlternateLocation());
-            histidine_mappings_.push_back(histidine_mapping);
-        }
-        else if(pdb_file->GetAtomOfResidueByName(his_residue, "HE2") == NULL && pdb_file->GetAtomOfResidueByName(his_residue, "HD1") == NULL)
-        {
-            PdbPreprocessorHistidineMapping* histidine_mapping =
-                    new PdbPreprocessorHistidineMapping(his_residue->GetResidueChainId(), his_residue->GetResidueSequenceNumber(), HIE,
-                                                        his_residue->GetResidueInsertionCode(), his_residue->GetResidueAlternateLocation());
-            histidine_mappings_.push_back(histidine_mapping);
-        }
+        else if(has_he2 && has_hd1)
+            mapping = HIP;
+        PdbPreprocessorHistidineMapping* histidine_mapping =
+                new PdbPreprocessorHistidineMapping(his_residue->GetResidueChainId(), his_residue->GetResidueSequenceNumber(), mapping,
+                                                    his_residue->GetResidueInsertionCode(), his_residue->GetResidueAlternateLocation());
+        histidine_mappings_.push_back(histidine_mapping);
     }
     return true;
 }
@@ -1594,86 +1563,37 @@ bool PdbPreprocessor::ExtractUnknownHeavyAtoms(string pdb_file_path, vector<stri
 }
 bool PdbPreprocessor::ExtractUnknownHeavyAtoms(PdbFile* pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    // Slow version
-//    vector<string> dataset_residue_names = GetAllResidueNamesFromDatasetFiles(lib_files, prep_files);
-    // Advanced version
-    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromDatasetFilesMap(lib_files, prep_files);
-    PdbFile::PdbPairVectorAtomNamePositionFlag pdb_residue_names = pdb_file->GetAllResidueNames();
-    // Slow version
-//    vector<string> recognized_residue_names = GetRecognizedResidueNames(pdb_residue_names, dataset_residue_names);
-    // Advanced version
-    ResidueNameMap recognized_residue_names = GetRecognizedResidueNamesMap(pdb_residue_names, dataset_residue_names);
-
-
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-    PdbFileSpace::PdbFile::PdbResidueVector recognized_residues = GetRecognizedResidues(pdb_residues, recognized_residue_names);
-
-    PdbFile::PdbResidueAtomsMap residue_atom_map = pdb_file->GetAllAtomsOfResidues();
-    ResidueNameAtomNamesMap dataset_residue_atom_map = GetAllAtomNamesOfResidueNamesFromDatasetFiles(lib_files, prep_files);
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return ExtractUnknownHeavyAtoms(&context);
+}
+bool PdbPreprocessor::ExtractUnknownHeavyAtoms(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractUnknownHeavyAtoms");
+    const PdbFileSpace::PdbFile::PdbResidueVector& recognized_residues = context->GetRecognizedResidues();
+    const ResidueNameAtomNamesMap& dataset_residue_atom_map = context->GetDatasetResidueAtomNames();
     vector<string> dataset_atom_names_of_residue = vector<string>();
-    vector<string> dataset_atom_names_of_head_residue = vector<string>();
-    vector<string> dataset_atom_names_of_tail_residue = vector<string>();
     PdbFile::PdbAtomVector unknown_heavy_atoms = PdbFile::PdbAtomVector();
-    PdbFile::PdbAtomVector atoms_of_residue = PdbFile::PdbAtomVector();
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
     {
         PdbFileSpace::PdbResidue* recognized_residue = *it;
         string residue_name = recognized_residue->GetResidueName();
         if(residue_name.compare("HIS") != 0)
         {
-            char chain_id = recognized_residue->GetResidueChainId();
-            int sequence_number = recognized_residue->GetResidueSequenceNumber();
-            char insertion_code = recognized_residue->GetResidueInsertionCode();
-            char alternate_location = recognized_residue->GetResidueAlternateLocation();
+            dataset_atom_names_of_residue = vector<string>();
+            ResidueNameAtomNamesMap::const_iterator dataset_entry = dataset_residue_atom_map.find(residue_name);
+            if(dataset_entry != dataset_residue_atom_map.end())
+                dataset_atom_names_of_residue = (*dataset_entry).second;
 
-            stringstream ss;
-            ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_" << alternate_location;
-            string key = ss.str();
-            atoms_of_residue = *(residue_atom_map[key]);
-            // Slow version
-//            vector<string> dataset_atom_names_of_residue = GetAllAtomNamesOfResidueFromDatasetFiles(residue_name, lib_files, prep_files);
-            // Advanced version
-            dataset_atom_names_of_residue = dataset_residue_atom_map[residue_name];
+            /// Atoms of the N/C terminal variant of the residue are also known at the start/end of a chain
+            ResidueNameAtomNamesMap::const_iterator terminal_entry = dataset_residue_atom_map.end();
+            if(context->HasResidueNameWithFlag(residue_name, "S"))
+                terminal_entry = dataset_residue_atom_map.find("N" + residue_name);
+            else if(context->HasResidueNameWithFlag(residue_name, "E"))
+                terminal_entry = dataset_residue_atom_map.find("C" + residue_name);
+            if(terminal_entry != dataset_residue_atom_map.end())
+                dataset_atom_names_of_residue.insert(dataset_atom_names_of_residue.end(), (*terminal_entry).second.begin(), (*terminal_entry).second.end());
 
-            pair<string, string> residue_sflag_pair = make_pair(residue_name, "S");
-            pair<string, string> residue_eflag_pair = make_pair(residue_name, "E");
-            if(find(pdb_residue_names.begin(), pdb_residue_names.end(), residue_sflag_pair) != pdb_residue_names.end())
-            {
-                stringstream ss1;
-                ss1 << "N" << residue_name;
-                dataset_atom_names_of_head_residue = dataset_residue_atom_map[ss1.str()];
-                for(vector<string>::iterator it1 = dataset_atom_names_of_head_residue.begin(); it1 != dataset_atom_names_of_head_residue.end(); it1++)
-                {
-                    string head_residue = (*it1);
-                    dataset_atom_names_of_residue.push_back(head_residue);
-                }
-            }
-            else if(find(pdb_residue_names.begin(), pdb_residue_names.end(), residue_eflag_pair) != pdb_residue_names.end())
-            {
-                stringstream ss1;
-                ss1 << "C" << residue_name;
-                dataset_atom_names_of_tail_residue = dataset_residue_atom_map[ss1.str()];
-                for(vector<string>::iterator it2 = dataset_atom_names_of_tail_residue.begin(); it2 != dataset_atom_names_of_tail_residue.end(); it2++)
-                {
-                    string head_residue = (*it2);
-                    dataset_atom_names_of_residue.push_back(head_residue);
-                }
-            }
-
-            unknown_heavy_atoms = GetUnknownHeavyAtomsOfResidue(atoms_of_residue, dataset_atom_names_of_residue);
+            unknown_heavy_atoms = GetUnknownHeavyAtomsOfResidue(context->GetAtomsOfResidue(recognized_residue), dataset_atom_names_of_residue);
 
             for(PdbFileSpace::PdbFile::PdbAtomVector::iterator it1 = unknown_heavy_atoms.begin(); it1 != unknown_heavy_atoms.end(); it1++)
             {
@@ -1873,55 +1793,26 @@ bool PdbPreprocessor::ExtractRemovedHydrogens(string pdb_file_path, vector<strin
 }
 bool PdbPreprocessor::ExtractRemovedHydrogens(PdbFile* pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    // Slow version
-//    vector<string> dataset_residue_names = GetAllResidueNamesFromDatasetFiles(lib_files, prep_files);
-    // Advanced version
-    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromDatasetFilesMap(lib_files, prep_files);
-    PdbFile::PdbPairVectorAtomNamePositionFlag pdb_residue_names = pdb_file->GetAllResidueNames();
-    // Slow version
-//    vector<string> recognized_residue_names = GetRecognizedResidueNames(pdb_residue_names, dataset_residue_names);
-    // Advanced version
-    ResidueNameMap recognized_residue_names = GetRecognizedResidueNamesMap(pdb_residue_names, dataset_residue_names);
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-    PdbFileSpace::PdbFile::PdbResidueVector recognized_residues = GetRecognizedResidues(pdb_residues, recognized_residue_names);
-
-    PdbFile::PdbResidueAtomsMap residue_atom_map = pdb_file->GetAllAtomsOfResidues();
-    PdbFile::PdbAtomVector atoms_of_residue;
-    ResidueNameAtomNamesMap dataset_residue_atom_map = GetAllAtomNamesOfResidueNamesFromDatasetFiles(lib_files, prep_files);
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return ExtractRemovedHydrogens(&context);
+}
+bool PdbPreprocessor::ExtractRemovedHydrogens(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractRemovedHydrogens");
+    const PdbFileSpace::PdbFile::PdbResidueVector& recognized_residues = context->GetRecognizedResidues();
+    const ResidueNameAtomNamesMap& dataset_residue_atom_map = context->GetDatasetResidueAtomNames();
     vector<string> dataset_atom_names_of_residue = vector<string>();
     PdbFile::PdbAtomVector removed_hydrogens;
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = recognized_residues.begin(); it != recognized_residues.end(); it++)
     {
         PdbFileSpace::PdbResidue* recognized_residue = *it;
         if(recognized_residue->GetResidueName().compare("HIS") != 0)
         {
-            string residue_name = recognized_residue->GetResidueName();
-            char chain_id = recognized_residue->GetResidueChainId();
-            int sequence_number = recognized_residue->GetResidueSequenceNumber();
-            char insertion_code = recognized_residue->GetResidueInsertionCode();
-            char alternate_location = recognized_residue->GetResidueAlternateLocation();
-            stringstream ss;
-            ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_" << alternate_location;
-            string key = ss.str();
-            atoms_of_residue = *(residue_atom_map[key]);
-            // Slow version
-//            vector<string> dataset_atom_names_of_residue = GetAllAtomNamesOfResidueFromDatasetFiles(residue_name, lib_files, prep_files);
-            // Advanced version
-            dataset_atom_names_of_residue = dataset_residue_atom_map[residue_name];
-            removed_hydrogens = GetRemovedHydrogensOfResidue(atoms_of_residue, dataset_atom_names_of_residue);
+            dataset_atom_names_of_residue = vector<string>();
+            ResidueNameAtomNamesMap::const_iterator dataset_entry = dataset_residue_atom_map.find(recognized_residue->GetResidueName());
+            if(dataset_entry != dataset_residue_atom_map.end())
+                dataset_atom_names_of_residue = (*dataset_entry).second;
+            removed_hydrogens = GetRemovedHydrogensOfResidue(context->GetAtomsOfResidue(recognized_residue), dataset_atom_names_of_residue);
             for(PdbFileSpace::PdbFile::PdbAtomVector::iterator it1 = removed_hydrogens.begin(); it1 != removed_hydrogens.end(); it1++)
             {
                 PdbAtom* removed_hydrogen = (*it1);
@@ -2063,9 +1954,7 @@ bool PdbPreprocessor::ExtractAminoAcidChains(string pdb_file_path, vector<string
             }
             if(chain_map_residue.size() > 2)
             {
-                cout << "There is an undefined protein in the middle of the chain" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is an undefined protein in the middle of the chain" );
-                cout << "Pdb file is not processible at this time" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "Pdb file is not processible at this time" );
 
                 return false;
@@ -2128,89 +2017,50 @@ bool PdbPreprocessor::ExtractAminoAcidChains(PdbFile* pdb_file)
 }
 bool PdbPreprocessor::ExtractAminoAcidChains(PdbFile* pdb_file, vector<string> amino_lib_files)
 {
-    try
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, vector<string>(), vector<string>(), vector<string>());
+    return ExtractAminoAcidChains(&context);
+}
+bool PdbPreprocessor::CheckAminoAcidChainSegments(PdbPreprocessorContext* context)
+{
+    const PdbPreprocessorContext::ChainIdSegmentsMap& chain_segments = context->GetChainSegments();
+    for(PdbPreprocessorContext::ChainIdSegmentsMap::const_iterator it = chain_segments.begin(); it != chain_segments.end(); it++)
     {
-        PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResiduesFromAtomCard();
-
-        PdbPreprocessorChainIdResidueMap all_chain_map_residue;
-        PdbPreprocessor::PdbPreprocessorChainIdSequenceNumbersMap chain_map_sequence_number;
-        PdbPreprocessor::PdbPreprocessorChainIdInsertionCodeMap chain_map_insertion_code;
-
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
+        if((*it).second.size() > 2)
         {
-            PdbFileSpace::PdbResidue* residue = *it;
-            char chain_id = residue->GetResidueChainId();
-
-            stringstream ss;
-            ss << chain_id;
-            all_chain_map_residue[ss.str()].push_back(residue);
-        }
-
-        // Slower version
-//        vector<string> amino_lib_residue_names = GetAllResidueNamesFromMultipleLibFiles(lib_files);
-        // Advanced version
-        ResidueNameMap amino_lib_residue_names_map = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
-
-        for(PdbPreprocessorChainIdResidueMap::iterator it = all_chain_map_residue.begin(); it != all_chain_map_residue.end(); it++)
-        {
-            int internal_amino_acid_chain_counter = 0;
-            PdbPreprocessorChainIdResidueMap chain_map_residue = PdbPreprocessorChainIdResidueMap();
-            string chain_id = (*it).first;
-            PdbFileSpace::PdbFile::PdbResidueVector residues = (*it).second;
-
-            for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
-            {
-                PdbResidue* residue = (*it1);
-                if(amino_lib_residue_names_map.find(residue->GetResidueName()) != amino_lib_residue_names_map.end())
-                {
-                    stringstream ss;
-                    ss << "A_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                    chain_map_residue[ss.str()].push_back(residue);
-                    stringstream sss(chain_id);
-                    char c_id;
-                    sss >> c_id;
-                    chain_map_sequence_number[c_id].push_back(residue->GetResidueSequenceNumber());
-                    chain_map_insertion_code[c_id].push_back(residue->GetResidueInsertionCode());
-                }
-                else
-                {
-                    stringstream ss;
-                    ss << "NA_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                    chain_map_residue[ss.str()].push_back(residue);
-                    internal_amino_acid_chain_counter++;
-                }
-            }
-            if(chain_map_residue.size() > 2)
-            {
-                cout << "There is an undefined protein in the middle of the chain" << endl;
-                gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is an undefined protein in the middle of the chain" );
-                cout << "Pdb file is not processible at this time" << endl;
-                gmml::log(__LINE__, __FILE__,  gmml::ERR, "Pdb file is not processible at this time" );
-
-
-                return false;
-            }
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is an undefined protein in the middle of the chain" );
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "Pdb file is not processible at this time" );
+            return false;
         }
-        for(PdbPreprocessorChainIdSequenceNumbersMap::iterator it = chain_map_sequence_number.begin(); it != chain_map_sequence_number.end(); it++)
-        {
-            char chain_id = (*it).first;
-            vector<int> sequence_numbers = (*it).second;
-            vector<char> insertion_codes = chain_map_insertion_code[chain_id];
-
-            vector<int>::iterator starting_sequence_number_iterator = min_element(sequence_numbers.begin(), sequence_numbers.end());
-            vector<int>::iterator ending_sequence_number_iterator = max_element(sequence_numbers.begin(), sequence_numbers.end());
-            int starting_index = distance(sequence_numbers.begin(), starting_sequence_number_iterator);
-            int ending_index = distance(sequence_numbers.begin(), ending_sequence_number_iterator);
+    }
+    return true;
+}
+PdbPreprocessorChainTermination* PdbPreprocessor::ExtractAminoAcidChain(PdbPreprocessorContext* context, char chain_id)
+{
+    const PdbPreprocessorContext::ChainIdSequenceNumbersMap& chain_map_sequence_number = context->GetChainSequenceNumbers();
+    const PdbPreprocessorContext::ChainIdInsertionCodeMap& chain_map_insertion_code = context->GetChainInsertionCodes();
+    PdbPreprocessorContext::ChainIdSequenceNumbersMap::const_iterator chain_sequence_numbers = chain_map_sequence_number.find(chain_id);
+    if(chain_sequence_numbers == chain_map_sequence_number.end())
+        return NULL;
+    const vector<int>& sequence_numbers = (*chain_sequence_numbers).second;
+    const vector<char>& insertion_codes = (*chain_map_insertion_code.find(chain_id)).second;
 
-            PdbPreprocessorChainTermination* chain = new PdbPreprocessorChainTermination(chain_id, *starting_sequence_number_iterator, *ending_sequence_number_iterator,
-                                                                                         insertion_codes.at(starting_index), insertion_codes.at(ending_index) );
+    vector<int>::const_iterator starting_sequence_number_iterator = min_element(sequence_numbers.begin(), sequence_numbers.end());
+    vector<int>::const_iterator ending_sequence_number_iterator = max_element(sequence_numbers.begin(), sequence_numbers.end());
+    int starting_index = distance(sequence_numbers.begin(), starting_sequence_number_iterator);
+    int ending_index = distance(sequence_numbers.begin(), ending_sequence_number_iterator);
 
-            chain_terminations_.push_back(chain);
-        }
-        return true;
-    }
-    catch(PdbFileSpace::PdbFileProcessingException &ex)
-    {}
+    return new PdbPreprocessorChainTermination(chain_id, *starting_sequence_number_iterator, *ending_sequence_number_iterator,
+                                               insertion_codes.at(starting_index), insertion_codes.at(ending_index) );
+}
+bool PdbPreprocessor::ExtractAminoAcidChains(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractAminoAcidChains");
+    if(!CheckAminoAcidChainSegments(context))
+        return false;
+    const PdbPreprocessorContext::ChainIdSequenceNumbersMap& chain_map_sequence_number = context->GetChainSequenceNumbers();
+    for(PdbPreprocessorContext::ChainIdSequenceNumbersMap::const_iterator it = chain_map_sequence_number.begin(); it != chain_map_sequence_number.end(); it++)
+        chain_terminations_.push_back(ExtractAminoAcidChain(context, (*it).first));
+    return true;
 }
 void PdbPreprocessor::UpdateAminoAcidChains(PdbFile *pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files,
                                             vector<string> prep_files, PdbPreprocessorChainTerminationVector chain_terminations)
@@ -2221,7 +2071,6 @@ void PdbPreprocessor::UpdateAminoAcidChains(PdbFile *pdb_file, vector<string> am
         PdbPreprocessorChainTermination* chain = (*it1);
         pdb_file->SplitAtomCardOfModelCard(chain->GetResidueChainId(), chain->GetEndingResidueSequenceNumber() + 1);
     }
-    cout << "Putting TER card after non-amino acid residues: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Putting TER card after non-amino acid residues: Done" );
     vector<string> glycam_residue_names = this->GetAllResidueNamesFromDatasetFiles(glycam_lib_files, prep_files);
     // Get all TER card positions and split
@@ -2233,7 +2082,6 @@ void PdbPreprocessor::UpdateAminoAcidChains(PdbFile *pdb_file, vector<string> am
         int sequence_number = ter_position.second;
         pdb_file->SplitAtomCardOfModelCard(chain_id, sequence_number);
     }
-    cout << "Putting TER card after residues with no tail or with at least 2 tails: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Putting TER card after residues with no tail or with at least 2 tails: Done" );
 
     // Add Terminals
@@ -2353,7 +2201,6 @@ void PdbPreprocessor::UpdateAminoAcidChains(PdbFile *pdb_file, vector<string> am
             }
         }
     }
-    cout << "Add terminals: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Add terminals: Done" );
 }
 
@@ -2368,7 +2215,6 @@ void PdbPreprocessor::UpdateAminoAcidChainsWithTheGivenModelNumber(PdbFile *pdb_
         pdb_file->SplitAtomCardOfModelCard(chain->GetResidueChainId(), chain->GetEndingResidueSequenceNumber() + 1);
     }
 
-    cout << "Putting TER card after non-amino acid residues: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Putting TER card after non-amino acid residues: Done" );
     vector<string> glycam_residue_names = this->GetAllResidueNamesFromDatasetFiles(glycam_lib_files, prep_files);
     // Get all TER card positions and split
@@ -2381,7 +2227,6 @@ void PdbPreprocessor::UpdateAminoAcidChainsWithTheGivenModelNumber(PdbFile *pdb_
         int sequence_number = ter_position.second;
         pdb_file->SplitAtomCardOfModelCard(chain_id, sequence_number);
     }
-    cout << "Putting TER card after residues with no tail or with at least 2 tails: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Putting TER card after residues with no tail or with at least 2 tails: Done" );
 
     // Add Terminals
@@ -2501,7 +2346,6 @@ void PdbPreprocessor::UpdateAminoAcidChainsWithTheGivenModelNumber(PdbFile *pdb_
             }
         }
     }
-    cout << "Add terminals: Done" << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, "Add terminals: Done" );
 }
 
@@ -2615,9 +2459,7 @@ bool PdbPreprocessor::ExtractGapsInAminoAcidChains(string pdb_file_path, vector<
             }
             if(chain_map_residue.size() > 2)
             {
-                cout << "There is an undefined protein in the middle of the chain" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is an undefined protein in the middle of the chain" );
-                cout << "Pdb file is not processible at this time" << endl;
                 gmml::log(__LINE__, __FILE__,  gmml::ERR, "Pdb file is not processible at this time" );
 
 
@@ -2720,115 +2562,52 @@ bool PdbPreprocessor::ExtractGapsInAminoAcidChains(PdbFile* pdb_file)
 
 bool PdbPreprocessor::ExtractGapsInAminoAcidChains(PdbFile *pdb_file, vector<string> amino_lib_files)
 {
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResiduesFromAtomCard();
-
-    PdbPreprocessorChainIdResidueMap all_chain_map_residue;
-    PdbPreprocessor::PdbPreprocessorChainIdSequenceNumbersMap chain_map_sequence_number;
-    PdbPreprocessor::PdbPreprocessorChainIdInsertionCodeMap chain_map_insertion_code;
-
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
-    {
-        PdbFileSpace::PdbResidue* residue = *it;
-        char chain_id = residue->GetResidueChainId();
-
-        stringstream ss;
-        ss << chain_id;
-        all_chain_map_residue[ss.str()].push_back(residue);
-    }
-
-    // Slower version
-//        vector<string> amino_lib_residue_names = GetAllResidueNamesFromMultipleLibFiles(lib_files);
-    // Advanced version
-    ResidueNameMap amino_lib_residue_names_map = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
-    PdbPreprocessorChainIdResidueMap all_chain_map_amino_acid_residue = PdbPreprocessorChainIdResidueMap();
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, vector<string>(), vector<string>(), vector<string>());
+    return ExtractGapsInAminoAcidChains(&context);
+}
+PdbPreprocessor::PdbPreprocessorMissingResidueVector PdbPreprocessor::ExtractGapsInAminoAcidChain(PdbPreprocessorContext* context, string chain_id)
+{
+    PdbPreprocessorMissingResidueVector missing_residues = PdbPreprocessorMissingResidueVector();
+    const PdbPreprocessorChainIdResidueMap& all_chain_map_amino_acid_residue = context->GetChainAminoAcidResidues();
+    PdbPreprocessorChainIdResidueMap::const_iterator chain_residues = all_chain_map_amino_acid_residue.find(chain_id);
+    if(chain_residues == all_chain_map_amino_acid_residue.end())
+        return missing_residues;
+    char c_id = chain_id[0];
+    const PdbFileSpace::PdbFile::PdbResidueVector& residues = (*chain_residues).second;
+    const vector<int>& sequence_numbers = (*context->GetChainSequenceNumbers().find(c_id)).second;
+    const vector<char>& insertion_codes = (*context->GetChainInsertionCodes().find(c_id)).second;
+    int starting_sequence_number = *min_element(sequence_numbers.begin(), sequence_numbers.end());
+    int ending_sequence_number = *max_element(sequence_numbers.begin(), sequence_numbers.end());
 
-    PdbFileSpace::PdbFile::PdbResidueVector residues;
-    PdbPreprocessorChainIdResidueMap chain_map_residue;
-    for(PdbPreprocessorChainIdResidueMap::iterator it = all_chain_map_residue.begin(); it != all_chain_map_residue.end(); it++)
+    for(unsigned int i = 0; i + 1 < residues.size(); i++)
     {
-        int internal_amino_acid_chain_counter = 0;
-        chain_map_residue = PdbPreprocessorChainIdResidueMap();
-        string chain_id = (*it).first;
-        residues = (*it).second;        
-
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
+        unsigned int j = i + 1;
+        PdbAtom* c_atom_of_residue = context->GetAtomOfResidueByName(residues.at(i), "C");
+        PdbAtom* n_atom_of_next_residue = context->GetAtomOfResidueByName(residues.at(j), "N");
+        double distance = INFINITY;
+        if(c_atom_of_residue != NULL && n_atom_of_next_residue != NULL)
+            distance = c_atom_of_residue->GetAtomOrthogonalCoordinate().Distance(n_atom_of_next_residue->GetAtomOrthogonalCoordinate());
+        if(distance > dCutOff + 1.0)
         {
-            PdbResidue* residue = (*it1);
-            if(amino_lib_residue_names_map.find(residue->GetResidueName()) != amino_lib_residue_names_map.end())
-            {
-                stringstream ss;
-                ss << "A_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                chain_map_residue[ss.str()].push_back(residue);
-                all_chain_map_amino_acid_residue[chain_id].push_back(residue);
-                stringstream sss(chain_id);
-                char c_id;
-                sss >> c_id;
-                chain_map_sequence_number[c_id].push_back(residue->GetResidueSequenceNumber());
-                chain_map_insertion_code[c_id].push_back(residue->GetResidueInsertionCode());
-            }
-            else
-            {
-                stringstream ss;
-                ss << "NA_" << chain_id << "_" << internal_amino_acid_chain_counter;
-                chain_map_residue[ss.str()].push_back(residue);
-                internal_amino_acid_chain_counter++;
-            }
-        }
-        if(chain_map_residue.size() > 2)
-        {
-            cout << "There is an undefined protein in the middle of the chain" << endl;
-            gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is an undefined protein in the middle of the chain" );
-            cout << "Pdb file is not processible at this time" << endl;
-            gmml::log(__LINE__, __FILE__,  gmml::ERR, "Pdb file is not processible at this time" );
-
-            return false;
+            PdbPreprocessorMissingResidue* missing_residue = new PdbPreprocessorMissingResidue(c_id, starting_sequence_number,
+                                                                                               ending_sequence_number, sequence_numbers.at(i),
+                                                                                               sequence_numbers.at(j), insertion_codes.at(i), insertion_codes.at(j));
+            missing_residues.push_back(missing_residue);
         }
     }
-
-
-    PdbFile::PdbResidueAtomsMap residue_atom_map;
-    residue_atom_map = pdb_file->GetAllAtomsOfResidues();
-    for(PdbPreprocessorChainIdResidueMap::iterator it = all_chain_map_amino_acid_residue.begin(); it != all_chain_map_amino_acid_residue.end(); it++)
+    return missing_residues;
+}
+bool PdbPreprocessor::ExtractGapsInAminoAcidChains(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractGapsInAminoAcidChains");
+    if(!CheckAminoAcidChainSegments(context))
+        return false;
+    const PdbPreprocessorChainIdResidueMap& all_chain_map_amino_acid_residue = context->GetChainAminoAcidResidues();
+    for(PdbPreprocessorChainIdResidueMap::const_iterator it = all_chain_map_amino_acid_residue.begin(); it != all_chain_map_amino_acid_residue.end(); it++)
     {
-        string chain_id = (*it).first;
-        PdbFileSpace::PdbFile::PdbResidueVector residues = (*it).second;
-        char c_id;
-        stringstream ss(chain_id);
-        ss >> c_id;
-        vector<int> sequence_numbers = chain_map_sequence_number[c_id];
-        vector<char> insertion_codes = chain_map_insertion_code[c_id];
-        vector<int>::iterator starting_sequence_number_iterator = min_element(sequence_numbers.begin(), sequence_numbers.end());
-        vector<int>::iterator ending_sequence_number_iterator = max_element(sequence_numbers.begin(), sequence_numbers.end());        
-
-        for(PdbFile::PdbResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
-        {
-            int dist = distance(residues.begin(), it1);
-            if(dist != residues.size() - 1)
-            {
-                PdbResidue* residue = (*it1);
-                PdbResidue* next_residue = *(it1 + 1);
-                int i = distance(residues.begin(), it1);
-                int j = distance(residues.begin(), it1 + 1);
-                PdbAtom* c_atom_of_residue = pdb_file->GetAtomOfResidueByName(residue, "C", residue_atom_map);
-                PdbAtom* n_atom_of_next_residue = pdb_file->GetAtomOfResidueByName(next_residue, "N", residue_atom_map);
-                double distance = INFINITY;
-                if(c_atom_of_residue != NULL && n_atom_of_next_residue != NULL)
-                {
-                    GeometryTopology::Coordinate c_atom_coordinate = c_atom_of_residue->GetAtomOrthogonalCoordinate();
-                    GeometryTopology::Coordinate n_atom_coordinate = n_atom_of_next_residue->GetAtomOrthogonalCoordinate();
-                    distance = c_atom_coordinate.Distance(n_atom_coordinate);
-                }
-                if(distance > dCutOff + 1.0)
-                {
-                    PdbPreprocessorMissingResidue* missing_residues = new PdbPreprocessorMissingResidue(c_id, *starting_sequence_number_iterator,
-                                                                                                        *ending_sequence_number_iterator, sequence_numbers.at(i),
-                                                                                                        sequence_numbers.at(j), insertion_codes.at(i), insertion_codes.at(j));
-                    missing_residues_.push_back(missing_residues);
-                }
-            }
-        }
+        PdbPreprocessorMissingResidueVector missing_residues = ExtractGapsInAminoAcidChain(context, (*it).first);
+        missing_residues_.insert(missing_residues_.end(), missing_residues.begin(), missing_residues.end());
     }
-
     return true;
 }
 
@@ -3132,127 +2911,82 @@ bool PdbPreprocessor::ExtractAlternateResidue(string pdb_file_path)
     try
     {
         PdbFile* pdb_file = new PdbFile(pdb_file_path);
-        PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
-        {
-            PdbFileSpace::PdbResidue* target_residue = *it;
-            string target_residue_name = target_residue->GetResidueName();
-            char target_chain_id = target_residue->GetResidueChainId();
-            int target_sequence_number = target_residue->GetResidueSequenceNumber();
-            char target_insertion_code = target_residue->GetResidueInsertionCode();
-            char target_alternate_location = target_residue->GetResidueAlternateLocation();
-            stringstream ss;
-            ss << target_residue_name << "_" << target_chain_id << "_" << target_sequence_number << "_" << target_insertion_code;
-            string target_key = ss.str();
-            for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 =it+1 ; it1 != pdb_residues.end(); it1++)
-            {
-                PdbFileSpace::PdbResidue* residue = *it1;
-                string residue_name = residue->GetResidueName();
-                char chain_id = residue->GetResidueChainId();
-                int sequence_number = residue->GetResidueSequenceNumber();
-                char insertion_code = residue->GetResidueInsertionCode();
-                char alternate_location = residue->GetResidueAlternateLocation();
-                stringstream sss;
-                sss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code;
-                string key = sss.str();
-
-                if(key.compare(target_key) == 0)
-                {
-                    if(target_alternate_location != alternate_location)
-                    {
-                        if (alternate_residue_map_.empty() || distance(alternate_residue_map_.begin() ,alternate_residue_map_.find(key)) < 0 ||
-                                distance(alternate_residue_map_.begin() ,alternate_residue_map_.find(key)) >= (int)alternate_residue_map_.size())
-                        {
-                            vector<bool> selected = vector<bool>();
-                            selected.push_back(true);
-                            selected.push_back(false);
-                            vector<char> alternate_locations = vector<char>();
-                            alternate_locations.push_back(target_alternate_location);
-                            alternate_locations.push_back(alternate_location);
-                            alternate_residue_map_[target_key] = new PdbPreprocessorAlternateResidue(residue_name, chain_id, sequence_number, insertion_code, alternate_locations, selected);
-                        }
-                        else
-                        {
-                            PdbPreprocessorAlternateResidue* alternate_residue = alternate_residue_map_[target_key];
-                            vector<char> alternate_locations = alternate_residue->GetResidueAlternateLocation();
-                            if(distance(alternate_locations.begin(), find(alternate_locations.begin(),alternate_locations.end(),alternate_location)) < 0 ||
-                                    distance(alternate_locations.begin(), find(alternate_locations.begin(),alternate_locations.end(),alternate_location)) >= (int)alternate_locations.size())
-                            {
-
-                                alternate_locations.push_back(alternate_location);
-                                alternate_residue->SetResidueAlternateLocation(alternate_locations);
-                                vector<bool> selected_alternate_locations = alternate_residue->GetSelectedAlternateLocation();
-                                selected_alternate_locations.push_back(false);
-                                alternate_residue->SetSelectedAlternateLocation(selected_alternate_locations);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        return true;
+        return ExtractAlternateResidue(pdb_file);
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
 }
 bool PdbPreprocessor::ExtractAlternateResidue(PdbFile* pdb_file)
 {
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
+    PdbPreprocessorContext context(pdb_file);
+    return ExtractAlternateResidue(&context);
+}
+bool PdbPreprocessor::ExtractAlternateResidue(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractAlternateResidue");
+    /// Group the residues by name, chain id, sequence number and insertion code in one pass; a group with more than one
+    /// alternate location is an alternate residue. The groups keep the order of the pdb file, so the first alternate location
+    /// of a residue stays the selected one
+    typedef std::unordered_map<string, unsigned int> ResidueGroupIndexMap;
+    ResidueGroupIndexMap group_index = ResidueGroupIndexMap();
+    vector<string> group_keys = vector<string>();
+    vector<PdbResidue*> group_residues = vector<PdbResidue*>();
+    vector<vector<char> > group_alternate_locations = vector<vector<char> >();
+
+    const PdbFileSpace::PdbFile::PdbResidueVector& pdb_residues = context->GetResidues();
+    group_index.reserve(pdb_residues.size());
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
     {
-        PdbFileSpace::PdbResidue* target_residue = *it;
-        string target_residue_name = target_residue->GetResidueName();
-        char target_chain_id = target_residue->GetResidueChainId();
-        int target_sequence_number = target_residue->GetResidueSequenceNumber();
-        char target_insertion_code = target_residue->GetResidueInsertionCode();
-        char target_alternate_location = target_residue->GetResidueAlternateLocation();
-        stringstream ss;
-        ss << target_residue_name << "_" << target_chain_id << "_" << target_sequence_number << "_" << target_insertion_code;
-        string target_key = ss.str();
-        for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it1 =it+1 ; it1 != pdb_residues.end(); it1++)
+        PdbFileSpace::PdbResidue* residue = *it;
+        string key = residue->GetResidueName();
+        key.append(1, '_').append(1, residue->GetResidueChainId()).append(1, '_');
+        key.append(ConvertT<int>(residue->GetResidueSequenceNumber())).append(1, '_').append(1, residue->GetResidueInsertionCode());
+        char alternate_location = residue->GetResidueAlternateLocation();
+
+        pair<ResidueGroupIndexMap::iterator, bool> group = group_index.insert(make_pair(key, (unsigned int)group_keys.size()));
+        if(group.second)
         {
-            PdbFileSpace::PdbResidue* residue = *it1;
-            string residue_name = residue->GetResidueName();
-            char chain_id = residue->GetResidueChainId();
-            int sequence_number = residue->GetResidueSequenceNumber();
-            char insertion_code = residue->GetResidueInsertionCode();
-            char alternate_location = residue->GetResidueAlternateLocation();
-            stringstream sss;
-            sss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code;
-            string key = sss.str();
+            group_keys.push_back(key);
+            group_residues.push_back(residue);
+            group_alternate_locations.push_back(vector<char>(1, alternate_location));
+        }
+        else
+        {
+            vector<char>& alternate_locations = group_alternate_locations.at((*group.first).second);
+            if(find(alternate_locations.begin(), alternate_locations.end(), alternate_location) == alternate_locations.end())
+                alternate_locations.push_back(alternate_location);
+        }
+    }
 
-            if(key.compare(target_key) == 0)
+    for(unsigned int i = 0; i < group_keys.size(); i++)
+    {
+        const vector<char>& alternate_locations = group_alternate_locations.at(i);
+        if(alternate_locations.size() < 2)
+            continue;
+        PdbPreprocessorAlternateResidueMap::iterator existing = alternate_residue_map_.find(group_keys.at(i));
+        if(existing == alternate_residue_map_.end())
+        {
+            vector<bool> selected = vector<bool>(alternate_locations.size(), false);
+            selected.at(0) = true;
+            PdbResidue* residue = group_residues.at(i);
+            alternate_residue_map_[group_keys.at(i)] = new PdbPreprocessorAlternateResidue(residue->GetResidueName(), residue->GetResidueChainId(), residue->GetResidueSequenceNumber(),
+                                                                                         residue->GetResidueInsertionCode(), alternate_locations, selected);
+        }
+        else
+        {
+            PdbPreprocessorAlternateResidue* alternate_residue = (*existing).second;
+            vector<char> known_alternate_locations = alternate_residue->GetResidueAlternateLocation();
+            vector<bool> selected_alternate_locations = alternate_residue->GetSelectedAlternateLocation();
+            for(vector<char>::const_iterator it = alternate_locations.begin(); it != alternate_locations.end(); it++)
             {
-                if(target_alternate_location != alternate_location)
+                if(find(known_alternate_locations.begin(), known_alternate_locations.end(), *it) == known_alternate_locations.end())
                 {
-                    if (alternate_residue_map_.empty() || distance(alternate_residue_map_.begin() ,alternate_residue_map_.find(key)) < 0 ||
-                            distance(alternate_residue_map_.begin() ,alternate_residue_map_.find(key)) >= (int)alternate_residue_map_.size())
-                    {
-                        vector<bool> selected = vector<bool>();
-                        selected.push_back(true);
-                        selected.push_back(false);
-                        vector<char> alternate_locations = vector<char>();
-                        alternate_locations.push_back(target_alternate_location);
-                        alternate_locations.push_back(alternate_location);
-                        alternate_residue_map_[target_key] = new PdbPreprocessorAlternateResidue(residue_name, chain_id, sequence_number, insertion_code, alternate_locations, selected);
-                    }
-                    else
-                    {
-                        PdbPreprocessorAlternateResidue* alternate_residue = alternate_residue_map_[target_key];
-                        vector<char> alternate_locations = alternate_residue->GetResidueAlternateLocation();
-                        if(distance(alternate_locations.begin(), find(alternate_locations.begin(),alternate_locations.end(),alternate_location)) < 0 ||
-                                distance(alternate_locations.begin(), find(alternate_locations.begin(),alternate_locations.end(),alternate_location)) >= (int)alternate_locations.size())
-                        {
-
-                            alternate_locations.push_back(alternate_location);
-                            alternate_residue->SetResidueAlternateLocation(alternate_locations);
-                            vector<bool> selected_alternate_locations = alternate_residue->GetSelectedAlternateLocation();
-                            selected_alternate_locations.push_back(false);
-                            alternate_residue->SetSelectedAlternateLocation(selected_alternate_locations);
-                        }
-                    }
+                    known_alternate_locations.push_back(*it);
+                    selected_alternate_locations.push_back(false);
                 }
             }
+            alternate_residue->SetResidueAlternateLocation(known_alternate_locations);
+            alternate_residue->SetSelectedAlternateLocation(selected_alternate_locations);
         }
     }
     return true;
@@ -3393,67 +3127,42 @@ bool PdbPreprocessor::ExtractResidueInfo(string pdb_file_path, vector<string> am
 }
 bool PdbPreprocessor::ExtractResidueInfo(PdbFile *pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return ExtractResidueInfo(&context);
+}
+/// Sum of the charges of the dataset residue with the same name as the given pdb residue; lib residues take precedence over prep residues
+static double GetDatasetResidueCharge(PdbPreprocessorContext* context, PdbResidue* residue)
+{
+    double residue_charge = 0.0;
+    const LibraryFileSpace::LibraryFile::ResidueMap& lib_residues = context->GetLibraryResidues();
+    const PrepFileSpace::PrepFile::ResidueMap& prep_residues = context->GetPrepResidues();
+    LibraryFileSpace::LibraryFile::ResidueMap::const_iterator lib_residue = lib_residues.find(residue->GetResidueName());
+    PrepFileSpace::PrepFile::ResidueMap::const_iterator prep_residue = prep_residues.find(residue->GetResidueName());
+    if(lib_residue != lib_residues.end())
     {
-        lib_files.push_back(*it);
+        LibraryFileSpace::LibraryFileResidue::AtomMap lib_atoms = (*lib_residue).second->GetAtoms();
+        for(LibraryFileSpace::LibraryFileResidue::AtomMap::iterator it = lib_atoms.begin(); it != lib_atoms.end(); it++)
+            residue_charge += (*it).second->GetCharge();
     }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
+    else if(prep_residue != prep_residues.end())
     {
-        lib_files.push_back(*it);
+        PrepFileSpace::PrepFileResidue::PrepFileAtomVector prep_atoms = (*prep_residue).second->GetAtoms();
+        for(PrepFileSpace::PrepFileResidue::PrepFileAtomVector::iterator it = prep_atoms.begin(); it != prep_atoms.end(); it++)
+            residue_charge += (*it)->GetCharge();
     }
-    LibraryFileSpace::LibraryFile::ResidueMap lib_residues = GetAllResiduesFromMultipleLibFilesMap(lib_files);
-    PrepFileSpace::PrepFile::ResidueMap prep_residues = GetAllResiduesFromMultiplePrepFilesMap(prep_files);
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-
-    LibraryFileSpace::LibraryFileResidue::AtomMap lib_atoms;
-    PrepFileSpace::PrepFileResidue::PrepFileAtomVector prep_atoms;
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
+    return residue_charge;
+}
+bool PdbPreprocessor::ExtractResidueInfo(PdbPreprocessorContext* context)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::ExtractResidueInfo");
+    const PdbFileSpace::PdbFile::PdbResidueVector& pdb_residues = context->GetResidues();
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
     {
-        double residue_charge = 0.0;
         PdbResidue* residue = *it;
-        if(lib_residues.find(residue->GetResidueName()) != lib_residues.end())
-        {
-            LibraryFileSpace::LibraryFileResidue* lib_residue = lib_residues[residue->GetResidueName()];
-//            PdbFile::PdbAtomVector atoms = pdb_file->GetAllAtomsOfResidue(residue);
-
-//            for(PdbFile::PdbAtomVector::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
-//            {
-//                PdbAtom* atom = (*it1);
-//                LibraryFileSpace::LibraryFileAtom* lib_atom = lib_residue->GetLibraryAtomByAtomName(atom->GetAtomName());
-//                if(lib_atom != NULL)
-//                {
-//                    if(lib_atom->GetCharge() != dNotSet)
-//                        residue_charge += lib_atom->GetCharge();
-//                }
-//            }
-            lib_atoms = lib_residue->GetAtoms();
-            for(LibraryFileSpace::LibraryFileResidue::AtomMap::iterator it1 = lib_atoms.begin(); it1 != lib_atoms.end(); it1++)
-            {
-                LibraryFileSpace::LibraryFileAtom* lib_atom = (*it1).second;
-                residue_charge += lib_atom->GetCharge();
-            }
-        }
-        else if (prep_residues.find(residue->GetResidueName()) != prep_residues.end())
-        {
-            PrepFileSpace::PrepFileResidue* prep_residue = prep_residues[residue->GetResidueName()];
-            prep_atoms = prep_residue->GetAtoms();
-            for(PrepFileSpace::PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
-            {
-                PrepFileSpace::PrepFileAtom* prep_atom = (*it1);
-                residue_charge += prep_atom->GetCharge();
-            }
-        }
-        stringstream ss;
-        ss << residue->GetResidueName() << "_" << residue->GetResidueChainId() << "_" << residue->GetResidueSequenceNumber() << "_" << residue->GetResidueInsertionCode()
-           << "_" << residue->GetResidueAlternateLocation();
+        double residue_charge = GetDatasetResidueCharge(context, residue);
         PdbPreprocessorResidueInfo* residue_info = new PdbPreprocessorResidueInfo(residue->GetResidueName(), residue->GetResidueChainId(), residue->GetResidueSequenceNumber(),
                                                                                   residue->GetResidueInsertionCode(), residue->GetResidueAlternateLocation(), residue_charge);
-        residue_info_map_[ss.str()] = residue_info;
+        residue_info_map_[PdbPreprocessorContext::GetResidueKey(residue)] = residue_info;
     }
     return true;
 }
@@ -3526,152 +3235,203 @@ double PdbPreprocessor::CalculateModelCharge(string pdb_file_path, vector<string
 }
 double PdbPreprocessor::CalculateModelCharge(PdbFile* pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
 {
-    vector<string> lib_files = vector<string>();
-    for(vector<string>::iterator it = amino_lib_files.begin(); it != amino_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = glycam_lib_files.begin(); it != glycam_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
-    for(vector<string>::iterator it = other_lib_files.begin(); it != other_lib_files.end(); it++)
-    {
-        lib_files.push_back(*it);
-    }
+    PdbPreprocessorContext context(pdb_file, amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    return CalculateModelCharge(&context);
+}
+double PdbPreprocessor::CalculateModelCharge(PdbPreprocessorContext* context)
+{
     double model_charge = 0.0;
-    LibraryFileSpace::LibraryFile::ResidueMap lib_residues = GetAllResiduesFromMultipleLibFilesMap(lib_files);
-    PrepFileSpace::PrepFile::ResidueMap prep_residues = GetAllResiduesFromMultiplePrepFilesMap(prep_files);
-    PdbFileSpace::PdbFile::PdbResidueVector pdb_residues = pdb_file->GetAllResidues();
-
-    LibraryFileSpace::LibraryFileResidue::AtomMap lib_atoms;
-    PrepFileSpace::PrepFileResidue::PrepFileAtomVector prep_atoms;
-    for(PdbFileSpace::PdbFile::PdbResidueVector::iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
-    {
-        PdbResidue* residue = *it;
-        if(lib_residues.find(residue->GetResidueName()) != lib_residues.end())
-        {
-            LibraryFileSpace::LibraryFileResidue* lib_residue = lib_residues[residue->GetResidueName()];
-//            PdbFile::PdbAtomVector atoms = pdb_file->GetAllAtomsOfResidue(residue);
-
-//            for(PdbFile::PdbAtomVector::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
-//            {
-//                PdbAtom* atom = (*it1);
-//                LibraryFileSpace::LibraryFileAtom* lib_atom = lib_residue->GetLibraryAtomByAtomName(atom->GetAtomName());
-//                if(lib_atom != NULL)
-//                {
-//                    if(lib_atom->GetCharge() != dNotSet)
-//                        model_charge += lib_atom->GetCharge();
-//                }
-//            }
-
-            lib_atoms = lib_residue->GetAtoms();
-            for(LibraryFileSpace::LibraryFileResidue::AtomMap::iterator it1 = lib_atoms.begin(); it1 != lib_atoms.end(); it1++)
-            {
-                LibraryFileSpace::LibraryFileAtom* lib_atom = (*it1).second;
-                model_charge += lib_atom->GetCharge();
-            }
-        }
-        else if (prep_residues.find(residue->GetResidueName()) != prep_residues.end())
-        {
-            PrepFileSpace::PrepFileResidue* prep_residue = prep_residues[residue->GetResidueName()];
-            prep_atoms = prep_residue->GetAtoms();
-            for(PrepFileSpace::PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
-            {
-                PrepFileSpace::PrepFileAtom* prep_atom = (*it1);
-                model_charge += prep_atom->GetCharge();
-            }
-        }
-    }
+    const PdbFileSpace::PdbFile::PdbResidueVector& pdb_residues = context->GetResidues();
+    for(PdbFileSpace::PdbFile::PdbResidueVector::const_iterator it = pdb_residues.begin(); it != pdb_residues.end(); it++)
+        model_charge += GetDatasetResidueCharge(context, *it);
     return model_charge;
 }
 
 void PdbPreprocessor::Preprocess(PdbFile* pdb_file, vector<string> amino_lib_files_path, vector<string> glycam_lib_files_path, vector<string> other_lib_files_path, vector<string> prep_files_path)
 {
+    GMML_SCOPED_TIMER("PdbPreprocessor::Preprocess");
     try
     {
         time_t t = time(0);
         string time_str = std::asctime(std::localtime(&t));
-        cout << time_str.substr(0, time_str.size() - 1) << "Start preprocessing ..." << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, "Start preprocessing ..." );
-        ExtractHISResidues(pdb_file);
+        /// All stages share the residue/atom indices of the pdb file and the dataset files that are read only once here
+        PdbPreprocessorContext context(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        ExtractHISResidues(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream his;
         his << time_str.substr(0, time_str.size() - 1) << "HIS residues extraction: done";
-        cout << his.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, his.str());
-        ExtractCYSResidues(pdb_file);
+        ExtractCYSResidues(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream cys;
         cys << time_str.substr(0, time_str.size() - 1) << "CYS residues extraction: done";
-        cout << cys.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, cys.str() );
-        ExtractAlternateResidue(pdb_file);
+        ExtractAlternateResidue(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream alt;
         alt << time_str.substr(0, time_str.size() - 1) << "Alternate residues extraction: done";
-        cout << alt.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, alt.str() );
-        ExtractUnrecognizedResidues(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        ExtractUnrecognizedResidues(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream unrecognized;
         unrecognized << time_str.substr(0, time_str.size() - 1) << "Unrecognized residues extraction: done";
-        cout << unrecognized.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, unrecognized.str() );
-        ExtractUnknownHeavyAtoms(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        ExtractUnknownHeavyAtoms(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream heavy;
         heavy << time_str.substr(0, time_str.size() - 1) << "Unknown heavy atoms extraction: done" ;
-        cout << heavy.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, heavy.str() );
-        ExtractRemovedHydrogens(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        ExtractRemovedHydrogens(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream hydrogen;
         hydrogen << time_str.substr(0, time_str.size() - 1) << "Removed hydrogens extraction: done" ;
-        cout << hydrogen.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, hydrogen.str() );
-        ExtractAminoAcidChains(pdb_file, amino_lib_files_path);
+        ExtractAminoAcidChains(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream amino;
         amino << time_str.substr(0, time_str.size() - 1) << "Amino acid chains extraction: done" ;
-        cout << amino.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, amino.str() );
-        ExtractGapsInAminoAcidChains(pdb_file, amino_lib_files_path);
+        ExtractGapsInAminoAcidChains(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream gaps;
         gaps << time_str.substr(0, time_str.size() - 1) << "Gaps in amino acid chains extraction: done";
-        cout << gaps.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, gaps.str() );
-        ExtractResidueInfo(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        ExtractResidueInfo(&context);
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream info;
         info << time_str.substr(0, time_str.size() - 1) << "Residue info extraction: done" ;
-        cout << info.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, info.str() );
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream model_charge;
-        model_charge << "Model charge is " << CalculateModelCharge(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path) ;
-        cout << model_charge.str() << endl;
+        model_charge << "Model charge is " << CalculateModelCharge(&context) ;
         gmml::log(__LINE__, __FILE__,  gmml::INF, model_charge.str() );
         stringstream model_done;
         model_done << time_str.substr(0, time_str.size() - 1) << "Model charge calculation: done" ;
-        cout << model_done << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, model_done.str() );
         t = time(0);
         time_str = std::asctime(std::localtime(&t));
         stringstream pre;
         pre << time_str.substr(0, time_str.size() - 1) << "Preprocessing done";
-        cout << pre.str() << endl;
+        gmml::log(__LINE__, __FILE__,  gmml::INF, pre.str() );
+    }
+    catch(PdbFileSpace::PdbFileProcessingException &ex)
+    {}
+}
+
+void* PreprocessThread(void* args)
+{
+    PreprocessingThreadArgument* arg = (PreprocessingThreadArgument*)args;
+    PdbPreprocessor* preprocessor = arg->preprocessor;
+    PdbPreprocessorContext* context = arg->context;
+    int number_of_tasks = NUMBER_OF_STAGES + arg->chain_ids->size();
+    /// Interleave the tasks between the threads; every stage writes its own result list and every chain its own slot
+    for(int i = arg->thread_index; i < number_of_tasks; i += arg->number_of_threads)
+    {
+        switch(i)
+        {
+            case HIS_STAGE:
+                preprocessor->ExtractHISResidues(context);
+                break;
+            case CYS_STAGE:
+                preprocessor->ExtractCYSResidues(context);
+                break;
+            case ALTERNATE_RESIDUE_STAGE:
+                preprocessor->ExtractAlternateResidue(context);
+                break;
+            case UNRECOGNIZED_RESIDUE_STAGE:
+                preprocessor->ExtractUnrecognizedResidues(context);
+                break;
+            case UNKNOWN_HEAVY_ATOM_STAGE:
+                preprocessor->ExtractUnknownHeavyAtoms(context);
+                break;
+            case REMOVED_HYDROGEN_STAGE:
+                preprocessor->ExtractRemovedHydrogens(context);
+                break;
+            case RESIDUE_INFO_STAGE:
+                preprocessor->ExtractResidueInfo(context);
+                break;
+            default:
+            {
+                int chain_index = i - NUMBER_OF_STAGES;
+                string chain_id = arg->chain_ids->at(chain_index);
+                arg->chain_terminations->at(chain_index) = preprocessor->ExtractAminoAcidChain(context, chain_id[0]);
+                arg->missing_residues->at(chain_index) = preprocessor->ExtractGapsInAminoAcidChain(context, chain_id);
+                break;
+            }
+        }
+    }
+    pthread_exit(NULL);
+}
+
+void PdbPreprocessor::Preprocess(PdbFile* pdb_file, vector<string> amino_lib_files_path, vector<string> glycam_lib_files_path, vector<string> other_lib_files_path,
+                                 vector<string> prep_files_path, int number_of_threads)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessor::Preprocess (threaded)");
+    if(number_of_threads <= 1)
+    {
+        Preprocess(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+        return;
+    }
+    try
+    {
+        time_t t = time(0);
+        string time_str = std::asctime(std::localtime(&t));
+        stringstream start;
+        start << "Start preprocessing on " << number_of_threads << " threads ...";
+        gmml::log(__LINE__, __FILE__,  gmml::INF, start.str() );
+        PdbPreprocessorContext context(pdb_file, amino_lib_files_path, glycam_lib_files_path, other_lib_files_path, prep_files_path);
+
+        vector<string> chain_ids = vector<string>();
+        if(CheckAminoAcidChainSegments(&context))
+        {
+            const PdbPreprocessorChainIdResidueMap& chain_amino_acid_residues = context.GetChainAminoAcidResidues();
+            for(PdbPreprocessorChainIdResidueMap::const_iterator it = chain_amino_acid_residues.begin(); it != chain_amino_acid_residues.end(); it++)
+                chain_ids.push_back((*it).first);
+        }
+        PdbPreprocessorChainTerminationVector chain_terminations = PdbPreprocessorChainTerminationVector(chain_ids.size(), NULL);
+        vector<PdbPreprocessorMissingResidueVector> missing_residues = vector<PdbPreprocessorMissingResidueVector>(chain_ids.size());
+
+        pthread_t threads[number_of_threads];
+        PreprocessingThreadArgument arg[number_of_threads];
+        for(int i = 0; i < number_of_threads; i++)
+        {
+            arg[i] = PreprocessingThreadArgument(i, number_of_threads, this, &context, &chain_ids, &chain_terminations, &missing_residues);
+            pthread_create(&threads[i], NULL, &PreprocessThread, &arg[i]);
+        }
+        for(int i = 0; i < number_of_threads; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        for(unsigned int i = 0; i < chain_ids.size(); i++)
+        {
+            if(chain_terminations.at(i) != NULL)
+                chain_terminations_.push_back(chain_terminations.at(i));
+            missing_residues_.insert(missing_residues_.end(), missing_residues.at(i).begin(), missing_residues.at(i).end());
+        }
+        t = time(0);
+        time_str = std::asctime(std::localtime(&t));
+        stringstream extraction;
+        extraction << time_str.substr(0, time_str.size() - 1) << "Extraction of all stages and " << chain_ids.size() << " amino acid chains: done";
+        gmml::log(__LINE__, __FILE__,  gmml::INF, extraction.str() );
+
+        stringstream model_charge;
+        model_charge << "Model charge is " << CalculateModelCharge(&context);
+        gmml::log(__LINE__, __FILE__,  gmml::INF, model_charge.str() );
+        t = time(0);
+        time_str = std::asctime(std::localtime(&t));
+        stringstream pre;
+        pre << time_str.substr(0, time_str.size() - 1) << "Preprocessing done";
         gmml::log(__LINE__, __FILE__,  gmml::INF, pre.str() );
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
@@ -3684,69 +3444,59 @@ void PdbPreprocessor::ApplyPreprocessing(PdbFile *pdb_file, vector<string> amino
     string time_str = std::asctime(std::localtime(&t));
     stringstream changes;
     changes << time_str.substr(0, time_str.size() - 1) << "Start to apply changes ...";
-    cout << changes.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, changes.str() );
     UpdateHISMapping(pdb_file,this->GetHistidineMappings());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream his_update;
     his_update << time_str.substr(0, time_str.size() - 1) << "HIS residues update: done" ;
-    cout << his_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, his_update.str() );
     UpdateCYSResidues(pdb_file, this->GetDisulfideBonds());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream cys_update;
     cys_update << time_str.substr(0, time_str.size() - 1) << "CYS residues update: done" ;
-    cout << cys_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, cys_update.str() );
     RemoveUnselectedAlternateResidues(pdb_file,this->GetAlternateResidueMap());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream alt_res;
     alt_res << time_str.substr(0, time_str.size() - 1) << "Unselected alternate residues removed: done" ;
-    cout << alt_res.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, alt_res.str() );
     RemoveUnrecognizedResidues(pdb_file, this->GetUnrecognizedResidues());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_res;
     remove_res << time_str.substr(0, time_str.size() - 1) << "Remove unrecognized residues: done" ;
-    cout << remove_res.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_res.str() );
     RemoveResiduesOfUnknownHeavyAtoms(pdb_file, this->GetUnrecognizedHeavyAtoms());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_heavy;
     remove_heavy << time_str.substr(0, time_str.size() - 1) << "Unknown heavy atoms removed: done" ;
-    cout << remove_heavy.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_heavy.str() );
     RemoveRemovedHydrogens(pdb_file, this->GetReplacedHydrogens());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_hydrogen;
     remove_hydrogen << time_str.substr(0, time_str.size() - 1) << "Removed hydrogens removed: done" ;
-    cout << remove_hydrogen.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_hydrogen.str() );
     UpdateAminoAcidChains(pdb_file, amino_lib_files_path, glycam_lib_files_path, prep_files_path, this->GetChainTerminations());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream amino_update;
     amino_update << time_str.substr(0, time_str.size() - 1) << "Amino acid chains update: done" ;
-    cout << amino_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, amino_update.str() );
     UpdateGapsInAminoAcidChains(pdb_file, amino_lib_files_path, this->GetMissingResidues());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream gaps_update;
     gaps_update << time_str.substr(0, time_str.size() - 1) << "Gaps in amino acid chains update: done" ;
-    cout << gaps_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, gaps_update.str() );
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream applied;
     applied << time_str.substr(0, time_str.size() - 1) << "Applying changes done" ;
-    cout << applied.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, applied.str() );
 }
 
@@ -3757,69 +3507,59 @@ void PdbPreprocessor::ApplyPreprocessingWithTheGivenModelNumber(PdbFile *pdb_fil
     string time_str = std::asctime(std::localtime(&t));
     stringstream changes;
     changes << time_str.substr(0, time_str.size() - 1) << "Start to apply changes ..." ;
-    cout << changes.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, changes.str() );
     UpdateHISMappingWithTheGivenNumber(pdb_file,this->GetHistidineMappings(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream his_update;
     his_update << time_str.substr(0, time_str.size() - 1) << "HIS residues update: done" ;
-    cout << his_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, his_update.str() );
     UpdateCYSResiduesWithTheGivenModelNumber(pdb_file, this->GetDisulfideBonds());
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream cys_update;
     cys_update << time_str.substr(0, time_str.size() - 1) << "CYS residues update: done" ;
-    cout << cys_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, cys_update.str() );
     RemoveUnselectedAlternateResiduesWithTheGivenModelNumber(pdb_file,this->GetAlternateResidueMap(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream alt_res;
     alt_res << time_str.substr(0, time_str.size() - 1) << "Unselected alternate residues removed: done" ;
-    cout << alt_res.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, alt_res.str() );
     RemoveUnrecognizedResiduesWithTheGivenModelNumber(pdb_file, this->GetUnrecognizedResidues(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_res;
     remove_res << time_str.substr(0, time_str.size() - 1) << "Remove unrecognized residues: done" ;
-    cout << remove_res.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_res.str() );
     RemoveResiduesOfUnknownHeavyAtomsWithTheGivenModelNumber(pdb_file, this->GetUnrecognizedHeavyAtoms(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_heavy;
     remove_heavy << time_str.substr(0, time_str.size() - 1) << "Unknown heavy atoms removed: done" ;
-    cout << remove_heavy.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_heavy.str() );
     RemoveRemovedHydrogensWithTheGivenModelNumber(pdb_file, this->GetReplacedHydrogens(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream remove_hydrogen;
     remove_hydrogen << time_str.substr(0, time_str.size() - 1) << "Removed hydrogens removed: done" ;
-    cout << remove_hydrogen.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, remove_hydrogen.str() );
     UpdateAminoAcidChainsWithTheGivenModelNumber(pdb_file, amino_lib_files_path, glycam_lib_files_path, prep_files_path, this->GetChainTerminations(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream amino_update;
     amino_update << time_str.substr(0, time_str.size() - 1) << "Amino acid chains update: done" ;
-    cout << amino_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, amino_update.str() );
     UpdateGapsInAminoAcidChainsWithTheGivenModelNumber(pdb_file, amino_lib_files_path, this->GetMissingResidues(), model_number);
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream gaps_update;
     gaps_update << time_str.substr(0, time_str.size() - 1) << "Gaps in amino acid chains update: done" ;
-    cout << gaps_update.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, gaps_update.str() );
     t = time(0);
     time_str = std::asctime(std::localtime(&t));
     stringstream applied;
     applied << time_str.substr(0, time_str.size() - 1) << "Applying changes done" ;
-    cout << applied.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, applied.str() );
 }
 
@@ -0,0 +1,334 @@
+#include <sstream>
+
+#include "../../../includes/Resolver/PdbPreprocessor/pdbpreprocessorcontext.hpp"
+#include "../../../includes/InputSet/PdbFileSpace/pdbfile.hpp"
+#include "../../../includes/InputSet/PdbFileSpace/pdbresidue.hpp"
+#include "../../../includes/InputSet/PdbFileSpace/pdbatom.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfile.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfileresidue.hpp"
+#include "../../../includes/ParameterSet/LibraryFileSpace/libraryfileatom.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfile.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfileresidue.hpp"
+#include "../../../includes/ParameterSet/PrepFileSpace/prepfileatom.hpp"
+#include "../../../includes/utils.hpp"
+#include "../../../includes/instrumentation.hpp"
+
+using namespace std;
+using namespace PdbPreprocessorSpace;
+using namespace PdbFileSpace;
+using namespace gmml;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+PdbPreprocessorContext::PdbPreprocessorContext(PdbFile *pdb_file) : pdb_file_(pdb_file)
+{
+    this->BuildPdbIndices();
+}
+
+PdbPreprocessorContext::PdbPreprocessorContext(PdbFile *pdb_file, vector<string> amino_lib_files, vector<string> glycam_lib_files,
+                                               vector<string> other_lib_files, vector<string> prep_files) : pdb_file_(pdb_file)
+{
+    this->BuildPdbIndices();
+    this->LoadDataset(amino_lib_files, glycam_lib_files, other_lib_files, prep_files);
+    this->BuildAminoAcidChains();
+}
+
+PdbPreprocessorContext::~PdbPreprocessorContext()
+{
+    for(PdbFile::PdbResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
+        delete (*it);
+    for(PdbFile::PdbResidueVector::iterator it = residues_from_atom_card_.begin(); it != residues_from_atom_card_.end(); it++)
+        delete (*it);
+    for(PdbFile::PdbResidueAtomsMap::iterator it = residue_atoms_.begin(); it != residue_atoms_.end(); it++)
+        delete (*it).second;
+    for(vector<LibraryFileSpace::LibraryFile*>::iterator it = loaded_lib_files_.begin(); it != loaded_lib_files_.end(); it++)
+        delete (*it);
+    for(vector<PrepFileSpace::PrepFile*>::iterator it = loaded_prep_files_.begin(); it != loaded_prep_files_.end(); it++)
+        delete (*it);
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+PdbFile* PdbPreprocessorContext::GetPdbFile()
+{
+    return pdb_file_;
+}
+
+const PdbFile::PdbResidueVector& PdbPreprocessorContext::GetResidues()
+{
+    return residues_;
+}
+
+const PdbFile::PdbResidueVector& PdbPreprocessorContext::GetResiduesFromAtomCard()
+{
+    return residues_from_atom_card_;
+}
+
+const PdbFile::PdbPairVectorAtomNamePositionFlag& PdbPreprocessorContext::GetResidueNames()
+{
+    return residue_names_;
+}
+
+const PdbPreprocessorContext::ChainIdResidueMap& PdbPreprocessorContext::GetChainResidues()
+{
+    return chain_residues_;
+}
+
+const PdbPreprocessorContext::ChainIdSegmentsMap& PdbPreprocessorContext::GetChainSegments()
+{
+    return chain_segments_;
+}
+
+const PdbPreprocessorContext::ChainIdResidueMap& PdbPreprocessorContext::GetChainAminoAcidResidues()
+{
+    return chain_amino_acid_residues_;
+}
+
+const PdbPreprocessorContext::ChainIdSequenceNumbersMap& PdbPreprocessorContext::GetChainSequenceNumbers()
+{
+    return chain_sequence_numbers_;
+}
+
+const PdbPreprocessorContext::ChainIdInsertionCodeMap& PdbPreprocessorContext::GetChainInsertionCodes()
+{
+    return chain_insertion_codes_;
+}
+
+const vector<string>& PdbPreprocessorContext::GetLibFiles()
+{
+    return lib_files_;
+}
+
+const vector<string>& PdbPreprocessorContext::GetPrepFiles()
+{
+    return prep_files_;
+}
+
+const LibraryFileSpace::LibraryFile::ResidueMap& PdbPreprocessorContext::GetLibraryResidues()
+{
+    return lib_residues_;
+}
+
+const PrepFileSpace::PrepFile::ResidueMap& PdbPreprocessorContext::GetPrepResidues()
+{
+    return prep_residues_;
+}
+
+const ResidueNameMap& PdbPreprocessorContext::GetAminoAcidResidueNames()
+{
+    return amino_acid_residue_names_;
+}
+
+const ResidueNameMap& PdbPreprocessorContext::GetDatasetResidueNames()
+{
+    return dataset_residue_names_;
+}
+
+const ResidueNameAtomNamesMap& PdbPreprocessorContext::GetDatasetResidueAtomNames()
+{
+    return dataset_residue_atom_names_;
+}
+
+const PdbFile::PdbResidueVector& PdbPreprocessorContext::GetRecognizedResidues()
+{
+    return recognized_residues_;
+}
+
+const PdbFile::PdbResidueVector& PdbPreprocessorContext::GetUnrecognizedResidues()
+{
+    return unrecognized_residues_;
+}
+
+bool PdbPreprocessorContext::HasResidueNameWithFlag(const string &residue_name, const string &flag)
+{
+    return residue_name_flags_.find(make_pair(residue_name, flag)) != residue_name_flags_.end();
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+string PdbPreprocessorContext::GetResidueKey(PdbResidue *residue)
+{
+    stringstream ss;
+    ss << residue->GetResidueName() << "_" << residue->GetResidueChainId() << "_" << residue->GetResidueSequenceNumber() << "_"
+       << residue->GetResidueInsertionCode() << "_" << residue->GetResidueAlternateLocation();
+    return ss.str();
+}
+
+const PdbFile::PdbAtomVector& PdbPreprocessorContext::GetAtomsOfResidue(PdbResidue *residue)
+{
+    PdbFile::PdbResidueAtomsMap::iterator it = residue_atoms_.find(GetResidueKey(residue));
+    if(it == residue_atoms_.end() || (*it).second == NULL)
+        return empty_atoms_;
+    return *((*it).second);
+}
+
+PdbAtom* PdbPreprocessorContext::GetAtomOfResidueByName(PdbResidue *residue, const string &atom_name)
+{
+    const PdbFile::PdbAtomVector& atoms = this->GetAtomsOfResidue(residue);
+    for(PdbFile::PdbAtomVector::const_iterator it = atoms.begin(); it != atoms.end(); it++)
+    {
+        if((*it)->GetAtomName().compare(atom_name) == 0)
+            return (*it);
+    }
+    return NULL;
+}
+
+void PdbPreprocessorContext::BuildPdbIndices()
+{
+    GMML_SCOPED_TIMER("PdbPreprocessorContext::BuildPdbIndices");
+    residues_ = pdb_file_->GetAllResidues();
+    residues_from_atom_card_ = pdb_file_->GetAllResiduesFromAtomCard();
+    residue_names_ = pdb_file_->GetAllResidueNames();
+    residue_atoms_ = pdb_file_->GetAllAtomsOfResidues();
+    for(PdbFile::PdbPairVectorAtomNamePositionFlag::iterator it = residue_names_.begin(); it != residue_names_.end(); it++)
+        residue_name_flags_[*it] = true;
+    for(PdbFile::PdbResidueVector::iterator it = residues_from_atom_card_.begin(); it != residues_from_atom_card_.end(); it++)
+    {
+        stringstream ss;
+        ss << (*it)->GetResidueChainId();
+        chain_residues_[ss.str()].push_back(*it);
+    }
+}
+
+void PdbPreprocessorContext::LoadDataset(vector<string> amino_lib_files, vector<string> glycam_lib_files, vector<string> other_lib_files, vector<string> prep_files)
+{
+    GMML_SCOPED_TIMER("PdbPreprocessorContext::LoadDataset");
+    lib_files_ = amino_lib_files;
+    lib_files_.insert(lib_files_.end(), glycam_lib_files.begin(), glycam_lib_files.end());
+    lib_files_.insert(lib_files_.end(), other_lib_files.begin(), other_lib_files.end());
+    prep_files_ = prep_files;
+
+    /// The name tables come from the indices of the files; only the residues the pdb file can refer to, with their N/C terminal variants, are parsed
+    ResidueNameMap needed_residue_names = ResidueNameMap();
+    for(PdbFile::PdbPairVectorAtomNamePositionFlag::iterator it = residue_names_.begin(); it != residue_names_.end(); it++)
+    {
+        string residue_name = (*it).first;
+        needed_residue_names[residue_name] = residue_name;
+        needed_residue_names["N" + residue_name] = "N" + residue_name;
+        needed_residue_names["C" + residue_name] = "C" + residue_name;
+    }
+
+    /// A residue of a later file replaces a residue with the same name of an earlier file
+    map<string, LibraryFileSpace::LibraryFile*> lib_residue_files = map<string, LibraryFileSpace::LibraryFile*>();
+    for(vector<string>::iterator it = lib_files_.begin(); it != lib_files_.end(); it++)
+    {
+        LibraryFileSpace::LibraryFile* lib_file = new LibraryFileSpace::LibraryFile(*it);
+        loaded_lib_files_.push_back(lib_file);
+        bool is_amino_lib_file = distance(lib_files_.begin(), it) < (int)amino_lib_files.size();
+        ResidueNameMap residue_names = lib_file->GetAllResidueNamesMap();
+        for(ResidueNameMap::iterator it1 = residue_names.begin(); it1 != residue_names.end(); it1++)
+        {
+            string residue_name = (*it1).first;
+            dataset_residue_names_[residue_name] = residue_name;
+            if(is_amino_lib_file)
+                amino_acid_residue_names_[residue_name] = residue_name;
+            if(needed_residue_names.find(residue_name) != needed_residue_names.end())
+                lib_residue_files[residue_name] = lib_file;
+        }
+    }
+    map<string, PrepFileSpace::PrepFile*> prep_residue_files = map<string, PrepFileSpace::PrepFile*>();
+    for(vector<string>::iterator it = prep_files_.begin(); it != prep_files_.end(); it++)
+    {
+        PrepFileSpace::PrepFile* prep_file = new PrepFileSpace::PrepFile(*it);
+        loaded_prep_files_.push_back(prep_file);
+        ResidueNameMap residue_names = prep_file->GetAllResidueNamesMap();
+        for(ResidueNameMap::iterator it1 = residue_names.begin(); it1 != residue_names.end(); it1++)
+        {
+            string residue_name = (*it1).first;
+            dataset_residue_names_[residue_name] = residue_name;
+            if(needed_residue_names.find(residue_name) != needed_residue_names.end())
+                prep_residue_files[residue_name] = prep_file;
+        }
+    }
+
+    for(map<string, LibraryFileSpace::LibraryFile*>::iterator it = lib_residue_files.begin(); it != lib_residue_files.end(); it++)
+    {
+        string residue_name = (*it).first;
+        LibraryFileSpace::LibraryFileResidue* residue = (*it).second->GetLibraryResidueByResidueName(residue_name);
+        if(residue == NULL)
+            continue;
+        lib_residues_[residue_name] = residue;
+        vector<string>& atom_names = dataset_residue_atom_names_[residue_name];
+        LibraryFileSpace::LibraryFileResidue::AtomMap atoms = residue->GetAtoms();
+        for(LibraryFileSpace::LibraryFileResidue::AtomMap::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
+            atom_names.push_back((*it1).second->GetName());
+    }
+    /// Prep residues replace lib residues with the same name in the atom name table
+    for(map<string, PrepFileSpace::PrepFile*>::iterator it = prep_residue_files.begin(); it != prep_residue_files.end(); it++)
+    {
+        string residue_name = (*it).first;
+        PrepFileSpace::PrepFileResidue* residue = (*it).second->GetPrepResidueByResidueName(residue_name);
+        if(residue == NULL)
+            continue;
+        prep_residues_[residue_name] = residue;
+        vector<string>& atom_names = dataset_residue_atom_names_[residue_name];
+        atom_names.clear();
+        PrepFileSpace::PrepFileResidue::PrepFileAtomVector atoms = residue->GetAtoms();
+        for(PrepFileSpace::PrepFileResidue::PrepFileAtomVector::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
+            atom_names.push_back((*it1)->GetName());
+    }
+
+    /// A residue name is recognized if the dataset has it (or its N/C terminal variant at the start/end of a chain); HIS is always recognized
+    ResidueNameMap recognized_residue_names = ResidueNameMap();
+    ResidueNameMap unrecognized_residue_names = ResidueNameMap();
+    for(PdbFile::PdbPairVectorAtomNamePositionFlag::iterator it = residue_names_.begin(); it != residue_names_.end(); it++)
+    {
+        string residue_name = (*it).first;
+        string position_flag = (*it).second;
+        if(residue_name.compare("HIS") == 0)
+        {
+            recognized_residue_names[residue_name] = residue_name;
+            continue;
+        }
+        bool recognized = dataset_residue_names_.find(residue_name) != dataset_residue_names_.end();
+        if(!recognized && position_flag.compare("S") == 0)
+            recognized = dataset_residue_names_.find("N" + residue_name) != dataset_residue_names_.end();
+        else if(!recognized && position_flag.compare("E") == 0)
+            recognized = dataset_residue_names_.find("C" + residue_name) != dataset_residue_names_.end();
+        if(recognized)
+            recognized_residue_names[residue_name] = residue_name;
+        else
+            unrecognized_residue_names[residue_name] = residue_name;
+    }
+    for(PdbFile::PdbResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
+    {
+        string residue_name = (*it)->GetResidueName();
+        if(recognized_residue_names.find(residue_name) != recognized_residue_names.end())
+            recognized_residues_.push_back(*it);
+        if(unrecognized_residue_names.find(residue_name) != unrecognized_residue_names.end())
+            unrecognized_residues_.push_back(*it);
+    }
+}
+
+void PdbPreprocessorContext::BuildAminoAcidChains()
+{
+    for(ChainIdResidueMap::iterator it = chain_residues_.begin(); it != chain_residues_.end(); it++)
+    {
+        int internal_amino_acid_chain_counter = 0;
+        string chain_id = (*it).first;
+        ChainIdResidueMap& segments = chain_segments_[chain_id];
+        PdbFile::PdbResidueVector& residues = (*it).second;
+        for(PdbFile::PdbResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
+        {
+            PdbResidue* residue = (*it1);
+            stringstream ss;
+            if(amino_acid_residue_names_.find(residue->GetResidueName()) != amino_acid_residue_names_.end())
+            {
+                ss << "A_" << chain_id << "_" << internal_amino_acid_chain_counter;
+                segments[ss.str()].push_back(residue);
+                chain_amino_acid_residues_[chain_id].push_back(residue);
+                chain_sequence_numbers_[chain_id[0]].push_back(residue->GetResidueSequenceNumber());
+                chain_insertion_codes_[chain_id[0]].push_back(residue->GetResidueInsertionCode());
+            }
+            else
+            {
+                ss << "NA_" << chain_id << "_" << internal_amino_acid_chain_counter;
+                segments[ss.str()].push_back(residue);
+                internal_amino_acid_chain_counter++;
+            }
+        }
+    }
+}
@@ -0,0 +1,468 @@
+#include <cstring>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#include "../includes/inputfilestream.hpp"
+#include "../includes/logger.hpp"
+
+using namespace std;
+using namespace gmml;
+
+/// Size of the parts a plain gzip file is read and inflated in
+static const size_t CHUNK_SIZE = 256 * 1024;
+/// Characters of the previous part that are kept in front of the next one, so that unget works across the parts
+static const size_t PUT_BACK_SIZE = 16;
+/// Blocks of a bgzip file that every thread inflates per batch; a block holds at most 64 KB of data
+static const size_t BLOCKS_PER_THREAD = 8;
+/// Upper limit of the number of threads that is used if the caller leaves it to the number of processors
+static const int MAX_DEFAULT_THREADS = 8;
+
+/*! \struct
+  * Position of a bgzip block in the batch of compressed data and of its data in the decompressed buffer
+  */
+struct BgzfBlock
+{
+        size_t input_offset;            /*!< Start of the deflate data of the block in the compressed batch >*/
+        size_t input_size;              /*!< Size of the deflate data of the block >*/
+        size_t output_offset;           /*!< Start of the data of the block in the decompressed buffer >*/
+        size_t output_size;             /*!< Size of the data of the block, ISIZE of the gzip trailer >*/
+        unsigned long crc;              /*!< CRC32 of the data of the block, from the gzip trailer >*/
+};
+
+/*! \struct
+  * Argument of the threads that inflate a batch of bgzip blocks; thread i inflates the blocks i, i + n, i + 2n ...
+  */
+struct BgzfBatchArgument
+{
+        const vector<BgzfBlock>* blocks;
+        const char* input;
+        char* output;
+        size_t first_block;
+        size_t stride;
+        bool succeeded;
+};
+
+static unsigned long ReadLittleEndian(const unsigned char* bytes, int size)
+{
+    unsigned long value = 0;
+    for(int i = size - 1; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+    return value;
+}
+
+static bool IsBgzfHeader(const unsigned char* header, size_t size)
+{
+    /// gzip member with the FEXTRA flag whose extra field starts with the BC subfield that holds the size of the block
+    return size >= 18 && header[0] == 0x1f && header[1] == 0x8b && header[2] == 8 && (header[3] & 4) != 0 &&
+            header[12] == 'B' && header[13] == 'C' && header[14] == 2 && header[15] == 0;
+}
+
+static bool InflateBgzfBlock(const char* input, char* output, const BgzfBlock& block)
+{
+    z_stream stream = z_stream();
+    if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+    stream.next_in = (Bytef*)(input + block.input_offset);
+    stream.avail_in = block.input_size;
+    stream.next_out = (Bytef*)(output + block.output_offset);
+    stream.avail_out = block.output_size;
+    int status = inflate(&stream, Z_FINISH);
+    bool succeeded = (status == Z_STREAM_END && stream.avail_out == 0);
+    inflateEnd(&stream);
+    return succeeded && crc32(0L, (const Bytef*)(output + block.output_offset), block.output_size) == block.crc;
+}
+
+static void* InflateBgzfBlocksThread(void* argument)
+{
+    BgzfBatchArgument* batch = (BgzfBatchArgument*)argument;
+    batch->succeeded = true;
+    for(size_t i = batch->first_block; i < batch->blocks->size(); i += batch->stride)
+    {
+        if(!InflateBgzfBlock(batch->input, batch->output, batch->blocks->at(i)))
+            batch->succeeded = false;
+    }
+    return NULL;
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+DecompressingBuffer::DecompressingBuffer() : file_(NULL), block_compressed_(false), number_of_threads_(1), stream_(NULL), end_of_file_(true),
+    member_ended_(false), buffer_offset_(0) {}
+
+DecompressingBuffer::~DecompressingBuffer()
+{
+    this->Close();
+}
+
+InputFileStream::InputFileStream() : std::istream(NULL), compressed_(false)
+{
+    this->rdbuf(&file_buffer_);
+}
+
+InputFileStream::InputFileStream(const string& path, int number_of_threads) : std::istream(NULL), compressed_(false)
+{
+    this->rdbuf(&file_buffer_);
+    this->open(path, number_of_threads);
+}
+
+InputFileStream::~InputFileStream()
+{
+    this->close();
+}
+
+//////////////////////////////////////////////////////////
+//                       ACCESSOR                       //
+//////////////////////////////////////////////////////////
+bool DecompressingBuffer::IsOpen() const
+{
+    return file_ != NULL;
+}
+
+bool DecompressingBuffer::IsBlockCompressed() const
+{
+    return block_compressed_;
+}
+
+bool InputFileStream::is_open() const
+{
+    return (compressed_) ? decompressing_buffer_.IsOpen() : file_buffer_.is_open();
+}
+
+bool InputFileStream::IsCompressed() const
+{
+    return compressed_;
+}
+
+bool InputFileStream::IsBlockCompressed() const
+{
+    return compressed_ && decompressing_buffer_.IsBlockCompressed();
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+bool DecompressingBuffer::Open(const string& path, int number_of_threads)
+{
+    this->Close();
+    file_ = fopen(path.c_str(), "rb");
+    if(file_ == NULL)
+        return false;
+    unsigned char header[18];
+    size_t size = fread(header, 1, sizeof(header), file_);
+    if(size < 10 || header[0] != 0x1f || header[1] != 0x8b)
+    {
+        this->Close();
+        return false;
+    }
+    block_compressed_ = IsBgzfHeader(header, size);
+    number_of_threads_ = (number_of_threads < 1) ? 1 : number_of_threads;
+    if(!this->Rewind())
+    {
+        this->Close();
+        return false;
+    }
+    return true;
+}
+
+void DecompressingBuffer::Close()
+{
+    if(file_ != NULL)
+        fclose(file_);
+    file_ = NULL;
+    if(stream_ != NULL)
+    {
+        inflateEnd((z_stream*)stream_);
+        delete (z_stream*)stream_;
+    }
+    stream_ = NULL;
+    block_compressed_ = false;
+    end_of_file_ = true;
+    compressed_ = vector<char>();
+    decompressed_ = vector<char>();
+    buffer_offset_ = 0;
+    this->setg(NULL, NULL, NULL);
+}
+
+bool DecompressingBuffer::Rewind()
+{
+    if(fseek(file_, 0, SEEK_SET) != 0)
+        return false;
+    end_of_file_ = false;
+    member_ended_ = false;
+    buffer_offset_ = 0;
+    decompressed_.clear();
+    this->setg(NULL, NULL, NULL);
+    if(block_compressed_)
+        return true;
+    /// 16 added to the window size makes zlib expect a gzip header and trailer
+    compressed_.resize(CHUNK_SIZE);
+    if(stream_ == NULL)
+    {
+        z_stream* stream = new z_stream();
+        if(inflateInit2(stream, MAX_WBITS + 16) != Z_OK)
+        {
+            delete stream;
+            return false;
+        }
+        stream_ = stream;
+    }
+    else
+        inflateReset((z_stream*)stream_);
+    ((z_stream*)stream_)->next_in = NULL;
+    ((z_stream*)stream_)->avail_in = 0;
+    return true;
+}
+
+bool DecompressingBuffer::Refill()
+{
+    if(file_ == NULL)
+        return false;
+    size_t consumed = this->gptr() - this->eback();
+    size_t kept = (consumed < PUT_BACK_SIZE) ? consumed : PUT_BACK_SIZE;
+    if(kept > 0)
+        memmove(&decompressed_[0], this->gptr() - kept, kept);
+    buffer_offset_ += consumed - kept;
+    decompressed_.resize(kept);
+    while(decompressed_.size() == kept && !end_of_file_)
+    {
+        if(!((block_compressed_) ? this->InflateBlocks() : this->InflateStream()))
+            end_of_file_ = true;
+    }
+    char* data = (decompressed_.empty()) ? NULL : &decompressed_[0];
+    this->setg(data, data + kept, data + decompressed_.size());
+    return decompressed_.size() > kept;
+}
+
+bool DecompressingBuffer::InflateStream()
+{
+    z_stream* stream = (z_stream*)stream_;
+    size_t start = decompressed_.size();
+    decompressed_.resize(start + CHUNK_SIZE);
+    stream->next_out = (Bytef*)&decompressed_[start];
+    stream->avail_out = CHUNK_SIZE;
+    bool succeeded = true;
+    while(stream->avail_out > 0)
+    {
+        if(stream->avail_in == 0)
+        {
+            size_t size = fread(&compressed_[0], 1, compressed_.size(), file_);
+            if(size == 0)
+            {
+                if(!member_ended_)
+                {
+                    GMML_LOG(gmml::ERR, "Compressed file ends in the middle of its data");
+                    succeeded = false;
+                }
+                end_of_file_ = true;
+                break;
+            }
+            stream->next_in = (Bytef*)&compressed_[0];
+            stream->avail_in = size;
+        }
+        if(member_ended_)
+        {
+            /// Another gzip member may follow the one that has ended; anything else after it is ignored like gzip does
+            if(stream->next_in[0] != 0x1f)
+            {
+                end_of_file_ = true;
+                break;
+            }
+            inflateReset(stream);
+            member_ended_ = false;
+        }
+        int status = inflate(stream, Z_NO_FLUSH);
+        if(status == Z_STREAM_END)
+            member_ended_ = true;
+        else if(status != Z_OK && !(status == Z_BUF_ERROR && stream->avail_in == 0))
+        {
+            GMML_LOG(gmml::ERR, "Invalid compressed data: " << ((stream->msg != NULL) ? stream->msg : "unknown error"));
+            succeeded = false;
+            end_of_file_ = true;
+            break;
+        }
+    }
+    decompressed_.resize(start + CHUNK_SIZE - stream->avail_out);
+    return succeeded;
+}
+
+bool DecompressingBuffer::InflateBlocks()
+{
+    size_t start = decompressed_.size();
+    size_t end = start;
+    size_t max_blocks = number_of_threads_ * BLOCKS_PER_THREAD;
+    vector<BgzfBlock> blocks = vector<BgzfBlock>();
+    compressed_.clear();
+    while(blocks.size() < max_blocks)
+    {
+        unsigned char header[18];
+        size_t size = fread(header, 1, sizeof(header), file_);
+        if(size == 0)
+        {
+            end_of_file_ = true;
+            break;
+        }
+        if(!IsBgzfHeader(header, size))
+        {
+            GMML_LOG(gmml::ERR, "Invalid block header in bgzip file");
+            return false;
+        }
+        size_t extra_size = ReadLittleEndian(header + 10, 2);
+        size_t block_size = ReadLittleEndian(header + 16, 2) + 1;
+        if(block_size < 12 + extra_size + 8)
+        {
+            GMML_LOG(gmml::ERR, "Invalid block size in bgzip file");
+            return false;
+        }
+        size_t offset = compressed_.size();
+        compressed_.resize(offset + block_size);
+        memcpy(&compressed_[offset], header, sizeof(header));
+        if(fread(&compressed_[offset + sizeof(header)], 1, block_size - sizeof(header), file_) != block_size - sizeof(header))
+        {
+            GMML_LOG(gmml::ERR, "Compressed file ends in the middle of a bgzip block");
+            return false;
+        }
+        const unsigned char* trailer = (const unsigned char*)&compressed_[offset + block_size - 8];
+        BgzfBlock block = BgzfBlock();
+        block.input_offset = offset + 12 + extra_size;
+        block.input_size = block_size - 12 - extra_size - 8;
+        block.output_offset = end;
+        block.output_size = ReadLittleEndian(trailer + 4, 4);
+        block.crc = ReadLittleEndian(trailer, 4);
+        end += block.output_size;
+        blocks.push_back(block);
+    }
+    /// Empty blocks such as the end of file marker have nothing to inflate
+    if(end == start)
+        return true;
+    decompressed_.resize(end);
+
+    /// The blocks are independent gzip members, so the threads inflate them straight into their place in the buffer
+    size_t number_of_threads = ((size_t)number_of_threads_ < blocks.size()) ? number_of_threads_ : blocks.size();
+    vector<BgzfBatchArgument> arguments = vector<BgzfBatchArgument>(number_of_threads);
+    for(size_t i = 0; i < number_of_threads; i++)
+    {
+        arguments[i].blocks = &blocks;
+        arguments[i].input = compressed_.data();
+        arguments[i].output = decompressed_.data();
+        arguments[i].first_block = i;
+        arguments[i].stride = number_of_threads;
+        arguments[i].succeeded = false;
+    }
+    if(number_of_threads == 1)
+        InflateBgzfBlocksThread(&arguments[0]);
+    else
+    {
+        vector<pthread_t> threads = vector<pthread_t>(number_of_threads);
+        vector<bool> started = vector<bool>(number_of_threads, false);
+        for(size_t i = 0; i < number_of_threads; i++)
+        {
+            started[i] = (pthread_create(&threads[i], NULL, &InflateBgzfBlocksThread, &arguments[i]) == 0);
+            /// The blocks of a thread that cannot be started are inflated by the calling one
+            if(!started[i])
+                InflateBgzfBlocksThread(&arguments[i]);
+        }
+        for(size_t i = 0; i < number_of_threads; i++)
+        {
+            if(started[i])
+                pthread_join(threads[i], NULL);
+        }
+    }
+    for(size_t i = 0; i < number_of_threads; i++)
+    {
+        if(!arguments[i].succeeded)
+        {
+            GMML_LOG(gmml::ERR, "Invalid compressed data or checksum in bgzip block");
+            decompressed_.resize(start);
+            return false;
+        }
+    }
+    return true;
+}
+
+void InputFileStream::open(const string& path, int number_of_threads)
+{
+    this->close();
+    /// The state of a previous file does not carry over to the next one
+    this->clear();
+    if(number_of_threads <= 0)
+    {
+        long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+        number_of_threads = (number_of_processors < 1) ? 1 : ((number_of_processors > MAX_DEFAULT_THREADS) ? MAX_DEFAULT_THREADS : number_of_processors);
+    }
+    if(IsCompressedFile(path) && decompressing_buffer_.Open(path, number_of_threads))
+    {
+        compressed_ = true;
+        this->rdbuf(&decompressing_buffer_);
+    }
+    else if(file_buffer_.open(path.c_str(), std::ios_base::in) != NULL)
+    {
+        compressed_ = false;
+        this->rdbuf(&file_buffer_);
+    }
+    else
+        this->setstate(std::ios_base::failbit);
+}
+
+void InputFileStream::close()
+{
+    if(decompressing_buffer_.IsOpen())
+        decompressing_buffer_.Close();
+    if(file_buffer_.is_open())
+        file_buffer_.close();
+    compressed_ = false;
+}
+
+bool InputFileStream::IsCompressedFile(const string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return false;
+    unsigned char magic[2] = {0, 0};
+    size_t size = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return size == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+//////////////////////////////////////////////////////////
+//                 STREAMBUF INTERFACE                  //
+//////////////////////////////////////////////////////////
+DecompressingBuffer::int_type DecompressingBuffer::underflow()
+{
+    if(this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+    if(!this->Refill())
+        return traits_type::eof();
+    return traits_type::to_int_type(*this->gptr());
+}
+
+DecompressingBuffer::pos_type DecompressingBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode)
+{
+    if(file_ == NULL || !(mode & std::ios_base::in))
+        return pos_type(off_type(-1));
+    off_type current = buffer_offset_ + (this->gptr() - this->eback());
+    if(direction == std::ios_base::cur)
+        return (offset == 0) ? pos_type(current) : this->seekpos(pos_type(current + offset), mode);
+    if(direction == std::ios_base::beg)
+        return this->seekpos(pos_type(offset), mode);
+    /// The size of the decompressed data is not known before all of it has been inflated
+    return pos_type(off_type(-1));
+}
+
+DecompressingBuffer::pos_type DecompressingBuffer::seekpos(pos_type position, std::ios_base::openmode mode)
+{
+    off_type target = off_type(position);
+    if(file_ == NULL || !(mode & std::ios_base::in) || target < 0)
+        return pos_type(off_type(-1));
+    if(target < buffer_offset_ && !this->Rewind())
+        return pos_type(off_type(-1));
+    while(target > buffer_offset_ + (this->egptr() - this->eback()))
+    {
+        this->setg(this->eback(), this->egptr(), this->egptr());
+        if(!this->Refill())
+            return pos_type(off_type(-1));
+    }
+    this->setg(this->eback(), this->eback() + (target - buffer_offset_), this->egptr());
+    return position;
+}
@@ -0,0 +1,194 @@
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "../includes/instrumentation.hpp"
+
+using namespace std;
+using namespace gmml;
+
+static bool GetInitialState()
+{
+    const char* enabled = getenv("GMML_INSTRUMENTATION");
+    if(enabled != NULL && string(enabled).compare("0") != 0 && string(enabled).compare("off") != 0)
+        return true;
+    return getenv("GMML_INSTRUMENTATION_REPORT") != NULL;
+}
+
+atomic<bool> Instrumentation::enabled_(GetInitialState());
+
+static Instrumentation* instrumentation_instance = NULL;
+static pthread_once_t instrumentation_once = PTHREAD_ONCE_INIT;
+
+/// Names of the timers and counters are written as JSON strings
+static string EscapeJson(const string& value)
+{
+    string escaped = "";
+    for(unsigned int i = 0; i < value.size(); i++)
+    {
+        char c = value.at(i);
+        if(c == '"' || c == '\\')
+            escaped += '\\';
+        if((unsigned char)c < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+Instrumentation::Instrumentation() : start_time_(GetTime())
+{
+    pthread_mutex_init(&mutex_, NULL);
+}
+
+void Instrumentation::CreateInstance()
+{
+    instrumentation_instance = new Instrumentation();
+    if(getenv("GMML_INSTRUMENTATION_REPORT") != NULL)
+        atexit(Instrumentation::WriteReportAtExit);
+}
+
+//////////////////////////////////////////////////////////
+//                       ACCESSOR                       //
+//////////////////////////////////////////////////////////
+Instrumentation* Instrumentation::GetInstance()
+{
+    pthread_once(&instrumentation_once, Instrumentation::CreateInstance);
+    return instrumentation_instance;
+}
+
+Instrumentation::TimerMap Instrumentation::GetTimers()
+{
+    pthread_mutex_lock(&mutex_);
+    TimerMap timers = timers_;
+    pthread_mutex_unlock(&mutex_);
+    return timers;
+}
+
+Instrumentation::CounterMap Instrumentation::GetCounters()
+{
+    pthread_mutex_lock(&mutex_);
+    CounterMap counters = counters_;
+    pthread_mutex_unlock(&mutex_);
+    return counters;
+}
+
+//////////////////////////////////////////////////////////
+//                       MUTATOR                        //
+//////////////////////////////////////////////////////////
+void Instrumentation::Enable(bool enabled)
+{
+    if(enabled)
+        GetInstance();
+    enabled_.store(enabled, memory_order_relaxed);
+}
+
+void Instrumentation::Reset()
+{
+    pthread_mutex_lock(&mutex_);
+    timers_.clear();
+    counters_.clear();
+    start_time_ = GetTime();
+    pthread_mutex_unlock(&mutex_);
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+void Instrumentation::AddTime(const string& name, double seconds)
+{
+    long peak_memory = GetPeakMemory();
+    pthread_mutex_lock(&mutex_);
+    TimerStatistics& statistics = timers_[name];
+    if(statistics.calls == 0 || seconds < statistics.min_seconds)
+        statistics.min_seconds = seconds;
+    if(seconds > statistics.max_seconds)
+        statistics.max_seconds = seconds;
+    if(peak_memory > statistics.peak_memory_kb)
+        statistics.peak_memory_kb = peak_memory;
+    statistics.calls++;
+    statistics.total_seconds += seconds;
+    pthread_mutex_unlock(&mutex_);
+}
+
+void Instrumentation::AddCount(const string& name, long value)
+{
+    pthread_mutex_lock(&mutex_);
+    counters_[name] += value;
+    pthread_mutex_unlock(&mutex_);
+}
+
+long Instrumentation::GetPeakMemory()
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    /// ru_maxrss is in kilobytes on linux
+    return usage.ru_maxrss;
+}
+
+double Instrumentation::GetTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//////////////////////////////////////////////////////////
+//                       DISPLAY FUNCTIONS              //
+//////////////////////////////////////////////////////////
+void Instrumentation::WriteReport(ostream& out)
+{
+    TimerMap timers = GetTimers();
+    CounterMap counters = GetCounters();
+    pthread_mutex_lock(&mutex_);
+    double elapsed = GetTime() - start_time_;
+    pthread_mutex_unlock(&mutex_);
+
+    out << setprecision(9);
+    out << "{" << endl;
+    out << "  \"pid\": " << getpid() << "," << endl;
+    out << "  \"wall_seconds\": " << elapsed << "," << endl;
+    out << "  \"peak_memory_kb\": " << GetPeakMemory() << "," << endl;
+    out << "  \"timers\": {";
+    for(TimerMap::iterator it = timers.begin(); it != timers.end(); it++)
+    {
+        TimerStatistics& statistics = it->second;
+        out << ((it == timers.begin()) ? "" : ",") << endl;
+        out << "    \"" << EscapeJson(it->first) << "\": {\"calls\": " << statistics.calls
+            << ", \"total_seconds\": " << statistics.total_seconds
+            << ", \"min_seconds\": " << statistics.min_seconds
+            << ", \"max_seconds\": " << statistics.max_seconds
+            << ", \"peak_memory_kb\": " << statistics.peak_memory_kb << "}";
+    }
+    out << endl << "  }," << endl;
+    out << "  \"counters\": {";
+    for(CounterMap::iterator it = counters.begin(); it != counters.end(); it++)
+    {
+        out << ((it == counters.begin()) ? "" : ",") << endl;
+        out << "    \"" << EscapeJson(it->first) << "\": " << it->second;
+    }
+    out << endl << "  }" << endl;
+    out << "}" << endl;
+}
+
+void Instrumentation::WriteReport(const string& file_path)
+{
+    ofstream out(file_path.c_str());
+    WriteReport(out);
+    out.close();
+}
+
+void Instrumentation::WriteReportAtExit()
+{
+    const char* file_path = getenv("GMML_INSTRUMENTATION_REPORT");
+    if(instrumentation_instance != NULL && file_path != NULL)
+        instrumentation_instance->WriteReport(string(file_path));
+}
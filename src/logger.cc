@@ -0,0 +1,371 @@
+#include <cstdlib>
+#include <sched.h>
+
+#include "../includes/logger.hpp"
+
+using namespace std;
+using namespace gmml;
+
+/// Warnings and errors are logged unless GMML_LOG_LEVEL says otherwise
+static int GetInitialLevels()
+{
+    int warnings_and_errors = (1 << (int)WAR) | (1 << (int)ERR);
+    const char* level = getenv("GMML_LOG_LEVEL");
+    if(level == NULL)
+        return warnings_and_errors;
+    string value = string(level);
+    if(value.compare("none") == 0 || value.compare("off") == 0)
+        return 0;
+    if(value.compare("error") == 0)
+        return 1 << (int)ERR;
+    if(value.compare("info") == 0 || value.compare("all") == 0)
+        return warnings_and_errors | (1 << (int)INF);
+    return warnings_and_errors;
+}
+
+atomic<int> Logger::enabled_levels_(GetInitialLevels());
+
+static Logger* logger_instance = NULL;
+static pthread_once_t logger_once = PTHREAD_ONCE_INIT;
+
+/// Number of records the ring buffer holds before the producers have to wait for the writer
+static const size_t LOG_BUFFER_CAPACITY = 8192;
+
+//////////////////////////////////////////////////////////
+//                         SINKS                        //
+//////////////////////////////////////////////////////////
+FileLogSink::FileLogSink() {}
+
+FileLogSink::~FileLogSink()
+{
+    for(map<string, ofstream*>::iterator it = files_.begin(); it != files_.end(); it++)
+    {
+        it->second->close();
+        delete it->second;
+    }
+}
+
+void FileLogSink::Write(const LogRecord& record)
+{
+    ofstream* file = NULL;
+    map<string, ofstream*>::iterator it = files_.find(record.out_file_name);
+    if(it == files_.end())
+    {
+        file = new ofstream(record.out_file_name.c_str(), fstream::app);
+        files_[record.out_file_name] = file;
+    }
+    else
+        file = it->second;
+    *file << Logger::Format(record);
+}
+
+void FileLogSink::Flush()
+{
+    for(map<string, ofstream*>::iterator it = files_.begin(); it != files_.end(); it++)
+        it->second->flush();
+}
+
+StreamLogSink::StreamLogSink(ostream& out) : out_(out) {}
+
+void StreamLogSink::Write(const LogRecord& record)
+{
+    out_ << Logger::Format(record);
+}
+
+void StreamLogSink::Flush()
+{
+    out_.flush();
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+Logger::Logger(size_t capacity) : enqueue_position_(0), dequeue_position_(0), written_(0), running_(false), writer_waiting_(false), synchronous_(false),
+    writer_started_(false)
+{
+    size_t size = 1;
+    while(size < capacity)
+        size <<= 1;
+    slots_ = new Slot[size];
+    mask_ = size - 1;
+    for(size_t i = 0; i < size; i++)
+        slots_[i].sequence.store(i, memory_order_relaxed);
+    pthread_mutex_init(&writer_mutex_, NULL);
+    pthread_cond_init(&writer_condition_, NULL);
+    sink_ = new FileLogSink();
+}
+
+void Logger::CreateInstance()
+{
+    /// The logger is never deleted since messages may still be logged from destructors of static objects;
+    /// the pending messages are written and the files are closed at exit
+    logger_instance = new Logger(LOG_BUFFER_CAPACITY);
+    atexit(Logger::ShutdownAtExit);
+}
+
+//////////////////////////////////////////////////////////
+//                       ACCESSOR                       //
+//////////////////////////////////////////////////////////
+Logger* Logger::GetInstance()
+{
+    pthread_once(&logger_once, Logger::CreateInstance);
+    return logger_instance;
+}
+
+//////////////////////////////////////////////////////////
+//                       MUTATOR                        //
+//////////////////////////////////////////////////////////
+void Logger::SetLevel(LogLevel level)
+{
+    int levels = LevelMask(ERR);
+    if(level == WAR || level == INF)
+        levels |= LevelMask(WAR);
+    if(level == INF)
+        levels |= LevelMask(INF);
+    enabled_levels_.store(levels, memory_order_relaxed);
+}
+
+void Logger::EnableLevel(LogLevel level, bool enabled)
+{
+    if(enabled)
+        enabled_levels_.fetch_or(LevelMask(level), memory_order_relaxed);
+    else
+        enabled_levels_.fetch_and(~LevelMask(level), memory_order_relaxed);
+}
+
+void Logger::Disable()
+{
+    enabled_levels_.store(0, memory_order_relaxed);
+}
+
+void Logger::SetSink(LogSink* sink)
+{
+    Flush();
+    pthread_mutex_lock(&writer_mutex_);
+    sink_->Flush();
+    delete sink_;
+    sink_ = sink;
+    pthread_mutex_unlock(&writer_mutex_);
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+void Logger::Log(int line, const string& file_path, LogLevel level, const string& msg, const string& out_file_name)
+{
+    if(!IsEnabled(level))
+        return;
+    bool synchronous = synchronous_.load(memory_order_acquire);
+    if(!synchronous && !running_.load(memory_order_acquire))
+        StartWriter();
+    LogRecord record;
+    record.time = time(NULL);
+    record.line = line;
+    record.level = level;
+    record.file_path = file_path;
+    record.message = msg;
+    record.out_file_name = out_file_name;
+    /// The buffer is full, let the writer catch up
+    while(!TryPush(record))
+    {
+        WakeWriter();
+        sched_yield();
+    }
+    WakeWriter();
+    if(synchronous)
+        Flush();
+}
+
+void Logger::Flush()
+{
+    size_t target = enqueue_position_.load(memory_order_acquire);
+    while(written_.load(memory_order_acquire) < target)
+    {
+        /// Without a writer thread (e.g. after Shutdown) the caller writes the records itself
+        if(!running_.load(memory_order_acquire))
+        {
+            pthread_mutex_lock(&writer_mutex_);
+            WritePending();
+            pthread_mutex_unlock(&writer_mutex_);
+        }
+        else
+            sched_yield();
+    }
+}
+
+void Logger::Shutdown()
+{
+    pthread_mutex_lock(&writer_mutex_);
+    bool started = writer_started_;
+    running_.store(false, memory_order_release);
+    pthread_cond_signal(&writer_condition_);
+    pthread_mutex_unlock(&writer_mutex_);
+    if(started)
+        pthread_join(writer_, NULL);
+    pthread_mutex_lock(&writer_mutex_);
+    writer_started_ = false;
+    WritePending();
+    pthread_mutex_unlock(&writer_mutex_);
+}
+
+string Logger::Format(const LogRecord& record)
+{
+    struct tm time_info;
+    char time_buffer[32];
+    localtime_r(&record.time, &time_info);
+    asctime_r(&time_info, time_buffer);
+    string time_str = string(time_buffer);
+    stringstream stream;
+    stream << time_str.substr(0, time_str.size() - 1) << " >>> " << record.file_path << ":" << record.line << " >>> ";
+    switch(record.level)
+    {
+        case INF:
+            stream << "[INFO]: ";
+            break;
+        case ERR:
+            stream << "[ERROR]: ";
+            break;
+        case WAR:
+            stream << "[WARNING]: ";
+            break;
+    }
+    stream << record.message << endl;
+    return stream.str();
+}
+
+/// Bounded multi producer/multi consumer queue: each slot carries a sequence number telling whether it is free for the
+/// enqueue position that maps onto it (sequence == position) or holds a record for the dequeue position (sequence == position + 1)
+bool Logger::TryPush(LogRecord& record)
+{
+    size_t position = enqueue_position_.load(memory_order_relaxed);
+    while(true)
+    {
+        Slot& slot = slots_[position & mask_];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        long difference = (long)sequence - (long)position;
+        if(difference == 0)
+        {
+            if(enqueue_position_.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                slot.record.time = record.time;
+                slot.record.line = record.line;
+                slot.record.level = record.level;
+                slot.record.file_path.swap(record.file_path);
+                slot.record.message.swap(record.message);
+                slot.record.out_file_name.swap(record.out_file_name);
+                slot.sequence.store(position + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if(difference < 0)
+            return false;
+        else
+            position = enqueue_position_.load(memory_order_relaxed);
+    }
+}
+
+bool Logger::TryPop(LogRecord& record)
+{
+    size_t position = dequeue_position_.load(memory_order_relaxed);
+    while(true)
+    {
+        Slot& slot = slots_[position & mask_];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        long difference = (long)sequence - (long)(position + 1);
+        if(difference == 0)
+        {
+            if(dequeue_position_.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                record.time = slot.record.time;
+                record.line = slot.record.line;
+                record.level = slot.record.level;
+                record.file_path.swap(slot.record.file_path);
+                record.message.swap(slot.record.message);
+                record.out_file_name.swap(slot.record.out_file_name);
+                slot.sequence.store(position + mask_ + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if(difference < 0)
+            return false;
+        else
+            position = dequeue_position_.load(memory_order_relaxed);
+    }
+}
+
+void Logger::StartWriter()
+{
+    pthread_mutex_lock(&writer_mutex_);
+    if(!writer_started_)
+    {
+        running_.store(true, memory_order_release);
+        if(pthread_create(&writer_, NULL, Logger::WriterThread, (void*)this) == 0)
+            writer_started_ = true;
+        else
+        {
+            /// No thread available, Flush writes the records from the calling thread
+            running_.store(false, memory_order_release);
+            pthread_mutex_unlock(&writer_mutex_);
+            Flush();
+            return;
+        }
+    }
+    pthread_mutex_unlock(&writer_mutex_);
+}
+
+/// Has to be called with writer_mutex_ held
+void Logger::WritePending()
+{
+    LogRecord record;
+    size_t count = 0;
+    while(TryPop(record))
+    {
+        sink_->Write(record);
+        count++;
+    }
+    if(count > 0)
+    {
+        sink_->Flush();
+        written_.fetch_add(count, memory_order_release);
+    }
+}
+
+/// Producers only take the mutex when the writer announced that it waits; the writer announces it before checking the queue
+/// a last time, so either it sees the new record or the producer sees the announcement (both sides use sequentially consistent fences)
+void Logger::WakeWriter()
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if(!writer_waiting_.load(memory_order_relaxed))
+        return;
+    pthread_mutex_lock(&writer_mutex_);
+    pthread_cond_signal(&writer_condition_);
+    pthread_mutex_unlock(&writer_mutex_);
+}
+
+void* Logger::WriterThread(void* args)
+{
+    Logger* logger = (Logger*)args;
+    pthread_mutex_lock(&logger->writer_mutex_);
+    while(logger->running_.load(memory_order_acquire))
+    {
+        logger->WritePending();
+        logger->writer_waiting_.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if(logger->running_.load(memory_order_acquire) &&
+                logger->dequeue_position_.load(memory_order_relaxed) == logger->enqueue_position_.load(memory_order_relaxed))
+            pthread_cond_wait(&logger->writer_condition_, &logger->writer_mutex_);
+        logger->writer_waiting_.store(false, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&logger->writer_mutex_);
+    pthread_exit(NULL);
+}
+
+void Logger::ShutdownAtExit()
+{
+    if(logger_instance != NULL)
+    {
+        /// Messages of static destructors are written right away, there is no writer thread anymore
+        logger_instance->synchronous_.store(true, memory_order_release);
+        logger_instance->Shutdown();
+    }
+}
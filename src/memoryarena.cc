@@ -0,0 +1,215 @@
+#include <new>
+#include <cstdlib>
+
+#include "../includes/memoryarena.hpp"
+
+using namespace std;
+using namespace gmml;
+
+/// Alignment of the objects placed in an arena, enough for any of the record classes
+static const size_t ARENA_ALIGNMENT = 16;
+
+static thread_local MemoryArena* current_arena = NULL;
+
+static size_t AlignSize(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+MemoryArena::MemoryArena(size_t block_size) : block_size_(AlignSize(block_size)), current_block_(0), reserved_bytes_(0), cursor_(NULL),
+    end_(NULL), last_object_(NULL), number_of_objects_(0) {}
+
+MemoryArena::~MemoryArena()
+{
+    this->Release();
+}
+
+MemoryArenaScope::MemoryArenaScope(MemoryArena* arena) : previous_(current_arena)
+{
+    current_arena = arena;
+}
+
+MemoryArenaScope::~MemoryArenaScope()
+{
+    current_arena = previous_;
+}
+
+//////////////////////////////////////////////////////////
+//                       ACCESSOR                       //
+//////////////////////////////////////////////////////////
+MemoryArena* MemoryArena::GetCurrent()
+{
+    return current_arena;
+}
+
+size_t MemoryArena::GetNumberOfObjects() const
+{
+    return number_of_objects_;
+}
+
+size_t MemoryArena::GetNumberOfBlocks() const
+{
+    return blocks_.size() + large_blocks_.size();
+}
+
+size_t MemoryArena::GetReservedBytes() const
+{
+    return reserved_bytes_;
+}
+
+//////////////////////////////////////////////////////////
+//                       MUTATOR                        //
+//////////////////////////////////////////////////////////
+void MemoryArena::Release()
+{
+    this->DestroyObjects();
+    for(vector<char*>::iterator it = blocks_.begin(); it != blocks_.end(); it++)
+        free(*it);
+    for(vector<char*>::iterator it = large_blocks_.begin(); it != large_blocks_.end(); it++)
+        free(*it);
+    blocks_.clear();
+    large_blocks_.clear();
+    current_block_ = 0;
+    reserved_bytes_ = 0;
+    cursor_ = NULL;
+    end_ = NULL;
+}
+
+void MemoryArena::Rewind()
+{
+    this->DestroyObjects();
+    for(vector<char*>::iterator it = large_blocks_.begin(); it != large_blocks_.end(); it++)
+        free(*it);
+    large_blocks_.clear();
+    reserved_bytes_ = blocks_.size() * block_size_;
+    current_block_ = 0;
+    cursor_ = (blocks_.empty()) ? NULL : blocks_.at(0);
+    end_ = (blocks_.empty()) ? NULL : blocks_.at(0) + block_size_;
+}
+
+void MemoryArena::Absorb(MemoryArena& other)
+{
+    if(&other == this || (other.blocks_.empty() && other.large_blocks_.empty()))
+        return;
+    if(other.last_object_ != NULL)
+    {
+        ObjectHeader* first = other.last_object_;
+        while(first->previous != NULL)
+            first = first->previous;
+        first->previous = last_object_;
+        last_object_ = other.last_object_;
+    }
+    /// The blocks of the other arena are full as far as this arena is concerned: they go in front of the current block,
+    /// so only free blocks follow it
+    vector<char*>::iterator position = (blocks_.empty()) ? blocks_.end() : blocks_.begin() + current_block_;
+    blocks_.insert(position, other.blocks_.begin(), other.blocks_.end());
+    if(cursor_ != NULL)
+        current_block_ += other.blocks_.size();
+    large_blocks_.insert(large_blocks_.end(), other.large_blocks_.begin(), other.large_blocks_.end());
+    reserved_bytes_ += other.reserved_bytes_;
+    number_of_objects_ += other.number_of_objects_;
+
+    other.blocks_.clear();
+    other.large_blocks_.clear();
+    other.current_block_ = 0;
+    other.reserved_bytes_ = 0;
+    other.cursor_ = NULL;
+    other.end_ = NULL;
+    other.last_object_ = NULL;
+    other.number_of_objects_ = 0;
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+void* MemoryArena::Allocate(size_t size, DestroyFunction destroy)
+{
+    size_t total_size = HeaderSize() + AlignSize(size);
+    char* memory = NULL;
+    /// Large objects get a block of their own so the current block keeps its free space
+    if(total_size > block_size_ / 4)
+    {
+        memory = this->AllocateBlock(total_size);
+        large_blocks_.push_back(memory);
+    }
+    else
+    {
+        if(cursor_ == NULL || (size_t)(end_ - cursor_) < total_size)
+        {
+            if(cursor_ != NULL && current_block_ + 1 < blocks_.size())
+                current_block_++;
+            else
+            {
+                blocks_.push_back(this->AllocateBlock(block_size_));
+                current_block_ = blocks_.size() - 1;
+            }
+            cursor_ = blocks_.at(current_block_);
+            end_ = cursor_ + block_size_;
+        }
+        memory = cursor_;
+        cursor_ += total_size;
+    }
+    ObjectHeader* header = (ObjectHeader*)memory;
+    header->destroy = destroy;
+    header->arena = this;
+    header->previous = last_object_;
+    last_object_ = header;
+    number_of_objects_++;
+    return memory + HeaderSize();
+}
+
+void* MemoryArena::AllocateObject(size_t size, DestroyFunction destroy)
+{
+    MemoryArena* arena = current_arena;
+    if(arena != NULL)
+        return arena->Allocate(size, destroy);
+    ObjectHeader* header = (ObjectHeader*)::operator new(HeaderSize() + size);
+    header->destroy = NULL;
+    header->arena = NULL;
+    header->previous = NULL;
+    return (char*)header + HeaderSize();
+}
+
+void MemoryArena::DeallocateObject(void* object)
+{
+    if(object == NULL)
+        return;
+    ObjectHeader* header = (ObjectHeader*)((char*)object - HeaderSize());
+    if(header->arena == NULL)
+        ::operator delete(header);
+    else
+        header->destroy = NULL;
+}
+
+char* MemoryArena::AllocateBlock(size_t size)
+{
+    char* block = NULL;
+    if(posix_memalign((void**)&block, ARENA_ALIGNMENT, size) != 0)
+        throw bad_alloc();
+    reserved_bytes_ += size;
+    return block;
+}
+
+void MemoryArena::DestroyObjects()
+{
+    /// Objects may refer to objects created before them, so the newest ones go first
+    for(ObjectHeader* header = last_object_; header != NULL; header = header->previous)
+    {
+        if(header->destroy != NULL)
+        {
+            DestroyFunction destroy = header->destroy;
+            header->destroy = NULL;
+            destroy((char*)header + HeaderSize());
+        }
+    }
+    last_object_ = NULL;
+    number_of_objects_ = 0;
+}
+
+size_t MemoryArena::HeaderSize()
+{
+    return AlignSize(sizeof(ObjectHeader));
+}